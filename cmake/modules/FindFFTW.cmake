@@ -16,6 +16,9 @@ This module provides the following imported targets, if found:
 
 ``FFTW::FFTW``
   The FFTW library
+``FFTW::Threads``
+  The FFTW threads library, if it provides
+  ``fftw_make_planner_thread_safe()`` (FFTW 3.3.5 or later)
 
 Result Variables
 ^^^^^^^^^^^^^^^^
@@ -28,6 +31,9 @@ This will define the following variables:
   Include directories needed to use FFTW.
 ``FFTW_LIBRARIES``
   Libraries needed to link to FFTW.
+``FFTW_THREAD_SAFE_PLANNER``
+  True if the planner can be made thread-safe with
+  ``fftw_make_planner_thread_safe()``.
 
 Cache Variables
 ^^^^^^^^^^^^^^^
@@ -38,6 +44,8 @@ The following cache variables may also be set:
   The directory containing ``fftw3.h``.
 ``FFTW_LIBRARY``
   The path to the FFTW library.
+``FFTW_THREADS_LIBRARY``
+  The path to the FFTW threads library.
 
 #]=======================================================================]
 
@@ -47,6 +55,13 @@ mark_as_advanced(FFTW_INCLUDE_DIR)
 find_library(FFTW_LIBRARY NAMES fftw fftw3 fftw-3.3 DOC "FFTW library")
 mark_as_advanced(FFTW_LIBRARY)
 
+find_library(
+  FFTW_THREADS_LIBRARY
+  NAMES fftw3_threads fftw-3.3_threads
+  DOC "FFTW threads library"
+)
+mark_as_advanced(FFTW_THREADS_LIBRARY)
+
 include(FindPackageHandleStandardArgs)
 find_package_handle_standard_args(
   FFTW
@@ -68,4 +83,34 @@ if(FFTW_FOUND)
         INTERFACE_INCLUDE_DIRECTORIES "${FFTW_INCLUDE_DIR}"
     )
   endif()
+
+  if(FFTW_THREADS_LIBRARY)
+    find_package(Threads)
+    include(CheckSymbolExists)
+    include(CMakePushCheckState)
+    cmake_push_check_state(RESET)
+    set(CMAKE_REQUIRED_INCLUDES "${FFTW_INCLUDE_DIR}")
+    set(
+      CMAKE_REQUIRED_LIBRARIES
+      "${FFTW_THREADS_LIBRARY}"
+      "${FFTW_LIBRARY}"
+      Threads::Threads
+    )
+    check_symbol_exists(
+      fftw_make_planner_thread_safe
+      "fftw3.h"
+      FFTW_THREAD_SAFE_PLANNER
+    )
+    cmake_pop_check_state()
+  endif()
+
+  if(FFTW_THREAD_SAFE_PLANNER AND NOT TARGET FFTW::Threads)
+    add_library(FFTW::Threads UNKNOWN IMPORTED)
+    set_target_properties(
+      FFTW::Threads
+      PROPERTIES
+        IMPORTED_LOCATION "${FFTW_THREADS_LIBRARY}"
+        INTERFACE_LINK_LIBRARIES "FFTW::FFTW;Threads::Threads"
+    )
+  endif()
 endif()
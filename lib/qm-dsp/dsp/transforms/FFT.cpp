@@ -10,8 +10,12 @@
 
 #include "maths/MathUtilities.h"
 
+#ifdef HAVE_FFTW3
+#include <fftw3.h>
+#else
 #include "ext/kissfft/kiss_fft.h"
 #include "ext/kissfft/tools/kiss_fftr.h"
+#endif
 
 #include <cmath>
 
@@ -19,6 +23,80 @@
 
 #include <stdexcept>
 
+#ifdef HAVE_FFTW3
+
+// The FFTW planner is not thread-safe, only the execution of plans is.
+// KeyFinder plans with the same FFTW under a lock of its own, so the
+// planner itself is made thread-safe (FFTW >= 3.3.5) once at startup,
+// before any analyzer thread is running. FFTW picks SIMD codelets for the
+// plans at runtime.
+static const bool fftwPlannerThreadSafe = [] {
+    fftw_make_planner_thread_safe();
+    return true;
+}();
+
+class FFT::D
+{
+public:
+    D(int n) : m_n(n) {
+        m_in = fftw_alloc_complex(m_n);
+        m_out = fftw_alloc_complex(m_n);
+        m_planf = fftw_plan_dft_1d(m_n, m_in, m_out,
+                                   FFTW_FORWARD, FFTW_ESTIMATE);
+        m_plani = fftw_plan_dft_1d(m_n, m_in, m_out,
+                                   FFTW_BACKWARD, FFTW_ESTIMATE);
+    }
+
+    ~D() {
+        fftw_destroy_plan(m_planf);
+        fftw_destroy_plan(m_plani);
+        fftw_free(m_in);
+        fftw_free(m_out);
+    }
+
+    void process(bool inverse,
+                 const double *ri,
+                 const double *ii,
+                 double *ro,
+                 double *io) {
+
+        for (int i = 0; i < m_n; ++i) {
+            m_in[i][0] = ri[i];
+            m_in[i][1] = (ii ? ii[i] : 0.0);
+        }
+
+        if (!inverse) {
+
+            fftw_execute(m_planf);
+
+            for (int i = 0; i < m_n; ++i) {
+                ro[i] = m_out[i][0];
+                io[i] = m_out[i][1];
+            }
+
+        } else {
+
+            fftw_execute(m_plani);
+
+            double scale = 1.0 / m_n;
+
+            for (int i = 0; i < m_n; ++i) {
+                ro[i] = m_out[i][0] * scale;
+                io[i] = m_out[i][1] * scale;
+            }
+        }
+    }
+
+private:
+    int m_n;
+    fftw_plan m_planf;
+    fftw_plan m_plani;
+    fftw_complex *m_in;
+    fftw_complex *m_out;
+};
+
+#else // HAVE_FFTW3
+
 class FFT::D
 {
 public:
@@ -77,6 +155,8 @@ private:
     kiss_fft_cpx *m_kout;
 };        
 
+#endif // HAVE_FFTW3
+
 FFT::FFT(int n) :
     m_d(new D(n))
 {
@@ -97,6 +177,93 @@ FFT::process(bool inverse,
                  p_lpRealOut, p_lpImagOut);
 }
     
+#ifdef HAVE_FFTW3
+
+class FFTReal::D
+{
+public:
+    D(int n) : m_n(n) {
+        if (n % 2) {
+            throw std::invalid_argument
+                ("nsamples must be even in FFTReal constructor");
+        }
+        m_r = fftw_alloc_real(m_n);
+        m_c = fftw_alloc_complex(m_n/2 + 1);
+        m_planf = fftw_plan_dft_r2c_1d(m_n, m_r, m_c, FFTW_ESTIMATE);
+        m_plani = fftw_plan_dft_c2r_1d(m_n, m_c, m_r, FFTW_ESTIMATE);
+    }
+
+    ~D() {
+        fftw_destroy_plan(m_planf);
+        fftw_destroy_plan(m_plani);
+        fftw_free(m_r);
+        fftw_free(m_c);
+    }
+
+    void forward(const double *ri, double *ro, double *io) {
+
+        for (int i = 0; i < m_n; ++i) {
+            m_r[i] = ri[i];
+        }
+
+        fftw_execute(m_planf);
+
+        for (int i = 0; i <= m_n/2; ++i) {
+            ro[i] = m_c[i][0];
+            io[i] = m_c[i][1];
+        }
+
+        for (int i = 0; i + 1 < m_n/2; ++i) {
+            ro[m_n - i - 1] =  ro[i + 1];
+            io[m_n - i - 1] = -io[i + 1];
+        }
+    }
+
+    void forwardMagnitude(const double *ri, double *mo) {
+
+        for (int i = 0; i < m_n; ++i) {
+            m_r[i] = ri[i];
+        }
+
+        fftw_execute(m_planf);
+
+        for (int i = 0; i <= m_n/2; ++i) {
+            mo[i] = sqrt(m_c[i][0] * m_c[i][0] + m_c[i][1] * m_c[i][1]);
+        }
+
+        for (int i = 0; i + 1 < m_n/2; ++i) {
+            mo[m_n - i - 1] = mo[i + 1];
+        }
+    }
+
+    void inverse(const double *ri, const double *ii, double *ro) {
+
+        // The c2r transform only reads nfft/2+1 complex points, and
+        // overwrites them
+        for (int i = 0; i < m_n/2 + 1; ++i) {
+            m_c[i][0] = ri[i];
+            m_c[i][1] = ii[i];
+        }
+
+        fftw_execute(m_plani);
+
+        double scale = 1.0 / m_n;
+
+        for (int i = 0; i < m_n; ++i) {
+            ro[i] = m_r[i] * scale;
+        }
+    }
+
+private:
+    int m_n;
+    fftw_plan m_planf;
+    fftw_plan m_plani;
+    double *m_r;
+    fftw_complex *m_c;
+};
+
+#else // HAVE_FFTW3
+
 class FFTReal::D
 {
 public:
@@ -108,12 +275,14 @@ public:
         m_planf = kiss_fftr_alloc(m_n, 0, NULL, NULL);
         m_plani = kiss_fftr_alloc(m_n, 1, NULL, NULL);
         m_c = new kiss_fft_cpx[m_n];
+        m_io = new double[m_n];
     }
 
     ~D() {
         kiss_fftr_free(m_planf);
         kiss_fftr_free(m_plani);
         delete[] m_c;
+        delete[] m_io;
     }
 
     void forward(const double *ri, double *ro, double *io) {
@@ -133,15 +302,11 @@ public:
 
     void forwardMagnitude(const double *ri, double *mo) {
 
-        double *io = new double[m_n];
-
-        forward(ri, mo, io);
+        forward(ri, mo, m_io);
 
         for (int i = 0; i < m_n; ++i) {
-            mo[i] = sqrt(mo[i] * mo[i] + io[i] * io[i]);
+            mo[i] = sqrt(mo[i] * mo[i] + m_io[i] * m_io[i]);
         }
-
-        delete[] io;
     }
 
     void inverse(const double *ri, const double *ii, double *ro) {
@@ -168,8 +333,12 @@ private:
     kiss_fftr_cfg m_planf;
     kiss_fftr_cfg m_plani;
     kiss_fft_cpx *m_c;
+    // The imaginary part of forwardMagnitude(), which is called per frame
+    double *m_io;
 };
 
+#endif // HAVE_FFTW3
+
 FFTReal::FFTReal(int n) :
     m_d(new D(n)) 
 {
@@ -276,8 +276,10 @@ void timecoder_free_lookup(void) {
     for (n = 0; n < ARRAY_SIZE(timecodes); n++) {
         struct timecode_def *def = &timecodes[n];
 
-        if (def->lookup)
+        if (def->lookup) {
             lut_clear(&def->lut);
+            def->lookup = false;
+        }
     }
 }
 
@@ -403,6 +405,7 @@ static void detect_zero_crossing(struct timecoder_channel *ch,
 static inline void update_monitor(struct timecoder *tc, signed int x, signed int y)
 {
     int px, py, size, ref;
+    double scale;
 
     if (!tc->mon)
         return;
@@ -413,19 +416,28 @@ static inline void update_monitor(struct timecoder *tc, signed int x, signed int
     /* Decay the pixels already in the montior */
 
     if (++tc->mon_counter % MONITOR_DECAY_EVERY == 0) {
-        int p;
+        unsigned char *mon = tc->mon;
+        int p, npixels = SQ(size);
 
-        for (p = 0; p < SQ(size); p++) {
-            if (tc->mon[p])
-                tc->mon[p] = tc->mon[p] * 7 / 8;
-        }
+        /* Without a branch and through a local pointer, which can't
+         * alias tc, so the loop is vectorised. Blank pixels stay
+         * blank. */
+
+        for (p = 0; p < npixels; p++)
+            mon[p] = mon[p] * 7 / 8;
     }
 
     assert(ref > 0);
 
-    /* ref_level is half the precision of signal level */
-    px = size / 2 + (long long)x * size / ref / 8;
-    py = size / 2 + (long long)y * size / ref / 8;
+    /* ref_level is half the precision of signal level.
+     *
+     * Truncating twice, by ref and by 8, is the same as truncating
+     * once. Both operands are exact in a double and the quotient is
+     * small, so the floating point division truncates to the same
+     * integer as the much slower 64-bit integer division. */
+    scale = (double)ref * 8;
+    px = size / 2 + (int)((double)x * size / scale);
+    py = size / 2 + (int)((double)y * size / scale);
 
     if (px < 0 || px >= size || py < 0 || py >= size)
         return;
@@ -610,6 +622,35 @@ void timecoder_submit(struct timecoder *tc, signed short *pcm, size_t npcm)
     }
 }
 
+/*
+ * Submit and decode a block of audio that has already been split into
+ * the left and right channel, eg. by a vectorised conversion
+ *
+ * The samples are in the full range of a signed int; ie. 32-bit signed.
+ * The result is the same as passing the samples, shifted down to
+ * 16-bit, to timecoder_submit().
+ */
+
+void timecoder_submit_channels(struct timecoder *tc, const signed int *left,
+                               const signed int *right, size_t npcm)
+{
+    const signed int *primary, *secondary;
+    size_t n;
+
+    if (tc->def->flags & SWITCH_PRIMARY) {
+        primary = left;
+        secondary = right;
+    } else {
+        primary = right;
+        secondary = left;
+    }
+
+    for (n = 0; n < npcm; n++) {
+        process_sample(tc, primary[n], secondary[n]);
+        update_monitor(tc, left[n], right[n]);
+    }
+}
+
 /*
  * Get the last-known position of the timecode
  *
@@ -94,6 +94,8 @@ void timecoder_monitor_clear(struct timecoder *tc);
 
 void timecoder_cycle_definition(struct timecoder *tc);
 void timecoder_submit(struct timecoder *tc, signed short *pcm, size_t npcm);
+void timecoder_submit_channels(struct timecoder *tc, const signed int *left,
+                               const signed int *right, size_t npcm);
 signed int timecoder_get_position(struct timecoder *tc, double *when);
 
 /*
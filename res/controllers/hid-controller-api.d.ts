@@ -67,6 +67,27 @@ declare namespace controller {
      */
     function sendOutputReport(reportID: number, dataArray: ArrayBuffer, useNonSkippingFIFO?: boolean): void;
 
+    /**
+     * Limits the rate of OutputReports sent in skipping mode
+     *
+     * Each ReportID is sent at most `reportsPerSecond` times per second.
+     * Data cached in between are coalesced, only the latest data are sent.
+     * This saves bus bandwidth for mappings, which update LEDs on every tick.
+     * Reports sent with useNonSkippingFIFO set `true` are never rate limited.
+     *
+     *  @param reportsPerSecond Maximum rate per ReportID, or 0 for no limit (default)
+     */
+    function setMaxOutputReportRate(reportsPerSecond: number): void;
+
+    /**
+     * Returns the number of OutputReports handled since the device was opened
+     *
+     *  @returns `sent`: Reports written to the device,
+     *           `skipped`: Reports not sent because the data were identical to the data sent before,
+     *           `coalesced`: Reports superseded by newer data before they could be sent
+     */
+    function getOutputReportStatistics(): {sent: number, skipped: number, coalesced: number};
+
     /**
      * getInputReport receives an InputReport from the HID device on request.
      *
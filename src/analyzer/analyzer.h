@@ -1,5 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <limits>
+
+#include "analyzer/analyzerfrontend.h"
 #include "analyzer/analyzertrack.h"
 #include "audio/signalinfo.h"
 #include "audio/types.h"
@@ -35,6 +39,26 @@ class Analyzer {
     // but not finalize()!
     virtual bool processSamples(const CSAMPLE* pIn, SINT count) = 0;
 
+    // Analyze the next chunk like processSamples(), but take the
+    // representations of the audio that are needed from the front-end,
+    // which prepares each of them only once for all analyzers.
+    virtual bool processChunk(AnalyzerFrontEnd* pFrontEnd) {
+        return processSamples(pFrontEnd->samples(), pFrontEnd->sampleCount());
+    }
+
+    // Return the first frame at or after frameIndex that is still needed,
+    // or the length of the track if no more frames are needed. The frames
+    // that no analyzer needs are not decoded, and decoding stops once all
+    // analyzers are done. Chunks that are not needed may still be passed
+    // to processChunk() if other analyzers need them.
+    //
+    // An analyzer may also return a frame before frameIndex to have frames
+    // decoded again that have been skipped. Chunks that are decoded again
+    // are only passed to the analyzers that requested them.
+    virtual SINT nextFrameNeeded(SINT frameIndex) const {
+        return frameIndex;
+    }
+
     // Update the track object with the analysis results after
     // processing finished successfully, i.e. all available audio
     // samples have been processed.
@@ -52,7 +76,8 @@ class AnalyzerWithState final {
   public:
     explicit AnalyzerWithState(AnalyzerPtr analyzer)
             : m_analyzer(std::move(analyzer)),
-              m_active(false) {
+              m_active(false),
+              m_nextFrame(0) {
         DEBUG_ASSERT(m_analyzer);
     }
     AnalyzerWithState(const AnalyzerWithState&) = delete;
@@ -72,12 +97,32 @@ class AnalyzerWithState final {
             mixxx::audio::ChannelCount channelCount,
             SINT frameLength) {
         DEBUG_ASSERT(!m_active);
+        m_nextFrame = 0;
         return m_active = m_analyzer->initialize(track, sampleRate, channelCount, frameLength);
     }
 
-    void processSamples(const CSAMPLE* pIn, const int count) {
+    SINT nextFrameNeeded(SINT frameIndex) const {
+        if (!m_active) {
+            return std::numeric_limits<SINT>::max();
+        }
+        const SINT nextFrame = m_analyzer->nextFrameNeeded(frameIndex);
+        if (frameIndex < m_nextFrame) {
+            // Frames are decoded again for another analyzer, but this one
+            // only needs the frames it has not been passed yet
+            return std::max(nextFrame, m_nextFrame);
+        }
+        return nextFrame;
+    }
+
+    void processChunk(AnalyzerFrontEnd* pFrontEnd) {
         if (m_active) {
-            m_active = m_analyzer->processSamples(pIn, count);
+            if (pFrontEnd->frameIndex() < m_nextFrame &&
+                    m_analyzer->nextFrameNeeded(m_nextFrame) >= m_nextFrame) {
+                // The chunk is decoded again for another analyzer
+                return;
+            }
+            m_nextFrame = pFrontEnd->frameIndex() + pFrontEnd->frameCount();
+            m_active = m_analyzer->processChunk(pFrontEnd);
             if (!m_active) {
                 // Ensure that cleanup() is invoked after processing
                 // failed and the analyzer became inactive!
@@ -104,4 +149,6 @@ class AnalyzerWithState final {
   private:
     AnalyzerPtr m_analyzer;
     bool m_active;
+    // The frame after the last chunk that has been passed to the analyzer
+    SINT m_nextFrame;
 };
@@ -4,6 +4,7 @@
 #include <QString>
 #include <QVector>
 #include <QtDebug>
+#include <limits>
 
 #include "analyzer/analyzertrack.h"
 #include "analyzer/constants.h"
@@ -11,8 +12,17 @@
 #include "analyzer/plugins/analyzersoundtouchbeats.h"
 #include "library/rekordbox/rekordboxconstants.h"
 #include "track/beatfactory.h"
+#include "track/beatutils.h"
 #include "track/track.h"
 
+namespace {
+
+// The BPM of excerpts agree within 1 %, which covers the jitter of the beat
+// trackers but still tells apart half and double tempo.
+constexpr double kExcerptBpmTolerance = 0.01;
+
+} // anonymous namespace
+
 // static
 QList<mixxx::AnalyzerPluginInfo> AnalyzerBeats::availablePlugins() {
     QList<mixxx::AnalyzerPluginInfo> plugins;
@@ -88,46 +98,65 @@ bool AnalyzerBeats::initialize(const AnalyzerTrack& track,
 
     m_sampleRate = sampleRate;
     m_channelCount = channelCount;
-    // In fast analysis mode, skip processing after
-    // kFastAnalysisSecondsToAnalyze seconds are analyzed.
+    m_maxFramesToProcess = frameLength;
+    m_currentFrame = 0;
+    m_excerpts = AnalyzerExcerpts();
+    m_excerptBeats.clear();
+
+    const mixxx::BeatsPointer pBeats = track.getTrack()->getBeats();
+    if (m_bPreferencesFastAnalysis && pBeats &&
+            AnalyzerExcerpts::isLowConfidence(pBeats->getSubVersion())) {
+        qDebug() << "Analyzing the whole track, because the result of the"
+                 << "fast analysis had a low confidence";
+        m_bPreferencesFastAnalysis = false;
+    }
     if (m_bPreferencesFastAnalysis) {
-        m_maxFramesToProcess =
-                mixxx::kFastAnalysisSecondsToAnalyze * m_sampleRate;
-    } else {
-        m_maxFramesToProcess = frameLength;
+        if (m_bPreferencesFixedTempo) {
+            // Estimate the tempo from strided excerpts of the track. The beat
+            // positions of a beat map need all frames.
+            m_excerpts = AnalyzerExcerpts(m_sampleRate, frameLength, kExcerptBpmTolerance);
+        } else {
+            // Skip processing after kFastAnalysisSecondsToAnalyze seconds
+            // are analyzed.
+            m_maxFramesToProcess =
+                    mixxx::kFastAnalysisSecondsToAnalyze * m_sampleRate;
+        }
     }
-    m_currentFrame = 0;
 
     // if we can load a stored track don't reanalyze it
     bool bShouldAnalyze = shouldAnalyze(track.getTrack());
 
     DEBUG_ASSERT(!m_pPlugin);
     if (bShouldAnalyze) {
-        if (m_pluginId == mixxx::AnalyzerQueenMaryBeats::pluginInfo().id()) {
-            m_pPlugin = std::make_unique<mixxx::AnalyzerQueenMaryBeats>();
-        } else if (m_pluginId == mixxx::AnalyzerSoundTouchBeats::pluginInfo().id()) {
-            m_pPlugin = std::make_unique<mixxx::AnalyzerSoundTouchBeats>();
-        } else {
-            // This must not happen, because we have already verified above
-            // that the PlugInId is valid
-            DEBUG_ASSERT(false);
-        }
-
-        if (m_pPlugin) {
-            if (m_pPlugin->initialize(m_sampleRate)) {
-                qDebug() << "Beat calculation started with plugin" << m_pluginId;
-            } else {
-                qDebug() << "Beat calculation will not start.";
-                m_pPlugin.reset();
-                bShouldAnalyze = false;
-            }
+        if (startPlugin()) {
+            qDebug() << "Beat calculation started with plugin" << m_pluginId;
         } else {
+            qDebug() << "Beat calculation will not start.";
             bShouldAnalyze = false;
         }
     }
     return bShouldAnalyze;
 }
 
+bool AnalyzerBeats::startPlugin() {
+    if (m_pluginId == mixxx::AnalyzerQueenMaryBeats::pluginInfo().id()) {
+        m_pPlugin = std::make_unique<mixxx::AnalyzerQueenMaryBeats>();
+    } else if (m_pluginId == mixxx::AnalyzerSoundTouchBeats::pluginInfo().id()) {
+        m_pPlugin = std::make_unique<mixxx::AnalyzerSoundTouchBeats>();
+    } else {
+        // This must not happen, because we have already verified above
+        // that the PlugInId is valid
+        DEBUG_ASSERT(false);
+        m_pPlugin.reset();
+        return false;
+    }
+    if (!m_pPlugin->initialize(m_sampleRate)) {
+        m_pPlugin.reset();
+        return false;
+    }
+    return true;
+}
+
 bool AnalyzerBeats::shouldAnalyze(TrackPointer pTrack) const {
     bool bpmLock = pTrack->isBpmLocked();
     if (bpmLock) {
@@ -164,6 +193,11 @@ bool AnalyzerBeats::shouldAnalyze(TrackPointer pTrack) const {
         return m_bPreferencesReanalyzeImported;
     }
 
+    if (AnalyzerExcerpts::isLowConfidence(subVersion)) {
+        qDebug() << "Re-analyzing track with a low confidence BPM from fast analysis.";
+        return true;
+    }
+
     if (subVersion.isEmpty() && pBeats->firstBeat() <= mixxx::audio::kStartFramePos &&
             m_pluginId != mixxx::AnalyzerSoundTouchBeats::pluginInfo().id()) {
         // This happens if the beat grid was created from the metadata BPM value.
@@ -197,50 +231,95 @@ bool AnalyzerBeats::shouldAnalyze(TrackPointer pTrack) const {
 }
 
 bool AnalyzerBeats::processSamples(const CSAMPLE* pIn, SINT count) {
+    // Only used without the shared front-end of the AnalyzerThread
+    AnalyzerFrontEnd frontEnd(m_channelCount);
+    frontEnd.setChunk(pIn, count, m_currentFrame);
+    return processChunk(&frontEnd);
+}
+
+bool AnalyzerBeats::processChunk(AnalyzerFrontEnd* pFrontEnd) {
     VERIFY_OR_DEBUG_ASSERT(m_pPlugin) {
         return false;
     }
+    if (m_channelCount > mixxx::audio::ChannelCount::stereo() &&
+            m_channelCount != mixxx::audio::ChannelCount::stem()) {
+        DEBUG_ASSERT(!"Unsupported channel count");
+        return false;
+    }
 
-    SINT numFrames = count / m_channelCount;
-    const CSAMPLE* pBeatInput = pIn;
-    CSAMPLE* pDrumChannel = nullptr;
+    const SINT numFrames = pFrontEnd->frameCount();
+    m_currentFrame = pFrontEnd->frameIndex() + numFrames;
+    if (!m_excerpts.isEmpty()) {
+        return m_excerpts.processChunk(pFrontEnd, this);
+    }
+    if (m_currentFrame > m_maxFramesToProcess) {
+        return true; // silently ignore all remaining samples
+    }
+    return processFrames(pFrontEnd, 0, numFrames);
+}
 
-    if (m_channelCount == mixxx::audio::ChannelCount::stem()) {
+bool AnalyzerBeats::processFrames(
+        AnalyzerFrontEnd* pFrontEnd, SINT offset, SINT frameCount) {
+    DEBUG_ASSERT(offset + frameCount <= pFrontEnd->frameCount());
+    if (m_channelCount == mixxx::audio::ChannelCount::stem() &&
+            m_bpmSettings.getStemStrategy() == BeatDetectionSettings::StemStrategy::Enforced) {
         // We have an 8 channel soundsource. The only implemented soundsource with
         // 8ch is the NI STEM file format.
         // TODO: If we add other soundsources with 8ch, we need to rework this condition.
         //
-        // For NI STEM we mix all the stems together except the first one,
-        // which contains drums or beats by convention.
-        count = numFrames * mixxx::audio::ChannelCount::stereo();
-        pDrumChannel = SampleUtil::alloc(count);
-
-        VERIFY_OR_DEBUG_ASSERT(pDrumChannel) {
-            return false;
+        // For NI STEM the first stem contains drums or beats by convention.
+        // Otherwise all the stems are mixed together by the front-end.
+        const SINT count = frameCount * mixxx::audio::ChannelCount::stereo();
+        if (m_drumStem.size() < count) {
+            mixxx::SampleBuffer(count).swap(m_drumStem);
         }
+        SampleUtil::copyOneStereoFromMulti(m_drumStem.data(),
+                pFrontEnd->samples() + offset * m_channelCount,
+                frameCount,
+                m_channelCount,
+                0);
+        return m_pPlugin->processSamples(m_drumStem.data(), count);
+    }
+
+    if (m_pPlugin->supportsMonoInput()) {
+        return m_pPlugin->processMonoSamples(pFrontEnd->mono() + offset, frameCount);
+    }
+    return m_pPlugin->processSamples(
+            pFrontEnd->stereo() + offset * mixxx::audio::ChannelCount::stereo(),
+            frameCount * mixxx::audio::ChannelCount::stereo());
+}
 
-        if (m_bpmSettings.getStemStrategy() == BeatDetectionSettings::StemStrategy::Enforced) {
-            SampleUtil::copyOneStereoFromMulti(pDrumChannel, pIn, numFrames, m_channelCount, 0);
+std::optional<double> AnalyzerBeats::finishExcerpt(mixxx::IndexRange excerpt) {
+    mixxx::Bpm bpm;
+    if (m_pPlugin->finalize()) {
+        if (m_pPlugin->supportsBeatTracking()) {
+            // The plugin counts the frames from the start of the excerpt
+            QVector<mixxx::audio::FramePos> beats = m_pPlugin->getBeats();
+            for (auto& beat : beats) {
+                beat += excerpt.start();
+            }
+            bpm = BeatUtils::calculateBpm(beats, m_sampleRate);
+            m_excerptBeats.resize(m_excerpts.currentIndex() + 1);
+            m_excerptBeats.back() = std::move(beats);
         } else {
-            SampleUtil::mixMultichannelToStereo(pDrumChannel, pIn, numFrames, m_channelCount);
+            bpm = m_pPlugin->getBpm();
         }
-
-        pBeatInput = pDrumChannel;
-    } else if (m_channelCount > mixxx::audio::ChannelCount::stereo()) {
-        DEBUG_ASSERT(!"Unsupported channel count");
-        return false;
     }
-
-    m_currentFrame += numFrames;
-    if (m_currentFrame > m_maxFramesToProcess) {
-        return true; // silently ignore all remaining samples
+    qDebug() << "AnalyzerBeats estimated" << bpm << "BPM in the excerpt" << excerpt;
+    if (!bpm.isValid()) {
+        return std::nullopt;
     }
+    return bpm.value();
+}
 
-    bool ret = m_pPlugin->processSamples(pBeatInput, count);
-    if (pDrumChannel) {
-        SampleUtil::free(pDrumChannel);
+SINT AnalyzerBeats::nextFrameNeeded(SINT frameIndex) const {
+    if (!m_excerpts.isEmpty()) {
+        return m_excerpts.nextFrameNeeded(frameIndex);
     }
-    return ret;
+    if (frameIndex >= m_maxFramesToProcess) {
+        return std::numeric_limits<SINT>::max();
+    }
+    return frameIndex;
 }
 
 void AnalyzerBeats::cleanup() {
@@ -251,6 +330,10 @@ void AnalyzerBeats::storeResults(TrackPointer pTrack) {
     VERIFY_OR_DEBUG_ASSERT(m_pPlugin) {
         return;
     }
+    if (!m_excerpts.isEmpty()) {
+        storeExcerptResults(pTrack);
+        return;
+    }
 
     if (!m_pPlugin->finalize()) {
         qWarning() << "Beat/BPM analysis failed";
@@ -284,6 +367,49 @@ void AnalyzerBeats::storeResults(TrackPointer pTrack) {
     pTrack->trySetBeats(pBeats);
 }
 
+void AnalyzerBeats::storeExcerptResults(TrackPointer pTrack) {
+    // The last excerpt is incomplete if the track is shorter than expected
+    m_excerpts.finishIncomplete(m_currentFrame, this);
+    const auto bpmEstimate = m_excerpts.estimate();
+    if (!bpmEstimate) {
+        qWarning() << "Beat/BPM analysis failed";
+        return;
+    }
+
+    QHash<QString, QString> extraVersionInfo = getExtraVersionInfo(
+            m_pluginId, m_bPreferencesFastAnalysis);
+    if (m_excerpts.isLowConfidence()) {
+        qDebug() << "AnalyzerBeats: The BPM of the excerpts disagree, the track"
+                 << "will be analyzed again in full";
+        AnalyzerExcerpts::markLowConfidence(&extraVersionInfo);
+    }
+
+    mixxx::BeatsPointer pBeats;
+    if (m_pPlugin->supportsBeatTracking()) {
+        // Only the beats of the excerpts that agree with the estimate
+        QVector<mixxx::audio::FramePos> beats;
+        for (int i = 0; i < static_cast<int>(m_excerptBeats.size()); ++i) {
+            if (m_excerpts.agreesWithEstimate(i)) {
+                beats += m_excerptBeats[i];
+            }
+        }
+        DEBUG_ASSERT(m_bPreferencesFixedTempo);
+        pBeats = BeatFactory::makePreferredBeats(
+                beats,
+                extraVersionInfo,
+                m_bPreferencesFixedTempo,
+                m_sampleRate);
+    } else {
+        const auto bpm = mixxx::Bpm(*bpmEstimate);
+        qDebug() << "AnalyzerBeats plugin detected constant BPM: " << bpm;
+        pBeats = mixxx::Beats::fromConstTempo(m_sampleRate, mixxx::audio::kStartFramePos, bpm);
+    }
+    qDebug() << "AnalyzerBeats estimated the BPM from"
+             << m_excerpts.currentIndex() << "of" << m_excerpts.size() << "excerpts";
+
+    pTrack->trySetBeats(pBeats);
+}
+
 // static
 QHash<QString, QString> AnalyzerBeats::getExtraVersionInfo(
         const QString& pluginId, bool bPreferencesFastAnalysis) {
@@ -3,13 +3,16 @@
 #include <QHash>
 #include <QList>
 #include <memory>
+#include <optional>
+#include <vector>
 
 #include "analyzer/analyzer.h"
+#include "analyzer/analyzerexcerpts.h"
 #include "analyzer/plugins/analyzerplugin.h"
 #include "preferences/beatdetectionsettings.h"
 #include "preferences/usersettings.h"
 
-class AnalyzerBeats : public Analyzer {
+class AnalyzerBeats : public Analyzer, private AnalyzerExcerpts::Callback {
   public:
     explicit AnalyzerBeats(
             UserSettingsPointer pConfig,
@@ -24,11 +27,17 @@ class AnalyzerBeats : public Analyzer {
             mixxx::audio::ChannelCount channelCount,
             SINT frameLength) override;
     bool processSamples(const CSAMPLE* pIn, SINT count) override;
+    bool processChunk(AnalyzerFrontEnd* pFrontEnd) override;
+    SINT nextFrameNeeded(SINT frameIndex) const override;
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
 
   private:
     bool shouldAnalyze(TrackPointer pTrack) const;
+    bool startPlugin() override;
+    bool processFrames(AnalyzerFrontEnd* pFrontEnd, SINT offset, SINT frameCount) override;
+    std::optional<double> finishExcerpt(mixxx::IndexRange excerpt) override;
+    void storeExcerptResults(TrackPointer pTrack);
     static QHash<QString, QString> getExtraVersionInfo(
             const QString& pluginId, bool bPreferencesFastAnalysis);
 
@@ -45,4 +54,9 @@ class AnalyzerBeats : public Analyzer {
     mixxx::audio::ChannelCount m_channelCount;
     SINT m_maxFramesToProcess;
     SINT m_currentFrame;
+    // Only used in fast analysis mode with a fixed tempo
+    AnalyzerExcerpts m_excerpts;
+    std::vector<QVector<mixxx::audio::FramePos>> m_excerptBeats;
+    // The drum stem of stem files, if beat detection is limited to it
+    mixxx::SampleBuffer m_drumStem;
 };
@@ -0,0 +1,178 @@
+#include "analyzer/analyzerexcerpts.h"
+
+#include <QStringList>
+#include <algorithm>
+#include <cmath>
+
+#include "analyzer/analyzerfrontend.h"
+#include "analyzer/constants.h"
+#include "util/assert.h"
+
+namespace {
+
+const QString kConfidenceVersionKey = QStringLiteral("confidence");
+const QString kLowConfidenceVersionValue = QStringLiteral("low");
+
+} // anonymous namespace
+
+AnalyzerExcerpts::AnalyzerExcerpts()
+        : m_frameLength(0),
+          m_relativeTolerance(0.0) {
+}
+
+AnalyzerExcerpts::AnalyzerExcerpts(mixxx::audio::SampleRate sampleRate,
+        SINT frameLength,
+        double relativeTolerance)
+        : m_frameLength(frameLength),
+          m_relativeTolerance(relativeTolerance) {
+    DEBUG_ASSERT(sampleRate.isValid());
+    DEBUG_ASSERT(frameLength > 0);
+    const SINT excerptLength = mixxx::kFastAnalysisSecondsPerExcerpt * sampleRate;
+    const int count = static_cast<int>(std::min<SINT>(
+            mixxx::kFastAnalysisExcerptCount, frameLength / excerptLength));
+    if (count < 2) {
+        // Too short for excerpts, analyze the whole track as one
+        m_excerpts.push_back(mixxx::IndexRange::forward(0, frameLength));
+        return;
+    }
+    // The first excerpt starts at the beginning and the last one ends at
+    // the end of the track
+    m_excerpts.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const SINT start = (frameLength - excerptLength) * i / (count - 1);
+        m_excerpts.push_back(mixxx::IndexRange::forward(start, excerptLength));
+    }
+}
+
+bool AnalyzerExcerpts::processChunk(AnalyzerFrontEnd* pFrontEnd, Callback* pCallback) {
+    const auto chunk = mixxx::IndexRange::forward(
+            pFrontEnd->frameIndex(), pFrontEnd->frameCount());
+    while (!isFinished()) {
+        const mixxx::IndexRange excerpt = current();
+        const SINT start = std::max(chunk.start(), excerpt.start());
+        const SINT end = std::min(chunk.end(), excerpt.end());
+        if (start < end &&
+                !pCallback->processFrames(pFrontEnd, start - chunk.start(), end - start)) {
+            return false;
+        }
+        if (chunk.end() < excerpt.end()) {
+            break;
+        }
+        if (!finishCurrent(pCallback)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AnalyzerExcerpts::finishIncomplete(SINT frameIndex, Callback* pCallback) {
+    if (!isFinished() && frameIndex > current().start()) {
+        finishCurrent(pCallback);
+    }
+}
+
+bool AnalyzerExcerpts::finishCurrent(Callback* pCallback) {
+    const auto estimate = pCallback->finishExcerpt(current());
+    if (estimate) {
+        addEstimate(*estimate);
+    } else {
+        skipEstimate();
+    }
+    if (isFinished()) {
+        return true;
+    }
+    // Each excerpt is analyzed from scratch
+    return pCallback->startPlugin();
+}
+
+void AnalyzerExcerpts::addEstimate(double estimate) {
+    VERIFY_OR_DEBUG_ASSERT(currentIndex() < size()) {
+        return;
+    }
+    m_estimates.push_back(estimate);
+}
+
+void AnalyzerExcerpts::skipEstimate() {
+    VERIFY_OR_DEBUG_ASSERT(currentIndex() < size()) {
+        return;
+    }
+    m_estimates.push_back(std::nullopt);
+}
+
+bool AnalyzerExcerpts::agree(double lhs, double rhs) const {
+    return std::fabs(lhs - rhs) <= m_relativeTolerance * std::fabs(lhs);
+}
+
+std::optional<int> AnalyzerExcerpts::bestIndex(int* pAgreeingCount) const {
+    std::optional<int> best;
+    int bestCount = 0;
+    for (int i = 0; i < static_cast<int>(m_estimates.size()); ++i) {
+        if (!m_estimates[i]) {
+            continue;
+        }
+        int count = 0;
+        for (const auto& other : m_estimates) {
+            if (other && agree(*m_estimates[i], *other)) {
+                ++count;
+            }
+        }
+        if (count > bestCount) {
+            best = i;
+            bestCount = count;
+        }
+    }
+    if (pAgreeingCount) {
+        *pAgreeingCount = bestCount;
+    }
+    return best;
+}
+
+bool AnalyzerExcerpts::hasConverged() const {
+    if (isEmpty()) {
+        return false;
+    }
+    int agreeingCount = 0;
+    if (!bestIndex(&agreeingCount)) {
+        return false;
+    }
+    // Short tracks have fewer excerpts
+    const int minAgreeingCount = std::min(mixxx::kFastAnalysisMinAgreeingExcerpts, size());
+    return agreeingCount >= minAgreeingCount &&
+            agreeingCount * 3 >= static_cast<int>(m_estimates.size()) * 2;
+}
+
+std::optional<double> AnalyzerExcerpts::estimate() const {
+    const auto index = bestIndex(nullptr);
+    if (!index) {
+        return std::nullopt;
+    }
+    return m_estimates[*index];
+}
+
+bool AnalyzerExcerpts::agreesWithEstimate(int index) const {
+    if (index >= static_cast<int>(m_estimates.size()) || !m_estimates[index]) {
+        return false;
+    }
+    const auto trackEstimate = estimate();
+    return trackEstimate && agree(*trackEstimate, *m_estimates[index]);
+}
+
+SINT AnalyzerExcerpts::nextFrameNeeded(SINT frameIndex) const {
+    if (isFinished()) {
+        return m_frameLength;
+    }
+    return std::max(frameIndex, current().start());
+}
+
+// static
+void AnalyzerExcerpts::markLowConfidence(QHash<QString, QString>* pExtraVersionInfo) {
+    pExtraVersionInfo->insert(kConfidenceVersionKey, kLowConfidenceVersionValue);
+}
+
+// static
+bool AnalyzerExcerpts::isLowConfidence(const QString& subVersion) {
+    // See BeatFactory::getPreferredSubVersion() and
+    // KeyFactory::getPreferredSubVersion()
+    return subVersion.split(QChar('|')).contains(
+            kConfidenceVersionKey + QChar('=') + kLowConfidenceVersionValue);
+}
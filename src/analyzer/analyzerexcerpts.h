@@ -0,0 +1,109 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <optional>
+#include <vector>
+
+#include "audio/types.h"
+#include "util/indexrange.h"
+#include "util/types.h"
+
+class AnalyzerFrontEnd;
+
+/// AnalyzerExcerpts splits a track into strided excerpts for the fast
+/// analysis of its tempo or key. The excerpts are spread evenly from the
+/// start to the end of the track, so an intro without drums or in a
+/// different key doesn't determine the result on its own.
+///
+/// An analyzer processes the excerpts in order and adds an estimate for
+/// each of them. The estimate has converged once
+/// kFastAnalysisMinAgreeingExcerpts and at least two thirds of the
+/// estimates agree. The remaining excerpts are skipped then. If the
+/// estimates still disagree after the last excerpt, the result has a low
+/// confidence and the track is analyzed in full next time.
+class AnalyzerExcerpts final {
+  public:
+    /// The analyzer specific part of the excerpt loop
+    class Callback {
+      public:
+        virtual ~Callback() = default;
+
+        /// Analyzes frameCount frames of the chunk from offset on
+        virtual bool processFrames(
+                AnalyzerFrontEnd* pFrontEnd, SINT offset, SINT frameCount) = 0;
+        /// Finalizes the analysis of the excerpt and returns its estimate
+        virtual std::optional<double> finishExcerpt(mixxx::IndexRange excerpt) = 0;
+        /// Starts the analysis from scratch for the next excerpt
+        virtual bool startPlugin() = 0;
+    };
+
+    /// No excerpts, i.e. the whole track is analyzed
+    AnalyzerExcerpts();
+    /// Estimates agree if they differ by at most relativeTolerance
+    AnalyzerExcerpts(mixxx::audio::SampleRate sampleRate,
+            SINT frameLength,
+            double relativeTolerance);
+
+    bool isEmpty() const {
+        return m_excerpts.empty();
+    }
+    int size() const {
+        return static_cast<int>(m_excerpts.size());
+    }
+    mixxx::IndexRange at(int index) const {
+        return m_excerpts[index];
+    }
+
+    /// The excerpt that is analyzed currently. Only valid until finished.
+    int currentIndex() const {
+        return static_cast<int>(m_estimates.size());
+    }
+    mixxx::IndexRange current() const {
+        return at(currentIndex());
+    }
+
+    /// Passes the frames of the chunk that belong to excerpts to the
+    /// callback and finishes every excerpt that ends in the chunk.
+    bool processChunk(AnalyzerFrontEnd* pFrontEnd, Callback* pCallback);
+    /// Finishes the current excerpt if the track ended within it, i.e. the
+    /// track is shorter than expected.
+    void finishIncomplete(SINT frameIndex, Callback* pCallback);
+
+    /// Finishes the current excerpt
+    void addEstimate(double estimate);
+    /// Finishes the current excerpt without an estimate
+    void skipEstimate();
+
+    /// True if all excerpts are finished or the estimate has converged
+    bool isFinished() const {
+        return isEmpty() || currentIndex() >= size() || hasConverged();
+    }
+    bool hasConverged() const;
+    /// The estimate of the track, if any excerpt had an estimate
+    std::optional<double> estimate() const;
+    /// True if the estimate of the given excerpt agrees with estimate()
+    bool agreesWithEstimate(int index) const;
+    bool isLowConfidence() const {
+        return !hasConverged();
+    }
+
+    /// The first frame at or after frameIndex that is needed for the
+    /// excerpts, or the length of the track once finished.
+    SINT nextFrameNeeded(SINT frameIndex) const;
+
+    /// Adds the extra version info of results with a low confidence
+    static void markLowConfidence(QHash<QString, QString>* pExtraVersionInfo);
+    static bool isLowConfidence(const QString& subVersion);
+
+  private:
+    bool finishCurrent(Callback* pCallback);
+    bool agree(double lhs, double rhs) const;
+    // The index of the estimate most other estimates agree with
+    std::optional<int> bestIndex(int* pAgreeingCount) const;
+
+    SINT m_frameLength;
+    double m_relativeTolerance;
+    std::vector<mixxx::IndexRange> m_excerpts;
+    std::vector<std::optional<double>> m_estimates;
+};
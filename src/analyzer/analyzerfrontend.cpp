@@ -0,0 +1,66 @@
+#include "analyzer/analyzerfrontend.h"
+
+#include "analyzer/constants.h"
+#include "util/assert.h"
+#include "util/sample.h"
+
+AnalyzerFrontEnd::AnalyzerFrontEnd(mixxx::audio::ChannelCount channelCount)
+        : m_channelCount(channelCount),
+          m_pSamples(nullptr),
+          m_frameIndex(0),
+          m_frameCount(0),
+          m_stereoValid(false),
+          m_monoValid(false) {
+}
+
+void AnalyzerFrontEnd::initialize(mixxx::audio::ChannelCount channelCount) {
+    DEBUG_ASSERT(channelCount % mixxx::audio::ChannelCount::stereo() == 0);
+    m_channelCount = channelCount;
+    setChunk(nullptr, 0);
+    // Allocate upfront for full chunks, which avoids allocations while
+    // analyzing. The buffers are only used if an analyzer requests them.
+    if (m_channelCount > mixxx::audio::ChannelCount::stereo()) {
+        reserve(&m_stereo,
+                mixxx::kAnalysisFramesPerChunk * mixxx::audio::ChannelCount::stereo());
+    }
+    reserve(&m_mono, mixxx::kAnalysisFramesPerChunk);
+}
+
+void AnalyzerFrontEnd::setChunk(const CSAMPLE* pSamples, SINT sampleCount, SINT frameIndex) {
+    DEBUG_ASSERT(sampleCount % m_channelCount == 0);
+    m_pSamples = pSamples;
+    m_frameIndex = frameIndex;
+    m_frameCount = sampleCount / m_channelCount;
+    m_stereoValid = false;
+    m_monoValid = false;
+}
+
+const CSAMPLE* AnalyzerFrontEnd::stereo() {
+    if (m_channelCount == mixxx::audio::ChannelCount::stereo()) {
+        return m_pSamples;
+    }
+    if (!m_stereoValid) {
+        reserve(&m_stereo, stereoSampleCount());
+        SampleUtil::mixMultichannelToStereo(
+                m_stereo.data(), m_pSamples, m_frameCount, m_channelCount);
+        m_stereoValid = true;
+    }
+    return m_stereo.data();
+}
+
+const CSAMPLE* AnalyzerFrontEnd::mono() {
+    if (!m_monoValid) {
+        const CSAMPLE* pStereo = stereo();
+        reserve(&m_mono, m_frameCount);
+        SampleUtil::mixMultichannelToMono(m_mono.data(), pStereo, stereoSampleCount());
+        m_monoValid = true;
+    }
+    return m_mono.data();
+}
+
+// static
+void AnalyzerFrontEnd::reserve(mixxx::SampleBuffer* pBuffer, SINT size) {
+    if (pBuffer->size() < size) {
+        mixxx::SampleBuffer(size).swap(*pBuffer);
+    }
+}
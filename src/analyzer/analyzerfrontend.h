@@ -0,0 +1,69 @@
+#pragma once
+
+#include "audio/types.h"
+#include "util/samplebuffer.h"
+#include "util/types.h"
+
+/// AnalyzerFrontEnd prepares the representations of a decoded chunk that the
+/// analyzers need, once for all of them. Without it every analyzer converts
+/// the chunk on its own, e.g. the beats and key analyzers each mix the stems
+/// of a stem file to stereo and downmix that to mono.
+///
+/// The representations are computed on the first request and are valid until
+/// the next chunk is set. The analyzers of a thread run one after another on
+/// the same chunk, so no synchronization is needed.
+class AnalyzerFrontEnd final {
+  public:
+    explicit AnalyzerFrontEnd(
+            mixxx::audio::ChannelCount channelCount = mixxx::audio::ChannelCount::stereo());
+
+    /// Prepares the buffers for the chunks of a track with channelCount
+    /// interleaved channels.
+    void initialize(mixxx::audio::ChannelCount channelCount);
+
+    /// Starts the next chunk. The samples must stay valid until the analyzers
+    /// have processed it. frameIndex is the position of the chunk in the
+    /// track, which is not contiguous if frames have been skipped.
+    void setChunk(const CSAMPLE* pSamples, SINT sampleCount, SINT frameIndex = 0);
+
+    mixxx::audio::ChannelCount channelCount() const {
+        return m_channelCount;
+    }
+    SINT frameIndex() const {
+        return m_frameIndex;
+    }
+    SINT frameCount() const {
+        return m_frameCount;
+    }
+
+    /// The decoded samples with all channels
+    const CSAMPLE* samples() const {
+        return m_pSamples;
+    }
+    SINT sampleCount() const {
+        return m_frameCount * m_channelCount;
+    }
+
+    /// All channels mixed to stereo, i.e. all stems of a stem file. The
+    /// decoded samples of a stereo track.
+    const CSAMPLE* stereo();
+    SINT stereoSampleCount() const {
+        return m_frameCount * mixxx::audio::ChannelCount::stereo();
+    }
+
+    /// The stereo mix downmixed to one channel with (L+R)/2
+    const CSAMPLE* mono();
+
+  private:
+    static void reserve(mixxx::SampleBuffer* pBuffer, SINT size);
+
+    mixxx::audio::ChannelCount m_channelCount;
+    const CSAMPLE* m_pSamples;
+    SINT m_frameIndex;
+    SINT m_frameCount;
+
+    mixxx::SampleBuffer m_stereo;
+    mixxx::SampleBuffer m_mono;
+    bool m_stereoValid;
+    bool m_monoValid;
+};
@@ -36,32 +36,25 @@ void AnalyzerGain::cleanup() {
 }
 
 bool AnalyzerGain::processSamples(const CSAMPLE* pIn, SINT count) {
+    // Only used without the shared front-end of the AnalyzerThread
+    AnalyzerFrontEnd frontEnd(m_channelCount);
+    frontEnd.setChunk(pIn, count);
+    return processChunk(&frontEnd);
+}
+
+bool AnalyzerGain::processChunk(AnalyzerFrontEnd* pFrontEnd) {
     ScopedTimer t(QStringLiteral("AnalyzerGain::process()"));
 
-    SINT numFrames = count / m_channelCount;
-
-    const CSAMPLE* pGainInput = pIn;
-    CSAMPLE* pMixedChannel = nullptr;
-
-    if (m_channelCount == mixxx::audio::ChannelCount::stem()) {
-        // We have an 8 channel soundsource. The only implemented soundsource with
-        // 8ch is the NI STEM file format.
-        // TODO: If we add other soundsources with 8ch, we need to rework this condition.
-        //
-        // For NI STEM we mix all the stems together except the first one,
-        // which contains drums or beats by convention.
-        count = numFrames * mixxx::audio::ChannelCount::stereo();
-        pMixedChannel = SampleUtil::alloc(count);
-        VERIFY_OR_DEBUG_ASSERT(pMixedChannel) {
-            return false;
-        }
-        SampleUtil::mixMultichannelToStereo(pMixedChannel, pIn, numFrames, m_channelCount);
-        pGainInput = pMixedChannel;
-    } else if (m_channelCount > mixxx::audio::ChannelCount::stereo()) {
+    if (m_channelCount > mixxx::audio::ChannelCount::stereo() &&
+            m_channelCount != mixxx::audio::ChannelCount::stem()) {
         DEBUG_ASSERT(!"Unsupported channel count");
         return false;
     }
 
+    // For NI STEM the front-end mixes all the stems together
+    const CSAMPLE* pGainInput = pFrontEnd->stereo();
+    const SINT numFrames = pFrontEnd->frameCount();
+
     if (numFrames > static_cast<SINT>(m_pLeftTempBuffer.size())) {
         m_pLeftTempBuffer.resize(numFrames);
         m_pRightTempBuffer.resize(numFrames);
@@ -72,12 +65,8 @@ bool AnalyzerGain::processSamples(const CSAMPLE* pIn, SINT count) {
             numFrames);
     SampleUtil::applyGain(m_pLeftTempBuffer.data(), 32767, numFrames);
     SampleUtil::applyGain(m_pRightTempBuffer.data(), 32767, numFrames);
-    bool ret = m_pReplayGain->process(
+    return m_pReplayGain->process(
             m_pLeftTempBuffer.data(), m_pRightTempBuffer.data(), numFrames);
-    if (pMixedChannel) {
-        SampleUtil::free(pMixedChannel);
-    }
-    return ret;
 }
 
 void AnalyzerGain::storeResults(TrackPointer pTrack) {
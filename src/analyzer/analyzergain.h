@@ -29,6 +29,7 @@ class AnalyzerGain : public Analyzer {
             mixxx::audio::ChannelCount channelCount,
             SINT frameLength) override;
     bool processSamples(const CSAMPLE* pIn, SINT count) override;
+    bool processChunk(AnalyzerFrontEnd* pFrontEnd) override;
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
 
@@ -10,6 +10,7 @@
 #include "analyzer/plugins/analyzerqueenmarykey.h"
 #include "proto/keys.pb.h"
 #include "track/keyfactory.h"
+#include "track/keyutils.h"
 #include "track/track.h"
 
 namespace {
@@ -82,47 +83,57 @@ bool AnalyzerKey::initialize(const AnalyzerTrack& track,
     m_sampleRate = sampleRate;
     m_channelCount = channelCount;
     m_totalFrames = frameLength;
-    // In fast analysis mode, skip processing after
-    // kFastAnalysisSecondsToAnalyze seconds are analyzed.
+    m_maxFramesToProcess = frameLength;
+    m_currentFrame = 0;
+    m_excerpts = AnalyzerExcerpts();
+
+    if (m_bPreferencesFastAnalysisEnabled &&
+            AnalyzerExcerpts::isLowConfidence(track.getTrack()->getKeys().getSubVersion())) {
+        qDebug() << "Analyzing the whole track, because the result of the"
+                 << "fast analysis had a low confidence";
+        m_bPreferencesFastAnalysisEnabled = false;
+    }
     if (m_bPreferencesFastAnalysisEnabled) {
-        m_maxFramesToProcess = mixxx::kFastAnalysisSecondsToAnalyze * m_sampleRate;
-    } else {
-        m_maxFramesToProcess = frameLength;
+        // Estimate the key from strided excerpts of the track
+        m_excerpts = AnalyzerExcerpts(m_sampleRate, frameLength, 0.0);
     }
-    m_currentFrame = 0;
 
     // if we can't load a stored track reanalyze it
     bool bShouldAnalyze = shouldAnalyze(track.getTrack());
 
     DEBUG_ASSERT(!m_pPlugin);
     if (bShouldAnalyze) {
-        if (m_pluginId == mixxx::AnalyzerQueenMaryKey::pluginInfo().id()) {
-            m_pPlugin = std::make_unique<mixxx::AnalyzerQueenMaryKey>();
-#if defined __KEYFINDER__
-        } else if (m_pluginId == mixxx::AnalyzerKeyFinder::pluginInfo().id()) {
-            m_pPlugin = std::make_unique<mixxx::AnalyzerKeyFinder>();
-#endif
-        } else {
-            // This must not happen, because we have already verified above
-            // that the PlugInId is valid
-            DEBUG_ASSERT(false);
-        }
-
-        if (m_pPlugin) {
-            if (m_pPlugin->initialize(mixxx::audio::SampleRate(m_sampleRate))) {
-                qDebug() << "Key calculation started with plugin" << m_pluginId;
-            } else {
-                qDebug() << "Key calculation will not start.";
-                m_pPlugin.reset();
-                bShouldAnalyze = false;
-            }
+        if (startPlugin()) {
+            qDebug() << "Key calculation started with plugin" << m_pluginId;
         } else {
+            qDebug() << "Key calculation will not start.";
             bShouldAnalyze = false;
         }
     }
     return bShouldAnalyze;
 }
 
+bool AnalyzerKey::startPlugin() {
+    if (m_pluginId == mixxx::AnalyzerQueenMaryKey::pluginInfo().id()) {
+        m_pPlugin = std::make_unique<mixxx::AnalyzerQueenMaryKey>();
+#if defined __KEYFINDER__
+    } else if (m_pluginId == mixxx::AnalyzerKeyFinder::pluginInfo().id()) {
+        m_pPlugin = std::make_unique<mixxx::AnalyzerKeyFinder>();
+#endif
+    } else {
+        // This must not happen, because we have already verified above
+        // that the PlugInId is valid
+        DEBUG_ASSERT(false);
+        m_pPlugin.reset();
+        return false;
+    }
+    if (!m_pPlugin->initialize(m_sampleRate)) {
+        m_pPlugin.reset();
+        return false;
+    }
+    return true;
+}
+
 bool AnalyzerKey::shouldAnalyze(TrackPointer pTrack) const {
     bool bPreferencesFastAnalysisEnabled = m_keySettings.getFastAnalysis();
     QString pluginID = m_keySettings.getKeyPluginId();
@@ -135,6 +146,11 @@ bool AnalyzerKey::shouldAnalyze(TrackPointer pTrack) const {
         QString version = keys.getVersion();
         QString subVersion = keys.getSubVersion();
 
+        if (AnalyzerExcerpts::isLowConfidence(subVersion)) {
+            qDebug() << "Re-analyzing track with a low confidence key from fast analysis.";
+            return true;
+        }
+
         QHash<QString, QString> extraVersionInfo = getExtraVersionInfo(
                 pluginID, bPreferencesFastAnalysisEnabled);
         QString newVersion = KeyFactory::getPreferredVersion();
@@ -157,55 +173,87 @@ bool AnalyzerKey::shouldAnalyze(TrackPointer pTrack) const {
 }
 
 bool AnalyzerKey::processSamples(const CSAMPLE* pIn, SINT count) {
+    // Only used without the shared front-end of the AnalyzerThread
+    AnalyzerFrontEnd frontEnd(m_channelCount);
+    frontEnd.setChunk(pIn, count, m_currentFrame);
+    return processChunk(&frontEnd);
+}
+
+bool AnalyzerKey::processChunk(AnalyzerFrontEnd* pFrontEnd) {
     VERIFY_OR_DEBUG_ASSERT(m_pPlugin) {
         return false;
     }
 
-    SINT numFrames = count / m_channelCount;
-    m_currentFrame += numFrames;
+    const SINT numFrames = pFrontEnd->frameCount();
+    m_currentFrame = pFrontEnd->frameIndex() + numFrames;
 
     if (m_currentFrame > m_maxFramesToProcess) {
         return true; // silently ignore remaining samples
     }
 
-    const CSAMPLE* pKeyInput = pIn;
-    CSAMPLE* pHarmonicMixedChannel = nullptr;
+    if (m_channelCount > mixxx::audio::ChannelCount::stereo() &&
+            m_channelCount != mixxx::audio::ChannelCount::stem()) {
+        DEBUG_ASSERT(!"Unsupported channel count");
+        return false;
+    }
 
-    if (m_channelCount == mixxx::audio::ChannelCount::stem()) {
+    if (!m_excerpts.isEmpty()) {
+        return m_excerpts.processChunk(pFrontEnd, this);
+    }
+    return processFrames(pFrontEnd, 0, numFrames);
+}
+
+bool AnalyzerKey::processFrames(
+        AnalyzerFrontEnd* pFrontEnd, SINT offset, SINT frameCount) {
+    DEBUG_ASSERT(offset + frameCount <= pFrontEnd->frameCount());
+    if (m_channelCount == mixxx::audio::ChannelCount::stem() &&
+            m_keySettings.getStemStrategy() == KeyDetectionSettings::StemStrategy::Enforced) {
         // We have an 8 channel soundsource. The only implemented soundsource with
         // 8ch is the NI STEM file format.
         // TODO: If we add other soundsources with 8ch, we need to rework this condition.
         //
         // For NI STEM we mix all the stems together except the first one,
         // which contains drums or beats by convention.
-        count = numFrames * mixxx::audio::ChannelCount::stereo();
-        pHarmonicMixedChannel = SampleUtil::alloc(count);
-        VERIFY_OR_DEBUG_ASSERT(pHarmonicMixedChannel) {
-            return false;
+        const SINT count = frameCount * mixxx::audio::ChannelCount::stereo();
+        if (m_harmonicStems.size() < count) {
+            mixxx::SampleBuffer(count).swap(m_harmonicStems);
         }
+        SampleUtil::mixMultichannelToStereo(m_harmonicStems.data(),
+                pFrontEnd->samples() + offset * m_channelCount,
+                frameCount,
+                m_channelCount,
+                excludeFirstChannelMask);
+        return m_pPlugin->processSamples(m_harmonicStems.data(), count);
+    }
 
-        if (m_keySettings.getStemStrategy() == KeyDetectionSettings::StemStrategy::Enforced) {
-            SampleUtil::mixMultichannelToStereo(pHarmonicMixedChannel,
-                    pIn,
-                    numFrames,
-                    m_channelCount,
-                    excludeFirstChannelMask);
-        } else {
-            SampleUtil::mixMultichannelToStereo(
-                    pHarmonicMixedChannel, pIn, numFrames, m_channelCount);
-        }
+    if (m_pPlugin->supportsMonoInput()) {
+        return m_pPlugin->processMonoSamples(pFrontEnd->mono() + offset, frameCount);
+    }
+    return m_pPlugin->processSamples(
+            pFrontEnd->stereo() + offset * mixxx::audio::ChannelCount::stereo(),
+            frameCount * mixxx::audio::ChannelCount::stereo());
+}
 
-        pKeyInput = pHarmonicMixedChannel;
-    } else if (m_channelCount > mixxx::audio::ChannelCount::stereo()) {
-        DEBUG_ASSERT(!"Unsupported channel count");
-        return false;
+std::optional<double> AnalyzerKey::finishExcerpt(mixxx::IndexRange excerpt) {
+    auto key = mixxx::track::io::key::INVALID;
+    if (m_pPlugin->finalize()) {
+        // The plugin counts the frames from the start of the excerpt
+        key = KeyUtils::calculateGlobalKey(
+                m_pPlugin->getKeyChanges(), excerpt.length(), m_sampleRate);
+    }
+    qDebug() << "AnalyzerKey estimated" << KeyUtils::keyDebugName(key)
+             << "in the excerpt" << excerpt;
+    if (key == mixxx::track::io::key::INVALID) {
+        return std::nullopt;
     }
+    return key;
+}
 
-    bool ret = m_pPlugin->processSamples(pKeyInput, count);
-    if (pHarmonicMixedChannel) {
-        SampleUtil::free(pHarmonicMixedChannel);
+SINT AnalyzerKey::nextFrameNeeded(SINT frameIndex) const {
+    if (!m_excerpts.isEmpty()) {
+        return m_excerpts.nextFrameNeeded(frameIndex);
     }
-    return ret;
+    return frameIndex;
 }
 
 void AnalyzerKey::cleanup() {
@@ -216,6 +264,10 @@ void AnalyzerKey::storeResults(TrackPointer tio) {
     VERIFY_OR_DEBUG_ASSERT(m_pPlugin) {
         return;
     }
+    if (!m_excerpts.isEmpty()) {
+        storeExcerptResults(tio);
+        return;
+    }
 
     if (!m_pPlugin->finalize()) {
         qWarning() << "Key detection failed";
@@ -230,11 +282,42 @@ void AnalyzerKey::storeResults(TrackPointer tio) {
     tio->setKeys(track_keys);
 }
 
+void AnalyzerKey::storeExcerptResults(TrackPointer tio) {
+    // The last excerpt is incomplete if the track is shorter than expected
+    m_excerpts.finishIncomplete(m_currentFrame, this);
+    const auto keyEstimate = m_excerpts.estimate();
+    if (!keyEstimate) {
+        qWarning() << "Key detection failed";
+        return;
+    }
+
+    QHash<QString, QString> extraVersionInfo = getExtraVersionInfo(
+            m_pluginId, m_bPreferencesFastAnalysisEnabled);
+    if (m_excerpts.isLowConfidence()) {
+        qDebug() << "AnalyzerKey: The keys of the excerpts disagree, the track"
+                 << "will be analyzed again in full";
+        AnalyzerExcerpts::markLowConfidence(&extraVersionInfo);
+    }
+
+    // The excerpts don't tell where the key changes, only the global key
+    KeyChangeList key_changes;
+    key_changes.push_back(qMakePair(
+            static_cast<mixxx::track::io::key::ChromaticKey>(*keyEstimate), 0.0));
+    Keys track_keys = KeyFactory::makePreferredKeys(
+            key_changes, extraVersionInfo, m_sampleRate, m_totalFrames);
+    tio->setKeys(track_keys);
+}
+
 // static
 QHash<QString, QString> AnalyzerKey::getExtraVersionInfo(
         const QString& pluginId, bool bPreferencesFastAnalysis) {
     QHash<QString, QString> extraVersionInfo;
     extraVersionInfo["vamp_plugin_id"] = pluginId;
+#if defined __KEYFINDER__
+    if (pluginId == mixxx::AnalyzerKeyFinder::pluginInfo().id()) {
+        extraVersionInfo.insert(mixxx::AnalyzerKeyFinder::extraVersionInfo());
+    }
+#endif
     if (bPreferencesFastAnalysis) {
         extraVersionInfo["fast_analysis"] = "1";
     }
@@ -4,13 +4,15 @@
 #include <QList>
 #include <QString>
 #include <memory>
+#include <optional>
 
 #include "analyzer/analyzer.h"
+#include "analyzer/analyzerexcerpts.h"
 #include "analyzer/plugins/analyzerplugin.h"
 #include "preferences/keydetectionsettings.h"
 #include "track/track_decl.h"
 
-class AnalyzerKey : public Analyzer {
+class AnalyzerKey : public Analyzer, private AnalyzerExcerpts::Callback {
   public:
     explicit AnalyzerKey(const KeyDetectionSettings& keySettings);
     ~AnalyzerKey() override = default;
@@ -23,6 +25,8 @@ class AnalyzerKey : public Analyzer {
             mixxx::audio::ChannelCount channelCount,
             SINT frameLength) override;
     bool processSamples(const CSAMPLE* pIn, SINT count) override;
+    bool processChunk(AnalyzerFrontEnd* pFrontEnd) override;
+    SINT nextFrameNeeded(SINT frameIndex) const override;
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
 
@@ -31,6 +35,10 @@ class AnalyzerKey : public Analyzer {
             const QString& pluginId, bool bPreferencesFastAnalysis);
 
     bool shouldAnalyze(TrackPointer tio) const;
+    bool startPlugin() override;
+    bool processFrames(AnalyzerFrontEnd* pFrontEnd, SINT offset, SINT frameCount) override;
+    std::optional<double> finishExcerpt(mixxx::IndexRange excerpt) override;
+    void storeExcerptResults(TrackPointer tio);
 
     KeyDetectionSettings m_keySettings;
     std::unique_ptr<mixxx::AnalyzerKeyPlugin> m_pPlugin;
@@ -40,6 +48,10 @@ class AnalyzerKey : public Analyzer {
     SINT m_totalFrames;
     SINT m_maxFramesToProcess;
     SINT m_currentFrame;
+    // Only used in fast analysis mode
+    AnalyzerExcerpts m_excerpts;
+    // The harmonic stems of stem files, if key detection is limited to them
+    mixxx::SampleBuffer m_harmonicStems;
 
     bool m_bPreferencesKeyDetectionEnabled;
     bool m_bPreferencesFastAnalysisEnabled;
@@ -3,6 +3,7 @@
 #include "analyzer/analyzertrack.h"
 #include "analyzer/constants.h"
 #include "track/track.h"
+#include "util/math.h"
 
 namespace {
 
@@ -12,6 +13,12 @@ constexpr CSAMPLE kSilenceThreshold = 0.001f; // -60 dB
 // TODO: Change the above line to:
 //constexpr CSAMPLE kSilenceThreshold = db2ratio(-60.0f);
 
+// After the first sound has been found, the last sound is searched only in
+// the end of the track if the other analyzers don't need the frames before.
+// If there is no sound in the end of the track, the skipped frames are
+// decoded after all.
+constexpr SINT kTailSecondsToAnalyze = 60;
+
 bool shouldAnalyze(TrackPointer pTrack) {
     CuePointer pIntroCue = pTrack->findCueByType(mixxx::CueType::Intro);
     CuePointer pOutroCue = pTrack->findCueByType(mixxx::CueType::Outro);
@@ -34,25 +41,32 @@ Iterator first_sound(Iterator begin, Iterator end) {
 
 AnalyzerSilence::AnalyzerSilence(UserSettingsPointer pConfig)
         : m_pConfig(pConfig),
+          m_frameLength(0),
+          m_tailFrames(0),
           m_framesProcessed(0),
           m_signalStart(-1),
-          m_signalEnd(-1) {
+          m_signalEnd(-1),
+          m_firstSkippedFrame(-1),
+          m_rewindFrame(-1),
+          m_decodeAllFrames(false) {
 }
 
 bool AnalyzerSilence::initialize(const AnalyzerTrack& track,
         mixxx::audio::SampleRate sampleRate,
         mixxx::audio::ChannelCount channelCount,
         SINT frameLength) {
-    Q_UNUSED(sampleRate);
-    Q_UNUSED(frameLength);
-
     if (!shouldAnalyze(track.getTrack())) {
         return false;
     }
 
+    m_frameLength = frameLength;
+    m_tailFrames = kTailSecondsToAnalyze * sampleRate;
     m_framesProcessed = 0;
     m_signalStart = -1;
     m_signalEnd = -1;
+    m_firstSkippedFrame = -1;
+    m_rewindFrame = -1;
+    m_decodeAllFrames = false;
     m_channelCount = channelCount;
 
     return true;
@@ -104,6 +118,50 @@ bool AnalyzerSilence::processSamples(const CSAMPLE* pIn, SINT count) {
     return true;
 }
 
+bool AnalyzerSilence::processChunk(AnalyzerFrontEnd* pFrontEnd) {
+    // Frames might have been skipped, see nextFrameNeeded()
+    const SINT frameIndex = pFrontEnd->frameIndex();
+    if (m_rewindFrame >= 0) {
+        // The skipped frames are decoded now
+        DEBUG_ASSERT(frameIndex <= m_rewindFrame);
+        m_rewindFrame = -1;
+    } else if (m_firstSkippedFrame < 0 && frameIndex > m_framesProcessed) {
+        m_firstSkippedFrame = m_framesProcessed;
+    }
+    m_framesProcessed = frameIndex;
+    if (!processSamples(pFrontEnd->samples(), pFrontEnd->sampleCount())) {
+        return false;
+    }
+
+    const SINT tailStart = m_frameLength - m_tailFrames;
+    if (m_framesProcessed >= m_frameLength &&
+            m_firstSkippedFrame >= 0 &&
+            !m_decodeAllFrames &&
+            m_signalEnd < tailStart) {
+        // There is no sound in the tail, so the last sound might be in the
+        // frames that have been skipped. Only those after the last sound
+        // found so far are needed.
+        m_rewindFrame = math_max(m_firstSkippedFrame, m_signalEnd);
+        m_decodeAllFrames = true;
+    }
+    return true;
+}
+
+SINT AnalyzerSilence::nextFrameNeeded(SINT frameIndex) const {
+    if (m_rewindFrame >= 0) {
+        return m_rewindFrame;
+    }
+    if (m_signalStart < 0) {
+        return frameIndex;
+    }
+    const SINT tailStart = m_frameLength - m_tailFrames;
+    if (m_decodeAllFrames) {
+        // The tail has already been analyzed
+        return frameIndex < tailStart ? frameIndex : m_frameLength;
+    }
+    return math_max(frameIndex, tailStart);
+}
+
 void AnalyzerSilence::cleanup() {
 }
 
@@ -26,6 +26,8 @@ class AnalyzerSilence : public Analyzer {
             mixxx::audio::ChannelCount channelCount,
             SINT frameLength) override;
     bool processSamples(const CSAMPLE* pIn, SINT count) override;
+    bool processChunk(AnalyzerFrontEnd* pFrontEnd) override;
+    SINT nextFrameNeeded(SINT frameIndex) const override;
     void storeResults(TrackPointer pTrack) override;
     void cleanup() override;
 
@@ -53,7 +55,16 @@ class AnalyzerSilence : public Analyzer {
   private:
     UserSettingsPointer m_pConfig;
     mixxx::audio::ChannelCount m_channelCount;
+    SINT m_frameLength;
+    SINT m_tailFrames;
     SINT m_framesProcessed;
     SINT m_signalStart;
     SINT m_signalEnd;
+    // The first frame that has been skipped, or -1
+    SINT m_firstSkippedFrame;
+    // The first skipped frame that is needed because the tail is silent,
+    // until it has been decoded, or -1
+    SINT m_rewindFrame;
+    // The tail is silent, so all frames before it are needed
+    bool m_decodeAllFrames;
 };
@@ -1,5 +1,6 @@
 #include "analyzer/analyzerthread.h"
 
+#include <limits>
 #include <mutex>
 
 #include "analyzer/analyzerbeats.h"
@@ -158,6 +159,7 @@ void AnalyzerThread::doRun() {
         }
 
         if (processTrack) {
+            m_frontEnd.initialize(audioSource->getSignalInfo().getChannelCount());
             const auto analysisResult = analyzeAudioSource(audioSource);
             DEBUG_ASSERT(analysisResult != AnalysisResult::Pending);
             if (analysisResult == AnalysisResult::Finished) {
@@ -235,7 +237,7 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
     emitBusyProgress(kAnalyzerProgressNone);
 
     mixxx::IndexRange remainingFrameRange = audioSource->frameIndexRange();
-    while (!remainingFrameRange.empty()) {
+    while (true) {
         sleepWhileSuspended();
         if (isStopping()) {
             return AnalysisResult::Cancelled;
@@ -243,6 +245,29 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
 
         // 1st step: Decode next chunk of audio data
 
+        // Skip the frames that no analyzer needs and stop once all
+        // analyzers are done
+        const SINT sourceStart = audioSource->frameIndexRange().start();
+        const SINT nextFrame = nextFrameNeeded(remainingFrameRange.start() - sourceStart);
+        if (nextFrame < remainingFrameRange.start() - sourceStart) {
+            // An analyzer needs frames that have been skipped before
+            kLogger.debug()
+                    << "Decoding skipped frames again from"
+                    << nextFrame;
+            remainingFrameRange = mixxx::IndexRange::between(
+                    nextFrame + sourceStart, audioSource->frameIndexRange().end());
+        }
+        if (nextFrame >= remainingFrameRange.end() - sourceStart) {
+            if (!remainingFrameRange.empty()) {
+                kLogger.debug()
+                        << "Skipping the remaining"
+                        << remainingFrameRange.length()
+                        << "frames that no analyzer needs";
+            }
+            break;
+        }
+        remainingFrameRange.shrinkFront(nextFrame + sourceStart - remainingFrameRange.start());
+
         // Split the range for the next chunk from the remaining (= to-be-analyzed) frames
         auto chunkFrameRange =
                 remainingFrameRange.splitAndShrinkFront(
@@ -299,10 +324,13 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
 
         // 2nd: step: Analyze chunk of decoded audio data
         if (!readableSampleFrames.frameIndexRange().empty()) {
+            m_frontEnd.setChunk(
+                    readableSampleFrames.readableData(),
+                    readableSampleFrames.readableLength(),
+                    readableSampleFrames.frameIndexRange().start() -
+                            audioSource->frameIndexRange().start());
             for (auto&& analyzer : m_analyzers) {
-                analyzer.processSamples(
-                        readableSampleFrames.readableData(),
-                        readableSampleFrames.readableLength());
+                analyzer.processChunk(&m_frontEnd);
             }
         }
 
@@ -331,6 +359,14 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
     return AnalysisResult::Finished;
 }
 
+SINT AnalyzerThread::nextFrameNeeded(SINT frameIndex) const {
+    SINT nextFrame = std::numeric_limits<SINT>::max();
+    for (const auto& analyzer : m_analyzers) {
+        nextFrame = math_min(nextFrame, analyzer.nextFrameNeeded(frameIndex));
+    }
+    return nextFrame;
+}
+
 void AnalyzerThread::emitBusyProgress(AnalyzerProgress busyProgress) {
     DEBUG_ASSERT(m_currentTrack.has_value());
     if ((m_emittedState == AnalyzerThreadState::Busy) &&
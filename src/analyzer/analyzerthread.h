@@ -120,6 +120,9 @@ class AnalyzerThread : public WorkerThread {
 
     mixxx::SampleBuffer m_sampleBuffer;
 
+    // Prepares the decoded chunks for all analyzers
+    AnalyzerFrontEnd m_frontEnd;
+
     std::optional<AnalyzerTrack> m_currentTrack;
 
     AnalyzerThreadState m_emittedState;
@@ -133,6 +136,8 @@ class AnalyzerThread : public WorkerThread {
     };
     AnalysisResult analyzeAudioSource(
             const mixxx::AudioSourcePointer& audioSource);
+    // The first frame at or after frameIndex that any analyzer needs
+    SINT nextFrameNeeded(SINT frameIndex) const;
 
     // Blocks the worker thread until a next track becomes available
     TrackPointer receiveNextTrack();
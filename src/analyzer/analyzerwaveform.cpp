@@ -195,6 +195,13 @@ void AnalyzerWaveform::destroyFilters() {
 }
 
 bool AnalyzerWaveform::processSamples(const CSAMPLE* pIn, SINT count) {
+    // Only used without the shared front-end of the AnalyzerThread
+    AnalyzerFrontEnd frontEnd(m_channelCount);
+    frontEnd.setChunk(pIn, count);
+    return processChunk(&frontEnd);
+}
+
+bool AnalyzerWaveform::processChunk(AnalyzerFrontEnd* pFrontEnd) {
     VERIFY_OR_DEBUG_ASSERT(m_waveform) {
         return false;
     }
@@ -202,23 +209,15 @@ bool AnalyzerWaveform::processSamples(const CSAMPLE* pIn, SINT count) {
         return false;
     }
 
-    SINT numFrames = count / m_channelCount;
-    count = numFrames * mixxx::audio::ChannelCount::stereo();
+    const CSAMPLE* pIn = pFrontEnd->samples();
+    const SINT count = pFrontEnd->stereoSampleCount();
     int stemCount = 0;
 
-    const CSAMPLE* pWaveformInput = pIn;
-    CSAMPLE* pMixedChannel = nullptr;
-
+    // The front-end mixes the stems of stem files together
+    const CSAMPLE* pWaveformInput = pFrontEnd->stereo();
     if (m_channelCount > mixxx::audio::ChannelCount::stereo()) {
         DEBUG_ASSERT(0 == m_channelCount % mixxx::audio::ChannelCount::stereo());
-
-        pMixedChannel = SampleUtil::alloc(count);
-        VERIFY_OR_DEBUG_ASSERT(pMixedChannel) {
-            return false;
-        }
-        SampleUtil::mixMultichannelToStereo(pMixedChannel, pIn, numFrames, m_channelCount);
         stemCount = m_channelCount / mixxx::audio::ChannelCount::stereo();
-        pWaveformInput = pMixedChannel;
     }
 
     // This should only append once if count is constant
@@ -308,9 +307,6 @@ bool AnalyzerWaveform::processSamples(const CSAMPLE* pIn, SINT count) {
 
     //kLogger.debug() << "process - m_waveform->getCompletion()" << m_waveform->getCompletion() << "off" << m_waveform->getDataSize();
     //kLogger.debug() << "process - m_waveformSummary->getCompletion()" << m_waveformSummary->getCompletion() << "off" << m_waveformSummary->getDataSize();
-    if (pMixedChannel) {
-        SampleUtil::free(pMixedChannel);
-    }
     return true;
 }
 
@@ -146,6 +146,7 @@ class AnalyzerWaveform : public Analyzer {
             mixxx::audio::ChannelCount channelCount,
             SINT frameLength) override;
     bool processSamples(const CSAMPLE* buffer, SINT count) override;
+    bool processChunk(AnalyzerFrontEnd* pFrontEnd) override;
     void storeResults(TrackPointer tio) override;
     void cleanup() override;
 
@@ -17,4 +17,11 @@ constexpr SINT kAnalysisSamplesPerChunk =
 // Only analyze the first minute in fast-analysis mode.
 constexpr SINT kFastAnalysisSecondsToAnalyze = 60;
 
+// In fast-analysis mode the tempo and the key are estimated from strided
+// excerpts across the track, if possible. See AnalyzerExcerpts.
+constexpr int kFastAnalysisExcerptCount = 8;
+constexpr SINT kFastAnalysisSecondsPerExcerpt = 15;
+// The analysis stops early once this many excerpts agree
+constexpr int kFastAnalysisMinAgreeingExcerpts = 3;
+
 }  // namespace mixxx
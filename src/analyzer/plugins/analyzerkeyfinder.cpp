@@ -1,5 +1,7 @@
 #include "analyzer/plugins/analyzerkeyfinder.h"
 
+#include <utility>
+
 #include "analyzer/constants.h"
 #include "util/assert.h"
 
@@ -72,22 +74,39 @@ ChromaticKey chromaticKeyFromKeyFinderKeyT(KeyFinder::key_t key) {
 namespace mixxx {
 
 AnalyzerKeyFinder::AnalyzerKeyFinder()
-        : m_currentFrame(0) {
+        : m_currentFrame(0),
+          m_segmentStartFrame(0) {
 }
 
 AnalyzerPluginInfo AnalyzerKeyFinder::pluginInfo() {
     return AnalyzerPluginInfo(pluginId, pluginAuthor, pluginName, false);
 }
 
+QHash<QString, QString> AnalyzerKeyFinder::extraVersionInfo() {
+    QHash<QString, QString> versionInfo;
+    versionInfo["keyfinder_segment_hops"] = QString::number(kHopsPerSegment);
+    return versionInfo;
+}
+
 bool AnalyzerKeyFinder::initialize(mixxx::audio::SampleRate sampleRate) {
     m_audioData.setFrameRate(sampleRate);
     m_audioData.setChannels(kAnalysisChannels);
+    m_currentFrame = 0;
+    m_segmentStartFrame = 0;
+    m_resultKeys.clear();
     return true;
 }
 
 bool AnalyzerKeyFinder::processSamples(const CSAMPLE* pIn, SINT iLen) {
     DEBUG_ASSERT(iLen % kAnalysisChannels == 0);
-    if (m_audioData.getSampleCount() == 0) {
+    if (m_audioData.getSampleCount() != static_cast<unsigned int>(iLen)) {
+        // The buffer is reused for all chunks. Only the first and the last,
+        // shorter chunk need a new one, otherwise the stale samples of the
+        // previous chunk would be analyzed again.
+        const unsigned int frameRate = m_audioData.getFrameRate();
+        m_audioData = KeyFinder::AudioData();
+        m_audioData.setFrameRate(frameRate);
+        m_audioData.setChannels(kAnalysisChannels);
         m_audioData.addToSampleCount(iLen);
     }
 
@@ -101,14 +120,37 @@ bool AnalyzerKeyFinder::processSamples(const CSAMPLE* pIn, SINT iLen) {
         }
     }
     m_keyFinder.progressiveChromagram(m_audioData, m_workspace);
+    if (m_workspace.chromagram &&
+            m_workspace.chromagram->getHops() >= kHopsPerSegment) {
+        finishSegment();
+    }
     return true;
 }
 
+void AnalyzerKeyFinder::finishSegment() {
+    // Move the chromagram of the segment out of the workspace. KeyFinder
+    // starts a new one with the next hop.
+    KeyFinder::Workspace segment;
+    std::swap(segment.chromagram, m_workspace.chromagram);
+    const ChromaticKey key = chromaticKeyFromKeyFinderKeyT(
+            m_keyFinder.keyOfChromagram(segment));
+    // Silent segments continue the previous key
+    if (key != ChromaticKey::INVALID &&
+            (m_resultKeys.isEmpty() || m_resultKeys.last().first != key)) {
+        m_resultKeys.push_back(qMakePair(key, static_cast<double>(m_segmentStartFrame)));
+    }
+    m_segmentStartFrame = m_currentFrame;
+}
+
 bool AnalyzerKeyFinder::finalize() {
     m_keyFinder.finalChromagram(m_workspace);
-    ChromaticKey finalKey = chromaticKeyFromKeyFinderKeyT(
-            m_keyFinder.keyOfChromagram(m_workspace));
-    m_resultKeys.push_back(qMakePair(finalKey, m_currentFrame));
+    if (m_workspace.chromagram && m_workspace.chromagram->getHops() > 0) {
+        finishSegment();
+    }
+    if (m_resultKeys.isEmpty()) {
+        // The whole track is silent
+        m_resultKeys.push_back(qMakePair(ChromaticKey::INVALID, 0.0));
+    }
     return true;
 }
 
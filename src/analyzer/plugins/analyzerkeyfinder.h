@@ -1,6 +1,9 @@
 #pragma once
 #include <keyfinder/keyfinder.h>
 
+#include <QHash>
+#include <QString>
+
 #include "analyzer/plugins/analyzerplugin.h"
 #include "util/types.h"
 
@@ -8,7 +11,16 @@ namespace mixxx {
 
 class AnalyzerKeyFinder : public AnalyzerKeyPlugin {
   public:
+    // The chromagram of KeyFinder has roughly one hop per second. The key of
+    // each segment of this many hops is classified as soon as it is complete,
+    // instead of the key of the whole chromagram in finalize(). This also
+    // bounds the size of the chromagram.
+    static constexpr unsigned int kHopsPerSegment = 32;
+
     static AnalyzerPluginInfo pluginInfo();
+    // Distinguishes the keys of segments from the keys of the whole
+    // chromagram, which earlier versions detected
+    static QHash<QString, QString> extraVersionInfo();
 
     AnalyzerKeyFinder();
     ~AnalyzerKeyFinder() override = default;
@@ -26,11 +38,15 @@ class AnalyzerKeyFinder : public AnalyzerKeyPlugin {
     }
 
   private:
+    // Classifies the chromagram since the end of the previous segment
+    void finishSegment();
+
     KeyFinder::KeyFinder m_keyFinder;
     KeyFinder::Workspace m_workspace;
     KeyFinder::AudioData m_audioData;
 
     SINT m_currentFrame;
+    SINT m_segmentStartFrame;
     KeyChangeList m_resultKeys;
 };
 
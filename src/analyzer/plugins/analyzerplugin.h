@@ -6,6 +6,7 @@
 #include "track/beats.h"
 #include "track/bpm.h"
 #include "track/keys.h"
+#include "util/assert.h"
 #include "util/types.h"
 
 namespace mixxx {
@@ -63,6 +64,19 @@ class AnalyzerPlugin {
     virtual bool initialize(mixxx::audio::SampleRate sampleRate) = 0;
     virtual bool processSamples(const CSAMPLE* pIn, SINT iLen) = 0;
     virtual bool finalize() = 0;
+
+    // Plugins that only analyze a mono downmix of the stereo samples can
+    // take it from the AnalyzerFrontEnd, which computes it once for all
+    // analyzers.
+    virtual bool supportsMonoInput() const {
+        return false;
+    }
+    virtual bool processMonoSamples(const CSAMPLE* pIn, SINT frames) {
+        Q_UNUSED(pIn);
+        Q_UNUSED(frames);
+        DEBUG_ASSERT(!"Mono input not supported");
+        return false;
+    }
 };
 
 class AnalyzerBeatsPlugin : public AnalyzerPlugin {
@@ -34,6 +34,11 @@ class AnalyzerQueenMaryBeats : public AnalyzerBeatsPlugin {
     bool processSamples(const CSAMPLE* pIn, SINT iLen) override;
     bool finalize() override;
 
+    bool supportsMonoInput() const override {
+        return true;
+    }
+    bool processMonoSamples(const CSAMPLE* pIn, SINT frames) override;
+
     bool supportsBeatTracking() const override {
         return true;
     }
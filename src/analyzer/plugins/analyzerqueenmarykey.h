@@ -34,6 +34,11 @@ class AnalyzerQueenMaryKey : public AnalyzerKeyPlugin {
     bool processSamples(const CSAMPLE* pIn, SINT iLen) override;
     bool finalize() override;
 
+    bool supportsMonoInput() const override {
+        return true;
+    }
+    bool processMonoSamples(const CSAMPLE* pIn, SINT frames) override;
+
     KeyChangeList getKeyChanges() const override {
         return m_resultKeys;
     }
@@ -25,10 +25,15 @@ class DownmixAndOverlapHelper {
             const CSAMPLE* pInput,
             size_t inputStereoSamples);
 
+    // For input that has already been downmixed to mono
+    bool processMonoSamples(
+            const CSAMPLE* pInput,
+            size_t inputFrames);
+
     bool finalize();
 
   private:
-    bool processInner(const CSAMPLE* pInput, size_t numInputFrames);
+    bool processInner(const CSAMPLE* pInput, size_t numInputFrames, int numChannels);
 
     std::vector<double> m_buffer;
     // The window size in frames.
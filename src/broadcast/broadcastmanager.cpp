@@ -4,6 +4,7 @@
 
 #include "broadcast/defs_broadcast.h"
 #include "control/controlpushbutton.h"
+#include "engine/enginemixer.h"
 #include "engine/sidechain/enginenetworkstream.h"
 #include "moc_broadcastmanager.cpp"
 #include "preferences/settingsmanager.h"
@@ -15,10 +16,12 @@ const mixxx::Logger kLogger("BroadcastManager");
 } // namespace
 
 BroadcastManager::BroadcastManager(SettingsManager* pSettingsManager,
-                                   SoundManager* pSoundManager)
+                                   SoundManager* pSoundManager,
+                                   EngineMixer* pEngine)
         : m_pConfig(pSettingsManager->settings()),
           m_pBroadcastSettings(pSettingsManager->broadcastSettings()),
-          m_pNetworkStream(pSoundManager->getNetworkStream()) {
+          m_pNetworkStream(pSoundManager->getNetworkStream()),
+          m_pSideChain(pEngine->getSideChain()) {
     const bool persist = true;
     m_pBroadcastEnabled = new ControlPushButton(
             ConfigKey(BROADCAST_PREF_KEY,"enabled"), persist);
@@ -154,7 +157,7 @@ bool BroadcastManager::addConnection(BroadcastProfilePtr profile) {
         return false;
     }
 
-    ShoutConnectionPtr connection(new ShoutConnection(profile, m_pConfig));
+    ShoutConnectionPtr connection(new ShoutConnection(profile, m_pConfig, m_pSideChain));
     m_pNetworkStream->addOutputWorker(connection);
 
     connect(profile.data(),
@@ -8,7 +8,9 @@
 
 class SoundManager;
 class ControlPushButton;
+class EngineMixer;
 class EngineNetworkStream;
+class EngineSideChain;
 class SettingsManager;
 
 class BroadcastManager : public QObject {
@@ -23,7 +25,8 @@ class BroadcastManager : public QObject {
     };
 
     BroadcastManager(SettingsManager* pSettingsManager,
-                     SoundManager* pSoundManager);
+                     SoundManager* pSoundManager,
+                     EngineMixer* pEngine);
     ~BroadcastManager() override;
 
     // Returns true if the broadcast connection is enabled. Note this only
@@ -52,6 +55,8 @@ class BroadcastManager : public QObject {
     UserSettingsPointer m_pConfig;
     BroadcastSettingsPointer m_pBroadcastSettings;
     QSharedPointer<EngineNetworkStream> m_pNetworkStream;
+    // Runs the encoders shared by the connections
+    EngineSideChain* m_pSideChain;
 
     ControlPushButton* m_pBroadcastEnabled;
     ControlObject* m_pStatusCO;
@@ -159,6 +159,39 @@ class HidControllerJSProxy : public ControllerJSProxy {
                 reportID, dataArray, useNonSkippingFIFO);
     }
 
+    /// @brief Limits the rate of OutputReports sent in skipping mode
+    /// @details Each ReportID is sent at most reportsPerSecond times per second.
+    ///          Data cached in between are coalesced, only the latest data are sent.
+    ///          This saves bus bandwidth for mappings, which update LEDs on every tick.
+    ///          Reports sent with useNonSkippingFIFO are never rate limited.
+    /// @param reportsPerSecond Maximum rate per ReportID, or 0 for no limit (default)
+    Q_INVOKABLE void setMaxOutputReportRate(int reportsPerSecond) {
+        VERIFY_OR_DEBUG_ASSERT(m_pHidController->m_pHidIoThread) {
+            return;
+        }
+        m_pHidController->m_pHidIoThread->setMaxOutputReportRate(reportsPerSecond);
+    }
+
+    /// @brief Returns the number of OutputReports handled since the device was opened
+    /// @return Object with the properties `sent` (written to the device),
+    ///         `skipped` (identical to the data sent before) and `coalesced`
+    ///         (superseded by newer data before they could be sent)
+    Q_INVOKABLE QVariantMap getOutputReportStatistics() const {
+        VERIFY_OR_DEBUG_ASSERT(m_pHidController->m_pHidIoThread) {
+            return {};
+        }
+        const HidIoOutputReportCounters& counters =
+                m_pHidController->m_pHidIoThread->outputReportCounters();
+        return QVariantMap{
+                {QStringLiteral("sent"),
+                        counters.sent.load(std::memory_order_relaxed)},
+                {QStringLiteral("skipped"),
+                        counters.skipped.load(std::memory_order_relaxed)},
+                {QStringLiteral("coalesced"),
+                        counters.coalesced.load(std::memory_order_relaxed)},
+        };
+    }
+
     /// @brief getInputReport receives an InputReport from the HID device on request.
     /// @details This can be used on startup to initialize the knob positions in Mixxx
     ///          to the physical position of the hardware knobs on the controller.
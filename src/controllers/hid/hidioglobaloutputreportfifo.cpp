@@ -3,6 +3,7 @@
 #include <hidapi.h>
 
 #include "controllers/hid/hiddevice.h"
+#include "controllers/hid/hidiooutputreport.h"
 #include "util/cmdlineargs.h"
 #include "util/compatibility/qmutex.h"
 #include "util/runtimeloggingcategory.h"
@@ -14,8 +15,10 @@ constexpr size_t kMaxHidErrorMessageSize = 512;
 constexpr size_t kSizeOfFifoInReports = 32;
 } // namespace
 
-HidIoGlobalOutputReportFifo::HidIoGlobalOutputReportFifo()
+HidIoGlobalOutputReportFifo::HidIoGlobalOutputReportFifo(
+        HidIoOutputReportCounters* pCounters)
         : m_fifoQueue(kSizeOfFifoInReports),
+          m_pCounters(pCounters),
           m_hidWriteErrorLogged(false) {
 }
 
@@ -86,6 +89,7 @@ bool HidIoGlobalOutputReportFifo::sendNextReportDataset(QMutex* pHidDeviceAndPol
         }
     } else {
         m_hidWriteErrorLogged = false;
+        m_pCounters->sent.fetch_add(1, std::memory_order_relaxed);
     }
 
     hidDeviceLock.unlock();
@@ -4,6 +4,7 @@
 
 #include "rigtorp/SPSCQueue.h"
 
+struct HidIoOutputReportCounters;
 struct RuntimeLoggingCategory;
 class QMutex;
 
@@ -19,7 +20,7 @@ class DeviceInfo;
 /// First Out (FIFO) order
 class HidIoGlobalOutputReportFifo {
   public:
-    HidIoGlobalOutputReportFifo();
+    explicit HidIoGlobalOutputReportFifo(HidIoOutputReportCounters* pCounters);
 
     /// Caches new OutputReport to the FIFO, which will later be send by the IO thread
     void addReportDatasetToFifo(const quint8 reportId,
@@ -38,5 +39,6 @@ class HidIoGlobalOutputReportFifo {
   private:
     // Lockless FIFO queue
     rigtorp::SPSCQueue<QByteArray> m_fifoQueue;
+    HidIoOutputReportCounters* const m_pCounters;
     bool m_hidWriteErrorLogged;
 };
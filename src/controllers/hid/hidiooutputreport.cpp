@@ -13,11 +13,14 @@ constexpr int kReportIdSize = 1;
 constexpr size_t kMaxHidErrorMessageSize = 512;
 } // namespace
 
-HidIoOutputReport::HidIoOutputReport(
-        const quint8& reportId, const unsigned int& reportDataSize)
+HidIoOutputReport::HidIoOutputReport(const quint8& reportId,
+        const unsigned int& reportDataSize,
+        HidIoOutputReportCounters* pCounters)
         : m_reportId(reportId),
           m_hidWriteErrorLogged(false),
+          m_pCounters(pCounters),
           m_possiblyUnsentDataCached(false),
+          m_dirtyBytes(0),
           m_lastCachedDataSize(0) {
     // First byte must always contain the ReportID - also after swapping, therefore initialize both arrays
     m_cachedData.reserve(kReportIdSize + reportDataSize);
@@ -55,6 +58,11 @@ void HidIoOutputReport::updateCachedData(const QByteArray& data,
         }
     }
 
+    if (m_possiblyUnsentDataCached) {
+        // The unsent data are superseded by the new data
+        m_pCounters->coalesced.fetch_add(1, std::memory_order_relaxed);
+    }
+
     // m_possiblyUnsentDataCached must be set while m_cachedDataMutex is locked
     // This step covers the case that data for the report are cached in skipping mode,
     // succeed by a non-skipping send of the same report
@@ -71,9 +79,42 @@ void HidIoOutputReport::updateCachedData(const QByteArray& data,
             m_cachedData.size(),
             data.constData(),
             data.size());
+
+    // Compare byte by byte with the data sent before, mappings which update
+    // the LEDs on every tick mostly resend identical data.
+    if (m_cachedData.size() != m_lastSentData.size()) {
+        m_dirtyBytes = static_cast<int>(m_cachedData.size()) - kReportIdSize;
+    } else {
+        m_dirtyBytes = 0;
+        for (qsizetype i = kReportIdSize; i < m_cachedData.size(); ++i) {
+            if (m_cachedData.at(i) != m_lastSentData.at(i)) {
+                m_dirtyBytes++;
+            }
+        }
+    }
+
+    if (m_dirtyBytes == 0) {
+        // Nothing changed since the last send, there is no need to send
+        // the report at all
+        m_possiblyUnsentDataCached = false;
+        m_pCounters->skipped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (!m_possiblyUnsentDataCached) {
+        m_unsentDataCachedSince = mixxx::Time::elapsed();
+    }
     m_possiblyUnsentDataCached = true;
 }
 
+std::optional<mixxx::Duration> HidIoOutputReport::unsentDataCachedSince() {
+    auto cacheLock = lockMutex(&m_cachedDataMutex);
+    if (!m_possiblyUnsentDataCached) {
+        return std::nullopt;
+    }
+    return m_unsentDataCachedSince;
+}
+
 bool HidIoOutputReport::sendCachedData(QMutex* pHidDeviceAndPollMutex,
         hid_device* pHidDevice,
         const RuntimeLoggingCategory& logOutput) {
@@ -86,7 +127,7 @@ bool HidIoOutputReport::sendCachedData(QMutex* pHidDeviceAndPollMutex,
         return false;
     }
 
-    if (!m_lastSentData.compare(m_cachedData)) {
+    if (m_dirtyBytes == 0) {
         // An HID OutputReport can contain only HID OutputItems.
         // HID OutputItems are defined to represent the state of one or more similar controls or LEDs.
         // Only HID Feature items may be attributes of other items.
@@ -94,8 +135,9 @@ bool HidIoOutputReport::sendCachedData(QMutex* pHidDeviceAndPollMutex,
         // and if the state is not changed, there's no need to execute the time consuming hid_write again.
 
         // Setting m_possiblyUnsentDataCached to false prevents,
-        // that the byte array compare operation is executed for the same data again
+        // that the report is checked for the same data again
         m_possiblyUnsentDataCached = false;
+        m_pCounters->skipped.fetch_add(1, std::memory_order_relaxed);
 
         cacheLock.unlock();
 
@@ -118,6 +160,7 @@ bool HidIoOutputReport::sendCachedData(QMutex* pHidDeviceAndPollMutex,
     // and concurrent execution of this method is prevented by locking pHidDeviceMutex
     m_lastSentData.swap(m_cachedData);
     m_possiblyUnsentDataCached = false;
+    m_dirtyBytes = 0;
 
     cacheLock.unlock();
 
@@ -149,12 +192,18 @@ bool HidIoOutputReport::sendCachedData(QMutex* pHidDeviceAndPollMutex,
 
     if (result == -1) {
         cacheLock.relock();
+        if (!m_possiblyUnsentDataCached) {
+            // No newer data were cached in the meantime,
+            // restore the data which failed to be sent
+            m_cachedData.swap(m_lastSentData);
+        }
         // Clear the m_lastSentData because the last send data are not reliable known.
         // These error should not occur in normal operation,
         // therefore the performance impact of additional memory allocation
         // at the next call of this method is negligible
         m_lastSentData.clear();
         m_lastSentData.append(m_reportId);
+        m_dirtyBytes = static_cast<int>(m_cachedData.size()) - kReportIdSize;
         m_possiblyUnsentDataCached = true;
 
         // Return with true, to signal the caller, that the time consuming hid_write operation was executed
@@ -162,6 +211,9 @@ bool HidIoOutputReport::sendCachedData(QMutex* pHidDeviceAndPollMutex,
         return true;
     }
 
+    m_lastSendTime = startOfHidWrite;
+    m_pCounters->sent.fetch_add(1, std::memory_order_relaxed);
+
     if (CmdlineArgs::Instance()
                     .getControllerDebug()) {
         qCDebug(logOutput) << "t:" << startOfHidWrite.formatMillisWithUnit() << " "
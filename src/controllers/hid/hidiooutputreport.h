@@ -1,21 +1,48 @@
 #pragma once
 
 #include <QByteArray>
+#include <atomic>
+#include <optional>
 
 #include "util/compatibility/qmutex.h"
+#include "util/duration.h"
 
 struct RuntimeLoggingCategory;
 typedef struct hid_device_ hid_device;
 
+/// Counters of the OutputReports handled by one HidIoThread. They are exposed
+/// to the mapping, to show how much traffic the skipping cache saved.
+struct HidIoOutputReportCounters {
+    /// Reports written to the device by hid_write
+    std::atomic<quint64> sent{0};
+    /// Reports not sent, because the data were identical to the last sent data
+    std::atomic<quint64> skipped{0};
+    /// Reports not sent, because they were superseded by newer data for the
+    /// same ReportID, before they could be sent
+    std::atomic<quint64> coalesced{0};
+};
+
 class HidIoOutputReport {
   public:
-    HidIoOutputReport(const quint8& reportId, const unsigned int& reportDataSize);
+    HidIoOutputReport(const quint8& reportId,
+            const unsigned int& reportDataSize,
+            HidIoOutputReportCounters* pCounters);
 
     /// Caches new report data, which will later send by the IO thread
     void updateCachedData(const QByteArray& data,
             const RuntimeLoggingCategory& logOutput,
             bool useNonSkippingFIFO);
 
+    /// Returns the time, since when changed data are waiting to be sent,
+    /// or std::nullopt if no unsent data are cached.
+    std::optional<mixxx::Duration> unsentDataCachedSince();
+
+    /// Returns true if the report is allowed to be sent at `now`,
+    /// without exceeding one report per `minSendInterval`.
+    bool isSendAllowed(mixxx::Duration now, mixxx::Duration minSendInterval) const {
+        return !m_lastSendTime || now - *m_lastSendTime >= minSendInterval;
+    }
+
     /// Sends the OutputReport to the HID device, when changed data are cached.
     /// Returns true if a time consuming hid_write operation was executed.
     bool sendCachedData(QMutex* pHidDeviceAndPollMutex,
@@ -27,12 +54,21 @@ class HidIoOutputReport {
     QByteArray m_lastSentData;
     bool m_hidWriteErrorLogged;
 
-    /// Mutex must be locked when reading/writing m_cachedData
-    /// or m_possiblyUnsentDataCached
+    /// Only accessed by the IO thread
+    std::optional<mixxx::Duration> m_lastSendTime;
+
+    HidIoOutputReportCounters* const m_pCounters;
+
+    /// Mutex must be locked when reading/writing m_cachedData,
+    /// m_possiblyUnsentDataCached, m_unsentDataCachedSince or m_dirtyBytes
     QMutex m_cachedDataMutex;
 
     QByteArray m_cachedData;
     bool m_possiblyUnsentDataCached;
+    mixxx::Duration m_unsentDataCachedSince;
+
+    /// Number of bytes in m_cachedData, which differ from m_lastSentData
+    int m_dirtyBytes;
 
     /// Due to swapping of the QbyteArrays, we need to store
     /// this information independent of the QBytearray size
@@ -41,13 +41,13 @@ HidIoThread::HidIoThread(
           m_lastPollSize(0),
           m_pollingBufferIndex(0),
           m_hidReadErrorLogged(false),
-          m_globalOutputReportFifo(),
+          m_minOutputReportIntervalNanos(0),
+          m_globalOutputReportFifo(&m_outputReportCounters),
           m_runLoopSemaphore(1) {
     // Initializing isn't strictly necessary but is good practice.
     for (int i = 0; i < kNumBuffers; i++) {
         memset(m_pPollData[i], 0, kBufferSize);
     }
-    m_outputReportIterator = m_outputReports.begin();
     m_state.storeRelease(static_cast<int>(HidIoThreadState::Initialized));
 }
 
@@ -203,7 +203,7 @@ void HidIoThread::updateCachedOutputReportData(quint8 reportID,
     if (m_outputReports.find(reportID) == m_outputReports.end()) {
         std::unique_ptr<HidIoOutputReport> pNewOutputReport;
         m_outputReports[reportID] = std::make_unique<HidIoOutputReport>(
-                reportID, data.size());
+                reportID, data.size(), &m_outputReportCounters);
     }
 
     // The only mutable operation on m_outputReports is insert
@@ -235,37 +235,54 @@ bool HidIoThread::sendNextCachedOutputReport() {
         return true;
     }
 
-    // 2.) If non non-skipping reports were in the FIFO, send the skipable reports
-    // from the m_outputReports cache
-
-    // m_outputReports.size() doesn't need mutex protection, because the value of i is not used.
-    // i is just a counter to prevent infinite loop execution.
-    // If the map size increases, this loop will execute one iteration more,
-    // which only has the effect, that one additional lookup operation for unsent data will be executed.
-    for (std::size_t i = 0; i < m_outputReports.size(); i++) {
-        auto mapLock = lockMutex(&m_outputReportMapMutex);
-        if (m_outputReportIterator == m_outputReports.end()) {
-            m_outputReportIterator = m_outputReports.begin();
-        } else {
-            m_outputReportIterator++;
-            if (m_outputReportIterator == m_outputReports.end()) {
-                m_outputReportIterator = m_outputReports.begin();
-            }
+    // 2.) If non non-skipping reports were in the FIFO, send the skipable report
+    // from the m_outputReports cache, which waits the longest time for being sent.
+    // Reports that were sent too recently for the maximum report rate are deferred,
+    // newer data for them coalesce in the cache meanwhile.
+    // When stopping, all cached reports are flushed without rate limit.
+    const auto now = mixxx::Time::elapsed();
+    const auto minSendInterval =
+            m_state.loadAcquire() ==
+                    static_cast<int>(HidIoThreadState::StopWhenAllReportsSent)
+            ? mixxx::Duration::empty()
+            : mixxx::Duration::fromNanos(
+                      m_minOutputReportIntervalNanos.load(std::memory_order_relaxed));
+
+    HidIoOutputReport* pNextOutputReport = nullptr;
+    mixxx::Duration oldestUnsentDataCachedSince;
+    auto mapLock = lockMutex(&m_outputReportMapMutex);
+    for (const auto& [reportId, pOutputReport] : m_outputReports) {
+        if (!pOutputReport->isSendAllowed(now, minSendInterval)) {
+            continue;
         }
-        mapLock.unlock();
-
-        // The only mutable operation on m_outputReports is insert
-        // by std::map<Key,T,Compare,Allocator>::operator[]
-        // The standard says that "No iterators or references are invalidated." using this operator.
-        // Therefore m_outputReportIterator doesn't require Mutex protection.
-        if (m_outputReportIterator->second->sendCachedData(
-                    &m_hidDeviceAndPollMutex, m_pHidDevice, m_logOutput)) {
-            // Return after each time consuming sendCachedData
-            return true;
+        const auto unsentDataCachedSince = pOutputReport->unsentDataCachedSince();
+        if (unsentDataCachedSince &&
+                (!pNextOutputReport ||
+                        *unsentDataCachedSince < oldestUnsentDataCachedSince)) {
+            pNextOutputReport = pOutputReport.get();
+            oldestUnsentDataCachedSince = *unsentDataCachedSince;
         }
     }
-    // Returns false if no report required a time consuming sendCachedData
-    return false;
+    mapLock.unlock();
+
+    if (!pNextOutputReport) {
+        // Returns false if no report required a time consuming sendCachedData
+        return false;
+    }
+
+    // The only mutable operation on m_outputReports is insert
+    // by std::map<Key,T,Compare,Allocator>::operator[]
+    // The standard says that "No iterators or references are invalidated." using this operator.
+    // Therefore pNextOutputReport doesn't require Mutex protection.
+    return pNextOutputReport->sendCachedData(
+            &m_hidDeviceAndPollMutex, m_pHidDevice, m_logOutput);
+}
+
+void HidIoThread::setMaxOutputReportRate(int reportsPerSecond) {
+    const qint64 minIntervalNanos = reportsPerSecond > 0
+            ? mixxx::Duration::fromSeconds(1).toIntegerNanos() / reportsPerSecond
+            : 0;
+    m_minOutputReportIntervalNanos.store(minIntervalNanos, std::memory_order_relaxed);
 }
 
 void HidIoThread::sendFeatureReport(
@@ -2,6 +2,7 @@
 
 #include <QSemaphore>
 #include <QThread>
+#include <atomic>
 #include <map>
 
 #include "controllers/hid/hiddevice.h"
@@ -45,6 +46,16 @@ class HidIoThread : public QThread {
     void updateCachedOutputReportData(quint8 reportID,
             const QByteArray& reportData,
             bool useNonSkippingFIFO);
+    /// Limits the rate at which OutputReports of the same ReportID are sent
+    /// from the skipping cache. Data cached in between are coalesced, only
+    /// the latest data are sent. 0 disables the limit.
+    /// Reports sent through the non-skipping FIFO are never rate limited.
+    void setMaxOutputReportRate(int reportsPerSecond);
+
+    const HidIoOutputReportCounters& outputReportCounters() const {
+        return m_outputReportCounters;
+    }
+
     QByteArray getInputReport(quint8 reportID);
     void sendFeatureReport(quint8 reportID, const QByteArray& reportData);
     QByteArray getFeatureReport(quint8 reportID);
@@ -81,8 +92,14 @@ class HidIoThread : public QThread {
     int m_pollingBufferIndex;
     bool m_hidReadErrorLogged;
 
+    HidIoOutputReportCounters m_outputReportCounters;
+
+    /// Minimum interval between two OutputReports with the same ReportID,
+    /// sent from the skipping cache
+    std::atomic<qint64> m_minOutputReportIntervalNanos;
+
     /// Must be locked when a operation changes the size of the m_outputReports map,
-    /// or when modify the m_outputReportIterator
+    /// or when iterating over it
     QMutex m_outputReportMapMutex;
 
     typedef std::map<unsigned char, std::unique_ptr<HidIoOutputReport>> OutputReportMap;
@@ -91,7 +108,6 @@ class HidIoThread : public QThread {
     /// Until then, it's not known, which OutputReports a device/mapping has.
     /// No other modifications to the map are done, until destruction of this class.
     OutputReportMap m_outputReports;
-    OutputReportMap::iterator m_outputReportIterator;
 
     HidIoGlobalOutputReportFifo m_globalOutputReportFifo;
 
@@ -2,6 +2,7 @@
 
 #include <QOffscreenSurface>
 #include <QOpenGLContext>
+#include <QOpenGLExtraFunctions>
 #include <QOpenGLFramebufferObject>
 #include <QOpenGLFunctions>
 #include <QQmlEngine>
@@ -10,6 +11,7 @@
 #include <QQuickRenderTarget>
 #include <QQuickWindow>
 #include <QThread>
+#include <cstring>
 
 #include "controllers/controller.h"
 #include "controllers/controllerenginethreadcontrol.h"
@@ -18,6 +20,7 @@
 #include "moc_controllerrenderingengine.cpp"
 #include "qml/qmlwaveformoverview.h"
 #include "util/cmdlineargs.h"
+#include "util/counter.h"
 #include "util/logger.h"
 #include "util/thread_affinity.h"
 #include "util/time.h"
@@ -33,6 +36,11 @@
 
 namespace {
 const mixxx::Logger kLogger("ControllerRenderingEngine");
+
+// Frames that haven't changed are not sent to the device, unless the last
+// frame sent is older than this interval. This makes sure the device gets
+// refreshed eventually, even if it dropped a frame.
+constexpr auto kMaxUnchangedFrameInterval = std::chrono::seconds(1);
 } // anonymous namespace
 
 using Clock = std::chrono::steady_clock;
@@ -42,6 +50,14 @@ ControllerRenderingEngine::ControllerRenderingEngine(
         gsl::not_null<ControllerEngineThreadControl*> engineThreadControl)
         : QObject(),
           m_screenInfo(info),
+          m_pixelBuffers{},
+          m_pixelBufferIndex(0),
+          m_pixelBufferPending(false),
+          m_renderTargetMirrored(false),
+          m_frameTimeStatKey(QStringLiteral("ControllerRenderingEngine::frame %1")
+                                     .arg(info.identifier)),
+          m_skippedFrameStatKey(QStringLiteral("ControllerRenderingEngine::unchangedFrames %1")
+                                        .arg(info.identifier)),
           m_GLDataFormat(GL_RGBA),
           m_GLDataType(GL_UNSIGNED_BYTE),
           m_isValid(true),
@@ -244,7 +260,8 @@ void ControllerRenderingEngine::finish() {
                 });
         m_quickWindow.reset();
 
-        // Free the engine and FBO.
+        // Free the engine, the pixel buffers and FBO.
+        releasePixelBuffers();
         m_fbo.reset();
 
         m_context->doneCurrent();
@@ -252,6 +269,145 @@ void ControllerRenderingEngine::finish() {
     m_context.reset();
 }
 
+// static
+QRect ControllerRenderingEngine::changedArea(const QImage& previous, const QImage& current) {
+    if (previous.isNull() || previous.size() != current.size() ||
+            previous.format() != current.format() ||
+            previous.bytesPerLine() != current.bytesPerLine()) {
+        return current.rect();
+    }
+    const int height = current.height();
+    const int bytesPerPixel = current.depth() / 8;
+    const qsizetype lineLength = static_cast<qsizetype>(current.width()) * bytesPerPixel;
+    VERIFY_OR_DEBUG_ASSERT(bytesPerPixel > 0) {
+        return current.rect();
+    }
+
+    int top = 0;
+    while (top < height &&
+            std::memcmp(previous.constScanLine(top), current.constScanLine(top), lineLength) ==
+                    0) {
+        top++;
+    }
+    if (top == height) {
+        return QRect();
+    }
+    int bottom = height - 1;
+    while (bottom > top &&
+            std::memcmp(previous.constScanLine(bottom),
+                    current.constScanLine(bottom),
+                    lineLength) == 0) {
+        bottom--;
+    }
+
+    // Narrow down the columns within the changed lines.
+    qsizetype left = lineLength;
+    qsizetype right = 0;
+    for (int y = top; y <= bottom; ++y) {
+        const uchar* pPrevious = previous.constScanLine(y);
+        const uchar* pCurrent = current.constScanLine(y);
+        qsizetype first = 0;
+        while (first < left && pPrevious[first] == pCurrent[first]) {
+            first++;
+        }
+        left = first;
+        qsizetype last = lineLength - 1;
+        while (last >= right && pPrevious[last] == pCurrent[last]) {
+            last--;
+        }
+        right = std::max(right, last);
+    }
+    const int leftPixel = static_cast<int>(left / bytesPerPixel);
+    const int rightPixel = static_cast<int>(right / bytesPerPixel);
+    return QRect(QPoint(leftPixel, top), QPoint(rightPixel, bottom));
+}
+
+bool ControllerRenderingEngine::initPixelBuffers() {
+    DEBUG_ASSERT(!m_pixelBuffers[0]);
+    // glMapBufferRange requires OpenGL (ES) 3.0
+    if (m_context->format().majorVersion() < 3) {
+        kLogger.info() << "Pixel buffer objects are not supported by the GL context. "
+                          "Falling back to synchronous read back.";
+        return false;
+    }
+    QImage frame(m_screenInfo.size, m_screenInfo.pixelFormat);
+    QOpenGLExtraFunctions* pGl = m_context->extraFunctions();
+    pGl->glGenBuffers(static_cast<GLsizei>(m_pixelBuffers.size()), m_pixelBuffers.data());
+    for (GLuint pixelBuffer : m_pixelBuffers) {
+        pGl->glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer);
+        pGl->glBufferData(GL_PIXEL_PACK_BUFFER,
+                static_cast<GLsizeiptr>(frame.sizeInBytes()),
+                nullptr,
+                GL_STREAM_READ);
+    }
+    pGl->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    GLenum glError = pGl->glGetError();
+    if (glError != GL_NO_ERROR) {
+        kLogger.warning() << "Unable to allocate pixel buffer objects, GLError:"
+                          << glError << ". Falling back to synchronous read back.";
+        releasePixelBuffers();
+        return false;
+    }
+    return true;
+}
+
+void ControllerRenderingEngine::releasePixelBuffers() {
+    if (m_pixelBuffers[0]) {
+        m_context->extraFunctions()->glDeleteBuffers(
+                static_cast<GLsizei>(m_pixelBuffers.size()), m_pixelBuffers.data());
+    }
+    m_pixelBuffers = {};
+    m_pixelBufferPending = false;
+}
+
+bool ControllerRenderingEngine::readFrame(QImage* pFrame, QDateTime* pTimestamp) {
+    const int width = m_screenInfo.size.width();
+    const int height = m_screenInfo.size.height();
+    if (!m_pixelBuffers[0]) {
+        ScopedTimer t(QStringLiteral("ControllerRenderingEngine::renderFrame::glReadPixels"));
+        m_context->functions()->glReadPixels(
+                0, 0, width, height, m_GLDataFormat, m_GLDataType, pFrame->bits());
+        return true;
+    }
+
+    QOpenGLExtraFunctions* pGl = m_context->extraFunctions();
+    {
+        // Queue the read back of the current frame. This returns immediately,
+        // the pixel transfer (and format conversion) happens on the GPU.
+        ScopedTimer t(QStringLiteral("ControllerRenderingEngine::renderFrame::glReadPixels"));
+        pGl->glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pixelBuffers[m_pixelBufferIndex]);
+        pGl->glReadPixels(0, 0, width, height, m_GLDataFormat, m_GLDataType, nullptr);
+    }
+
+    // Fetch the frame queued on the previous call, which should be
+    // available by now without stalling the pipeline.
+    const std::size_t previousIndex = (m_pixelBufferIndex + 1) % m_pixelBuffers.size();
+    bool frameAvailable = false;
+    if (m_pixelBufferPending) {
+        ScopedTimer t(QStringLiteral("ControllerRenderingEngine::renderFrame::mapPixelBuffer"));
+        pGl->glBindBuffer(GL_PIXEL_PACK_BUFFER, m_pixelBuffers[previousIndex]);
+        const auto* pData = static_cast<const uchar*>(pGl->glMapBufferRange(GL_PIXEL_PACK_BUFFER,
+                0,
+                static_cast<GLsizeiptr>(pFrame->sizeInBytes()),
+                GL_MAP_READ_BIT));
+        if (pData) {
+            std::memcpy(pFrame->bits(), pData, pFrame->sizeInBytes());
+            pGl->glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            *pTimestamp = m_pixelBufferTimestamp;
+            frameAvailable = true;
+        } else {
+            kLogger.warning() << "Unable to map the pixel buffer object";
+        }
+    }
+    pGl->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    m_pixelBufferTimestamp = QDateTime::currentDateTime();
+    m_pixelBufferPending = true;
+    m_pixelBufferIndex = previousIndex;
+    return frameAvailable;
+}
+
 void ControllerRenderingEngine::renderFrame() {
     ScopedTimer t(QStringLiteral("ControllerRenderingEngine::renderFrame"));
     if (!m_isValid) {
@@ -284,10 +440,19 @@ void ControllerRenderingEngine::renderFrame() {
         VERIFY_OR_TERMINATE(m_renderControl->initialize(),
                 "Failed to initialize redirected Qt Quick rendering");
 
-        m_quickWindow->setRenderTarget(QQuickRenderTarget::fromOpenGLTexture(m_fbo->texture(),
-                m_screenInfo.size));
+        QQuickRenderTarget renderTarget = QQuickRenderTarget::fromOpenGLTexture(
+                m_fbo->texture(), m_screenInfo.size);
+#if QT_VERSION >= QT_VERSION_CHECK(6, 4, 0)
+        // Let the scene graph render upside down, so the rows read back from
+        // OpenGL are already in the top-to-bottom order expected by devices.
+        renderTarget.setMirrorVertically(true);
+        m_renderTargetMirrored = true;
+#endif
+        m_quickWindow->setRenderTarget(renderTarget);
 
         m_quickWindow->setGeometry(0, 0, m_screenInfo.size.width(), m_screenInfo.size.height());
+
+        initPixelBuffers();
     }
 
     m_nextFrameStart = Clock::now();
@@ -340,16 +505,7 @@ void ControllerRenderingEngine::renderFrame() {
     while ((glError = m_context->functions()->glGetError()) != GL_NO_ERROR) {
         kLogger.debug() << "Retrieved a previously unhandled GL error: " << glError;
     }
-    {
-        ScopedTimer t(QStringLiteral("ControllerRenderingEngine::renderFrame::glReadPixels"));
-        m_context->functions()->glReadPixels(0,
-                0,
-                m_screenInfo.size.width(),
-                m_screenInfo.size.height(),
-                m_GLDataFormat,
-                m_GLDataType,
-                fboImage.bits());
-    }
+    const bool frameAvailable = readFrame(&fboImage, &timestamp);
     glError = m_context->functions()->glGetError();
     VERIFY_OR_TERMINATE(glError == GL_NO_ERROR, "GLError: " << glError);
     VERIFY_OR_DEBUG_ASSERT(!fboImage.isNull()) {
@@ -359,11 +515,31 @@ void ControllerRenderingEngine::renderFrame() {
         kLogger.debug() << "Couldn't release the FBO.";
     }
 
-    fboImage.mirror(false, true);
+    m_context->doneCurrent();
 
-    emit frameRendered(m_screenInfo, fboImage.copy(), timestamp);
+    if (!frameAvailable) {
+        // The first frame is still in flight.
+        scheduleNextFrame();
+        return;
+    }
 
-    m_context->doneCurrent();
+    if (!m_renderTargetMirrored) {
+        fboImage.mirror(false, true);
+    }
+
+    QRect dirtyArea = changedArea(m_lastFrame, fboImage);
+    if (dirtyArea.isEmpty()) {
+        if (Clock::now() - m_lastFrameEmitted < kMaxUnchangedFrameInterval) {
+            Counter(m_skippedFrameStatKey).increment();
+            scheduleNextFrame();
+            return;
+        }
+        dirtyArea = fboImage.rect();
+    }
+
+    m_lastFrame = fboImage;
+    m_lastFrameEmitted = Clock::now();
+    emit frameRendered(m_screenInfo, fboImage, timestamp, dirtyArea);
 }
 
 bool ControllerRenderingEngine::stop() {
@@ -378,17 +554,26 @@ void ControllerRenderingEngine::send(Controller* controller, const QByteArray& f
         VERIFY_OR_TERMINATE(controller->sendBytes(frame), "Unable to send frame to device");
     }
 
+    const auto frameTime = Clock::now() - m_nextFrameStart;
+    Stat::track(m_frameTimeStatKey,
+            Stat::DURATION_NANOSEC,
+            Stat::experimentFlags(kDefaultComputeFlags),
+            static_cast<double>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(frameTime)
+                            .count()));
     if (CmdlineArgs::Instance()
                     .getControllerDebug()) {
-        auto endOfFrameCycle = Clock::now();
         kLogger.debug()
                 << "Frame took "
-                << std::chrono::duration_cast<std::chrono::milliseconds>(
-                           endOfFrameCycle - m_nextFrameStart)
+                << std::chrono::duration_cast<std::chrono::milliseconds>(frameTime)
                            .count()
                 << "milliseconds and frame has" << frame.size() << "bytes";
     }
 
+    scheduleNextFrame();
+}
+
+void ControllerRenderingEngine::scheduleNextFrame() {
     m_nextFrameStart += std::chrono::microseconds(1000000 / m_screenInfo.target_fps);
 
     auto durationToWaitBeforeFrame =
@@ -3,6 +3,7 @@
 #include <QObject>
 #include <QOpenGLContext>
 #include <QOpenGLFramebufferObject>
+#include <array>
 #include <chrono>
 #include <gsl/pointers>
 
@@ -52,6 +53,13 @@ class ControllerRenderingEngine : public QObject {
         return m_screenInfo;
     }
 
+    /// Returns the bounding rectangle of all pixels that differ between
+    /// `previous` and `current`. An empty rectangle means that both frames are
+    /// identical. If the frames cannot be compared (e.g no previous frame, or
+    /// a size or format mismatch), the full rectangle of `current` is
+    /// returned.
+    static QRect changedArea(const QImage& previous, const QImage& current);
+
   public slots:
     // Request sending frame data to the device. The task will be run in the
     // rendering event loop. This method should only be called once received the
@@ -72,9 +80,14 @@ class ControllerRenderingEngine : public QObject {
     void send(Controller* controller, const QByteArray& frame);
 
   signals:
+    /// @brief Emitted when a new frame is ready to be transformed and sent.
+    /// Frames identical to the previous one are not emitted.
+    /// @param dirtyArea the area of the frame that changed since the previous
+    /// emitted frame.
     void frameRendered(const LegacyControllerMapping::ScreenInfo& screeninfo,
             QImage frame,
-            const QDateTime& timestamp);
+            const QDateTime& timestamp,
+            const QRect& dirtyArea);
     void stopping();
     /// @brief Request the screen thread to send a frame to the device.
     /// @param controller the controller to send the frame to.
@@ -84,7 +97,18 @@ class ControllerRenderingEngine : public QObject {
   private:
     virtual void prepare();
 
+    bool initPixelBuffers();
+    void releasePixelBuffers();
+    // Read back the frame currently rendered in the FBO into `pFrame`. When
+    // pixel buffer objects are available, the read back is asynchronous and
+    // `pFrame` receives the frame rendered on the previous call instead, with
+    // `pTimestamp` updated accordingly. Returns false if no frame is
+    // available yet.
+    bool readFrame(QImage* pFrame, QDateTime* pTimestamp);
+    void scheduleNextFrame();
+
     std::chrono::time_point<std::chrono::steady_clock> m_nextFrameStart;
+    std::chrono::time_point<std::chrono::steady_clock> m_lastFrameEmitted;
 
     LegacyControllerMapping::ScreenInfo m_screenInfo;
 
@@ -97,6 +121,21 @@ class ControllerRenderingEngine : public QObject {
 
     std::unique_ptr<QOpenGLFramebufferObject> m_fbo;
 
+    // Double-buffered pixel buffer objects used for asynchronous read back.
+    // Empty (zeroed) if not supported by the GL context.
+    std::array<GLuint, 2> m_pixelBuffers;
+    std::size_t m_pixelBufferIndex;
+    bool m_pixelBufferPending;
+    QDateTime m_pixelBufferTimestamp;
+    // Whether the Qt Quick render target is already mirrored vertically, so
+    // the read back frame doesn't need to be flipped on the CPU.
+    bool m_renderTargetMirrored;
+
+    // Last emitted frame, used to detect dirty areas.
+    QImage m_lastFrame;
+    QString m_frameTimeStatKey;
+    QString m_skippedFrameStatKey;
+
     GLenum m_GLDataFormat;
     GLenum m_GLDataType;
 
@@ -502,7 +502,8 @@ bool ControllerScriptEngineLegacy::bindSceneToScreen(
 void ControllerScriptEngineLegacy::handleScreenFrame(
         const LegacyControllerMapping::ScreenInfo& screenInfo,
         const QImage& frame,
-        const QDateTime& timestamp) {
+        const QDateTime& timestamp,
+        const QRect& dirtyArea) {
     VERIFY_OR_DEBUG_ASSERT(
             m_renderingScreens.contains(screenInfo.identifier)) {
         qCWarning(m_logger) << "Unable to find transform function info for the given screen";
@@ -563,9 +564,17 @@ void ControllerScriptEngineLegacy::handleScreenFrame(
     }
     // During the frame transformation, any QML errors are considered fatal.
     setErrorsAreFatal(true);
+    // The dirty area lets mappings for devices supporting partial updates
+    // only transform and send the region that changed.
+    QJSValue jsDirtyArea = m_pJSEngine->newObject();
+    jsDirtyArea.setProperty(QStringLiteral("x"), dirtyArea.x());
+    jsDirtyArea.setProperty(QStringLiteral("y"), dirtyArea.y());
+    jsDirtyArea.setProperty(QStringLiteral("width"), dirtyArea.width());
+    jsDirtyArea.setProperty(QStringLiteral("height"), dirtyArea.height());
     auto result = pScreen->getTransform().call(
             QJSValueList{m_pJSEngine->toScriptValue(input),
-                    m_pJSEngine->toScriptValue(timestamp)});
+                    m_pJSEngine->toScriptValue(timestamp),
+                    jsDirtyArea});
     if (result.isError()) {
         qCWarning(m_logger) << "Could not transform rendering buffer for screen"
                             << screenInfo.identifier;
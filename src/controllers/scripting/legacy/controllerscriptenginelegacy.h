@@ -68,7 +68,8 @@ class ControllerScriptEngineLegacy : public ControllerScriptEngineBase {
     void handleScreenFrame(
             const LegacyControllerMapping::ScreenInfo& screeninfo,
             const QImage& frame,
-            const QDateTime& timestamp);
+            const QDateTime& timestamp,
+            const QRect& dirtyArea);
 
   signals:
     /// Emitted when a screen has been rendered.
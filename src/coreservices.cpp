@@ -300,7 +300,8 @@ void CoreServices::initialize(QApplication* pApp) {
 #ifdef __BROADCAST__
     m_pBroadcastManager = std::make_shared<BroadcastManager>(
             m_pSettingsManager.get(),
-            m_pSoundManager.get());
+            m_pSoundManager.get(),
+            m_pEngine.get());
 #endif
 
 #ifdef __VINYLCONTROL__
@@ -356,7 +357,8 @@ void CoreServices::initialize(QApplication* pApp) {
             &ScreensaverManager::slotCurrentPlayingDeckChanged);
 
     emit initializationProgressUpdate(50, tr("library"));
-    CoverArtCache::createInstance();
+    CoverArtCache::createInstance(
+            QDir(pConfig->getSettingsPath()).filePath(QStringLiteral("coverthumbnails")));
     Clipboard::createInstance();
 
     m_pTrackCollectionManager = std::make_shared<TrackCollectionManager>(
@@ -51,6 +51,10 @@ class CoreServices : public QObject {
         return m_pControlIndicatorTimer;
     }
 
+    std::shared_ptr<EngineMixer> getEngineMixer() const {
+        return m_pEngine;
+    }
+
     std::shared_ptr<SoundManager> getSoundManager() const {
         return m_pSoundManager;
     }
@@ -1,5 +1,6 @@
 #include "engine/cachingreader/cachingreader.h"
 
+#include <QThread>
 #include <QtDebug>
 
 #include "moc_cachingreader.cpp"
@@ -35,6 +36,10 @@ constexpr SINT kDefaultHintFrames = 1024;
 // massive drop outs are expected to occur Mixxx should run reliably!
 constexpr SINT kNumberOfCachedChunksInMemory = 80;
 
+// Polling interval while waiting for the worker in synchronous mode. Decoding
+// a chunk takes much longer, so this doesn't need to be any shorter.
+constexpr unsigned long kSynchronousReadPollIntervalUs = 100;
+
 } // anonymous namespace
 
 CachingReader::CachingReader(const QString& group,
@@ -60,11 +65,15 @@ CachingReader::CachingReader(const QString& group,
           m_lruCachingReaderChunk(nullptr),
           m_sampleBuffer(CachingReaderChunk::kFrames * maxSupportedChannel *
                   kNumberOfCachedChunksInMemory),
+          m_synchronousReads(false),
           m_worker(group,
                   &m_chunkReadRequestFIFO,
                   &m_readerStatusUpdateFIFO,
                   maxSupportedChannel) {
     m_allocatedCachingReaderChunks.reserve(kNumberOfCachedChunksInMemory);
+#ifdef __STEM__
+    m_refreshingChunks.reserve(kNumberOfCachedChunksInMemory);
+#endif
     // Divide up the allocated raw memory buffer into total_chunks
     // chunks. Initialize each chunk to hold nothing and add it to the free
     // list.
@@ -244,6 +253,19 @@ void CachingReader::process() {
                     update.status == CHUNK_READ_EOF ||
                     update.status == CHUNK_READ_INVALID ||
                     update.status == CHUNK_READ_DISCARDED);
+#ifdef __STEM__
+            if (m_refreshingChunks.value(pChunk->getIndex()) == pChunk) {
+                m_refreshingChunks.remove(pChunk->getIndex());
+                if (m_state.loadAcquire() == STATE_TRACK_LOADED &&
+                        update.status == CHUNK_READ_SUCCESS) {
+                    replaceChunk(pChunk);
+                } else {
+                    // Keep the cached chunk, it is still readable
+                    freeChunkFromList(pChunk);
+                }
+                continue;
+            }
+#endif
             if (m_state.loadAcquire() == STATE_TRACK_LOADING) {
                 // Discard all results from pending read requests for the
                 // previous track before the next track has been loaded.
@@ -448,7 +470,23 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
                 }
 
                 mixxx::IndexRange bufferedFrameIndexRange;
-                const CachingReaderChunkForOwner* const pChunk = lookupChunkAndFreshen(chunkIndex);
+#ifdef __STEM__
+                if (m_synchronousReads) {
+                    // Offline rendering must not wait for the replacement
+                    // of a chunk with missing stems
+                    auto* pStaleChunk = lookupChunk(chunkIndex);
+                    if (pStaleChunk &&
+                            pStaleChunk->getState() == CachingReaderChunkForOwner::READY &&
+                            !pStaleChunk->containsStems(m_stemMask)) {
+                        freeChunk(pStaleChunk);
+                    }
+                }
+#endif
+                const CachingReaderChunkForOwner* pChunk = lookupChunkAndFreshen(chunkIndex);
+                if (m_synchronousReads &&
+                        !(pChunk && pChunk->getState() == CachingReaderChunkForOwner::READY)) {
+                    pChunk = waitForChunk(chunkIndex);
+                }
                 if (pChunk && (pChunk->getState() == CachingReaderChunkForOwner::READY)) {
                     if (reverse) {
                         bufferedFrameIndexRange =
@@ -536,6 +574,111 @@ CachingReader::ReadResult CachingReader::read(SINT startSample,
     return result;
 }
 
+CachingReaderChunkForOwner* CachingReader::requestChunk(SINT chunkIndex) {
+    CachingReaderChunkForOwner* pChunk = allocateChunkExpireLRU(chunkIndex);
+    if (!pChunk) {
+        kLogger.warning()
+                << "Failed to allocate chunk"
+                << chunkIndex
+                << "for read request";
+        return nullptr;
+    }
+#ifdef __STEM__
+    pChunk->setStemMask(m_stemMask);
+#endif
+    // Do not insert the allocated chunk into the MRU/LRU list,
+    // because it will be handed over to the worker immediately
+    CachingReaderChunkReadRequest request;
+    request.giveToWorker(pChunk);
+    if (kLogger.traceEnabled()) {
+        kLogger.trace()
+                << "Requesting read of chunk"
+                << request.chunk;
+    }
+    if (m_chunkReadRequestFIFO.write(&request, 1) != 1) {
+        kLogger.warning()
+                << "Failed to submit read request for chunk"
+                << chunkIndex;
+        // Revoke the chunk from the worker and free it
+        pChunk->takeFromWorker();
+        freeChunk(pChunk);
+        return nullptr;
+    }
+    return pChunk;
+}
+
+#ifdef __STEM__
+bool CachingReader::requestChunkRefresh(SINT chunkIndex) {
+    if (m_freeChunks.empty() && m_lruCachingReaderChunk) {
+        freeChunk(m_lruCachingReaderChunk);
+    }
+    if (m_freeChunks.empty()) {
+        return false;
+    }
+    CachingReaderChunkForOwner* pChunk = m_freeChunks.front();
+    m_freeChunks.pop_front();
+    // Not inserted into m_allocatedCachingReaderChunks until it
+    // replaces the cached chunk
+    pChunk->init(chunkIndex);
+    pChunk->setStemMask(m_stemMask);
+    CachingReaderChunkReadRequest request;
+    request.giveToWorker(pChunk);
+    if (m_chunkReadRequestFIFO.write(&request, 1) != 1) {
+        pChunk->takeFromWorker();
+        freeChunkFromList(pChunk);
+        return false;
+    }
+    m_refreshingChunks.insert(chunkIndex, pChunk);
+    return true;
+}
+
+void CachingReader::replaceChunk(CachingReaderChunkForOwner* pRefreshedChunk) {
+    const SINT chunkIndex = pRefreshedChunk->getIndex();
+    CachingReaderChunkForOwner* pCachedChunk = lookupChunk(chunkIndex);
+    if (pCachedChunk) {
+        if (pCachedChunk->getState() == CachingReaderChunkForOwner::READ_PENDING) {
+            // The cached chunk has been evicted in the meantime and a
+            // regular read of the same chunk is already pending
+            freeChunkFromList(pRefreshedChunk);
+            return;
+        }
+        freeChunk(pCachedChunk);
+    }
+    m_allocatedCachingReaderChunks.insert(chunkIndex, pRefreshedChunk);
+    freshenChunk(pRefreshedChunk);
+}
+#endif
+
+const CachingReaderChunkForOwner* CachingReader::waitForChunk(SINT chunkIndex) {
+    DEBUG_ASSERT(m_synchronousReads);
+    CachingReaderChunkForOwner* pChunk = lookupChunk(chunkIndex);
+    if (!pChunk) {
+        // Pending hints may have filled the request FIFO, wait until
+        // the worker has picked them up.
+        while (m_chunkReadRequestFIFO.writeAvailable() == 0) {
+            m_worker.wake();
+            QThread::usleep(kSynchronousReadPollIntervalUs);
+            process();
+        }
+        pChunk = requestChunk(chunkIndex);
+        if (!pChunk) {
+            return nullptr;
+        }
+    }
+    m_worker.wake();
+    while (pChunk->getState() != CachingReaderChunkForOwner::READY) {
+        QThread::usleep(kSynchronousReadPollIntervalUs);
+        process();
+        // The chunk is freed if reading failed
+        pChunk = lookupChunk(chunkIndex);
+        if (!pChunk) {
+            return nullptr;
+        }
+    }
+    freshenChunk(pChunk);
+    return pChunk;
+}
+
 void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
     // If no file is loaded, skip.
     if (atomicLoadRelaxed(m_state) != STATE_TRACK_LOADED) {
@@ -583,35 +726,20 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
             CachingReaderChunkForOwner* pChunk = lookupChunk(chunkIndex);
             if (!pChunk) {
                 shouldWake = true;
-                pChunk = allocateChunkExpireLRU(chunkIndex);
-                if (!pChunk) {
-                    kLogger.warning()
-                            << "Failed to allocate chunk"
-                            << chunkIndex
-                            << "for read request";
-                    continue;
-                }
-                // Do not insert the allocated chunk into the MRU/LRU list,
-                // because it will be handed over to the worker immediately
-                CachingReaderChunkReadRequest request;
-                request.giveToWorker(pChunk);
-                if (kLogger.traceEnabled()) {
-                    kLogger.trace()
-                            << "Requesting read of chunk"
-                            << request.chunk;
-                }
-                if (m_chunkReadRequestFIFO.write(&request, 1) != 1) {
-                    kLogger.warning()
-                            << "Failed to submit read request for chunk"
-                            << chunkIndex;
-                    // Revoke the chunk from the worker and free it
-                    pChunk->takeFromWorker();
-                    freeChunk(pChunk);
-                }
+                requestChunk(chunkIndex);
             } else if (pChunk->getState() == CachingReaderChunkForOwner::READY) {
                 // This will cause the chunk to be 'freshened' in the cache. The
                 // chunk will be moved to the end of the LRU list.
                 freshenChunk(pChunk);
+#ifdef __STEM__
+                if (!pChunk->containsStems(m_stemMask) &&
+                        !m_refreshingChunks.contains(chunkIndex) &&
+                        requestChunkRefresh(chunkIndex)) {
+                    // A stem has been unmuted. The cached chunk is read
+                    // with the stem still silent until it is replaced.
+                    shouldWake = true;
+                }
+#endif
             }
         }
     }
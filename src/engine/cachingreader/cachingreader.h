@@ -126,6 +126,24 @@ class CachingReader : public QObject {
         m_worker.setScheduler(pScheduler);
     }
 
+    // In synchronous mode read() blocks on a cache miss until the missing
+    // chunk has been decoded instead of returning silence. This makes the
+    // output deterministic when the engine is driven offline. Must never be
+    // enabled while rendering in realtime.
+    void setSynchronousReads(bool synchronousReads) {
+        m_synchronousReads = synchronousReads;
+    }
+
+#ifdef __STEM__
+    // The stems that need to be audible, an empty selection for all stems.
+    // Newly read chunks only contain those stems. Cached chunks with missing
+    // stems are read again when hinted and replaced once they are ready.
+    // Must only be called from the engine callback.
+    void setStemMask(mixxx::StemChannelSelection stemMask) {
+        m_stemMask = stemMask;
+    }
+#endif
+
   signals:
     // Emitted once a new track is loaded and ready to be read from.
     void trackLoading();
@@ -168,6 +186,25 @@ class CachingReader : public QObject {
     // Gets a chunk from the free list, frees the LRU CachingReaderChunk if none available.
     CachingReaderChunkForOwner* allocateChunkExpireLRU(SINT chunkIndex);
 
+    // Allocates a chunk and hands it over to the worker for reading.
+    // Returns nullptr if the request could not be submitted.
+    CachingReaderChunkForOwner* requestChunk(SINT chunkIndex);
+
+    // Requests the chunk if needed and blocks until the worker has read it.
+    // Returns nullptr if the chunk could not be read. Only used for
+    // synchronous reads.
+    const CachingReaderChunkForOwner* waitForChunk(SINT chunkIndex);
+
+#ifdef __STEM__
+    // Reads a cached chunk again into another chunk, which replaces the
+    // cached chunk when it is ready. Returns false if the request could not
+    // be submitted.
+    bool requestChunkRefresh(SINT chunkIndex);
+
+    // Replaces the cached chunk with the refreshed chunk from the worker
+    void replaceChunk(CachingReaderChunkForOwner* pRefreshedChunk);
+#endif
+
     enum State {
         STATE_IDLE,
         STATE_TRACK_LOADING,
@@ -197,5 +234,15 @@ class CachingReader : public QObject {
     // The readable frame index range as reported by the worker.
     mixxx::IndexRange m_readableFrameIndexRange;
 
+    bool m_synchronousReads;
+
+#ifdef __STEM__
+    mixxx::StemChannelSelection m_stemMask;
+
+    // Chunks that are read again by the worker for the cached chunk
+    // with the same index
+    QHash<int, CachingReaderChunkForOwner*> m_refreshingChunks;
+#endif
+
     CachingReaderWorker m_worker;
 };
@@ -26,6 +26,9 @@ void CachingReaderChunk::init(SINT index) {
     DEBUG_ASSERT(m_index == kInvalidChunkIndex || index == kInvalidChunkIndex);
     m_index = index;
     m_bufferedSampleFrames.frameIndexRange() = mixxx::IndexRange();
+#ifdef __STEM__
+    m_stemMask = mixxx::StemChannelSelection();
+#endif
 }
 
 // Frame index range of this chunk for the given audio source.
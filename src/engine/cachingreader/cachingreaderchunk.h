@@ -71,6 +71,27 @@ public:
             mixxx::audio::ChannelCount channelCount,
             const mixxx::IndexRange& frameIndexRange) const;
 
+#ifdef __STEM__
+    // The stems that have been decoded into the chunk, empty if all
+    // channels have been decoded. Before handing over the chunk the owner
+    // sets the stems that need to be decoded, the worker then replaces
+    // them with the stems that have actually been decoded.
+    mixxx::StemChannelSelection stemMask() const {
+        return m_stemMask;
+    }
+    void setStemMask(mixxx::StemChannelSelection stemMask) {
+        m_stemMask = stemMask;
+    }
+
+    // Returns false if any of the given stems has not been decoded
+    bool containsStems(mixxx::StemChannelSelection stemMask) const {
+        if (!m_stemMask) {
+            return true;
+        }
+        return stemMask && !(stemMask & ~m_stemMask);
+    }
+#endif
+
   protected:
     explicit CachingReaderChunk(
             mixxx::SampleBuffer::WritableSlice sampleBuffer);
@@ -89,6 +110,10 @@ public:
     // set the corresponding frame index range.
     mixxx::SampleBuffer::WritableSlice m_sampleBuffer;
     mixxx::ReadableSampleFrames m_bufferedSampleFrames;
+
+#ifdef __STEM__
+    mixxx::StemChannelSelection m_stemMask;
+#endif
 };
 
 // This derived class is only accessible for the cache as the owner,
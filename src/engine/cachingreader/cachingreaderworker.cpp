@@ -51,6 +51,16 @@ ReaderStatusUpdate CachingReaderWorker::processReadRequest(
         return result;
     }
 
+#ifdef __STEM__
+    // Muted stems are neither decoded nor cached. The chunk is read again
+    // when one of them is unmuted.
+    if (pChunk->stemMask() != m_requestedStemMask) {
+        m_requestedStemMask = pChunk->stemMask();
+        m_decodedStemMask = m_pAudioSource->selectDecodedStems(m_requestedStemMask);
+    }
+    pChunk->setStemMask(m_decodedStemMask);
+#endif
+
     // Try to read the data required for the chunk from the audio source
     const mixxx::IndexRange bufferedFrameIndexRange = pChunk->bufferSampleFrames(
             m_pAudioSource,
@@ -250,6 +260,12 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
         return;
     }
 
+#ifdef __STEM__
+    // The new audio source decodes all stems
+    m_requestedStemMask = mixxx::StemChannelSelection();
+    m_decodedStemMask = mixxx::StemChannelSelection();
+#endif
+
     // Initially assume that the complete content offered by audio source
     // is available for reading. Later if read errors occur this value will
     // be decreased to avoid repeated reading of corrupt audio data.
@@ -185,5 +185,12 @@ class CachingReaderWorker : public EngineWorker {
     // The maximum number of channel that this reader can support
     mixxx::audio::ChannelCount m_maxSupportedChannel;
 
+#ifdef __STEM__
+    // The stems requested by the last chunk read and the stems that
+    // the audio source actually decodes for them
+    mixxx::StemChannelSelection m_requestedStemMask;
+    mixxx::StemChannelSelection m_decodedStemMask;
+#endif
+
     QAtomicInt m_stop;
 };
@@ -138,6 +138,17 @@ void EngineDeck::processStem(CSAMPLE* pOut, const std::size_t bufferSize) {
     mixxx::audio::SampleRate sampleRate = mixxx::audio::SampleRate::fromDouble(m_sampleRate.get());
     unsigned int stemCount = chCount / mixxx::kEngineChannelOutputCount;
     SINT numFrames = bufferSize / mixxx::kEngineChannelOutputCount;
+
+    // Muted stems are neither decoded nor cached by the reader. If all
+    // stems are muted they are still decoded to be ready for unmuting.
+    int audibleStems = 0;
+    for (unsigned int stemIdx = 0; stemIdx < stemCount; stemIdx++) {
+        if (!m_stemMute[stemIdx]->toBool()) {
+            audibleStems |= 1 << stemIdx;
+        }
+    }
+    m_pBuffer->setStemMask(mixxx::StemChannelSelection::fromInt(audibleStems));
+
     std::size_t allChannelBufferSize = bufferSize * stemCount;
     if (m_stemBuffer.size() < static_cast<SINT>(allChannelBufferSize)) {
         m_stemBuffer = mixxx::SampleBuffer(allChannelBufferSize);
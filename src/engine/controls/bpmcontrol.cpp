@@ -6,6 +6,7 @@
 #include "control/controlpushbutton.h"
 #include "engine/effects/groupfeaturestate.h"
 #include "engine/enginebuffer.h"
+#include "engine/sync/leadercallbackadvance.h"
 #include "moc_bpmcontrol.cpp"
 #include "track/beatutils.h"
 #include "track/track.h"
@@ -69,6 +70,7 @@ BpmControl::BpmControl(const QString& group,
           m_bpmTapFilter(this, kBpmTapFilterLength, kBpmTapMaxInterval),
           m_tempoTapFilter(this, kBpmTapFilterLength, kBpmTapMaxInterval),
           m_dSyncInstantaneousBpm(0.0),
+          m_dLeaderBeatsPerCallback(0.0),
           m_dLastSyncAdjustment(1.0) {
     m_dSyncTargetBeatDistance.setValue(0.0);
     m_dUserOffset.setValue(0.0);
@@ -566,6 +568,24 @@ double BpmControl::calcSyncAdjustment(bool userTweakingSync) {
         if (fabs(error) > kTrainWreckThreshold) {
             // Assume poor reflexes (late button push) -- speed up to catch the other track.
             adjustment = 1.0 + kSyncAdjustmentCap;
+        } else if (m_dLeaderBeatsPerCallback > 0.0) {
+            // Buffer-scaled phase correction: we know how far the target
+            // advances per callback, so close the error within a correction
+            // horizon measured in beats, and recalculate the rate with every
+            // callback. This decays the error with the same time constant
+            // regardless of the buffer size, and without a dead band it does
+            // not drift inside the threshold below.
+            constexpr double kSyncCorrectionBeats = 1.0;
+            // The slew limit per beat, not per callback
+            constexpr double kSyncDeltaCapPerBeat = 0.1;
+            const double horizon = math_max(kSyncCorrectionBeats,
+                    m_dLeaderBeatsPerCallback * LeaderCallbackAdvance::kCorrectionCallbacks);
+            const double adjust = 1.0 - error / horizon;
+            const double deltaCap = kSyncDeltaCapPerBeat * m_dLeaderBeatsPerCallback;
+            const double delta = math_clamp(adjust - m_dLastSyncAdjustment, -deltaCap, deltaCap);
+            adjustment = 1.0 + math_clamp(
+                    m_dLastSyncAdjustment - 1.0 + delta,
+                    -kSyncAdjustmentCap, kSyncAdjustmentCap);
         } else if (fabs(error) > kErrorThreshold) {
             // Proportional control constant. The higher this is, the more we
             // influence sync.
@@ -1263,6 +1283,10 @@ void BpmControl::updateInstantaneousBpm(double instantaneousBpm) {
     m_dSyncInstantaneousBpm = instantaneousBpm;
 }
 
+void BpmControl::updateLeaderBeatsPerCallback(double beatsPerCallback) {
+    m_dLeaderBeatsPerCallback = beatsPerCallback;
+}
+
 void BpmControl::resetSyncAdjustment() {
     // Immediately edit the beat distance to reflect the new reality.
     double new_distance = m_pThisBeatDistance.get() + m_dUserOffset.getValue();
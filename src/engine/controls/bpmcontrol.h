@@ -55,6 +55,9 @@ class BpmControl : public EngineControl {
 
     void setTargetBeatDistance(double beatDistance);
     void updateInstantaneousBpm(double instantaneousBpm);
+    /// The beats the sync target advances per callback, or 0 if the phase
+    /// correction is not scaled to the callback length.
+    void updateLeaderBeatsPerCallback(double beatsPerCallback);
     void resetSyncAdjustment();
     mixxx::Bpm updateLocalBpm();
     /// Updates the beat distance based on the current play position.
@@ -189,6 +192,7 @@ class BpmControl : public EngineControl {
 
     // used in the engine thread only
     double m_dSyncInstantaneousBpm;
+    double m_dLeaderBeatsPerCallback;
     double m_dLastSyncAdjustment;
 
     // m_pBeats is written from an engine worker thread
@@ -330,6 +330,16 @@ void EngineBuffer::bindWorkers(EngineWorkerScheduler* pWorkerScheduler) {
     m_pReader->setScheduler(pWorkerScheduler);
 }
 
+void EngineBuffer::setSynchronousReads(bool synchronousReads) {
+    m_pReader->setSynchronousReads(synchronousReads);
+}
+
+#ifdef __STEM__
+void EngineBuffer::setStemMask(mixxx::StemChannelSelection stemMask) {
+    m_pReader->setStemMask(stemMask);
+}
+#endif
+
 void EngineBuffer::enableIndependentPitchTempoScaling(bool bEnable,
         const std::size_t bufferSize) {
     // MUST ACQUIRE THE PAUSE MUTEX BEFORE CALLING THIS METHOD
@@ -107,6 +107,12 @@ class EngineBuffer : public EngineObject {
     virtual ~EngineBuffer();
 
     void bindWorkers(EngineWorkerScheduler* pWorkerScheduler);
+    // See CachingReader::setSynchronousReads()
+    void setSynchronousReads(bool synchronousReads);
+#ifdef __STEM__
+    // See CachingReader::setStemMask()
+    void setStemMask(mixxx::StemChannelSelection stemMask);
+#endif
 
     QString getGroup() const;
     // Return the current rate (not thread-safe)
@@ -879,6 +879,15 @@ EngineChannel* EngineMixer::getChannel(const QString& group) {
     return nullptr;
 }
 
+void EngineMixer::setSynchronousReads(bool synchronousReads) {
+    for (const auto& pChannelInfo : m_channels) {
+        EngineBuffer* pBuffer = pChannelInfo->m_pChannel->getEngineBuffer();
+        if (pBuffer) {
+            pBuffer->setSynchronousReads(synchronousReads);
+        }
+    }
+}
+
 CSAMPLE_GAIN EngineMixer::getMainGain(int channelIndex) const {
     if (channelIndex >= 0 && channelIndex < m_channelMainGainCache.size()) {
         return m_channelMainGainCache[channelIndex].m_gain;
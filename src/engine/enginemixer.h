@@ -74,6 +74,11 @@ class EngineMixer : public QObject, public AudioSource {
     // only call it before the engine has started mixing.
     void addChannel(std::unique_ptr<EngineChannel> pChannel);
     EngineChannel* getChannel(const QString& group);
+
+    // Makes all channels block on a cache miss until the audio data has been
+    // decoded, see CachingReader::setSynchronousReads(). Only for driving the
+    // engine offline, not thread safe.
+    void setSynchronousReads(bool synchronousReads);
     static inline CSAMPLE_GAIN gainForOrientation(EngineChannel::ChannelOrientation orientation,
             CSAMPLE_GAIN leftGain,
             CSAMPLE_GAIN centerGain,
@@ -29,6 +29,10 @@ void EngineWorker::workReady() {
     m_pScheduler->workerReady();
 }
 
+void EngineWorker::wake() {
+    m_semaRun.release();
+}
+
 void EngineWorker::wakeIfReady() {
     if (!m_notReady.test_and_set()) {
         m_semaRun.release();
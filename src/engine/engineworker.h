@@ -23,6 +23,10 @@ class EngineWorker : public QThread {
     void setScheduler(EngineWorkerScheduler* pScheduler);
     void workReady();
     void wakeIfReady();
+    // Wakes the worker immediately without going through the scheduler.
+    // Must not be called from the audio callback, only when the engine is
+    // driven offline.
+    void wake();
 
   protected:
     QSemaphore m_semaRun;
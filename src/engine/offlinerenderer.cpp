@@ -0,0 +1,225 @@
+#include "engine/offlinerenderer.h"
+
+#include <QIODevice>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <algorithm>
+#include <cmath>
+
+#include "control/controlobject.h"
+#include "engine/engine.h"
+#include "engine/enginemixer.h"
+#include "soundio/soundmanagerutil.h"
+#include "util/assert.h"
+#include "util/defs.h"
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/performancetimer.h"
+#include "util/stat.h"
+
+namespace {
+
+const mixxx::Logger kLogger("OfflineRenderer");
+
+const QString kAppGroup = QStringLiteral("[App]");
+
+const QRegularExpression kFieldSeparator(QStringLiteral("\\s+"));
+
+} // anonymous namespace
+
+double OfflineRenderer::Result::realtimeFactor(mixxx::audio::SampleRate sampleRate) const {
+    const double renderSeconds = renderTime.toDoubleSeconds();
+    if (renderSeconds <= 0 || !sampleRate.isValid()) {
+        return 0;
+    }
+    return frames / sampleRate.toDouble() / renderSeconds;
+}
+
+OfflineRenderer::OfflineRenderer(UserSettingsPointer pConfig,
+        EngineMixer* pEngineMixer,
+        mixxx::audio::SampleRate sampleRate,
+        SINT framesPerBuffer)
+        : m_pConfig(pConfig),
+          m_pEngineMixer(pEngineMixer),
+          m_sampleRate(sampleRate),
+          m_framesPerBuffer(framesPerBuffer),
+          m_nextEvent(0) {
+    DEBUG_ASSERT(m_pEngineMixer);
+    DEBUG_ASSERT(m_sampleRate.isValid());
+    DEBUG_ASSERT(m_framesPerBuffer > 0);
+    DEBUG_ASSERT(m_framesPerBuffer <= static_cast<SINT>(kMaxEngineFrames));
+}
+
+OfflineRenderer::~OfflineRenderer() {
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+// static
+std::optional<QList<OfflineRenderEvent>> OfflineRenderer::parseAutomationScript(
+        QIODevice* pDevice,
+        mixxx::audio::SampleRate sampleRate,
+        QString* pErrorMessage) {
+    QList<OfflineRenderEvent> events;
+    QTextStream in(pDevice);
+    int lineNumber = 0;
+    while (!in.atEnd()) {
+        const QString line = in.readLine().trimmed();
+        ++lineNumber;
+        if (line.isEmpty() || line.startsWith(QChar('#'))) {
+            continue;
+        }
+        const QStringList fields = line.split(kFieldSeparator, Qt::SkipEmptyParts);
+        bool timeOk = false;
+        bool valueOk = false;
+        const double seconds = fields.size() == 4 ? fields[0].toDouble(&timeOk) : 0;
+        const double value = fields.size() == 4 ? fields[3].toDouble(&valueOk) : 0;
+        if (!timeOk || !valueOk || seconds < 0) {
+            if (pErrorMessage) {
+                *pErrorMessage = QStringLiteral("Invalid automation event in line %1: %2")
+                                         .arg(QString::number(lineNumber), line);
+            }
+            return std::nullopt;
+        }
+        events.append(OfflineRenderEvent{
+                static_cast<SINT>(std::round(seconds * sampleRate.toDouble())),
+                ConfigKey(fields[1], fields[2]),
+                value});
+    }
+    // Events at the same time are applied in the order of the script
+    std::stable_sort(events.begin(),
+            events.end(),
+            [](const OfflineRenderEvent& lhs, const OfflineRenderEvent& rhs) {
+                return lhs.framePos < rhs.framePos;
+            });
+    return events;
+}
+
+void OfflineRenderer::setAutomation(QList<OfflineRenderEvent> events) {
+    m_events = std::move(events);
+    m_nextEvent = 0;
+}
+
+void OfflineRenderer::applyAutomation(SINT endFramePos) {
+    // Events are quantized to the start of the buffer that contains them,
+    // the same as control changes from a controller in realtime.
+    while (m_nextEvent < m_events.size() &&
+            m_events[m_nextEvent].framePos < endFramePos) {
+        const OfflineRenderEvent& event = m_events[m_nextEvent++];
+        ControlObject* pControl = ControlObject::getControl(
+                event.key, ControlFlag::AllowMissingOrInvalid);
+        if (!pControl) {
+            kLogger.warning()
+                    << "Ignoring automation event for unknown control"
+                    << event.key;
+            continue;
+        }
+        pControl->set(event.value);
+    }
+}
+
+OfflineRenderer::Result OfflineRenderer::render(const QString& fileName,
+        const Encoder::Format& format,
+        SINT numFrames) {
+    Result result;
+
+    EncoderPointer pEncoder = EncoderFactory::getFactory().createRecordingEncoder(
+            format, m_pConfig, this);
+    if (!pEncoder) {
+        result.errorMessage = QStringLiteral("No encoder available for %1").arg(format.label);
+        return result;
+    }
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::WriteOnly)) {
+        result.errorMessage = m_file.errorString();
+        return result;
+    }
+    m_dataStream.setDevice(&m_file);
+    if (pEncoder->initEncoder(m_sampleRate, &result.errorMessage) < 0) {
+        pEncoder.reset();
+        m_dataStream.setDevice(nullptr);
+        m_file.close();
+        // Don't leave an empty file behind
+        m_file.remove();
+        return result;
+    }
+
+    // We are the clock of the engine now
+    ControlObject::set(ConfigKey(kAppGroup, QStringLiteral("samplerate")),
+            m_sampleRate.toDouble());
+    m_pEngineMixer->onOutputConnected(AudioOutput(AudioPathType::Main,
+            0,
+            mixxx::audio::ChannelCount::stereo()));
+    m_pEngineMixer->setSynchronousReads(true);
+    m_nextEvent = 0;
+
+    PerformanceTimer timer;
+    timer.start();
+    SINT framePos = 0;
+    while (framePos < numFrames) {
+        const SINT frames = math_min(m_framesPerBuffer, numFrames - framePos);
+        applyAutomation(framePos + frames);
+        const std::size_t samples = frames * mixxx::kEngineChannelOutputCount;
+        m_pEngineMixer->process(samples);
+        pEncoder->encodeBuffer(m_pEngineMixer->getMainBuffer().data(), samples);
+        framePos += frames;
+    }
+    pEncoder->flush();
+    // Deleting the encoder finalizes the header of WAV, AIFF and FLAC
+    // files through the callbacks, so the file must still be open.
+    pEncoder.reset();
+    result.renderTime = timer.elapsed();
+    result.frames = framePos;
+    result.success = true;
+
+    m_pEngineMixer->setSynchronousReads(false);
+    m_dataStream.setDevice(nullptr);
+    m_file.close();
+
+    const double realtimeFactor = result.realtimeFactor(m_sampleRate);
+    Stat::track(QStringLiteral("OfflineRenderer realtime factor"),
+            Stat::UNSPECIFIED,
+            Stat::experimentFlags(Stat::COUNT | Stat::AVERAGE | Stat::MIN | Stat::MAX),
+            realtimeFactor);
+    kLogger.info()
+            << "Rendered" << result.frames << "frames to" << fileName
+            << "in" << result.renderTime.formatMillisWithUnit()
+            << "realtime factor" << realtimeFactor;
+    return result;
+}
+
+void OfflineRenderer::write(const unsigned char* header,
+        const unsigned char* body,
+        int headerLen,
+        int bodyLen) {
+    if (!m_file.isOpen()) {
+        return;
+    }
+    // Relevant for OGG
+    if (headerLen > 0) {
+        m_dataStream.writeRawData(reinterpret_cast<const char*>(header), headerLen);
+    }
+    m_dataStream.writeRawData(reinterpret_cast<const char*>(body), bodyLen);
+}
+
+int OfflineRenderer::tell() {
+    if (!m_file.isOpen()) {
+        return -1;
+    }
+    return static_cast<int>(m_file.pos());
+}
+
+void OfflineRenderer::seek(int pos) {
+    if (!m_file.isOpen()) {
+        return;
+    }
+    m_file.seek(static_cast<qint64>(pos));
+}
+
+int OfflineRenderer::filelen() {
+    if (!m_file.isOpen()) {
+        return 0;
+    }
+    return static_cast<int>(m_file.size());
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QDataStream>
+#include <QFile>
+#include <QList>
+#include <QString>
+#include <optional>
+
+#include "audio/types.h"
+#include "encoder/encoder.h"
+#include "encoder/encodercallback.h"
+#include "preferences/usersettings.h"
+#include "util/duration.h"
+#include "util/types.h"
+
+class EngineMixer;
+class QIODevice;
+
+/// A control change of a recorded automation script. It is applied right
+/// before rendering the buffer that contains framePos.
+struct OfflineRenderEvent {
+    SINT framePos;
+    ConfigKey key;
+    double value;
+};
+
+/// Renders the main mix of an EngineMixer into a file as fast as the CPU
+/// allows, e.g. for QA and archiving of long sets.
+///
+/// Instead of being paced by a sound device, the engine is driven in a tight
+/// loop from the calling thread. Control changes are replayed from an
+/// automation script at their frame position and chunk reads are
+/// synchronous, so the output only depends on the loaded tracks and the
+/// script. The main output is encoded with the regular recording encoders.
+class OfflineRenderer : public EncoderCallback {
+  public:
+    struct Result {
+        bool success = false;
+        QString errorMessage;
+        SINT frames = 0;
+        mixxx::Duration renderTime;
+
+        /// The rendered audio duration divided by the time it took to
+        /// render it. Values above 1 are faster than realtime.
+        double realtimeFactor(mixxx::audio::SampleRate sampleRate) const;
+    };
+
+    OfflineRenderer(UserSettingsPointer pConfig,
+            EngineMixer* pEngineMixer,
+            mixxx::audio::SampleRate sampleRate,
+            SINT framesPerBuffer);
+    ~OfflineRenderer() override;
+
+    /// Parses an automation script with one control change per line:
+    /// the time in seconds, the group, the item and the value separated by
+    /// whitespace, e.g. "12.5 [Channel1] play 1". Empty lines and lines
+    /// starting with # are ignored. The events are sorted by time. When
+    /// rendering from the command line, the last event marks the end.
+    static std::optional<QList<OfflineRenderEvent>> parseAutomationScript(
+            QIODevice* pDevice,
+            mixxx::audio::SampleRate sampleRate,
+            QString* pErrorMessage);
+
+    void setAutomation(QList<OfflineRenderEvent> events);
+
+    /// Renders numFrames frames of the main mix into fileName. The tracks
+    /// must already be loaded into the decks.
+    Result render(const QString& fileName,
+            const Encoder::Format& format,
+            SINT numFrames);
+
+    void write(const unsigned char* header,
+            const unsigned char* body,
+            int headerLen,
+            int bodyLen) override;
+    int tell() override;
+    void seek(int pos) override;
+    int filelen() override;
+
+  private:
+    void applyAutomation(SINT endFramePos);
+
+    const UserSettingsPointer m_pConfig;
+    EngineMixer* const m_pEngineMixer;
+    const mixxx::audio::SampleRate m_sampleRate;
+    const SINT m_framesPerBuffer;
+
+    QList<OfflineRenderEvent> m_events;
+    int m_nextEvent;
+
+    QFile m_file;
+    QDataStream m_dataStream;
+};
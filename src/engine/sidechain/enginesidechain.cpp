@@ -4,14 +4,18 @@
 // to increase the amount of time the CPU has to do whatever work needs to
 // be done, and that work is executed in a separate thread. (Threading
 // allows the next buffer to be filled while processing a buffer that's is
-// already full.)
+// already full.) The samples are fanned out to one thread per worker, so
+// multiple encoders run in parallel. The samples are written once into a
+// buffer shared by all workers, each worker reads them in place.
 
 #include "engine/sidechain/enginesidechain.h"
 
 #include <QtDebug>
+#include <algorithm>
 
 #include "engine/engine.h"
 #include "engine/sidechain/sidechainworker.h"
+#include "engine/sidechain/sidechainworkerthread.h"
 #include "moc_enginesidechain.cpp"
 #include "util/counter.h"
 #include "util/event.h"
@@ -25,9 +29,9 @@ EngineSideChain::EngineSideChain(
         CSAMPLE* sidechainMix)
         : m_pConfig(pConfig),
           m_bStopThread(false),
-          m_sampleFifo(SIDECHAIN_BUFFER_SIZE),
-          m_pWorkBuffer(SampleUtil::alloc(SIDECHAIN_BUFFER_SIZE)),
-          m_pSidechainMix(sidechainMix) {
+          m_sampleBuffer(SIDECHAIN_BUFFER_SIZE, kMaxWorkers),
+          m_pSidechainMix(sidechainMix),
+          m_numWorkersAdded(0) {
     // We use HighPriority to prevent starvation by lower-priority processes (Qt
     // main thread, analysis, etc.). This used to be LowPriority but that is not
     // a suitable choice since we do semi-realtime tasks
@@ -48,18 +52,43 @@ EngineSideChain::~EngineSideChain() {
 
     MMutexLocker locker(&m_workerLock);
     while (!m_workers.empty()) {
-        SideChainWorker* pWorker = m_workers.takeLast();
+        SideChainWorker* pWorker = m_workers.back()->worker();
+        // Stop the thread before shutting down the worker
+        m_workers.pop_back();
         pWorker->shutdown();
         delete pWorker;
     }
     locker.unlock();
+}
 
-    SampleUtil::free(m_pWorkBuffer);
+bool EngineSideChain::addSideChainWorker(SideChainWorker* pWorker) {
+    MMutexLocker locker(&m_workerLock);
+    VERIFY_OR_DEBUG_ASSERT(m_workers.size() < kMaxWorkers) {
+        qWarning() << "EngineSideChain: Too many workers, ignoring new worker";
+        delete pWorker;
+        return false;
+    }
+    m_workers.push_back(std::make_unique<SideChainWorkerThread>(pWorker,
+            QStringLiteral("EngineSideChain worker %1").arg(++m_numWorkersAdded),
+            &m_sampleBuffer));
+    return true;
 }
 
-void EngineSideChain::addSideChainWorker(SideChainWorker* pWorker) {
+void EngineSideChain::removeSideChainWorker(SideChainWorker* pWorker) {
     MMutexLocker locker(&m_workerLock);
-    m_workers.append(pWorker);
+    const auto it = std::find_if(m_workers.begin(),
+            m_workers.end(),
+            [pWorker](const auto& pWorkerThread) {
+                return pWorkerThread->worker() == pWorker;
+            });
+    VERIFY_OR_DEBUG_ASSERT(it != m_workers.end()) {
+        return;
+    }
+    // Stop the thread before shutting down the worker
+    m_workers.erase(it);
+    locker.unlock();
+    pWorker->shutdown();
+    delete pWorker;
 }
 
 void EngineSideChain::receiveBuffer(const AudioInput& input,
@@ -78,13 +107,13 @@ void EngineSideChain::writeSamples(const CSAMPLE* pBuffer, int iFrames) {
     Trace sidechain("EngineSideChain::writeSamples");
     // TODO: remove assumption of stereo buffer
     const int numSamples = iFrames * mixxx::kEngineChannelOutputCount;
-    const int numSamplesWritten = m_sampleFifo.write(pBuffer, numSamples);
+    const int numSamplesWritten = m_sampleBuffer.write(pBuffer, numSamples);
 
     if (numSamplesWritten != numSamples) {
         Counter("EngineSideChain::writeSamples buffer overrun").increment();
     }
 
-    if (m_sampleFifo.writeAvailable() < SIDECHAIN_BUFFER_SIZE / 5) {
+    if (m_sampleBuffer.writeAvailable() < SIDECHAIN_BUFFER_SIZE / 5) {
         // Signal to the sidechain that samples are available.
         Trace wakeup("EngineSideChain::writeSamples wake up");
         m_waitForSamples.wakeAll();
@@ -107,13 +136,11 @@ void EngineSideChain::run() {
         m_waitLock.unlock();
         Event::start(tag);
 
-        int samples_read;
-        while ((samples_read = m_sampleFifo.read(m_pWorkBuffer,
-                                                 SIDECHAIN_BUFFER_SIZE))) {
+        {
             Trace process("EngineSideChain::process");
             MMutexLocker locker(&m_workerLock);
-            foreach (SideChainWorker* pWorker, m_workers) {
-                pWorker->process(m_pWorkBuffer, samples_read);
+            for (const auto& pWorkerThread : m_workers) {
+                pWorkerThread->samplesAvailable();
             }
         }
 
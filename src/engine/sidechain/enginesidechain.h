@@ -4,14 +4,17 @@
 #include <QMutex>
 #include <QWaitCondition>
 #include <QList>
+#include <memory>
+#include <vector>
 
 #include "preferences/usersettings.h"
 #include "soundio/soundmanagerutil.h"
-#include "util/fifo.h"
+#include "util/multireaderringbuffer.h"
 #include "util/mutex.h"
 #include "util/types.h"
 
 class SideChainWorker;
+class SideChainWorkerThread;
 
 class EngineSideChain : public QThread, public AudioDestination {
     Q_OBJECT
@@ -30,10 +33,17 @@ class EngineSideChain : public QThread, public AudioDestination {
             const CSAMPLE* pBuffer,
             unsigned int iFrames) override;
 
-    // Thread-safe, blocking.
-    void addSideChainWorker(SideChainWorker* pWorker);
+    // Thread-safe, blocking. Each worker is processed on its own thread.
+    // Takes ownership of pWorker. Returns false if there are too many workers
+    // already, then pWorker has been deleted.
+    bool addSideChainWorker(SideChainWorker* pWorker);
+
+    // Thread-safe, blocking. Stops the thread of pWorker, then shuts it down
+    // and deletes it. Must not be called from the thread of pWorker.
+    void removeSideChainWorker(SideChainWorker* pWorker);
 
     static constexpr int SIDECHAIN_BUFFER_SIZE = 65536;
+    static constexpr int kMaxWorkers = 16;
 
   private:
     void run() override;
@@ -42,8 +52,9 @@ class EngineSideChain : public QThread, public AudioDestination {
     // Indicates that the thread should exit.
     volatile bool m_bStopThread;
 
-    FIFO<CSAMPLE> m_sampleFifo;
-    CSAMPLE* m_pWorkBuffer;
+    // Written once by the engine, read in place by every worker at its own
+    // read cursor.
+    MultiReaderRingBuffer<CSAMPLE> m_sampleBuffer;
     CSAMPLE* m_pSidechainMix;
 
     // Provides thread safety around the wait condition below.
@@ -51,7 +62,10 @@ class EngineSideChain : public QThread, public AudioDestination {
     // Allows sleeping until we have samples to process.
     QWaitCondition m_waitForSamples;
 
-    // Sidechain workers registered with EngineSideChain.
+    // Sidechain workers registered with EngineSideChain, each wrapped in the
+    // thread that feeds it.
     MMutex m_workerLock;
-    QList<SideChainWorker*> m_workers GUARDED_BY(m_workerLock);
+    std::vector<std::unique_ptr<SideChainWorkerThread>> m_workers GUARDED_BY(m_workerLock);
+    // Numbers the worker threads, they are not renumbered when one is removed.
+    int m_numWorkersAdded GUARDED_BY(m_workerLock);
 };
@@ -0,0 +1,226 @@
+#include "engine/sidechain/sharedbroadcastencoder.h"
+
+#include <QHash>
+#include <QObject>
+
+#include "engine/sidechain/enginesidechain.h"
+#include "engine/sidechain/sidechainworker.h"
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/counter.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("SharedBroadcastEncoder");
+
+// Limit for the encoded data queued for a member, which doesn't send them.
+// Same as ShoutConnection's network cache limit: 10 s mp3 @ 192 kbit/s
+constexpr int kMaxQueuedBytes = 491520;
+
+// All shared encoders currently in use, by their settings.
+QMutex s_registryMutex;
+QHash<QString, std::weak_ptr<SharedBroadcastEncoder>> s_registry;
+
+QString settingsKey(const EncoderSettingsPointer& pSettings,
+        mixxx::audio::SampleRate sampleRate) {
+    return QStringLiteral("%1 %2 %3 %4")
+            .arg(pSettings->getFormat(),
+                    QString::number(pSettings->getQuality()),
+                    QString::number(static_cast<int>(pSettings->getChannelMode())),
+                    QString::number(sampleRate.value()));
+}
+
+} // namespace
+
+// Feeds the samples of the sidechain into the encoder on the worker thread.
+// Owned by the EngineSideChain, but removed by the encoder before it is
+// deleted.
+class SharedBroadcastEncoder::Worker : public SideChainWorker {
+  public:
+    explicit Worker(SharedBroadcastEncoder* pEncoder)
+            : m_pEncoder(pEncoder) {
+    }
+
+    void process(const CSAMPLE* pBuffer, const std::size_t bufferSize) override {
+        m_pEncoder->encodeBuffer(pBuffer, bufferSize);
+    }
+
+    void shutdown() override {
+    }
+
+  private:
+    SharedBroadcastEncoder* const m_pEncoder;
+};
+
+// static
+std::shared_ptr<SharedBroadcastEncoder> SharedBroadcastEncoder::acquire(
+        const EncoderSettingsPointer& pSettings,
+        mixxx::audio::SampleRate sampleRate,
+        EngineSideChain* pSideChain,
+        QString* pUserErrorMessage) {
+    VERIFY_OR_DEBUG_ASSERT(pSideChain) {
+        return nullptr;
+    }
+    const QString key = settingsKey(pSettings, sampleRate);
+    // Declared before the lock, so an encoder that failed to initialize is
+    // deleted after the lock has been released. Its destructor locks the
+    // registry, too.
+    std::shared_ptr<SharedBroadcastEncoder> pShared;
+    auto registryLock = lockMutex(&s_registryMutex);
+    pShared = s_registry.value(key).lock();
+    if (pShared) {
+        kLogger.debug() << "Sharing encoder" << key;
+        return pShared;
+    }
+
+    // Can't use std::make_shared with the private constructor
+    pShared = std::shared_ptr<SharedBroadcastEncoder>(new SharedBroadcastEncoder(key));
+    pShared->m_pEncoder = EncoderFactory::getFactory().createEncoder(
+            pSettings, pShared.get());
+    if (!pShared->m_pEncoder ||
+            pShared->m_pEncoder->initEncoder(sampleRate, pUserErrorMessage) < 0) {
+        kLogger.warning() << "Failed to initialize encoder" << key;
+        return nullptr;
+    }
+    // The worker starts encoding as soon as a member becomes active
+    pShared->m_pSideChain = pSideChain;
+    pShared->m_pWorker = new Worker(pShared.get());
+    if (!pSideChain->addSideChainWorker(pShared->m_pWorker)) {
+        // Already deleted by the sidechain
+        pShared->m_pWorker = nullptr;
+        kLogger.warning() << "Failed to add sidechain worker for encoder" << key;
+        if (pUserErrorMessage) {
+            *pUserErrorMessage = QObject::tr("Too many encoders are running.");
+        }
+        return nullptr;
+    }
+    s_registry.insert(key, pShared);
+    pShared->m_registered = true;
+    return pShared;
+}
+
+SharedBroadcastEncoder::SharedBroadcastEncoder(QString key)
+        : m_key(std::move(key)),
+          m_registered(false),
+          m_pSideChain(nullptr),
+          m_pWorker(nullptr),
+          m_nextMemberId(0),
+          m_numActiveMembers(0) {
+}
+
+SharedBroadcastEncoder::~SharedBroadcastEncoder() {
+    // Stop encoding before the encoder is deleted
+    if (m_pWorker) {
+        m_pSideChain->removeSideChainWorker(m_pWorker);
+        m_pWorker = nullptr;
+    }
+    // Deleting the encoder calls write(), no member is left to receive it
+    m_pEncoder.reset();
+
+    if (!m_registered) {
+        return;
+    }
+    auto registryLock = lockMutex(&s_registryMutex);
+    // Only remove our own entry, it might have been replaced already by a
+    // new encoder with the same settings, after the last reference to this
+    // one was dropped.
+    auto it = s_registry.find(m_key);
+    if (it != s_registry.end() && it.value().expired()) {
+        s_registry.erase(it);
+    }
+}
+
+SharedBroadcastEncoder::MemberId SharedBroadcastEncoder::addMember() {
+    auto lock = lockMutex(&m_mutex);
+    const MemberId memberId = m_nextMemberId++;
+    m_members.push_back(Member{memberId, false, QByteArray()});
+    return memberId;
+}
+
+void SharedBroadcastEncoder::removeMember(MemberId memberId) {
+    auto lock = lockMutex(&m_mutex);
+    std::erase_if(m_members, [this, memberId](const Member& member) {
+        if (member.id != memberId) {
+            return false;
+        }
+        if (member.active) {
+            --m_numActiveMembers;
+        }
+        return true;
+    });
+}
+
+void SharedBroadcastEncoder::setMemberActive(MemberId memberId, bool active) {
+    auto lock = lockMutex(&m_mutex);
+    Member* pMember = findMember(memberId);
+    VERIFY_OR_DEBUG_ASSERT(pMember) {
+        return;
+    }
+    if (pMember->active != active) {
+        pMember->active = active;
+        m_numActiveMembers += active ? 1 : -1;
+    }
+    // Don't hand out data encoded before the member became active
+    pMember->encodedData.clear();
+}
+
+int SharedBroadcastEncoder::numMembers() const {
+    auto lock = lockMutex(&m_mutex);
+    return static_cast<int>(m_members.size());
+}
+
+void SharedBroadcastEncoder::encodeBuffer(
+        const CSAMPLE* pBuffer, std::size_t bufferSize) {
+    {
+        auto lock = lockMutex(&m_mutex);
+        if (m_numActiveMembers == 0) {
+            return;
+        }
+    }
+    // Only called from the worker thread, so the encoder is never used
+    // concurrently. The encoded frames are received by the write() callback.
+    m_pEncoder->encodeBuffer(pBuffer, bufferSize);
+}
+
+QByteArray SharedBroadcastEncoder::takeEncodedData(MemberId memberId) {
+    auto lock = lockMutex(&m_mutex);
+    Member* pMember = findMember(memberId);
+    VERIFY_OR_DEBUG_ASSERT(pMember) {
+        return {};
+    }
+    QByteArray encodedData;
+    encodedData.swap(pMember->encodedData);
+    return encodedData;
+}
+
+void SharedBroadcastEncoder::write(const unsigned char* header,
+        const unsigned char* body,
+        int headerLen,
+        int bodyLen) {
+    auto lock = lockMutex(&m_mutex);
+    for (auto& member : m_members) {
+        if (!member.active) {
+            continue;
+        }
+        if (member.encodedData.size() + headerLen + bodyLen > kMaxQueuedBytes) {
+            // The member doesn't keep up sending, e.g. because of a slow
+            // network. Drop the backlog instead of growing without limit.
+            Counter(QStringLiteral("SharedBroadcastEncoder queue overflow")).increment();
+            member.encodedData.clear();
+        }
+        if (headerLen > 0) {
+            member.encodedData.append(reinterpret_cast<const char*>(header), headerLen);
+        }
+        member.encodedData.append(reinterpret_cast<const char*>(body), bodyLen);
+    }
+}
+
+SharedBroadcastEncoder::Member* SharedBroadcastEncoder::findMember(MemberId memberId) {
+    for (auto& member : m_members) {
+        if (member.id == memberId) {
+            return &member;
+        }
+    }
+    return nullptr;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <QByteArray>
+#include <QMutex>
+#include <QString>
+#include <memory>
+#include <vector>
+
+#include "audio/types.h"
+#include "encoder/encoder.h"
+#include "encoder/encodercallback.h"
+#include "util/types.h"
+
+class EngineSideChain;
+
+/// An encoder shared by all broadcast connections with identical encoder
+/// settings, so the main mix is encoded only once for all of them.
+///
+/// The encoder runs on its own EngineSideChain worker thread and reads the
+/// samples from the sidechain buffer, independent of the connections.
+/// The encoded data are queued for every active member, and each member sends
+/// them from its own thread. A member that doesn't keep up sending only drops
+/// its own queued data. This is only suitable for self-synchronizing formats
+/// like MP3 and AAC, where a member can join an already running stream and
+/// metadata is sent out of band.
+class SharedBroadcastEncoder : public EncoderCallback {
+  public:
+    using MemberId = int;
+
+    /// Returns the shared encoder for `pSettings` and `sampleRate`, creating
+    /// and initializing it if no connection uses these settings yet. A new
+    /// encoder is registered as worker of `pSideChain`, which must outlive it.
+    /// Returns nullptr if the encoder fails to initialize.
+    static std::shared_ptr<SharedBroadcastEncoder> acquire(
+            const EncoderSettingsPointer& pSettings,
+            mixxx::audio::SampleRate sampleRate,
+            EngineSideChain* pSideChain,
+            QString* pUserErrorMessage);
+
+    ~SharedBroadcastEncoder() override;
+
+    /// Adds a new, not yet active member.
+    MemberId addMember();
+    void removeMember(MemberId memberId);
+    /// Only active members receive encoded data. Nothing is encoded while
+    /// no member is active.
+    void setMemberActive(MemberId memberId, bool active);
+
+    /// Returns and clears the encoded data queued for `memberId`.
+    QByteArray takeEncodedData(MemberId memberId);
+
+    int numMembers() const;
+
+    // EncoderCallback, called by the encoder while encoding.
+    void write(const unsigned char* header,
+            const unsigned char* body,
+            int headerLen,
+            int bodyLen) override;
+    int tell() override {
+        return -1;
+    }
+    void seek(int pos) override {
+        Q_UNUSED(pos);
+    }
+    int filelen() override {
+        return 0;
+    }
+
+  private:
+    class Worker;
+
+    struct Member {
+        MemberId id;
+        bool active;
+        QByteArray encodedData;
+    };
+
+    SharedBroadcastEncoder(QString key);
+
+    /// Called on the worker thread with the samples of the sidechain.
+    void encodeBuffer(const CSAMPLE* pBuffer, std::size_t bufferSize);
+
+    Member* findMember(MemberId memberId);
+
+    const QString m_key;
+    EncoderPointer m_pEncoder;
+    // Only encoders that initialized successfully are registered
+    bool m_registered;
+
+    // Owned by m_pSideChain, removed before the encoder is deleted.
+    EngineSideChain* m_pSideChain;
+    Worker* m_pWorker;
+
+    // Protects all members below
+    mutable QMutex m_mutex;
+    std::vector<Member> m_members;
+    MemberId m_nextMemberId;
+    int m_numActiveMembers;
+};
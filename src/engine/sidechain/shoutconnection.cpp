@@ -26,6 +26,8 @@
 #include "track/track.h"
 #include "util/compatibility/qatomic.h"
 #include "util/logger.h"
+#include "util/stat.h"
+#include "util/timer.h"
 
 namespace {
 
@@ -43,7 +45,8 @@ const mixxx::Logger kLogger("ShoutConnection");
 } // namespace
 
 ShoutConnection::ShoutConnection(BroadcastProfilePtr profile,
-        UserSettingsPointer pConfig)
+        UserSettingsPointer pConfig,
+        EngineSideChain* pSideChain)
         : m_pTextCodec(nullptr),
           m_pMetaData(),
           m_pShout(nullptr),
@@ -54,6 +57,8 @@ ShoutConnection::ShoutConnection(BroadcastProfilePtr profile,
           m_pConfig(pConfig),
           m_pProfile(profile),
           m_encoder(nullptr),
+          m_pSideChain(pSideChain),
+          m_sharedEncoderMemberId(0),
           m_mainSamplerate(QStringLiteral("[App]"), QStringLiteral("samplerate")),
           m_broadcastEnabled(BROADCAST_PREF_KEY, "enabled"),
           m_custom_metadata(false),
@@ -187,6 +192,7 @@ void ShoutConnection::updateFromPreferences() {
     // delete m_encoder calls write() check if it will be exit early
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
     m_encoder.reset();
+    releaseSharedEncoder();
 
     m_format_is_mp3 = false;
     m_format_is_ov = false;
@@ -453,13 +459,27 @@ void ShoutConnection::updateFromPreferences() {
     // Initialize m_encoder
     EncoderSettingsPointer pBroadcastSettings =
             std::make_shared<EncoderBroadcastSettings>(m_pProfile);
-    m_encoder = EncoderFactory::getFactory().createEncoder(
-                    pBroadcastSettings, this);
-
     QString userErrorMsg;
     int ret = -1;
-    if (m_encoder) {
-        ret = m_encoder->initEncoder(mainSamplerate, &userErrorMsg);
+    // Leave the encoder of a previous connection attempt first, otherwise
+    // it would keep this connection as an active member.
+    releaseSharedEncoder();
+    if ((m_format_is_mp3 || m_format_is_aac) && m_pSideChain) {
+        // MP3 and AAC streams can be joined at any frame and don't carry the
+        // metadata in the stream, so the encoded data can be shared with all
+        // connections using the same settings.
+        m_pSharedEncoder = SharedBroadcastEncoder::acquire(
+                pBroadcastSettings, mainSamplerate, m_pSideChain, &userErrorMsg);
+        if (m_pSharedEncoder) {
+            m_sharedEncoderMemberId = m_pSharedEncoder->addMember();
+            ret = 0;
+        }
+    } else {
+        m_encoder = EncoderFactory::getFactory().createEncoder(
+                pBroadcastSettings, this);
+        if (m_encoder) {
+            ret = m_encoder->initEncoder(mainSamplerate, &userErrorMsg);
+        }
     }
 
     // TODO(XXX): Use mixxx::audio::SampleRate instead of int in initEncoder
@@ -467,6 +487,7 @@ void ShoutConnection::updateFromPreferences() {
         // delete m_encoder calls write() make sure it will be exit early
         DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
         m_encoder.reset();
+        releaseSharedEncoder();
 
         setState(NETWORKSTREAMWORKER_STATE_ERROR);
 
@@ -499,7 +520,7 @@ bool ShoutConnection::processConnect() {
     // Make sure that we call updateFromPreferences always
     updateFromPreferences();
 
-    if (!m_encoder) {
+    if (!m_encoder && !m_pSharedEncoder) {
         // updateFromPreferences failed
         setStatus(BroadcastProfile::STATUS_FAILURE);
         kLogger.warning() << "ShoutOutput::processConnect() returning false";
@@ -597,6 +618,10 @@ bool ShoutConnection::processConnect() {
             }
             m_threadWaiting = true;
 
+            if (m_pSharedEncoder) {
+                m_pSharedEncoder->setMemberActive(m_sharedEncoderMemberId, true);
+            }
+
             setStatus(BroadcastProfile::STATUS_CONNECTED);
             emit broadcastConnected();
 
@@ -626,6 +651,7 @@ bool ShoutConnection::processConnect() {
     // delete m_encoder calls write() check if it will be exit early
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
     m_encoder.reset();
+    releaseSharedEncoder();
     if (m_pProfile->getEnabled()) {
         setStatus(BroadcastProfile::STATUS_FAILURE);
     } else {
@@ -651,9 +677,18 @@ bool ShoutConnection::processDisconnect() {
     // delete m_encoder calls write() check if it will be exit early
     DEBUG_ASSERT(m_iShoutStatus != SHOUTERR_CONNECTED);
     m_encoder.reset();
+    releaseSharedEncoder();
     return disconnected;
 }
 
+void ShoutConnection::releaseSharedEncoder() {
+    if (!m_pSharedEncoder) {
+        return;
+    }
+    m_pSharedEncoder->removeMember(m_sharedEncoderMemberId);
+    m_pSharedEncoder.reset();
+}
+
 void ShoutConnection::write(const unsigned char* header, const unsigned char* body,
                             int headerLen, int bodyLen) {
     setFunctionCode(7);
@@ -742,9 +777,22 @@ void ShoutConnection::process(const CSAMPLE* pBuffer, const std::size_t bufferSi
     // to prevent race conditions when resetting the member
     // pointer while disconnecting in the worker thread!
     const EncoderPointer pEncoder = m_encoder;
+    const std::shared_ptr<SharedBroadcastEncoder> pSharedEncoder = m_pSharedEncoder;
 
     // If we are connected, encode the samples.
-    if (bufferSize > 0 && pEncoder) {
+    if (pSharedEncoder) {
+        setFunctionCode(6);
+        // The shared encoder encodes the sidechain on its own thread, so the
+        // samples are not used. Only send what has been queued for us.
+        const QByteArray encodedData =
+                pSharedEncoder->takeEncodedData(m_sharedEncoderMemberId);
+        if (!encodedData.isEmpty()) {
+            write(nullptr,
+                    reinterpret_cast<const unsigned char*>(encodedData.constData()),
+                    0,
+                    static_cast<int>(encodedData.size()));
+        }
+    } else if (bufferSize > 0 && pEncoder) {
         setFunctionCode(6);
         pEncoder->encodeBuffer(pBuffer, bufferSize);
         // the encoded frames are received by the write() callback.
@@ -1017,6 +1065,8 @@ void ShoutConnection::run() {
 
     setStatus(BroadcastProfile::STATUS_CONNECTED);
 
+    const QString fillLevelStatKey = QStringLiteral("ShoutOutput '%1' buffer fill level")
+                                             .arg(m_pProfile->getProfileName());
     while(true) {
         // Stop the thread if broadcasting is turned off
         if (!m_pProfile->getEnabled() || !m_broadcastEnabled.toBool() ||
@@ -1038,8 +1088,14 @@ void ShoutConnection::run() {
         }
 
         int readAvailable = m_pOutputFifo->readAvailable();
+        Stat::track(fillLevelStatKey,
+                Stat::UNSPECIFIED,
+                Stat::experimentFlags(Stat::COUNT | Stat::AVERAGE | Stat::MIN | Stat::MAX),
+                readAvailable);
         if (readAvailable) {
             setFunctionCode(3);
+            ScopedTimer t(QStringLiteral("ShoutOutput '%1' process"),
+                    m_pProfile->getProfileName());
             CSAMPLE* dataPtr1;
             ring_buffer_size_t size1;
             CSAMPLE* dataPtr2;
@@ -12,6 +12,7 @@
 #include "control/pollingcontrolproxy.h"
 #include "encoder/encoder.h"
 #include "encoder/encodercallback.h"
+#include "engine/sidechain/sharedbroadcastencoder.h"
 #include "preferences/broadcastprofile.h"
 #include "preferences/usersettings.h"
 #include "track/track_decl.h"
@@ -22,13 +23,16 @@
 typedef struct shout shout_t;
 typedef struct _util_dict shout_metadata_t;
 
+class EngineSideChain;
 class QTextCodec;
 
 class ShoutConnection
         : public QThread, public EncoderCallback, public NetworkOutputStreamWorker {
     Q_OBJECT
   public:
-    ShoutConnection(BroadcastProfilePtr profile, UserSettingsPointer pConfig);
+    ShoutConnection(BroadcastProfilePtr profile,
+            UserSettingsPointer pConfig,
+            EngineSideChain* pSideChain);
     ~ShoutConnection() override;
 
     // This is called by the Engine implementation for each sample. Encode and
@@ -107,6 +111,9 @@ class ShoutConnection
 
     bool waitForRetry();
 
+    // Leaves the shared encoder, if one is used.
+    void releaseSharedEncoder();
+
     void tryReconnect();
     void insertMetaData(const char *name, const char *value);
 
@@ -120,6 +127,12 @@ class ShoutConnection
     UserSettingsPointer m_pConfig;
     BroadcastProfilePtr m_pProfile;
     EncoderPointer m_encoder;
+    // Runs the shared encoders, nullptr if the engine has no sidechain.
+    EngineSideChain* m_pSideChain;
+    // Used instead of m_encoder for formats that allow sharing the encoder
+    // with other connections using the same encoder settings.
+    std::shared_ptr<SharedBroadcastEncoder> m_pSharedEncoder;
+    SharedBroadcastEncoder::MemberId m_sharedEncoderMemberId;
     PollingControlProxy m_mainSamplerate;
     PollingControlProxy m_broadcastEnabled;
     // static metadata according to prefereneces
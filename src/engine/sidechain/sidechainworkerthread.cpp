@@ -0,0 +1,102 @@
+#include "engine/sidechain/sidechainworkerthread.h"
+
+#include <algorithm>
+
+#include "engine/sidechain/sidechainworker.h"
+#include "util/counter.h"
+#include "util/stat.h"
+#include "util/timer.h"
+#include "util/trace.h"
+
+namespace {
+
+// The engine drops the samples that would overwrite acquired samples, so a
+// slow worker only holds a part of the shared buffer at a time.
+constexpr int kMaxAcquiredBufferFraction = 4;
+
+} // anonymous namespace
+
+SideChainWorkerThread::SideChainWorkerThread(SideChainWorker* pWorker,
+        const QString& name,
+        MultiReaderRingBuffer<CSAMPLE>* pSampleBuffer)
+        : m_pWorker(pWorker),
+          m_name(name),
+          m_overflowCounterKey(QStringLiteral("%1 buffer overrun").arg(name)),
+          m_fillLevelStatKey(QStringLiteral("%1 buffer fill level").arg(name)),
+          m_bStopThread(false),
+          m_pSampleBuffer(pSampleBuffer),
+          m_readerId(pSampleBuffer->addReader()) {
+    DEBUG_ASSERT(m_readerId >= 0);
+    // Same priority as the EngineSideChain thread, see there.
+    start(QThread::HighPriority);
+}
+
+SideChainWorkerThread::~SideChainWorkerThread() {
+    m_waitLock.lock();
+    m_bStopThread = true;
+    m_waitForSamples.wakeAll();
+    m_waitLock.unlock();
+
+    wait();
+
+    m_pSampleBuffer->removeReader(m_readerId);
+}
+
+void SideChainWorkerThread::samplesAvailable() {
+    Trace wakeup("SideChainWorkerThread::samplesAvailable wake up");
+    // Unlike the engine callback, the EngineSideChain thread is allowed to
+    // lock. This prevents missing the wake up between the check for
+    // available samples and the wait in run().
+    m_waitLock.lock();
+    m_waitForSamples.wakeAll();
+    m_waitLock.unlock();
+}
+
+void SideChainWorkerThread::run() {
+    QThread::currentThread()->setObjectName(m_name);
+    while (!m_bStopThread) {
+        m_waitLock.lock();
+        // Don't sleep if samples arrived while processing the previous ones.
+        if (!m_bStopThread && m_pSampleBuffer->readAvailable(m_readerId) == 0) {
+            m_waitForSamples.wait(&m_waitLock);
+        }
+        m_waitLock.unlock();
+
+        const std::uint64_t overflowCount = m_pSampleBuffer->takeOverflowCount(m_readerId);
+        if (overflowCount > 0) {
+            // This worker can't keep up, e.g. a slow encoder.
+            Counter(m_overflowCounterKey).increment(static_cast<int>(overflowCount));
+        }
+
+        const int readAvailable = m_pSampleBuffer->readAvailable(m_readerId);
+        Stat::track(m_fillLevelStatKey,
+                Stat::UNSPECIFIED,
+                Stat::experimentFlags(Stat::COUNT | Stat::AVERAGE | Stat::MIN | Stat::MAX),
+                readAvailable);
+        if (m_bStopThread || readAvailable == 0) {
+            continue;
+        }
+
+        // Process the samples in place, without copying them. The remaining
+        // samples are processed by the next iteration without waiting.
+        const CSAMPLE* pData1;
+        int size1;
+        const CSAMPLE* pData2;
+        int size2;
+        const int samplesRead = m_pSampleBuffer->acquireReadRegions(m_readerId,
+                std::min(readAvailable,
+                        m_pSampleBuffer->size() / kMaxAcquiredBufferFraction),
+                &pData1,
+                &size1,
+                &pData2,
+                &size2);
+        {
+            ScopedTimer t(QStringLiteral("%1 process"), m_name);
+            m_pWorker->process(pData1, size1);
+            if (size2 > 0) {
+                m_pWorker->process(pData2, size2);
+            }
+        }
+        m_pSampleBuffer->releaseReadRegions(m_readerId, samplesRead);
+    }
+}
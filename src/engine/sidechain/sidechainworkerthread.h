@@ -0,0 +1,52 @@
+#pragma once
+
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "util/multireaderringbuffer.h"
+#include "util/types.h"
+
+class SideChainWorker;
+
+// Runs a single SideChainWorker (e.g. the encoder of a recording) on its own
+// thread, so that multiple workers are processed in parallel instead of
+// sequentially by the EngineSideChain thread. The worker reads the samples in
+// place from the buffer shared by all workers, at its own read cursor.
+class SideChainWorkerThread : public QThread {
+  public:
+    SideChainWorkerThread(SideChainWorker* pWorker,
+            const QString& name,
+            MultiReaderRingBuffer<CSAMPLE>* pSampleBuffer);
+    // Stops the thread and waits for it. Samples not processed yet are
+    // discarded. The worker is not deleted.
+    ~SideChainWorkerThread() override;
+
+    // Wakes up the thread to process the samples available in the shared
+    // buffer. Should only be called from the EngineSideChain thread.
+    void samplesAvailable();
+
+    SideChainWorker* worker() const {
+        return m_pWorker;
+    }
+
+  private:
+    void run() override;
+
+    SideChainWorker* const m_pWorker;
+    const QString m_name;
+    const QString m_overflowCounterKey;
+    const QString m_fillLevelStatKey;
+
+    // Indicates that the thread should exit.
+    volatile bool m_bStopThread;
+
+    MultiReaderRingBuffer<CSAMPLE>* const m_pSampleBuffer;
+    const MultiReaderRingBuffer<CSAMPLE>::ReaderId m_readerId;
+
+    // Provides thread safety around the wait condition below.
+    QMutex m_waitLock;
+    // Allows sleeping until we have samples to process.
+    QWaitCondition m_waitForSamples;
+};
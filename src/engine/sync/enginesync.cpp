@@ -2,6 +2,7 @@
 
 #include <QMetaType>
 
+#include "control/controlpushbutton.h"
 #include "engine/channels/enginechannel.h"
 #include "engine/enginebuffer.h"
 #include "engine/sync/internalclock.h"
@@ -17,8 +18,11 @@ constexpr mixxx::Bpm kDefaultBpm = mixxx::Bpm(124.0);
 EngineSync::EngineSync(UserSettingsPointer pConfig)
         : m_pConfig(pConfig),
           m_pInternalClock(new InternalClock(kInternalClockGroup, this)),
-          m_pLeaderSyncable(nullptr) {
+          m_pLeaderSyncable(nullptr),
+          m_pBufferScaledCorrection(std::make_unique<ControlPushButton>(
+                  ConfigKey(kInternalClockGroup, "sync_buffer_scaled_correction"), true)) {
     qRegisterMetaType<SyncMode>("SyncMode");
+    m_pBufferScaledCorrection->setButtonMode(mixxx::control::ButtonMode::Toggle);
     m_pInternalClock->updateLeaderBpm(kDefaultBpm);
 }
 
@@ -591,6 +595,26 @@ void EngineSync::onCallbackStart(mixxx::audio::SampleRate sampleRate, std::size_
 
 void EngineSync::onCallbackEnd(mixxx::audio::SampleRate sampleRate, std::size_t bufferSize) {
     m_pInternalClock->onCallbackEnd(sampleRate, bufferSize);
+    updateLeaderCallbackAdvance(sampleRate, bufferSize);
+}
+
+void EngineSync::updateLeaderCallbackAdvance(
+        mixxx::audio::SampleRate sampleRate, std::size_t bufferSize) {
+    // The followers sync to the internal clock. Its bpm is what the
+    // followers base their rate on in the next callback.
+    if (m_pBufferScaledCorrection->toBool()) {
+        // stereo samples, so divide by 2
+        m_leaderCallbackAdvance.update(m_pInternalClock->getBpm(),
+                sampleRate,
+                static_cast<SINT>(bufferSize / 2));
+    } else {
+        m_leaderCallbackAdvance.reset();
+    }
+    // Also tell the decks that are not synchronized, so the advance is
+    // current when they enable sync.
+    for (Syncable* pSyncable : std::as_const(m_syncables)) {
+        pSyncable->updateLeaderCallbackAdvance(m_leaderCallbackAdvance);
+    }
 }
 
 EngineChannel* EngineSync::getLeaderChannel() const {
@@ -2,9 +2,13 @@
 
 #include <gtest/gtest_prod.h>
 
+#include <memory>
+
+#include "engine/sync/leadercallbackadvance.h"
 #include "engine/sync/syncable.h"
 #include "preferences/usersettings.h"
 
+class ControlPushButton;
 class InternalClock;
 class EngineChannel;
 
@@ -127,6 +131,10 @@ class EngineSync : public SyncableListener {
     /// pSource.
     void updateLeaderBeatDistance(Syncable* pSource, double beatDistance);
 
+    /// Publish the beats the internal clock, which the followers sync to,
+    /// advances per callback to every deck.
+    void updateLeaderCallbackAdvance(mixxx::audio::SampleRate sampleRate, std::size_t bufferSize);
+
     /// Initialize the leader parameters using the provided syncable as the source.
     /// This should only be called for "major" updates, like a new track or change in
     /// leader. Should not be called on every buffer callback.
@@ -167,4 +175,7 @@ class EngineSync : public SyncableListener {
     Syncable* m_pLeaderSyncable;
     /// The list of all Syncables registered via addSyncableDeck.
     QList<Syncable*> m_syncables;
+    /// Enables the buffer-scaled phase correction of the followers.
+    std::unique_ptr<ControlPushButton> m_pBufferScaledCorrection;
+    LeaderCallbackAdvance m_leaderCallbackAdvance;
 };
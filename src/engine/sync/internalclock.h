@@ -59,6 +59,10 @@ class InternalClock : public QObject, public Clock, public Syncable {
     void notifyLeaderParamSource() override;
     mixxx::Bpm getBpm() const override;
     void updateInstantaneousBpm(mixxx::Bpm bpm) override;
+    void updateLeaderCallbackAdvance(const LeaderCallbackAdvance& advance) override {
+        // The advance is derived from the clock itself
+        Q_UNUSED(advance);
+    }
     void reinitLeaderParams(double beatDistance, mixxx::Bpm baseBpm, mixxx::Bpm bpm) override;
 
     void onCallbackStart(mixxx::audio::SampleRate sampleRate, std::size_t bufferSize);
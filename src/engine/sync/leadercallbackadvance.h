@@ -0,0 +1,51 @@
+#pragma once
+
+#include "audio/types.h"
+#include "track/bpm.h"
+#include "util/types.h"
+
+/// LeaderCallbackAdvance describes how far the sync leader advances per
+/// engine callback at its current tempo.
+///
+/// EngineSync publishes it after every callback for the buffer-scaled phase
+/// correction: followers scale the correction of a phase error to the
+/// length of a callback instead of correcting a fixed fraction of the error
+/// per callback. The position of the leader is not predicted.
+class LeaderCallbackAdvance {
+  public:
+    /// Number of callbacks a follower spreads the correction of a phase error
+    /// over, at least. The linear scaler ramps the rate within a callback, so
+    /// only half of a change is applied in the callback it was requested for.
+    /// Closing at most a third of the error per callback keeps that from
+    /// overshooting.
+    static constexpr int kCorrectionCallbacks = 3;
+
+    LeaderCallbackAdvance()
+            : m_beatsPerCallback(0.0) {
+    }
+
+    void update(mixxx::Bpm bpm,
+            mixxx::audio::SampleRate sampleRate,
+            SINT callbackFrames) {
+        if (!bpm.isValid() || !sampleRate.isValid() || callbackFrames <= 0) {
+            m_beatsPerCallback = 0.0;
+            return;
+        }
+        m_beatsPerCallback = bpm.value() / 60.0 * callbackFrames / sampleRate;
+    }
+
+    void reset() {
+        m_beatsPerCallback = 0.0;
+    }
+
+    bool isValid() const {
+        return m_beatsPerCallback > 0.0;
+    }
+
+    double beatsPerCallback() const {
+        return m_beatsPerCallback;
+    }
+
+  private:
+    double m_beatsPerCallback;
+};
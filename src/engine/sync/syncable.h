@@ -6,6 +6,7 @@
 #include "audio/frame.h"
 #include "track/bpm.h"
 
+class LeaderCallbackAdvance;
 class EngineChannel;
 
 enum class SyncMode {
@@ -150,6 +151,10 @@ class Syncable {
     // SyncableListener::notifyInstantaneousBpmChanged or signal loops could
     // occur.
     virtual void updateInstantaneousBpm(mixxx::Bpm bpm) = 0;
+
+    // Update the beats the leader advances per callback. The advance is
+    // invalid if the phase correction is not scaled to the callback length.
+    virtual void updateLeaderCallbackAdvance(const LeaderCallbackAdvance& advance) = 0;
 };
 
 /// SyncableListener is an interface class used by EngineSync to receive
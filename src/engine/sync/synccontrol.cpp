@@ -7,6 +7,7 @@
 #include "engine/controls/bpmcontrol.h"
 #include "engine/enginebuffer.h"
 #include "engine/enginemixer.h"
+#include "engine/sync/leadercallbackadvance.h"
 #include "engine/sync/enginesync.h"
 #include "moc_synccontrol.cpp"
 #include "track/track.h"
@@ -359,6 +360,14 @@ void SyncControl::updateInstantaneousBpm(mixxx::Bpm bpm) {
     m_pBpmControl->updateInstantaneousBpm(bpmValue);
 }
 
+void SyncControl::updateLeaderCallbackAdvance(const LeaderCallbackAdvance& advance) {
+    // Adjust the beats per callback by the multiplier.
+    const double beatsPerCallback = advance.isValid()
+            ? advance.beatsPerCallback() * m_leaderBpmAdjustFactor
+            : 0.0;
+    m_pBpmControl->updateLeaderBeatsPerCallback(beatsPerCallback);
+}
+
 // called from an engine worker thread
 void SyncControl::trackLoaded(TrackPointer pNewTrack) {
     // Note: The track is loaded but not yet cued.
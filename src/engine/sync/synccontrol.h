@@ -73,6 +73,7 @@ class SyncControl : public EngineControl, public Syncable {
     // SyncableListener::notifyInstantaneousBpmChanged or signal loops could
     // occur.
     void updateInstantaneousBpm(mixxx::Bpm bpm) override;
+    void updateLeaderCallbackAdvance(const LeaderCallbackAdvance& advance) override;
 
     void setEngineControls(RateControl* pRateControl, BpmControl* pBpmControl);
 
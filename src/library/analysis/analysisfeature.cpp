@@ -9,6 +9,7 @@
 #include "library/library.h"
 #include "library/trackcollectionmanager.h"
 #include "moc_analysisfeature.cpp"
+#include "preferences/beatdetectionsettings.h"
 #include "sources/soundsourceproxy.h"
 #include "util/logger.h"
 #include "widget/wlibrary.h"
@@ -36,7 +37,11 @@ AnalyzerModeFlags getAnalyzerModeFlags(
     // of the existing code. We should rethink the configuration of analyzers when
     // refactoring/redesigning the analyzer framework.
     int modeFlags = AnalyzerModeFlags::WithBeats | AnalyzerModeFlags::LowPriority;
-    if (pConfig->getValue<bool>(ConfigKey("[Library]", "EnableWaveformGenerationWithAnalysis"), true)) {
+    // The fast analysis only decodes excerpts of the tracks if possible. The
+    // waveforms would need all samples and are generated when the tracks are
+    // loaded instead.
+    if (pConfig->getValue<bool>(ConfigKey("[Library]", "EnableWaveformGenerationWithAnalysis"), true) &&
+            !BeatDetectionSettings(pConfig).getFastAnalysis()) {
         modeFlags |= AnalyzerModeFlags::WithWaveform;
     }
     return static_cast<AnalyzerModeFlags>(modeFlags);
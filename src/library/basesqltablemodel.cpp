@@ -3,6 +3,7 @@
 #include <QUrl>
 #include <QtDebug>
 #include <algorithm>
+#include <numeric>
 
 #include "library/dao/trackschema.h"
 #include "library/queryutil.h"
@@ -15,11 +16,13 @@
 #include "track/track.h"
 #include "track/trackmetadata.h"
 #include "util/assert.h"
+#include "util/counter.h"
 #include "util/datetime.h"
 #include "util/db/dbconnection.h"
 #include "util/duration.h"
 #include "util/performancetimer.h"
 #include "util/platform.h"
+#include "util/stat.h"
 
 namespace {
 
@@ -36,6 +39,15 @@ const QString COLUMNS_SORTING = QStringLiteral("ColumnsSorting");
 
 const QString kModelName = "table:";
 
+// Changed tracks are moved to their sorted row up to this number of tracks,
+// otherwise the table is not re-sorted until the next select()
+constexpr int kMaxChangedTracksToMove = 16;
+
+const QString kSelectLatencyStatKey =
+        QStringLiteral("BaseSqlTableModel::selectInBackground latency");
+const QString kSelectCanceledStatKey =
+        QStringLiteral("BaseSqlTableModel::selectInBackground canceled");
+
 } // anonymous namespace
 
 BaseSqlTableModel::BaseSqlTableModel(
@@ -45,7 +57,18 @@ BaseSqlTableModel::BaseSqlTableModel(
         : BaseTrackTableModel(parent, pTrackCollectionManager, settingsNamespace),
           m_pTrackCollectionManager(pTrackCollectionManager),
           m_database(pTrackCollectionManager->internalCollection()->database()),
-          m_bInitialized(false) {
+          m_bInitialized(false),
+          m_pLatestSelectId(std::make_shared<std::atomic<quint64>>(0)),
+          m_selectPending(false) {
+    TrackTableQueryThread* pQueryThread =
+            pTrackCollectionManager->trackTableQueryThread();
+    if (pQueryThread) {
+        connect(pQueryThread,
+                &TrackTableQueryThread::queryFinished,
+                this,
+                &BaseSqlTableModel::slotQueryFinished,
+                Qt::QueuedConnection);
+    }
 }
 
 BaseSqlTableModel::~BaseSqlTableModel() {
@@ -158,22 +181,24 @@ void BaseSqlTableModel::initSortColumnMapping() {
 }
 
 void BaseSqlTableModel::clearRows() {
-    DEBUG_ASSERT(m_rowInfo.empty() == m_trackIdToRows.empty());
-    DEBUG_ASSERT(m_rowInfo.size() >= m_trackIdToRows.size());
-    if (!m_rowInfo.isEmpty()) {
-        beginRemoveRows(QModelIndex(), 0, m_rowInfo.size() - 1);
-        m_rowInfo.clear();
+    DEBUG_ASSERT(m_rowTrackIds.empty() == m_trackIdToRows.empty());
+    DEBUG_ASSERT(m_rowTrackIds.size() >= m_trackIdToRows.size());
+    if (!m_rowTrackIds.isEmpty()) {
+        beginRemoveRows(QModelIndex(), 0, m_rowTrackIds.size() - 1);
+        m_rowTrackIds.clear();
+        m_rowValues = ColumnarValues();
         m_trackIdToRows.clear();
         m_trackPosToRow.clear();
         endRemoveRows();
     }
-    DEBUG_ASSERT(m_rowInfo.isEmpty());
+    DEBUG_ASSERT(m_rowTrackIds.isEmpty());
     DEBUG_ASSERT(m_trackIdToRows.isEmpty());
     DEBUG_ASSERT(m_trackPosToRow.isEmpty());
 }
 
 void BaseSqlTableModel::replaceRows(
-        QVector<RowInfo>&& rows,
+        QVector<TrackId>&& rowTrackIds,
+        ColumnarValues&& rowValues,
         TrackId2Rows&& trackIdToRows,
         TrackPos2Row&& trackPosToRows) {
     // NOTE(uklotzde): Use r-value references for parameters here, because
@@ -183,16 +208,18 @@ void BaseSqlTableModel::replaceRows(
     // behind the scenes. Moving would be more efficient, although implicit
     // sharing meets all requirements. If Qt will ever add move support for
     // its container types in the future this code becomes even more efficient.
-    DEBUG_ASSERT(rows.empty() == trackIdToRows.empty());
-    DEBUG_ASSERT(rows.size() >= trackIdToRows.size());
+    DEBUG_ASSERT(rowTrackIds.empty() == trackIdToRows.empty());
+    DEBUG_ASSERT(rowTrackIds.size() >= trackIdToRows.size());
+    DEBUG_ASSERT(rowTrackIds.size() == rowValues.rowCount());
     if (hasPositionColumn()) {
-        DEBUG_ASSERT(rows.size() == trackPosToRows.size());
+        DEBUG_ASSERT(rowTrackIds.size() == trackPosToRows.size());
     }
-    if (rows.isEmpty()) {
+    if (rowTrackIds.isEmpty()) {
         clearRows();
     } else {
-        beginInsertRows(QModelIndex(), 0, rows.size() - 1);
-        m_rowInfo = rows;
+        beginInsertRows(QModelIndex(), 0, rowTrackIds.size() - 1);
+        m_rowTrackIds = std::move(rowTrackIds);
+        m_rowValues = std::move(rowValues);
         m_trackIdToRows = trackIdToRows;
         m_trackPosToRow = trackPosToRows;
         endInsertRows();
@@ -218,6 +245,9 @@ void BaseSqlTableModel::select() {
         qDebug() << this << "select()";
     }
 
+    // The result of a pending query in background would be outdated
+    cancelSelectInBackground();
+
     PerformanceTimer time;
     time.start();
 
@@ -242,126 +272,244 @@ void BaseSqlTableModel::select() {
         return;
     }
 
-    // Remove all the rows from the table after(!) the query has been
-    // executed successfully. See issue #6782.
-    // TODO(rryan) we could edit the table in place instead of clearing it?
-    clearRows();
-
     // The size of the result set is not known in advance for a
     // forward-only query, so we cannot reserve memory for rows
-    // in advance.
-    QVector<RowInfo> rowInfos;
-    QSet<TrackId> trackIds;
-    int idColumn = -1;
-    int posColumn = -1;
+    // in advance. Only the track ids and the values of the table
+    // columns are loaded, which are stored column by column.
+    QVector<TrackId> rowTrackIds;
+    ColumnarValues rowValues(m_tableColumns.size());
+    const QSqlRecord sqlRecord = query.record();
+    const int idColumn = sqlRecord.indexOf(m_idColumn);
+    // TODO(XXX): Can we get rid of the hard-coded assumption that
+    // the the first column always contains the id?
+    DEBUG_ASSERT(idColumn == kIdColumn);
+    VERIFY_OR_DEBUG_ASSERT(idColumn != -1) {
+        qCritical()
+                << "ID column not available in database query results:"
+                << m_idColumn;
+        return;
+    }
+    QVector<QVariant> columnValues(m_tableColumns.size());
     while (query.next()) {
-        QSqlRecord sqlRecord = query.record();
-
-        if (idColumn < 0) {
-            idColumn = sqlRecord.indexOf(m_idColumn);
-        }
-
-        if (posColumn == -1 && hasPositionColumn()) {
-            posColumn = sqlRecord.indexOf(PLAYLISTTABLE_POSITION);
-        }
-
-        // TODO(XXX): Can we get rid of the hard-coded assumption that
-        // the the first column always contains the id?
-        DEBUG_ASSERT(idColumn == kIdColumn);
-
-        VERIFY_OR_DEBUG_ASSERT(idColumn != -1) {
-            qCritical()
-                    << "ID column not available in database query results:"
-                    << m_idColumn;
-            return;
-        }
-
-        TrackId trackId(sqlRecord.value(idColumn));
-        trackIds.insert(trackId);
-
-        RowInfo rowInfo;
-        rowInfo.trackId = trackId;
-        rowInfo.row = rowInfos.size();
-
-        rowInfo.columnValues.reserve(sqlRecord.count());
         for (int i = 0; i < m_tableColumns.size(); ++i) {
-            rowInfo.columnValues.push_back(sqlRecord.value(i));
+            columnValues[i] = query.value(i);
         }
-        rowInfos.push_back(rowInfo);
+        rowTrackIds.push_back(TrackId(columnValues[idColumn]));
+        rowValues.appendRow(columnValues);
     }
 
     if (sDebug) {
-        qDebug() << "Rows actually received:" << rowInfos.size();
+        qDebug() << "Rows actually received:" << rowTrackIds.size();
     }
 
+    QHash<TrackId, int> trackSortOrder;
     if (m_trackSource) {
+        const QSet<TrackId> trackIds(rowTrackIds.constBegin(), rowTrackIds.constEnd());
         m_trackSource->filterAndSort(trackIds,
                 m_currentSearch,
                 m_currentSearchFilter,
                 m_trackSourceOrderBy,
                 m_sortColumns,
                 m_tableColumns.size() - 1, // exclude the 1st column with the id
-                &m_trackSortOrder);
+                &trackSortOrder);
+    }
+
+    sortAndReplaceRows(std::move(rowTrackIds),
+            std::move(rowValues),
+            m_trackSource ? &trackSortOrder : nullptr);
 
+    qDebug() << this << "select() returned" << m_rowTrackIds.size()
+             << "results in" << time.elapsed().debugMillisWithUnit();
+}
+
+void BaseSqlTableModel::sortAndReplaceRows(
+        QVector<TrackId>&& rowTrackIds,
+        ColumnarValues&& rowValues,
+        const QHash<TrackId, int>* pTrackSortOrder) {
+    DEBUG_ASSERT(rowTrackIds.size() == rowValues.rowCount());
+
+    // The sort order of each row, -1 if the row has been removed
+    std::vector<int> rowOrder(rowTrackIds.size());
+    std::iota(rowOrder.begin(), rowOrder.end(), 0);
+    if (pTrackSortOrder) {
         // Re-sort the track IDs since filterAndSort can change their order or mark
         // them for removal (by setting their row to -1).
-        for (auto& rowInfo : rowInfos) {
+        for (int row = 0; row < rowTrackIds.size(); ++row) {
             // If the sort is not a track column then we will sort only to
             // separate removed tracks (order == -1) from present tracks (order ==
             // 0). Otherwise we sort by the order that filterAndSort returned to us.
             if (m_trackSourceOrderBy.isEmpty()) {
-                rowInfo.row = m_trackSortOrder.contains(rowInfo.trackId) ? 0 : -1;
+                rowOrder[row] = pTrackSortOrder->contains(rowTrackIds[row]) ? 0 : -1;
             } else {
-                rowInfo.row = m_trackSortOrder.value(rowInfo.trackId, -1);
+                rowOrder[row] = pTrackSortOrder->value(rowTrackIds[row], -1);
             }
         }
     }
 
-    // RowInfo::operator< sorts by the order field, except -1 is placed at the
-    // end so we can easily slice off rows that are no longer present. Stable
-    // sort is necessary because the tracks may be in pre-sorted order so we
-    // should not disturb that if we are only removing tracks.
-    std::stable_sort(rowInfos.begin(), rowInfos.end());
+    // Sort the rows by their order, except -1 is placed at the end so we can
+    // easily slice off rows that are no longer present. Stable sort is
+    // necessary because the tracks may be in pre-sorted order so we should
+    // not disturb that if we are only removing tracks.
+    std::vector<int> sortedRows(rowTrackIds.size());
+    std::iota(sortedRows.begin(), sortedRows.end(), 0);
+    std::stable_sort(sortedRows.begin(),
+            sortedRows.end(),
+            [&rowOrder](int lhs, int rhs) {
+                // -1 is greater than anything
+                if (rowOrder[lhs] == -1) {
+                    return false;
+                } else if (rowOrder[rhs] == -1) {
+                    return true;
+                }
+                return rowOrder[lhs] < rowOrder[rhs];
+            });
+    // Cut off the rows that are no longer present
+    const auto firstRemovedRow = std::find_if(sortedRows.begin(),
+            sortedRows.end(),
+            [&rowOrder](int row) {
+                return rowOrder[row] == -1;
+            });
+    sortedRows.erase(firstRemovedRow, sortedRows.end());
+
+    QVector<TrackId> sortedTrackIds;
+    sortedTrackIds.reserve(static_cast<int>(sortedRows.size()));
+    for (int row : sortedRows) {
+        sortedTrackIds.push_back(rowTrackIds[row]);
+    }
+    ColumnarValues sortedValues = rowValues.reordered(sortedRows);
+    // Release the unsorted rows before building the indices
+    rowTrackIds.clear();
+    rowValues = ColumnarValues();
 
     TrackId2Rows trackIdToRows;
     // We expect almost all rows to be valid and that only a few tracks
-    // are contained multiple times in rowInfos (e.g. in history playlists)
-    trackIdToRows.reserve(rowInfos.size());
-    for (int i = 0; i < rowInfos.size(); ++i) {
-        const RowInfo& rowInfo = rowInfos[i];
-        if (rowInfo.row == -1) {
-            // We've reached the end of valid rows. Resize rowInfo to cut off
-            // this and all further elements.
-            rowInfos.resize(i);
-            break;
-        }
-        trackIdToRows[rowInfo.trackId].push_back(i);
+    // are contained multiple times in the rows (e.g. in history playlists)
+    trackIdToRows.reserve(sortedTrackIds.size());
+    for (int i = 0; i < sortedTrackIds.size(); ++i) {
+        trackIdToRows[sortedTrackIds[i]].push_back(i);
     }
     // The number of unique tracks cannot be greater than the
     // number of total rows returned by the query
-    DEBUG_ASSERT(trackIdToRows.size() <= rowInfos.size());
+    DEBUG_ASSERT(trackIdToRows.size() <= sortedTrackIds.size());
 
     TrackPos2Row trackPosToRows;
-    if (hasPositionColumn()) {
+    // The columns of the rows are the table columns
+    const int posColumn = hasPositionColumn()
+            ? m_tableColumns.indexOf(PLAYLISTTABLE_POSITION)
+            : -1;
+    if (posColumn >= 0) {
         // We expect as many positions as we have rows
-        trackPosToRows.reserve(rowInfos.size());
-        for (int i = 0; i < rowInfos.size(); ++i) {
-            const RowInfo& rowInfo = rowInfos[i];
-            trackPosToRows.insert(rowInfo.getPosition(posColumn), i);
+        trackPosToRows.reserve(sortedTrackIds.size());
+        for (int i = 0; i < sortedTrackIds.size(); ++i) {
+            bool ok = false;
+            const int pos = sortedValues.value(i, posColumn).toInt(&ok);
+            trackPosToRows.insert(ok ? pos : -1, i);
         }
-        DEBUG_ASSERT(trackPosToRows.size() == rowInfos.size());
+        DEBUG_ASSERT(trackPosToRows.size() == sortedTrackIds.size());
     }
 
+    // Remove all the rows from the table after(!) the query has been
+    // executed successfully. See issue #6782.
+    // TODO(rryan) we could edit the table in place instead of clearing it?
+    clearRows();
+
     // We're done! Issue the update signals and replace the main maps.
     replaceRows(
-            std::move(rowInfos),
+            std::move(sortedTrackIds),
+            std::move(sortedValues),
             std::move(trackIdToRows),
             std::move(trackPosToRows));
-    // Both rowInfo and trackIdToRows (might) have been moved and
+    // The sorted rows and indices (might) have been moved and
     // must not be used afterwards!
+}
 
-    qDebug() << this << "select() returned" << m_rowInfo.size()
-             << "results in" << time.elapsed().debugMillisWithUnit();
+quint64 BaseSqlTableModel::cancelSelectInBackground() {
+    if (m_selectPending) {
+        m_selectPending = false;
+        Counter(kSelectCanceledStatKey).increment();
+    }
+    return ++(*m_pLatestSelectId);
+}
+
+void BaseSqlTableModel::selectInBackground() {
+    if (!m_bInitialized) {
+        return;
+    }
+    TrackTableQueryThread* pQueryThread =
+            m_pTrackCollectionManager->trackTableQueryThread();
+    TrackTableQuery query;
+    // Temporary tables are only visible on our own connection
+    if (!pQueryThread ||
+            !TrackTableQueryThread::readTemporaryViews(
+                    m_database, m_tableName, &query.temporaryViews)) {
+        select();
+        return;
+    }
+
+    query.id = cancelSelectInBackground();
+    query.pLatestId = m_pLatestSelectId;
+    query.tableQuery = QString("SELECT %1 FROM %2 %3")
+                               .arg(m_tableColumns.join(","), m_tableName, m_tableOrderBy);
+    query.tableColumnCount = m_tableColumns.size();
+    if (m_trackSource) {
+        // The tracks of the table are selected by a subquery instead of a
+        // list of ids, which is only known when the table query has finished
+        query.trackSourceQuery = m_trackSource->filterAndSortQuery(
+                QString("SELECT %1 FROM %2").arg(m_idColumn, m_tableName),
+                m_currentSearch,
+                m_currentSearchFilter,
+                m_trackSourceOrderBy);
+    }
+
+    if (sDebug) {
+        qDebug() << this << "selectInBackground() executing:"
+                 << query.tableQuery << query.trackSourceQuery;
+    }
+
+    // The current rows remain visible until the result is swapped in
+    m_selectPending = true;
+    m_selectTimer.start();
+    pQueryThread->submit(query);
+}
+
+void BaseSqlTableModel::slotQueryFinished(const TrackTableQueryResultPointer& pResult) {
+    // The results of the queries of all models are delivered to each model
+    if (!m_selectPending ||
+            pResult->pLatestId != m_pLatestSelectId ||
+            pResult->id != m_pLatestSelectId->load()) {
+        return;
+    }
+    m_selectPending = false;
+
+    if (pResult->succeeded) {
+        QHash<TrackId, int> trackSortOrder;
+        if (m_trackSource) {
+            m_trackSource->finishFilterAndSort(pResult->rowTrackIds,
+                    m_currentSearch,
+                    m_currentSearchFilter,
+                    m_sortColumns,
+                    m_tableColumns.size() - 1, // exclude the 1st column with the id
+                    &pResult->trackSourceOrder,
+                    &trackSortOrder);
+        }
+        sortAndReplaceRows(std::move(pResult->rowTrackIds),
+                std::move(pResult->rowValues),
+                m_trackSource ? &trackSortOrder : nullptr);
+    } else {
+        qWarning() << this << "Selecting in background failed, selecting again";
+        select();
+    }
+
+    const mixxx::Duration latency = m_selectTimer.elapsed();
+    Stat::track(kSelectLatencyStatKey,
+            Stat::DURATION_MSEC,
+            Stat::experimentFlags(Stat::COUNT | Stat::AVERAGE | Stat::MIN |
+                    Stat::MAX | Stat::HISTOGRAM),
+            static_cast<double>(latency.toIntegerMillis()));
+    qDebug() << this << "selectInBackground() returned" << m_rowTrackIds.size()
+             << "results in" << latency.debugMillisWithUnit();
+
+    emit selectFinished();
 }
 
 void BaseSqlTableModel::setTable(QString tableName,
@@ -371,6 +519,9 @@ void BaseSqlTableModel::setTable(QString tableName,
     if (sDebug) {
         qDebug() << this << "setTable" << tableName << tableColumns << idColumn;
     }
+    // Results of the previous table must not be applied
+    cancelSelectInBackground();
+
     m_tableName = std::move(tableName);
     m_idColumn = std::move(idColumn);
     m_tableColumns = std::move(tableColumns);
@@ -380,6 +531,10 @@ void BaseSqlTableModel::setTable(QString tableName,
                 &BaseTrackCache::tracksChanged,
                 this,
                 &BaseSqlTableModel::tracksChanged);
+        disconnect(m_trackSource.data(),
+                &BaseTrackCache::tracksFetched,
+                this,
+                &BaseSqlTableModel::repaintTracks);
     }
     m_trackSource = trackSource;
     if (m_trackSource) {
@@ -395,6 +550,11 @@ void BaseSqlTableModel::setTable(QString tableName,
                 this,
                 &BaseSqlTableModel::tracksChanged,
                 Qt::QueuedConnection);
+        connect(m_trackSource.data(),
+                &BaseTrackCache::tracksFetched,
+                this,
+                &BaseSqlTableModel::repaintTracks,
+                Qt::QueuedConnection);
     }
 
     initTableColumnsAndHeaderProperties(m_tableColumns);
@@ -442,7 +602,7 @@ void BaseSqlTableModel::search(const QString& searchText, const QString& extraFi
         qDebug() << this << "search" << searchText;
     }
     setSearch(searchText, extraFilter);
-    select();
+    selectInBackground();
 }
 
 void BaseSqlTableModel::setSort(int column, Qt::SortOrder order) {
@@ -587,11 +747,11 @@ void BaseSqlTableModel::sort(int column, Qt::SortOrder order) {
         qDebug() << this << "sort()" << column << order;
     }
     setSort(column, order);
-    select();
+    selectInBackground();
 }
 
 int BaseSqlTableModel::rowCount(const QModelIndex& parent) const {
-    int count = parent.isValid() ? 0 : m_rowInfo.size();
+    int count = parent.isValid() ? 0 : m_rowTrackIds.size();
     //qDebug() << "rowCount()" << parent << count;
     return count;
 }
@@ -655,7 +815,7 @@ QVariant BaseSqlTableModel::rawValue(
 
     const int row = index.row();
     DEBUG_ASSERT(row >= 0);
-    if (row >= m_rowInfo.size()) {
+    if (row >= m_rowTrackIds.size()) {
         return QVariant();
     }
 
@@ -663,8 +823,7 @@ QVariant BaseSqlTableModel::rawValue(
     DEBUG_ASSERT(column >= 0);
     // TODO(rryan) check range on column
 
-    const RowInfo& rowInfo = m_rowInfo[row];
-    const TrackId trackId = rowInfo.trackId;
+    const TrackId trackId = m_rowTrackIds[row];
 
     // If the row info has the row-specific column, return that.
     if (column < m_tableColumns.size()) {
@@ -674,13 +833,13 @@ QVariant BaseSqlTableModel::rawValue(
             return previewDeckTrackId() == trackId;
         }
 
-        const QVector<QVariant>& columnValues = rowInfo.columnValues;
+        const QVariant value = m_rowValues.value(row, column);
         if (sDebug) {
             qDebug() << "Returning table-column value"
-                     << columnValues.at(column)
+                     << value
                      << "for column" << column;
         }
-        return columnValues[column];
+        return value;
     }
 
     // Otherwise, return the information from the track record cache for the
@@ -691,7 +850,10 @@ QVariant BaseSqlTableModel::rawValue(
     // Subtract table columns from index to get the track source column
     // number and add 1 to skip over the id column.
     int trackSourceColumn = column - m_tableColumns.size() + 1;
-    if (!m_trackSource->isCached(trackId)) {
+    // When fetching in background the values of uncached tracks are
+    // requested by data() and are signaled by tracksChanged() later.
+    if (!m_trackSource->isFetchingInBackground() &&
+            !m_trackSource->isCached(trackId)) {
         // Ideally Mixxx would have notified us of this via a signal, but in
         // the case that a track is not in the cache, we attempt to load it
         // on the fly. This will be a steep penalty to pay if there are tons
@@ -792,11 +954,16 @@ QString BaseSqlTableModel::getTrackLocation(const QModelIndex& index) const {
     if (!index.isValid()) {
         return QString();
     }
-    QString nativeLocation =
-            index.sibling(index.row(),
-                         fieldIndex(ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION))
-                    .data()
-                    .toString();
+    const QModelIndex locationIndex = index.sibling(index.row(),
+            fieldIndex(ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION));
+    QString nativeLocation = locationIndex.data().toString();
+    if (nativeLocation.isEmpty() && m_trackSource &&
+            m_trackSource->isFetchingInBackground()) {
+        // The location is needed now and can't wait until the track
+        // has been fetched in background
+        m_trackSource->ensureCached(getTrackId(index));
+        nativeLocation = locationIndex.data().toString();
+    }
     return QDir::fromNativeSeparators(nativeLocation);
 }
 
@@ -856,6 +1023,16 @@ void BaseSqlTableModel::tracksChanged(const QSet<TrackId>& trackIds) {
         qDebug() << this << "trackChanged" << trackIds.size();
     }
 
+    if (trackIds.size() <= kMaxChangedTracksToMove && canMoveChangedTracks()) {
+        // Keep the rows sorted without selecting all of them again
+        for (const auto& trackId : trackIds) {
+            moveChangedTrack(trackId);
+        }
+    }
+    repaintTracks(trackIds);
+}
+
+void BaseSqlTableModel::repaintTracks(const QSet<TrackId>& trackIds) {
     const int numColumns = columnCount();
     for (const auto& trackId : trackIds) {
         const auto rows = getTrackRows(trackId);
@@ -868,6 +1045,76 @@ void BaseSqlTableModel::tracksChanged(const QSet<TrackId>& trackIds) {
     }
 }
 
+bool BaseSqlTableModel::canMoveChangedTracks() const {
+    // Only the order of the track source is known for a single track. The
+    // order of the table columns is only known by the database.
+    // The values of tracks that are fetched in background would be queried
+    // one at a time for each comparison, so these tracks are only repainted.
+    if (!m_trackSource || m_trackSource->isFetchingInBackground() || m_selectPending ||
+            m_trackSourceOrderBy.isEmpty() || !m_tableOrderBy.isEmpty() ||
+            fieldIndex(ColumnCache::COLUMN_PLAYLISTTRACKSTABLE_POSITION) >= 0) {
+        return false;
+    }
+    for (const auto& sortColumn : m_sortColumns) {
+        if (sortColumn.m_column < m_tableColumns.size()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BaseSqlTableModel::moveChangedTrack(TrackId trackId) {
+    const auto rows = getTrackRows(trackId);
+    if (rows.size() != 1) {
+        return;
+    }
+    const int row = rows.first();
+    const int sortedRow = m_trackSource->findSortedRow(m_rowTrackIds,
+            row,
+            m_sortColumns,
+            m_tableColumns.size() - 1); // exclude the 1st column with the id
+    if (sortedRow != row) {
+        moveTrackRow(row, sortedRow);
+    }
+}
+
+void BaseSqlTableModel::moveTrackRow(int fromRow, int toRow) {
+    // The destination of beginMoveRows() is the row before which the row
+    // is inserted
+    const int destinationRow = toRow > fromRow ? toRow + 1 : toRow;
+    if (!beginMoveRows(QModelIndex(), fromRow, fromRow, QModelIndex(), destinationRow)) {
+        return;
+    }
+    const auto first = m_rowTrackIds.begin();
+    if (fromRow < toRow) {
+        std::rotate(first + fromRow, first + fromRow + 1, first + toRow + 1);
+    } else {
+        std::rotate(first + toRow, first + fromRow, first + fromRow + 1);
+    }
+    m_rowValues.moveRow(fromRow, toRow);
+
+    // The rows in between are shifted by one
+    const int minRow = std::min(fromRow, toRow);
+    const int maxRow = std::max(fromRow, toRow);
+    const int shift = fromRow < toRow ? -1 : 1;
+    QSet<TrackId> movedTrackIds;
+    for (int row = minRow; row <= maxRow; ++row) {
+        const TrackId trackId = m_rowTrackIds[row];
+        if (movedTrackIds.contains(trackId)) {
+            continue;
+        }
+        movedTrackIds.insert(trackId);
+        for (int& trackRow : m_trackIdToRows[trackId]) {
+            if (trackRow == fromRow) {
+                trackRow = toRow;
+            } else if (trackRow >= minRow && trackRow <= maxRow) {
+                trackRow += shift;
+            }
+        }
+    }
+    endMoveRows();
+}
+
 void BaseSqlTableModel::hideTracks(const QModelIndexList& indices) {
     QList<TrackId> trackIds;
     foreach (QModelIndex index, indices) {
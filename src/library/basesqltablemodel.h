@@ -1,12 +1,17 @@
 #pragma once
 
 #include <QHash>
+#include <atomic>
+#include <memory>
 
 #include "library/basetrackcache.h"
 #include "library/dao/trackdao.h"
 #include "library/basetracktablemodel.h"
+#include "library/columnartrackcache.h"
 #include "library/columncache.h"
+#include "library/tracktablequerythread.h"
 #include "util/class.h"
+#include "util/performancetimer.h"
 
 class TrackCollectionManager;
 
@@ -31,6 +36,13 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     void setSearch(const QString& searchText, const QString& extraFilter = QString());
     void setSort(int column, Qt::SortOrder order);
 
+    // Returns true while the rows of a sort or search are queried in
+    // background. The rows are replaced at once before selectFinished()
+    // is emitted.
+    bool isSelectPending() const {
+        return m_selectPending;
+    }
+
     ///////////////////////////////////////////////////////////////////////////
     // Inherited from QAbstractItemModel
     ///////////////////////////////////////////////////////////////////////////
@@ -77,6 +89,9 @@ class BaseSqlTableModel : public BaseTrackTableModel {
 
     QString modelKey(bool noSearch) const override;
 
+  signals:
+    void selectFinished();
+
   protected:
     ///////////////////////////////////////////////////////////////////////////
     // Inherited from BaseTrackTableModel
@@ -114,6 +129,8 @@ class BaseSqlTableModel : public BaseTrackTableModel {
 
   private slots:
     void tracksChanged(const QSet<TrackId>& trackIds);
+    void repaintTracks(const QSet<TrackId>& trackIds);
+    void slotQueryFinished(const TrackTableQueryResultPointer& pResult);
 
   private:
     void setTrackValueForColumn(
@@ -124,51 +141,43 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     // called.
     QString orderByClause() const;
 
-    struct RowInfo {
-        TrackId trackId;
-        int row;
-        QVector<QVariant> columnValues;
-
-        int getPosition(int posCol) const {
-            if (posCol < 0) {
-                return -1;
-            }
-            bool ok = false;
-            int pos = columnValues.at(posCol).toInt(&ok);
-            if (ok) {
-                return pos;
-            }
-            return -1;
-        }
-
-        bool operator<(const RowInfo& other) const {
-            // -1 is greater than anything
-            if (row == -1) {
-                return false;
-            } else if (other.row == -1) {
-                return true;
-            }
-            return row < other.row;
-        }
-    };
-
     typedef QHash<TrackId, QVector<int>> TrackId2Rows;
     typedef QHash<int, int> TrackPos2Row;
 
     void clearRows();
     void replaceRows(
-            QVector<RowInfo>&& rows,
+            QVector<TrackId>&& rowTrackIds,
+            ColumnarValues&& rowValues,
             TrackId2Rows&& trackIdToRows,
             TrackPos2Row&& trackPosToRows);
-
-    QVector<RowInfo> m_rowInfo;
+    // Sorts the rows of the table query by the order of the track source,
+    // if any, and replaces all rows
+    void sortAndReplaceRows(
+            QVector<TrackId>&& rowTrackIds,
+            ColumnarValues&& rowValues,
+            const QHash<TrackId, int>* pTrackSortOrder);
+
+    // Queries the rows of a sort or search on the TrackTableQueryThread
+    // instead of blocking the GUI thread like select()
+    void selectInBackground();
+    // Returns the id for the next query
+    quint64 cancelSelectInBackground();
+
+    bool canMoveChangedTracks() const;
+    void moveChangedTrack(TrackId trackId);
+    void moveTrackRow(int fromRow, int toRow);
+
+    // The track ids of the rows in sorted order. The values of the table
+    // columns are stored column by column in the same order, the values of
+    // the track source are looked up by the track id.
+    QVector<TrackId> m_rowTrackIds;
+    ColumnarValues m_rowValues;
 
     QString m_idColumn;
     QSharedPointer<BaseTrackCache> m_trackSource;
     QStringList m_tableColumns;
     QList<SortColumn> m_sortColumns;
     bool m_bInitialized;
-    QHash<TrackId, int> m_trackSortOrder;
     TrackId2Rows m_trackIdToRows;
     TrackPos2Row m_trackPosToRow;
     QString m_currentSearch;
@@ -176,5 +185,11 @@ class BaseSqlTableModel : public BaseTrackTableModel {
     QVector<QHash<int, QVariant>> m_headerInfo;
     QString m_trackSourceOrderBy;
 
+    // The id of the latest query in background, results of other queries
+    // are discarded
+    const std::shared_ptr<std::atomic<quint64>> m_pLatestSelectId;
+    bool m_selectPending;
+    PerformanceTimer m_selectTimer;
+
     DISALLOW_COPY_AND_ASSIGN(BaseSqlTableModel);
 };
@@ -1,9 +1,12 @@
 #include "library/basetrackcache.h"
 
+#include <QTimer>
+
 #include "library/queryutil.h"
 #include "library/searchquery.h"
 #include "library/searchqueryparser.h"
 #include "library/trackcollection.h"
+#include "library/trackcolumnfetcher.h"
 #include "moc_basetrackcache.cpp"
 #include "track/globaltrackcache.h"
 #include "track/keyutils.h"
@@ -14,6 +17,12 @@ namespace {
 
 constexpr bool sDebug = false;
 
+// The number of tracks that are cached when fetching in background. This
+// is enough for multiple screens of rows and a few thousand selected tracks.
+constexpr int kMaxFetchedTracks = 8192;
+// The tracks that are requested while painting are fetched in batches
+constexpr int kMaxTracksPerFetch = 256;
+
 }  // namespace
 
 BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
@@ -31,7 +40,9 @@ BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
                   pTrackCollection, std::move(searchColumns))),
           m_bIndexBuilt(false),
           m_bIsCaching(isCaching),
-          m_database(pTrackCollection->database()) {
+          m_database(pTrackCollection->database()),
+          m_fetchedTracks(kMaxFetchedTracks),
+          m_fetchScheduled(false) {
 }
 
 BaseTrackCache::~BaseTrackCache() {
@@ -81,6 +92,9 @@ void BaseTrackCache::slotTracksRemoved(const QSet<TrackId>& trackIds) {
         m_trackInfo.remove(trackId);
         m_dirtyTracks.remove(trackId);
     }
+    if (m_pFetcher) {
+        removeFetchedTracks(trackIds);
+    }
 }
 
 void BaseTrackCache::slotTrackDirty(TrackId trackId) {
@@ -100,17 +114,187 @@ void BaseTrackCache::slotTrackClean(TrackId trackId) {
 }
 
 bool BaseTrackCache::isCached(TrackId trackId) const {
+    if (m_pFetcher) {
+        return m_fetchedTracks.contains(trackId);
+    }
     return m_trackInfo.contains(trackId);
 }
 
 void BaseTrackCache::ensureCached(TrackId trackId) {
+    if (m_pFetcher) {
+        fetchNow(QSet<TrackId>{trackId});
+        return;
+    }
     updateTrackInIndex(trackId);
 }
 
 void BaseTrackCache::ensureCached(const QSet<TrackId>& trackIds) {
+    if (m_pFetcher) {
+        fetchNow(trackIds);
+        return;
+    }
     updateTracksInIndex(trackIds);
 }
 
+void BaseTrackCache::fetchInBackground(
+        mixxx::DbConnectionPoolPtr pDbConnectionPool,
+        const QString& createViewQuery) {
+    VERIFY_OR_DEBUG_ASSERT(!m_pFetcher) {
+        return;
+    }
+    m_pFetcher = std::make_unique<TrackColumnFetcher>(
+            std::move(pDbConnectionPool),
+            m_tableName,
+            m_idColumn,
+            m_columnCount,
+            m_columnsJoined,
+            createViewQuery,
+            fieldIndex(ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION));
+    connect(m_pFetcher.get(),
+            &TrackColumnFetcher::tracksFetched,
+            this,
+            &BaseTrackCache::slotTracksFetched,
+            Qt::QueuedConnection);
+    connect(m_pFetcher.get(),
+            &TrackColumnFetcher::fetchFailed,
+            this,
+            &BaseTrackCache::slotFetchFailed,
+            Qt::QueuedConnection);
+    // The values are fetched on demand from now on
+    m_trackInfo.clear();
+    m_trackInfo.squeeze();
+}
+
+void BaseTrackCache::requestFetch(TrackId trackId) {
+    DEBUG_ASSERT(m_pFetcher);
+    if (m_fetchingTracks.contains(trackId)) {
+        return;
+    }
+    m_tracksToFetch.insert(trackId);
+    if (m_fetchScheduled) {
+        return;
+    }
+    // Collect the tracks of all rows that are painted before fetching them
+    m_fetchScheduled = true;
+    QTimer::singleShot(0, this, [this] {
+        fetchRequestedTracks();
+    });
+}
+
+void BaseTrackCache::fetchRequestedTracks() {
+    m_fetchScheduled = false;
+    QVector<TrackId> trackIds;
+    trackIds.reserve(kMaxTracksPerFetch);
+    for (const auto& trackId : std::as_const(m_tracksToFetch)) {
+        trackIds.append(trackId);
+        m_fetchingTracks.insert(trackId);
+        if (trackIds.size() == kMaxTracksPerFetch) {
+            m_pFetcher->fetchTracks(trackIds);
+            trackIds.clear();
+        }
+    }
+    if (!trackIds.isEmpty()) {
+        m_pFetcher->fetchTracks(trackIds);
+    }
+    m_tracksToFetch.clear();
+}
+
+void BaseTrackCache::slotTracksFetched(
+        const QVector<TrackId>& trackIds, const ColumnarValues& values) {
+    if (sDebug) {
+        qDebug() << this << "slotTracksFetched" << trackIds.size();
+    }
+    QSet<TrackId> fetchedTrackIds;
+    fetchedTrackIds.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
+        m_fetchingTracks.remove(trackId);
+        fetchedTrackIds.insert(trackId);
+    }
+    m_fetchedTracks.insert(trackIds, values);
+    // Values that have changed since they were fetched are outdated
+    QSet<TrackId> staleTrackIds;
+    for (const auto& trackId : trackIds) {
+        if (m_staleFetchingTracks.remove(trackId)) {
+            staleTrackIds.insert(trackId);
+        }
+    }
+    m_fetchedTracks.remove(staleTrackIds);
+    emit tracksFetched(fetchedTrackIds);
+}
+
+void BaseTrackCache::slotFetchFailed(const QVector<TrackId>& trackIds) {
+    if (sDebug) {
+        qDebug() << this << "slotFetchFailed" << trackIds.size();
+    }
+    // Fall back to the connection of the GUI thread. The values fetched
+    // now are up to date, even if the tracks changed in the meantime.
+    QSet<TrackId> failedTrackIds;
+    failedTrackIds.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
+        m_fetchingTracks.remove(trackId);
+        m_staleFetchingTracks.remove(trackId);
+        failedTrackIds.insert(trackId);
+    }
+    // If this fails too the cells stay empty until they are requested
+    // again, e.g. when they are painted the next time
+    if (fetchNow(failedTrackIds)) {
+        emit tracksFetched(failedTrackIds);
+    }
+}
+
+bool BaseTrackCache::fetchNow(const QSet<TrackId>& trackIds) {
+    DEBUG_ASSERT(m_pFetcher);
+    QVector<TrackId> missingTrackIds;
+    for (const auto& trackId : trackIds) {
+        if (!m_fetchedTracks.contains(trackId)) {
+            missingTrackIds.append(trackId);
+        }
+    }
+    if (missingTrackIds.isEmpty()) {
+        return true;
+    }
+    ColumnarValues values(m_columnCount);
+    if (!TrackColumnFetcher::queryTracks(m_database,
+                m_tableName,
+                m_idColumn,
+                m_columnsJoined,
+                fieldIndex(ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION),
+                missingTrackIds,
+                &values)) {
+        return false;
+    }
+    m_fetchedTracks.insert(missingTrackIds, std::move(values));
+    return true;
+}
+
+void BaseTrackCache::removeFetchedTracks(const QSet<TrackId>& trackIds) {
+    DEBUG_ASSERT(m_pFetcher);
+    m_fetchedTracks.remove(trackIds);
+    for (const auto& trackId : trackIds) {
+        if (m_fetchingTracks.contains(trackId)) {
+            m_staleFetchingTracks.insert(trackId);
+        }
+    }
+}
+
+QVariant BaseTrackCache::fetchedData(TrackId trackId, int column) {
+    DEBUG_ASSERT(m_pFetcher);
+    QVariant value;
+    if (!m_fetchedTracks.lookup(trackId, column, &value)) {
+        requestFetch(trackId);
+        return QVariant{};
+    }
+    if (column == fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_KEY)) {
+        // The Key value is determined by either the KEY_ID or KEY column
+        QVariant keyId;
+        m_fetchedTracks.lookup(trackId,
+                fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_KEY_ID),
+                &keyId);
+        return KeyUtils::keyFromKeyTextAndIdFields(value, keyId);
+    }
+    return value;
+}
+
 const TrackPointer& BaseTrackCache::getRecentTrack(TrackId trackId) const {
     DEBUG_ASSERT(m_bIsCaching);
     // Only refresh the recently used track if the identifiers
@@ -200,7 +384,13 @@ bool BaseTrackCache::updateTrackInIndex(
     int numColumns = columnCount();
 
     TrackId trackId = pTrack->getId();
-    if (trackId.isValid()) {
+    if (trackId.isValid() && m_pFetcher) {
+        // The values are fetched again when needed
+        removeFetchedTracks(QSet<TrackId>{trackId});
+        if (m_bIsCaching) {
+            replaceRecentTrack(std::move(trackId), pTrack);
+        }
+    } else if (trackId.isValid()) {
         // m_trackInfo[id] will insert a QVector<QVariant> into the
         // m_trackInfo HashTable with the key "id"
         QVector<QVariant>& record = m_trackInfo[trackId];
@@ -275,6 +465,14 @@ void BaseTrackCache::buildIndex() {
         qDebug() << this << "buildIndex()";
     }
 
+    if (m_pFetcher) {
+        // Nothing to load in advance
+        removeFetchedTracks(m_fetchingTracks);
+        m_fetchedTracks.clear();
+        m_bIndexBuilt = true;
+        return;
+    }
+
     QString queryString = QString("SELECT %1 FROM %2")
             .arg(m_columnsJoined, m_tableName);
 
@@ -305,6 +503,14 @@ void BaseTrackCache::updateTracksInIndex(const QSet<TrackId>& trackIds) {
         return;
     }
 
+    if (m_pFetcher) {
+        // Don't query the database here, only the visible tracks are
+        // fetched again in background
+        removeFetchedTracks(trackIds);
+        emit tracksChanged(trackIds);
+        return;
+    }
+
     QStringList idStrings;
     idStrings.reserve(trackIds.size());
     for (const auto& trackId: trackIds) {
@@ -438,7 +644,7 @@ QVariant BaseTrackCache::getTrackValueForColumn(TrackPointer pTrack,
     return QVariant{};
 }
 
-QVariant BaseTrackCache::data(TrackId trackId, int column) const {
+QVariant BaseTrackCache::data(TrackId trackId, int column) {
     if (!m_bIndexBuilt) {
         qDebug() << this << "ERROR index is not built for" << m_tableName;
         return QVariant{};
@@ -458,6 +664,10 @@ QVariant BaseTrackCache::data(TrackId trackId, int column) const {
     // keep track of in Track, like playlist position) look up the value in
     // the track info cache.
 
+    if (m_pFetcher) {
+        return fetchedData(trackId, column);
+    }
+
     // TODO(rryan) this code is flawed for columns that contains row-specific
     // metadata. Currently the upper-levels will not delegate row-specific
     // columns to this method, but there should still be a check here I think.
@@ -477,6 +687,33 @@ QVariant BaseTrackCache::data(TrackId trackId, int column) const {
     return fields.value(column, QVariant{});
 }
 
+std::unique_ptr<QueryNode> BaseTrackCache::parseFilterQuery(
+        const QString& searchQuery,
+        const QString& extraFilter,
+        const QString& idFilter) const {
+    QStringList queryFragments;
+    if (!extraFilter.isNull() && extraFilter != "") {
+        queryFragments << QString("(%1)").arg(extraFilter);
+    }
+    if (!idFilter.isEmpty()) {
+        queryFragments << idFilter;
+    }
+    return m_pQueryParser->parseQuery(
+            searchQuery,
+            queryFragments.join(" AND "));
+}
+
+QString BaseTrackCache::selectTrackIdsQuery(
+        const QueryNode& query,
+        const QString& orderByClause) const {
+    QString filter = query.toSql();
+    if (!filter.isEmpty()) {
+        filter.prepend("WHERE ");
+    }
+    return QString("SELECT %1 FROM %2 %3 %4")
+            .arg(m_idColumn, m_tableName, filter, orderByClause);
+}
+
 void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
                                    const QString& searchQuery,
                                    const QString& extraFilter,
@@ -504,27 +741,12 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         }
     }
 
-    QStringList queryFragments;
-    if (!extraFilter.isNull() && extraFilter != "") {
-        queryFragments << QString("(%1)").arg(extraFilter);
-    }
-    if (idStrings.size() > 0) {
-        queryFragments << QString("%1 in (%2)")
-                .arg(m_idColumn, idStrings.join(","));
-    }
-
-    const std::unique_ptr<QueryNode> pQuery =
-            m_pQueryParser->parseQuery(
-                    searchQuery,
-                    queryFragments.join(" AND "));
+    const std::unique_ptr<QueryNode> pQuery = parseFilterQuery(
+            searchQuery,
+            extraFilter,
+            QString("%1 in (%2)").arg(m_idColumn, idStrings.join(",")));
 
-    QString filter = pQuery->toSql();
-    if (!filter.isEmpty()) {
-        filter.prepend("WHERE ");
-    }
-
-    QString queryString = QString("SELECT %1 FROM %2 %3 %4")
-            .arg(m_idColumn, m_tableName, filter, orderByClause);
+    QString queryString = selectTrackIdsQuery(*pQuery, orderByClause);
 
     if (sDebug) {
         qDebug() << this << "select() executing:" << queryString;
@@ -560,6 +782,78 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         m_trackOrder.append(trackId);
     }
 
+    sortDirtyTracks(*pQuery,
+            searchQuery,
+            dirtyTracks,
+            sortColumns,
+            columnOffset,
+            &m_trackOrder,
+            trackToIndex);
+}
+
+QString BaseTrackCache::filterAndSortQuery(
+        const QString& trackIdsQuery,
+        const QString& searchQuery,
+        const QString& extraFilter,
+        const QString& orderByClause) {
+    if (!m_bIndexBuilt) {
+        buildIndex();
+    }
+    const std::unique_ptr<QueryNode> pQuery = parseFilterQuery(
+            searchQuery,
+            extraFilter,
+            QString("%1 in (%2)").arg(m_idColumn, trackIdsQuery));
+    return selectTrackIdsQuery(*pQuery, orderByClause);
+}
+
+void BaseTrackCache::finishFilterAndSort(
+        const QVector<TrackId>& trackIds,
+        const QString& searchQuery,
+        const QString& extraFilter,
+        const QList<SortColumn>& sortColumns,
+        const int columnOffset,
+        QVector<TrackId>* pTrackOrder,
+        QHash<TrackId, int>* trackToIndex) {
+    trackToIndex->clear();
+    trackToIndex->reserve(pTrackOrder->size());
+    for (int i = 0; i < pTrackOrder->size(); ++i) {
+        trackToIndex->insert(pTrackOrder->at(i), i);
+    }
+
+    QSet<TrackId> dirtyTracks;
+    if (m_bIsCaching && !m_dirtyTracks.isEmpty()) {
+        for (const auto& trackId : trackIds) {
+            if (m_dirtyTracks.contains(trackId)) {
+                dirtyTracks.insert(trackId);
+            }
+        }
+    }
+    if (dirtyTracks.isEmpty()) {
+        return;
+    }
+    // Only the dirty tracks are matched, the ids have been filtered by the
+    // query already
+    const std::unique_ptr<QueryNode> pQuery = parseFilterQuery(
+            searchQuery,
+            extraFilter,
+            QString());
+    sortDirtyTracks(*pQuery,
+            searchQuery,
+            dirtyTracks,
+            sortColumns,
+            columnOffset,
+            pTrackOrder,
+            trackToIndex);
+}
+
+void BaseTrackCache::sortDirtyTracks(
+        const QueryNode& query,
+        const QString& searchQuery,
+        const QSet<TrackId>& dirtyTracks,
+        const QList<SortColumn>& sortColumns,
+        const int columnOffset,
+        QVector<TrackId>* pTrackOrder,
+        QHash<TrackId, int>* trackToIndex) {
     // At this point, the original set of tracks have been divided into two
     // pieces: those that should be in the result set and those that should
     // not. Unfortunately, due to TrackDAO caching, there may be tracks in
@@ -585,7 +879,7 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         // The track should be in the result set if the search is empty or the
         // track matches the search.
         bool shouldBeInResultSet = searchQuery.isEmpty() ||
-                pQuery->match(pTrack);
+                query.match(pTrack);
 
         // If the track is in this result set.
         bool isInResultSet = trackToIndex->contains(trackId);
@@ -597,14 +891,22 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
             // will sort wrong).
             if (isInResultSet) {
                 int index = (*trackToIndex)[trackId];
-                m_trackOrder.remove(index);
+                pTrackOrder->remove(index);
                 // Don't update trackToIndex, since we do it below.
             }
 
             // Figure out where it is supposed to sort. The table is sorted by
             // the sort column, so we can binary search.
-            int insertRow = findSortInsertionPoint(
-                    pTrack, sortColumns, columnOffset, m_trackOrder);
+            QList<QVariant> trackValues;
+            for (const auto& sc : sortColumns) {
+                trackValues.append(getTrackValueForColumn(pTrack, sc.m_column - columnOffset));
+            }
+            int insertRow = findSortInsertionPoint(trackValues,
+                    sortColumns,
+                    columnOffset,
+                    *pTrackOrder,
+                    0,
+                    pTrackOrder->size() - 1);
 
             if (sDebug) {
                 qDebug() << this
@@ -613,76 +915,125 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
             }
 
             // The track should sort at insertRow
-            m_trackOrder.insert(insertRow, trackId);
+            pTrackOrder->insert(insertRow, trackId);
 
             trackToIndex->clear();
             // Fix the index. TODO(rryan) find a non-stupid way to do this.
-            for (int i = 0; i < m_trackOrder.size(); ++i) {
-                (*trackToIndex)[m_trackOrder[i]] = i;
+            for (int i = 0; i < pTrackOrder->size(); ++i) {
+                (*trackToIndex)[pTrackOrder->at(i)] = i;
             }
         } else if (isInResultSet) {
             // Track should not be in this result set, but it is. We need to
             // remove it.
             int index = (*trackToIndex)[trackId];
-            m_trackOrder.remove(index);
+            pTrackOrder->remove(index);
 
             trackToIndex->clear();
             // Fix the index. TODO(rryan) find a non-stupid way to do this.
-            for (int i = 0; i < m_trackOrder.size(); ++i) {
-                (*trackToIndex)[m_trackOrder[i]] = i;
+            for (int i = 0; i < pTrackOrder->size(); ++i) {
+                (*trackToIndex)[pTrackOrder->at(i)] = i;
             }
         }
     }
 }
 
-int BaseTrackCache::findSortInsertionPoint(TrackPointer pTrack,
+int BaseTrackCache::findSortedRow(
+        const QVector<TrackId>& trackIds,
+        int row,
         const QList<SortColumn>& sortColumns,
-        const int columnOffset,
-        const QVector<TrackId>& trackIds) const {
-    QList<QVariant> trackValues;
+        const int columnOffset) {
+    VERIFY_OR_DEBUG_ASSERT(row >= 0 && row < trackIds.size()) {
+        return row;
+    }
     if (sortColumns.isEmpty()) {
-        return 0;
+        return row;
     }
-    for (const auto& sc: sortColumns) {
-        trackValues.append(getTrackValueForColumn(pTrack, sc.m_column - columnOffset));
+    // Comparing with the other tracks would query their values one at a
+    // time if they are fetched in background
+    VERIFY_OR_DEBUG_ASSERT(!m_pFetcher) {
+        return row;
+    }
+    const TrackId trackId = trackIds[row];
+    QList<QVariant> trackValues;
+    for (const auto& sc : sortColumns) {
+        trackValues.append(data(trackId, sc.m_column - columnOffset));
+    }
+    // All other rows are still sorted, so comparing the neighbors tells
+    // the direction in which the track has to be moved
+    if (row > 0 &&
+            compareTrackValues(trackValues, trackIds[row - 1], sortColumns, columnOffset) < 0) {
+        return findSortInsertionPoint(
+                trackValues, sortColumns, columnOffset, trackIds, 0, row - 1);
+    }
+    if (row < trackIds.size() - 1 &&
+            compareTrackValues(trackValues, trackIds[row + 1], sortColumns, columnOffset) > 0) {
+        // The row itself is removed before inserting the track
+        return findSortInsertionPoint(trackValues,
+                       sortColumns,
+                       columnOffset,
+                       trackIds,
+                       row + 1,
+                       trackIds.size() - 1) -
+                1;
+    }
+    return row;
+}
+
+int BaseTrackCache::compareTrackValues(
+        const QList<QVariant>& trackValues,
+        TrackId otherTrackId,
+        const QList<SortColumn>& sortColumns,
+        const int columnOffset) {
+    if (m_pFetcher) {
+        // The values are needed now and can't be fetched in background
+        ensureCached(otherTrackId);
+    } else if (!m_trackInfo.contains(otherTrackId)) {
+        // This should not happen, but it's a recoverable error so we should
+        // only log it.
+        qDebug() << "WARNING: track" << otherTrackId << "was not in index";
+        //updateTrackInIndex(otherTrackId);
+    }
+
+    int compare = 0;
+    for (int i = 0; i < sortColumns.count(); i++) {
+        QVariant tableValue =
+                data(otherTrackId, sortColumns[i].m_column - columnOffset);
+
+        compare = compareColumnValues(
+                sortColumns[i].m_column - columnOffset,
+                sortColumns[i].m_order,
+                trackValues[i],
+                tableValue);
+
+        if (compare != 0) {
+            break;
+        }
     }
+    return compare;
+}
 
-    int min = 0;
-    int max = trackIds.size() - 1;
+int BaseTrackCache::findSortInsertionPoint(
+        const QList<QVariant>& trackValues,
+        const QList<SortColumn>& sortColumns,
+        const int columnOffset,
+        const QVector<TrackId>& trackIds,
+        int min,
+        int max) {
+    if (sortColumns.isEmpty()) {
+        return min;
+    }
 
     if (sDebug) {
         qDebug() << this << "Trying to insertion sort:"
                  << trackValues.at(0) << "min" << min << "max" << max;
     }
 
-    // If trackIds is empty, min is 0 and max is -1 so findSortInsertionPoint
-    // returns 0.
+    // If the range is empty, max is min - 1 so findSortInsertionPoint
+    // returns min.
     while (min <= max) {
         int mid = min + (max - min) / 2;
-        TrackId otherTrackId(trackIds[mid]);
-
-        // This should not happen, but it's a recoverable error so we should
-        // only log it.
-        if (!m_trackInfo.contains(otherTrackId)) {
-            qDebug() << "WARNING: track" << otherTrackId << "was not in index";
-            //updateTrackInIndex(otherTrackId);
-        }
-
-        int compare = 0;
-        for (int i = 0; i < sortColumns.count(); i++) {
-            QVariant tableValue =
-                    data(otherTrackId, sortColumns[i].m_column - columnOffset);
-
-            compare = compareColumnValues(
-                    sortColumns[i].m_column - columnOffset,
-                    sortColumns[i].m_order,
-                    trackValues[i],
-                    tableValue);
-
-            if (compare != 0) {
-                break;
-            }
-        }
+        int compare = compareTrackValues(
+                trackValues, trackIds[mid], sortColumns, columnOffset);
 
         if (compare == 0) {
             // Alright, if we're here then we can insert it here and be
@@ -10,14 +10,18 @@
 #include <QVector>
 #include <memory>
 
+#include "library/columnartrackcache.h"
 #include "library/columncache.h"
 #include "track/track_decl.h"
 #include "track/trackid.h"
 #include "util/class.h"
+#include "util/db/dbconnectionpool.h"
 #include "util/string.h"
 
+class QueryNode;
 class SearchQueryParser;
 class TrackCollection;
+class TrackColumnFetcher;
 
 class SortColumn {
   public:
@@ -54,11 +58,25 @@ class BaseTrackCache : public QObject {
     // expensive on large tables.
     virtual void buildIndex();
 
+    /// Don't keep the values of all tracks in memory, but fetch the values
+    /// that are requested by data() in batches on a background thread. Only
+    /// a bounded number of tracks is cached then. createViewQuery creates
+    /// the table if it is a temporary view, which is only visible on the
+    /// connection that created it.
+    void fetchInBackground(
+            mixxx::DbConnectionPoolPtr pDbConnectionPool,
+            const QString& createViewQuery);
+    bool isFetchingInBackground() const {
+        return static_cast<bool>(m_pFetcher);
+    }
+
     ////////////////////////////////////////////////////////////////////////////
     // Data access methods
     ////////////////////////////////////////////////////////////////////////////
 
-    virtual QVariant data(TrackId trackId, int column) const;
+    /// Not const, because in background mode a missing value is requested
+    /// from the fetcher.
+    virtual QVariant data(TrackId trackId, int column);
     virtual int columnCount() const;
     virtual int fieldIndex(const QString& column) const;
     QString columnNameForFieldIndex(int index) const;
@@ -71,12 +89,38 @@ class BaseTrackCache : public QObject {
                                const QList<SortColumn>& sortColumns,
                                const int columnOffset,
                                QHash<TrackId, int>* trackToIndex);
+    /// Returns the query of filterAndSort() for the tracks that are selected
+    /// by trackIdsQuery, e.g. "SELECT id FROM playlist_view". It can be
+    /// executed on another connection that has the same temporary views.
+    QString filterAndSortQuery(const QString& trackIdsQuery,
+            const QString& searchQuery,
+            const QString& extraFilter,
+            const QString& orderByClause);
+    /// Corrects the sorted result of filterAndSortQuery() for the tracks
+    /// that have been modified but not saved yet and fills trackToIndex.
+    void finishFilterAndSort(const QVector<TrackId>& trackIds,
+            const QString& searchQuery,
+            const QString& extraFilter,
+            const QList<SortColumn>& sortColumns,
+            const int columnOffset,
+            QVector<TrackId>* pTrackOrder,
+            QHash<TrackId, int>* trackToIndex);
+    /// Returns the row that the track in the given row of the sorted
+    /// trackIds has to be moved to after its values have changed. Not
+    /// supported while fetching in background.
+    int findSortedRow(const QVector<TrackId>& trackIds,
+            int row,
+            const QList<SortColumn>& sortColumns,
+            const int columnOffset);
     virtual bool isCached(TrackId trackId) const;
     virtual void ensureCached(TrackId trackId);
     virtual void ensureCached(const QSet<TrackId>& trackIds);
 
   signals:
     void tracksChanged(const QSet<TrackId>& trackIds);
+    /// The values of the tracks have been fetched in background. Unlike
+    /// tracksChanged() they have not been modified.
+    void tracksFetched(const QSet<TrackId>& trackIds);
 
   public slots:
     void slotScanTrackAdded(TrackPointer pTrack);
@@ -86,7 +130,19 @@ class BaseTrackCache : public QObject {
     void slotTrackDirty(TrackId trackId);
     void slotTrackClean(TrackId trackId);
 
+  private slots:
+    void slotTracksFetched(const QVector<TrackId>& trackIds, const ColumnarValues& values);
+    void slotFetchFailed(const QVector<TrackId>& trackIds);
+
   private:
+    void requestFetch(TrackId trackId);
+    void fetchRequestedTracks();
+    /// Fetches the values of the tracks that are not cached on the
+    /// connection of the GUI thread. Nothing is cached if the query fails.
+    bool fetchNow(const QSet<TrackId>& trackIds);
+    void removeFetchedTracks(const QSet<TrackId>& trackIds);
+    QVariant fetchedData(TrackId trackId, int column);
+
     const TrackPointer& getRecentTrack(TrackId trackId) const;
     void replaceRecentTrack(TrackPointer pTrack) const;
     void replaceRecentTrack(TrackId trackId, TrackPointer pTrack) const;
@@ -98,10 +154,31 @@ class BaseTrackCache : public QObject {
     void updateTracksInIndex(const QSet<TrackId>& trackIds);
     QVariant getTrackValueForColumn(TrackPointer pTrack, int column) const;
 
-    int findSortInsertionPoint(TrackPointer pTrack,
-                               const QList<SortColumn>& sortColumns,
-                               const int columnOffset,
-                               const QVector<TrackId>& trackIds) const;
+    std::unique_ptr<QueryNode> parseFilterQuery(
+            const QString& searchQuery,
+            const QString& extraFilter,
+            const QString& idFilter) const;
+    QString selectTrackIdsQuery(
+            const QueryNode& query,
+            const QString& orderByClause) const;
+    void sortDirtyTracks(const QueryNode& query,
+            const QString& searchQuery,
+            const QSet<TrackId>& dirtyTracks,
+            const QList<SortColumn>& sortColumns,
+            const int columnOffset,
+            QVector<TrackId>* pTrackOrder,
+            QHash<TrackId, int>* trackToIndex);
+
+    int findSortInsertionPoint(const QList<QVariant>& trackValues,
+            const QList<SortColumn>& sortColumns,
+            const int columnOffset,
+            const QVector<TrackId>& trackIds,
+            int min,
+            int max);
+    int compareTrackValues(const QList<QVariant>& trackValues,
+            TrackId otherTrackId,
+            const QList<SortColumn>& sortColumns,
+            const int columnOffset);
     int compareColumnValues(int sortColumn,
             Qt::SortOrder sortOrder,
             const QVariant& val1,
@@ -146,5 +223,15 @@ class BaseTrackCache : public QObject {
     QHash<TrackId, QVector<QVariant>> m_trackInfo;
     QSqlDatabase m_database;
 
+    // Only used when fetching in background instead of m_trackInfo
+    std::unique_ptr<TrackColumnFetcher> m_pFetcher;
+    ColumnarTrackCache m_fetchedTracks;
+    // Tracks that have been requested by data() but are not fetched yet
+    QSet<TrackId> m_tracksToFetch;
+    bool m_fetchScheduled;
+    QSet<TrackId> m_fetchingTracks;
+    // Tracks that changed while they were fetched
+    QSet<TrackId> m_staleFetchingTracks;
+
     DISALLOW_COPY_AND_ASSIGN(BaseTrackCache);
 };
@@ -0,0 +1,397 @@
+#include "library/columnartrackcache.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "util/assert.h"
+
+namespace {
+
+template<typename T>
+void moveElement(std::vector<T>* pValues, int from, int to) {
+    const auto first = pValues->begin();
+    if (from < to) {
+        std::rotate(first + from, first + from + 1, first + to + 1);
+    } else {
+        std::rotate(first + to, first + from, first + from + 1);
+    }
+}
+
+} // anonymous namespace
+
+ColumnarValues::ColumnarValues(int columnCount)
+        : m_columns(std::max(columnCount, 0)),
+          m_rowCount(0) {
+}
+
+void ColumnarValues::reserve(int rowCount) {
+    for (auto& column : m_columns) {
+        column.nulls.reserve(rowCount);
+    }
+}
+
+// static
+ColumnarValues::Type ColumnarValues::typeOf(const QVariant& value) {
+    if (value.isNull()) {
+        return Type::Null;
+    }
+    switch (value.userType()) {
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Bool:
+        return Type::Integer;
+    case QMetaType::Double:
+        return Type::Real;
+    case QMetaType::QString:
+        return Type::Text;
+    case QMetaType::QByteArray:
+        return Type::Bytes;
+    default:
+        return Type::Variant;
+    }
+}
+
+// static
+void ColumnarValues::setType(Column* pColumn, Type type, int rowCount) {
+    DEBUG_ASSERT(pColumn->type == Type::Null);
+    pColumn->type = type;
+    // All previous rows are NULL
+    switch (type) {
+    case Type::Integer:
+        pColumn->integers.resize(rowCount);
+        break;
+    case Type::Real:
+        pColumn->reals.resize(rowCount);
+        break;
+    case Type::Text:
+        pColumn->texts.resize(rowCount);
+        break;
+    case Type::Bytes:
+        pColumn->bytes.resize(rowCount);
+        break;
+    case Type::Variant:
+        pColumn->variants.resize(rowCount);
+        break;
+    case Type::Null:
+        DEBUG_ASSERT(!"unreachable");
+        break;
+    }
+}
+
+// static
+void ColumnarValues::convertToVariants(Column* pColumn) {
+    const auto rowCount = pColumn->nulls.size();
+    pColumn->variants.reserve(pColumn->nulls.capacity());
+    for (std::size_t row = 0; row < rowCount; ++row) {
+        if (pColumn->nulls[row]) {
+            pColumn->variants.emplace_back();
+            continue;
+        }
+        switch (pColumn->type) {
+        case Type::Integer:
+            pColumn->variants.emplace_back(pColumn->integers[row]);
+            break;
+        case Type::Real:
+            pColumn->variants.emplace_back(pColumn->reals[row]);
+            break;
+        case Type::Text:
+            pColumn->variants.emplace_back(pColumn->texts[row]);
+            break;
+        case Type::Bytes:
+            pColumn->variants.emplace_back(pColumn->bytes[row]);
+            break;
+        default:
+            DEBUG_ASSERT(!"unreachable");
+            pColumn->variants.emplace_back();
+        }
+    }
+    pColumn->integers = {};
+    pColumn->reals = {};
+    pColumn->texts = {};
+    pColumn->bytes = {};
+    pColumn->type = Type::Variant;
+}
+
+// static
+void ColumnarValues::append(Column* pColumn, const QVariant& value, int rowCount) {
+    const Type type = typeOf(value);
+    if (type == Type::Null) {
+        pColumn->nulls.push_back(true);
+        switch (pColumn->type) {
+        case Type::Null:
+            break;
+        case Type::Integer:
+            pColumn->integers.emplace_back();
+            break;
+        case Type::Real:
+            pColumn->reals.emplace_back();
+            break;
+        case Type::Text:
+            pColumn->texts.emplace_back();
+            break;
+        case Type::Bytes:
+            pColumn->bytes.emplace_back();
+            break;
+        case Type::Variant:
+            pColumn->variants.emplace_back();
+            break;
+        }
+        return;
+    }
+    if (pColumn->type == Type::Null) {
+        setType(pColumn, type, rowCount);
+    } else if (pColumn->type != type && pColumn->type != Type::Variant) {
+        convertToVariants(pColumn);
+    }
+    pColumn->nulls.push_back(false);
+    switch (pColumn->type) {
+    case Type::Integer:
+        pColumn->integers.push_back(value.toLongLong());
+        break;
+    case Type::Real:
+        pColumn->reals.push_back(value.toDouble());
+        break;
+    case Type::Text:
+        pColumn->texts.push_back(value.toString());
+        break;
+    case Type::Bytes:
+        pColumn->bytes.push_back(value.toByteArray());
+        break;
+    case Type::Variant:
+        pColumn->variants.push_back(value);
+        break;
+    case Type::Null:
+        DEBUG_ASSERT(!"unreachable");
+        break;
+    }
+}
+
+void ColumnarValues::appendRow(const QVector<QVariant>& values) {
+    DEBUG_ASSERT(values.size() == columnCount());
+    for (int i = 0; i < columnCount(); ++i) {
+        append(&m_columns[i], values.value(i), m_rowCount);
+    }
+    ++m_rowCount;
+}
+
+QVariant ColumnarValues::value(int row, int column) const {
+    VERIFY_OR_DEBUG_ASSERT(row >= 0 && row < m_rowCount &&
+            column >= 0 && column < columnCount()) {
+        return QVariant();
+    }
+    const Column& values = m_columns[column];
+    if (values.nulls[row]) {
+        return QVariant();
+    }
+    switch (values.type) {
+    case Type::Integer:
+        return QVariant(values.integers[row]);
+    case Type::Real:
+        return QVariant(values.reals[row]);
+    case Type::Text:
+        return QVariant(values.texts[row]);
+    case Type::Bytes:
+        return QVariant(values.bytes[row]);
+    case Type::Variant:
+        return values.variants[row];
+    case Type::Null:
+        break;
+    }
+    return QVariant();
+}
+
+// static
+void ColumnarValues::appendFrom(Column* pColumn, const Column& source, int row) {
+    pColumn->nulls.push_back(source.nulls[row]);
+    switch (source.type) {
+    case Type::Integer:
+        pColumn->integers.push_back(source.integers[row]);
+        break;
+    case Type::Real:
+        pColumn->reals.push_back(source.reals[row]);
+        break;
+    case Type::Text:
+        pColumn->texts.push_back(source.texts[row]);
+        break;
+    case Type::Bytes:
+        pColumn->bytes.push_back(source.bytes[row]);
+        break;
+    case Type::Variant:
+        pColumn->variants.push_back(source.variants[row]);
+        break;
+    case Type::Null:
+        break;
+    }
+}
+
+ColumnarValues ColumnarValues::reordered(const std::vector<int>& rows) const {
+    ColumnarValues result(columnCount());
+    for (int i = 0; i < columnCount(); ++i) {
+        const Column& source = m_columns[i];
+        Column* pColumn = &result.m_columns[i];
+        pColumn->type = source.type;
+        pColumn->nulls.reserve(rows.size());
+        for (int row : rows) {
+            DEBUG_ASSERT(row >= 0 && row < m_rowCount);
+            appendFrom(pColumn, source, row);
+        }
+    }
+    result.m_rowCount = static_cast<int>(rows.size());
+    return result;
+}
+
+void ColumnarValues::moveRow(int fromRow, int toRow) {
+    VERIFY_OR_DEBUG_ASSERT(fromRow >= 0 && fromRow < m_rowCount &&
+            toRow >= 0 && toRow < m_rowCount) {
+        return;
+    }
+    if (fromRow == toRow) {
+        return;
+    }
+    for (auto& column : m_columns) {
+        moveElement(&column.nulls, fromRow, toRow);
+        switch (column.type) {
+        case Type::Integer:
+            moveElement(&column.integers, fromRow, toRow);
+            break;
+        case Type::Real:
+            moveElement(&column.reals, fromRow, toRow);
+            break;
+        case Type::Text:
+            moveElement(&column.texts, fromRow, toRow);
+            break;
+        case Type::Bytes:
+            moveElement(&column.bytes, fromRow, toRow);
+            break;
+        case Type::Variant:
+            moveElement(&column.variants, fromRow, toRow);
+            break;
+        case Type::Null:
+            break;
+        }
+    }
+}
+
+std::size_t ColumnarValues::memoryUsage() const {
+    std::size_t bytes = sizeof(*this) + m_columns.capacity() * sizeof(Column);
+    for (const auto& column : m_columns) {
+        bytes += column.nulls.capacity() / 8;
+        bytes += column.integers.capacity() * sizeof(qint64);
+        bytes += column.reals.capacity() * sizeof(double);
+        bytes += column.texts.capacity() * sizeof(QString);
+        for (const auto& text : column.texts) {
+            if (!text.isEmpty()) {
+                bytes += text.capacity() * sizeof(QChar);
+            }
+        }
+        bytes += column.bytes.capacity() * sizeof(QByteArray);
+        for (const auto& data : column.bytes) {
+            bytes += data.capacity();
+        }
+        bytes += column.variants.capacity() * sizeof(QVariant);
+    }
+    return bytes;
+}
+
+ColumnarTrackCache::ColumnarTrackCache(int maxRowCount)
+        : m_maxRowCount(maxRowCount),
+          m_nextBatchId(0),
+          m_useCounter(0) {
+    DEBUG_ASSERT(m_maxRowCount > 0);
+}
+
+bool ColumnarTrackCache::lookup(TrackId trackId, int column, QVariant* pValue) const {
+    const auto rowIt = m_rowsByTrackId.constFind(trackId);
+    if (rowIt == m_rowsByTrackId.constEnd()) {
+        return false;
+    }
+    const auto batchIt = m_batches.find(rowIt->batchId);
+    VERIFY_OR_DEBUG_ASSERT(batchIt != m_batches.end()) {
+        return false;
+    }
+    const Batch& batch = batchIt->second;
+    batch.lastUsed = ++m_useCounter;
+    if (column < 0 || column >= batch.values.columnCount()) {
+        *pValue = QVariant();
+    } else {
+        *pValue = batch.values.value(rowIt->row, column);
+    }
+    return true;
+}
+
+void ColumnarTrackCache::insert(const QVector<TrackId>& trackIds, ColumnarValues values) {
+    VERIFY_OR_DEBUG_ASSERT(trackIds.size() == values.rowCount()) {
+        return;
+    }
+    if (trackIds.isEmpty()) {
+        return;
+    }
+    // Replace previously cached values of the same tracks
+    remove(QSet<TrackId>(trackIds.begin(), trackIds.end()));
+
+    const int batchId = m_nextBatchId++;
+    for (int row = 0; row < trackIds.size(); ++row) {
+        m_rowsByTrackId.insert(trackIds[row], Row{batchId, row});
+    }
+    m_batches.emplace(batchId,
+            Batch{trackIds,
+                    std::move(values),
+                    static_cast<int>(trackIds.size()),
+                    ++m_useCounter});
+
+    // Never evict the batch that has just been inserted
+    while (rowCount() > m_maxRowCount && m_batches.size() > 1) {
+        evictLeastRecentlyUsed();
+    }
+}
+
+void ColumnarTrackCache::remove(const QSet<TrackId>& trackIds) {
+    for (const auto& trackId : trackIds) {
+        const auto rowIt = m_rowsByTrackId.find(trackId);
+        if (rowIt == m_rowsByTrackId.end()) {
+            continue;
+        }
+        // The values remain in the batch until all of its rows are removed
+        const auto batchIt = m_batches.find(rowIt->batchId);
+        if (batchIt != m_batches.end() && --batchIt->second.cachedRowCount <= 0) {
+            m_batches.erase(batchIt);
+        }
+        m_rowsByTrackId.erase(rowIt);
+    }
+}
+
+void ColumnarTrackCache::clear() {
+    m_batches.clear();
+    m_rowsByTrackId.clear();
+}
+
+void ColumnarTrackCache::evictLeastRecentlyUsed() {
+    DEBUG_ASSERT(!m_batches.empty());
+    auto evictIt = m_batches.begin();
+    for (auto it = m_batches.begin(); it != m_batches.end(); ++it) {
+        if (it->second.lastUsed < evictIt->second.lastUsed) {
+            evictIt = it;
+        }
+    }
+    const int batchId = evictIt->first;
+    for (const auto& trackId : std::as_const(evictIt->second.trackIds)) {
+        // Removed tracks might have been cached again in another batch
+        const auto rowIt = m_rowsByTrackId.find(trackId);
+        if (rowIt != m_rowsByTrackId.end() && rowIt->batchId == batchId) {
+            m_rowsByTrackId.erase(rowIt);
+        }
+    }
+    m_batches.erase(evictIt);
+}
+
+std::size_t ColumnarTrackCache::memoryUsage() const {
+    std::size_t bytes = sizeof(*this) +
+            m_rowsByTrackId.capacity() * (sizeof(TrackId) + sizeof(Row) + sizeof(void*));
+    for (const auto& batch : m_batches) {
+        bytes += batch.second.trackIds.capacity() * sizeof(TrackId);
+        bytes += batch.second.values.memoryUsage();
+    }
+    return bytes;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QMetaType>
+#include <QSet>
+#include <QString>
+#include <QVariant>
+#include <QVector>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "track/trackid.h"
+
+/// ColumnarValues stores the values of a table column by column in compact,
+/// typed arrays instead of a QVector<QVariant> per row. Integers, reals,
+/// strings and byte arrays each need a single array entry per row and a
+/// bit for NULL, which is only a fraction of the memory of a QVariant per
+/// value plus the overhead of a vector per row.
+///
+/// The type of a column is determined by its first non-NULL value. SQLite
+/// is dynamically typed, so a column with mixed types falls back to an
+/// array of QVariant.
+class ColumnarValues final {
+  public:
+    explicit ColumnarValues(int columnCount = 0);
+
+    int columnCount() const {
+        return static_cast<int>(m_columns.size());
+    }
+    int rowCount() const {
+        return m_rowCount;
+    }
+
+    void reserve(int rowCount);
+    /// Appends a row with the values of all columns
+    void appendRow(const QVector<QVariant>& values);
+
+    /// NULL values are returned as an invalid QVariant
+    QVariant value(int row, int column) const;
+
+    /// Returns the given rows in the given order
+    ColumnarValues reordered(const std::vector<int>& rows) const;
+    /// Moves a row to another position and shifts the rows in between
+    void moveRow(int fromRow, int toRow);
+
+    /// The approximate number of bytes allocated, including the contents
+    /// of strings and byte arrays
+    std::size_t memoryUsage() const;
+
+  private:
+    enum class Type {
+        Null,
+        Integer,
+        Real,
+        Text,
+        Bytes,
+        Variant,
+    };
+
+    struct Column {
+        Type type = Type::Null;
+        std::vector<bool> nulls;
+        // Only the array that matches the type is used
+        std::vector<qint64> integers;
+        std::vector<double> reals;
+        std::vector<QString> texts;
+        std::vector<QByteArray> bytes;
+        std::vector<QVariant> variants;
+    };
+
+    static Type typeOf(const QVariant& value);
+    static void setType(Column* pColumn, Type type, int rowCount);
+    static void convertToVariants(Column* pColumn);
+    static void append(Column* pColumn, const QVariant& value, int rowCount);
+    static void appendFrom(Column* pColumn, const Column& source, int row);
+
+    std::vector<Column> m_columns;
+    int m_rowCount;
+};
+
+Q_DECLARE_METATYPE(ColumnarValues)
+
+/// ColumnarTrackCache caches the column values of a bounded number of tracks
+/// in batches of ColumnarValues, i.e. in the order they have been fetched.
+/// The least recently used batches are evicted if the cache is full, so the
+/// memory doesn't depend on the size of the library.
+class ColumnarTrackCache final {
+  public:
+    explicit ColumnarTrackCache(int maxRowCount);
+
+    bool contains(TrackId trackId) const {
+        return m_rowsByTrackId.contains(trackId);
+    }
+    /// Returns false if the track is not cached
+    bool lookup(TrackId trackId, int column, QVariant* pValue) const;
+
+    /// The values are stored in the same order as trackIds
+    void insert(const QVector<TrackId>& trackIds, ColumnarValues values);
+    void remove(const QSet<TrackId>& trackIds);
+    void clear();
+
+    int rowCount() const {
+        return static_cast<int>(m_rowsByTrackId.size());
+    }
+    std::size_t memoryUsage() const;
+
+  private:
+    struct Batch {
+        QVector<TrackId> trackIds;
+        ColumnarValues values;
+        int cachedRowCount;
+        mutable std::uint64_t lastUsed;
+    };
+    struct Row {
+        int batchId;
+        int row;
+    };
+
+    void evictLeastRecentlyUsed();
+
+    const int m_maxRowCount;
+    int m_nextBatchId;
+    mutable std::uint64_t m_useCounter;
+    std::map<int, Batch> m_batches;
+    QHash<TrackId, Row> m_rowsByTrackId;
+};
@@ -2,8 +2,10 @@
 
 #include <QFutureWatcher>
 #include <QPixmapCache>
+#include <QThread>
 #include <QtConcurrentRun>
 #include <QtDebug>
+#include <algorithm>
 
 #include "moc_coverartcache.cpp"
 #include "track/track.h"
@@ -27,9 +29,32 @@ inline QImage resizeImageWidth(const QImage& image, int width) {
     return image.scaledToWidth(width, kTransformationMode);
 }
 
+// Decoding covers is CPU intensive and must not compete with the analysis
+// or the audio threads. While scrolling through a library only the covers
+// of the visible rows are needed anyway.
+int maxLoadThreadCount() {
+    return std::clamp(QThread::idealThreadCount() / 2, 1, 4);
+}
+
 } // anonymous namespace
 
-CoverArtCache::CoverArtCache() {
+CoverArtCache::CoverArtCache(const QString& thumbnailDirectory)
+        : m_startedLoads(0) {
+    m_loadPool.setObjectName(QStringLiteral("CoverArtCache"));
+    m_loadPool.setMaxThreadCount(maxLoadThreadCount());
+    if (!thumbnailDirectory.isEmpty()) {
+        m_pThumbnailStore = std::make_unique<CoverThumbnailStore>(thumbnailDirectory);
+        m_pruneFuture = QtConcurrent::run(
+                &m_loadPool,
+                [pThumbnailStore = m_pThumbnailStore.get()] {
+                    pThumbnailStore->prune();
+                });
+    }
+}
+
+CoverArtCache::~CoverArtCache() {
+    m_queuedLoads.clear();
+    m_loadPool.waitForDone();
 }
 
 //static
@@ -131,6 +156,39 @@ void CoverArtCache::requestUncachedCover(
             desiredWidth);
 }
 
+// static
+void CoverArtCache::cancelRequest(
+        const QObject* pRequester,
+        mixxx::cache_key_t cacheKey) {
+    CoverArtCache* pCache = CoverArtCache::instance();
+    VERIFY_OR_DEBUG_ASSERT(pCache) {
+        return;
+    }
+    const auto queued = std::find_if(
+            pCache->m_queuedLoads.begin(),
+            pCache->m_queuedLoads.end(),
+            [cacheKey](const LoadRequest& request) {
+                return request.coverInfo.cacheKey() == cacheKey;
+            });
+    if (queued == pCache->m_queuedLoads.end()) {
+        // Loads that have already been started are finished, cached and
+        // delivered as usual. Otherwise the same cover might be loaded
+        // concurrently when it is requested again.
+        return;
+    }
+    auto i = pCache->m_runningRequests.find(cacheKey);
+    while (i != pCache->m_runningRequests.end() && i.key() == cacheKey) {
+        if (i.value().pRequester == pRequester) {
+            i = pCache->m_runningRequests.erase(i);
+        } else {
+            ++i;
+        }
+    }
+    if (!pCache->m_runningRequests.contains(cacheKey)) {
+        pCache->m_queuedLoads.erase(queued);
+    }
+}
+
 void CoverArtCache::tryLoadCover(
         const QObject* pRequester,
         const TrackPointer& pTrack,
@@ -162,32 +220,43 @@ void CoverArtCache::tryLoadCover(
         return;
     }
 
-    if (kLogger.traceEnabled()) {
-        kLogger.trace()
-                << "requestCover starting future for"
-                << coverInfo;
-    }
+    m_queuedLoads.append({pTrack, coverInfo, desiredWidth});
+    startQueuedLoads();
+}
 
-    // The watcher will be deleted in coverLoaded()
-    QFutureWatcher<FutureResult>* watcher = new QFutureWatcher<FutureResult>(this);
-    QFuture<FutureResult> future = QtConcurrent::run(
-            &CoverArtCache::loadCover,
-            pTrack,
-            coverInfo,
-            desiredWidth);
-    connect(watcher,
-            &QFutureWatcher<FutureResult>::finished,
-            this,
-            &CoverArtCache::coverLoaded);
-    watcher->setFuture(future);
-    return;
+void CoverArtCache::startQueuedLoads() {
+    while (m_startedLoads < m_loadPool.maxThreadCount() && !m_queuedLoads.isEmpty()) {
+        const LoadRequest request = m_queuedLoads.takeLast();
+        if (kLogger.traceEnabled()) {
+            kLogger.trace()
+                    << "requestCover starting future for"
+                    << request.coverInfo;
+        }
+
+        // The watcher will be deleted in coverLoaded()
+        QFutureWatcher<FutureResult>* watcher = new QFutureWatcher<FutureResult>(this);
+        QFuture<FutureResult> future = QtConcurrent::run(
+                &m_loadPool,
+                &CoverArtCache::loadCover,
+                request.pTrack,
+                request.coverInfo,
+                request.desiredWidth,
+                m_pThumbnailStore.get());
+        connect(watcher,
+                &QFutureWatcher<FutureResult>::finished,
+                this,
+                &CoverArtCache::coverLoaded);
+        watcher->setFuture(future);
+        ++m_startedLoads;
+    }
 }
 
 //static
 CoverArtCache::FutureResult CoverArtCache::loadCover(
         TrackPointer pTrack,
         CoverInfo coverInfo,
-        int desiredWidth) {
+        int desiredWidth,
+        const CoverThumbnailStore* pThumbnailStore) {
     if (kLogger.traceEnabled()) {
         kLogger.trace()
                 << "loadCover"
@@ -200,6 +269,25 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
     auto res = FutureResult(
             coverInfo.cacheKey());
 
+    // Covers with a legacy hash are reloaded to update their digest
+    if (desiredWidth <= 0 || coverInfo.imageDigest().isEmpty()) {
+        pThumbnailStore = nullptr;
+    }
+    if (pThumbnailStore) {
+        QImage thumbnail = pThumbnailStore->load(res.requestedCacheKey, desiredWidth);
+        if (!thumbnail.isNull()) {
+            CoverInfo::LoadedImage loadedImage(CoverInfo::LoadedImage::Result::Ok);
+            loadedImage.image = std::move(thumbnail);
+            loadedImage.location = pThumbnailStore->filePath(
+                    res.requestedCacheKey, desiredWidth);
+            res.coverArt = CoverArt(
+                    std::move(coverInfo),
+                    std::move(loadedImage),
+                    desiredWidth);
+            return res;
+        }
+    }
+
     CoverInfo::LoadedImage loadedImage = coverInfo.loadImage(pTrack);
     if (!loadedImage.image.isNull()) {
         if (coverInfo.imageDigest().isEmpty()) {
@@ -221,6 +309,10 @@ CoverArtCache::FutureResult CoverArtCache::loadCover(
             // Adjust the cover size according to the request
             // or downsize the image for efficiency.
             loadedImage.image = resizeImageWidth(loadedImage.image, desiredWidth);
+            if (pThumbnailStore) {
+                pThumbnailStore->save(
+                        res.requestedCacheKey, desiredWidth, loadedImage.image);
+            }
         }
     }
 
@@ -243,6 +335,8 @@ void CoverArtCache::coverLoaded() {
         res = pFutureWatcher->result();
         pFutureWatcher->deleteLater();
     }
+    DEBUG_ASSERT(m_startedLoads > 0);
+    --m_startedLoads;
 
     if (kLogger.traceEnabled()) {
         kLogger.trace() << "coverLoaded" << res.coverArt;
@@ -310,4 +404,5 @@ void CoverArtCache::coverLoaded() {
         }
         ++i;
     }
+    startQueuedLoads();
 }
@@ -1,12 +1,17 @@
 #pragma once
 
+#include <QFuture>
+#include <QList>
 #include <QObject>
 #include <QPair>
 #include <QPixmap>
 #include <QSet>
+#include <QThreadPool>
 #include <QtDebug>
+#include <memory>
 
 #include "library/coverart.h"
+#include "library/coverthumbnailstore.h"
 #include "track/track_decl.h"
 #include "util/singleton.h"
 
@@ -37,6 +42,13 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
             const TrackPointer& pTrack,
             int desiredWidth);
 
+    /// Withdraws the requests of pRequester for the cover, e.g. if it is no
+    /// longer visible. Loading is only skipped if it hasn't been started yet
+    /// and no other requester is waiting for the cover.
+    static void cancelRequest(
+            const QObject* pRequester,
+            mixxx::cache_key_t cacheKey);
+
     // Only public for testing
     struct FutureResult {
         FutureResult()
@@ -49,12 +61,14 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
         mixxx::cache_key_t requestedCacheKey;
         CoverArt coverArt;
     };
-    // Load cover from path indicated in coverInfo. WARNING: This is run in a
-    // worker thread.
+    // Load cover from path indicated in coverInfo. Scaled covers are read
+    // from and written to the optional thumbnail store. WARNING: This is
+    // run in a worker thread.
     static FutureResult loadCover(
             TrackPointer pTrack,
             CoverInfo coverInfo,
-            int desiredWidth);
+            int desiredWidth,
+            const CoverThumbnailStore* pThumbnailStore = nullptr);
 
   private slots:
     // Called when loadCover is complete in the main thread.
@@ -67,8 +81,9 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
             const QPixmap& pixmap);
 
   protected:
-    CoverArtCache();
-    ~CoverArtCache() override = default;
+    /// Thumbnails are only stored on disk if a directory is given
+    explicit CoverArtCache(const QString& thumbnailDirectory = QString());
+    ~CoverArtCache() override;
     friend class Singleton<CoverArtCache>;
 
   private:
@@ -83,10 +98,28 @@ class CoverArtCache : public QObject, public Singleton<CoverArtCache> {
             const TrackPointer& pTrack,
             const CoverInfo& info,
             int desiredWidth);
+    void startQueuedLoads();
 
     struct RequestData {
         const QObject* pRequester;
         int desiredWidth;
     };
+    // The requests of all covers that are either queued or being loaded
     QMultiHash<mixxx::cache_key_t, RequestData> m_runningRequests;
+
+    struct LoadRequest {
+        TrackPointer pTrack;
+        CoverInfo coverInfo;
+        int desiredWidth;
+    };
+    // The loads that have not been started yet. The newest one is started
+    // first, because table views request the covers of the rows they paint
+    // and the rows painted last are those that are currently visible.
+    QList<LoadRequest> m_queuedLoads;
+    int m_startedLoads;
+
+    std::unique_ptr<CoverThumbnailStore> m_pThumbnailStore;
+    QFuture<void> m_pruneFuture;
+    // Declared last to finish all loads before the store is destroyed
+    QThreadPool m_loadPool;
 };
@@ -0,0 +1,140 @@
+#include "library/coverthumbnailstore.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QSaveFile>
+
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("CoverThumbnailStore");
+
+// Photos are stored lossy, images with transparency losslessly. The files
+// have no suffix and the format is detected from the contents when loading.
+const char* const kLossyFormat = "JPG";
+const char* const kLosslessFormat = "PNG";
+constexpr int kLossyQuality = 90;
+
+// Pruning leaves some room, so that the next thumbnails can be saved
+// without pruning again immediately
+qint64 pruneTargetBytes(qint64 maxBytes) {
+    return maxBytes - maxBytes / 4;
+}
+
+} // anonymous namespace
+
+CoverThumbnailStore::CoverThumbnailStore(
+        QString directory,
+        qint64 maxBytes)
+        : m_directory(std::move(directory)),
+          m_maxBytes(maxBytes),
+          m_totalBytes(0),
+          m_pruning(false) {
+    if (!QDir().mkpath(m_directory)) {
+        kLogger.warning()
+                << "Failed to create directory"
+                << m_directory;
+    }
+}
+
+QString CoverThumbnailStore::filePath(
+        mixxx::cache_key_t cacheKey,
+        int width) const {
+    return QDir(m_directory).filePath(
+            QStringLiteral("%1_%2")
+                    .arg(cacheKey, 16, 16, QChar('0'))
+                    .arg(width));
+}
+
+QImage CoverThumbnailStore::load(
+        mixxx::cache_key_t cacheKey,
+        int width) const {
+    const QString path = filePath(cacheKey, width);
+    QFile file(path);
+    if (!file.exists() || !file.open(QIODevice::ReadOnly)) {
+        return QImage();
+    }
+    // The modification time orders the thumbnails for prune()
+    file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    QImageReader reader(&file);
+    QImage image = reader.read();
+    if (image.isNull()) {
+        kLogger.warning()
+                << "Failed to read thumbnail"
+                << path
+                << reader.errorString();
+        // Don't try to read it again
+        file.close();
+        QFile::remove(path);
+    }
+    return image;
+}
+
+bool CoverThumbnailStore::save(
+        mixxx::cache_key_t cacheKey,
+        int width,
+        const QImage& image) const {
+    VERIFY_OR_DEBUG_ASSERT(!image.isNull()) {
+        return false;
+    }
+    // Writing to a temporary file and renaming it prevents that a
+    // concurrent load() reads a partially written thumbnail.
+    QSaveFile file(filePath(cacheKey, width));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    const bool saved = image.hasAlphaChannel()
+            ? image.save(&file, kLosslessFormat)
+            : image.save(&file, kLossyFormat, kLossyQuality);
+    const qint64 fileBytes = file.size();
+    if (!saved || !file.commit()) {
+        kLogger.warning()
+                << "Failed to write thumbnail"
+                << file.fileName();
+        return false;
+    }
+    if (m_totalBytes.fetch_add(fileBytes) + fileBytes > m_maxBytes) {
+        prune();
+    }
+    return true;
+}
+
+void CoverThumbnailStore::prune() const {
+    if (m_pruning.exchange(true)) {
+        return;
+    }
+    const QFileInfoList files = QDir(m_directory).entryInfoList(
+            QDir::Files, QDir::Time);
+    qint64 totalBytes = 0;
+    for (const auto& fileInfo : files) {
+        totalBytes += fileInfo.size();
+    }
+    int removed = 0;
+    if (totalBytes > m_maxBytes) {
+        // Most recently used first, see load()
+        const qint64 targetBytes = pruneTargetBytes(m_maxBytes);
+        qint64 keptBytes = 0;
+        for (const auto& fileInfo : files) {
+            keptBytes += fileInfo.size();
+            if (keptBytes > targetBytes && QFile::remove(fileInfo.filePath())) {
+                totalBytes -= fileInfo.size();
+                ++removed;
+            }
+        }
+    }
+    // Saves during pruning are not accounted for until the next prune()
+    m_totalBytes.store(totalBytes);
+    m_pruning.store(false);
+    if (removed > 0) {
+        kLogger.info()
+                << "Removed"
+                << removed
+                << "of"
+                << files.size()
+                << "thumbnails";
+    }
+}
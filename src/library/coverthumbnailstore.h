@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QImage>
+#include <QString>
+#include <atomic>
+
+#include "util/cache.h"
+
+/// CoverThumbnailStore keeps the scaled cover images of the library table on
+/// disk, so that they don't have to be extracted from the tags and decoded
+/// at full size again after a restart or an eviction from QPixmapCache.
+///
+/// The thumbnails are keyed by the cache key of the cover, which is derived
+/// from the digest of the original image, and the width. A changed cover gets
+/// a new key, so the thumbnails never need to be invalidated. All functions
+/// are thread-safe, they only access the files of the store.
+///
+/// The store is pruned whenever a saved thumbnail exceeds the maximum size.
+/// prune() needs to be invoked once initially to account for the thumbnails
+/// of previous sessions.
+class CoverThumbnailStore {
+  public:
+    static constexpr qint64 kDefaultMaxBytes = 64 * 1024 * 1024;
+
+    explicit CoverThumbnailStore(
+            QString directory,
+            qint64 maxBytes = kDefaultMaxBytes);
+
+    const QString& directory() const {
+        return m_directory;
+    }
+
+    QString filePath(
+            mixxx::cache_key_t cacheKey,
+            int width) const;
+
+    /// Returns a null image if no thumbnail has been stored. Marks the
+    /// thumbnail as recently used.
+    QImage load(
+            mixxx::cache_key_t cacheKey,
+            int width) const;
+
+    bool save(
+            mixxx::cache_key_t cacheKey,
+            int width,
+            const QImage& image) const;
+
+    /// Deletes the least recently used thumbnails if the store exceeds
+    /// maxBytes. Does nothing while another thread is pruning the store.
+    void prune() const;
+
+  private:
+    const QString m_directory;
+    const qint64 m_maxBytes;
+
+    // The approximate size of the store, which is corrected by prune()
+    mutable std::atomic<qint64> m_totalBytes;
+    mutable std::atomic<bool> m_pruning;
+};
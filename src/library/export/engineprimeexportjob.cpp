@@ -1,18 +1,26 @@
 #include "library/export/engineprimeexportjob.h"
 
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QFuture>
 #include <QHash>
+#include <QSaveFile>
 #include <QStringList>
+#include <QThreadPool>
+#include <QtConcurrentRun>
 #include <array>
 #include <cstdint>
 #include <memory>
 #include <stdexcept>
 
+#include "library/export/engineprimeexportmanifest.h"
 #include "library/export/engineprimeexportrequest.h"
 #include "library/trackcollection.h"
 #include "library/trackcollectionmanager.h"
 #include "library/trackset/crate/crate.h"
 #include "moc_engineprimeexportjob.cpp"
 #include "track/track.h"
+#include "util/performancetimer.h"
 #include "util/thread_affinity.h"
 #include "waveform/waveformfactory.h"
 
@@ -28,6 +36,17 @@ constexpr int kMaxHotCues = 8;
 
 constexpr uint8_t kDefaultWaveformOpacity = 127;
 
+// Number of tracks that are loaded from the Mixxx database, converted and
+// written to the Engine Library database at a time. The manifest is saved
+// after each batch.
+constexpr int kTrackBatchSize = 32;
+
+// Music files are usually copied to a USB stick, which gets slower with
+// more concurrent writes.
+constexpr int kMaxConcurrentFileCopies = 2;
+
+constexpr qint64 kFileCopyChunkBytes = 1024 * 1024;
+
 const QStringList kSupportedFileTypes = {
         "aac",
         "m4a",
@@ -72,7 +91,18 @@ std::optional<djinterop::musical_key> toDjinteropKey(
     return keyMap[key];
 }
 
-QString exportFile(const QSharedPointer<EnginePrimeExportRequest> pRequest,
+/// A music file of the export.
+struct ExportFile {
+    QString srcPath;
+    QString dstPath;
+    QString relativePath;
+    qint64 sizeInBytes;
+    bool needsCopy;
+    /// Whether a previous export has copied the file already
+    bool dstExists;
+};
+
+ExportFile prepareExportFile(const QSharedPointer<EnginePrimeExportRequest> pRequest,
         TrackPointer pTrack) {
     if (!pRequest->engineLibraryDbDir.exists()) {
         const auto msg = QStringLiteral(
@@ -93,13 +123,104 @@ QString exportFile(const QSharedPointer<EnginePrimeExportRequest> pRequest,
     mixxx::FileInfo srcFileInfo = pTrack->getFileInfo();
     QString dstFilename = pTrack->getId().toString() + " - " + srcFileInfo.fileName();
     QString dstPath = pRequest->musicFilesDir.filePath(dstFilename);
-    if (!QFile::exists(dstPath) ||
-            srcFileInfo.lastModified() > QFileInfo{dstPath}.lastModified()) {
-        const auto srcPath = srcFileInfo.location();
-        QFile::copy(srcPath, dstPath);
+    QFileInfo dstFileInfo{dstPath};
+    return ExportFile{
+            srcFileInfo.location(),
+            dstPath,
+            pRequest->engineLibraryDbDir.relativeFilePath(dstPath),
+            srcFileInfo.sizeInBytes(),
+            !dstFileInfo.exists() ||
+                    srcFileInfo.lastModified() > dstFileInfo.lastModified(),
+            dstFileInfo.exists()};
+}
+
+/// Runs on the file copy pool.
+bool copyExportFile(const ExportFile& file) {
+    QFile srcFile(file.srcPath);
+    if (!srcFile.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open" << file.srcPath << ":" << srcFile.errorString();
+        return false;
+    }
+    // The file is copied to a temporary file, which only replaces a previous
+    // copy once it is complete. The track in the Engine Library database
+    // keeps referring to the previous copy if copying fails.
+    QSaveFile dstFile(file.dstPath);
+    if (!dstFile.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to create" << file.dstPath << ":" << dstFile.errorString();
+        return false;
     }
+    while (!srcFile.atEnd()) {
+        const QByteArray chunk = srcFile.read(kFileCopyChunkBytes);
+        if (chunk.isEmpty() || dstFile.write(chunk) != chunk.size()) {
+            qWarning() << "Failed to copy" << file.srcPath << "to" << file.dstPath
+                       << ":" << srcFile.errorString() << dstFile.errorString();
+            dstFile.cancelWriting();
+            return false;
+        }
+    }
+    if (!dstFile.commit()) {
+        qWarning() << "Failed to replace" << file.dstPath << ":" << dstFile.errorString();
+        return false;
+    }
+    return true;
+}
 
-    return pRequest->engineLibraryDbDir.relativeFilePath(dstPath);
+/// Hashes everything that is exported for a track, so that tracks that are
+/// unchanged since the previous export can be skipped.
+QByteArray exportHash(
+        const e::engine_version& dbVersion,
+        const TrackPointer& pTrack,
+        const Waveform* pWaveform,
+        const ExportFile& file) {
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    const auto fileInfo = pTrack->getFileInfo();
+    stream << file.relativePath
+           << fileInfo.sizeInBytes()
+           << fileInfo.lastModified().toMSecsSinceEpoch()
+           << dbVersion.is_v2_schema()
+           << pTrack->getTrackNumber()
+           << pTrack->getDuration()
+           << pTrack->getBpm()
+           << pTrack->getYear()
+           << pTrack->getTitle()
+           << pTrack->getArtist()
+           << pTrack->getAlbum()
+           << pTrack->getGenre()
+           << pTrack->getComment()
+           << pTrack->getComposer()
+           << static_cast<qint32>(pTrack->getKey())
+           << static_cast<qint32>(pTrack->getBitrate())
+           << static_cast<qint32>(pTrack->getRating())
+           << static_cast<quint32>(pTrack->getSampleRate());
+
+    const auto mainCuePosition = pTrack->getMainCuePosition();
+    stream << (mainCuePosition.isValid() ? mainCuePosition.value() : 0.0);
+
+    const BeatsPointer pBeats = pTrack->getBeats();
+    stream << (pBeats ? pBeats->toByteArray() : QByteArray());
+
+    const auto cues = pTrack->getCuePoints();
+    for (const CuePointer& pCue : cues) {
+        if (pCue->getType() != CueType::HotCue) {
+            continue;
+        }
+        const auto position = pCue->getPosition();
+        stream << static_cast<qint32>(pCue->getHotCue())
+               << (position.isValid() ? position.value() : -1.0)
+               << pCue->getLabel()
+               << static_cast<quint32>(pCue->getColor());
+    }
+
+    // The waveform of an analysis doesn't change, unless the track is
+    // analyzed again and gets a new analysis id.
+    if (pWaveform) {
+        stream << static_cast<qint32>(pWaveform->getId())
+               << pWaveform->getVersion()
+               << static_cast<qint32>(pWaveform->getDataSize());
+    }
+
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1);
 }
 
 std::optional<djinterop::track> getTrackByRelativePath(
@@ -165,178 +286,215 @@ bool tryGetBeatgrid(BeatsPointer pBeats,
     return true;
 }
 
-void exportMetadata(
-        djinterop::database* pDatabase,
+/// The metadata of a track, converted for the Engine Library database.
+struct ConvertedTrack {
+    QString relativePath;
+
+    /// Holds all exported fields. The beat grid and the waveform are only
+    /// valid if the corresponding flag is set, and hot cues that don't exist
+    /// in Mixxx are std::nullopt.
+    djinterop::track_snapshot snapshot;
+    bool hasBeatgrid = false;
+    bool hasWaveform = false;
+
+    /// Set if the conversion has failed.
+    QString errorMessage;
+};
+
+/// Runs on the conversion pool. Must not access the Engine Library database.
+ConvertedTrack convertTrack(
         const e::engine_version& dbVersion,
-        QHash<TrackId, int64_t>* pMixxxToEnginePrimeTrackIdMap,
-        TrackPointer pTrack,
-        const Waveform* pWaveform,
+        const TrackPointer& pTrack,
+        const std::shared_ptr<const Waveform>& pWaveform,
         const QString& relativePath) {
-    // Attempt to load the track in the database, using the relative path to
-    // the music file.  If it exists already, take a snapshot of the track and
-    // update it.  If it does not exist, we'll create a new snapshot.
-    auto externalTrack = getTrackByRelativePath(pDatabase, relativePath);
-    auto snapshot = externalTrack
-            ? externalTrack->snapshot()
-            : djinterop::track_snapshot{};
+    ConvertedTrack converted;
+    converted.relativePath = relativePath;
+    auto& snapshot = converted.snapshot;
     snapshot.relative_path = relativePath.toStdString();
 
-    snapshot.track_number = pTrack->getTrackNumber().toInt();
-    if (snapshot.track_number == 0) {
-        snapshot.track_number = std::nullopt;
-    }
+    try {
+        snapshot.track_number = pTrack->getTrackNumber().toInt();
+        if (snapshot.track_number == 0) {
+            snapshot.track_number = std::nullopt;
+        }
 
-    snapshot.duration = std::chrono::milliseconds{
-            static_cast<int64_t>(1000 * pTrack->getDuration())};
-    snapshot.bpm = pTrack->getBpm();
-    snapshot.year = pTrack->getYear().toInt();
-    snapshot.title = pTrack->getTitle().toStdString();
-    snapshot.artist = pTrack->getArtist().toStdString();
-    snapshot.album = pTrack->getAlbum().toStdString();
-    snapshot.genre = pTrack->getGenre().toStdString();
-    snapshot.comment = pTrack->getComment().toStdString();
-    snapshot.composer = pTrack->getComposer().toStdString();
-    snapshot.key = toDjinteropKey(pTrack->getKey());
-    snapshot.bitrate = pTrack->getBitrate();
-    snapshot.rating = pTrack->getRating() * 20; // note rating is in range 0-100
-    snapshot.file_bytes = pTrack->getFileInfo().sizeInBytes();
-
-    // Frames used interchangeably with "samples" here.
-    const auto frameCount = static_cast<int64_t>(pTrack->getDuration() * pTrack->getSampleRate());
-    snapshot.sample_count = frameCount;
-    snapshot.sample_rate = pTrack->getSampleRate();
-
-    // Track loudness controls how the waveforms are scaled on Engine players.
-    // However, getting it wrong and accidentally scaling a waveform beyond a sensible maximum
-    // can result in no waveform being shown at all.  In order to be safe, no loudness information
-    // is exported, resulting in waveforms being displayed as-is.
-    snapshot.average_loudness = 0;
-
-    // Set main cue-point.
-    mixxx::audio::FramePos cuePlayPos = pTrack->getMainCuePosition();
-    const auto cuePlayPosValue = cuePlayPos.isValid() ? cuePlayPos.value() : 0;
-    snapshot.main_cue = cuePlayPosValue;
-
-    // Fill in beat grid.
-    BeatsPointer beats = pTrack->getBeats();
-    if (beats != nullptr) {
-        std::vector<djinterop::beatgrid_marker> beatgrid;
-        if (tryGetBeatgrid(beats, cuePlayPos, frameCount, &beatgrid)) {
-            snapshot.beatgrid = beatgrid;
+        snapshot.duration = std::chrono::milliseconds{
+                static_cast<int64_t>(1000 * pTrack->getDuration())};
+        snapshot.bpm = pTrack->getBpm();
+        snapshot.year = pTrack->getYear().toInt();
+        snapshot.title = pTrack->getTitle().toStdString();
+        snapshot.artist = pTrack->getArtist().toStdString();
+        snapshot.album = pTrack->getAlbum().toStdString();
+        snapshot.genre = pTrack->getGenre().toStdString();
+        snapshot.comment = pTrack->getComment().toStdString();
+        snapshot.composer = pTrack->getComposer().toStdString();
+        snapshot.key = toDjinteropKey(pTrack->getKey());
+        snapshot.bitrate = pTrack->getBitrate();
+        snapshot.rating = pTrack->getRating() * 20; // note rating is in range 0-100
+        snapshot.file_bytes = pTrack->getFileInfo().sizeInBytes();
+
+        // Frames used interchangeably with "samples" here.
+        const auto frameCount = static_cast<int64_t>(
+                pTrack->getDuration() * pTrack->getSampleRate());
+        snapshot.sample_count = frameCount;
+        snapshot.sample_rate = pTrack->getSampleRate();
+
+        // Track loudness controls how the waveforms are scaled on Engine players.
+        // However, getting it wrong and accidentally scaling a waveform beyond a sensible maximum
+        // can result in no waveform being shown at all.  In order to be safe, no loudness information
+        // is exported, resulting in waveforms being displayed as-is.
+        snapshot.average_loudness = 0;
+
+        // Set main cue-point.
+        mixxx::audio::FramePos cuePlayPos = pTrack->getMainCuePosition();
+        const auto cuePlayPosValue = cuePlayPos.isValid() ? cuePlayPos.value() : 0;
+        snapshot.main_cue = cuePlayPosValue;
+
+        // Fill in beat grid.
+        BeatsPointer beats = pTrack->getBeats();
+        if (beats != nullptr) {
+            std::vector<djinterop::beatgrid_marker> beatgrid;
+            if (tryGetBeatgrid(beats, cuePlayPos, frameCount, &beatgrid)) {
+                snapshot.beatgrid = beatgrid;
+                converted.hasBeatgrid = true;
+            } else {
+                qWarning() << "Beats data exists but is invalid for track"
+                           << pTrack->getId() << "("
+                           << pTrack->getFileInfo().fileName() << ")";
+            }
         } else {
-            qWarning() << "Beats data exists but is invalid for track"
-                       << pTrack->getId() << "("
-                       << pTrack->getFileInfo().fileName() << ")";
+            qInfo() << "No beats data found for track" << pTrack->getId()
+                    << "(" << pTrack->getFileInfo().fileName() << ")";
         }
-    } else {
-        qInfo() << "No beats data found for track" << pTrack->getId()
-                << "(" << pTrack->getFileInfo().fileName() << ")";
-    }
 
-    // Note that any existing hot cues on the track are kept in place, if Mixxx
-    // does not have a hot cue at that location.
-    const auto cues = pTrack->getCuePoints();
-    snapshot.hot_cues.resize(kMaxHotCues);
-    for (const CuePointer& pCue : cues) {
-        // We are only interested in hot cues.
-        if (pCue->getType() != CueType::HotCue) {
-            continue;
-        }
+        const auto cues = pTrack->getCuePoints();
+        snapshot.hot_cues.resize(kMaxHotCues);
+        for (const CuePointer& pCue : cues) {
+            // We are only interested in hot cues.
+            if (pCue->getType() != CueType::HotCue) {
+                continue;
+            }
 
-        int hotCueIndex = pCue->getHotCue(); // Note: Mixxx uses 0-based.
-        if (hotCueIndex < 0 || hotCueIndex >= kMaxHotCues) {
-            qInfo() << "Skipping hot cue" << hotCueIndex
-                    << "as the Engine Prime format only supports at most"
-                    << kMaxHotCues << "hot cues.";
-            continue;
-        }
+            int hotCueIndex = pCue->getHotCue(); // Note: Mixxx uses 0-based.
+            if (hotCueIndex < 0 || hotCueIndex >= kMaxHotCues) {
+                qInfo() << "Skipping hot cue" << hotCueIndex
+                        << "as the Engine Prime format only supports at most"
+                        << kMaxHotCues << "hot cues.";
+                continue;
+            }
 
-        if (!pCue->getPosition().isValid()) {
-            qWarning() << "Hot cue" << hotCueIndex << "exists but is invalid for track"
-                       << pTrack->getId() << "(" << pTrack->getFileInfo().fileName() << ")";
-            continue;
+            if (!pCue->getPosition().isValid()) {
+                qWarning() << "Hot cue" << hotCueIndex << "exists but is invalid for track"
+                           << pTrack->getId() << "(" << pTrack->getFileInfo().fileName() << ")";
+                continue;
+            }
+
+            QString label = pCue->getLabel();
+            if (label == "") {
+                label = QString("Cue %1").arg(hotCueIndex + 1);
+            }
+
+            djinterop::hot_cue hotCue{};
+            hotCue.label = label.toStdString();
+            hotCue.sample_offset = pCue->getPosition().value();
+
+            auto color = mixxx::RgbColor::toQColor(pCue->getColor());
+            hotCue.color = djinterop::pad_color{
+                    static_cast<uint_least8_t>(color.red()),
+                    static_cast<uint_least8_t>(color.green()),
+                    static_cast<uint_least8_t>(color.blue()),
+                    255};
+
+            snapshot.hot_cues[hotCueIndex] = hotCue;
         }
 
-        QString label = pCue->getLabel();
-        if (label == "") {
-            label = QString("Cue %1").arg(hotCueIndex + 1);
+        // TODO (mr-smidge): Export saved loops.
+
+        // Convert waveform.
+        if (pWaveform) {
+            djinterop::waveform_extents extents = dbVersion.is_v2_schema()
+                    ? e::calculate_overview_waveform_extents(
+                              frameCount, pTrack->getSampleRate())
+                    : e::calculate_high_resolution_waveform_extents(
+                              frameCount, pTrack->getSampleRate());
+            std::vector<djinterop::waveform_entry> externalWaveform;
+            externalWaveform.reserve(extents.size);
+            for (uint64_t i = 0; i < extents.size; ++i) {
+                uint64_t j = pWaveform->getDataSize() * i / extents.size;
+                externalWaveform.push_back({{pWaveform->getLow(j), kDefaultWaveformOpacity},
+                        {pWaveform->getMid(j), kDefaultWaveformOpacity},
+                        {pWaveform->getHigh(j), kDefaultWaveformOpacity}});
+            }
+            snapshot.waveform = std::move(externalWaveform);
+            converted.hasWaveform = true;
+        } else {
+            qInfo() << "No waveform data found for track" << pTrack->getId()
+                    << "(" << pTrack->getFileInfo().fileName() << ")";
         }
+    } catch (std::exception& e) {
+        converted.errorMessage = QString::fromStdString(e.what());
+    }
 
-        djinterop::hot_cue hotCue{};
-        hotCue.label = label.toStdString();
-        hotCue.sample_offset = pCue->getPosition().value();
+    return converted;
+}
 
-        auto color = mixxx::RgbColor::toQColor(pCue->getColor());
-        hotCue.color = djinterop::pad_color{
-                static_cast<uint_least8_t>(color.red()),
-                static_cast<uint_least8_t>(color.green()),
-                static_cast<uint_least8_t>(color.blue()),
-                255};
+/// Writes a converted track to the Engine Library database and returns its
+/// external track id.
+int64_t writeTrack(
+        djinterop::database* pDatabase,
+        const ConvertedTrack& converted) {
+    // Attempt to load the track in the database, using the relative path to
+    // the music file.  If it exists already, take a snapshot of the track and
+    // update it.  If it does not exist, we'll create a new snapshot.
+    auto externalTrack = getTrackByRelativePath(pDatabase, converted.relativePath);
+    auto snapshot = externalTrack
+            ? externalTrack->snapshot()
+            : djinterop::track_snapshot{};
 
-        snapshot.hot_cues[hotCueIndex] = hotCue;
+    const auto& src = converted.snapshot;
+    snapshot.relative_path = src.relative_path;
+    snapshot.track_number = src.track_number;
+    snapshot.duration = src.duration;
+    snapshot.bpm = src.bpm;
+    snapshot.year = src.year;
+    snapshot.title = src.title;
+    snapshot.artist = src.artist;
+    snapshot.album = src.album;
+    snapshot.genre = src.genre;
+    snapshot.comment = src.comment;
+    snapshot.composer = src.composer;
+    snapshot.key = src.key;
+    snapshot.bitrate = src.bitrate;
+    snapshot.rating = src.rating;
+    snapshot.file_bytes = src.file_bytes;
+    snapshot.sample_count = src.sample_count;
+    snapshot.sample_rate = src.sample_rate;
+    snapshot.average_loudness = src.average_loudness;
+    snapshot.main_cue = src.main_cue;
+    if (converted.hasBeatgrid) {
+        snapshot.beatgrid = src.beatgrid;
     }
 
-    // TODO (mr-smidge): Export saved loops.
-
-    // Write waveform.
-    if (pWaveform) {
-        djinterop::waveform_extents extents = dbVersion.is_v2_schema()
-                ? e::calculate_overview_waveform_extents(
-                          frameCount, pTrack->getSampleRate())
-                : e::calculate_high_resolution_waveform_extents(
-                          frameCount, pTrack->getSampleRate());
-        std::vector<djinterop::waveform_entry> externalWaveform;
-        externalWaveform.reserve(extents.size);
-        for (uint64_t i = 0; i < extents.size; ++i) {
-            uint64_t j = pWaveform->getDataSize() * i / extents.size;
-            externalWaveform.push_back({{pWaveform->getLow(j), kDefaultWaveformOpacity},
-                    {pWaveform->getMid(j), kDefaultWaveformOpacity},
-                    {pWaveform->getHigh(j), kDefaultWaveformOpacity}});
+    // Note that any existing hot cues on the track are kept in place, if Mixxx
+    // does not have a hot cue at that location.
+    snapshot.hot_cues.resize(kMaxHotCues);
+    for (int i = 0; i < kMaxHotCues; ++i) {
+        if (src.hot_cues[i]) {
+            snapshot.hot_cues[i] = src.hot_cues[i];
         }
-        snapshot.waveform = std::move(externalWaveform);
-    } else {
-        qInfo() << "No waveform data found for track" << pTrack->getId()
-                << "(" << pTrack->getFileInfo().fileName() << ")";
     }
 
-    int externalTrackId;
+    if (converted.hasWaveform) {
+        snapshot.waveform = src.waveform;
+    }
+
     if (externalTrack) {
         externalTrack->update(snapshot);
-        externalTrackId = externalTrack->id();
+        return externalTrack->id();
     } else {
         auto newTrack = pDatabase->create_track(snapshot);
-        externalTrackId = newTrack.id();
+        return newTrack.id();
     }
-
-    // Record the mapping from Mixxx track id to exported track id.
-    pMixxxToEnginePrimeTrackIdMap->insert(pTrack->getId(), externalTrackId);
-}
-
-void exportTrack(
-        const QSharedPointer<EnginePrimeExportRequest> pRequest,
-        djinterop::database* pDatabase,
-        const e::engine_version& dbVersion,
-        QHash<TrackId, int64_t>* pMixxxToEnginePrimeTrackIdMap,
-        const TrackPointer pTrack,
-        const Waveform* pWaveform) {
-    // Only export supported file types.
-    if (!kSupportedFileTypes.contains(pTrack->getType())) {
-        qInfo() << "Skipping file" << pTrack->getFileInfo().fileName()
-                << "(id" << pTrack->getId() << ") as its file type"
-                << pTrack->getType() << "is not supported";
-        return;
-    }
-
-    // Copy the file, if required.
-    const auto musicFileRelativePath = exportFile(pRequest, pTrack);
-
-    // Export meta-data.
-    exportMetadata(pDatabase,
-            dbVersion,
-            pMixxxToEnginePrimeTrackIdMap,
-            pTrack,
-            pWaveform,
-            musicFileRelativePath);
 }
 
 void exportCrate(
@@ -449,22 +607,29 @@ void EnginePrimeExportJob::loadIds(const QSet<CrateId>& crateIds) {
     }
 }
 
-void EnginePrimeExportJob::loadTrack(const TrackRef& trackRef) {
+void EnginePrimeExportJob::loadTracks(const QList<TrackRef>& trackRefs) {
     DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(m_pTrackCollectionManager);
 
-    // Load the track.
-    m_pLastLoadedTrack = m_pTrackCollectionManager->getOrAddTrack(trackRef);
-
-    // Load high-resolution waveform from analysis info.
+    m_lastLoadedTracks.clear();
+    m_lastLoadedTracks.reserve(trackRefs.size());
     auto& analysisDao = m_pTrackCollectionManager->internalCollection()->getAnalysisDAO();
-    const auto waveformAnalyses = analysisDao.getAnalysesForTrackByType(
-            m_pLastLoadedTrack->getId(), AnalysisDao::TYPE_WAVEFORM);
-    if (!waveformAnalyses.isEmpty()) {
-        const auto& waveformAnalysis = waveformAnalyses.first();
-        m_pLastLoadedWaveform.reset(
-                WaveformFactory::loadWaveformFromAnalysis(waveformAnalysis));
-    } else {
-        m_pLastLoadedWaveform.reset();
+    for (const auto& trackRef : trackRefs) {
+        // Load the track.
+        LoadedTrack loadedTrack;
+        loadedTrack.pTrack = m_pTrackCollectionManager->getOrAddTrack(trackRef);
+        VERIFY_OR_DEBUG_ASSERT(loadedTrack.pTrack) {
+            continue;
+        }
+
+        // Load high-resolution waveform from analysis info.
+        const auto waveformAnalyses = analysisDao.getAnalysesForTrackByType(
+                loadedTrack.pTrack->getId(), AnalysisDao::TYPE_WAVEFORM);
+        if (!waveformAnalyses.isEmpty()) {
+            const auto& waveformAnalysis = waveformAnalyses.first();
+            loadedTrack.pWaveform.reset(
+                    WaveformFactory::loadWaveformFromAnalysis(waveformAnalysis));
+        }
+        m_lastLoadedTracks.append(std::move(loadedTrack));
     }
 }
 
@@ -508,8 +673,8 @@ void EnginePrimeExportJob::run() {
     // Ensure that the database exists, creating an empty one if not.
     std::unique_ptr<djinterop::database> pDb;
     e::engine_version dbVersion;
+    bool created = false;
     try {
-        bool created;
         pDb = std::make_unique<djinterop::database>(e::create_or_load_database(
                 m_pRequest->engineLibraryDbDir.path().toStdString(),
                 m_pRequest->exportVersion,
@@ -532,49 +697,242 @@ void EnginePrimeExportJob::run() {
     // We will build up a map from Mixxx track id to EL track id during export.
     QHash<TrackId, int64_t> mixxxToEnginePrimeTrackIdMap;
 
-    for (const auto& trackRef : std::as_const(m_trackRefs)) {
-        // Load each track.
+    // Tracks that have been exported completely by a previous export and are
+    // unchanged since then are skipped.  A new database doesn't contain any
+    // of them.
+    EnginePrimeExportManifest manifest{m_pRequest->engineLibraryDbDir};
+    if (!created) {
+        manifest.load();
+    }
+
+    QThreadPool copyPool;
+    copyPool.setMaxThreadCount(kMaxConcurrentFileCopies);
+    QThreadPool conversionPool;
+    conversionPool.setMaxThreadCount(QThread::idealThreadCount());
+
+    // A music file that is still being copied to replace the copy of a
+    // previous export. Its track is recorded in the manifest when the copy
+    // has succeeded.
+    struct PendingCopy {
+        QFuture<bool> future;
+        QString relativePath;
+        qint64 sizeInBytes;
+        EnginePrimeExportManifest::Entry entry;
+    };
+    std::vector<PendingCopy> pendingCopies;
+
+    int numTracksWritten = 0;
+    int numTracksSkipped = 0;
+    int numCopiesFailed = 0;
+    qint64 bytesCopied = 0;
+    PerformanceTimer timer;
+    timer.start();
+
+    const auto collectFinishedCopies = [&](bool waitForAll) {
+        if (waitForAll) {
+            copyPool.waitForDone();
+        }
+        auto it = pendingCopies.begin();
+        while (it != pendingCopies.end()) {
+            if (!it->future.isFinished()) {
+                ++it;
+                continue;
+            }
+            if (it->future.result()) {
+                manifest.insert(it->relativePath, it->entry);
+                bytesCopied += it->sizeInBytes;
+            } else {
+                // Not recorded in the manifest, so the next export copies
+                // the file again
+                ++numCopiesFailed;
+            }
+            it = pendingCopies.erase(it);
+        }
+        manifest.save();
+    };
+
+    // Keeps the tracks that have been exported completely in the manifest,
+    // so that the next export resumes with the others.
+    const auto abortPendingWork = [&] {
+        conversionPool.clear();
+        conversionPool.waitForDone();
+        copyPool.clear();
+        collectFinishedCopies(true);
+    };
+
+    const auto reportThroughput = [&] {
+        const double seconds = timer.elapsed().toDoubleSeconds();
+        if (seconds <= 0) {
+            return;
+        }
+        emit jobThroughput(
+                (numTracksWritten + numTracksSkipped) / seconds,
+                bytesCopied / (1024.0 * 1024.0) / seconds);
+    };
+
+    // The file copies and conversions of a track, started before the first
+    // track of the batch is written to the database.
+    struct PendingTrack {
+        TrackPointer pTrack;
+        ExportFile file;
+        QByteArray exportHash;
+        QFuture<bool> copy;
+        QFuture<ConvertedTrack> conversion;
+    };
+
+    for (int batchStart = 0; batchStart < m_trackRefs.size(); batchStart += kTrackBatchSize) {
+        // Load the tracks of the batch.
         // Note that loading must happen on the same thread as the track collection
         // manager, which is not the same as this method's worker thread.
         QMetaObject::invokeMethod(
                 this,
-                "loadTrack",
+                "loadTracks",
                 Qt::BlockingQueuedConnection,
-                Q_ARG(TrackRef, trackRef));
+                Q_ARG(QList<TrackRef>, m_trackRefs.mid(batchStart, kTrackBatchSize)));
 
         if (m_cancellationRequested.loadAcquire() != 0) {
             qInfo() << "Cancelling export";
+            abortPendingWork();
             return;
         }
 
-        DEBUG_ASSERT(m_pLastLoadedTrack != nullptr);
+        std::vector<PendingTrack> pendingTracks;
+        pendingTracks.reserve(m_lastLoadedTracks.size());
+        for (const auto& loadedTrack : std::as_const(m_lastLoadedTracks)) {
+            const TrackPointer& pTrack = loadedTrack.pTrack;
+
+            // Only export supported file types.
+            if (!kSupportedFileTypes.contains(pTrack->getType())) {
+                qInfo() << "Skipping file" << pTrack->getFileInfo().fileName()
+                        << "(id" << pTrack->getId() << ") as its file type"
+                        << pTrack->getType() << "is not supported";
+                ++currProgress;
+                emit jobProgress(currProgress);
+                continue;
+            }
 
-        qInfo() << "Exporting track" << m_pLastLoadedTrack->getId().toString()
-                << "at" << m_pLastLoadedTrack->getFileInfo().location() << "...";
-        try {
-            exportTrack(m_pRequest,
-                    pDb.get(),
+            PendingTrack pendingTrack;
+            pendingTrack.pTrack = pTrack;
+            try {
+                pendingTrack.file = prepareExportFile(m_pRequest, pTrack);
+                pendingTrack.exportHash = exportHash(
+                        dbVersion, pTrack, loadedTrack.pWaveform.get(), pendingTrack.file);
+
+                const auto* pEntry = manifest.findUnchanged(
+                        pendingTrack.file.relativePath, pendingTrack.exportHash);
+                if (pEntry && !pendingTrack.file.needsCopy) {
+                    const auto externalTrack = getTrackByRelativePath(
+                            pDb.get(), pendingTrack.file.relativePath);
+                    if (externalTrack && externalTrack->id() == pEntry->externalTrackId) {
+                        mixxxToEnginePrimeTrackIdMap.insert(
+                                pTrack->getId(), pEntry->externalTrackId);
+                        ++numTracksSkipped;
+                        ++currProgress;
+                        emit jobProgress(currProgress);
+                        continue;
+                    }
+                }
+            } catch (std::exception& e) {
+                qWarning() << "Failed to export track"
+                           << pTrack->getId().toString() << ":"
+                           << e.what();
+                //: %1 is the artist %2 is the title and %3 is the original error message
+                m_lastErrorMessage = tr("Failed to export track %1 - %2:\n%3")
+                                             .arg(pTrack->getArtist(),
+                                                     pTrack->getTitle(),
+                                                     e.what());
+                abortPendingWork();
+                emit failed(m_lastErrorMessage);
+                return;
+            }
+
+            qInfo() << "Exporting track" << pTrack->getId().toString()
+                    << "at" << pTrack->getFileInfo().location() << "...";
+            if (pendingTrack.file.needsCopy) {
+                pendingTrack.copy = QtConcurrent::run(
+                        &copyPool,
+                        copyExportFile,
+                        pendingTrack.file);
+            }
+            pendingTrack.conversion = QtConcurrent::run(
+                    &conversionPool,
+                    convertTrack,
                     dbVersion,
-                    &mixxxToEnginePrimeTrackIdMap,
-                    m_pLastLoadedTrack,
-                    m_pLastLoadedWaveform.get());
-        } catch (std::exception& e) {
-            qWarning() << "Failed to export track"
-                       << m_pLastLoadedTrack->getId().toString() << ":"
-                       << e.what();
-            //: %1 is the artist %2 is the title and %3 is the original error message
-            m_lastErrorMessage = tr("Failed to export track %1 - %2:\n%3")
-                                         .arg(m_pLastLoadedTrack->getArtist(),
-                                                 m_pLastLoadedTrack->getTitle(),
-                                                 e.what());
-            emit failed(m_lastErrorMessage);
-            return;
+                    pTrack,
+                    loadedTrack.pWaveform,
+                    pendingTrack.file.relativePath);
+            pendingTracks.push_back(std::move(pendingTrack));
         }
+        m_lastLoadedTracks.clear();
+
+        // Write the converted tracks in order, while the following tracks of
+        // the batch are still being converted and the files are being copied.
+        for (auto& pendingTrack : pendingTracks) {
+            const bool replacesCopy = pendingTrack.file.dstExists;
+            if (pendingTrack.file.needsCopy && !replacesCopy) {
+                // The track must not refer to a music file that doesn't
+                // exist, so it is only written once its first copy is
+                // complete. Without a manifest entry the next export
+                // tries again.
+                if (!pendingTrack.copy.result()) {
+                    ++numCopiesFailed;
+                    ++currProgress;
+                    emit jobProgress(currProgress);
+                    continue;
+                }
+                bytesCopied += pendingTrack.file.sizeInBytes;
+            }
+            const ConvertedTrack converted = pendingTrack.conversion.result();
+            int64_t externalTrackId;
+            try {
+                if (!converted.errorMessage.isEmpty()) {
+                    throw std::runtime_error{converted.errorMessage.toStdString()};
+                }
+                externalTrackId = writeTrack(pDb.get(), converted);
+            } catch (std::exception& e) {
+                qWarning() << "Failed to export track"
+                           << pendingTrack.pTrack->getId().toString() << ":"
+                           << e.what();
+                //: %1 is the artist %2 is the title and %3 is the original error message
+                m_lastErrorMessage = tr("Failed to export track %1 - %2:\n%3")
+                                             .arg(pendingTrack.pTrack->getArtist(),
+                                                     pendingTrack.pTrack->getTitle(),
+                                                     e.what());
+                abortPendingWork();
+                emit failed(m_lastErrorMessage);
+                return;
+            }
 
-        m_pLastLoadedTrack.reset();
+            // Record the mapping from Mixxx track id to exported track id.
+            mixxxToEnginePrimeTrackIdMap.insert(pendingTrack.pTrack->getId(), externalTrackId);
+            ++numTracksWritten;
+
+            EnginePrimeExportManifest::Entry entry{pendingTrack.exportHash, externalTrackId};
+            if (pendingTrack.file.needsCopy && replacesCopy) {
+                pendingCopies.push_back(PendingCopy{pendingTrack.copy,
+                        pendingTrack.file.relativePath,
+                        pendingTrack.file.sizeInBytes,
+                        entry});
+            } else {
+                manifest.insert(pendingTrack.file.relativePath, entry);
+            }
 
-        ++currProgress;
-        emit jobProgress(currProgress);
+            ++currProgress;
+            emit jobProgress(currProgress);
+        }
+
+        collectFinishedCopies(false);
+        reportThroughput();
+    }
+
+    collectFinishedCopies(true);
+    reportThroughput();
+    qInfo() << "Exported" << numTracksWritten << "track(s) and skipped"
+            << numTracksSkipped << "unchanged track(s) in"
+            << timer.elapsed().formatSecondsWithUnit() << "with"
+            << bytesCopied / (1024 * 1024) << "MiB copied";
+    if (numCopiesFailed > 0) {
+        qWarning() << "Failed to copy the music files of" << numCopiesFailed << "track(s)";
     }
 
     // We will ensure that there is a special top-level crate representing the
@@ -652,8 +1010,8 @@ void EnginePrimeExportJob::run() {
         emit jobProgress(currProgress);
     }
 
-    qInfo() << "Engine Prime Export Job completed successfully";
-    emit completed(m_trackRefs.size(), m_crateIds.size());
+    qInfo() << "Engine Prime Export Job completed";
+    emit completed(m_trackRefs.size(), numTracksSkipped, m_crateIds.size(), numCopiesFailed);
 }
 
 void EnginePrimeExportJob::slotCancel() {
@@ -24,6 +24,12 @@ struct EnginePrimeExportRequest;
 /// library to an external Engine Prime (also known as "Engine Library")
 /// database, using the libdjinterop library, in accordance with the export
 /// request with which it is constructed.
+///
+/// The export is pipelined: tracks are loaded in batches, music files are
+/// copied on a small pool of threads while the metadata of the tracks is
+/// converted on a second pool, and the converted tracks are written to the
+/// database in batches on the job thread. Tracks that are unchanged since
+/// the previous export are skipped, see EnginePrimeExportManifest.
 class EnginePrimeExportJob : public QThread {
     Q_OBJECT
   public:
@@ -44,8 +50,17 @@ class EnginePrimeExportJob : public QThread {
     /// Informs of progress through the job, up to the pre-signalled maximum.
     void jobProgress(int progress);
 
-    /// Inform of a completed export job.
-    void completed(int numTracksExported, int numCratesExported);
+    /// Informs of the throughput of the export so far.
+    void jobThroughput(double tracksPerSecond, double megabytesPerSecond);
+
+    /// Inform of a completed export job. numTracksSkipped of the exported
+    /// tracks were unchanged since the previous export. The music files of
+    /// numCopiesFailed tracks could not be copied and are exported again by
+    /// the next job.
+    void completed(int numTracksExported,
+            int numTracksSkipped,
+            int numCratesExported,
+            int numCopiesFailed);
 
     /// Inform of a failed export job.
     void failed(const QString& message);
@@ -59,14 +74,18 @@ class EnginePrimeExportJob : public QThread {
     // thread of the application, which will be different to the worker thread
     // used by an instance of this class.
     void loadIds(const QSet<CrateId>& crateIdsToExport);
-    void loadTrack(const TrackRef& trackRef);
+    void loadTracks(const QList<TrackRef>& trackRefs);
     void loadCrate(const CrateId& crateId);
 
   private:
+    struct LoadedTrack {
+        TrackPointer pTrack;
+        std::shared_ptr<const Waveform> pWaveform;
+    };
+
     QList<TrackRef> m_trackRefs;
     QList<CrateId> m_crateIds;
-    TrackPointer m_pLastLoadedTrack;
-    std::unique_ptr<Waveform> m_pLastLoadedWaveform;
+    QList<LoadedTrack> m_lastLoadedTracks;
     Crate m_lastLoadedCrate;
     QList<TrackId> m_lastLoadedCrateTrackIds;
 
@@ -0,0 +1,115 @@
+#include "library/export/engineprimeexportmanifest.h"
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("EnginePrimeExportManifest");
+
+const QString kManifestFileName = QStringLiteral("mixxx-export-manifest.json");
+
+// Increment when the export hash or the exported metadata changes in a way
+// that requires all tracks to be exported again.
+constexpr int kManifestVersion = 1;
+
+const QString kVersionKey = QStringLiteral("version");
+const QString kTracksKey = QStringLiteral("tracks");
+const QString kPathKey = QStringLiteral("path");
+const QString kHashKey = QStringLiteral("hash");
+const QString kExternalIdKey = QStringLiteral("id");
+
+} // anonymous namespace
+
+EnginePrimeExportManifest::EnginePrimeExportManifest(const QDir& engineLibraryDbDir)
+        : m_filePath(engineLibraryDbDir.filePath(kManifestFileName)) {
+}
+
+void EnginePrimeExportManifest::load() {
+    m_entries.clear();
+
+    QFile file(m_filePath);
+    if (!file.exists()) {
+        return;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        kLogger.warning()
+                << "Failed to open"
+                << m_filePath
+                << file.errorString();
+        return;
+    }
+
+    QJsonParseError error;
+    const auto document = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError || !document.isObject()) {
+        kLogger.warning()
+                << "Ignoring invalid manifest"
+                << m_filePath
+                << error.errorString();
+        return;
+    }
+
+    const auto root = document.object();
+    if (root.value(kVersionKey).toInt() != kManifestVersion) {
+        kLogger.info()
+                << "Ignoring manifest of a different version"
+                << m_filePath;
+        return;
+    }
+
+    const auto tracks = root.value(kTracksKey).toArray();
+    m_entries.reserve(tracks.size());
+    for (const auto& value : tracks) {
+        const auto track = value.toObject();
+        const auto relativePath = track.value(kPathKey).toString();
+        const auto exportHash = QByteArray::fromHex(
+                track.value(kHashKey).toString().toLatin1());
+        if (relativePath.isEmpty() || exportHash.isEmpty()) {
+            continue;
+        }
+        m_entries.insert(relativePath,
+                Entry{exportHash,
+                        static_cast<int64_t>(
+                                track.value(kExternalIdKey).toDouble())});
+    }
+    kLogger.debug()
+            << "Loaded" << m_entries.size()
+            << "exported tracks from" << m_filePath;
+}
+
+bool EnginePrimeExportManifest::save() const {
+    QJsonArray tracks;
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        tracks.append(QJsonObject{
+                {kPathKey, it.key()},
+                {kHashKey, QString::fromLatin1(it.value().exportHash.toHex())},
+                {kExternalIdKey, static_cast<double>(it.value().externalTrackId)},
+        });
+    }
+    const QJsonObject root{
+            {kVersionKey, kManifestVersion},
+            {kTracksKey, tracks},
+    };
+
+    QSaveFile file(m_filePath);
+    if (!file.open(QIODevice::WriteOnly) ||
+            file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) < 0 ||
+            !file.commit()) {
+        kLogger.warning()
+                << "Failed to write"
+                << m_filePath
+                << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+} // namespace mixxx
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QByteArray>
+#include <QDir>
+#include <QHash>
+#include <QString>
+#include <cstdint>
+
+namespace mixxx {
+
+/// The manifest of an Engine Prime export records which tracks have been
+/// exported completely, i.e. their music file has been copied and their
+/// metadata has been written to the Engine Library database.
+///
+/// It is stored next to the database and makes exports incremental: a track
+/// is only exported again if its export hash has changed. An interrupted or
+/// canceled export resumes with the tracks that were not recorded yet.
+class EnginePrimeExportManifest {
+  public:
+    struct Entry {
+        QByteArray exportHash;
+        int64_t externalTrackId;
+    };
+
+    explicit EnginePrimeExportManifest(const QDir& engineLibraryDbDir);
+
+    QString filePath() const {
+        return m_filePath;
+    }
+
+    /// Reads the manifest from disk. A missing or unreadable manifest
+    /// results in an empty one, which exports all tracks again.
+    void load();
+
+    /// Writes the manifest to disk, replacing the previous file atomically.
+    bool save() const;
+
+    void clear() {
+        m_entries.clear();
+    }
+
+    /// Returns nullptr if the track has not been exported yet.
+    const Entry* find(const QString& relativePath) const {
+        const auto it = m_entries.constFind(relativePath);
+        return it != m_entries.constEnd() ? &it.value() : nullptr;
+    }
+
+    /// Returns nullptr if the track has not been exported yet or if it
+    /// has changed since then.
+    const Entry* findUnchanged(
+            const QString& relativePath,
+            const QByteArray& exportHash) const {
+        const Entry* pEntry = find(relativePath);
+        return pEntry && pEntry->exportHash == exportHash ? pEntry : nullptr;
+    }
+
+    void insert(const QString& relativePath, Entry entry) {
+        m_entries.insert(relativePath, std::move(entry));
+    }
+
+    int size() const {
+        return m_entries.size();
+    }
+
+  private:
+    const QString m_filePath;
+
+    // Keyed by the path of the music file relative to the database
+    QHash<QString, Entry> m_entries;
+};
+
+} // namespace mixxx
@@ -53,12 +53,27 @@ void LibraryExporter::beginEnginePrimeExport(
     connect(pJobThread,
             &EnginePrimeExportJob::completed,
             this,
-            [](int numTracks, int numCrates) {
+            [](int numTracks, int numTracksSkipped, int numCrates, int numCopiesFailed) {
+                QString message = QString{tr("Exported %1 track(s) and %2 crate(s).")}
+                                          .arg(numTracks)
+                                          .arg(numCrates);
+                if (numTracksSkipped > 0) {
+                    message += QChar('\n') +
+                            tr("%1 track(s) were unchanged since the previous export.")
+                                    .arg(numTracksSkipped);
+                }
+                if (numCopiesFailed > 0) {
+                    QMessageBox::warning(nullptr,
+                            tr("Export Completed"),
+                            message + QChar('\n') +
+                                    tr("Failed to copy the music files of %1 "
+                                       "track(s). Export again to retry.")
+                                            .arg(numCopiesFailed));
+                    return;
+                }
                 QMessageBox::information(nullptr,
                         tr("Export Completed"),
-                        QString{tr("Exported %1 track(s) and %2 crate(s).")}
-                                .arg(numTracks)
-                                .arg(numCrates));
+                        message);
             });
     connect(pJobThread,
             &EnginePrimeExportJob::failed,
@@ -79,6 +94,17 @@ void LibraryExporter::beginEnginePrimeExport(
             &EnginePrimeExportJob::jobProgress,
             pProgressDlg,
             &QProgressDialog::setValue);
+    connect(pJobThread,
+            &EnginePrimeExportJob::jobThroughput,
+            pProgressDlg,
+            [pProgressDlg = pProgressDlg.get()](
+                    double tracksPerSecond, double megabytesPerSecond) {
+                pProgressDlg->setLabelText(
+                        tr("Exporting to Engine Prime...\n"
+                           "%1 tracks/s, %2 MB/s")
+                                .arg(QString::number(tracksPerSecond, 'f', 1),
+                                        QString::number(megabytesPerSecond, 'f', 1)));
+            });
     connect(pJobThread, &EnginePrimeExportJob::finished, pProgressDlg, &QObject::deleteLater);
     connect(pProgressDlg,
             &QProgressDialog::canceled,
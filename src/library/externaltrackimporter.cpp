@@ -0,0 +1,283 @@
+#include "library/externaltrackimporter.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QtEndian>
+#include <algorithm>
+#include <utility>
+
+#include "library/dao/settingsdao.h"
+#include "library/queryutil.h"
+#include "util/assert.h"
+#include "util/fileinfo.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("ExternalTrackImporter");
+
+const QString kHashColumn = QStringLiteral("import_hash");
+const QString kIdColumn = QStringLiteral("id");
+
+// Older SQLite versions limit the number of bound values of a statement
+// to 999 (SQLITE_MAX_VARIABLE_NUMBER).
+constexpr int kMaxBoundValues = 999;
+constexpr int kMaxDeletedIdsPerQuery = 500;
+
+qint64 hashValues(const QVariantList& values) {
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    // Fixed, so that the hashes remain stable across Qt versions
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << values;
+    return qFromLittleEndian<qint64>(
+            QCryptographicHash::hash(data, QCryptographicHash::Sha1).constData());
+}
+
+QString importSourceSettingsKey(const QString& tableName) {
+    return QStringLiteral("mixxx.%1.import_source").arg(tableName);
+}
+
+QString sourceFileStamp(const QString& filePath) {
+    if (filePath.isEmpty()) {
+        return QString();
+    }
+    const mixxx::FileInfo fileInfo(filePath);
+    return QStringLiteral("%1:%2")
+            .arg(fileInfo.lastModified().toMSecsSinceEpoch())
+            .arg(fileInfo.sizeInBytes());
+}
+
+} // anonymous namespace
+
+ExternalTrackImporter::ExternalTrackImporter(
+        const QSqlDatabase& database,
+        const QString& tableName,
+        const QStringList& columns)
+        : m_database(database),
+          m_tableName(tableName),
+          m_columns(columns),
+          m_assignIds(columns.first() != kIdColumn),
+          m_insertBatchSize(std::max(1,
+                  kMaxBoundValues / (static_cast<int>(columns.size()) + 2))),
+          m_sourceFileUnchanged(false),
+          m_nextId(1),
+          m_failed(false),
+          m_insertedCount(0),
+          m_updatedCount(0),
+          m_unchangedCount(0) {
+    DEBUG_ASSERT(!columns.isEmpty());
+}
+
+bool ExternalTrackImporter::begin(const QString& sourceFilePath) {
+    m_tracks.clear();
+    m_pendingInserts.clear();
+    m_changedTrackIds.clear();
+    m_failed = false;
+    m_insertedCount = 0;
+    m_updatedCount = 0;
+    m_unchangedCount = 0;
+
+    QSqlQuery query(m_database);
+    query.setForwardOnly(true);
+    query.prepare(QStringLiteral("SELECT id, %1, %2 FROM %3")
+                          .arg(m_columns.first(), kHashColumn, m_tableName));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    int maxId = 0;
+    while (query.next()) {
+        const int id = query.value(0).toInt();
+        m_tracks.insert(query.value(1).toString(),
+                Track{id, query.value(2).toLongLong(), false});
+        maxId = std::max(maxId, id);
+    }
+    m_nextId = maxId + 1;
+
+    // The number of tracks is part of the stored state, in case the table
+    // has been modified by another version of Mixxx in the meantime.
+    m_sourceFileStamp = sourceFileStamp(sourceFilePath);
+    m_sourceFileUnchanged = !m_sourceFileStamp.isEmpty() &&
+            SettingsDAO(m_database).getValue(importSourceSettingsKey(m_tableName)) ==
+                    QStringLiteral("%1:%2").arg(m_sourceFileStamp).arg(m_tracks.size());
+
+    m_insertBatchQuery = prepareInsert(m_insertBatchSize);
+
+    QStringList assignments;
+    for (const auto& column : m_columns) {
+        assignments.append(column + QStringLiteral("=?"));
+    }
+    assignments.append(kHashColumn + QStringLiteral("=?"));
+    m_updateQuery = QSqlQuery(m_database);
+    m_updateQuery.prepare(QStringLiteral("UPDATE %1 SET %2 WHERE id=?")
+                                  .arg(m_tableName, assignments.join(',')));
+    return true;
+}
+
+QSqlQuery ExternalTrackImporter::prepareInsert(int rowCount) const {
+    QStringList columns = m_columns;
+    if (m_assignIds) {
+        columns.prepend(kIdColumn);
+    }
+    columns.append(kHashColumn);
+    QStringList placeholders;
+    placeholders.fill(QStringLiteral("?"), columns.size());
+    const QString row = QStringLiteral("(") + placeholders.join(',') + QStringLiteral(")");
+    QStringList rows;
+    rows.fill(row, rowCount);
+
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral("INSERT INTO %1 (%2) VALUES %3")
+                          .arg(m_tableName, columns.join(','), rows.join(',')));
+    return query;
+}
+
+void ExternalTrackImporter::keepAllTracks() {
+    for (auto& track : m_tracks) {
+        track.imported = true;
+    }
+    m_unchangedCount += static_cast<int>(m_tracks.size());
+}
+
+int ExternalTrackImporter::importTrack(const QVariantList& values) {
+    VERIFY_OR_DEBUG_ASSERT(values.size() == m_columns.size()) {
+        return -1;
+    }
+    if (m_failed) {
+        return -1;
+    }
+    const QString key = values.first().toString();
+    const qint64 hash = hashValues(values);
+
+    const auto it = m_tracks.find(key);
+    if (it != m_tracks.end()) {
+        it->imported = true;
+        if (it->hash == hash) {
+            ++m_unchangedCount;
+            return it->id;
+        }
+        int pos = 0;
+        for (const auto& value : values) {
+            m_updateQuery.bindValue(pos++, value);
+        }
+        m_updateQuery.bindValue(pos++, hash);
+        m_updateQuery.bindValue(pos++, it->id);
+        if (!m_updateQuery.exec()) {
+            LOG_FAILED_QUERY(m_updateQuery);
+            m_failed = true;
+            return -1;
+        }
+        it->hash = hash;
+        ++m_updatedCount;
+        m_changedTrackIds.append(it->id);
+        return it->id;
+    }
+
+    QVariantList row;
+    row.reserve(values.size() + 2);
+    int id;
+    if (m_assignIds) {
+        id = m_nextId++;
+        row.append(id);
+    } else {
+        bool ok = false;
+        id = values.first().toInt(&ok);
+        if (!ok) {
+            kLogger.warning() << "Invalid id of track in" << m_tableName << key;
+            return -1;
+        }
+    }
+    row += values;
+    row.append(hash);
+    m_pendingInserts.append(std::move(row));
+    m_tracks.insert(key, Track{id, hash, true});
+    m_changedTrackIds.append(id);
+    if (m_pendingInserts.size() >= m_insertBatchSize && !flushInserts()) {
+        // The ids of the whole batch have already been returned
+        return -1;
+    }
+    return id;
+}
+
+int ExternalTrackImporter::trackId(const QString& key) const {
+    const auto it = m_tracks.constFind(key);
+    if (it == m_tracks.constEnd()) {
+        return -1;
+    }
+    return it->id;
+}
+
+bool ExternalTrackImporter::flushInserts() {
+    if (m_pendingInserts.isEmpty()) {
+        return true;
+    }
+    QSqlQuery partialQuery;
+    QSqlQuery* pQuery = &m_insertBatchQuery;
+    if (m_pendingInserts.size() < m_insertBatchSize) {
+        partialQuery = prepareInsert(static_cast<int>(m_pendingInserts.size()));
+        pQuery = &partialQuery;
+    }
+    int pos = 0;
+    for (const auto& row : std::as_const(m_pendingInserts)) {
+        for (const auto& value : row) {
+            pQuery->bindValue(pos++, value);
+        }
+    }
+    const int rowCount = static_cast<int>(m_pendingInserts.size());
+    m_pendingInserts.clear();
+    if (!pQuery->exec()) {
+        LOG_FAILED_QUERY(*pQuery);
+        m_failed = true;
+        return false;
+    }
+    m_insertedCount += rowCount;
+    return true;
+}
+
+bool ExternalTrackImporter::deleteRemovedTracks() {
+    QStringList removedIds;
+    for (auto it = m_tracks.begin(); it != m_tracks.end();) {
+        if (it->imported) {
+            ++it;
+            continue;
+        }
+        removedIds.append(QString::number(it->id));
+        it = m_tracks.erase(it);
+    }
+    const int removedCount = static_cast<int>(removedIds.size());
+    for (int first = 0; first < removedCount; first += kMaxDeletedIdsPerQuery) {
+        QSqlQuery query(m_database);
+        query.prepare(QStringLiteral("DELETE FROM %1 WHERE id IN (%2)")
+                              .arg(m_tableName,
+                                      removedIds.mid(first, kMaxDeletedIdsPerQuery)
+                                              .join(',')));
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+            return false;
+        }
+    }
+    kLogger.info() << m_tableName << ":"
+                   << m_insertedCount << "inserted,"
+                   << m_updatedCount << "updated,"
+                   << m_unchangedCount << "unchanged,"
+                   << removedCount << "removed tracks";
+    return true;
+}
+
+bool ExternalTrackImporter::commit() {
+    if (m_failed) {
+        kLogger.warning() << "Not committing the failed import of" << m_tableName;
+        return false;
+    }
+    if (!flushInserts() || !deleteRemovedTracks()) {
+        return false;
+    }
+    // The state of the file when the import began, it might have been
+    // modified while it was parsed.
+    if (!m_sourceFileStamp.isEmpty()) {
+        SettingsDAO(m_database).setValue(importSourceSettingsKey(m_tableName),
+                QStringLiteral("%1:%2").arg(m_sourceFileStamp).arg(m_tracks.size()));
+    }
+    return true;
+}
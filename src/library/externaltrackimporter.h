@@ -0,0 +1,108 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+
+/// Writes the tracks of an external library (Traktor, iTunes, Rhythmbox)
+/// into its table while the library file is parsed in a single pass,
+/// instead of clearing the table and inserting every track with a query
+/// of its own.
+///
+/// Each row stores a hash of the imported values. Tracks that didn't
+/// change since the previous import are skipped and keep their id, new
+/// tracks are inserted in batches of multiple rows, changed tracks are
+/// updated, and commit() deletes the tracks that are no longer part of the
+/// library.
+///
+/// The importer doesn't start a transaction. The caller is expected to
+/// import the whole library inside of a single ScopedTransaction.
+class ExternalTrackImporter final {
+  public:
+    /// The first column identifies a track, e.g. "location" or the "id"
+    /// that the external library assigned. Unless it is "id", the ids of
+    /// new tracks are assigned by the importer.
+    ExternalTrackImporter(
+            const QSqlDatabase& database,
+            const QString& tableName,
+            const QStringList& columns);
+
+    /// Reads the ids and hashes of the tracks that have been imported
+    /// before, and compares the modification time and size of the library
+    /// file with the previous import. Without a file path the library is
+    /// never considered unchanged.
+    bool begin(const QString& sourceFilePath = QString());
+
+    /// Returns true if the library file is unchanged since the last
+    /// successful import, so parsing its tracks can be skipped.
+    bool isSourceFileUnchanged() const {
+        return m_sourceFileUnchanged;
+    }
+
+    /// Keeps all tracks of the previous import, e.g. after skipping the
+    /// tracks of an unchanged library file.
+    void keepAllTracks();
+
+    /// Imports a track with the values of the columns in the order that
+    /// was passed to the constructor. Returns the id of the track or -1.
+    /// After a failure all following imports and commit() fail, too, since
+    /// tracks that were imported before might not have been written.
+    int importTrack(const QVariantList& values);
+
+    /// Returns the id of a track that has been imported or kept, or -1.
+    int trackId(const QString& key) const;
+
+    /// Returns the ids of the tracks that have been inserted or updated
+    /// since begin(). Inserted tracks are only written by commit().
+    const QList<int>& changedTrackIds() const {
+        return m_changedTrackIds;
+    }
+
+    /// Writes the pending tracks, deletes the tracks that have not been
+    /// imported or kept and stores the state of the library file. Returns
+    /// false if any import failed, then the caller must roll back its
+    /// transaction.
+    bool commit();
+
+  private:
+    struct Track {
+        int id;
+        qint64 hash;
+        bool imported;
+    };
+
+    QSqlQuery prepareInsert(int rowCount) const;
+    bool flushInserts();
+    bool deleteRemovedTracks();
+
+    QSqlDatabase m_database;
+    const QString m_tableName;
+    const QStringList m_columns;
+    const bool m_assignIds;
+    const int m_insertBatchSize;
+
+    // The modification time and size of the library file
+    QString m_sourceFileStamp;
+    bool m_sourceFileUnchanged;
+
+    QHash<QString, Track> m_tracks;
+    int m_nextId;
+    QList<int> m_changedTrackIds;
+
+    // The values of each pending row, including the id if it is assigned
+    // by the importer and the hash
+    QList<QVariantList> m_pendingInserts;
+    QSqlQuery m_insertBatchQuery;
+    QSqlQuery m_updateQuery;
+
+    // Set if writing any track failed
+    bool m_failed;
+
+    int m_insertedCount;
+    int m_updatedCount;
+    int m_unchangedCount;
+};
@@ -4,6 +4,7 @@
 #include <QSqlQuery>
 #include <gsl/pointers>
 
+#include "library/externaltrackimporter.h"
 #include "library/itunes/ituneslocalhosttoken.h"
 #include "library/itunes/itunespathmapping.h"
 #include "library/queryutil.h"
@@ -40,20 +41,33 @@ std::ostream& operator<<(std::ostream& os, const ITunesPlaylist& playlist) {
     return os;
 }
 
+ITunesDAO::ITunesDAO() = default;
+
+ITunesDAO::~ITunesDAO() = default;
+
 void ITunesDAO::initialize(const QSqlDatabase& database) {
-    m_insertTrackQuery = QSqlQuery(database);
+    // The tracks are identified by the id that iTunes assigned
+    m_pTrackImporter = std::make_unique<ExternalTrackImporter>(database,
+            "itunes_library",
+            QStringList{"id",
+                    "artist",
+                    "title",
+                    "album",
+                    "album_artist",
+                    "genre",
+                    "grouping",
+                    "year",
+                    "duration",
+                    "location",
+                    "rating",
+                    "comment",
+                    "tracknumber",
+                    "bpm",
+                    "bitrate"});
     m_insertPlaylistQuery = QSqlQuery(database);
     m_insertPlaylistTrackQuery = QSqlQuery(database);
     m_applyPathMappingQuery = QSqlQuery(database);
 
-    m_insertTrackQuery.prepare(
-            "INSERT INTO itunes_library (id, artist, title, album, "
-            "album_artist, genre, grouping, year, duration, "
-            "location, rating, comment, tracknumber, bpm, bitrate) "
-            "VALUES (:id, :artist, :title, :album, :album_artist, "
-            ":genre, :grouping, :year, :duration, :location, "
-            ":rating, :comment, :tracknumber, :bpm, :bitrate)");
-
     m_insertPlaylistQuery.prepare("INSERT INTO itunes_playlists (id, name) VALUES (:id, :name)");
 
     m_insertPlaylistTrackQuery.prepare(
@@ -62,34 +76,54 @@ void ITunesDAO::initialize(const QSqlDatabase& database) {
 
     m_applyPathMappingQuery.prepare(
             "UPDATE itunes_library SET location = replace( location, "
-            ":itunes_path, :mixxx_path )");
+            ":itunes_path, :mixxx_path ) WHERE id = :id");
 
     m_isDatabaseInitialized = true;
 }
 
-bool ITunesDAO::importTrack(const ITunesTrack& track) {
+bool ITunesDAO::beginImport(const QString& libraryFilePath) {
     if (m_isDatabaseInitialized) {
-        QSqlQuery& query = m_insertTrackQuery;
-
-        query.bindValue(":id", track.id);
-        query.bindValue(":artist", track.artist);
-        query.bindValue(":title", track.title);
-        query.bindValue(":album", track.album);
-        query.bindValue(":album_artist", track.albumArtist);
-        query.bindValue(":genre", track.genre);
-        query.bindValue(":grouping", track.grouping);
-        query.bindValue(":year", track.year > 0 ? QVariant(track.year) : QVariant());
-        query.bindValue(":duration", track.duration);
-        query.bindValue(":location", track.location);
-        query.bindValue(":rating", track.rating);
-        query.bindValue(":comment", track.comment);
-        query.bindValue(":tracknumber",
-                track.trackNumber > 0 ? QVariant(track.trackNumber) : QVariant());
-        query.bindValue(":bpm", track.bpm);
-        query.bindValue(":bitrate", track.bitrate);
+        return m_pTrackImporter->begin(libraryFilePath);
+    }
 
-        if (!query.exec()) {
-            LOG_FAILED_QUERY(query);
+    return true;
+}
+
+bool ITunesDAO::keepTracksIfUnchanged() {
+    if (m_isDatabaseInitialized && m_pTrackImporter->isSourceFileUnchanged()) {
+        m_pTrackImporter->keepAllTracks();
+        return true;
+    }
+
+    return false;
+}
+
+bool ITunesDAO::finishImport() {
+    if (m_isDatabaseInitialized) {
+        return m_pTrackImporter->commit();
+    }
+
+    return true;
+}
+
+bool ITunesDAO::importTrack(const ITunesTrack& track) {
+    if (m_isDatabaseInitialized) {
+        const int id = m_pTrackImporter->importTrack({track.id,
+                track.artist,
+                track.title,
+                track.album,
+                track.albumArtist,
+                track.genre,
+                track.grouping,
+                track.year > 0 ? QVariant(track.year) : QVariant(),
+                track.duration,
+                track.location,
+                track.rating,
+                track.comment,
+                track.trackNumber > 0 ? QVariant(track.trackNumber) : QVariant(),
+                track.bpm,
+                track.bitrate});
+        if (id < 0) {
             return false;
         }
     }
@@ -141,15 +175,18 @@ bool ITunesDAO::importPlaylistTrack(int playlistId, int trackId, int position) {
 
 bool ITunesDAO::applyPathMapping(const ITunesPathMapping& pathMapping) {
     if (m_isDatabaseInitialized) {
-        QSqlQuery& query = m_insertPlaylistTrackQuery;
+        QSqlQuery& query = m_applyPathMappingQuery;
 
         query.bindValue(":itunes_path",
                 QString(pathMapping.dbITunesRoot).replace(kiTunesLocalhostToken, ""));
         query.bindValue(":mixxx_path", pathMapping.mixxxITunesRoot);
 
-        if (!query.exec()) {
-            LOG_FAILED_QUERY(query);
-            return false;
+        for (const int id : m_pTrackImporter->changedTrackIds()) {
+            query.bindValue(":id", id);
+            if (!query.exec()) {
+                LOG_FAILED_QUERY(query);
+                return false;
+            }
         }
     }
 
@@ -6,10 +6,12 @@
 #include <QString>
 #include <gsl/pointers>
 #include <map>
+#include <memory>
 #include <ostream>
 
 #include "library/dao/dao.h"
 
+class ExternalTrackImporter;
 class QSqlDatabase;
 struct ITunesPathMapping;
 class TreeItem;
@@ -88,14 +90,29 @@ std::ostream& operator<<(std::ostream& os, const ITunesPlaylist& playlist);
 /// the tree afterwards.
 class ITunesDAO : public DAO {
   public:
-    ~ITunesDAO() override = default;
+    ITunesDAO();
+    ~ITunesDAO() override;
 
     void initialize(const QSqlDatabase& database) override;
 
+    /// Starts an incremental import of the tracks. An empty file path
+    /// means that the library is not read from a file, e.g. through the
+    /// native iTunesLibrary framework on macOS.
+    virtual bool beginImport(const QString& libraryFilePath);
+    /// Returns true and keeps the previously imported tracks if the library
+    /// file didn't change, so its tracks don't need to be parsed.
+    virtual bool keepTracksIfUnchanged();
+    /// Writes the pending tracks and removes the tracks that are no longer
+    /// part of the library.
+    virtual bool finishImport();
+
     virtual bool importTrack(const ITunesTrack& track);
     virtual bool importPlaylist(const ITunesPlaylist& playlist);
     virtual bool importPlaylistRelation(int parentId, int childId);
     virtual bool importPlaylistTrack(int playlistId, int trackId, int position);
+    /// Maps the locations of the tracks that have been inserted or updated
+    /// by this import. The locations of unchanged tracks have already been
+    /// mapped by a previous import.
     virtual bool applyPathMapping(const ITunesPathMapping& pathMapping);
 
     virtual void appendPlaylistTree(gsl::not_null<TreeItem*> item,
@@ -113,7 +130,7 @@ class ITunesDAO : public DAO {
 
     // Note that these queries reference the database, which is expected
     // to outlive the DAO.
-    QSqlQuery m_insertTrackQuery;
+    std::unique_ptr<ExternalTrackImporter> m_pTrackImporter;
     QSqlQuery m_insertPlaylistQuery;
     QSqlQuery m_insertPlaylistTrackQuery;
     QSqlQuery m_applyPathMappingQuery;
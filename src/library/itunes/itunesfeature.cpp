@@ -168,10 +168,10 @@ void ITunesFeature::activate(bool forceReload) {
     //qDebug("ITunesFeature::activate()");
     if (!m_isActivated || forceReload) {
 
-        //Delete all table entries of iTunes feature
+        // Delete the playlists of the iTunes feature. The tracks are
+        // updated incrementally by the importer.
         ScopedTransaction transaction(m_database);
         clearTable("itunes_playlist_tracks");
-        clearTable("itunes_library");
         clearTable("itunes_playlists");
         transaction.commit();
 
@@ -266,7 +266,7 @@ void ITunesFeature::onRightClick(const QPoint& globalPos) {
     if (chosen == &useDefault) {
         SettingsDAO settings(m_database);
         settings.setValue(kItdbPathKey, QString());
-        activate(true); // clears tables before parsing
+        activate(true); // reimports the library
     } else if (chosen == &chooseNew) {
         SettingsDAO settings(m_database);
         QString dbfile = showOpenDialog();
@@ -283,7 +283,7 @@ void ITunesFeature::onRightClick(const QPoint& globalPos) {
         Sandbox::createSecurityToken(&dbFileInfo);
 
         settings.setValue(kItdbPathKey, dbfile);
-        activate(true); // clears tables before parsing
+        activate(true); // reimports the library
     }
 }
 
@@ -333,9 +333,14 @@ TreeItem* ITunesFeature::importLibrary() {
 
     std::unique_ptr<ITunesImporter> importer = makeImporter();
     ITunesImport iTunesImport = importer->importLibrary();
+    if (iTunesImport.writeFailed) {
+        // Rolls back the playlists, which might refer to tracks that have
+        // not been written
+        return nullptr;
+    }
 
-    // Even if an error occurred, commit the transaction. The file may have been
-    // half-parsed.
+    // Even if a parse error occurred, commit the transaction. The file may
+    // have been half-parsed.
     transaction.commit();
 
     return iTunesImport.playlistRoot.release();
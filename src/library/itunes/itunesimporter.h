@@ -7,6 +7,9 @@ class ITunesFeature;
 
 struct ITunesImport {
     std::unique_ptr<TreeItem> playlistRoot;
+    // Set if the tracks could not be written, then the import must be
+    // rolled back
+    bool writeFailed = false;
 };
 
 class ITunesImporter {
@@ -217,7 +217,9 @@ ITunesImport ITunesMacOSImporter::importLibrary() {
     ITLibrary* library = [[ITLibrary alloc] initWithAPIVersion:@"1.0"
                                                          error:&error];
 
-    if (library) {
+    // The library is not read from a file, so all media items are compared
+    // with the previous import.
+    if (library && m_dao->beginImport(QString())) {
         std::unique_ptr<TreeItem> rootItem =
                 TreeItem::newRoot(m_pParentFeature);
         ImporterImpl impl(this, *m_dao);
@@ -225,6 +227,10 @@ ITunesImport ITunesMacOSImporter::importLibrary() {
         impl.importPlaylists(library.allPlaylists);
         impl.importMediaItems(library.allMediaItems);
         impl.appendPlaylistTree(rootItem.get());
+        if (!canceled() && !m_dao->finishImport()) {
+            qWarning() << "Failed to write the iTunes tracks";
+            iTunesImport.writeFailed = true;
+        }
 
         iTunesImport.playlistRoot = std::move(rootItem);
     } else if (error) {
@@ -66,6 +66,7 @@ ITunesImport ITunesXMLImporter::importLibrary() {
 
     ITunesImport iTunesImport;
     bool isMusicFolderLocatedAfterTracks = false;
+    bool areTracksKept = false;
 
     // In sandboxed builds we have to obtain an access token
     auto access = mixxx::FileAccess(mixxx::FileInfo(m_xmlFilePath));
@@ -76,6 +77,10 @@ ITunesImport ITunesXMLImporter::importLibrary() {
         return iTunesImport;
     }
 
+    if (!m_dao->beginImport(m_xmlFilePath)) {
+        return iTunesImport;
+    }
+
     while (!m_xml.atEnd() && !canceled()) {
         m_xml.readNext();
         if (m_xml.isStartElement()) {
@@ -89,7 +94,15 @@ ITunesImport ITunesXMLImporter::importLibrary() {
                         guessMusicLibraryMountpoint();
                     }
                 } else if (key == "Tracks") {
-                    parseTracks();
+                    if (m_dao->keepTracksIfUnchanged()) {
+                        // Only the playlists need to be parsed again
+                        areTracksKept = true;
+                        if (readNextStartElement()) {
+                            m_xml.skipCurrentElement();
+                        }
+                    } else {
+                        parseTracks();
+                    }
                 } else if (key == "Playlists") {
                     parsePlaylists();
 
@@ -112,9 +125,15 @@ ITunesImport ITunesXMLImporter::importLibrary() {
         qDebug() << "line:" << m_xml.lineNumber()
                  << "column:" << m_xml.columnNumber()
                  << "error:" << m_xml.errorString();
+    } else if (!canceled() && !m_dao->finishImport()) {
+        qWarning() << "Failed to write the iTunes tracks";
+        iTunesImport.writeFailed = true;
+        return iTunesImport;
     }
 
-    if (isMusicFolderLocatedAfterTracks) {
+    // Only the locations of the tracks that have been written by this
+    // import are mapped, kept tracks have already been mapped before
+    if (isMusicFolderLocatedAfterTracks && !areTracksKept) {
         qDebug() << "Updating iTunes real path from "
                  << m_pathMapping.dbITunesRoot << " to "
                  << m_pathMapping.mixxxITunesRoot;
@@ -106,6 +106,9 @@ MixxxLibraryFeature::MixxxLibraryFeature(Library* pLibrary,
             std::move(columns),
             std::move(searchColumns),
             true);
+    // Only the visible tracks are fetched from large libraries. The fetcher
+    // needs its own instance of the temporary view.
+    pBaseTrackCache->fetchInBackground(pLibrary->dbConnectionPool(), queryString);
     m_pBaseTrackCache = QSharedPointer<BaseTrackCache>(pBaseTrackCache);
     m_pTrackCollection->connectTrackSource(m_pBaseTrackCache);
 
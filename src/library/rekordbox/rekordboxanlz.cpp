@@ -0,0 +1,207 @@
+#include "library/rekordbox/rekordboxanlz.h"
+
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+#include "util/assert.h"
+
+namespace mixxx {
+
+namespace rekordbox {
+
+namespace {
+
+// File header: magic "PMAI", len_header u4, len_file u4
+constexpr qint64 kFileHeaderMinSize = 12;
+constexpr quint32 kFileHeaderSizeOffset = 4;
+
+// Section header: fourcc u4, len_header u4, len_tag u4, followed by the body
+constexpr qint64 kSectionHeaderSize = 12;
+constexpr quint32 kSectionTagSizeOffset = 8;
+
+// Beat grid body: unknown u4, unknown u4, num_beats u4, followed by the
+// beats: beat_number u2, tempo u2, time u4
+constexpr quint32 kBeatGridCountOffset = 8;
+constexpr quint32 kBeatGridBeatsOffset = 12;
+constexpr quint32 kBeatSize = 8;
+constexpr quint32 kBeatTimeOffset = 4;
+
+// PCOB body: type u4, unknown 2 bytes, num_cues u2, memory_count u4,
+// followed by the entries
+constexpr quint32 kCueListCountOffset = 6;
+constexpr quint32 kCueListEntriesOffset = 12;
+// PCPT entry of a fixed size: magic, len_header u4, len_entry u4,
+// hot_cue u4, status u4, unknown u4, order_first u2, order_last u2, type u1,
+// unknown 3 bytes, time u4, loop_time u4, unknown 16 bytes
+constexpr quint32 kCueEntrySize = 56;
+constexpr quint32 kCueEntryHotCueOffset = 12;
+constexpr quint32 kCueEntryTypeOffset = 28;
+constexpr quint32 kCueEntryTimeOffset = 32;
+constexpr quint32 kCueEntryLoopTimeOffset = 36;
+
+// PCO2 body: type u4, num_cues u2, unknown 2 bytes, followed by the entries
+constexpr quint32 kCueExtendedListCountOffset = 4;
+constexpr quint32 kCueExtendedListEntriesOffset = 8;
+// PCP2 entry: magic, len_header u4, len_entry u4, hot_cue u4, type u1,
+// unknown 3 bytes, time u4, loop_time u4, color_id u1, unknown 7 bytes,
+// loop_numerator u2, loop_denominator u2, and if len_entry > 43:
+// len_comment u4, comment, color_code u1, color_red u1, color_green u1,
+// color_blue u1, unknown
+constexpr quint32 kCueExtendedEntryMinSize = 40;
+constexpr quint32 kCueExtendedEntryLengthOffset = 8;
+constexpr quint32 kCueExtendedEntryHotCueOffset = 12;
+constexpr quint32 kCueExtendedEntryTypeOffset = 16;
+constexpr quint32 kCueExtendedEntryTimeOffset = 20;
+constexpr quint32 kCueExtendedEntryLoopTimeOffset = 24;
+constexpr quint32 kCueExtendedEntryColorIdOffset = 28;
+constexpr quint32 kCueExtendedEntryCommentLengthOffset = 40;
+constexpr quint32 kCueExtendedEntryCommentOffset = 44;
+
+const char kFileMagic[] = "PMAI";
+const char kCueEntryMagic[] = "PCPT";
+const char kCueExtendedEntryMagic[] = "PCP2";
+
+bool hasMagic(const uchar* pData, const char* magic) {
+    return std::memcmp(pData, magic, 4) == 0;
+}
+
+} // anonymous namespace
+
+AnlzSectionIterator::AnlzSectionIterator(const uchar* pData, qint64 size)
+        : m_pData(nullptr),
+          m_size(0),
+          m_nextSection(0),
+          m_tag(0),
+          m_pBody(nullptr),
+          m_bodySize(0) {
+    if (!pData || size < kFileHeaderMinSize || !hasMagic(pData, kFileMagic)) {
+        return;
+    }
+    m_pData = pData;
+    m_size = size;
+    m_nextSection = qFromBigEndian<quint32>(pData + kFileHeaderSizeOffset);
+}
+
+bool AnlzSectionIterator::next() {
+    if (!m_pData || m_nextSection + kSectionHeaderSize > m_size) {
+        return false;
+    }
+    const uchar* pSection = m_pData + m_nextSection;
+    const quint32 tagSize = qFromBigEndian<quint32>(pSection + kSectionTagSizeOffset);
+    if (tagSize < kSectionHeaderSize || m_nextSection + tagSize > m_size) {
+        m_pData = nullptr;
+        return false;
+    }
+    m_tag = qFromBigEndian<quint32>(pSection);
+    m_pBody = pSection + kSectionHeaderSize;
+    m_bodySize = tagSize - kSectionHeaderSize;
+    m_nextSection += tagSize;
+    return true;
+}
+
+quint32 AnlzSectionIterator::bodyU32(quint32 offset) const {
+    if (offset + 4 > m_bodySize) {
+        return 0;
+    }
+    return qFromBigEndian<quint32>(m_pBody + offset);
+}
+
+quint16 AnlzSectionIterator::bodyU16(quint32 offset) const {
+    if (offset + 2 > m_bodySize) {
+        return 0;
+    }
+    return qFromBigEndian<quint16>(m_pBody + offset);
+}
+
+int AnlzSectionIterator::beatCount() const {
+    DEBUG_ASSERT(m_tag == static_cast<quint32>(AnlzSectionTag::BeatGrid));
+    if (m_bodySize < kBeatGridBeatsOffset) {
+        return 0;
+    }
+    return static_cast<int>(std::min(bodyU32(kBeatGridCountOffset),
+            (m_bodySize - kBeatGridBeatsOffset) / kBeatSize));
+}
+
+quint32 AnlzSectionIterator::beatTime(int index) const {
+    return bodyU32(kBeatGridBeatsOffset + index * kBeatSize + kBeatTimeOffset);
+}
+
+AnlzCueListType AnlzSectionIterator::cueListType() const {
+    return static_cast<AnlzCueListType>(bodyU32(0));
+}
+
+QList<AnlzCueEntry> AnlzSectionIterator::cueEntries() const {
+    QList<AnlzCueEntry> entries;
+    if (m_tag == static_cast<quint32>(AnlzSectionTag::Cues)) {
+        const int count = bodyU16(kCueListCountOffset);
+        quint32 pos = kCueListEntriesOffset;
+        for (int i = 0; i < count && pos + kCueEntrySize <= m_bodySize; ++i) {
+            const uchar* pEntry = m_pBody + pos;
+            if (!hasMagic(pEntry, kCueEntryMagic)) {
+                break;
+            }
+            AnlzCueEntry entry;
+            entry.hotCue = qFromBigEndian<quint32>(pEntry + kCueEntryHotCueOffset);
+            entry.type = static_cast<AnlzCueEntryType>(pEntry[kCueEntryTypeOffset]);
+            entry.time = qFromBigEndian<quint32>(pEntry + kCueEntryTimeOffset);
+            entry.loopTime = qFromBigEndian<quint32>(pEntry + kCueEntryLoopTimeOffset);
+            entries.append(std::move(entry));
+            pos += kCueEntrySize;
+        }
+    } else if (m_tag == static_cast<quint32>(AnlzSectionTag::Cues2)) {
+        const int count = bodyU16(kCueExtendedListCountOffset);
+        quint32 pos = kCueExtendedListEntriesOffset;
+        for (int i = 0; i < count && pos + kCueExtendedEntryMinSize <= m_bodySize; ++i) {
+            const uchar* pEntry = m_pBody + pos;
+            if (!hasMagic(pEntry, kCueExtendedEntryMagic)) {
+                break;
+            }
+            const quint32 entrySize = qFromBigEndian<quint32>(
+                    pEntry + kCueExtendedEntryLengthOffset);
+            AnlzCueEntry entry;
+            entry.hotCue = qFromBigEndian<quint32>(pEntry + kCueExtendedEntryHotCueOffset);
+            entry.type = static_cast<AnlzCueEntryType>(pEntry[kCueExtendedEntryTypeOffset]);
+            entry.time = qFromBigEndian<quint32>(pEntry + kCueExtendedEntryTimeOffset);
+            entry.loopTime = qFromBigEndian<quint32>(pEntry + kCueExtendedEntryLoopTimeOffset);
+            entry.colorId = pEntry[kCueExtendedEntryColorIdOffset];
+            quint32 consumed = kCueExtendedEntryMinSize;
+            if (entrySize > 43) {
+                if (pos + kCueExtendedEntryCommentOffset > m_bodySize) {
+                    break;
+                }
+                const quint32 commentSize = qFromBigEndian<quint32>(
+                        pEntry + kCueExtendedEntryCommentLengthOffset);
+                const quint32 colorsOffset = kCueExtendedEntryCommentOffset + commentSize;
+                if (commentSize > m_bodySize - pos - kCueExtendedEntryCommentOffset) {
+                    break;
+                }
+                entry.comment = QByteArray(
+                        reinterpret_cast<const char*>(pEntry + kCueExtendedEntryCommentOffset),
+                        static_cast<int>(commentSize));
+                // The colors follow the comment, if the entry is long enough.
+                const quint32 colorsSize = entrySize - std::min(entrySize, colorsOffset);
+                if (pos + colorsOffset + std::min<quint32>(colorsSize, 4) > m_bodySize) {
+                    break;
+                }
+                if (colorsSize > 1) {
+                    entry.colorRed = pEntry[colorsOffset + 1];
+                }
+                if (colorsSize > 2) {
+                    entry.colorGreen = pEntry[colorsOffset + 2];
+                }
+                if (colorsSize > 3) {
+                    entry.colorBlue = pEntry[colorsOffset + 3];
+                }
+                consumed = std::max(entrySize, colorsOffset);
+            }
+            entries.append(std::move(entry));
+            pos += consumed;
+        }
+    }
+    return entries;
+}
+
+} // namespace rekordbox
+
+} // namespace mixxx
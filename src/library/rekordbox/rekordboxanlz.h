@@ -0,0 +1,92 @@
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QtGlobal>
+
+// Decodes the beat grid and cue sections of a Rekordbox ANLZ analysis file
+// directly from its bytes, instead of building the object tree of the Kaitai
+// Struct parser rekordbox_anlz_t. Waveform and other sections are skipped
+// without being read.
+//
+// The layout is documented in lib/rekordbox-metadata/rekordbox_anlz.ksy.
+
+namespace mixxx {
+
+namespace rekordbox {
+
+enum class AnlzSectionTag : quint32 {
+    BeatGrid = 0x5051545a, // PQTZ
+    Cues = 0x50434f42,     // PCOB
+    Cues2 = 0x50434f32,    // PCO2
+};
+
+enum class AnlzCueListType : quint32 {
+    MemoryCues = 0,
+    HotCues = 1,
+};
+
+enum class AnlzCueEntryType : quint8 {
+    MemoryCue = 1,
+    Loop = 2,
+};
+
+/// An entry of a PCOB or PCO2 cue list. The comment and the colors are
+/// only contained in the extended entries of PCO2 sections.
+struct AnlzCueEntry {
+    quint32 hotCue = 0;
+    AnlzCueEntryType type = AnlzCueEntryType::MemoryCue;
+    /// Milliseconds
+    quint32 time = 0;
+    /// Milliseconds
+    quint32 loopTime = 0;
+    quint8 colorId = 0;
+    /// The raw UTF-16 bytes, including a trailing null character
+    QByteArray comment;
+    quint8 colorRed = 0;
+    quint8 colorGreen = 0;
+    quint8 colorBlue = 0;
+};
+
+/// Iterates over the tagged sections of an ANLZ file. It doesn't own the
+/// data, which must outlive the iterator.
+class AnlzSectionIterator {
+  public:
+    AnlzSectionIterator(const uchar* pData, qint64 size);
+
+    bool isValid() const {
+        return m_pData != nullptr;
+    }
+
+    /// Advances to the next section. Returns false at the end.
+    bool next();
+
+    quint32 tag() const {
+        return m_tag;
+    }
+
+    /// The number of beats of a PQTZ section
+    int beatCount() const;
+    /// The time of a beat of a PQTZ section in milliseconds
+    quint32 beatTime(int index) const;
+
+    /// The cue list type of a PCOB or PCO2 section
+    AnlzCueListType cueListType() const;
+    /// The entries of a PCOB or PCO2 section
+    QList<AnlzCueEntry> cueEntries() const;
+
+  private:
+    quint32 bodyU32(quint32 offset) const;
+    quint16 bodyU16(quint32 offset) const;
+
+    const uchar* m_pData;
+    qint64 m_size;
+    qint64 m_nextSection;
+    quint32 m_tag;
+    const uchar* m_pBody;
+    quint32 m_bodySize;
+};
+
+} // namespace rekordbox
+
+} // namespace mixxx
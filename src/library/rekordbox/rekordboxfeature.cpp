@@ -1,8 +1,6 @@
 #include "library/rekordbox/rekordboxfeature.h"
 
 #include <mp3guessenc.h>
-#include <rekordbox_anlz.h>
-#include <rekordbox_pdb.h>
 
 #include <QMap>
 #include <QMessageBox>
@@ -15,7 +13,9 @@
 #include "library/dao/trackschema.h"
 #include "library/library.h"
 #include "library/queryutil.h"
+#include "library/rekordbox/rekordboxanlz.h"
 #include "library/rekordbox/rekordboxconstants.h"
+#include "library/rekordbox/rekordboxpdb.h"
 #include "library/trackcollection.h"
 #include "library/trackcollectionmanager.h"
 #include "library/treeitem.h"
@@ -27,6 +27,7 @@
 #include "util/color/color.h"
 #include "util/db/dbconnectionpooled.h"
 #include "util/db/dbconnectionpooler.h"
+#include "util/mappedfile.h"
 #include "util/sandbox.h"
 #include "waveform/waveform.h"
 #include "widget/wlibrary.h"
@@ -250,40 +251,8 @@ QList<TreeItem*> findRekordboxDevices() {
     return foundDevices;
 }
 
-template<typename Base, typename T>
-inline bool instanceof (const T* ptr) {
-    return dynamic_cast<const Base*>(ptr) != nullptr;
-}
-
-QString toUnicode(const std::string& toConvert) {
-    return QTextCodec::codecForName("UTF-16LE")
-            ->toUnicode(toConvert.data(), static_cast<int>(toConvert.length()));
-}
-
-// Functions getText and parseDeviceDB are roughly based on the following Java file:
-// https://github.com/Deep-Symmetry/crate-digger/commit/f09fa9fc097a2a428c43245ddd542ac1370c1adc
-// getText is needed because the strings in the PDB file "have a variety of obscure representations".
-
-QString getText(rekordbox_pdb_t::device_sql_string_t* deviceString) {
-    QString text;
-
-    if (instanceof <rekordbox_pdb_t::device_sql_short_ascii_t>(deviceString->body())) {
-        rekordbox_pdb_t::device_sql_short_ascii_t* shortAsciiString =
-                static_cast<rekordbox_pdb_t::device_sql_short_ascii_t*>(deviceString->body());
-        text = QString::fromStdString(shortAsciiString->text());
-    } else if (instanceof <rekordbox_pdb_t::device_sql_long_ascii_t>(deviceString->body())) {
-        rekordbox_pdb_t::device_sql_long_ascii_t* longAsciiString =
-                static_cast<rekordbox_pdb_t::device_sql_long_ascii_t*>(deviceString->body());
-        text = QString::fromStdString(longAsciiString->text());
-    } else if (instanceof <rekordbox_pdb_t::device_sql_long_utf16le_t>(deviceString->body())) {
-        rekordbox_pdb_t::device_sql_long_utf16le_t* longUtf16leString =
-                static_cast<rekordbox_pdb_t::device_sql_long_utf16le_t*>(deviceString->body());
-        text = toUnicode(longUtf16leString->text());
-    }
-
-    // Some strings read from Rekordbox *.PDB files contain random null characters
-    // which if not removed cause Mixxx to crash when attempting to read file paths
-    return text.remove(QChar('\x0'));
+QString toUnicode(const QByteArray& toConvert) {
+    return QTextCodec::codecForName("UTF-16LE")->toUnicode(toConvert);
 }
 
 int createDevicePlaylist(QSqlDatabase& database, const QString& devicePath) {
@@ -344,7 +313,7 @@ mixxx::RgbColor colorFromID(int colorID) {
 
 void insertTrack(
         QSqlDatabase& database,
-        rekordbox_pdb_t::track_row_t* track,
+        const mixxx::rekordbox::PdbTrackRow& track,
         QSqlQuery& query,
         QSqlQuery& queryInsertIntoDevicePlaylistTracks,
         QMap<uint32_t, QString>& artistsMap,
@@ -354,21 +323,21 @@ void insertTrack(
         const QString& devicePath,
         const QString& device,
         int audioFilesCount) {
-    int rbID = static_cast<int>(track->id());
-    QString title = getText(track->title());
-    QString artist = artistsMap[track->artist_id()];
-    QString album = albumsMap[track->album_id()];
-    QString year = QString::number(track->year());
-    QString genre = genresMap[track->genre_id()];
-    QString location = devicePath + getText(track->file_path());
-    float bpm = static_cast<float>(track->tempo() / 100.0);
-    int bitrate = static_cast<int>(track->bitrate());
-    QString key = keysMap[track->key_id()];
-    int playtime = static_cast<int>(track->duration());
-    int rating = static_cast<int>(track->rating());
-    QString comment = getText(track->comment());
-    QString tracknumber = QString::number(track->track_number());
-    QString anlzPath = devicePath + getText(track->analyze_path());
+    int rbID = static_cast<int>(track.id);
+    QString title = track.title;
+    QString artist = artistsMap[track.artistId];
+    QString album = albumsMap[track.albumId];
+    QString year = QString::number(track.year);
+    QString genre = genresMap[track.genreId];
+    QString location = devicePath + track.filePath;
+    float bpm = static_cast<float>(track.tempo / 100.0);
+    int bitrate = static_cast<int>(track.bitrate);
+    QString key = keysMap[track.keyId];
+    int playtime = static_cast<int>(track.duration);
+    int rating = static_cast<int>(track.rating);
+    QString comment = track.comment;
+    QString tracknumber = QString::number(track.trackNumber);
+    QString anlzPath = devicePath + track.analyzePath;
 
     query.bindValue(":rb_id", rbID);
     query.bindValue(":artist", artist);
@@ -388,7 +357,7 @@ void insertTrack(
     query.bindValue(":device", device);
     query.bindValue(":color",
             mixxx::RgbColor::toQVariant(
-                    colorFromID(static_cast<int>(track->color_id()))));
+                    colorFromID(static_cast<int>(track.colorId))));
 
     if (!query.exec()) {
         LOG_FAILED_QUERY(query);
@@ -432,6 +401,8 @@ void buildPlaylistTree(
         const QString& playlistPath,
         const QString& device);
 
+// parseDeviceDB is roughly based on the following Java file:
+// https://github.com/Deep-Symmetry/crate-digger/commit/f09fa9fc097a2a428c43245ddd542ac1370c1adc
 QString parseDeviceDB(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* deviceItem) {
     QString device = deviceItem->getLabel();
     QString devicePath = deviceItem->getData().toList()[0].toString();
@@ -488,10 +459,14 @@ QString parseDeviceDB(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* dev
     if (!Sandbox::askForAccess(&fileInfo)) {
         return QString();
     }
-    std::ifstream ifs(dbPath.toStdString(), std::ifstream::binary);
-    kaitai::kstream ks(&ifs);
-
-    rekordbox_pdb_t rekordboxDB = rekordbox_pdb_t(&ks);
+    // The pages are decoded lazily straight from the mapped file, no object
+    // tree of the whole database is built.
+    const mixxx::MappedFile dbFile(dbPath);
+    const mixxx::rekordbox::PdbReader reader(dbFile.data(), dbFile.size());
+    if (!reader.isValid()) {
+        qWarning() << "Failed to read Rekordbox database" << dbPath;
+        return QString();
+    }
 
     // There are other types of tables (eg. COLOR), these are the only ones we are
     // interested at the moment. Perhaps when/if
@@ -500,17 +475,15 @@ QString parseDeviceDB(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* dev
     // Attempt was made to also recover HISTORY
     // playlists (which are found on removable Rekordbox devices), however
     // they didn't appear to contain valid row_ref_t structures.
-    constexpr int totalTables = 8;
-
-    rekordbox_pdb_t::page_type_t tableOrder[totalTables] = {
-            rekordbox_pdb_t::PAGE_TYPE_KEYS,
-            rekordbox_pdb_t::PAGE_TYPE_GENRES,
-            rekordbox_pdb_t::PAGE_TYPE_ARTISTS,
-            rekordbox_pdb_t::PAGE_TYPE_ALBUMS,
-            rekordbox_pdb_t::PAGE_TYPE_PLAYLIST_ENTRIES,
-            rekordbox_pdb_t::PAGE_TYPE_TRACKS,
-            rekordbox_pdb_t::PAGE_TYPE_PLAYLIST_TREE,
-            rekordbox_pdb_t::PAGE_TYPE_HISTORY};
+    using mixxx::rekordbox::PdbPageType;
+    const PdbPageType tableOrder[] = {
+            PdbPageType::Keys,
+            PdbPageType::Genres,
+            PdbPageType::Artists,
+            PdbPageType::Albums,
+            PdbPageType::PlaylistEntries,
+            PdbPageType::Tracks,
+            PdbPageType::PlaylistTree};
 
     QMap<uint32_t, QString> keysMap;
     QMap<uint32_t, QString> genresMap;
@@ -523,103 +496,62 @@ QString parseDeviceDB(mixxx::DbConnectionPoolPtr dbConnectionPool, TreeItem* dev
 
     bool folderOrPlaylistFound = false;
 
-    for (int tableOrderIndex = 0; tableOrderIndex < totalTables; tableOrderIndex++) {
-        for (const auto& table : *rekordboxDB.tables()) {
-            if (table->type() == tableOrder[tableOrderIndex]) {
-                uint16_t lastIndex = table->last_page()->index();
-                rekordbox_pdb_t::page_ref_t* currentRef = table->first_page();
-
-                while (true) {
-                    rekordbox_pdb_t::page_t* page = currentRef->body();
-
-                    if (page->is_data_page()) {
-                        for (const auto& rowgroup : *page->row_groups()) {
-                            for (const auto& rowRef : *rowgroup->rows()) {
-                                if (rowRef->present()) {
-                                    switch (tableOrder[tableOrderIndex]) {
-                                    case rekordbox_pdb_t::PAGE_TYPE_KEYS: {
-                                        auto* key =
-                                                static_cast<rekordbox_pdb_t::key_row_t*>(
-                                                        rowRef->body());
-                                        keysMap[key->id()] = getText(key->name());
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_GENRES: {
-                                        auto* genre =
-                                                static_cast<rekordbox_pdb_t::genre_row_t*>(
-                                                        rowRef->body());
-                                        genresMap[genre->id()] = getText(genre->name());
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_ARTISTS: {
-                                        auto* artist =
-                                                static_cast<rekordbox_pdb_t::artist_row_t*>(
-                                                        rowRef->body());
-                                        artistsMap[artist->id()] = getText(artist->name());
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_ALBUMS: {
-                                        auto* album =
-                                                static_cast<rekordbox_pdb_t::album_row_t*>(
-                                                        rowRef->body());
-                                        albumsMap[album->id()] = getText(album->name());
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_PLAYLIST_ENTRIES: {
-                                        auto* playlistEntry =
-                                                static_cast<rekordbox_pdb_t::playlist_entry_row_t*>(
-                                                        rowRef->body());
-                                        playlistTrackMap
-                                                [playlistEntry->playlist_id()]
-                                                [playlistEntry->entry_index()] =
-                                                        playlistEntry
-                                                                ->track_id();
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_TRACKS: {
-                                        insertTrack(database,
-                                                static_cast<rekordbox_pdb_t::track_row_t*>(
-                                                        rowRef->body()),
-                                                query,
-                                                queryInsertIntoDevicePlaylistTracks,
-                                                artistsMap,
-                                                albumsMap,
-                                                genresMap,
-                                                keysMap,
-                                                devicePath,
-                                                device,
-                                                audioFilesCount);
-
-                                        audioFilesCount++;
-                                    } break;
-                                    case rekordbox_pdb_t::PAGE_TYPE_PLAYLIST_TREE: {
-                                        auto* playlistTree =
-                                                static_cast<rekordbox_pdb_t::playlist_tree_row_t*>(
-                                                        rowRef->body());
-
-                                        playlistNameMap[playlistTree->id()] =
-                                                getText(playlistTree->name());
-                                        playlistIsFolderMap[playlistTree
-                                                                    ->id()] =
-                                                playlistTree->is_folder();
-                                        playlistTreeMap
-                                                [playlistTree->parent_id()]
-                                                [playlistTree->sort_order()] =
-                                                        playlistTree->id();
-
-                                        folderOrPlaylistFound = true;
-                                    } break;
-                                    default:
-                                        // we currently don't handle any other
-                                        // data, even though there is more.
-                                        break;
-                                    }
-                                }
-                            }
-                        }
-                    }
-
-                    if (currentRef->index() == lastIndex) {
-                        break;
-                    } else {
-                        currentRef = page->next_page();
-                    }
-                }
+    for (const PdbPageType type : tableOrder) {
+        for (auto it = reader.rows(type); it.next();) {
+            switch (type) {
+            case PdbPageType::Keys: {
+                auto key = mixxx::rekordbox::decodePdbNamedRow(type, it.row());
+                keysMap[key.id] = std::move(key.name);
+            } break;
+            case PdbPageType::Genres: {
+                auto genre = mixxx::rekordbox::decodePdbNamedRow(type, it.row());
+                genresMap[genre.id] = std::move(genre.name);
+            } break;
+            case PdbPageType::Artists: {
+                auto artist = mixxx::rekordbox::decodePdbNamedRow(type, it.row());
+                artistsMap[artist.id] = std::move(artist.name);
+            } break;
+            case PdbPageType::Albums: {
+                auto album = mixxx::rekordbox::decodePdbNamedRow(type, it.row());
+                albumsMap[album.id] = std::move(album.name);
+            } break;
+            case PdbPageType::PlaylistEntries: {
+                const auto playlistEntry =
+                        mixxx::rekordbox::decodePdbPlaylistEntryRow(it.row());
+                playlistTrackMap[playlistEntry.playlistId]
+                                [playlistEntry.entryIndex] =
+                                        playlistEntry.trackId;
+            } break;
+            case PdbPageType::Tracks: {
+                insertTrack(database,
+                        mixxx::rekordbox::decodePdbTrackRow(it.row()),
+                        query,
+                        queryInsertIntoDevicePlaylistTracks,
+                        artistsMap,
+                        albumsMap,
+                        genresMap,
+                        keysMap,
+                        devicePath,
+                        device,
+                        audioFilesCount);
+
+                audioFilesCount++;
+            } break;
+            case PdbPageType::PlaylistTree: {
+                auto playlistTree =
+                        mixxx::rekordbox::decodePdbPlaylistTreeRow(it.row());
+
+                playlistIsFolderMap[playlistTree.id] = playlistTree.isFolder;
+                playlistTreeMap[playlistTree.parentId][playlistTree.sortOrder] =
+                        playlistTree.id;
+                playlistNameMap[playlistTree.id] = std::move(playlistTree.name);
+
+                folderOrPlaylistFound = true;
+            } break;
+            default:
+                // we currently don't handle any other
+                // data, even though there is more.
+                break;
             }
         }
     }
@@ -874,31 +806,27 @@ void readAnalyze(TrackPointer track,
 
     qDebug() << "Rekordbox ANLZ path:" << anlzPath << " for: " << track->getTitle();
 
-    std::ifstream ifs(anlzPath.toStdString(), std::ifstream::binary);
-    kaitai::kstream ks(&ifs);
-
-    rekordbox_anlz_t anlz = rekordbox_anlz_t(&ks);
+    const mixxx::MappedFile anlzFile(anlzPath);
+    mixxx::rekordbox::AnlzSectionIterator section(anlzFile.data(), anlzFile.size());
 
     const double sampleRateKhz = sampleRate / 1000.0;
 
     QList<memory_cue_loop_t> memoryCuesAndLoops;
     int lastHotCueIndex = 0;
 
-    for (const auto& section : *anlz.sections()) {
-        switch (section->fourcc()) {
-        case rekordbox_anlz_t::SECTION_TAGS_BEAT_GRID: {
+    while (section.next()) {
+        switch (static_cast<mixxx::rekordbox::AnlzSectionTag>(section.tag())) {
+        case mixxx::rekordbox::AnlzSectionTag::BeatGrid: {
             if (!ignoreCues) {
                 break;
             }
 
-            auto* beatGridTag =
-                    static_cast<rekordbox_anlz_t::beat_grid_tag_t*>(
-                            section->body());
-
+            const int beatCount = section.beatCount();
             QVector<mixxx::audio::FramePos> beats;
+            beats.reserve(beatCount);
 
-            for (const auto& beat : *beatGridTag->beats()) {
-                int time = static_cast<int>(beat->time()) - timingOffset;
+            for (int beatIndex = 0; beatIndex < beatCount; ++beatIndex) {
+                int time = static_cast<int>(section.beatTime(beatIndex)) - timingOffset;
                 // Ensure no offset times are less than 1
                 if (time < 1) {
                     time = 1;
@@ -912,17 +840,21 @@ void readAnalyze(TrackPointer track,
                     mixxx::rekordboxconstants::beatsSubversion);
             track->trySetBeats(pBeats);
         } break;
-        case rekordbox_anlz_t::SECTION_TAGS_CUES: {
+        case mixxx::rekordbox::AnlzSectionTag::Cues:
+        case mixxx::rekordbox::AnlzSectionTag::Cues2: {
             if (ignoreCues) {
                 break;
             }
 
-            auto* cuesTag =
-                    static_cast<rekordbox_anlz_t::cue_tag_t*>(
-                            section->body());
+            // Only the extended entries of PCO2 sections carry a comment
+            // and colors.
+            const bool isExtended = static_cast<mixxx::rekordbox::AnlzSectionTag>(
+                                            section.tag()) ==
+                    mixxx::rekordbox::AnlzSectionTag::Cues2;
+            const auto cueListType = section.cueListType();
 
-            for (const auto& cueEntry : *cuesTag->cues()) {
-                int time = static_cast<int>(cueEntry->time()) - timingOffset;
+            for (const auto& cueEntry : section.cueEntries()) {
+                int time = static_cast<int>(cueEntry.time) - timingOffset;
                 // Ensure no offset times are less than 1
                 if (time < 1) {
                     time = 1;
@@ -930,83 +862,23 @@ void readAnalyze(TrackPointer track,
                 const auto position = mixxx::audio::FramePos(
                         sampleRateKhz * static_cast<double>(time));
 
-                switch (cuesTag->type()) {
-                case rekordbox_anlz_t::CUE_LIST_TYPE_MEMORY_CUES: {
-                    switch (cueEntry->type()) {
-                    case rekordbox_anlz_t::CUE_ENTRY_TYPE_MEMORY_CUE: {
+                switch (cueListType) {
+                case mixxx::rekordbox::AnlzCueListType::MemoryCues: {
+                    switch (cueEntry.type) {
+                    case mixxx::rekordbox::AnlzCueEntryType::MemoryCue: {
                         memory_cue_loop_t memoryCue;
                         memoryCue.startPosition = position;
                         memoryCue.endPosition = mixxx::audio::kInvalidFramePos;
-                        memoryCue.color = mixxx::RgbColor::nullopt();
-                        memoryCuesAndLoops << memoryCue;
-                    } break;
-                    case rekordbox_anlz_t::CUE_ENTRY_TYPE_LOOP: {
-                        int endTime = static_cast<int>(cueEntry->loop_time()) - timingOffset;
-                        // Ensure no offset times are less than 1
-                        if (endTime < 1) {
-                            endTime = 1;
+                        if (isExtended) {
+                            memoryCue.comment = toUnicode(cueEntry.comment);
+                            memoryCue.color = colorFromID(static_cast<int>(cueEntry.colorId));
+                        } else {
+                            memoryCue.color = mixxx::RgbColor::nullopt();
                         }
-
-                        memory_cue_loop_t loop;
-                        loop.startPosition = position;
-                        loop.endPosition = mixxx::audio::FramePos(
-                                sampleRateKhz * static_cast<double>(endTime));
-                        loop.color = mixxx::RgbColor::nullopt();
-                        memoryCuesAndLoops << loop;
-                    } break;
-                    }
-                } break;
-                case rekordbox_anlz_t::CUE_LIST_TYPE_HOT_CUES: {
-                    int hotCueIndex = static_cast<int>(cueEntry->hot_cue() - 1);
-                    if (hotCueIndex > lastHotCueIndex) {
-                        lastHotCueIndex = hotCueIndex;
-                    }
-                    setHotCue(
-                            track,
-                            position,
-                            mixxx::audio::kInvalidFramePos,
-                            hotCueIndex,
-                            QString(),
-                            mixxx::RgbColor::nullopt());
-                } break;
-                }
-            }
-        } break;
-        case rekordbox_anlz_t::SECTION_TAGS_CUES_2: {
-            if (ignoreCues) {
-                break;
-            }
-
-            auto* cuesExtendedTag =
-                    static_cast<rekordbox_anlz_t::cue_extended_tag_t*>(
-                            section->body());
-
-            for (const auto& cueExtendedEntry : *cuesExtendedTag->cues()) {
-                int time = static_cast<int>(cueExtendedEntry->time()) - timingOffset;
-                // Ensure no offset times are less than 1
-                if (time < 1) {
-                    time = 1;
-                }
-                const auto position = mixxx::audio::FramePos(
-                        sampleRateKhz * static_cast<double>(time));
-
-                switch (cuesExtendedTag->type()) {
-                case rekordbox_anlz_t::CUE_LIST_TYPE_MEMORY_CUES: {
-                    switch (cueExtendedEntry->type()) {
-                    case rekordbox_anlz_t::CUE_ENTRY_TYPE_MEMORY_CUE: {
-                        memory_cue_loop_t memoryCue;
-                        memoryCue.startPosition = position;
-                        memoryCue.endPosition = mixxx::audio::kInvalidFramePos;
-                        memoryCue.comment = toUnicode(cueExtendedEntry->comment());
-                        memoryCue.color = colorFromID(static_cast<int>(
-                                cueExtendedEntry->color_id()));
                         memoryCuesAndLoops << memoryCue;
                     } break;
-                    case rekordbox_anlz_t::CUE_ENTRY_TYPE_LOOP: {
-                        int endTime =
-                                static_cast<int>(
-                                        cueExtendedEntry->loop_time()) -
-                                timingOffset;
+                    case mixxx::rekordbox::AnlzCueEntryType::Loop: {
+                        int endTime = static_cast<int>(cueEntry.loopTime) - timingOffset;
                         // Ensure no offset times are less than 1
                         if (endTime < 1) {
                             endTime = 1;
@@ -1016,29 +888,40 @@ void readAnalyze(TrackPointer track,
                         loop.startPosition = position;
                         loop.endPosition = mixxx::audio::FramePos(
                                 sampleRateKhz * static_cast<double>(endTime));
-                        loop.comment = toUnicode(cueExtendedEntry->comment());
-                        loop.color = colorFromID(static_cast<int>(cueExtendedEntry->color_id()));
+                        if (isExtended) {
+                            loop.comment = toUnicode(cueEntry.comment);
+                            loop.color = colorFromID(static_cast<int>(cueEntry.colorId));
+                        } else {
+                            loop.color = mixxx::RgbColor::nullopt();
+                        }
                         memoryCuesAndLoops << loop;
                     } break;
                     }
                 } break;
-                case rekordbox_anlz_t::CUE_LIST_TYPE_HOT_CUES: {
-                    int hotCueIndex = static_cast<int>(cueExtendedEntry->hot_cue() - 1);
+                case mixxx::rekordbox::AnlzCueListType::HotCues: {
+                    int hotCueIndex = static_cast<int>(cueEntry.hotCue - 1);
                     if (hotCueIndex > lastHotCueIndex) {
                         lastHotCueIndex = hotCueIndex;
                     }
-                    setHotCue(track,
-                            position,
-                            mixxx::audio::kInvalidFramePos,
-                            hotCueIndex,
-                            toUnicode(cueExtendedEntry->comment()),
-                            mixxx::RgbColor(qRgb(
-                                    static_cast<int>(
-                                            cueExtendedEntry->color_red()),
-                                    static_cast<int>(
-                                            cueExtendedEntry->color_green()),
-                                    static_cast<int>(cueExtendedEntry
-                                                             ->color_blue()))));
+                    if (isExtended) {
+                        setHotCue(track,
+                                position,
+                                mixxx::audio::kInvalidFramePos,
+                                hotCueIndex,
+                                toUnicode(cueEntry.comment),
+                                mixxx::RgbColor(qRgb(
+                                        static_cast<int>(cueEntry.colorRed),
+                                        static_cast<int>(cueEntry.colorGreen),
+                                        static_cast<int>(cueEntry.colorBlue))));
+                    } else {
+                        setHotCue(
+                                track,
+                                position,
+                                mixxx::audio::kInvalidFramePos,
+                                hotCueIndex,
+                                QString(),
+                                mixxx::RgbColor::nullopt());
+                    }
                 } break;
                 }
             }
@@ -7,20 +7,12 @@
 
 //      https://github.com/Deep-Symmetry/crate-digger
 
-// And uses the C++ Kaitai Struct binary parsing libraries:
-
-//      http://kaitai.io
-//      https://github.com/kaitai-io/kaitai_struct
-//      https://github.com/kaitai-io/kaitai_struct_cpp_stl_runtime
-
-// The *.PDB C++ files:
-
-//      rekordbox_pdb.h
-//      rekordbox_pdb.cpp
-
-// Were generated from the following structure definition file:
+// The *.PDB and ANLZ files are decoded in place from memory mapped files by
+// rekordboxpdb.h and rekordboxanlz.h, following the structure definition
+// files of the Kaitai Struct parsers in lib/rekordbox-metadata:
 
 //      https://github.com/Deep-Symmetry/crate-digger/blob/master/src/main/kaitai/rekordbox_pdb.ksy
+//      https://github.com/Deep-Symmetry/crate-digger/blob/master/src/main/kaitai/rekordbox_anlz.ksy
 
 #pragma once
 
@@ -28,7 +20,6 @@
 #include <QFutureWatcher>
 #include <QStringListModel>
 #include <QtConcurrentRun>
-#include <fstream>
 
 #include "library/baseexternallibraryfeature.h"
 #include "library/baseexternalplaylistmodel.h"
@@ -0,0 +1,334 @@
+#include "library/rekordbox/rekordboxpdb.h"
+
+#include <QtEndian>
+#include <algorithm>
+
+#include "util/assert.h"
+
+namespace mixxx {
+
+namespace rekordbox {
+
+namespace {
+
+// File header: unknown u4, len_page u4, num_tables u4, next_unused_page u4,
+// unknown u4, sequence u4, gap u4, followed by the table directory.
+constexpr qint64 kFileHeaderSize = 28;
+constexpr quint32 kPageSizeOffset = 4;
+constexpr quint32 kTableCountOffset = 8;
+
+// Table directory entry: type u4, empty_candidate u4, first_page u4,
+// last_page u4
+constexpr qint64 kTableEntrySize = 16;
+constexpr quint32 kTableTypeOffset = 0;
+constexpr quint32 kTableFirstPageOffset = 8;
+constexpr quint32 kTableLastPageOffset = 12;
+
+// Page header, followed by the heap that contains the rows. Row offsets are
+// relative to the start of the heap.
+constexpr quint32 kPageNextPageOffset = 12;
+constexpr quint32 kPageNumRowsSmallOffset = 24;
+constexpr quint32 kPageFlagsOffset = 27;
+constexpr quint32 kPageNumRowsLargeOffset = 34;
+constexpr quint32 kPageHeapOffset = 40;
+constexpr quint8 kPageFlagStrange = 0x40;
+constexpr quint16 kNumRowsLargeInvalid = 0x1fff;
+
+// The row index is built backwards from the end of the page in groups of
+// 16 rows. Each group has 16 row offsets u2, followed by the present flags
+// u2 and an unknown u2.
+constexpr quint32 kRowGroupSize = 0x24;
+constexpr int kRowsPerGroup = 16;
+
+// DeviceSQL string kinds
+constexpr quint8 kStringLongAscii = 0x40;
+constexpr quint8 kStringLongUtf16le = 0x90;
+// The length of long strings includes the 4 byte header
+constexpr quint32 kStringLongHeaderSize = 4;
+
+// Artist rows with this subtype have a 2 byte offset of the name
+constexpr quint16 kArtistSubtypeFarName = 0x64;
+
+// Indices of the string offsets of a track row
+constexpr quint32 kTrackStringOffsetsOffset = 94;
+constexpr quint32 kTrackStringAnalyzePath = 14;
+constexpr quint32 kTrackStringComment = 16;
+constexpr quint32 kTrackStringTitle = 17;
+constexpr quint32 kTrackStringFilePath = 20;
+
+quint32 trackString(const PdbRow& row, quint32 index) {
+    return row.u16(kTrackStringOffsetsOffset + 2 * index);
+}
+
+} // anonymous namespace
+
+quint8 PdbRow::u8(quint32 offset) const {
+    const quint32 pos = m_rowBase + offset;
+    if (pos + 1 > m_pageSize) {
+        return 0;
+    }
+    return m_pPage[pos];
+}
+
+quint16 PdbRow::u16(quint32 offset) const {
+    const quint32 pos = m_rowBase + offset;
+    if (pos + 2 > m_pageSize) {
+        return 0;
+    }
+    return qFromLittleEndian<quint16>(m_pPage + pos);
+}
+
+quint32 PdbRow::u32(quint32 offset) const {
+    const quint32 pos = m_rowBase + offset;
+    if (pos + 4 > m_pageSize) {
+        return 0;
+    }
+    return qFromLittleEndian<quint32>(m_pPage + pos);
+}
+
+QString PdbRow::string(quint32 offset) const {
+    const quint32 pos = m_rowBase + offset;
+    if (pos + 1 > m_pageSize) {
+        return QString();
+    }
+    const quint8 kind = m_pPage[pos];
+    QString text;
+    if (kind == kStringLongAscii || kind == kStringLongUtf16le) {
+        const quint32 length = u16(offset + 1);
+        if (length < kStringLongHeaderSize ||
+                pos + length > m_pageSize) {
+            return QString();
+        }
+        const uchar* pText = m_pPage + pos + kStringLongHeaderSize;
+        const quint32 textSize = length - kStringLongHeaderSize;
+        if (kind == kStringLongAscii) {
+            text = QString::fromUtf8(reinterpret_cast<const char*>(pText),
+                    static_cast<int>(textSize));
+        } else {
+            text = QString(static_cast<int>(textSize / 2), Qt::Uninitialized);
+            QChar* pChars = text.data();
+            for (quint32 i = 0; i < textSize / 2; ++i) {
+                pChars[i] = QChar(qFromLittleEndian<quint16>(pText + 2 * i));
+            }
+        }
+    } else {
+        // Short ASCII: the length includes the kind byte and is stored
+        // incremented, doubled and incremented again.
+        const quint32 length = kind >> 1;
+        if (length < 1 || pos + length > m_pageSize) {
+            return QString();
+        }
+        text = QString::fromUtf8(reinterpret_cast<const char*>(m_pPage + pos + 1),
+                static_cast<int>(length - 1));
+    }
+    // Some strings read from Rekordbox *.PDB files contain random null characters
+    // which if not removed cause Mixxx to crash when attempting to read file paths
+    return text.remove(QChar('\x0'));
+}
+
+PdbNamedRow decodePdbNamedRow(PdbPageType type, const PdbRow& row) {
+    switch (type) {
+    case PdbPageType::Keys:
+        // id u4, id2 u4, name
+        return PdbNamedRow{row.u32(0), row.string(8)};
+    case PdbPageType::Genres:
+    case PdbPageType::Labels:
+        // id u4, name
+        return PdbNamedRow{row.u32(0), row.string(4)};
+    case PdbPageType::Artists: {
+        // subtype u2, index_shift u2, id u4, unknown u1, ofs_name_near u1,
+        // ofs_name_far u2 (only with kArtistSubtypeFarName)
+        const quint32 nameOffset = row.u16(0) == kArtistSubtypeFarName
+                ? row.u16(10)
+                : row.u8(9);
+        return PdbNamedRow{row.u32(4), row.string(nameOffset)};
+    }
+    case PdbPageType::Albums:
+        // unknown u2, index_shift u2, unknown u4, artist_id u4, id u4,
+        // unknown u4, unknown u1, ofs_name u1
+        return PdbNamedRow{row.u32(12), row.string(row.u8(21))};
+    default:
+        DEBUG_ASSERT(!"Rows of this type have no name");
+        return PdbNamedRow{0, QString()};
+    }
+}
+
+PdbPlaylistTreeRow decodePdbPlaylistTreeRow(const PdbRow& row) {
+    // parent_id u4, unknown u4, sort_order u4, id u4, raw_is_folder u4, name
+    PdbPlaylistTreeRow playlist;
+    playlist.parentId = row.u32(0);
+    playlist.sortOrder = row.u32(8);
+    playlist.id = row.u32(12);
+    playlist.isFolder = row.u32(16) != 0;
+    playlist.name = row.string(20);
+    return playlist;
+}
+
+PdbPlaylistEntryRow decodePdbPlaylistEntryRow(const PdbRow& row) {
+    // entry_index u4, track_id u4, playlist_id u4
+    PdbPlaylistEntryRow entry;
+    entry.entryIndex = row.u32(0);
+    entry.trackId = row.u32(4);
+    entry.playlistId = row.u32(8);
+    return entry;
+}
+
+PdbTrackRow decodePdbTrackRow(const PdbRow& row) {
+    PdbTrackRow track;
+    track.keyId = row.u32(32);
+    track.bitrate = row.u32(48);
+    track.trackNumber = row.u32(52);
+    track.tempo = row.u32(56);
+    track.genreId = row.u32(60);
+    track.albumId = row.u32(64);
+    track.artistId = row.u32(68);
+    track.id = row.u32(72);
+    track.year = row.u16(80);
+    track.duration = row.u16(84);
+    track.colorId = row.u8(88);
+    track.rating = row.u8(89);
+    track.title = row.string(trackString(row, kTrackStringTitle));
+    track.comment = row.string(trackString(row, kTrackStringComment));
+    track.filePath = row.string(trackString(row, kTrackStringFilePath));
+    track.analyzePath = row.string(trackString(row, kTrackStringAnalyzePath));
+    return track;
+}
+
+PdbReader::PdbReader(const uchar* pData, qint64 size)
+        : m_pData(pData),
+          m_size(size),
+          m_pageSize(0),
+          m_tableCount(0) {
+    if (!pData || size < kFileHeaderSize) {
+        return;
+    }
+    const quint32 pageSize = qFromLittleEndian<quint32>(pData + kPageSizeOffset);
+    if (pageSize <= kPageHeapOffset + kRowGroupSize || pageSize > size) {
+        return;
+    }
+    m_pageSize = pageSize;
+    m_tableCount = static_cast<quint32>(std::min<qint64>(
+            qFromLittleEndian<quint32>(pData + kTableCountOffset),
+            (size - kFileHeaderSize) / kTableEntrySize));
+}
+
+const uchar* PdbReader::page(quint32 pageIndex) const {
+    const qint64 pageOffset = static_cast<qint64>(pageIndex) * m_pageSize;
+    if (pageOffset + m_pageSize > m_size) {
+        return nullptr;
+    }
+    return m_pData + pageOffset;
+}
+
+PdbReader::RowIterator::RowIterator(const PdbReader* pReader, PdbPageType type)
+        : m_pReader(pReader),
+          m_type(static_cast<quint32>(type)),
+          m_tableIndex(0),
+          m_pageIndex(0),
+          m_lastPageIndex(0),
+          m_remainingPages(pReader->isValid() ? pReader->m_size / pReader->m_pageSize : 0),
+          m_pPage(nullptr),
+          m_rowGroupCount(0),
+          m_rowGroup(0),
+          m_rowInGroup(0),
+          m_rowPresentFlags(0) {
+}
+
+bool PdbReader::RowIterator::next() {
+    while (m_pPage || nextTable()) {
+        if (nextRowInPage()) {
+            return true;
+        }
+        if (!nextPage()) {
+            m_pPage = nullptr;
+        }
+    }
+    return false;
+}
+
+bool PdbReader::RowIterator::nextTable() {
+    while (m_tableIndex < m_pReader->m_tableCount) {
+        const uchar* pTable = m_pReader->m_pData + kFileHeaderSize +
+                m_tableIndex * kTableEntrySize;
+        ++m_tableIndex;
+        if (qFromLittleEndian<quint32>(pTable + kTableTypeOffset) != m_type) {
+            continue;
+        }
+        m_lastPageIndex = qFromLittleEndian<quint32>(pTable + kTableLastPageOffset);
+        if (enterPage(qFromLittleEndian<quint32>(pTable + kTableFirstPageOffset))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PdbReader::RowIterator::enterPage(quint32 pageIndex) {
+    if (--m_remainingPages < 0) {
+        return false;
+    }
+    m_pPage = m_pReader->page(pageIndex);
+    if (!m_pPage) {
+        return false;
+    }
+    m_pageIndex = pageIndex;
+    m_rowGroup = 0;
+    m_rowInGroup = 0;
+    if (m_pPage[kPageFlagsOffset] & kPageFlagStrange) {
+        // Not a data page, its rows can't be parsed.
+        m_rowGroupCount = 0;
+        return true;
+    }
+    const int numRowsSmall = m_pPage[kPageNumRowsSmallOffset];
+    const int numRowsLarge = qFromLittleEndian<quint16>(m_pPage + kPageNumRowsLargeOffset);
+    const int numRows = (numRowsLarge > numRowsSmall && numRowsLarge != kNumRowsLargeInvalid)
+            ? numRowsLarge
+            : numRowsSmall;
+    m_rowGroupCount = std::min<int>((numRows - 1) / kRowsPerGroup + 1,
+            (m_pReader->m_pageSize - kPageHeapOffset) / kRowGroupSize);
+    loadRowGroup();
+    return true;
+}
+
+bool PdbReader::RowIterator::nextPage() {
+    if (m_pageIndex == m_lastPageIndex) {
+        return false;
+    }
+    return enterPage(qFromLittleEndian<quint32>(m_pPage + kPageNextPageOffset));
+}
+
+void PdbReader::RowIterator::loadRowGroup() {
+    if (m_rowGroup >= m_rowGroupCount) {
+        return;
+    }
+    const quint32 base = m_pReader->m_pageSize - m_rowGroup * kRowGroupSize;
+    m_rowPresentFlags = qFromLittleEndian<quint16>(m_pPage + base - 4);
+}
+
+bool PdbReader::RowIterator::nextRowInPage() {
+    const quint32 pageSize = m_pReader->m_pageSize;
+    while (m_rowGroup < m_rowGroupCount) {
+        const quint32 base = pageSize - m_rowGroup * kRowGroupSize;
+        while (m_rowInGroup < kRowsPerGroup) {
+            const int rowIndex = m_rowInGroup++;
+            if (((m_rowPresentFlags >> rowIndex) & 1) == 0) {
+                continue;
+            }
+            const quint32 rowOffset = qFromLittleEndian<quint16>(
+                    m_pPage + base - (6 + 2 * rowIndex));
+            const quint32 rowBase = kPageHeapOffset + rowOffset;
+            if (rowBase >= pageSize) {
+                continue;
+            }
+            m_row = PdbRow(m_pPage, pageSize, rowBase);
+            return true;
+        }
+        ++m_rowGroup;
+        m_rowInGroup = 0;
+        loadRowGroup();
+    }
+    return false;
+}
+
+} // namespace rekordbox
+
+} // namespace mixxx
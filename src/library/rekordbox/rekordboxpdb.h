@@ -0,0 +1,182 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+
+// Decodes the tables of a Rekordbox export.pdb database directly from its
+// bytes, usually a MappedFile, instead of building the object tree of the
+// Kaitai Struct parser rekordbox_pdb_t. Only the rows and fields that Mixxx
+// imports are decoded, and strings are converted straight from the page
+// into QString.
+//
+// The layout is documented in lib/rekordbox-metadata/rekordbox_pdb.ksy.
+// All reads are bounds checked: a corrupt file yields fewer rows or empty
+// fields, but never reads outside of the data.
+
+namespace mixxx {
+
+namespace rekordbox {
+
+enum class PdbPageType : quint32 {
+    Tracks = 0,
+    Genres = 1,
+    Artists = 2,
+    Albums = 3,
+    Labels = 4,
+    Keys = 5,
+    Colors = 6,
+    PlaylistTree = 7,
+    PlaylistEntries = 8,
+    HistoryPlaylists = 11,
+    HistoryEntries = 12,
+    Artwork = 13,
+    Columns = 16,
+    History = 19,
+};
+
+/// A row that is present in a table page. Offsets are relative to the start
+/// of the row, like the offsets stored in the rows themselves.
+class PdbRow {
+  public:
+    PdbRow()
+            : m_pPage(nullptr),
+              m_pageSize(0),
+              m_rowBase(0) {
+    }
+    PdbRow(const uchar* pPage, quint32 pageSize, quint32 rowBase)
+            : m_pPage(pPage),
+              m_pageSize(pageSize),
+              m_rowBase(rowBase) {
+    }
+
+    quint8 u8(quint32 offset) const;
+    quint16 u16(quint32 offset) const;
+    quint32 u32(quint32 offset) const;
+
+    /// Decodes the DeviceSQL string at the given offset. Null characters,
+    /// which some exports contain, are removed.
+    QString string(quint32 offset) const;
+
+  private:
+    const uchar* m_pPage;
+    quint32 m_pageSize;
+    quint32 m_rowBase;
+};
+
+/// The id and name of a row in the keys, genres, artists or albums table.
+struct PdbNamedRow {
+    quint32 id;
+    QString name;
+};
+
+struct PdbPlaylistTreeRow {
+    quint32 id;
+    quint32 parentId;
+    quint32 sortOrder;
+    bool isFolder;
+    QString name;
+};
+
+struct PdbPlaylistEntryRow {
+    quint32 playlistId;
+    quint32 entryIndex;
+    quint32 trackId;
+};
+
+/// The fields of a track row that are imported by Mixxx.
+struct PdbTrackRow {
+    quint32 id;
+    quint32 artistId;
+    quint32 albumId;
+    quint32 genreId;
+    quint32 keyId;
+    quint32 bitrate;
+    quint32 trackNumber;
+    /// Beats per minute multiplied by 100
+    quint32 tempo;
+    quint16 year;
+    /// Seconds
+    quint16 duration;
+    quint8 colorId;
+    quint8 rating;
+    QString title;
+    QString comment;
+    QString filePath;
+    QString analyzePath;
+};
+
+PdbNamedRow decodePdbNamedRow(PdbPageType type, const PdbRow& row);
+PdbPlaylistTreeRow decodePdbPlaylistTreeRow(const PdbRow& row);
+PdbPlaylistEntryRow decodePdbPlaylistEntryRow(const PdbRow& row);
+PdbTrackRow decodePdbTrackRow(const PdbRow& row);
+
+/// A read-only view of the pages of an export.pdb file. It doesn't own the
+/// data, which must outlive the reader and its iterators.
+class PdbReader {
+  public:
+    PdbReader(const uchar* pData, qint64 size);
+
+    bool isValid() const {
+        return m_pageSize > 0;
+    }
+
+    quint32 pageSize() const {
+        return m_pageSize;
+    }
+
+    /// Visits the present rows of all tables of one type lazily, page by
+    /// page, in the order of the linked list of pages:
+    ///
+    ///     for (auto it = reader.rows(PdbPageType::Keys); it.next();) {
+    ///         const auto key = decodePdbNamedRow(PdbPageType::Keys, it.row());
+    ///     }
+    class RowIterator {
+      public:
+        /// Advances to the next present row. Returns false at the end.
+        bool next();
+
+        const PdbRow& row() const {
+            return m_row;
+        }
+
+      private:
+        friend class PdbReader;
+        RowIterator(const PdbReader* pReader, PdbPageType type);
+
+        bool nextTable();
+        bool enterPage(quint32 pageIndex);
+        bool nextPage();
+        void loadRowGroup();
+        bool nextRowInPage();
+
+        const PdbReader* m_pReader;
+        quint32 m_type;
+        quint32 m_tableIndex;
+        quint32 m_pageIndex;
+        quint32 m_lastPageIndex;
+        // Guards against cycles in the page links of corrupt files
+        qint64 m_remainingPages;
+        const uchar* m_pPage;
+        int m_rowGroupCount;
+        int m_rowGroup;
+        int m_rowInGroup;
+        quint16 m_rowPresentFlags;
+        PdbRow m_row;
+    };
+
+    RowIterator rows(PdbPageType type) const {
+        return RowIterator(this, type);
+    }
+
+  private:
+    const uchar* page(quint32 pageIndex) const;
+
+    const uchar* m_pData;
+    qint64 m_size;
+    quint32 m_pageSize;
+    quint32 m_tableCount;
+};
+
+} // namespace rekordbox
+
+} // namespace mixxx
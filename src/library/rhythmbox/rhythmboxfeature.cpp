@@ -9,6 +9,7 @@
 
 #include "library/baseexternalplaylistmodel.h"
 #include "library/baseexternaltrackmodel.h"
+#include "library/externaltrackimporter.h"
 #include "library/library.h"
 #include "library/queryutil.h"
 #include "library/trackcollection.h"
@@ -170,50 +171,68 @@ TreeItem* RhythmboxFeature::importMusicCollection() {
         return nullptr;
     }
 
-    //Delete all table entries of Traktor feature
+    // Tracks and playlists are imported in a single transaction. The tracks
+    // are updated incrementally, the playlists are rebuilt.
     ScopedTransaction transaction(m_database);
     clearTable("rhythmbox_playlist_tracks");
-    clearTable("rhythmbox_library");
     clearTable("rhythmbox_playlists");
-    transaction.commit();
-
-    transaction.transaction();
-    QSqlQuery query(m_database);
-    query.prepare("INSERT INTO rhythmbox_library (artist, title, album, year, "
-                  "genre, comment, tracknumber, bpm, bitrate,"
-                  "duration, location, rating ) "
-                  "VALUES (:artist, :title, :album, :year, :genre, :comment, "
-                  ":tracknumber, :bpm, :bitrate, :duration, :location, :rating )");
 
+    ExternalTrackImporter importer(m_database,
+            "rhythmbox_library",
+            {"location",
+                    "artist",
+                    "title",
+                    "album",
+                    "year",
+                    "genre",
+                    "comment",
+                    "tracknumber",
+                    "bpm",
+                    "bitrate",
+                    "duration",
+                    "rating"});
+    if (!importer.begin(db.fileName())) {
+        return nullptr;
+    }
 
-    QXmlStreamReader xml(&db);
-    while (!xml.atEnd() && !m_cancelImport) {
-        xml.readNext();
-        if (xml.isStartElement() && xml.name() == QLatin1String("entry")) {
-            QXmlStreamAttributes attr = xml.attributes();
-            //Check if we really parse a track and not album art information
-            if (attr.value("type").toString() == "song") {
-                importTrack(xml, query);
+    if (importer.isSourceFileUnchanged()) {
+        // Only the playlists need to be parsed again
+        importer.keepAllTracks();
+    } else {
+        QXmlStreamReader xml(&db);
+        while (!xml.atEnd() && !m_cancelImport) {
+            xml.readNext();
+            if (xml.isStartElement() && xml.name() == QLatin1String("entry")) {
+                QXmlStreamAttributes attr = xml.attributes();
+                //Check if we really parse a track and not album art information
+                if (attr.value("type").toString() == "song") {
+                    importTrack(xml, &importer);
+                }
             }
         }
-    }
-    transaction.commit();
 
-    if (xml.hasError()) {
-        // do error handling
-        qDebug() << "Cannot process Rhythmbox music collection";
-        qDebug() << "XML ERROR: " << xml.errorString();
-        return nullptr;
+        if (xml.hasError()) {
+            // do error handling
+            qDebug() << "Cannot process Rhythmbox music collection";
+            qDebug() << "XML ERROR: " << xml.errorString();
+            return nullptr;
+        }
     }
 
     db.close();
     if (m_cancelImport) {
         return nullptr;
     }
-    return importPlaylists();
+    TreeItem* root = importPlaylists(importer);
+    if (m_cancelImport || !importer.commit()) {
+        delete root;
+        return nullptr;
+    }
+    transaction.commit();
+    return root;
 }
 
-TreeItem* RhythmboxFeature::importPlaylists() {
+TreeItem* RhythmboxFeature::importPlaylists(const ExternalTrackImporter& importer) {
     QFile db(QDir::homePath() + "/.gnome2/rhythmbox/playlists.xml");
     if (!db.exists()) {
         db.setFileName(QDir::homePath() + "/.local/share/rhythmbox/playlists.xml");
@@ -263,7 +282,7 @@ TreeItem* RhythmboxFeature::importPlaylists() {
                 int playlist_id = query_insert_to_playlists.lastInsertId().toInt();
 
                 //Process playlist entries
-                importPlaylist(xml, query_insert_to_playlist_tracks, playlist_id);
+                importPlaylist(xml, importer, &query_insert_to_playlist_tracks, playlist_id);
             }
         }
     }
@@ -279,7 +298,7 @@ TreeItem* RhythmboxFeature::importPlaylists() {
     return rootItem.release();
 }
 
-void RhythmboxFeature::importTrack(QXmlStreamReader &xml, QSqlQuery &query) {
+void RhythmboxFeature::importTrack(QXmlStreamReader& xml, ExternalTrackImporter* pImporter) {
     QString title;
     QString artist;
     QString album;
@@ -355,32 +374,25 @@ void RhythmboxFeature::importTrack(QXmlStreamReader &xml, QSqlQuery &query) {
         return;
     }
 
-    query.bindValue(":artist", artist);
-    query.bindValue(":title", title);
-    query.bindValue(":album", album);
-    query.bindValue(":genre", genre);
-    query.bindValue(":year", year);
-    query.bindValue(":duration", playtime);
-    query.bindValue(":location", location);
-    query.bindValue(":rating", rating);
-    query.bindValue(":comment", comment);
-    query.bindValue(":tracknumber", tracknumber);
-    query.bindValue(":bpm", bpm);
-    query.bindValue(":bitrate", bitrate);
-
-    bool success = query.exec();
-
-    if (!success) {
-        qDebug() << "SQL Error in rhythmboxfeature.cpp: line" << __LINE__
-                 << " " << query.lastError();
-        return;
-    }
+    pImporter->importTrack({location,
+            artist,
+            title,
+            album,
+            year,
+            genre,
+            comment,
+            tracknumber,
+            bpm,
+            bitrate,
+            playtime,
+            rating});
 }
 
 // reads all playlist entries and executes a SQL statement
-void RhythmboxFeature::importPlaylist(QXmlStreamReader &xml,
-                                      QSqlQuery &query_insert_to_playlist_tracks,
-                                      int playlist_id) {
+void RhythmboxFeature::importPlaylist(QXmlStreamReader& xml,
+        const ExternalTrackImporter& importer,
+        QSqlQuery* pQueryInsertToPlaylistTracks,
+        int playlist_id) {
     int playlist_position = 1;
     while (!xml.atEnd()) {
         //read next XML element
@@ -389,30 +401,16 @@ void RhythmboxFeature::importPlaylist(QXmlStreamReader &xml,
             const auto fileInfo = mixxx::FileInfo::fromQUrl(xml.readElementText());
 
             //get the ID of the file in the rhythmbox_library table
-            int track_id = -1;
-            QSqlQuery finder_query(m_database);
-            finder_query.prepare("select id from rhythmbox_library where location=:path");
-            finder_query.bindValue(":path", fileInfo.location());
-            bool success = finder_query.exec();
-
-            if (success) {
-                const int idColumn = finder_query.record().indexOf("id");
-                while (finder_query.next()) {
-                    track_id = finder_query.value(idColumn).toInt();
-                }
-             } else {
-                qDebug() << "SQL Error in RhythmboxFeature.cpp: line"
-                         << __LINE__ << " " << finder_query.lastError();
-            }
+            const int track_id = importer.trackId(fileInfo.location());
 
-            query_insert_to_playlist_tracks.bindValue(":playlist_id", playlist_id);
-            query_insert_to_playlist_tracks.bindValue(":track_id", track_id);
-            query_insert_to_playlist_tracks.bindValue(":position", playlist_position++);
-            success = query_insert_to_playlist_tracks.exec();
+            pQueryInsertToPlaylistTracks->bindValue(":playlist_id", playlist_id);
+            pQueryInsertToPlaylistTracks->bindValue(":track_id", track_id);
+            pQueryInsertToPlaylistTracks->bindValue(":position", playlist_position++);
+            bool success = pQueryInsertToPlaylistTracks->exec();
 
             if (!success) {
                 qDebug() << "SQL Error in RhythmboxFeature.cpp: line" << __LINE__ << " "
-                         << query_insert_to_playlist_tracks.lastError()
+                         << pQueryInsertToPlaylistTracks->lastError()
                          << "trackid" << track_id
                          << "playlis ID " << playlist_id
                          << "-----------------";
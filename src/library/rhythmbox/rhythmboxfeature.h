@@ -10,6 +10,7 @@ class BaseExternalTrackModel;
 class BaseExternalPlaylistModel;
 class QXmlStreamReader;
 class BaseTrackCache;
+class ExternalTrackImporter;
 
 class RhythmboxFeature : public BaseExternalLibraryFeature {
     Q_OBJECT
@@ -24,7 +25,7 @@ class RhythmboxFeature : public BaseExternalLibraryFeature {
     // processes the music collection
     TreeItem* importMusicCollection();
     // processes the playlist entries
-    TreeItem* importPlaylists();
+    TreeItem* importPlaylists(const ExternalTrackImporter& importer);
 
   public slots:
     void activate() override;
@@ -38,10 +39,13 @@ class RhythmboxFeature : public BaseExternalLibraryFeature {
   private:
     // Removes all rows from a given table
     void clearTable(const QString& table_name);
-    // reads the properties of a track and executes a SQL statement
-    void importTrack(QXmlStreamReader &xml, QSqlQuery &query);
+    // reads the properties of a track and passes them to the importer
+    void importTrack(QXmlStreamReader& xml, ExternalTrackImporter* pImporter);
     // reads all playlist entries and executes a SQL statement
-    void importPlaylist(QXmlStreamReader &xml, QSqlQuery &query, int playlist_id);
+    void importPlaylist(QXmlStreamReader& xml,
+            const ExternalTrackImporter& importer,
+            QSqlQuery* pQueryInsertToPlaylistTracks,
+            int playlist_id);
 
     BaseExternalTrackModel* m_pRhythmboxTrackModel;
     BaseExternalPlaylistModel* m_pRhythmboxPlaylistModel;
@@ -78,9 +78,35 @@ void CoverArtDelegate::requestUncachedCover(
     m_pendingCacheRows.insert(coverInfo.cacheKey(), row);
 }
 
+void CoverArtDelegate::cancelInvisibleRequests() {
+    QSet<mixxx::cache_key_t> canceledCacheKeys;
+    auto it = m_pendingCacheRows.begin();
+    while (it != m_pendingCacheRows.end()) {
+        const QModelIndex index = m_pTableView->model()->index(it.value(), m_column);
+        const QRect rect = m_pTableView->visualRect(index);
+        if (rect.intersects(m_pTableView->viewport()->rect())) {
+            ++it;
+        } else {
+            canceledCacheKeys.insert(it.key());
+            it = m_pendingCacheRows.erase(it);
+        }
+    }
+    for (const auto cacheKey : std::as_const(canceledCacheKeys)) {
+        // The same cover might still be shown in another row
+        if (!m_pendingCacheRows.contains(cacheKey)) {
+            CoverArtCache::cancelRequest(this, cacheKey);
+        }
+    }
+}
+
 void CoverArtDelegate::slotInhibitLazyLoading(
         bool inhibitLazyLoading) {
     m_inhibitLazyLoading = inhibitLazyLoading;
+    if (m_pCache && !m_pendingCacheRows.isEmpty()) {
+        // Don't load the covers of rows that have been scrolled away
+        // before loading those of the rows that are visible now.
+        cancelInvisibleRequests();
+    }
     if (m_inhibitLazyLoading || m_cacheMissRows.isEmpty()) {
         return;
     }
@@ -93,7 +119,7 @@ void CoverArtDelegate::slotInhibitLazyLoading(
     for (int row : std::as_const(m_cacheMissRows)) {
         const QModelIndex index = m_pTableView->model()->index(row, m_column);
         const QRect rect = m_pTableView->visualRect(index);
-        if (rect.intersects(m_pTableView->rect())) {
+        if (rect.intersects(m_pTableView->viewport()->rect())) {
             const CoverInfo coverInfo = m_pTrackModel->getCoverInfo(index);
             requestUncachedCover(coverInfo, width, row);
         }
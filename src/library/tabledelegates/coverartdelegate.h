@@ -56,6 +56,7 @@ class CoverArtDelegate : public TableItemDelegate {
     void emitRowsChanged(
             QList<int>&& rows);
     void cleanCacheMissRows() const;
+    void cancelInvisibleRequests();
     void requestUncachedCover(
             const CoverInfo& coverInfo,
             int width,
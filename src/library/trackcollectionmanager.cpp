@@ -6,6 +6,7 @@
 #include "library/library_prefs.h"
 #include "library/scanner/libraryscanner.h"
 #include "library/trackcollection.h"
+#include "library/tracktablequerythread.h"
 #include "moc_trackcollectionmanager.cpp"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
@@ -21,6 +22,16 @@ const QString kConfigGroup = QStringLiteral("[TrackCollection]");
 
 const ConfigKey kConfigKeyRepairDatabaseOnNextRestart(kConfigGroup, "RepairDatabaseOnNextRestart");
 
+// Connections to a shared in-memory database lock its tables instead of
+// reading them concurrently, so queries in background would only block
+// the GUI thread.
+bool isInMemoryDatabase(const QSqlDatabase& database) {
+    const QString databaseName = database.databaseName();
+    return databaseName.isEmpty() ||
+            databaseName == QStringLiteral(":memory:") ||
+            databaseName.contains(QStringLiteral("mode=memory"));
+}
+
 inline
 parented_ptr<TrackCollection> createInternalTrackCollection(
         TrackCollectionManager* parent,
@@ -126,9 +137,19 @@ TrackCollectionManager::TrackCollectionManager(
         kLogger.info() << "Starting library scanner thread";
         m_pScanner->start();
     }
+
+    if (isInMemoryDatabase(dbConnection)) {
+        kLogger.info() << "Track table queries in background are disabled"
+                       << "for an in-memory database";
+    } else {
+        m_pTrackTableQueryThread = std::make_unique<TrackTableQueryThread>(pDbConnectionPool);
+    }
 }
 
 TrackCollectionManager::~TrackCollectionManager() {
+    // Stops the thread and releases its database connection
+    m_pTrackTableQueryThread.reset();
+
     if (m_pScanner) {
         while (m_pScanner->isRunning()) {
             kLogger.info() << "Stopping library scanner thread";
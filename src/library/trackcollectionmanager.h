@@ -13,6 +13,7 @@
 #include "util/thread_affinity.h"
 
 class LibraryScanner;
+class TrackTableQueryThread;
 class TrackCollection;
 class ExternalTrackCollection;
 class RelocatedTrack;
@@ -47,6 +48,12 @@ class TrackCollectionManager: public QObject,
         return m_externalCollections;
     }
 
+    // Sorts and filters the track tables in background. Not available
+    // in tests that use an in-memory database.
+    TrackTableQueryThread* trackTableQueryThread() const {
+        return m_pTrackTableQueryThread.get();
+    }
+
     TrackPointer getTrackById(
             TrackId trackId) const;
     TrackPointer getTrackByRef(
@@ -128,4 +135,6 @@ class TrackCollectionManager: public QObject,
 
     // TODO: Extract and decouple LibraryScanner from TrackCollectionManager
     std::unique_ptr<LibraryScanner> m_pScanner;
+
+    std::unique_ptr<TrackTableQueryThread> m_pTrackTableQueryThread;
 };
@@ -0,0 +1,153 @@
+#include "library/trackcolumnfetcher.h"
+
+#include <QDir>
+#include <QHash>
+#include <QSqlQuery>
+#include <QSqlRecord>
+
+#include "library/queryutil.h"
+#include "moc_trackcolumnfetcher.cpp"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
+#include "util/logger.h"
+
+namespace {
+
+mixxx::Logger kLogger("TrackColumnFetcher");
+
+} // anonymous namespace
+
+TrackColumnFetcher::TrackColumnFetcher(
+        mixxx::DbConnectionPoolPtr pDbConnectionPool,
+        QString tableName,
+        QString idColumn,
+        int columnCount,
+        QString columnsJoined,
+        QString createViewQuery,
+        int locationColumn)
+        : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_tableName(std::move(tableName)),
+          m_idColumn(std::move(idColumn)),
+          m_columnCount(columnCount),
+          m_columnsJoined(std::move(columnsJoined)),
+          m_createViewQuery(std::move(createViewQuery)),
+          m_locationColumn(locationColumn),
+          m_dbConnectionOpen(false) {
+    qRegisterMetaType<QVector<TrackId>>();
+    qRegisterMetaType<ColumnarValues>();
+
+    // Move the fetcher to its own thread so that the requests are queued
+    // to its event loop.
+    moveToThread(this);
+    setObjectName(QStringLiteral("TrackColumnFetcher ") + m_tableName);
+
+    connect(this,
+            &TrackColumnFetcher::fetchRequested,
+            this,
+            &TrackColumnFetcher::slotFetchTracks);
+    start(QThread::LowPriority);
+}
+
+TrackColumnFetcher::~TrackColumnFetcher() {
+    quit();
+    wait();
+}
+
+void TrackColumnFetcher::run() {
+    kLogger.debug() << "Entering thread";
+    {
+        const mixxx::DbConnectionPooler dbConnectionPooler(m_pDbConnectionPool);
+        QSqlDatabase dbConnection = mixxx::DbConnectionPooled(m_pDbConnectionPool);
+        m_dbConnectionOpen = dbConnection.isOpen();
+        if (!m_dbConnectionOpen) {
+            // Keep answering the requests, so that they are fetched on
+            // another connection instead
+            kLogger.warning()
+                    << "Failed to open database connection for fetching tracks";
+        } else if (!m_createViewQuery.isEmpty()) {
+            QSqlQuery query(dbConnection);
+            if (!query.exec(m_createViewQuery)) {
+                LOG_FAILED_QUERY(query);
+            }
+        }
+        exec();
+    }
+    kLogger.debug() << "Exiting thread";
+}
+
+void TrackColumnFetcher::fetchTracks(const QVector<TrackId>& trackIds) {
+    emit fetchRequested(trackIds);
+}
+
+void TrackColumnFetcher::slotFetchTracks(const QVector<TrackId>& trackIds) {
+    if (!m_dbConnectionOpen) {
+        emit fetchFailed(trackIds);
+        return;
+    }
+    ColumnarValues values(m_columnCount);
+    if (!queryTracks(mixxx::DbConnectionPooled(m_pDbConnectionPool),
+                m_tableName,
+                m_idColumn,
+                m_columnsJoined,
+                m_locationColumn,
+                trackIds,
+                &values)) {
+        // The NULL values of a failed query must not be cached
+        emit fetchFailed(trackIds);
+        return;
+    }
+    emit tracksFetched(trackIds, values);
+}
+
+// static
+bool TrackColumnFetcher::queryTracks(
+        const QSqlDatabase& database,
+        const QString& tableName,
+        const QString& idColumn,
+        const QString& columnsJoined,
+        int locationColumn,
+        const QVector<TrackId>& trackIds,
+        ColumnarValues* pValues) {
+    QStringList idStrings;
+    idStrings.reserve(trackIds.size());
+    for (const auto& trackId : trackIds) {
+        idStrings << trackId.toString();
+    }
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+    const QString queryString = QString("SELECT %1 FROM %2 WHERE %3 in (%4)")
+                                        .arg(columnsJoined,
+                                                tableName,
+                                                idColumn,
+                                                idStrings.join(","));
+    const int columnCount = pValues->columnCount();
+    QHash<TrackId, QVector<QVariant>> rows;
+    rows.reserve(trackIds.size());
+    bool success = query.prepare(queryString) && query.exec();
+    if (success) {
+        const int idColumnIndex = query.record().indexOf(idColumn);
+        while (query.next()) {
+            QVector<QVariant> row(columnCount);
+            for (int i = 0; i < columnCount; ++i) {
+                if (i == locationColumn) {
+                    // Database stores all locations with Qt separators: "/"
+                    // Here we want to cache the display string with native separators.
+                    row[i] = QDir::toNativeSeparators(query.value(i).toString());
+                } else {
+                    row[i] = query.value(i);
+                }
+            }
+            rows.insert(TrackId(query.value(idColumnIndex)), std::move(row));
+        }
+    } else {
+        LOG_FAILED_QUERY(query);
+    }
+
+    pValues->reserve(pValues->rowCount() + trackIds.size());
+    const QVector<QVariant> nullRow(columnCount);
+    for (const auto& trackId : trackIds) {
+        const auto it = rows.constFind(trackId);
+        pValues->appendRow(it != rows.constEnd() ? it.value() : nullRow);
+    }
+    return success;
+}
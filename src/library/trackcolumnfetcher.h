@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QSqlDatabase>
+#include <QString>
+#include <QThread>
+#include <QVector>
+
+#include "library/columnartrackcache.h"
+#include "track/trackid.h"
+#include "util/db/dbconnectionpool.h"
+
+/// TrackColumnFetcher fetches the column values of tracks from the database
+/// on its own thread and database connection. Table views request the values
+/// of the visible rows in batches and receive them asynchronously, so that
+/// scrolling through a large library never waits for SQLite on the GUI
+/// thread.
+class TrackColumnFetcher : public QThread {
+    Q_OBJECT
+  public:
+    /// The table or view must contain the id column and all columns. A
+    /// temporary view is only visible on the connection that created it,
+    /// so createViewQuery is executed on the connection of the fetcher.
+    TrackColumnFetcher(
+            mixxx::DbConnectionPoolPtr pDbConnectionPool,
+            QString tableName,
+            QString idColumn,
+            int columnCount,
+            QString columnsJoined,
+            QString createViewQuery,
+            int locationColumn);
+    ~TrackColumnFetcher() override;
+
+    /// Thread-safe, the values are delivered by tracksFetched(), or
+    /// fetchFailed() if the database is not available or the query failed
+    void fetchTracks(const QVector<TrackId>& trackIds);
+
+    /// Fetches the values of the tracks in the order of trackIds into
+    /// pValues, which must have a column for each of columnsJoined. Tracks
+    /// that don't exist in the table get a row of NULL values.
+    static bool queryTracks(
+            const QSqlDatabase& database,
+            const QString& tableName,
+            const QString& idColumn,
+            const QString& columnsJoined,
+            int locationColumn,
+            const QVector<TrackId>& trackIds,
+            ColumnarValues* pValues);
+
+  signals:
+    void fetchRequested(const QVector<TrackId>& trackIds);
+    void tracksFetched(const QVector<TrackId>& trackIds, const ColumnarValues& values);
+    void fetchFailed(const QVector<TrackId>& trackIds);
+
+  protected:
+    void run() override;
+
+  private slots:
+    void slotFetchTracks(const QVector<TrackId>& trackIds);
+
+  private:
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+    const QString m_tableName;
+    const QString m_idColumn;
+    const int m_columnCount;
+    const QString m_columnsJoined;
+    const QString m_createViewQuery;
+    const int m_locationColumn;
+    // Only accessed by the thread of the fetcher
+    bool m_dbConnectionOpen;
+};
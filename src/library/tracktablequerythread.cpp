@@ -0,0 +1,204 @@
+#include "library/tracktablequerythread.h"
+
+#include <QSet>
+#include <QSqlQuery>
+
+#include "library/queryutil.h"
+#include "moc_tracktablequerythread.cpp"
+#include "util/db/dbconnectionpooled.h"
+#include "util/db/dbconnectionpooler.h"
+#include "util/logger.h"
+
+namespace {
+
+mixxx::Logger kLogger("TrackTableQueryThread");
+
+// Aborting a query is checked after reading this many rows
+constexpr int kRowsPerCancelCheck = 1024;
+
+const QString kCreateView = QStringLiteral("CREATE VIEW");
+const QString kCreateTemporaryView = QStringLiteral("CREATE TEMPORARY VIEW");
+
+QString quotedName(QString name) {
+    return QChar('"') + name.replace(QChar('"'), QStringLiteral("\"\"")) + QChar('"');
+}
+
+} // anonymous namespace
+
+TrackTableQueryThread::TrackTableQueryThread(
+        mixxx::DbConnectionPoolPtr pDbConnectionPool)
+        : m_pDbConnectionPool(std::move(pDbConnectionPool)) {
+    qRegisterMetaType<TrackTableQuery>();
+    qRegisterMetaType<TrackTableQueryResultPointer>();
+
+    // Move the thread object to its own thread so that the queries are
+    // queued to its event loop.
+    moveToThread(this);
+    setObjectName(QStringLiteral("TrackTableQueryThread"));
+
+    connect(this,
+            &TrackTableQueryThread::queryRequested,
+            this,
+            &TrackTableQueryThread::slotExecuteQuery);
+    start();
+}
+
+TrackTableQueryThread::~TrackTableQueryThread() {
+    quit();
+    wait();
+}
+
+void TrackTableQueryThread::run() {
+    kLogger.debug() << "Entering thread";
+    {
+        const mixxx::DbConnectionPooler dbConnectionPooler(m_pDbConnectionPool);
+        QSqlDatabase dbConnection = mixxx::DbConnectionPooled(m_pDbConnectionPool);
+        if (!dbConnection.isOpen()) {
+            kLogger.warning()
+                    << "Failed to open database connection for track queries";
+            kLogger.debug() << "Exiting thread";
+            return;
+        }
+        exec();
+        m_temporaryViews.clear();
+    }
+    kLogger.debug() << "Exiting thread";
+}
+
+void TrackTableQueryThread::submit(const TrackTableQuery& query) {
+    emit queryRequested(query);
+}
+
+// static
+bool TrackTableQueryThread::readTemporaryViews(
+        const QSqlDatabase& database,
+        const QString& tableName,
+        QList<QPair<QString, QString>>* pTemporaryViews) {
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+    if (!query.exec(QStringLiteral(
+                "SELECT type, name, sql FROM sqlite_temp_master "
+                "WHERE type IN ('table', 'view') ORDER BY rowid"))) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    pTemporaryViews->clear();
+    while (query.next()) {
+        const QString name = query.value(1).toString();
+        if (query.value(0).toString() == QStringLiteral("table")) {
+            if (name == tableName) {
+                return false;
+            }
+            continue;
+        }
+        // SQLite stores the statement of a temporary view without TEMPORARY
+        QString createView = query.value(2).toString();
+        if (createView.startsWith(kCreateView, Qt::CaseInsensitive)) {
+            createView.replace(0, kCreateView.size(), kCreateTemporaryView);
+        }
+        pTemporaryViews->append(qMakePair(name, createView));
+    }
+    return true;
+}
+
+bool TrackTableQueryThread::updateTemporaryViews(
+        const QSqlDatabase& database,
+        const QList<QPair<QString, QString>>& temporaryViews) {
+    QSqlQuery query(database);
+    QSet<QString> names;
+    for (const auto& view : temporaryViews) {
+        names.insert(view.first);
+    }
+    for (auto it = m_temporaryViews.begin(); it != m_temporaryViews.end();) {
+        if (names.contains(it.key())) {
+            ++it;
+            continue;
+        }
+        if (!query.exec(QStringLiteral("DROP VIEW IF EXISTS ") + quotedName(it.key()))) {
+            LOG_FAILED_QUERY(query);
+        }
+        it = m_temporaryViews.erase(it);
+    }
+    for (const auto& view : temporaryViews) {
+        const auto it = m_temporaryViews.constFind(view.first);
+        if (it != m_temporaryViews.constEnd()) {
+            if (it.value() == view.second) {
+                continue;
+            }
+            // The view has been recreated with a different statement
+            if (!query.exec(QStringLiteral("DROP VIEW IF EXISTS ") + quotedName(view.first))) {
+                LOG_FAILED_QUERY(query);
+            }
+            m_temporaryViews.remove(view.first);
+        }
+        if (!query.exec(view.second)) {
+            LOG_FAILED_QUERY(query);
+            return false;
+        }
+        m_temporaryViews.insert(view.first, view.second);
+    }
+    return true;
+}
+
+void TrackTableQueryThread::slotExecuteQuery(const TrackTableQuery& query) {
+    if (query.isCanceled()) {
+        // A newer query of the same model is already queued
+        return;
+    }
+    const QSqlDatabase database = mixxx::DbConnectionPooled(m_pDbConnectionPool);
+    auto pResult = std::make_shared<TrackTableQueryResult>();
+    pResult->id = query.id;
+    pResult->pLatestId = query.pLatestId;
+    pResult->rowValues = ColumnarValues(query.tableColumnCount);
+    pResult->succeeded = updateTemporaryViews(database, query.temporaryViews) &&
+            executeQuery(database, query, pResult.get());
+    if (query.isCanceled()) {
+        return;
+    }
+    emit queryFinished(pResult);
+}
+
+bool TrackTableQueryThread::executeQuery(
+        const QSqlDatabase& database,
+        const TrackTableQuery& query,
+        TrackTableQueryResult* pResult) const {
+    QSqlQuery tableQuery(database);
+    // Avoids that QSqlCachedResult allocates a copy of the whole table
+    tableQuery.setForwardOnly(true);
+    if (!tableQuery.prepare(query.tableQuery) || !tableQuery.exec()) {
+        LOG_FAILED_QUERY(tableQuery);
+        return false;
+    }
+    // The first column always contains the id, see BaseSqlTableModel
+    QVector<QVariant> columnValues(query.tableColumnCount);
+    while (tableQuery.next()) {
+        for (int i = 0; i < query.tableColumnCount; ++i) {
+            columnValues[i] = tableQuery.value(i);
+        }
+        pResult->rowTrackIds.push_back(TrackId(columnValues[0]));
+        pResult->rowValues.appendRow(columnValues);
+        if (pResult->rowTrackIds.size() % kRowsPerCancelCheck == 0 &&
+                query.isCanceled()) {
+            return false;
+        }
+    }
+
+    if (query.trackSourceQuery.isEmpty() || query.isCanceled()) {
+        return true;
+    }
+    QSqlQuery trackSourceQuery(database);
+    trackSourceQuery.setForwardOnly(true);
+    if (!trackSourceQuery.prepare(query.trackSourceQuery) || !trackSourceQuery.exec()) {
+        LOG_FAILED_QUERY(trackSourceQuery);
+        return false;
+    }
+    pResult->trackSourceOrder.reserve(pResult->rowTrackIds.size());
+    while (trackSourceQuery.next()) {
+        pResult->trackSourceOrder.push_back(TrackId(trackSourceQuery.value(0)));
+        if (pResult->trackSourceOrder.size() % kRowsPerCancelCheck == 0 &&
+                query.isCanceled()) {
+            return false;
+        }
+    }
+    return true;
+}
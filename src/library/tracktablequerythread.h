@@ -0,0 +1,99 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QMetaType>
+#include <QPair>
+#include <QSqlDatabase>
+#include <QString>
+#include <QThread>
+#include <QVector>
+#include <atomic>
+#include <memory>
+
+#include "library/columnartrackcache.h"
+#include "track/trackid.h"
+#include "util/db/dbconnectionpool.h"
+
+/// The queries of BaseSqlTableModel::select() that are executed in
+/// background. Queries that are no longer the latest one of their model
+/// are skipped or aborted, e.g. while the user is typing a search.
+struct TrackTableQuery {
+    quint64 id = 0;
+    std::shared_ptr<const std::atomic<quint64>> pLatestId;
+    /// The names and CREATE statements of the temporary views of the
+    /// model's connection in the order they have been created
+    QList<QPair<QString, QString>> temporaryViews;
+    /// Selects the id and the other columns of the table
+    QString tableQuery;
+    int tableColumnCount = 0;
+    /// Selects the filtered and sorted ids of the track source, if any
+    QString trackSourceQuery;
+
+    bool isCanceled() const {
+        return !pLatestId || pLatestId->load() != id;
+    }
+};
+
+struct TrackTableQueryResult {
+    quint64 id = 0;
+    std::shared_ptr<const std::atomic<quint64>> pLatestId;
+    bool succeeded = false;
+    /// The rows of the table in the order of the table query
+    QVector<TrackId> rowTrackIds;
+    ColumnarValues rowValues;
+    QVector<TrackId> trackSourceOrder;
+};
+
+typedef std::shared_ptr<TrackTableQueryResult> TrackTableQueryResultPointer;
+
+Q_DECLARE_METATYPE(TrackTableQuery)
+Q_DECLARE_METATYPE(TrackTableQueryResultPointer)
+
+/// TrackTableQueryThread executes the queries that sort and filter the
+/// track tables on its own thread and database connection, so that
+/// sorting or searching a large library doesn't block the GUI thread.
+/// The results are delivered to all models, which pick their own results
+/// by the id of the query.
+class TrackTableQueryThread : public QThread {
+    Q_OBJECT
+  public:
+    explicit TrackTableQueryThread(mixxx::DbConnectionPoolPtr pDbConnectionPool);
+    ~TrackTableQueryThread() override;
+
+    /// Thread-safe, the result is delivered by queryFinished()
+    void submit(const TrackTableQuery& query);
+
+    /// Reads the temporary views of the connection in the order they have
+    /// been created. Returns false if tableName is a temporary table,
+    /// which can't be queried from another connection.
+    static bool readTemporaryViews(
+            const QSqlDatabase& database,
+            const QString& tableName,
+            QList<QPair<QString, QString>>* pTemporaryViews);
+
+  signals:
+    void queryRequested(const TrackTableQuery& query);
+    void queryFinished(const TrackTableQueryResultPointer& pResult);
+
+  protected:
+    void run() override;
+
+  private slots:
+    void slotExecuteQuery(const TrackTableQuery& query);
+
+  private:
+    bool updateTemporaryViews(
+            const QSqlDatabase& database,
+            const QList<QPair<QString, QString>>& temporaryViews);
+    bool executeQuery(
+            const QSqlDatabase& database,
+            const TrackTableQuery& query,
+            TrackTableQueryResult* pResult) const;
+
+    const mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+
+    // The CREATE statements of the temporary views that have been created
+    // on the connection of this thread
+    QHash<QString, QString> m_temporaryViews;
+};
@@ -9,6 +9,7 @@
 #include <QXmlStreamReader>
 #include <QtDebug>
 
+#include "library/externaltrackimporter.h"
 #include "library/library.h"
 #include "library/librarytablemodel.h"
 #include "library/missing_hidden/missingtablemodel.h"
@@ -206,20 +207,11 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
     thisThread->setPriority(QThread::LowPriority);
     //Invisible root item of Traktor's child model
     TreeItem* root = nullptr;
-    //Delete all table entries of Traktor feature
+    // Tracks and playlists are imported in a single transaction. The tracks
+    // are updated incrementally, the playlists are rebuilt.
     ScopedTransaction transaction(m_database);
     clearTable("traktor_playlist_tracks");
-    clearTable("traktor_library");
     clearTable("traktor_playlists");
-    transaction.commit();
-
-    transaction.transaction();
-    QSqlQuery query(m_database);
-    query.prepare("INSERT INTO traktor_library (artist, title, album, year,"
-                  "genre,comment,tracknumber,bpm, bitrate,duration, location,"
-                  "rating,key) VALUES (:artist, :title, :album, :year,:genre,"
-                  ":comment, :tracknumber,:bpm, :bitrate,:duration, :location,"
-                  ":rating,:key)");
 
     //Parse Trakor XML file using SAX (for performance)
     mixxx::FileInfo fileInfo(file);
@@ -228,6 +220,26 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
         qDebug() << "Cannot open Traktor music collection: " << traktor_file.errorString();
         return nullptr;
     }
+
+    ExternalTrackImporter importer(m_database,
+            "traktor_library",
+            {"location",
+                    "artist",
+                    "title",
+                    "album",
+                    "year",
+                    "genre",
+                    "comment",
+                    "tracknumber",
+                    "bpm",
+                    "bitrate",
+                    "duration",
+                    "rating",
+                    "key"});
+    if (!importer.begin(file)) {
+        return nullptr;
+    }
+
     QXmlStreamReader xml(&traktor_file);
     bool inCollectionTag = false;
     bool inPlaylistsTag = false;
@@ -238,12 +250,18 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
         xml.readNext();
         if (xml.isStartElement()) {
             if (xml.name() == QLatin1String("COLLECTION")) {
+                if (importer.isSourceFileUnchanged()) {
+                    // Only the playlists need to be parsed again
+                    importer.keepAllTracks();
+                    xml.skipCurrentElement();
+                    continue;
+                }
                 inCollectionTag = true;
             }
             // Each "ENTRY" tag in <COLLECTION> represents a track
             if (inCollectionTag && xml.name() == QLatin1String("ENTRY")) {
                 //parse track
-                parseTrack(xml, query);
+                parseTrack(xml, &importer);
                 ++nAudioFiles; //increment number of files in the music collection
             }
             if (xml.name() == QLatin1String("PLAYLISTS")) {
@@ -256,7 +274,7 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
 
                 if (nodetype == "FOLDER" && name == "$ROOT") {
                     //process all playlists
-                    root = parsePlaylists(xml);
+                    root = parsePlaylists(xml, importer);
                     isRootFolderParsed = true;
                 }
             }
@@ -270,7 +288,7 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
             }
         }
     }
-    if (xml.hasError()) {
+    if (xml.hasError() || m_cancelImport || !importer.commit()) {
          // do error handling
          qDebug() << "Cannot process Traktor music collection";
          if (root) {
@@ -286,7 +304,7 @@ TreeItem* TraktorFeature::importLibrary(const QString& file) {
     return root;
 }
 
-void TraktorFeature::parseTrack(QXmlStreamReader &xml, QSqlQuery &query) {
+void TraktorFeature::parseTrack(QXmlStreamReader& xml, ExternalTrackImporter* pImporter) {
     QString title;
     QString artist;
     QString album;
@@ -384,26 +402,19 @@ void TraktorFeature::parseTrack(QXmlStreamReader &xml, QSqlQuery &query) {
 
     // If we reach the end of ENTRY within the COLLECTION tag
     // Save parsed track to database
-    query.bindValue(":artist", artist);
-    query.bindValue(":title", title);
-    query.bindValue(":album", album);
-    query.bindValue(":genre", genre);
-    query.bindValue(":year", year);
-    query.bindValue(":duration", playtime);
-    query.bindValue(":location", location);
-    query.bindValue(":rating", rating);
-    query.bindValue(":comment", comment);
-    query.bindValue(":tracknumber", tracknumber);
-    query.bindValue(":key", key);
-    query.bindValue(":bpm", bpm);
-    query.bindValue(":bitrate", bitrate);
-
-    bool success = query.exec();
-    if (!success) {
-        qDebug() << "SQL Error in TraktorTableModel.cpp: line"
-                 << __LINE__ << " " << query.lastError();
-        return;
-    }
+    pImporter->importTrack({location,
+            artist,
+            title,
+            album,
+            year,
+            genre,
+            comment,
+            tracknumber,
+            bpm,
+            bitrate,
+            playtime,
+            rating,
+            key});
 }
 
 // Purpose: Parsing all the folder and playlists of Traktor
@@ -411,7 +422,8 @@ void TraktorFeature::parseTrack(QXmlStreamReader &xml, QSqlQuery &query) {
 // A folder can contain folders and playlists. A playlist contains entries but no folders.
 // In other words, Traktor uses a tree structure to organize music.
 // Inner nodes represent folders while leaves are playlists.
-TreeItem* TraktorFeature::parsePlaylists(QXmlStreamReader &xml) {
+TreeItem* TraktorFeature::parsePlaylists(
+        QXmlStreamReader& xml, const ExternalTrackImporter& importer) {
 
     qDebug() << "Process RootFolder";
     //Each playlist is unique and can be identified by a path in the tree structure.
@@ -459,8 +471,9 @@ TreeItem* TraktorFeature::parsePlaylists(QXmlStreamReader &xml) {
                     // process all the entries within the playlist 'name' having path 'current_path'
                     parsePlaylistEntries(xml,
                             current_path,
-                            std::move(query_insert_to_playlists),
-                            std::move(query_insert_to_playlist_tracks));
+                            importer,
+                            &query_insert_to_playlists,
+                            &query_insert_to_playlist_tracks);
                 }
             }
         }
@@ -489,14 +502,15 @@ TreeItem* TraktorFeature::parsePlaylists(QXmlStreamReader &xml) {
 void TraktorFeature::parsePlaylistEntries(
         QXmlStreamReader& xml,
         const QString& playlist_path,
-        QSqlQuery query_insert_into_playlist,
-        QSqlQuery query_insert_into_playlisttracks) {
+        const ExternalTrackImporter& importer,
+        QSqlQuery* pQueryInsertIntoPlaylist,
+        QSqlQuery* pQueryInsertIntoPlaylistTracks) {
     // In the database, the name of a playlist is specified by the unique path,
     // e.g., /someFolderA/someFolderB/playlistA"
-    query_insert_into_playlist.bindValue(":name", playlist_path);
+    pQueryInsertIntoPlaylist->bindValue(":name", playlist_path);
 
-    if (!query_insert_into_playlist.exec()) {
-        LOG_FAILED_QUERY(query_insert_into_playlist)
+    if (!pQueryInsertIntoPlaylist->exec()) {
+        LOG_FAILED_QUERY(*pQueryInsertIntoPlaylist)
                 << "Failed to insert playlist in TraktorTableModel:"
                 << playlist_path;
         return;
@@ -536,25 +550,13 @@ void TraktorFeature::parsePlaylistEntries(
                     #endif
 
                     //insert to database
-                    int track_id = -1;
-                    QSqlQuery finder_query(m_database);
-                    finder_query.prepare("select id from traktor_library where location=:path");
-                    finder_query.bindValue(":path", key);
-
-                    if (!finder_query.exec()) {
-                        LOG_FAILED_QUERY(finder_query) << "Could not get track id:" << key;
-                        continue;
-                    }
-
-                    if (finder_query.next()) {
-                        track_id = finder_query.value(finder_query.record().indexOf("id")).toInt();
-                    }
-
-                    query_insert_into_playlisttracks.bindValue(":playlist_id", playlist_id);
-                    query_insert_into_playlisttracks.bindValue(":track_id", track_id);
-                    query_insert_into_playlisttracks.bindValue(":position", playlist_position++);
-                    if (!query_insert_into_playlisttracks.exec()) {
-                        LOG_FAILED_QUERY(query_insert_into_playlisttracks)
+                    const int track_id = importer.trackId(key);
+                    pQueryInsertIntoPlaylistTracks->bindValue(":playlist_id", playlist_id);
+                    pQueryInsertIntoPlaylistTracks->bindValue(":track_id", track_id);
+                    pQueryInsertIntoPlaylistTracks->bindValue(
+                            ":position", playlist_position++);
+                    if (!pQueryInsertIntoPlaylistTracks->exec()) {
+                        LOG_FAILED_QUERY(*pQueryInsertIntoPlaylistTracks)
                                 << "trackid" << track_id << " with path " << key
                                 << "playlistname; " << playlist_path <<" with ID " << playlist_id;
                     }
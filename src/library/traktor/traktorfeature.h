@@ -11,6 +11,8 @@
 #include "library/baseexternalplaylistmodel.h"
 #include "library/treeitemmodel.h"
 
+class ExternalTrackImporter;
+
 class TraktorTrackModel : public BaseExternalTrackModel {
     Q_OBJECT
   public:
@@ -51,14 +53,15 @@ class TraktorFeature : public BaseExternalLibraryFeature {
             const QString& playlist) override;
     TreeItem* importLibrary(const QString& file);
     // parses a track in the music collection
-    void parseTrack(QXmlStreamReader &xml, QSqlQuery &query);
+    void parseTrack(QXmlStreamReader& xml, ExternalTrackImporter* pImporter);
     // Iterates over all playliost and folders and constructs the childmodel
-    TreeItem* parsePlaylists(QXmlStreamReader &xml);
+    TreeItem* parsePlaylists(QXmlStreamReader& xml, const ExternalTrackImporter& importer);
     // processes a particular playlist
     void parsePlaylistEntries(QXmlStreamReader& xml,
             const QString& playlist_path,
-            QSqlQuery query_insert_into_playlist,
-            QSqlQuery query_insert_into_playlisttracks);
+            const ExternalTrackImporter& importer,
+            QSqlQuery* pQueryInsertIntoPlaylist,
+            QSqlQuery* pQueryInsertIntoPlaylistTracks);
     void clearTable(const QString& table_name);
     static QString getTraktorMusicDatabase();
     // private fields
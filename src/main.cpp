@@ -1,5 +1,7 @@
 #include <QApplication>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
 #include <QPixmapCache>
 #include <QString>
 #include <QStringList>
@@ -7,25 +9,38 @@
 #include <QThread>
 #include <QtDebug>
 #include <QtGlobal>
+#include <algorithm>
 #include <cstdio>
 #include <stdexcept>
 
 #include "config.h"
 #include "controllers/controllermanager.h"
 #include "coreservices.h"
+#include "encoder/encoder.h"
+#include "engine/channels/enginedeck.h"
+#include "engine/engine.h"
+#include "engine/enginebuffer.h"
+#include "engine/enginemixer.h"
+#include "engine/offlinerenderer.h"
 #include "errordialoghandler.h"
 #include "mixxxapplication.h"
 #ifdef MIXXX_USE_QML
 #include "qml/qmlapplication.h"
 #endif
+#include "mixer/deck.h"
+#include "mixer/playermanager.h"
 #include "mixxxmainwindow.h"
 #if defined(__WINDOWS__)
 #include "nativeeventhandlerwin.h"
 #endif
+#include "recording/defs_recording.h"
+#include "soundio/soundmanager.h"
 #include "sources/soundsourceproxy.h"
 #include "util/cmdlineargs.h"
 #include "util/console.h"
+#include "util/defs.h"
 #include "util/logging.h"
+#include "util/math.h"
 #include "util/sandbox.h"
 #include "util/versionstore.h"
 
@@ -34,6 +49,9 @@ namespace {
 // Exit codes
 constexpr int kFatalErrorOnStartupExitCode = 1;
 constexpr int kParseCmdlineArgsErrorExitCode = 2;
+constexpr int kRenderOfflineErrorExitCode = 3;
+
+constexpr qint64 kRenderOfflineLoadTimeoutMillis = 30000;
 
 constexpr char kScaleFactorEnvVar[] = "QT_SCALE_FACTOR";
 const QString kConfigGroup = QStringLiteral("[Config]");
@@ -49,11 +67,95 @@ const QString kScaleFactorKey = QStringLiteral("ScaleFactor");
 // An indicator that the QPixmapCache was too small.
 constexpr int kPixmapCacheLimitAt100PercentZoom = 32 * 1024; // 32 MByte
 
+/// Renders the music files from the command line with the automation
+/// script of --render-offline without a sound device or a GUI.
+int renderOffline(MixxxApplication* pApp,
+        const std::shared_ptr<mixxx::CoreServices>& pCoreServices,
+        const CmdlineArgs& args) {
+    const auto soundConfig = pCoreServices->getSoundManager()->getConfig();
+    const mixxx::audio::SampleRate sampleRate = soundConfig.getSampleRate();
+    const SINT framesPerBuffer = math_min(
+            static_cast<SINT>(soundConfig.getFramesPerBuffer()),
+            static_cast<SINT>(kMaxEngineFrames));
+
+    QFile scriptFile(args.getRenderOfflineScriptPath());
+    if (!scriptFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qCritical() << "Failed to open the automation script"
+                    << scriptFile.fileName() << scriptFile.errorString();
+        return kRenderOfflineErrorExitCode;
+    }
+    QString errorMessage;
+    auto events = OfflineRenderer::parseAutomationScript(
+            &scriptFile, sampleRate, &errorMessage);
+    if (!events) {
+        qCritical() << errorMessage;
+        return kRenderOfflineErrorExitCode;
+    }
+    if (events->isEmpty()) {
+        qCritical() << "The automation script" << scriptFile.fileName() << "is empty";
+        return kRenderOfflineErrorExitCode;
+    }
+    const SINT numFrames = events->last().framePos;
+
+    // The decks only finish loading while the engine is processing, which
+    // no sound device does for us here. The decks are stopped, so the
+    // mix is silent and nothing is rendered yet.
+    EngineMixer* pEngineMixer = pCoreServices->getEngineMixer().get();
+    const auto pPlayerManager = pCoreServices->getPlayerManager();
+    QList<EngineBuffer*> loadingBuffers;
+    const QList<QString>& musicFiles = args.getMusicFiles();
+    for (int i = 0; i < static_cast<int>(PlayerManager::numDecks()) &&
+            i < musicFiles.count();
+            ++i) {
+        if (SoundSourceProxy::isFileNameSupported(musicFiles.at(i))) {
+            loadingBuffers.append(pPlayerManager->getDeck(i)
+                                          ->getEngineDeck()
+                                          ->getEngineBuffer());
+        }
+    }
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+    while (!std::all_of(loadingBuffers.cbegin(),
+            loadingBuffers.cend(),
+            [](EngineBuffer* pBuffer) { return pBuffer->isTrackLoaded(); })) {
+        if (loadTimer.elapsed() > kRenderOfflineLoadTimeoutMillis) {
+            qCritical() << "Timed out loading the music files for the offline rendering";
+            return kRenderOfflineErrorExitCode;
+        }
+        pEngineMixer->process(framesPerBuffer * mixxx::kEngineChannelOutputCount);
+        pApp->processEvents();
+        QThread::msleep(1);
+    }
+
+    OfflineRenderer renderer(pCoreServices->getSettings(),
+            pEngineMixer,
+            sampleRate,
+            framesPerBuffer);
+    renderer.setAutomation(std::move(*events));
+    const auto result = renderer.render(args.getRenderOfflineOutputPath(),
+            EncoderFactory::getFactory().getFormatFor(ENCODING_WAVE),
+            numFrames);
+    if (!result.success) {
+        qCritical() << "Offline rendering failed:" << result.errorMessage;
+        return kRenderOfflineErrorExitCode;
+    }
+    qInfo() << "Rendered" << args.getRenderOfflineOutputPath()
+            << "with realtime factor" << result.realtimeFactor(sampleRate);
+    return 0;
+}
+
 int runMixxx(MixxxApplication* pApp, const CmdlineArgs& args) {
     CmdlineArgs::Instance().parseForUserFeedback();
 
     const auto pCoreServices = std::make_shared<mixxx::CoreServices>(args, pApp);
 
+    if (args.getRenderOffline()) {
+        // Neither the GUI, the controllers nor the sound devices are set
+        // up, the renderer is the only one that drives the engine.
+        pCoreServices->initialize(pApp);
+        return renderOffline(pApp, pCoreServices, args);
+    }
+
     int exitCode;
 #ifdef MIXXX_USE_QML
     if (args.isQml()) {
@@ -156,6 +156,10 @@ DlgPrefWaveform::DlgPrefWaveform(
             &QCheckBox::clicked,
             this,
             &DlgPrefWaveform::slotSetZoomSynchronization);
+    connect(adaptiveQualityCheckBox,
+            &QCheckBox::toggled,
+            this,
+            &DlgPrefWaveform::slotSetAdaptiveQuality);
     connect(allVisualGain,
             QOverload<double>::of(&QDoubleSpinBox::valueChanged),
             this,
@@ -283,6 +287,7 @@ void DlgPrefWaveform::slotUpdate() {
     endOfTrackWarningTimeSpinBox->setValue(factory->getEndOfTrackWarningTime());
     endOfTrackWarningTimeSlider->setValue(factory->getEndOfTrackWarningTime());
     synchronizeZoomCheckBox->setChecked(factory->isZoomSync());
+    adaptiveQualityCheckBox->setChecked(factory->isAdaptiveQuality());
     allVisualGain->setValue(factory->getVisualGain(WaveformWidgetFactory::All));
     lowVisualGain->setValue(factory->getVisualGain(WaveformWidgetFactory::Low));
     midVisualGain->setValue(factory->getVisualGain(WaveformWidgetFactory::Mid));
@@ -366,6 +371,9 @@ void DlgPrefWaveform::slotResetToDefaults() {
 
     synchronizeZoomCheckBox->setChecked(true);
 
+    // Always render in full quality.
+    adaptiveQualityCheckBox->setChecked(false);
+
     // RGB overview.
     waveformOverviewComboBox->setCurrentIndex(
             waveformOverviewComboBox->findData(QVariant::fromValue(WOverview::Type::RGB)));
@@ -565,6 +573,10 @@ void DlgPrefWaveform::slotSetZoomSynchronization(bool checked) {
     WaveformWidgetFactory::instance()->setZoomSync(checked);
 }
 
+void DlgPrefWaveform::slotSetAdaptiveQuality(bool checked) {
+    WaveformWidgetFactory::instance()->setAdaptiveQuality(checked);
+}
+
 void DlgPrefWaveform::slotSetVisualGainAll(double gain) {
     WaveformWidgetFactory::instance()->setVisualGain(WaveformWidgetFactory::All,gain);
 }
@@ -56,7 +56,13 @@ void Engine::render() {
 }
 
 void Engine::render(BaseNode* pNode) {
-    pNode->render();
+    if (m_pObserver) {
+        m_pObserver->beginNode(Pass::Render, pNode);
+        pNode->render();
+        m_pObserver->endNode(Pass::Render, pNode);
+    } else {
+        pNode->render();
+    }
     pNode = pNode->firstChild();
     while (pNode) {
         if (!pNode->isSubtreeBlocked()) {
@@ -68,7 +74,14 @@ void Engine::render(BaseNode* pNode) {
 
 void Engine::preprocess() {
     for (auto pNode : m_pPreprocessNodes) {
-        if (!pNode->isSubtreeBlocked()) {
+        if (pNode->isSubtreeBlocked()) {
+            continue;
+        }
+        if (m_pObserver) {
+            m_pObserver->beginNode(Pass::Preprocess, pNode);
+            pNode->preprocess();
+            m_pObserver->endNode(Pass::Preprocess, pNode);
+        } else {
             pNode->preprocess();
         }
     }
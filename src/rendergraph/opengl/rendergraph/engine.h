@@ -12,6 +12,20 @@ class Engine;
 
 class rendergraph::Engine {
   public:
+    enum class Pass {
+        Preprocess,
+        Render,
+    };
+
+    /// Is called around the preprocess() and render() of every node, but not
+    /// around those of its children, e.g. for profiling.
+    class Observer {
+      public:
+        virtual ~Observer() = default;
+        virtual void beginNode(Pass pass, BaseNode* pNode) = 0;
+        virtual void endNode(Pass pass, BaseNode* pNode) = 0;
+    };
+
     Engine(std::unique_ptr<BaseNode> pRootNode);
     ~Engine();
 
@@ -23,12 +37,17 @@ class rendergraph::Engine {
     const QMatrix4x4& matrix() const {
         return m_matrix;
     }
+    /// The observer is not owned and may be nullptr
+    void setObserver(Observer* pObserver) {
+        m_pObserver = pObserver;
+    }
 
   private:
     void render(BaseNode* pNode);
     void resize(BaseNode* pNode, int, int);
 
     QMatrix4x4 m_matrix;
+    Observer* m_pObserver{};
     std::unique_ptr<BaseNode> m_pRootNode;
     std::vector<BaseNode*> m_pPreprocessNodes;
     std::vector<BaseNode*> m_pInitializeNodes;
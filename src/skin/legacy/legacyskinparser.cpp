@@ -1052,6 +1052,13 @@ QWidget* LegacySkinParser::parseOverview(const QDomElement& node) {
 
     commonWidgetSetup(node, overviewWidget);
     overviewWidget->setup(node, *m_pContext);
+#ifdef MIXXX_USE_QOPENGL
+    if (CmdlineArgs::Instance().getUseShaderOverview() &&
+            WaveformWidgetFactory::instance()->isOpenGlShaderAvailable() &&
+            !CmdlineArgs::Instance().getSafeMode()) {
+        overviewWidget->enableShaderRendering();
+    }
+#endif
     overviewWidget->installEventFilter(m_pKeyboard);
     overviewWidget->installEventFilter(m_pControllerManager->getControllerLearningEventFilter());
     overviewWidget->initWithTrack(pPlayer->getLoadedTrack());
@@ -339,6 +339,20 @@ class AudioSource : public UrlResource, public virtual /*implements*/ IAudioSour
     ReadableSampleFrames readSampleFrames(
             const WritableSampleFrames& sampleFrames);
 
+#ifdef __STEM__
+    /// Restricts decoding to the given stems of a multi-stem source without
+    /// changing the channel layout. The channels of all other stems are
+    /// filled with silence. An empty selection decodes all stems again.
+    ///
+    /// Returns the stems that are decoded from now on, or an empty selection
+    /// if all channels are decoded, e.g. for sources without stems.
+    virtual StemChannelSelection selectDecodedStems(
+            StemChannelSelection stemMask) {
+        Q_UNUSED(stemMask);
+        return StemChannelSelection();
+    }
+#endif
+
   protected:
     explicit AudioSource(const QUrl& url);
 
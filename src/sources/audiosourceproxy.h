@@ -23,6 +23,13 @@ class AudioSourceProxy : public AudioSource {
         m_pAudioSource->close();
     }
 
+#ifdef __STEM__
+    StemChannelSelection selectDecodedStems(
+            StemChannelSelection stemMask) override {
+        return m_pAudioSource->selectDecodedStems(stemMask);
+    }
+#endif
+
   protected:
     OpenResult tryOpen(
             OpenMode mode,
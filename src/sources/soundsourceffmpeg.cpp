@@ -883,56 +883,66 @@ void SoundSourceFFmpeg::close() {
     m_pavStream = nullptr;
 }
 
-namespace {
-SINT readNextPacket(
-        AVFormatContext* pavFormatContext,
-        AVStream* pavStream,
-        AVPacket* pavPacket,
-        SINT flushFrameIndex) {
+int SoundSourceFFmpeg::readNextAVPacket(AVPacket* pavPacket) {
     while (true) {
         // The underlying buffer will be provided by av_read_frame()
         // and is only borrowed until the next packet is read.
         DEBUG_ASSERT(!pavPacket->buf);
         const auto av_read_frame_result =
                 av_read_frame(
-                        pavFormatContext,
+                        m_pavInputFormatContext,
                         pavPacket);
         if (av_read_frame_result < 0) {
-            if (av_read_frame_result == AVERROR_EOF) {
-                // Enter drain mode: Flush the decoder with a final empty packet
-#if VERBOSE_DEBUG_LOG
-                kLogger.debug()
-                        << "EOF: Entering drain mode";
-#endif
-                pavPacket->stream_index = pavStream->index;
-                pavPacket->data = nullptr;
-                pavPacket->size = 0;
-                return flushFrameIndex;
-            } else {
-                kLogger.warning().noquote()
-                        << "av_read_frame() failed:"
-                        << SoundSourceFFmpeg::formatErrorString(av_read_frame_result);
-                return ReadAheadFrameBuffer::kInvalidFrameIndex;
-            }
+            return av_read_frame_result;
         }
 #if VERBOSE_DEBUG_LOG
         avTrace("Packet read from stream", *pavPacket);
 #endif
         DEBUG_ASSERT(pavPacket->data);
         DEBUG_ASSERT(pavPacket->size > 0);
-        if (pavPacket->stream_index == pavStream->index) {
+        if (pavPacket->stream_index == m_pavStream->index) {
             // Found a packet for the stream
-            break;
+            return 0;
+        }
+        av_packet_unref(pavPacket);
+    }
+}
+
+int SoundSourceFFmpeg::seekInput(int64_t seekTimestamp) {
+    return av_seek_frame(
+            m_pavInputFormatContext,
+            m_pavStream->index,
+            seekTimestamp,
+            AVSEEK_FLAG_BACKWARD);
+}
+
+SINT SoundSourceFFmpeg::readNextPacket(
+        AVPacket* pavPacket,
+        SINT flushFrameIndex) {
+    const int readResult = readNextAVPacket(pavPacket);
+    if (readResult < 0) {
+        if (readResult == AVERROR_EOF) {
+            // Enter drain mode: Flush the decoder with a final empty packet
+#if VERBOSE_DEBUG_LOG
+            kLogger.debug()
+                    << "EOF: Entering drain mode";
+#endif
+            pavPacket->stream_index = m_pavStream->index;
+            pavPacket->data = nullptr;
+            pavPacket->size = 0;
+            return flushFrameIndex;
         } else {
-            av_packet_unref(pavPacket);
+            kLogger.warning().noquote()
+                    << "av_read_frame() failed:"
+                    << formatErrorString(readResult);
+            return ReadAheadFrameBuffer::kInvalidFrameIndex;
         }
     }
-    DEBUG_ASSERT(pavPacket->stream_index == pavStream->index);
+    DEBUG_ASSERT(pavPacket->stream_index == m_pavStream->index);
     return (pavPacket->pts != AV_NOPTS_VALUE)
-            ? convertStreamTimeToFrameIndex(*pavStream, pavPacket->pts)
+            ? convertStreamTimeToFrameIndex(*m_pavStream, pavPacket->pts)
             : ReadAheadFrameBuffer::kUnknownFrameIndex;
 }
-} // namespace
 
 bool SoundSourceFFmpeg::adjustCurrentPosition(SINT startIndex) {
     DEBUG_ASSERT(frameIndexRange().containsIndex(startIndex));
@@ -966,11 +976,7 @@ bool SoundSourceFFmpeg::adjustCurrentPosition(SINT startIndex) {
     // Seek to new position
     const int64_t seekTimestamp =
             convertFrameIndexToStreamTime(*m_pavStream, seekIndex);
-    int av_seek_frame_result = av_seek_frame(
-            m_pavInputFormatContext,
-            m_pavStream->index,
-            seekTimestamp,
-            AVSEEK_FLAG_BACKWARD);
+    int av_seek_frame_result = seekInput(seekTimestamp);
     if (av_seek_frame_result < 0) {
         // Unrecoverable seek error: Invalidate the current position and abort
         kLogger.warning().noquote()
@@ -993,8 +999,6 @@ bool SoundSourceFFmpeg::consumeNextAVPacket(
     if (!*ppavNextPacket) {
         // Read next packet from stream
         const SINT packetFrameIndex = readNextPacket(
-                m_pavInputFormatContext,
-                m_pavStream,
                 m_pavPacket,
                 m_frameBuffer.writeIndex());
         if (packetFrameIndex == ReadAheadFrameBuffer::kInvalidFrameIndex) {
@@ -30,9 +30,25 @@ class SoundSourceFFmpeg : public SoundSource {
             OpenMode mode,
             const OpenParams& params) override;
 
+    // Reads the next packet of m_pavStream from the input. Returns 0
+    // on success or the negative error code of av_read_frame(), e.g.
+    // AVERROR_EOF at the end of the input.
+    virtual int readNextAVPacket(AVPacket* pavPacket);
+
+    // Seeks the input backward to the given timestamp of m_pavStream.
+    // Returns the result of av_seek_frame().
+    virtual int seekInput(int64_t seekTimestamp);
+
   private:
     const CSAMPLE* resampleDecodedAVFrame();
 
+    // Reads the next packet into pavPacket and returns its frame index.
+    // Returns ReadAheadFrameBuffer::kInvalidFrameIndex on errors and
+    // flushFrameIndex for the final empty packet that drains the decoder.
+    SINT readNextPacket(
+            AVPacket* pavPacket,
+            SINT flushFrameIndex);
+
     // Seek to the requested start index (if needed) or return false
     // upon seek errors.
     bool adjustCurrentPosition(
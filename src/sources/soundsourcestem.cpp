@@ -1,5 +1,8 @@
 #include "sources/soundsourcestem.h"
 
+#include <QtConcurrentMap>
+#include <numeric>
+
 #include "sources/readaheadframebuffer.h"
 
 extern "C" {
@@ -13,6 +16,7 @@ extern "C" {
 
 #include "util/assert.h"
 #include "util/logger.h"
+#include "util/mutex.h"
 #include "util/sample.h"
 
 #if !defined(VERBOSE_DEBUG_LOG)
@@ -29,6 +33,11 @@ constexpr int kRequiredStreamCount = kNumStreams - 1; // Stem count doesn't incl
 
 const Logger kLogger("SoundSourceSTEM");
 
+// An empty selection selects all stems
+bool isStemSelected(StemChannelSelection stemMask, std::size_t stemIdx) {
+    return !stemMask || stemMask.testFlag(static_cast<StemChannel>(1 << stemIdx));
+}
+
 } // anonymous namespace
 
 const QString SoundSourceProviderSTEM::kDisplayName = QStringLiteral("STEM with FFmpeg");
@@ -47,63 +56,245 @@ QString SoundSourceProviderSTEM::getVersionString() const {
     return QString::fromUtf8(av_version_info());
 }
 
+STEMDemuxer::STEMDemuxer(AVFormatContext* pavInputFormatContext)
+        : m_pavInputFormatContext(pavInputFormatContext),
+          m_pavPacket(av_packet_alloc()),
+          m_seekStreamIndex(-1),
+          m_seekTimestamp(AV_NOPTS_VALUE),
+          m_readError(0) {
+    DEBUG_ASSERT(m_pavInputFormatContext);
+    DEBUG_ASSERT(m_pavPacket);
+}
+
+STEMDemuxer::~STEMDemuxer() {
+    clearQueues();
+    av_packet_free(&m_pavPacket);
+    avformat_close_input(&m_pavInputFormatContext);
+}
+
+void STEMDemuxer::addStream(int streamIndex) {
+    const auto locker = lockMutex(&m_mutex);
+    VERIFY_OR_DEBUG_ASSERT(!findStreamQueue(streamIndex)) {
+        return;
+    }
+    m_streamQueues.emplace_back(streamIndex, StreamQueue{});
+}
+
+void STEMDemuxer::setStreamEnabled(int streamIndex, bool enabled) {
+    const auto locker = lockMutex(&m_mutex);
+    StreamQueue* pQueue = findStreamQueue(streamIndex);
+    VERIFY_OR_DEBUG_ASSERT(pQueue) {
+        return;
+    }
+    if (pQueue->enabled == enabled) {
+        return;
+    }
+    pQueue->enabled = enabled;
+    for (AVPacket* pavPacket : pQueue->packets) {
+        av_packet_free(&pavPacket);
+    }
+    pQueue->packets.clear();
+    // The stream has missed packets of the current position, so it can't
+    // acknowledge the last seek of the other streams
+    m_seekStreamIndex = -1;
+    m_seekTimestamp = AV_NOPTS_VALUE;
+    for (auto& [index, queue] : m_streamQueues) {
+        queue.seekPending = false;
+    }
+}
+
+STEMDemuxer::StreamQueue* STEMDemuxer::findStreamQueue(int streamIndex) {
+    for (auto& [index, queue] : m_streamQueues) {
+        if (index == streamIndex) {
+            return &queue;
+        }
+    }
+    return nullptr;
+}
+
+void STEMDemuxer::clearQueues() {
+    for (auto& [index, queue] : m_streamQueues) {
+        for (AVPacket* pavPacket : queue.packets) {
+            av_packet_free(&pavPacket);
+        }
+        queue.packets.clear();
+    }
+}
+
+int STEMDemuxer::readNextPacket(int streamIndex, AVPacket* pavPacket) {
+    const auto locker = lockMutex(&m_mutex);
+    StreamQueue* pQueue = findStreamQueue(streamIndex);
+    VERIFY_OR_DEBUG_ASSERT(pQueue && pQueue->enabled) {
+        return AVERROR(EINVAL);
+    }
+    if (pQueue->seekPending) {
+        // The stems are out of sync and the packets of the input no longer
+        // continue where this stream has stopped reading. Reading fails
+        // until the stream seeks again.
+        kLogger.warning()
+                << "Stream" << streamIndex
+                << "has not followed the last seek of stream"
+                << m_seekStreamIndex;
+        return AVERROR(EINVAL);
+    }
+    if (!pQueue->packets.empty()) {
+        AVPacket* pavQueuedPacket = pQueue->packets.front();
+        pQueue->packets.pop_front();
+        av_packet_move_ref(pavPacket, pavQueuedPacket);
+        av_packet_free(&pavQueuedPacket);
+        return 0;
+    }
+    if (m_readError < 0) {
+        return m_readError;
+    }
+    while (true) {
+        const auto av_read_frame_result =
+                av_read_frame(
+                        m_pavInputFormatContext,
+                        m_pavPacket);
+        if (av_read_frame_result < 0) {
+            // Also applies to the other streams that have already
+            // consumed all of their queued packets.
+            m_readError = av_read_frame_result;
+            return av_read_frame_result;
+        }
+        DEBUG_ASSERT(m_pavPacket->data);
+        DEBUG_ASSERT(m_pavPacket->size > 0);
+        if (m_pavPacket->stream_index == streamIndex) {
+            av_packet_move_ref(pavPacket, m_pavPacket);
+            return 0;
+        }
+        StreamQueue* pOtherQueue = findStreamQueue(m_pavPacket->stream_index);
+        if (pOtherQueue && pOtherQueue->enabled) {
+            // Keep the packet for the stem, which will read it later
+            AVPacket* pavQueuedPacket = av_packet_alloc();
+            av_packet_move_ref(pavQueuedPacket, m_pavPacket);
+            pOtherQueue->packets.push_back(pavQueuedPacket);
+        } else {
+            av_packet_unref(m_pavPacket);
+        }
+    }
+}
+
+int STEMDemuxer::seek(int streamIndex, int64_t seekTimestamp) {
+    const auto locker = lockMutex(&m_mutex);
+    StreamQueue* pQueue = findStreamQueue(streamIndex);
+    VERIFY_OR_DEBUG_ASSERT(pQueue) {
+        return AVERROR(EINVAL);
+    }
+    if (pQueue->seekPending &&
+            av_compare_ts(seekTimestamp,
+                    m_pavInputFormatContext->streams[streamIndex]->time_base,
+                    m_seekTimestamp,
+                    m_pavInputFormatContext->streams[m_seekStreamIndex]->time_base) ==
+                    0) {
+        // Another stem has already seeked to this position. All packets
+        // since then have been queued for this stream.
+        pQueue->seekPending = false;
+        return 0;
+    }
+    const int av_seek_frame_result = av_seek_frame(
+            m_pavInputFormatContext,
+            streamIndex,
+            seekTimestamp,
+            AVSEEK_FLAG_BACKWARD);
+    clearQueues();
+    m_readError = 0;
+    const bool seeked = av_seek_frame_result >= 0;
+    m_seekStreamIndex = seeked ? streamIndex : -1;
+    m_seekTimestamp = seeked ? seekTimestamp : AV_NOPTS_VALUE;
+    for (auto& [index, queue] : m_streamQueues) {
+        queue.seekPending = seeked && index != streamIndex;
+    }
+    return av_seek_frame_result;
+}
+
 SoundSourceSingleSTEM::SoundSourceSingleSTEM(const QUrl& url, unsigned int streamIdx)
         : SoundSourceFFmpeg(url), m_streamIdx(streamIdx) {
 }
 
+SoundSourceSingleSTEM::SoundSourceSingleSTEM(const QUrl& url,
+        unsigned int streamIdx,
+        std::shared_ptr<STEMDemuxer> pDemuxer)
+        : SoundSourceFFmpeg(url),
+          m_streamIdx(streamIdx),
+          m_pDemuxer(std::move(pDemuxer)) {
+}
+
+int SoundSourceSingleSTEM::readNextAVPacket(AVPacket* pavPacket) {
+    if (!m_pDemuxer) {
+        return SoundSourceFFmpeg::readNextAVPacket(pavPacket);
+    }
+    return m_pDemuxer->readNextPacket(m_pavStream->index, pavPacket);
+}
+
+int SoundSourceSingleSTEM::seekInput(int64_t seekTimestamp) {
+    if (!m_pDemuxer) {
+        return SoundSourceFFmpeg::seekInput(seekTimestamp);
+    }
+    return m_pDemuxer->seek(m_pavStream->index, seekTimestamp);
+}
+
 SoundSource::OpenResult SoundSourceSingleSTEM::tryOpen(
         OpenMode /*mode*/,
         const OpenParams& params) {
-    // Open input
-    {
-        AVFormatContext* pavInputFormatContext =
-                openInputFile(getLocalFileName());
-        if (pavInputFormatContext == nullptr) {
-            kLogger.warning()
-                    << "Failed to open input file"
-                    << getLocalFileName();
-            return OpenResult::Failed;
+    AVFormatContext* pavInputFormatContext = nullptr;
+    if (m_pDemuxer) {
+        // The shared input has already been opened and probed
+        pavInputFormatContext = m_pDemuxer->inputFormatContext();
+    } else {
+        // Open input
+        {
+            AVFormatContext* pavOpenedInputFormatContext =
+                    openInputFile(getLocalFileName());
+            if (pavOpenedInputFormatContext == nullptr) {
+                kLogger.warning()
+                        << "Failed to open input file"
+                        << getLocalFileName();
+                return OpenResult::Failed;
+            }
+            m_pavInputFormatContext.take(&pavOpenedInputFormatContext);
         }
-        m_pavInputFormatContext.take(&pavInputFormatContext);
-    }
+        pavInputFormatContext = m_pavInputFormatContext;
 #if VERBOSE_DEBUG_LOG
-    kLogger.debug()
-            << "AVFormatContext"
-            << "{ nb_streams" << m_pavInputFormatContext->nb_streams
-            << "| start_time" << m_pavInputFormatContext->start_time
-            << "| duration" << m_pavInputFormatContext->duration
-            << "| bit_rate" << m_pavInputFormatContext->bit_rate
-            << "| packet_size" << m_pavInputFormatContext->packet_size
-            << "| audio_codec_id" << m_pavInputFormatContext->audio_codec_id
-            << "| output_ts_offset" << m_pavInputFormatContext->output_ts_offset
-            << '}';
+        kLogger.debug()
+                << "AVFormatContext"
+                << "{ nb_streams" << pavInputFormatContext->nb_streams
+                << "| start_time" << pavInputFormatContext->start_time
+                << "| duration" << pavInputFormatContext->duration
+                << "| bit_rate" << pavInputFormatContext->bit_rate
+                << "| packet_size" << pavInputFormatContext->packet_size
+                << "| audio_codec_id" << pavInputFormatContext->audio_codec_id
+                << "| output_ts_offset" << pavInputFormatContext->output_ts_offset
+                << '}';
 #endif
 
-    // Retrieve stream information
-    const int avformat_find_stream_info_result =
-            avformat_find_stream_info(m_pavInputFormatContext, nullptr);
-    if (avformat_find_stream_info_result != 0) {
-        DEBUG_ASSERT(avformat_find_stream_info_result < 0);
-        kLogger.warning().noquote()
-                << "avformat_find_stream_info() failed:"
-                << formatErrorString(avformat_find_stream_info_result);
-        return OpenResult::Failed;
+        // Retrieve stream information
+        const int avformat_find_stream_info_result =
+                avformat_find_stream_info(pavInputFormatContext, nullptr);
+        if (avformat_find_stream_info_result != 0) {
+            DEBUG_ASSERT(avformat_find_stream_info_result < 0);
+            kLogger.warning().noquote()
+                    << "avformat_find_stream_info() failed:"
+                    << formatErrorString(avformat_find_stream_info_result);
+            return OpenResult::Failed;
+        }
     }
 
-    if (m_pavInputFormatContext->nb_streams <= m_streamIdx) {
+    if (pavInputFormatContext->nb_streams <= m_streamIdx) {
         kLogger.warning().noquote()
                 << "cannot find stream" << m_streamIdx;
         return OpenResult::Failed;
     }
 
-    if (m_pavInputFormatContext->streams[m_streamIdx]->codecpar->codec_type !=
+    if (pavInputFormatContext->streams[m_streamIdx]->codecpar->codec_type !=
             AVMEDIA_TYPE_AUDIO) {
         kLogger.warning().noquote()
                 << "selected stream isn't a valid audio stream";
         return OpenResult::Failed;
     }
 
-    AVStream* selectedAudioStream = m_pavInputFormatContext->streams[m_streamIdx];
+    AVStream* selectedAudioStream = pavInputFormatContext->streams[m_streamIdx];
 
     // Open the decoder for these streams
     const AVCodec* pDecoder = avcodec_find_decoder(selectedAudioStream->codecpar->codec_id);
@@ -318,8 +509,11 @@ SoundSource::OpenResult SoundSourceSTEM::tryOpen(
         kLogger.warning().noquote()
                 << "avformat_find_stream_info() failed:"
                 << SoundSourceFFmpeg::formatErrorString(avformat_find_stream_info_result);
+        avformat_close_input(&pavInputFormatContext);
         return OpenResult::Failed;
     }
+    // All stems are decoded from the packets of this single input
+    m_pDemuxer = std::make_shared<STEMDemuxer>(pavInputFormatContext);
 
     AVStream* firstAudioStream = nullptr;
     int stemCount = 0;
@@ -376,7 +570,9 @@ SoundSource::OpenResult SoundSourceSTEM::tryOpen(
             continue;
         }
 
-        m_pStereoStreams.emplace_back(std::make_unique<SoundSourceSingleSTEM>(getUrl(), streamIdx));
+        m_pDemuxer->addStream(static_cast<int>(streamIdx));
+        m_pStereoStreams.emplace_back(std::make_unique<SoundSourceSingleSTEM>(
+                getUrl(), streamIdx, m_pDemuxer));
         if (m_pStereoStreams.back()->open(OpenMode::Strict /*Unused*/,
                     stemParam) != OpenResult::Succeeded) {
             return OpenResult::Failed;
@@ -425,6 +621,42 @@ void SoundSourceSTEM::close() {
     }
 }
 
+StemChannelSelection SoundSourceSTEM::selectDecodedStems(
+        StemChannelSelection stemMask) {
+    const std::size_t stemCount = m_pStereoStreams.size();
+    if (m_requestedChannelCount != mixxx::audio::ChannelCount::stem() || stemCount <= 1) {
+        // All selected stems are mixed down into a single stereo channel
+        return StemChannelSelection();
+    }
+    const auto allStemsMask = StemChannelSelection::fromInt((1 << stemCount) - 1);
+    stemMask &= allStemsMask;
+    if (stemMask == allStemsMask) {
+        stemMask = StemChannelSelection();
+    }
+    if (stemMask == m_decodedStemMask) {
+        return m_decodedStemMask;
+    }
+
+    bool resumeDecoding = false;
+    for (std::size_t stemIdx = 0; stemIdx < stemCount; stemIdx++) {
+        const bool wasDecoded = isStemSelected(m_decodedStemMask, stemIdx);
+        const bool isDecoded = isStemSelected(stemMask, stemIdx);
+        m_pDemuxer->setStreamEnabled(
+                static_cast<int>(m_pStereoStreams[stemIdx]->streamIndex()),
+                isDecoded);
+        resumeDecoding |= isDecoded && !wasDecoded;
+    }
+    if (resumeDecoding) {
+        // The resumed stems have skipped packets. All stems seek together
+        // before the next read to stay in lockstep.
+        for (auto& pStream : m_pStereoStreams) {
+            pStream->invalidatePosition();
+        }
+    }
+    m_decodedStemMask = stemMask;
+    return m_decodedStemMask;
+}
+
 ReadableSampleFrames SoundSourceSTEM::readSampleFramesClamped(
         const WritableSampleFrames& globalSampleFrames) {
     VERIFY_OR_DEBUG_ASSERT(m_requestedChannelCount.isValid()) {
@@ -440,13 +672,6 @@ ReadableSampleFrames SoundSourceSTEM::readSampleFramesClamped(
     SINT stemSampleLength = m_pStereoStreams.front()->getSignalInfo().frames2samples(
             globalSampleFrames.frameLength());
 
-    // The same buffer is reused between requests tp prevent reallocation, but
-    // it will be reallocated if a larger chunk is requested and will keep the
-    // new maximum size
-    if (stemSampleLength > m_buffer.size()) {
-        m_buffer = SampleBuffer(stemSampleLength);
-    }
-
     ReadableSampleFrames read(globalSampleFrames.frameIndexRange(),
             SampleBuffer::ReadableSlice(
                     globalSampleFrames.writableData(),
@@ -454,43 +679,65 @@ ReadableSampleFrames SoundSourceSTEM::readSampleFramesClamped(
     std::size_t stemCount = m_pStereoStreams.size();
     CSAMPLE* pBuffer = globalSampleFrames.writableData();
 
-    if (m_requestedChannelCount == mixxx::audio::ChannelCount::stereo() && stemCount != 1) {
-        SampleUtil::clear(pBuffer, globalSampleFrames.writableLength());
-    } else {
-        DEBUG_ASSERT(stemSampleLength * static_cast<SINT>(stemCount) ==
-                globalSampleFrames.writableLength());
-    }
-
     if (stemCount == 1) {
         m_pStereoStreams[0]->readSampleFrames(globalSampleFrames);
         return read;
     }
 
-    for (std::size_t streamIdx = 0; streamIdx < stemCount; streamIdx++) {
-        WritableSampleFrames currentStemFrame = WritableSampleFrames(
-                globalSampleFrames.frameIndexRange(),
-                SampleBuffer::WritableSlice(
-                        m_buffer.data(),
-                        stemSampleLength));
-        m_pStereoStreams[streamIdx]->readSampleFrames(currentStemFrame);
-
-        // TODO(XXX): currently, stem samples are interleaved and packed
-        // next to each other as such:
-        //    1L1R1L1R1L1R...2L2R2L2R2L2R2L2R......3L3R3L3R3L3R3L3R......4L4R4L4R4L4R4L4R....
-        //    Can FFmpeg decode as without having to use a decoder per
-        //    channel? 1LLLLLLLLLLLLLL....1RRRRRRRRR...2LLLLLLL...?
-        if (m_requestedChannelCount != mixxx::audio::ChannelCount::stereo()) {
-            // Change the sample layout to interleave all channels together
-            for (SINT i = 0; i < stemSampleLength / 2; i++) {
-                pBuffer[2 * stemCount * i + 2 * streamIdx] = m_buffer[2 * i];
-                pBuffer[2 * stemCount * i + 2 * streamIdx + 1] = m_buffer[2 * i + 1];
-            }
-        } else {
-            // Change the sample layout to mix all channels together
-            for (SINT i = 0; i < stemSampleLength / 2; i++) {
-                pBuffer[2 * i] += m_buffer[2 * i];
-                pBuffer[2 * i + 1] += m_buffer[2 * i + 1];
-            }
+    // The same buffers are reused between requests to prevent reallocation,
+    // but they will be reallocated if a larger chunk is requested and will
+    // keep the new maximum size
+    m_stemBuffers.resize(stemCount);
+    for (auto& stemBuffer : m_stemBuffers) {
+        if (stemSampleLength > stemBuffer.size()) {
+            stemBuffer = SampleBuffer(stemSampleLength);
+        }
+    }
+
+    const bool mixdown = m_requestedChannelCount == mixxx::audio::ChannelCount::stereo();
+    if (!mixdown) {
+        DEBUG_ASSERT(stemSampleLength * static_cast<SINT>(stemCount) ==
+                globalSampleFrames.writableLength());
+    }
+
+    // The stems only share the demuxer, which dispatches the packets, so
+    // they are decoded in parallel. Each stem writes its own pair of
+    // channels into the interleaved output buffer:
+    //    1L1R2L2R3L3R4L4R1L1R2L2R3L3R4L4R...
+    std::vector<std::size_t> streamIndices(stemCount);
+    std::iota(streamIndices.begin(), streamIndices.end(), 0);
+    QtConcurrent::blockingMap(streamIndices,
+            [this, &globalSampleFrames, stemSampleLength, stemCount, mixdown, pBuffer](
+                    std::size_t streamIdx) {
+                CSAMPLE* pStemBuffer = m_stemBuffers[streamIdx].data();
+                if (!isStemSelected(m_decodedStemMask, streamIdx)) {
+                    // Not decoded, only its channels are cleared
+                    DEBUG_ASSERT(!mixdown);
+                    for (SINT i = 0; i < stemSampleLength / 2; i++) {
+                        pBuffer[2 * stemCount * i + 2 * streamIdx] = 0;
+                        pBuffer[2 * stemCount * i + 2 * streamIdx + 1] = 0;
+                    }
+                    return;
+                }
+                m_pStereoStreams[streamIdx]->readSampleFrames(WritableSampleFrames(
+                        globalSampleFrames.frameIndexRange(),
+                        SampleBuffer::WritableSlice(
+                                pStemBuffer,
+                                stemSampleLength)));
+                if (mixdown) {
+                    return;
+                }
+                for (SINT i = 0; i < stemSampleLength / 2; i++) {
+                    pBuffer[2 * stemCount * i + 2 * streamIdx] = pStemBuffer[2 * i];
+                    pBuffer[2 * stemCount * i + 2 * streamIdx + 1] = pStemBuffer[2 * i + 1];
+                }
+            });
+
+    if (mixdown) {
+        // Mix all stems together
+        SampleUtil::copy(pBuffer, m_stemBuffers[0].data(), stemSampleLength);
+        for (std::size_t streamIdx = 1; streamIdx < stemCount; streamIdx++) {
+            SampleUtil::add(pBuffer, m_stemBuffers[streamIdx].data(), stemSampleLength);
         }
     }
 
@@ -1,11 +1,79 @@
 #pragma once
 
+#include <QMutex>
+#include <deque>
+#include <memory>
+
 #include "sources/soundsourceffmpeg.h"
 #include "sources/soundsourceprovider.h"
 #include "util/samplebuffer.h"
 
 namespace mixxx {
 
+/// @brief Demux all streams of a stem file from a single input
+///
+/// Packets are read from the container once and dispatched to the decoder
+/// of the stem they belong to. Packets of other selected stems are queued
+/// until those decoders ask for them, packets of unselected streams are
+/// dropped. All stems of a file are read and seeked in lockstep, so the
+/// first stem requesting a seek performs it and the following requests for
+/// the same position only acknowledge it. Thread-safe, the stems may be
+/// decoded in parallel.
+class STEMDemuxer final {
+  public:
+    /// Takes ownership of an opened input with stream info.
+    explicit STEMDemuxer(AVFormatContext* pavInputFormatContext);
+    ~STEMDemuxer();
+
+    STEMDemuxer(const STEMDemuxer&) = delete;
+    STEMDemuxer& operator=(const STEMDemuxer&) = delete;
+
+    /// The input is owned by the demuxer. It must not be read from
+    /// directly after the first stream has been added.
+    AVFormatContext* inputFormatContext() const {
+        return m_pavInputFormatContext;
+    }
+
+    /// Registers a stream whose packets should be dispatched.
+    void addStream(int streamIndex);
+
+    /// Packets of disabled streams are dropped instead of being queued.
+    /// The next seek after enabling or disabling a stream is always
+    /// performed, i.e. not shared with previous seeks.
+    void setStreamEnabled(int streamIndex, bool enabled);
+
+    /// Moves the next packet of the stream into pavPacket. Returns 0 or the
+    /// error code of av_read_frame(), e.g. AVERROR_EOF.
+    int readNextPacket(int streamIndex, AVPacket* pavPacket);
+
+    /// Seeks backward to the timestamp of the stream. Returns the result of
+    /// av_seek_frame().
+    int seek(int streamIndex, int64_t seekTimestamp);
+
+  private:
+    struct StreamQueue {
+        std::deque<AVPacket*> packets;
+        // Another stream has seeked the input and this stream still needs
+        // to acknowledge that seek before reading any packets
+        bool seekPending = false;
+        bool enabled = true;
+    };
+
+    StreamQueue* findStreamQueue(int streamIndex);
+    void clearQueues();
+
+    AVFormatContext* m_pavInputFormatContext;
+    AVPacket* m_pavPacket;
+
+    QMutex m_mutex;
+    std::vector<std::pair<int, StreamQueue>> m_streamQueues;
+    // The last seek that was performed on the input
+    int m_seekStreamIndex;
+    int64_t m_seekTimestamp;
+    // The sticky error of av_read_frame() until the next seek
+    int m_readError;
+};
+
 /// @brief Handle a single stem embedded in a stem file
 class SoundSourceSingleSTEM : public SoundSourceFFmpeg {
   public:
@@ -13,13 +81,33 @@ class SoundSourceSingleSTEM : public SoundSourceFFmpeg {
     // because STEM may contain other non audio stream
     explicit SoundSourceSingleSTEM(const QUrl& url, unsigned int streamIdx);
 
+    // Decodes the stream with packets from a demuxer that is shared with
+    // the other stems of the file instead of opening the file again.
+    SoundSourceSingleSTEM(const QUrl& url,
+            unsigned int streamIdx,
+            std::shared_ptr<STEMDemuxer> pDemuxer);
+
+    unsigned int streamIndex() const {
+        return m_streamIdx;
+    }
+
+    // Forces a seek before the next read, e.g. after the stream
+    // has not been decoded for a while.
+    void invalidatePosition() {
+        m_frameBuffer.invalidate();
+    }
+
   protected:
     OpenResult tryOpen(
             OpenMode mode,
             const OpenParams& params) override;
 
+    int readNextAVPacket(AVPacket* pavPacket) override;
+    int seekInput(int64_t seekTimestamp) override;
+
   private:
     unsigned int m_streamIdx;
+    const std::shared_ptr<STEMDemuxer> m_pDemuxer;
 };
 
 /// @brief Handle a stem file, composed of multiple audio channel. Can open in
@@ -32,12 +120,21 @@ class SoundSourceSTEM : public SoundSource {
 
     void close() override;
 
+    /// Only has an effect if opened with all stems as separate channels.
+    /// The streams of the other stems are neither demuxed nor decoded.
+    StemChannelSelection selectDecodedStems(
+            StemChannelSelection stemMask) override;
+
   private:
+    std::shared_ptr<STEMDemuxer> m_pDemuxer;
     // Contains each stem source, or the main mix if opened in stereo mode
     std::vector<std::unique_ptr<SoundSourceSingleSTEM>> m_pStereoStreams;
-    SampleBuffer m_buffer;
+    // One decoding buffer per stem source, reused between requests
+    std::vector<SampleBuffer> m_stemBuffers;
 
     mixxx::audio::ChannelCount m_requestedChannelCount;
+    // The stems that are decoded, empty if all stems are decoded
+    StemChannelSelection m_decodedStemMask;
 
   protected:
     OpenResult tryOpen(
@@ -0,0 +1,155 @@
+#include "analyzer/analyzerexcerpts.h"
+
+#include <gtest/gtest.h>
+
+#include <QHash>
+#include <algorithm>
+#include <vector>
+
+#include "analyzer/analyzerfrontend.h"
+#include "analyzer/constants.h"
+#include "track/beatfactory.h"
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate = mixxx::audio::SampleRate(44100);
+constexpr SINT kFramesPerMinute = 60 * 44100;
+constexpr double kTolerance = 0.01;
+
+class ExcerptRecorder : public AnalyzerExcerpts::Callback {
+  public:
+    bool processFrames(AnalyzerFrontEnd* pFrontEnd, SINT offset, SINT frameCount) override {
+        framesProcessed.push_back(mixxx::IndexRange::forward(
+                pFrontEnd->frameIndex() + offset, frameCount));
+        return true;
+    }
+    std::optional<double> finishExcerpt(mixxx::IndexRange excerpt) override {
+        finishedExcerpts.push_back(excerpt);
+        return 128.0;
+    }
+    bool startPlugin() override {
+        ++startCount;
+        return true;
+    }
+
+    std::vector<mixxx::IndexRange> framesProcessed;
+    std::vector<mixxx::IndexRange> finishedExcerpts;
+    int startCount = 0;
+};
+
+TEST(AnalyzerExcerptsTest, SpreadAcrossTrack) {
+    const SINT frameLength = 5 * kFramesPerMinute;
+    const AnalyzerExcerpts excerpts(kSampleRate, frameLength, kTolerance);
+
+    ASSERT_EQ(mixxx::kFastAnalysisExcerptCount, excerpts.size());
+    EXPECT_EQ(0, excerpts.at(0).start());
+    EXPECT_EQ(frameLength, excerpts.at(excerpts.size() - 1).end());
+    for (int i = 0; i < excerpts.size(); ++i) {
+        EXPECT_EQ(mixxx::kFastAnalysisSecondsPerExcerpt * kSampleRate,
+                excerpts.at(i).length());
+        if (i > 0) {
+            EXPECT_LT(excerpts.at(i - 1).end(), excerpts.at(i).start());
+        }
+    }
+}
+
+TEST(AnalyzerExcerptsTest, ShortTrackIsOneExcerpt) {
+    const SINT frameLength = 20 * 44100;
+    const AnalyzerExcerpts excerpts(kSampleRate, frameLength, kTolerance);
+
+    ASSERT_EQ(1, excerpts.size());
+    EXPECT_EQ(mixxx::IndexRange::forward(0, frameLength), excerpts.at(0));
+}
+
+TEST(AnalyzerExcerptsTest, ConvergesAfterIntro) {
+    const SINT frameLength = 5 * kFramesPerMinute;
+    AnalyzerExcerpts excerpts(kSampleRate, frameLength, kTolerance);
+
+    // The intro without drums
+    excerpts.addEstimate(87.3);
+    excerpts.addEstimate(128.0);
+    excerpts.addEstimate(127.8);
+    EXPECT_FALSE(excerpts.isFinished());
+    EXPECT_EQ(excerpts.current().start(), excerpts.nextFrameNeeded(0));
+
+    excerpts.addEstimate(128.1);
+    EXPECT_TRUE(excerpts.hasConverged());
+    EXPECT_TRUE(excerpts.isFinished());
+    EXPECT_FALSE(excerpts.isLowConfidence());
+    EXPECT_EQ(128.0, excerpts.estimate());
+    EXPECT_FALSE(excerpts.agreesWithEstimate(0));
+    EXPECT_TRUE(excerpts.agreesWithEstimate(3));
+    // No more frames are needed
+    EXPECT_EQ(frameLength, excerpts.nextFrameNeeded(0));
+}
+
+TEST(AnalyzerExcerptsTest, ProcessChunks) {
+    const SINT frameLength = 5 * kFramesPerMinute;
+    AnalyzerExcerpts excerpts(kSampleRate, frameLength, kTolerance);
+    ExcerptRecorder recorder;
+
+    // Decode the frames that are needed like the AnalyzerThread
+    const SINT chunkFrames = 100000;
+    std::vector<CSAMPLE> samples(chunkFrames * mixxx::audio::ChannelCount::stereo());
+    AnalyzerFrontEnd frontEnd;
+    SINT frameIndex = 0;
+    while ((frameIndex = excerpts.nextFrameNeeded(frameIndex)) < frameLength) {
+        const SINT frameCount = std::min(chunkFrames, frameLength - frameIndex);
+        frontEnd.setChunk(samples.data(),
+                frameCount * mixxx::audio::ChannelCount::stereo(),
+                frameIndex);
+        ASSERT_TRUE(excerpts.processChunk(&frontEnd, &recorder));
+        frameIndex += frameCount;
+    }
+
+    // All estimates agree, so the estimate converges after the minimum
+    // number of excerpts
+    ASSERT_TRUE(excerpts.hasConverged());
+    ASSERT_EQ(mixxx::kFastAnalysisMinAgreeingExcerpts,
+            static_cast<int>(recorder.finishedExcerpts.size()));
+    // The plugin is started again for every excerpt but the first
+    EXPECT_EQ(mixxx::kFastAnalysisMinAgreeingExcerpts - 1, recorder.startCount);
+    SINT excerptFrames = 0;
+    for (int i = 0; i < static_cast<int>(recorder.finishedExcerpts.size()); ++i) {
+        EXPECT_EQ(excerpts.at(i), recorder.finishedExcerpts[i]);
+        excerptFrames += excerpts.at(i).length();
+    }
+    // Only the frames of the excerpts are processed
+    SINT framesProcessed = 0;
+    for (const auto& range : recorder.framesProcessed) {
+        framesProcessed += range.length();
+    }
+    EXPECT_EQ(excerptFrames, framesProcessed);
+}
+
+TEST(AnalyzerExcerptsTest, LowConfidenceIfDisagreeing) {
+    AnalyzerExcerpts excerpts(kSampleRate, 5 * kFramesPerMinute, kTolerance);
+
+    for (int i = 0; i < excerpts.size(); ++i) {
+        ASSERT_FALSE(excerpts.isFinished());
+        if (i % 3 == 0) {
+            excerpts.skipEstimate();
+        } else {
+            // Half and double tempo
+            excerpts.addEstimate(i % 2 == 0 ? 70.0 : 140.0);
+        }
+    }
+    EXPECT_TRUE(excerpts.isFinished());
+    EXPECT_FALSE(excerpts.hasConverged());
+    EXPECT_TRUE(excerpts.isLowConfidence());
+    EXPECT_TRUE(excerpts.estimate().has_value());
+}
+
+TEST(AnalyzerExcerptsTest, LowConfidenceVersionInfo) {
+    QHash<QString, QString> extraVersionInfo;
+    extraVersionInfo["vamp_plugin_id"] = "qm-tempotracker:0";
+    extraVersionInfo["fast_analysis"] = "1";
+    EXPECT_FALSE(AnalyzerExcerpts::isLowConfidence(
+            BeatFactory::getPreferredSubVersion(extraVersionInfo)));
+
+    AnalyzerExcerpts::markLowConfidence(&extraVersionInfo);
+    EXPECT_TRUE(AnalyzerExcerpts::isLowConfidence(
+            BeatFactory::getPreferredSubVersion(extraVersionInfo)));
+}
+
+} // namespace
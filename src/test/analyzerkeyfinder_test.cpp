@@ -0,0 +1,97 @@
+#if defined __KEYFINDER__
+
+#include "analyzer/plugins/analyzerkeyfinder.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "analyzer/constants.h"
+
+using mixxx::track::io::key::ChromaticKey;
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate = mixxx::audio::SampleRate(44100);
+
+// The notes of the tonic triads in two octaves
+const std::vector<double> kCMajorHz = {130.81, 261.63, 329.63, 392.00};
+const std::vector<double> kFSharpMajorHz = {185.00, 369.99, 466.16, 554.37};
+
+class AnalyzerKeyFinderTest : public testing::Test {
+  protected:
+    AnalyzerKeyFinderTest()
+            : m_currentFrame(0) {
+    }
+
+    void SetUp() override {
+        ASSERT_TRUE(m_keyFinder.initialize(kSampleRate));
+    }
+
+    // Feeds a chord, or silence without frequencies, in chunks like the
+    // AnalyzerThread
+    void process(const std::vector<double>& frequencies, int seconds) {
+        const SINT frameCount = seconds * kSampleRate;
+        std::vector<CSAMPLE> samples(mixxx::kAnalysisFramesPerChunk * mixxx::kAnalysisChannels);
+        for (SINT start = 0; start < frameCount; start += mixxx::kAnalysisFramesPerChunk) {
+            const SINT chunkFrames = std::min(mixxx::kAnalysisFramesPerChunk, frameCount - start);
+            for (SINT frame = 0; frame < chunkFrames; ++frame) {
+                const double time = static_cast<double>(m_currentFrame + frame) / kSampleRate;
+                double value = 0.0;
+                for (const double frequency : frequencies) {
+                    value += 0.2 * std::sin(2.0 * M_PI * frequency * time);
+                }
+                for (SINT channel = 0; channel < mixxx::kAnalysisChannels; ++channel) {
+                    samples[frame * mixxx::kAnalysisChannels + channel] =
+                            static_cast<CSAMPLE>(value);
+                }
+            }
+            ASSERT_TRUE(m_keyFinder.processSamples(
+                    samples.data(), chunkFrames * mixxx::kAnalysisChannels));
+            m_currentFrame += chunkFrames;
+        }
+    }
+
+    mixxx::AnalyzerKeyFinder m_keyFinder;
+    SINT m_currentFrame;
+};
+
+TEST_F(AnalyzerKeyFinderTest, KeyChangeAndSilentTail) {
+    process(kCMajorHz, 64);
+    process(kFSharpMajorHz, 64);
+    const SINT toneEnd = m_currentFrame;
+    process({}, 40);
+    ASSERT_TRUE(m_keyFinder.finalize());
+
+    const KeyChangeList keyChanges = m_keyFinder.getKeyChanges();
+    ASSERT_GE(keyChanges.size(), 2);
+    const ChromaticKey firstKey = keyChanges.first().first;
+    const ChromaticKey lastKey = keyChanges.last().first;
+    EXPECT_NE(ChromaticKey::INVALID, firstKey);
+    EXPECT_NE(ChromaticKey::INVALID, lastKey);
+    EXPECT_NE(firstKey, lastKey);
+    EXPECT_EQ(0.0, keyChanges.first().second);
+
+    // The key changes in the second half, which takes at least one segment
+    // to be detected, and the silent tail continues the last key
+    EXPECT_GT(keyChanges.last().second, 32.0 * kSampleRate);
+    EXPECT_LT(keyChanges.last().second, static_cast<double>(toneEnd));
+    for (const auto& keyChange : keyChanges) {
+        EXPECT_NE(ChromaticKey::INVALID, keyChange.first);
+    }
+}
+
+TEST_F(AnalyzerKeyFinderTest, SilentTrack) {
+    process({}, 40);
+    ASSERT_TRUE(m_keyFinder.finalize());
+
+    const KeyChangeList keyChanges = m_keyFinder.getKeyChanges();
+    ASSERT_EQ(1, keyChanges.size());
+    EXPECT_EQ(ChromaticKey::INVALID, keyChanges.first().first);
+}
+
+} // namespace
+
+#endif // __KEYFINDER__
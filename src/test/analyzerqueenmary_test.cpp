@@ -0,0 +1,202 @@
+#include <benchmark/benchmark.h>
+#include <dsp/transforms/FFT.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+// The analyzer headers come after the qm-dsp headers, like in the analyzers
+#include "analyzer/constants.h"
+#include "analyzer/plugins/analyzerqueenmarybeats.h"
+#include "analyzer/plugins/analyzerqueenmarykey.h"
+
+// Compares the FFTs of qm-dsp with a plain DFT, so that the results of the
+// analyzers don't depend on the FFT backend that qm-dsp was built with.
+// The benchmarks report the time to analyze one minute of a track:
+// mixxx-test --benchmark --benchmark_filter=BM_AnalyzerQueenMary
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate = mixxx::audio::SampleRate(44100);
+constexpr double kBpm = 128.0;
+// Relative to the size of the transform
+constexpr double kMaxFftError = 1e-12;
+
+std::vector<double> makeTestSignal(int size) {
+    std::vector<double> signal(size);
+    for (int i = 0; i < size; ++i) {
+        signal[i] = 0.5 * std::sin(0.05 * i) + 0.3 * std::cos(0.7 * i + 0.2) +
+                0.1 * ((i * 7919) % 13 - 6) / 6.0;
+    }
+    return signal;
+}
+
+std::vector<std::complex<double>> dft(const std::vector<double>& real,
+        const std::vector<double>& imag,
+        bool inverse) {
+    const auto size = real.size();
+    const double sign = inverse ? 1.0 : -1.0;
+    std::vector<std::complex<double>> result(size);
+    for (std::size_t k = 0; k < size; ++k) {
+        std::complex<double> sum;
+        for (std::size_t n = 0; n < size; ++n) {
+            // Reduce the product first to keep the phase accurate
+            const double phase = sign * 2.0 * M_PI * ((k * n) % size) / size;
+            sum += std::complex<double>(real[n], imag[n]) *
+                    std::polar(1.0, phase);
+        }
+        result[k] = inverse ? sum / static_cast<double>(size) : sum;
+    }
+    return result;
+}
+
+class AnalyzerQueenMaryFftTest : public testing::TestWithParam<int> {};
+
+INSTANTIATE_TEST_SUITE_P(AnalyzerQueenMaryFftTestSuite,
+        AnalyzerQueenMaryFftTest,
+        // The window sizes of the analyzers are powers of two, but the
+        // backends must support all even sizes.
+        testing::Values(64, 512, 1024, 2048, 1000));
+
+TEST_P(AnalyzerQueenMaryFftTest, RealForwardMatchesDft) {
+    const int size = GetParam();
+    const std::vector<double> input = makeTestSignal(size);
+    const auto expected = dft(input, std::vector<double>(size), false);
+
+    FFTReal fft(size);
+    std::vector<double> real(size);
+    std::vector<double> imag(size);
+    fft.forward(input.data(), real.data(), imag.data());
+    std::vector<double> magnitude(size);
+    fft.forwardMagnitude(input.data(), magnitude.data());
+
+    for (int i = 0; i < size; ++i) {
+        EXPECT_NEAR(expected[i].real(), real[i], kMaxFftError * size) << i;
+        EXPECT_NEAR(expected[i].imag(), imag[i], kMaxFftError * size) << i;
+        EXPECT_NEAR(std::abs(expected[i]), magnitude[i], kMaxFftError * size) << i;
+    }
+}
+
+TEST_P(AnalyzerQueenMaryFftTest, RealInverseRestoresSignal) {
+    const int size = GetParam();
+    const std::vector<double> input = makeTestSignal(size);
+
+    FFTReal fft(size);
+    std::vector<double> real(size);
+    std::vector<double> imag(size);
+    fft.forward(input.data(), real.data(), imag.data());
+    std::vector<double> output(size);
+    fft.inverse(real.data(), imag.data(), output.data());
+
+    for (int i = 0; i < size; ++i) {
+        EXPECT_NEAR(input[i], output[i], kMaxFftError * size) << i;
+    }
+}
+
+TEST_P(AnalyzerQueenMaryFftTest, ComplexMatchesDft) {
+    const int size = GetParam();
+    const std::vector<double> inputReal = makeTestSignal(size);
+    std::vector<double> inputImag = makeTestSignal(size);
+    std::reverse(inputImag.begin(), inputImag.end());
+
+    FFT fft(size);
+    std::vector<double> real(size);
+    std::vector<double> imag(size);
+    for (bool inverse : {false, true}) {
+        const auto expected = dft(inputReal, inputImag, inverse);
+        fft.process(inverse, inputReal.data(), inputImag.data(), real.data(), imag.data());
+        for (int i = 0; i < size; ++i) {
+            EXPECT_NEAR(expected[i].real(), real[i], kMaxFftError * size) << i;
+            EXPECT_NEAR(expected[i].imag(), imag[i], kMaxFftError * size) << i;
+        }
+    }
+}
+
+// A minute of stereo clicks at kBpm on top of an A minor chord
+const std::vector<CSAMPLE>& trackMinute() {
+    static const std::vector<CSAMPLE> samples = [] {
+        const SINT frames = 60 * kSampleRate;
+        const double framesPerBeat = kSampleRate * 60.0 / kBpm;
+        std::vector<CSAMPLE> samples(frames * mixxx::kAnalysisChannels);
+        for (SINT frame = 0; frame < frames; ++frame) {
+            const double time = static_cast<double>(frame) / kSampleRate;
+            double value = 0.1 * std::sin(2 * M_PI * 220.0 * time) +
+                    0.1 * std::sin(2 * M_PI * 261.63 * time) +
+                    0.1 * std::sin(2 * M_PI * 329.63 * time);
+            const double sinceBeat = std::fmod(static_cast<double>(frame), framesPerBeat);
+            value += 0.6 * std::exp(-sinceBeat / 200.0) *
+                    std::sin(2 * M_PI * 60.0 * sinceBeat / kSampleRate);
+            for (int channel = 0; channel < mixxx::kAnalysisChannels; ++channel) {
+                samples[frame * mixxx::kAnalysisChannels + channel] =
+                        static_cast<CSAMPLE>(value);
+            }
+        }
+        return samples;
+    }();
+    return samples;
+}
+
+template<typename Analyzer>
+void analyze(Analyzer* pAnalyzer) {
+    const std::vector<CSAMPLE>& samples = trackMinute();
+    const SINT chunkSize = mixxx::kAnalysisFramesPerChunk * mixxx::kAnalysisChannels;
+    pAnalyzer->initialize(kSampleRate);
+    for (SINT offset = 0; offset < static_cast<SINT>(samples.size()); offset += chunkSize) {
+        const SINT length = std::min(chunkSize, static_cast<SINT>(samples.size()) - offset);
+        pAnalyzer->processSamples(samples.data() + offset, length);
+    }
+    pAnalyzer->finalize();
+}
+
+TEST(AnalyzerQueenMaryTest, BeatsOfClickTrack) {
+    mixxx::AnalyzerQueenMaryBeats analyzer;
+    analyze(&analyzer);
+
+    const QVector<mixxx::audio::FramePos> beats = analyzer.getBeats();
+    ASSERT_GT(beats.size(), 100);
+    // Skip the start, where the tracker has not settled yet
+    const double framesPerBeat = (beats.last() - beats[10]) / (beats.size() - 11);
+    EXPECT_NEAR(kBpm, kSampleRate * 60.0 / framesPerBeat, 0.5);
+}
+
+void BM_AnalyzerQueenMaryBeats(benchmark::State& state) {
+    trackMinute();
+    for (auto _ : state) {
+        mixxx::AnalyzerQueenMaryBeats analyzer;
+        analyze(&analyzer);
+        const auto beats = analyzer.getBeats();
+        benchmark::DoNotOptimize(beats);
+    }
+}
+
+void BM_AnalyzerQueenMaryKey(benchmark::State& state) {
+    trackMinute();
+    for (auto _ : state) {
+        mixxx::AnalyzerQueenMaryKey analyzer;
+        analyze(&analyzer);
+        const auto keyChanges = analyzer.getKeyChanges();
+        benchmark::DoNotOptimize(keyChanges);
+    }
+}
+
+void BM_AnalyzerQueenMaryFftReal(benchmark::State& state) {
+    const int size = static_cast<int>(state.range(0));
+    const std::vector<double> input = makeTestSignal(size);
+    std::vector<double> real(size);
+    std::vector<double> imag(size);
+    FFTReal fft(size);
+    for (auto _ : state) {
+        fft.forward(input.data(), real.data(), imag.data());
+        benchmark::DoNotOptimize(real.data());
+    }
+    state.SetItemsProcessed(state.iterations() * size);
+}
+
+} // namespace
+
+// The time per iteration is the time per track-minute
+BENCHMARK(BM_AnalyzerQueenMaryBeats)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AnalyzerQueenMaryKey)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AnalyzerQueenMaryFftReal)->RangeMultiplier(2)->Range(512, 16384);
@@ -2,9 +2,12 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <vector>
 
+#include "analyzer/analyzerfrontend.h"
 #include "analyzer/analyzertrack.h"
+#include "analyzer/constants.h"
 #include "engine/engine.h"
 #include "test/mixxxtest.h"
 #include "track/track.h"
@@ -217,6 +220,56 @@ TEST_F(AnalyzerSilenceTest, RespectUserEdits) {
     EXPECT_DOUBLE_EQ(kManualOutroPosition.value(), pOutroCue->getLengthFrames());
 }
 
+TEST_F(AnalyzerSilenceTest, SilentTailAfterSkippedFrames) {
+    // A track of 90 seconds with sound from 1 to 20 seconds. The last
+    // minute is silent, so the last sound is in the frames that are skipped
+    // after the first sound has been found.
+    const auto sampleRate = mixxx::audio::SampleRate(44100);
+    const SINT frameLength = 90 * sampleRate;
+    const SINT soundStart = 1 * sampleRate;
+    const SINT soundEnd = 20 * sampleRate;
+    std::vector<CSAMPLE> samples(frameLength * kChannelCount, 0.0f);
+    std::fill(samples.begin() + soundStart * kChannelCount,
+            samples.begin() + soundEnd * kChannelCount,
+            0.5f);
+
+    ASSERT_TRUE(analyzerSilence.initialize(AnalyzerTrack(pTrack),
+            sampleRate,
+            mixxx::audio::ChannelCount(kChannelCount),
+            frameLength));
+    // Decode the frames that are needed like the AnalyzerThread
+    AnalyzerFrontEnd frontEnd(mixxx::audio::ChannelCount(kChannelCount));
+    SINT frameIndex = 0;
+    SINT framesDecoded = 0;
+    while (true) {
+        frameIndex = analyzerSilence.nextFrameNeeded(frameIndex);
+        if (frameIndex >= frameLength) {
+            break;
+        }
+        const SINT frameCount = std::min(
+                mixxx::kAnalysisFramesPerChunk, frameLength - frameIndex);
+        frontEnd.setChunk(samples.data() + frameIndex * kChannelCount,
+                frameCount * kChannelCount,
+                frameIndex);
+        ASSERT_TRUE(analyzerSilence.processChunk(&frontEnd));
+        frameIndex += frameCount;
+        framesDecoded += frameCount;
+    }
+    analyzerSilence.storeResults(pTrack);
+    analyzerSilence.cleanup();
+
+    // The skipped frames are decoded later, but the tail is not decoded
+    // twice
+    EXPECT_LT(framesDecoded, frameLength + mixxx::kAnalysisFramesPerChunk);
+
+    CuePointer pIntroCue = pTrack->findCueByType(mixxx::CueType::Intro);
+    EXPECT_EQ(mixxx::audio::FramePos(soundStart), pIntroCue->getPosition());
+
+    CuePointer pOutroCue = pTrack->findCueByType(mixxx::CueType::Outro);
+    EXPECT_EQ(mixxx::audio::kInvalidFramePos, pOutroCue->getPosition());
+    EXPECT_DOUBLE_EQ(soundEnd, pOutroCue->getLengthFrames());
+}
+
 TEST_F(AnalyzerSilenceTest, verifyFirstSound) {
     const CSAMPLE s[] = {
             0.0000f,
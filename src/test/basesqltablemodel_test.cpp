@@ -0,0 +1,178 @@
+#include "library/basesqltablemodel.h"
+
+#include <gtest/gtest.h>
+
+#include <QElapsedTimer>
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include "library/basetrackcache.h"
+#include "library/dao/trackschema.h"
+#include "library/librarytablemodel.h"
+#include "library/queryutil.h"
+#include "library/tracktablequerythread.h"
+#include "test/librarytest.h"
+#include "track/track.h"
+
+namespace {
+
+// The queries in background need a second connection to the same database
+const bool kInMemoryDbConnection = false;
+
+const int kTrackCount = 10;
+
+const qint64 kSelectTimeoutMillis = 10000;
+
+} // anonymous namespace
+
+class BaseSqlTableModelTest : public LibraryTest {
+  protected:
+    BaseSqlTableModelTest()
+            : LibraryTest(kInMemoryDbConnection) {
+    }
+
+    void SetUp() override {
+        ASSERT_NE(nullptr, trackCollectionManager()->trackTableQueryThread());
+
+        // The artists are numbered in reverse order of the track ids
+        for (int i = 0; i < kTrackCount; ++i) {
+            mixxx::FileInfo fileInfo(QDir(QDir::tempPath()),
+                    QStringLiteral("track%1.mp3").arg(i));
+            TrackPointer pTrack = Track::newTemporary(mixxx::FileAccess(fileInfo));
+            pTrack->setArtist(QStringLiteral("Artist %1").arg(kTrackCount - i, 2, 10, QChar('0')));
+            const TrackId trackId = internalCollection()->addTrack(pTrack, false);
+            ASSERT_TRUE(trackId.isValid());
+            m_trackIds.append(trackId);
+        }
+
+        const QStringList columns = {
+                LIBRARYTABLE_ID,
+                LIBRARYTABLE_ARTIST,
+                LIBRARYTABLE_TITLE,
+                TRACKLOCATIONSTABLE_LOCATION,
+                TRACKLOCATIONSTABLE_FSDELETED,
+                LIBRARYTABLE_MIXXXDELETED};
+        QStringList qualifiedColumns;
+        for (const auto& column : columns) {
+            qualifiedColumns.append(mixxx::trackschema::tableForColumn(column) +
+                    QLatin1Char('.') + column);
+        }
+        QSqlQuery query(internalCollection()->database());
+        query.prepare(QStringLiteral(
+                "CREATE TEMPORARY VIEW IF NOT EXISTS library_cache_view AS "
+                "SELECT %1 FROM library "
+                "INNER JOIN track_locations ON library.location = track_locations.id")
+                              .arg(qualifiedColumns.join(",")));
+        ASSERT_TRUE(query.exec()) << query.lastError().text();
+
+        internalCollection()->connectTrackSource(
+                QSharedPointer<BaseTrackCache>::create(internalCollection(),
+                        QStringLiteral("library_cache_view"),
+                        LIBRARYTABLE_ID,
+                        columns,
+                        QStringList{LIBRARYTABLE_ARTIST, LIBRARYTABLE_TITLE},
+                        true));
+
+        m_pModel = std::make_unique<LibraryTableModel>(nullptr,
+                trackCollectionManager(),
+                "mixxx.db.model.library");
+        QObject::connect(m_pModel.get(),
+                &BaseSqlTableModel::selectFinished,
+                m_pModel.get(),
+                [this] { ++m_selectFinishedCount; });
+        m_pModel->select();
+        ASSERT_EQ(kTrackCount, m_pModel->rowCount());
+    }
+
+    void TearDown() override {
+        m_pModel.reset();
+    }
+
+    bool waitForSelect() {
+        QElapsedTimer timer;
+        timer.start();
+        while (m_pModel->isSelectPending()) {
+            if (timer.elapsed() > kSelectTimeoutMillis) {
+                return false;
+            }
+            application()->processEvents();
+        }
+        // Results of stale queries that are still queued must be ignored
+        application()->processEvents();
+        return true;
+    }
+
+    QVector<TrackId> rowTrackIds() const {
+        QVector<TrackId> trackIds;
+        for (int row = 0; row < m_pModel->rowCount(); ++row) {
+            trackIds.append(m_pModel->getTrackId(m_pModel->index(row, 0)));
+        }
+        return trackIds;
+    }
+
+    int artistColumn() const {
+        return m_pModel->fieldIndex(ColumnCache::COLUMN_LIBRARYTABLE_ARTIST);
+    }
+
+    QVector<TrackId> m_trackIds;
+    std::unique_ptr<LibraryTableModel> m_pModel;
+    int m_selectFinishedCount = 0;
+};
+
+TEST_F(BaseSqlTableModelTest, SortInBackground) {
+    // Sorted by artist in ascending order, i.e. the last track first
+    QVector<TrackId> expectedTrackIds(m_trackIds.crbegin(), m_trackIds.crend());
+    ASSERT_EQ(expectedTrackIds, rowTrackIds());
+
+    m_pModel->sort(artistColumn(), Qt::DescendingOrder);
+    ASSERT_TRUE(m_pModel->isSelectPending());
+    // The previous rows remain until the result is swapped in
+    EXPECT_EQ(expectedTrackIds, rowTrackIds());
+
+    ASSERT_TRUE(waitForSelect());
+    EXPECT_EQ(1, m_selectFinishedCount);
+    EXPECT_EQ(m_trackIds, rowTrackIds());
+}
+
+TEST_F(BaseSqlTableModelTest, StaleSelectIsCanceled) {
+    m_pModel->sort(artistColumn(), Qt::DescendingOrder);
+    m_pModel->search(QStringLiteral("03"));
+    m_pModel->search(QStringLiteral("01"));
+    ASSERT_TRUE(m_pModel->isSelectPending());
+
+    // Only the latest query is applied
+    ASSERT_TRUE(waitForSelect());
+    EXPECT_EQ(1, m_selectFinishedCount);
+    EXPECT_EQ(QVector<TrackId>{m_trackIds.last()}, rowTrackIds());
+}
+
+TEST_F(BaseSqlTableModelTest, CanceledQueryIsSkipped) {
+    TrackTableQueryThread* pQueryThread =
+            trackCollectionManager()->trackTableQueryThread();
+    int queryFinishedCount = 0;
+    QObject receiver;
+    QObject::connect(pQueryThread,
+            &TrackTableQueryThread::queryFinished,
+            &receiver,
+            [&queryFinishedCount] { ++queryFinishedCount; });
+
+    const auto pLatestId = std::make_shared<std::atomic<quint64>>(2);
+    TrackTableQuery query;
+    query.pLatestId = pLatestId;
+    query.tableQuery = QStringLiteral("SELECT id FROM library");
+    query.tableColumnCount = 1;
+
+    // Superseded by the query with the latest id
+    query.id = 1;
+    pQueryThread->submit(query);
+    query.id = 2;
+    pQueryThread->submit(query);
+
+    QElapsedTimer timer;
+    timer.start();
+    while (queryFinishedCount == 0 && timer.elapsed() < kSelectTimeoutMillis) {
+        application()->processEvents();
+    }
+    application()->processEvents();
+    EXPECT_EQ(1, queryFinishedCount);
+}
@@ -0,0 +1,246 @@
+#include "library/columnartrackcache.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QHash>
+#include <algorithm>
+
+// The benchmarks compare the time to load the columns of a large library and
+// the memory that is needed afterwards, for a QVector<QVariant> per track
+// like BaseTrackCache did and for columnar storage:
+// mixxx-test --benchmark --benchmark_filter=BM_Library
+
+namespace {
+
+// artist, title, album, bpm, duration, times played, cover digest
+constexpr int kColumnCount = 7;
+
+QVector<QVariant> makeRow(int trackIndex) {
+    return {
+            QVariant(QStringLiteral("Artist %1").arg(trackIndex % 5000)),
+            QVariant(QStringLiteral("Title of track %1").arg(trackIndex)),
+            // Many tracks don't have an album
+            trackIndex % 3 == 0
+                    ? QVariant()
+                    : QVariant(QStringLiteral("Album %1").arg(trackIndex % 20000)),
+            QVariant(120.0 + trackIndex % 40),
+            QVariant(180.0 + trackIndex % 300),
+            QVariant(static_cast<qlonglong>(trackIndex % 17)),
+            QVariant(QByteArray(20, static_cast<char>(trackIndex))),
+    };
+}
+
+TEST(ColumnarValuesTest, TypedColumns) {
+    ColumnarValues values(kColumnCount);
+    for (int i = 0; i < 10; ++i) {
+        values.appendRow(makeRow(i));
+    }
+
+    ASSERT_EQ(10, values.rowCount());
+    for (int row = 0; row < values.rowCount(); ++row) {
+        const QVector<QVariant> expected = makeRow(row);
+        for (int column = 0; column < kColumnCount; ++column) {
+            const QVariant value = values.value(row, column);
+            EXPECT_EQ(expected[column].isNull(), value.isNull());
+            if (!expected[column].isNull()) {
+                EXPECT_EQ(expected[column], value);
+            }
+        }
+    }
+}
+
+TEST(ColumnarValuesTest, LeadingNullsAndMixedTypes) {
+    ColumnarValues values(1);
+    values.appendRow({QVariant()});
+    values.appendRow({QVariant(42LL)});
+    // SQLite is dynamically typed
+    values.appendRow({QVariant(QStringLiteral("42a"))});
+    values.appendRow({QVariant()});
+
+    EXPECT_TRUE(values.value(0, 0).isNull());
+    EXPECT_EQ(QVariant(42LL), values.value(1, 0));
+    EXPECT_EQ(QVariant(QStringLiteral("42a")), values.value(2, 0));
+    EXPECT_TRUE(values.value(3, 0).isNull());
+}
+
+TEST(ColumnarValuesTest, Reordered) {
+    ColumnarValues values(kColumnCount);
+    for (int i = 0; i < 5; ++i) {
+        values.appendRow(makeRow(i));
+    }
+
+    const ColumnarValues reordered = values.reordered({4, 0, 2});
+    ASSERT_EQ(3, reordered.rowCount());
+    EXPECT_EQ(values.value(4, 1), reordered.value(0, 1));
+    EXPECT_EQ(values.value(0, 1), reordered.value(1, 1));
+    EXPECT_EQ(values.value(2, 3), reordered.value(2, 3));
+    // Album of track 0 is NULL
+    EXPECT_TRUE(reordered.value(1, 2).isNull());
+}
+
+TEST(ColumnarValuesTest, MoveRow) {
+    ColumnarValues values(kColumnCount);
+    for (int i = 0; i < 5; ++i) {
+        values.appendRow(makeRow(i));
+    }
+
+    // Move down and back up again
+    values.moveRow(0, 3);
+    EXPECT_EQ(makeRow(1)[1], values.value(0, 1));
+    EXPECT_EQ(makeRow(3)[1], values.value(2, 1));
+    EXPECT_EQ(makeRow(0)[1], values.value(3, 1));
+    EXPECT_TRUE(values.value(3, 2).isNull());
+    EXPECT_EQ(makeRow(4)[1], values.value(4, 1));
+
+    values.moveRow(3, 0);
+    for (int row = 0; row < values.rowCount(); ++row) {
+        EXPECT_EQ(makeRow(row)[1], values.value(row, 1));
+        EXPECT_EQ(makeRow(row)[2].isNull(), values.value(row, 2).isNull());
+        EXPECT_EQ(makeRow(row)[6], values.value(row, 6));
+    }
+}
+
+TEST(ColumnarTrackCacheTest, LookupAndRemove) {
+    ColumnarTrackCache cache(100);
+    QVector<TrackId> trackIds;
+    ColumnarValues values(kColumnCount);
+    for (int i = 1; i <= 3; ++i) {
+        trackIds.append(TrackId(QVariant(i)));
+        values.appendRow(makeRow(i));
+    }
+    cache.insert(trackIds, values);
+
+    QVariant value;
+    ASSERT_TRUE(cache.lookup(trackIds[1], 1, &value));
+    EXPECT_EQ(makeRow(2)[1], value);
+    EXPECT_FALSE(cache.lookup(TrackId(QVariant(4)), 1, &value));
+
+    cache.remove({trackIds[1]});
+    EXPECT_FALSE(cache.contains(trackIds[1]));
+    EXPECT_TRUE(cache.contains(trackIds[2]));
+    EXPECT_EQ(2, cache.rowCount());
+}
+
+TEST(ColumnarTrackCacheTest, EvictLeastRecentlyUsed) {
+    constexpr int kBatchSize = 10;
+    ColumnarTrackCache cache(2 * kBatchSize);
+    for (int batch = 0; batch < 3; ++batch) {
+        QVector<TrackId> trackIds;
+        ColumnarValues values(kColumnCount);
+        for (int i = 0; i < kBatchSize; ++i) {
+            const int trackIndex = batch * kBatchSize + i + 1;
+            trackIds.append(TrackId(QVariant(trackIndex)));
+            values.appendRow(makeRow(trackIndex));
+        }
+        cache.insert(trackIds, values);
+        if (batch == 1) {
+            // Use the first batch, so that the second one is evicted
+            QVariant value;
+            EXPECT_TRUE(cache.lookup(TrackId(QVariant(1)), 0, &value));
+        }
+    }
+
+    EXPECT_EQ(2 * kBatchSize, cache.rowCount());
+    EXPECT_TRUE(cache.contains(TrackId(QVariant(1))));
+    EXPECT_FALSE(cache.contains(TrackId(QVariant(kBatchSize + 1))));
+    EXPECT_TRUE(cache.contains(TrackId(QVariant(2 * kBatchSize + 1))));
+}
+
+// The approximate heap memory of a QHash<TrackId, QVector<QVariant>> without
+// the contents of strings and byte arrays, see payloadMemoryUsage()
+std::size_t variantRowsMemoryUsage(const QHash<TrackId, QVector<QVariant>>& rows) {
+    // A hash node has a next pointer, the hash, the key and the value
+    constexpr std::size_t kNodeSize = sizeof(void*) + sizeof(uint) +
+            sizeof(TrackId) + sizeof(QVector<QVariant>);
+    // The array header of QVector
+    constexpr std::size_t kArrayHeaderSize = 3 * sizeof(void*);
+    std::size_t bytes = rows.capacity() * sizeof(void*);
+    for (const auto& row : rows) {
+        bytes += kNodeSize + kArrayHeaderSize + row.capacity() * sizeof(QVariant);
+    }
+    return bytes;
+}
+
+std::size_t payloadMemoryUsage(const QVector<QVariant>& row) {
+    std::size_t bytes = 0;
+    for (const auto& value : row) {
+        if (value.userType() == QMetaType::QString) {
+            bytes += value.toString().capacity() * sizeof(QChar);
+        } else if (value.userType() == QMetaType::QByteArray) {
+            bytes += value.toByteArray().capacity();
+        }
+    }
+    return bytes;
+}
+
+void BM_LibraryVariantRows(benchmark::State& state) {
+    const int trackCount = static_cast<int>(state.range(0));
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        QHash<TrackId, QVector<QVariant>> rows;
+        std::size_t payloadBytes = 0;
+        for (int i = 1; i <= trackCount; ++i) {
+            QVector<QVariant>& row = rows[TrackId(QVariant(i))];
+            row = makeRow(i);
+            payloadBytes += payloadMemoryUsage(row);
+        }
+        benchmark::DoNotOptimize(rows);
+        bytes = variantRowsMemoryUsage(rows) + payloadBytes;
+    }
+    state.counters["bytes_per_track"] = static_cast<double>(bytes) / trackCount;
+}
+
+void BM_LibraryColumnar(benchmark::State& state) {
+    const int trackCount = static_cast<int>(state.range(0));
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        // The sorted track ids and the values of the tracks in the cache
+        QVector<TrackId> trackIds;
+        ColumnarValues values(kColumnCount);
+        values.reserve(trackCount);
+        for (int i = 1; i <= trackCount; ++i) {
+            trackIds.append(TrackId(QVariant(i)));
+            values.appendRow(makeRow(i));
+        }
+        benchmark::DoNotOptimize(trackIds);
+        bytes = trackIds.capacity() * sizeof(TrackId) + values.memoryUsage();
+    }
+    state.counters["bytes_per_track"] = static_cast<double>(bytes) / trackCount;
+}
+
+void BM_LibraryLazyColumnar(benchmark::State& state) {
+    // Opening the table only needs the sorted track ids. The memory is
+    // measured after scrolling through the whole table, the cache stays
+    // bounded meanwhile.
+    constexpr int kRowsPerBatch = 256;
+    const int trackCount = static_cast<int>(state.range(0));
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        QVector<TrackId> trackIds;
+        for (int i = 1; i <= trackCount; ++i) {
+            trackIds.append(TrackId(QVariant(i)));
+        }
+        // Only the time to open the table is measured
+        state.PauseTiming();
+        ColumnarTrackCache cache(8192);
+        for (int first = 0; first < trackCount; first += kRowsPerBatch) {
+            const int count = std::min(kRowsPerBatch, trackCount - first);
+            ColumnarValues values(kColumnCount);
+            for (int i = 0; i < count; ++i) {
+                values.appendRow(makeRow(first + i + 1));
+            }
+            cache.insert(trackIds.mid(first, count), std::move(values));
+        }
+        benchmark::DoNotOptimize(trackIds);
+        bytes = trackIds.capacity() * sizeof(TrackId) + cache.memoryUsage();
+        state.ResumeTiming();
+    }
+    state.counters["bytes_per_track"] = static_cast<double>(bytes) / trackCount;
+}
+
+} // namespace
+
+BENCHMARK(BM_LibraryVariantRows)->Arg(300000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LibraryColumnar)->Arg(300000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LibraryLazyColumnar)->Arg(300000)->Unit(benchmark::kMillisecond);
@@ -51,3 +51,27 @@ TEST_F(ControllerRenderingEngineTest, createValidRendererWithSupportedTypes) {
         EXPECT_TRUE(screenTest.stop());
     }
 }
+
+TEST_F(ControllerRenderingEngineTest, changedAreaDetectsDirtyRegion) {
+    const auto& supportedPixelFormats = supportedPixelFormat();
+    for (const auto& pixelFormat : supportedPixelFormats) {
+        QImage previous(QSize(48, 27), pixelFormat);
+        previous.fill(Qt::black);
+        QImage current = previous.copy();
+
+        EXPECT_EQ(QRect(),
+                ControllerRenderingEngine::changedArea(previous, current));
+
+        current.setPixelColor(3, 4, Qt::white);
+        current.setPixelColor(20, 10, Qt::white);
+        EXPECT_EQ(QRect(QPoint(3, 4), QPoint(20, 10)),
+                ControllerRenderingEngine::changedArea(previous, current));
+
+        // Frames that can't be compared are fully dirty
+        EXPECT_EQ(current.rect(),
+                ControllerRenderingEngine::changedArea(QImage(), current));
+        EXPECT_EQ(current.rect(),
+                ControllerRenderingEngine::changedArea(
+                        previous.scaled(QSize(24, 27)), current));
+    }
+}
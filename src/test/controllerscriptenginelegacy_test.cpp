@@ -104,7 +104,7 @@ class ControllerScriptEngineLegacyTest : public ControllerScriptEngineLegacy, pu
             const LegacyControllerMapping::ScreenInfo& screeninfo,
             const QImage& frame,
             const QDateTime& timestamp) {
-        handleScreenFrame(screeninfo, frame, timestamp);
+        handleScreenFrame(screeninfo, frame, timestamp, frame.rect());
     }
 #endif
 };
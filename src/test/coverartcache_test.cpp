@@ -1,8 +1,11 @@
 #include <gtest/gtest.h>
+#include <QDateTime>
 #include <QFileInfo>
+#include <QTemporaryDir>
 
 #include "library/coverartcache.h"
 #include "library/coverartutils.h"
+#include "library/coverthumbnailstore.h"
 #include "library/trackcollection.h"
 #include "test/librarytest.h"
 #include "sources/soundsourceproxy.h"
@@ -88,3 +91,79 @@ TEST_F(CoverArtCacheTest, loadCoverFromFileAbsolute) {
             getTestDir().filePath(kCoverLocationTest),
             getTestDir().filePath(kCoverLocationTest));
 }
+
+TEST_F(CoverArtCacheTest, loadCoverFromThumbnailStore) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const CoverThumbnailStore thumbnailStore(tempDir.path());
+    constexpr int kWidth = 64;
+
+    const QString coverLocation = getTestDir().filePath(kCoverLocationTest);
+    const QImage img = QImage(coverLocation);
+    ASSERT_FALSE(img.isNull());
+    CoverInfo info;
+    info.type = CoverInfo::FILE;
+    info.source = CoverInfo::GUESSED;
+    info.coverLocation = coverLocation;
+    info.setImageDigest(img);
+    const QString thumbnailLocation = thumbnailStore.filePath(info.cacheKey(), kWidth);
+
+    // The first load decodes the cover and stores the thumbnail...
+    CoverArtCache::FutureResult res =
+            CoverArtCache::loadCover(TrackPointer(), info, kWidth, &thumbnailStore);
+    EXPECT_NE(thumbnailLocation, res.coverArt.loadedImage.location);
+    EXPECT_EQ(kWidth, res.coverArt.loadedImage.image.width());
+    EXPECT_TRUE(QFileInfo::exists(thumbnailLocation));
+
+    // ...which is loaded instead of the cover afterwards
+    res = CoverArtCache::loadCover(TrackPointer(), info, kWidth, &thumbnailStore);
+    EXPECT_EQ(CoverInfo::LoadedImage::Result::Ok, res.coverArt.loadedImage.result);
+    EXPECT_QSTRING_EQ(thumbnailLocation, res.coverArt.loadedImage.location);
+    EXPECT_EQ(kWidth, res.coverArt.loadedImage.image.width());
+    EXPECT_EQ(kWidth, res.coverArt.resizedToWidth);
+
+    // Full size covers are never stored
+    res = CoverArtCache::loadCover(TrackPointer(), info, 0, &thumbnailStore);
+    EXPECT_EQ(img, res.coverArt.loadedImage.image);
+    EXPECT_FALSE(QFileInfo::exists(thumbnailStore.filePath(info.cacheKey(), 0)));
+}
+
+TEST_F(CoverArtCacheTest, pruneLeastRecentlyUsedThumbnails) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    QImage image(16, 16, QImage::Format_RGB32);
+    image.fill(Qt::red);
+    constexpr int kWidth = 16;
+
+    // All thumbnails of the same image have the same size
+    qint64 thumbnailBytes;
+    {
+        const CoverThumbnailStore thumbnailStore(tempDir.filePath("probe"));
+        ASSERT_TRUE(thumbnailStore.save(0, kWidth, image));
+        thumbnailBytes = QFileInfo(thumbnailStore.filePath(0, kWidth)).size();
+        ASSERT_GT(thumbnailBytes, 0);
+    }
+
+    // Pruning keeps 3 of 5 thumbnails
+    const CoverThumbnailStore thumbnailStore(tempDir.filePath("store"), 4 * thumbnailBytes);
+    const QDateTime now = QDateTime::currentDateTime();
+    for (int i = 1; i <= 4; ++i) {
+        ASSERT_TRUE(thumbnailStore.save(i, kWidth, image));
+        // The first thumbnail is the oldest one
+        QFile file(thumbnailStore.filePath(i, kWidth));
+        ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+        ASSERT_TRUE(file.setFileTime(
+                now.addSecs(3600 * (i - 5)), QFileDevice::FileModificationTime));
+    }
+
+    // Loading the oldest thumbnail makes it the most recently used one
+    EXPECT_FALSE(thumbnailStore.load(1, kWidth).isNull());
+
+    // Exceeding the maximum size prunes the store
+    ASSERT_TRUE(thumbnailStore.save(5, kWidth, image));
+    EXPECT_TRUE(QFileInfo::exists(thumbnailStore.filePath(1, kWidth)));
+    EXPECT_FALSE(QFileInfo::exists(thumbnailStore.filePath(2, kWidth)));
+    EXPECT_FALSE(QFileInfo::exists(thumbnailStore.filePath(3, kWidth)));
+    EXPECT_TRUE(QFileInfo::exists(thumbnailStore.filePath(4, kWidth)));
+    EXPECT_TRUE(QFileInfo::exists(thumbnailStore.filePath(5, kWidth)));
+}
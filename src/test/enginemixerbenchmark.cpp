@@ -0,0 +1,167 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "effects/effectsmanager.h"
+#include "test/signalpathtest.h"
+#include "util/performancetimer.h"
+
+// End-to-end benchmarks of the whole engine callback, i.e. EngineMixer::process()
+// with real decks, samplers and effect units, as it is called by the sound device.
+// Run with: mixxx-test --benchmark --benchmark_filter=BM_EngineMixerProcess
+
+namespace {
+
+constexpr int kBaseDecks = 3;
+constexpr int kProcessIterations = 2000;
+// The decks play a loop at the start of the reference track, which fits
+// completely into the cache of the CachingReader. Thus no decoding happens
+// in the measured callbacks after the warm up.
+constexpr double kLoopSeconds = 10;
+// The default sample rate of EngineMixer
+constexpr double kSampleRate = 44100;
+
+// Sets up the engine like BaseSignalPathTest but with a configurable number
+// of decks, samplers and effect units, all of them playing.
+class EngineMixerBenchmarkSetup : public BaseSignalPathTest {
+  public:
+    EngineMixerBenchmarkSetup(int numDecks, int numSamplers, int numEffectUnits) {
+        BaseSignalPathTest::SetUp();
+
+        std::vector<BaseTrackPlayerImpl*> players = {
+                m_pMixerDeck1, m_pMixerDeck2, m_pMixerDeck3};
+        for (int i = kBaseDecks + 1; i <= numDecks; ++i) {
+            m_extraDecks.push_back(std::make_unique<Deck>(nullptr,
+                    m_pConfig,
+                    m_pEngineMixer,
+                    m_pEffectsManager,
+                    EngineChannel::CENTER,
+                    m_pEngineMixer->registerChannelGroup(
+                            QStringLiteral("[Channel%1]").arg(i))));
+            addDeck(m_extraDecks.back()->getEngineDeck());
+            players.push_back(m_extraDecks.back().get());
+        }
+        // Unused decks of the base setup stay empty and inactive
+        players.resize(numDecks);
+        for (int i = 1; i <= numSamplers; ++i) {
+            m_samplers.push_back(std::make_unique<Sampler>(nullptr,
+                    m_pConfig,
+                    m_pEngineMixer,
+                    m_pEffectsManager,
+                    EngineChannel::CENTER,
+                    m_pEngineMixer->registerChannelGroup(
+                            QStringLiteral("[Sampler%1]").arg(i))));
+            ControlObject::set(ConfigKey(m_samplers.back()->getGroup(), "main_mix"), 1.0);
+            players.push_back(m_samplers.back().get());
+        }
+
+        if (numEffectUnits > 0) {
+            m_pEffectsManager->setup();
+        }
+        for (int unit = 1; unit <= numEffectUnits; ++unit) {
+            const QString unitGroup = QStringLiteral("[EffectRack1_EffectUnit%1]").arg(unit);
+            ControlObject::set(ConfigKey(unitGroup, "enabled"), 1.0);
+            ControlObject::set(ConfigKey(unitGroup, "mix"), 0.5);
+            for (int effect = 1; effect <= 3; ++effect) {
+                ControlObject::set(ConfigKey(QStringLiteral("[EffectRack1_EffectUnit%1_Effect%2]")
+                                                   .arg(unit)
+                                                   .arg(effect),
+                                           "enabled"),
+                        1.0);
+            }
+            for (const auto* pPlayer : players) {
+                ControlObject::set(ConfigKey(unitGroup,
+                                           QStringLiteral("group_%1_enable")
+                                                   .arg(pPlayer->getGroup())),
+                        1.0);
+            }
+        }
+
+        const QString kTrackLocationTest = getTestDir().filePath(QStringLiteral("sine-30.wav"));
+        const double loopEndPosition =
+                kLoopSeconds * kSampleRate * mixxx::kEngineChannelOutputCount;
+        for (auto* pPlayer : players) {
+            loadTrack(pPlayer, TrackPointer(Track::newTemporary(kTrackLocationTest)));
+            const QString& group = pPlayer->getGroup();
+            ControlObject::set(ConfigKey(group, "loop_start_position"), 0.0);
+            ControlObject::set(ConfigKey(group, "loop_end_position"), loopEndPosition);
+            ControlObject::set(ConfigKey(group, "reloop_toggle"), 1.0);
+            ControlObject::set(ConfigKey(group, "play"), 1.0);
+        }
+
+        // Decode the whole loop once, without measuring it
+        m_pEngineMixer->setSynchronousReads(true);
+        const SINT warmUpFrames = static_cast<SINT>(kLoopSeconds * kSampleRate) + kMaxEngineFrames;
+        for (SINT frames = 0; frames < warmUpFrames; frames += kMaxEngineFrames) {
+            m_pEngineMixer->process(kMaxEngineSamples);
+        }
+    }
+
+    ~EngineMixerBenchmarkSetup() override {
+        m_pEngineMixer->setSynchronousReads(false);
+        m_samplers.clear();
+        m_extraDecks.clear();
+        BaseSignalPathTest::TearDown();
+    }
+
+    void process(std::size_t framesPerBuffer) {
+        m_pEngineMixer->process(framesPerBuffer * mixxx::kEngineChannelOutputCount);
+    }
+
+  private:
+    void TestBody() override {
+    }
+
+    std::vector<std::unique_ptr<Deck>> m_extraDecks;
+    std::vector<std::unique_ptr<Sampler>> m_samplers;
+};
+
+void reportPercentiles(benchmark::State& state, std::vector<double>* pCallbackMicros) {
+    if (pCallbackMicros->empty()) {
+        return;
+    }
+    std::sort(pCallbackMicros->begin(), pCallbackMicros->end());
+    const auto percentile = [pCallbackMicros](double p) {
+        const auto index = static_cast<std::size_t>(p * (pCallbackMicros->size() - 1));
+        return (*pCallbackMicros)[index];
+    };
+    state.counters["p50_us"] = percentile(0.5);
+    state.counters["p99_us"] = percentile(0.99);
+    state.counters["max_us"] = pCallbackMicros->back();
+}
+
+// Arguments: decks, samplers, effect units, frames per buffer
+void BM_EngineMixerProcess(benchmark::State& state) {
+    EngineMixerBenchmarkSetup setup(static_cast<int>(state.range(0)),
+            static_cast<int>(state.range(1)),
+            static_cast<int>(state.range(2)));
+    const auto framesPerBuffer = static_cast<std::size_t>(state.range(3));
+
+    std::vector<double> callbackMicros;
+    callbackMicros.reserve(kProcessIterations);
+    PerformanceTimer timer;
+    for (auto _ : state) {
+        timer.start();
+        setup.process(framesPerBuffer);
+        callbackMicros.push_back(timer.elapsed().toDoubleMicros());
+    }
+    state.SetItemsProcessed(state.iterations() * framesPerBuffer);
+    reportPercentiles(state, &callbackMicros);
+}
+
+} // namespace
+
+BENCHMARK(BM_EngineMixerProcess)
+        ->ArgNames({"decks", "samplers", "fx", "frames"})
+        ->Args({2, 0, 0, 64})
+        ->Args({2, 0, 0, 256})
+        ->Args({2, 0, 0, 1024})
+        ->Args({4, 0, 0, 256})
+        ->Args({4, 4, 0, 256})
+        ->Args({4, 4, 4, 64})
+        ->Args({4, 4, 4, 256})
+        ->Args({4, 4, 4, 1024})
+        ->Iterations(kProcessIterations)
+        ->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,108 @@
+#ifdef __ENGINEPRIME__
+
+#include "library/export/engineprimeexportjob.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include "library/export/engineprimeexportrequest.h"
+#include "test/librarytest.h"
+#include "track/track.h"
+
+namespace mixxx {
+
+namespace {
+
+const QString kTrackLocationA = QStringLiteral("id3-test-data/artist.mp3");
+const QString kTrackLocationB = QStringLiteral("id3-test-data/cover-test-png.mp3");
+
+struct ExportResult {
+    bool completed = false;
+    int numTracksExported = 0;
+    int numTracksSkipped = 0;
+    int numCopiesFailed = 0;
+};
+
+class EnginePrimeExportJobTest : public LibraryTest {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+        const QDir sourceDir(m_tempDir.filePath(QStringLiteral("source")));
+        ASSERT_TRUE(sourceDir.mkpath(QStringLiteral(".")));
+        internalCollection()->addDirectory(mixxx::FileInfo(sourceDir));
+
+        // The source files are copied, so that their ids prefix the
+        // file names of the exported files in a clean directory
+        for (const auto& location : {kTrackLocationA, kTrackLocationB}) {
+            const QString fileName = sourceDir.filePath(QFileInfo(location).fileName());
+            ASSERT_TRUE(QFile::copy(getTestDir().filePath(location), fileName));
+            TrackPointer pTrack = getOrAddTrackByLocation(fileName);
+            ASSERT_NE(nullptr, pTrack);
+            m_tracks.append(pTrack);
+        }
+    }
+
+    ExportResult exportLibrary() {
+        auto pRequest = QSharedPointer<EnginePrimeExportRequest>::create();
+        const QDir exportDir(m_tempDir.path());
+        pRequest->engineLibraryDbDir.setPath(
+                exportDir.filePath(djinterop::engine::default_database_dir_name));
+        pRequest->musicFilesDir.setPath(exportDir.filePath(QStringLiteral("Mixxx")));
+        pRequest->exportVersion = djinterop::engine::latest_os;
+
+        ExportResult result;
+        EnginePrimeExportJob job(nullptr, trackCollectionManager(), pRequest);
+        QObject::connect(&job,
+                &EnginePrimeExportJob::completed,
+                &job,
+                [&result](int numTracksExported,
+                        int numTracksSkipped,
+                        int,
+                        int numCopiesFailed) {
+                    result.completed = true;
+                    result.numTracksExported = numTracksExported;
+                    result.numTracksSkipped = numTracksSkipped;
+                    result.numCopiesFailed = numCopiesFailed;
+                });
+        job.start();
+        // The tracks are loaded on this thread while the job is waiting
+        while (!job.isFinished()) {
+            application()->processEvents();
+        }
+        application()->processEvents();
+        return result;
+    }
+
+    QTemporaryDir m_tempDir;
+    QList<TrackPointer> m_tracks;
+};
+
+TEST_F(EnginePrimeExportJobTest, ReexportSkipsUnchangedTracks) {
+    ExportResult result = exportLibrary();
+    ASSERT_TRUE(result.completed);
+    EXPECT_EQ(2, result.numTracksExported);
+    EXPECT_EQ(0, result.numTracksSkipped);
+    EXPECT_EQ(0, result.numCopiesFailed);
+
+    result = exportLibrary();
+    ASSERT_TRUE(result.completed);
+    EXPECT_EQ(2, result.numTracksExported);
+    EXPECT_EQ(2, result.numTracksSkipped);
+
+    // Only the changed track is exported again
+    m_tracks.first()->setTitle(QStringLiteral("Changed Title"));
+    result = exportLibrary();
+    ASSERT_TRUE(result.completed);
+    EXPECT_EQ(2, result.numTracksExported);
+    EXPECT_EQ(1, result.numTracksSkipped);
+    EXPECT_EQ(0, result.numCopiesFailed);
+}
+
+} // anonymous namespace
+
+} // namespace mixxx
+
+#endif // __ENGINEPRIME__
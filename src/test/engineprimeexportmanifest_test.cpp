@@ -0,0 +1,89 @@
+#ifdef __ENGINEPRIME__
+
+#include "library/export/engineprimeexportmanifest.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+namespace mixxx {
+
+namespace {
+
+class EnginePrimeExportManifestTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+    }
+
+    QDir engineLibraryDbDir() const {
+        return QDir(m_tempDir.path());
+    }
+
+    QTemporaryDir m_tempDir;
+};
+
+TEST_F(EnginePrimeExportManifestTest, SaveAndLoad) {
+    EnginePrimeExportManifest savedManifest(engineLibraryDbDir());
+    savedManifest.insert("Music/1 - a.mp3",
+            EnginePrimeExportManifest::Entry{QByteArray::fromHex("0123"), 1});
+    // Ids exceeding 32 bits must survive the round trip
+    savedManifest.insert("Music/2 - b.flac",
+            EnginePrimeExportManifest::Entry{QByteArray::fromHex("abcdef"), 1LL << 40});
+    ASSERT_TRUE(savedManifest.save());
+
+    EnginePrimeExportManifest manifest(engineLibraryDbDir());
+    manifest.load();
+    ASSERT_EQ(2, manifest.size());
+    const auto* pEntry = manifest.find("Music/1 - a.mp3");
+    ASSERT_NE(nullptr, pEntry);
+    EXPECT_EQ(QByteArray::fromHex("0123"), pEntry->exportHash);
+    EXPECT_EQ(1, pEntry->externalTrackId);
+    pEntry = manifest.find("Music/2 - b.flac");
+    ASSERT_NE(nullptr, pEntry);
+    EXPECT_EQ(QByteArray::fromHex("abcdef"), pEntry->exportHash);
+    EXPECT_EQ(1LL << 40, pEntry->externalTrackId);
+    EXPECT_EQ(nullptr, manifest.find("Music/3 - c.mp3"));
+}
+
+TEST_F(EnginePrimeExportManifestTest, SkipUnchangedTracks) {
+    const QByteArray exportHash = QByteArray::fromHex("0123");
+    {
+        EnginePrimeExportManifest manifest(engineLibraryDbDir());
+        manifest.insert("Music/1 - a.mp3", EnginePrimeExportManifest::Entry{exportHash, 7});
+        ASSERT_TRUE(manifest.save());
+    }
+
+    EnginePrimeExportManifest manifest(engineLibraryDbDir());
+    manifest.load();
+    const auto* pEntry = manifest.findUnchanged("Music/1 - a.mp3", exportHash);
+    ASSERT_NE(nullptr, pEntry);
+    EXPECT_EQ(7, pEntry->externalTrackId);
+
+    // Changed or new tracks are exported again
+    EXPECT_EQ(nullptr, manifest.findUnchanged("Music/1 - a.mp3", QByteArray::fromHex("4567")));
+    EXPECT_EQ(nullptr, manifest.findUnchanged("Music/2 - b.mp3", exportHash));
+}
+
+TEST_F(EnginePrimeExportManifestTest, LoadInvalidManifest) {
+    EnginePrimeExportManifest manifest(engineLibraryDbDir());
+    manifest.insert("Music/1 - a.mp3",
+            EnginePrimeExportManifest::Entry{QByteArray::fromHex("0123"), 1});
+    ASSERT_TRUE(manifest.save());
+
+    QFile file(manifest.filePath());
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write("{\"version\":");
+    file.close();
+
+    // All tracks are exported again
+    manifest.load();
+    EXPECT_EQ(0, manifest.size());
+}
+
+} // anonymous namespace
+
+} // namespace mixxx
+
+#endif // __ENGINEPRIME__
@@ -1,6 +1,7 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
@@ -3179,3 +3180,117 @@ TEST_F(EngineSyncTest, DISABLED_KeepCorrectFactorOnLoad) {
             ControlObject::get(ConfigKey(m_sGroup2, "rate")),
             0.005);
 }
+
+class EngineSyncBufferScaledCorrectionTest
+        : public EngineSyncTest,
+          public testing::WithParamInterface<int> {
+  protected:
+    void SetUp() override {
+        EngineSyncTest::SetUp();
+        mixxx::BeatsPointer pBeats1 = mixxx::Beats::fromConstTempo(
+                m_pTrack1->getSampleRate(), mixxx::audio::kStartFramePos, mixxx::Bpm(130));
+        m_pTrack1->trySetBeats(pBeats1);
+        mixxx::BeatsPointer pBeats2 = mixxx::Beats::fromConstTempo(
+                m_pTrack2->getSampleRate(), mixxx::audio::kStartFramePos, mixxx::Bpm(120));
+        m_pTrack2->trySetBeats(pBeats2);
+    }
+
+    double phaseError() const {
+        return BpmControl::shortestPercentageChange(
+                ControlObject::get(ConfigKey(m_sGroup1, "beat_distance")),
+                ControlObject::get(ConfigKey(m_sGroup2, "beat_distance")));
+    }
+
+    int sampleRate() const {
+        return static_cast<int>(ControlObject::get(ConfigKey("[App]", "samplerate")));
+    }
+
+    /// The beats the leader at 130 bpm advances per callback
+    double leaderBeatsPerCallback(int bufferSize) const {
+        // stereo samples, so divide by 2
+        return 130.0 / 60.0 * (bufferSize / 2) / sampleRate();
+    }
+
+    /// Lets the follower play in tempo but out of phase with the leader,
+    /// with the phase correction still disabled.
+    void startOutOfPhase(int bufferSize, bool bufferScaled) {
+        // Start both decks stopped at the track start
+        for (const auto& group : {m_sGroup1, m_sGroup2}) {
+            ControlObject::set(ConfigKey(group, "play"), 0.0);
+            ControlObject::set(ConfigKey(group, "sync_mode"),
+                    static_cast<double>(SyncMode::None));
+            ControlObject::set(ConfigKey(group, "quantize"), 0.0);
+            ControlObject::set(ConfigKey(group, "playposition"), 0.0);
+        }
+        ProcessBuffer();
+
+        ControlObject::set(ConfigKey(m_sInternalClockGroup, "sync_buffer_scaled_correction"),
+                bufferScaled ? 1.0 : 0.0);
+        ControlObject::set(ConfigKey(m_sGroup1, "sync_mode"),
+                static_cast<double>(SyncMode::LeaderExplicit));
+        ControlObject::set(ConfigKey(m_sGroup2, "sync_mode"),
+                static_cast<double>(SyncMode::Follower));
+
+        // Without quantize the follower starts playing out of phase.
+        ControlObject::set(ConfigKey(m_sGroup1, "play"), 1.0);
+        for (int i = 0; i < 4; ++i) {
+            ProcessBuffer();
+        }
+        ControlObject::set(ConfigKey(m_sGroup2, "play"), 1.0);
+        ProcessBuffer();
+        // Publish the advance of the leader for this buffer size
+        m_pEngineMixer->process(bufferSize);
+        EXPECT_GT(fabs(phaseError()), 0.05);
+    }
+
+    /// Brings the follower into phase with the leader from out of phase and
+    /// returns the largest phase error once it has settled.
+    double settledPhaseError(int bufferSize, bool bufferScaled) {
+        startOutOfPhase(bufferSize, bufferScaled);
+        ControlObject::set(ConfigKey(m_sGroup2, "quantize"), 1.0);
+
+        // Run for 8 seconds and take the largest error of the last 2 seconds
+        const int buffersPerSecond = 2 * sampleRate() / bufferSize;
+        double maxError = 0.0;
+        for (int i = 0; i < 8 * buffersPerSecond; ++i) {
+            m_pEngineMixer->process(bufferSize);
+            if (i >= 6 * buffersPerSecond) {
+                maxError = std::max(maxError, fabs(phaseError()));
+            }
+        }
+        EXPECT_NEAR(130.0, ControlObject::get(ConfigKey(m_sGroup2, "bpm")), 130.0 * 0.002);
+        return maxError;
+    }
+};
+
+INSTANTIATE_TEST_SUITE_P(EngineSyncBufferScaledCorrectionTestSuite,
+        EngineSyncBufferScaledCorrectionTest,
+        testing::Values(256, 1024, 4096, 8192));
+
+TEST_P(EngineSyncBufferScaledCorrectionTest, PhaseErrorAgainstBufferSize) {
+    const int bufferSize = GetParam();
+    startOutOfPhase(bufferSize, true);
+    const double initialError = fabs(phaseError());
+    ASSERT_LT(initialError, 0.2);
+
+    ControlObject::set(ConfigKey(m_sGroup2, "quantize"), 1.0);
+    m_pEngineMixer->process(bufferSize);
+
+    // The error of about a tenth of a beat exceeds what the slew limit of
+    // 0.1 per beat of callback allows to correct, so the rate changes by
+    // 0.1 * beatsPerCallback. The linear scaler ramps to the new rate
+    // within the callback, which closes half of the planned correction.
+    const double beatsPerCallback = leaderBeatsPerCallback(bufferSize);
+    const double plannedCorrection = 0.1 * beatsPerCallback * beatsPerCallback;
+    EXPECT_NEAR(initialError - plannedCorrection / 2,
+            fabs(phaseError()),
+            plannedCorrection / 4);
+
+    // Once in phase, the remaining phase error must not depend on the
+    // buffer size, and it must be smaller than the one left inside the dead
+    // band of the reactive correction.
+    const double reactiveError = settledPhaseError(bufferSize, false);
+    const double bufferScaledError = settledPhaseError(bufferSize, true);
+    EXPECT_LT(bufferScaledError, 0.002);
+    EXPECT_LT(bufferScaledError, reactiveError);
+}
@@ -0,0 +1,145 @@
+#include "library/externaltrackimporter.h"
+
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+
+#include "library/queryutil.h"
+#include "test/mixxxdbtest.h"
+
+namespace {
+
+const bool kInMemoryDbConnection = true;
+
+const QStringList kColumns = {"location", "artist", "title"};
+
+} // anonymous namespace
+
+class ExternalTrackImporterTest : public MixxxDbTest {
+  protected:
+    ExternalTrackImporterTest()
+            : MixxxDbTest(kInMemoryDbConnection) {
+    }
+
+    void SetUp() override {
+        ASSERT_TRUE(MixxxDb::initDatabaseSchema(dbConnection()));
+    }
+
+    int rowCount() const {
+        QSqlQuery query(dbConnection());
+        query.prepare("SELECT COUNT(*) FROM traktor_library");
+        if (!query.exec() || !query.next()) {
+            LOG_FAILED_QUERY(query);
+            return -1;
+        }
+        return query.value(0).toInt();
+    }
+
+    QString artist(int id) const {
+        QSqlQuery query(dbConnection());
+        query.prepare("SELECT artist FROM traktor_library WHERE id=:id");
+        query.bindValue(":id", id);
+        if (!query.exec() || !query.next()) {
+            return QString();
+        }
+        return query.value(0).toString();
+    }
+};
+
+TEST_F(ExternalTrackImporterTest, ReimportKeepsIds) {
+    int firstId;
+    int secondId;
+    int thirdId;
+    {
+        ExternalTrackImporter importer(dbConnection(), "traktor_library", kColumns);
+        ASSERT_TRUE(importer.begin());
+        firstId = importer.importTrack({"/music/1.mp3", "Artist 1", "Title 1"});
+        secondId = importer.importTrack({"/music/2.mp3", "Artist 2", "Title 2"});
+        thirdId = importer.importTrack({"/music/3.mp3", "Artist 3", "Title 3"});
+        EXPECT_EQ(secondId, importer.trackId("/music/2.mp3"));
+        ASSERT_TRUE(importer.commit());
+    }
+    EXPECT_EQ(3, rowCount());
+
+    // Change the second track, remove the third and add a fourth
+    ExternalTrackImporter importer(dbConnection(), "traktor_library", kColumns);
+    ASSERT_TRUE(importer.begin());
+    EXPECT_EQ(firstId, importer.importTrack({"/music/1.mp3", "Artist 1", "Title 1"}));
+    EXPECT_EQ(secondId, importer.importTrack({"/music/2.mp3", "Other", "Title 2"}));
+    const int fourthId = importer.importTrack({"/music/4.mp3", "Artist 4", "Title 4"});
+    EXPECT_NE(thirdId, fourthId);
+    EXPECT_EQ(QList<int>({secondId, fourthId}), importer.changedTrackIds());
+    ASSERT_TRUE(importer.commit());
+
+    EXPECT_EQ(3, rowCount());
+    EXPECT_EQ("Artist 1", artist(firstId));
+    EXPECT_EQ("Other", artist(secondId));
+    EXPECT_EQ(QString(), artist(thirdId));
+    EXPECT_EQ("Artist 4", artist(fourthId));
+    EXPECT_EQ(-1, importer.trackId("/music/3.mp3"));
+}
+
+TEST_F(ExternalTrackImporterTest, InsertInBatches) {
+    ExternalTrackImporter importer(dbConnection(), "traktor_library", kColumns);
+    ASSERT_TRUE(importer.begin());
+    const int trackCount = 1000;
+    for (int i = 0; i < trackCount; ++i) {
+        const QString location = QStringLiteral("/music/%1.mp3").arg(i);
+        ASSERT_GT(importer.importTrack({location, "Artist", "Title"}), 0);
+    }
+    ASSERT_TRUE(importer.commit());
+    EXPECT_EQ(trackCount, rowCount());
+}
+
+TEST_F(ExternalTrackImporterTest, FailedInsertFailsImport) {
+    // Tracks identified by the id of the external library
+    const QStringList columns = {"id", "artist", "title"};
+    ExternalTrackImporter importer(dbConnection(), "itunes_library", columns);
+    ASSERT_TRUE(importer.begin());
+    EXPECT_EQ(1, importer.importTrack({"1", "Artist 1", "Title 1"}));
+    // A different key with the same id, which violates the primary key when
+    // the batch is inserted
+    EXPECT_EQ(1, importer.importTrack({"01", "Artist 2", "Title 2"}));
+    int id = 0;
+    for (int i = 2; id >= 0 && i < 1000; ++i) {
+        id = importer.importTrack({QString::number(i), "Artist", "Title"});
+    }
+    EXPECT_EQ(-1, id);
+
+    // None of the following tracks is imported
+    EXPECT_EQ(-1, importer.importTrack({"1000", "Artist", "Title"}));
+    EXPECT_FALSE(importer.commit());
+}
+
+TEST_F(ExternalTrackImporterTest, SkipUnchangedSourceFile) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString filePath = tempDir.filePath("collection.nml");
+    QFile file(filePath);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("<NML></NML>");
+    file.close();
+
+    int id;
+    {
+        ExternalTrackImporter importer(dbConnection(), "traktor_library", kColumns);
+        ASSERT_TRUE(importer.begin(filePath));
+        EXPECT_FALSE(importer.isSourceFileUnchanged());
+        id = importer.importTrack({"/music/1.mp3", "Artist 1", "Title 1"});
+        ASSERT_TRUE(importer.commit());
+    }
+
+    ExternalTrackImporter importer(dbConnection(), "traktor_library", kColumns);
+    ASSERT_TRUE(importer.begin(filePath));
+    ASSERT_TRUE(importer.isSourceFileUnchanged());
+    importer.keepAllTracks();
+    EXPECT_EQ(id, importer.trackId("/music/1.mp3"));
+    ASSERT_TRUE(importer.commit());
+    EXPECT_EQ(1, rowCount());
+
+    // Without a file the library is always parsed again
+    ASSERT_TRUE(importer.begin());
+    EXPECT_FALSE(importer.isSourceFileUnchanged());
+}
@@ -0,0 +1,195 @@
+#include "util/fifo.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "util/types.h"
+
+namespace {
+
+TEST(FIFOTest, sizeIsRoundedUpToPowerOf2) {
+    FIFO<int> fifo(100);
+    EXPECT_EQ(128, fifo.writeAvailable());
+    EXPECT_EQ(0, fifo.readAvailable());
+}
+
+TEST(FIFOTest, writeAndReadWrapAround) {
+    FIFO<int> fifo(8);
+    std::vector<int> input(6);
+    std::iota(input.begin(), input.end(), 0);
+    std::vector<int> output(6);
+
+    // Move the indices close to the end of the buffer
+    ASSERT_EQ(6, fifo.write(input.data(), 6));
+    ASSERT_EQ(6, fifo.read(output.data(), 6));
+
+    std::iota(input.begin(), input.end(), 10);
+    ASSERT_EQ(6, fifo.write(input.data(), 6));
+    EXPECT_EQ(6, fifo.readAvailable());
+    EXPECT_EQ(2, fifo.writeAvailable());
+
+    // Only the free space is written
+    EXPECT_EQ(2, fifo.write(input.data(), 6));
+    EXPECT_EQ(0, fifo.writeAvailable());
+
+    ASSERT_EQ(6, fifo.read(output.data(), 6));
+    EXPECT_EQ(input, output);
+}
+
+TEST(FIFOTest, regionsAreSplitAtTheEndOfTheBuffer) {
+    FIFO<int> fifo(8);
+    std::vector<int> input(5, 1);
+    ASSERT_EQ(5, fifo.write(input.data(), 5));
+    ASSERT_EQ(5, fifo.flushReadData(5));
+
+    int* dataPtr1;
+    ring_buffer_size_t size1;
+    int* dataPtr2;
+    ring_buffer_size_t size2;
+    ASSERT_EQ(6, fifo.aquireWriteRegions(6, &dataPtr1, &size1, &dataPtr2, &size2));
+    EXPECT_EQ(3, size1);
+    EXPECT_EQ(3, size2);
+    std::iota(dataPtr1, dataPtr1 + size1, 0);
+    std::iota(dataPtr2, dataPtr2 + size2, size1);
+    // Nothing is visible to the reader before the release
+    EXPECT_EQ(0, fifo.readAvailable());
+    fifo.releaseWriteRegions(6);
+
+    ASSERT_EQ(6, fifo.aquireReadRegions(6, &dataPtr1, &size1, &dataPtr2, &size2));
+    ASSERT_EQ(3, size1);
+    ASSERT_EQ(3, size2);
+    for (int i = 0; i < size1; ++i) {
+        EXPECT_EQ(i, dataPtr1[i]);
+        EXPECT_EQ(size1 + i, dataPtr2[i]);
+    }
+    fifo.releaseReadRegions(6);
+    EXPECT_EQ(0, fifo.readAvailable());
+    EXPECT_EQ(8, fifo.writeAvailable());
+}
+
+TEST(FIFOTest, producerAndConsumerThreads) {
+    constexpr int kCount = 1 << 16;
+    FIFO<int> fifo(1024);
+    std::thread producer([&fifo] {
+        std::vector<int> chunk(100);
+        int next = 0;
+        while (next < kCount) {
+            const int chunkSize = std::min(static_cast<int>(chunk.size()), kCount - next);
+            std::iota(chunk.begin(), chunk.begin() + chunkSize, next);
+            next += fifo.write(chunk.data(), chunkSize);
+        }
+    });
+
+    std::vector<int> chunk(77);
+    int expected = 0;
+    bool inOrder = true;
+    while (expected < kCount) {
+        const int read = fifo.read(chunk.data(), static_cast<int>(chunk.size()));
+        for (int i = 0; i < read; ++i) {
+            inOrder &= chunk[i] == expected++;
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(inOrder);
+}
+
+// The PortAudio ring buffer, which backed FIFO before, for comparison
+class PaUtilFIFO {
+  public:
+    explicit PaUtilFIFO(int size)
+            : m_data(roundUpToPowerOf2(size)) {
+        PaUtil_InitializeRingBuffer(&m_ringBuffer,
+                static_cast<ring_buffer_size_t>(sizeof(CSAMPLE)),
+                static_cast<ring_buffer_size_t>(m_data.size()),
+                m_data.data());
+    }
+    int read(CSAMPLE* pData, int count) {
+        return PaUtil_ReadRingBuffer(&m_ringBuffer, pData, count);
+    }
+    int write(const CSAMPLE* pData, int count) {
+        return PaUtil_WriteRingBuffer(&m_ringBuffer, pData, count);
+    }
+
+  private:
+    std::vector<CSAMPLE> m_data;
+    PaUtilRingBuffer m_ringBuffer;
+};
+
+constexpr int kBenchmarkFifoSize = 65536;
+
+// Throughput of a write followed by a read of the same chunk on one thread
+template<typename Fifo>
+static void BM_WriteRead(benchmark::State& state) {
+    const int chunkSize = static_cast<int>(state.range(0));
+    Fifo fifo(kBenchmarkFifoSize);
+    std::vector<CSAMPLE> input(chunkSize, 0.5f);
+    std::vector<CSAMPLE> output(chunkSize);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(fifo.write(input.data(), chunkSize));
+        benchmark::DoNotOptimize(fifo.read(output.data(), chunkSize));
+    }
+    state.SetItemsProcessed(state.iterations() * chunkSize);
+}
+BENCHMARK_TEMPLATE(BM_WriteRead, FIFO<CSAMPLE>)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_WriteRead, PaUtilFIFO)->Range(64, 4096);
+
+// Throughput with the consumer running on a second thread
+template<typename Fifo>
+static void BM_ProducerConsumer(benchmark::State& state) {
+    const int chunkSize = static_cast<int>(state.range(0));
+    Fifo fifo(kBenchmarkFifoSize);
+    std::atomic<bool> stop(false);
+    std::thread consumer([&] {
+        std::vector<CSAMPLE> output(chunkSize);
+        while (!stop.load(std::memory_order_relaxed)) {
+            fifo.read(output.data(), chunkSize);
+        }
+    });
+    std::vector<CSAMPLE> input(chunkSize, 0.5f);
+    for (auto _ : state) {
+        int written = 0;
+        while (written < chunkSize) {
+            written += fifo.write(input.data() + written, chunkSize - written);
+        }
+    }
+    stop.store(true);
+    consumer.join();
+    state.SetItemsProcessed(state.iterations() * chunkSize);
+}
+BENCHMARK_TEMPLATE(BM_ProducerConsumer, FIFO<CSAMPLE>)->Range(64, 4096)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ProducerConsumer, PaUtilFIFO)->Range(64, 4096)->UseRealTime();
+
+// Round trip latency of a single sample through two FIFOs, ping-pong style
+template<typename Fifo>
+static void BM_RoundTripLatency(benchmark::State& state) {
+    Fifo request(1024);
+    Fifo response(1024);
+    std::atomic<bool> stop(false);
+    std::thread echo([&] {
+        CSAMPLE sample;
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (request.read(&sample, 1) == 1) {
+                while (response.write(&sample, 1) == 0) {
+                }
+            }
+        }
+    });
+    CSAMPLE sample = 0.5f;
+    for (auto _ : state) {
+        while (request.write(&sample, 1) == 0) {
+        }
+        while (response.read(&sample, 1) == 0) {
+        }
+    }
+    stop.store(true);
+    echo.join();
+}
+BENCHMARK_TEMPLATE(BM_RoundTripLatency, FIFO<CSAMPLE>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_RoundTripLatency, PaUtilFIFO)->UseRealTime();
+
+} // namespace
@@ -0,0 +1,69 @@
+#include "library/itunes/itunesdao.h"
+
+#include <gtest/gtest.h>
+
+#include <QSqlQuery>
+
+#include "library/itunes/itunespathmapping.h"
+#include "library/queryutil.h"
+#include "test/mixxxdbtest.h"
+
+namespace {
+
+const bool kInMemoryDbConnection = true;
+
+ITunesTrack makeTrack(int id, const QString& location) {
+    ITunesTrack track{};
+    track.id = id;
+    track.artist = QStringLiteral("Artist");
+    track.title = QStringLiteral("Title");
+    track.location = location;
+    return track;
+}
+
+} // anonymous namespace
+
+class ITunesDAOTest : public MixxxDbTest {
+  protected:
+    ITunesDAOTest()
+            : MixxxDbTest(kInMemoryDbConnection) {
+    }
+
+    void SetUp() override {
+        ASSERT_TRUE(MixxxDb::initDatabaseSchema(dbConnection()));
+        m_dao.initialize(dbConnection());
+    }
+
+    QString location(int id) const {
+        QSqlQuery query(dbConnection());
+        query.prepare("SELECT location FROM itunes_library WHERE id=:id");
+        query.bindValue(":id", id);
+        if (!query.exec() || !query.next()) {
+            LOG_FAILED_QUERY(query);
+            return QString();
+        }
+        return query.value(0).toString();
+    }
+
+    ITunesDAO m_dao;
+};
+
+TEST_F(ITunesDAOTest, ReimportMapsPathsOnce) {
+    // The Mixxx root contains the iTunes root
+    const ITunesPathMapping pathMapping{
+            QStringLiteral("/Users/x/"),
+            QStringLiteral("/Volumes/Mac/Users/x/")};
+
+    // The "Music Folder" is only known after the tracks have been imported
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_TRUE(m_dao.beginImport(QString()));
+        ASSERT_TRUE(m_dao.importTrack(makeTrack(1, QStringLiteral("/Users/x/1.mp3"))));
+        ASSERT_TRUE(m_dao.importTrack(makeTrack(2 + i, QStringLiteral("/Users/x/2.mp3"))));
+        ASSERT_TRUE(m_dao.finishImport());
+        ASSERT_TRUE(m_dao.applyPathMapping(pathMapping));
+    }
+
+    EXPECT_EQ(QStringLiteral("/Volumes/Mac/Users/x/1.mp3"), location(1));
+    EXPECT_EQ(QString(), location(2));
+    EXPECT_EQ(QStringLiteral("/Volumes/Mac/Users/x/2.mp3"), location(3));
+}
@@ -6,8 +6,6 @@
 
 namespace {
 
-const bool kInMemoryDbConnection = true;
-
 void deleteTrack(Track* pTrack) {
     // Delete track objects directly in unit tests with
     // no main event loop
@@ -30,8 +28,8 @@ std::unique_ptr<TrackCollectionManager> newTrackCollectionManager(
 
 } // namespace
 
-LibraryTest::LibraryTest()
-        : MixxxDbTest(kInMemoryDbConnection),
+LibraryTest::LibraryTest(bool inMemoryDbConnection)
+        : MixxxDbTest(inMemoryDbConnection),
           m_pTrackCollectionManager(newTrackCollectionManager(config(), dbConnectionPooler())),
           m_keyNotationCO(mixxx::library::prefs::kKeyNotationConfigKey) {
     CoverArtCache::createInstance();
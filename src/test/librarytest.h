@@ -13,7 +13,9 @@
 
 class LibraryTest : public MixxxDbTest, SoundSourceProviderRegistration {
   protected:
-    LibraryTest();
+    // Track table queries in background are only enabled for a
+    // file-backed database
+    explicit LibraryTest(bool inMemoryDbConnection = true);
     ~LibraryTest() override;
 
     TrackCollectionManager* trackCollectionManager() const {
@@ -0,0 +1,167 @@
+#include "util/multireaderringbuffer.h"
+
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <vector>
+
+namespace {
+
+class MultiReaderRingBufferTest : public testing::Test {
+  protected:
+    static std::vector<int> readAll(MultiReaderRingBuffer<int>* pBuffer,
+            MultiReaderRingBuffer<int>::ReaderId reader) {
+        const int* pData1;
+        int size1;
+        const int* pData2;
+        int size2;
+        const int available = pBuffer->acquireReadRegions(
+                reader, pBuffer->size(), &pData1, &size1, &pData2, &size2);
+        std::vector<int> result(pData1, pData1 + size1);
+        result.insert(result.end(), pData2, pData2 + size2);
+        pBuffer->releaseReadRegions(reader, available);
+        return result;
+    }
+};
+
+TEST_F(MultiReaderRingBufferTest, ReadersHaveIndependentCursors) {
+    MultiReaderRingBuffer<int> buffer(16, 2);
+    const auto reader1 = buffer.addReader();
+    const auto reader2 = buffer.addReader();
+    ASSERT_NE(reader1, reader2);
+
+    std::vector<int> input(10);
+    std::iota(input.begin(), input.end(), 0);
+    EXPECT_EQ(10, buffer.write(input.data(), 10));
+
+    EXPECT_EQ(input, readAll(&buffer, reader1));
+    EXPECT_EQ(0, buffer.readAvailable(reader1));
+    EXPECT_EQ(10, buffer.readAvailable(reader2));
+
+    // Wraps around the end of the buffer for reader1, and overruns the first
+    // 4 items of reader2
+    EXPECT_EQ(10, buffer.write(input.data(), 10));
+    EXPECT_EQ(input, readAll(&buffer, reader1));
+
+    std::vector<int> expected(input.begin() + 4, input.end());
+    expected.insert(expected.end(), input.begin(), input.end());
+    EXPECT_EQ(expected, readAll(&buffer, reader2));
+    EXPECT_EQ(0u, buffer.takeOverflowCount(reader1));
+    EXPECT_EQ(4u, buffer.takeOverflowCount(reader2));
+}
+
+TEST_F(MultiReaderRingBufferTest, OverflowIsAccountedToSlowReader) {
+    MultiReaderRingBuffer<int> buffer(16, 2);
+    const auto fastReader = buffer.addReader();
+    const auto slowReader = buffer.addReader();
+
+    std::vector<int> input(12);
+    std::iota(input.begin(), input.end(), 0);
+    EXPECT_EQ(12, buffer.write(input.data(), 12));
+    readAll(&buffer, fastReader);
+
+    // The slow reader didn't release anything, the oldest 8 items are
+    // overwritten and dropped for it only.
+    EXPECT_EQ(4, buffer.writeAvailable());
+    EXPECT_EQ(12, buffer.write(input.data(), 12));
+    EXPECT_EQ(0u, buffer.takeOverflowCount(fastReader));
+    EXPECT_EQ(8u, buffer.takeOverflowCount(slowReader));
+    EXPECT_EQ(0u, buffer.takeOverflowCount(slowReader));
+    EXPECT_EQ(input, readAll(&buffer, fastReader));
+
+    std::vector<int> expected(input.begin() + 8, input.end());
+    expected.insert(expected.end(), input.begin(), input.end());
+    EXPECT_EQ(expected, readAll(&buffer, slowReader));
+}
+
+TEST_F(MultiReaderRingBufferTest, StalledReaderDoesNotDropForOthers) {
+    MultiReaderRingBuffer<int> buffer(16, 3);
+    const auto reader1 = buffer.addReader();
+    const auto reader2 = buffer.addReader();
+    const auto stalledReader = buffer.addReader();
+
+    // The stalled reader never reads anything
+    std::vector<int> input(6);
+    std::vector<int> written;
+    std::vector<int> read1;
+    std::vector<int> read2;
+    for (int i = 0; i < 20; ++i) {
+        std::iota(input.begin(), input.end(), i * 6);
+        EXPECT_EQ(6, buffer.write(input.data(), 6));
+        written.insert(written.end(), input.begin(), input.end());
+        const auto items1 = readAll(&buffer, reader1);
+        read1.insert(read1.end(), items1.begin(), items1.end());
+        const auto items2 = readAll(&buffer, reader2);
+        read2.insert(read2.end(), items2.begin(), items2.end());
+    }
+
+    EXPECT_EQ(written, read1);
+    EXPECT_EQ(written, read2);
+    EXPECT_EQ(0u, buffer.takeOverflowCount(reader1));
+    EXPECT_EQ(0u, buffer.takeOverflowCount(reader2));
+    // Only the most recent items are left for the stalled reader
+    EXPECT_EQ(static_cast<std::uint64_t>(written.size() - buffer.size()),
+            buffer.takeOverflowCount(stalledReader));
+    EXPECT_EQ(buffer.size(), buffer.readAvailable(stalledReader));
+    EXPECT_EQ(std::vector<int>(written.end() - buffer.size(), written.end()),
+            readAll(&buffer, stalledReader));
+
+    // A removed reader is not overrun anymore
+    buffer.removeReader(stalledReader);
+    EXPECT_EQ(buffer.size(), buffer.writeAvailable());
+}
+
+TEST_F(MultiReaderRingBufferTest, AcquiredItemsAreNotOverwritten) {
+    MultiReaderRingBuffer<int> buffer(16, 2);
+    const auto reader = buffer.addReader();
+    const auto holdingReader = buffer.addReader();
+
+    std::vector<int> input(8);
+    std::iota(input.begin(), input.end(), 0);
+    EXPECT_EQ(8, buffer.write(input.data(), 8));
+
+    // Holds the first 4 items while the writer laps it
+    const int* pData1;
+    int size1;
+    const int* pData2;
+    int size2;
+    ASSERT_EQ(4, buffer.acquireReadRegions(holdingReader, 4, &pData1, &size1, &pData2, &size2));
+    ASSERT_EQ(4, size1);
+    EXPECT_EQ(std::vector<int>({0, 1, 2, 3}), std::vector<int>(pData1, pData1 + size1));
+
+    // Fills the buffer without reaching the acquired items
+    std::iota(input.begin(), input.end(), 8);
+    EXPECT_EQ(8, buffer.write(input.data(), 8));
+    EXPECT_EQ(16u, readAll(&buffer, reader).size());
+
+    // Would overwrite the acquired items, so the block is dropped for all
+    // readers
+    std::iota(input.begin(), input.end(), 16);
+    EXPECT_EQ(0, buffer.write(input.data(), 8));
+    EXPECT_EQ(std::vector<int>({0, 1, 2, 3}), std::vector<int>(pData1, pData1 + size1));
+    EXPECT_EQ(0, buffer.readAvailable(reader));
+    EXPECT_EQ(8u, buffer.takeOverflowCount(reader));
+    EXPECT_EQ(8u, buffer.takeOverflowCount(holdingReader));
+
+    // After releasing the items, the writer overruns the reader again
+    buffer.releaseReadRegions(holdingReader, 4);
+    EXPECT_EQ(8, buffer.write(input.data(), 8));
+    EXPECT_EQ(input, readAll(&buffer, reader));
+    EXPECT_EQ(4u, buffer.takeOverflowCount(holdingReader));
+    std::vector<int> expected(8);
+    std::iota(expected.begin(), expected.end(), 8);
+    expected.insert(expected.end(), input.begin(), input.end());
+    EXPECT_EQ(expected, readAll(&buffer, holdingReader));
+}
+
+TEST_F(MultiReaderRingBufferTest, NewReaderStartsAtWritePosition) {
+    MultiReaderRingBuffer<int> buffer(16, 1);
+    std::vector<int> input(8, 1);
+    EXPECT_EQ(8, buffer.write(input.data(), 8));
+
+    const auto reader = buffer.addReader();
+    EXPECT_EQ(0, buffer.readAvailable(reader));
+    EXPECT_EQ(-1, buffer.addReader());
+}
+
+} // namespace
@@ -0,0 +1,124 @@
+#include "engine/offlinerenderer.h"
+
+#include <QBuffer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtEndian>
+
+#include "recording/defs_recording.h"
+#include "test/signalpathtest.h"
+
+namespace {
+
+constexpr auto kSampleRate = mixxx::audio::SampleRate(44100);
+
+std::optional<QList<OfflineRenderEvent>> parse(
+        const QByteArray& script, QString* pErrorMessage = nullptr) {
+    QBuffer buffer;
+    buffer.setData(script);
+    buffer.open(QIODevice::ReadOnly);
+    return OfflineRenderer::parseAutomationScript(&buffer, kSampleRate, pErrorMessage);
+}
+
+struct WaveHeader {
+    quint32 riffSize = 0;
+    quint16 channels = 0;
+    quint32 sampleRate = 0;
+    quint16 bitsPerSample = 0;
+    quint32 dataSize = 0;
+};
+
+/// Reads the sizes and the format of a canonical RIFF WAVE file, which
+/// libsndfile only finalizes when the encoder is closed.
+std::optional<WaveHeader> readWaveHeader(const QString& fileName) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return std::nullopt;
+    }
+    const QByteArray data = file.readAll();
+    if (data.size() < 12 || !data.startsWith("RIFF") || data.mid(8, 4) != "WAVE") {
+        return std::nullopt;
+    }
+    const auto* pData = reinterpret_cast<const uchar*>(data.constData());
+    WaveHeader header;
+    header.riffSize = qFromLittleEndian<quint32>(pData + 4);
+    int pos = 12;
+    while (pos + 8 <= data.size()) {
+        const QByteArray chunkId = data.mid(pos, 4);
+        const quint32 chunkSize = qFromLittleEndian<quint32>(pData + pos + 4);
+        if (chunkId == "fmt " && pos + 24 <= data.size()) {
+            header.channels = qFromLittleEndian<quint16>(pData + pos + 10);
+            header.sampleRate = qFromLittleEndian<quint32>(pData + pos + 12);
+            header.bitsPerSample = qFromLittleEndian<quint16>(pData + pos + 22);
+        } else if (chunkId == "data") {
+            header.dataSize = chunkSize;
+            return header;
+        }
+        // Chunks are padded to an even size
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+class OfflineRendererTest : public SignalPathTest {
+};
+
+TEST_F(OfflineRendererTest, parseAutomationScriptSortsEvents) {
+    const auto events = parse(
+            "# Start deck 2 after deck 1, fields may be separated by tabs\n"
+            "\n"
+            "1.5 [Channel2] play 1\n"
+            "0 [Channel1] play 1\n"
+            "1.5\t[Channel1]  volume 0.5\n");
+    ASSERT_TRUE(events);
+    ASSERT_EQ(3, events->size());
+    EXPECT_EQ(0, events->at(0).framePos);
+    EXPECT_EQ(ConfigKey(m_sGroup1, "play"), events->at(0).key);
+    EXPECT_EQ(66150, events->at(1).framePos);
+    EXPECT_EQ(ConfigKey(m_sGroup2, "play"), events->at(1).key);
+    // Events at the same time keep the order of the script
+    EXPECT_EQ(66150, events->at(2).framePos);
+    EXPECT_EQ(ConfigKey(m_sGroup1, "volume"), events->at(2).key);
+    EXPECT_DOUBLE_EQ(0.5, events->at(2).value);
+}
+
+TEST_F(OfflineRendererTest, parseAutomationScriptRejectsInvalidLines) {
+    QString errorMessage;
+    EXPECT_FALSE(parse("0 [Channel1] play\n", &errorMessage));
+    EXPECT_TRUE(errorMessage.contains(QStringLiteral("line 1")));
+    EXPECT_FALSE(parse("0 [Channel1] play 1\n-1 [Channel1] play 0\n", &errorMessage));
+    EXPECT_TRUE(errorMessage.contains(QStringLiteral("line 2")));
+}
+
+TEST_F(OfflineRendererTest, renderReplaysAutomation) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString fileName = tempDir.filePath(QStringLiteral("render.wav"));
+
+    OfflineRenderer renderer(config(), m_pEngineMixer, kSampleRate, 512);
+    renderer.setAutomation(*parse(
+            "0 [Channel1] play 1\n"
+            "0.5 [Channel1] play 0\n"));
+    constexpr SINT kFrames = 44100;
+    const auto result = renderer.render(fileName,
+            EncoderFactory::getFactory().getFormatFor(ENCODING_WAVE),
+            kFrames);
+
+    ASSERT_TRUE(result.success) << result.errorMessage.toStdString();
+    EXPECT_EQ(kFrames, result.frames);
+    EXPECT_GT(result.realtimeFactor(kSampleRate), 0);
+    // The deck played for half a second and was stopped afterwards
+    EXPECT_EQ(0.0, ControlObject::get(ConfigKey(m_sGroup1, "play")));
+    EXPECT_GT(ControlObject::get(ConfigKey(m_sGroup1, "playposition")), 0.0);
+
+    // The header has been finalized with the rendered length
+    const auto header = readWaveHeader(fileName);
+    ASSERT_TRUE(header);
+    EXPECT_EQ(2, header->channels);
+    EXPECT_EQ(kSampleRate.value(), header->sampleRate);
+    EXPECT_EQ(16, header->bitsPerSample);
+    EXPECT_EQ(static_cast<quint32>(kFrames * 2 * 2), header->dataSize);
+    EXPECT_EQ(static_cast<quint32>(QFile(fileName).size() - 8), header->riffSize);
+}
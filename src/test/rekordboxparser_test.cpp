@@ -0,0 +1,533 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+#include <rekordbox_pdb.h>
+
+#include <QByteArray>
+#include <QList>
+#include <QtEndian>
+#include <cstring>
+#include <sstream>
+
+#include "library/rekordbox/rekordboxanlz.h"
+#include "library/rekordbox/rekordboxpdb.h"
+
+// The benchmarks compare the import of the tracks of a large synthetic
+// export.pdb with the Kaitai Struct parser, like RekordboxFeature did before,
+// and with the PdbReader that decodes the rows in place:
+// mixxx-test --benchmark --benchmark_filter=BM_RekordboxPdb
+
+using namespace mixxx::rekordbox;
+
+namespace {
+
+constexpr quint32 kPageSize = 4096;
+constexpr quint32 kPageHeapOffset = 40;
+constexpr quint32 kRowGroupSize = 0x24;
+constexpr int kRowsPerGroup = 16;
+
+void putU8(QByteArray* pData, int offset, quint8 value) {
+    (*pData)[offset] = static_cast<char>(value);
+}
+
+void putU16(QByteArray* pData, int offset, quint16 value) {
+    qToLittleEndian(value, pData->data() + offset);
+}
+
+void putU32(QByteArray* pData, int offset, quint32 value) {
+    qToLittleEndian(value, pData->data() + offset);
+}
+
+QByteArray shortAscii(const QByteArray& text) {
+    return static_cast<char>(((text.size() + 1) << 1) | 1) + text;
+}
+
+QByteArray longUtf16le(const QString& text) {
+    QByteArray string(4, '\0');
+    putU8(&string, 0, 0x90);
+    putU16(&string, 1, static_cast<quint16>(4 + 2 * text.size()));
+    for (const QChar c : text) {
+        const quint16 unicode = qToLittleEndian(c.unicode());
+        string.append(reinterpret_cast<const char*>(&unicode), 2);
+    }
+    return string;
+}
+
+QByteArray namedRow(quint32 id, const QByteArray& name) {
+    // id u4, id2 u4, name
+    QByteArray row(8, '\0');
+    putU32(&row, 0, id);
+    putU32(&row, 4, id);
+    return row + shortAscii(name);
+}
+
+QByteArray artistRow(quint32 id, const QByteArray& name) {
+    // subtype u2, index_shift u2, id u4, unknown u1, ofs_name_near u1
+    QByteArray row(10, '\0');
+    putU16(&row, 0, 0x60);
+    putU32(&row, 4, id);
+    putU8(&row, 8, 0x03);
+    putU8(&row, 9, 10);
+    return row + shortAscii(name);
+}
+
+QByteArray trackRow(quint32 id, quint32 artistId, const QByteArray& title) {
+    constexpr int kStringOffsets = 94;
+    constexpr int kStringCount = 21;
+    QByteArray row(kStringOffsets + 2 * kStringCount, '\0');
+    putU32(&row, 32, 1);         // key_id
+    putU32(&row, 48, 320);       // bitrate
+    putU32(&row, 52, id % 12);   // track_number
+    putU32(&row, 56, 12800);     // tempo
+    putU32(&row, 68, artistId);  // artist_id
+    putU32(&row, 72, id);        // id
+    putU16(&row, 80, 2021);      // year
+    putU16(&row, 84, 321);       // duration
+    putU8(&row, 88, 3);          // color_id
+    putU8(&row, 89, 4);          // rating
+    // All strings that aren't imported point to the same empty string
+    const int emptyString = row.size();
+    row += shortAscii(QByteArray());
+    for (int i = 0; i < kStringCount; ++i) {
+        putU16(&row, kStringOffsets + 2 * i, static_cast<quint16>(emptyString));
+    }
+    const auto appendString = [&row](int index, const QByteArray& string) {
+        putU16(&row, kStringOffsets + 2 * index, static_cast<quint16>(row.size()));
+        row += string;
+    };
+    appendString(14, shortAscii("/PIONEER/USBANLZ/P000/ANLZ0000.DAT"));
+    appendString(16, shortAscii("Comment"));
+    appendString(17, shortAscii(title));
+    appendString(20, shortAscii("/Contents/" + title + ".mp3"));
+    return row;
+}
+
+/// Writes the tables into the pages of an export.pdb file, in the layout
+/// that is documented in rekordbox_pdb.ksy.
+class PdbBuilder {
+  public:
+    void addTable(PdbPageType type, const QList<QByteArray>& rows) {
+        m_tables.append(Table{type, rows});
+    }
+
+    QByteArray build() const {
+        QByteArray data(kPageSize, '\0');
+        putU32(&data, 4, kPageSize);
+        putU32(&data, 8, static_cast<quint32>(m_tables.size()));
+        quint32 pageIndex = 1;
+        for (int tableIndex = 0; tableIndex < m_tables.size(); ++tableIndex) {
+            const Table& table = m_tables[tableIndex];
+            const quint32 firstPage = pageIndex;
+            int row = 0;
+            do {
+                QByteArray page(kPageSize, '\0');
+                putU32(&page, 4, pageIndex);
+                putU32(&page, 8, static_cast<quint32>(table.type));
+                putU32(&page, 12, pageIndex + 1);
+                quint32 heapSize = 0;
+                int rowCount = 0;
+                while (row < table.rows.size()) {
+                    const QByteArray& rowData = table.rows[row];
+                    const int groupCount = rowCount / kRowsPerGroup + 1;
+                    if (kPageHeapOffset + heapSize + rowData.size() +
+                                    groupCount * kRowGroupSize >
+                            kPageSize) {
+                        break;
+                    }
+                    std::memcpy(page.data() + kPageHeapOffset + heapSize,
+                            rowData.constData(),
+                            rowData.size());
+                    const int base = kPageSize - (rowCount / kRowsPerGroup) * kRowGroupSize;
+                    const int rowInGroup = rowCount % kRowsPerGroup;
+                    putU16(&page, base - (6 + 2 * rowInGroup), static_cast<quint16>(heapSize));
+                    const quint16 presentFlags = qFromLittleEndian<quint16>(
+                            page.constData() + base - 4);
+                    putU16(&page, base - 4, presentFlags | (1 << rowInGroup));
+                    heapSize += rowData.size();
+                    ++rowCount;
+                    ++row;
+                }
+                putU8(&page, 24, static_cast<quint8>(rowCount));
+                putU16(&page, 34, static_cast<quint16>(rowCount));
+                data += page;
+                ++pageIndex;
+            } while (row < table.rows.size());
+            const int entry = 28 + 16 * tableIndex;
+            putU32(&data, entry, static_cast<quint32>(table.type));
+            putU32(&data, entry + 4, pageIndex);
+            putU32(&data, entry + 8, firstPage);
+            putU32(&data, entry + 12, pageIndex - 1);
+        }
+        putU32(&data, 12, pageIndex);
+        return data;
+    }
+
+  private:
+    struct Table {
+        PdbPageType type;
+        QList<QByteArray> rows;
+    };
+    QList<Table> m_tables;
+};
+
+const uchar* bytes(const QByteArray& data) {
+    return reinterpret_cast<const uchar*>(data.constData());
+}
+
+QList<QByteArray> makeTrackRows(int trackCount) {
+    QList<QByteArray> rows;
+    for (int i = 1; i <= trackCount; ++i) {
+        rows.append(trackRow(i, i % 100, "Title " + QByteArray::number(i)));
+    }
+    return rows;
+}
+
+TEST(RekordboxPdbReaderTest, DecodeRows) {
+    PdbBuilder builder;
+    builder.addTable(PdbPageType::Keys, {namedRow(1, "Am"), namedRow(2, "C")});
+    builder.addTable(PdbPageType::Artists, {artistRow(7, "Artist")});
+    builder.addTable(PdbPageType::Tracks, {trackRow(3, 7, "Title")});
+    const QByteArray data = builder.build();
+
+    const PdbReader reader(bytes(data), data.size());
+    ASSERT_TRUE(reader.isValid());
+
+    QList<PdbNamedRow> keys;
+    for (auto it = reader.rows(PdbPageType::Keys); it.next();) {
+        keys.append(decodePdbNamedRow(PdbPageType::Keys, it.row()));
+    }
+    ASSERT_EQ(2, keys.size());
+    EXPECT_EQ(1u, keys[0].id);
+    EXPECT_EQ(QStringLiteral("Am"), keys[0].name);
+    EXPECT_EQ(2u, keys[1].id);
+    EXPECT_EQ(QStringLiteral("C"), keys[1].name);
+
+    auto artists = reader.rows(PdbPageType::Artists);
+    ASSERT_TRUE(artists.next());
+    const auto artist = decodePdbNamedRow(PdbPageType::Artists, artists.row());
+    EXPECT_EQ(7u, artist.id);
+    EXPECT_EQ(QStringLiteral("Artist"), artist.name);
+    EXPECT_FALSE(artists.next());
+
+    auto tracks = reader.rows(PdbPageType::Tracks);
+    ASSERT_TRUE(tracks.next());
+    const auto track = decodePdbTrackRow(tracks.row());
+    EXPECT_EQ(3u, track.id);
+    EXPECT_EQ(7u, track.artistId);
+    EXPECT_EQ(1u, track.keyId);
+    EXPECT_EQ(12800u, track.tempo);
+    EXPECT_EQ(2021, track.year);
+    EXPECT_EQ(321, track.duration);
+    EXPECT_EQ(3, track.colorId);
+    EXPECT_EQ(4, track.rating);
+    EXPECT_EQ(QStringLiteral("Title"), track.title);
+    EXPECT_EQ(QStringLiteral("Comment"), track.comment);
+    EXPECT_EQ(QStringLiteral("/Contents/Title.mp3"), track.filePath);
+    EXPECT_EQ(QStringLiteral("/PIONEER/USBANLZ/P000/ANLZ0000.DAT"), track.analyzePath);
+    EXPECT_FALSE(tracks.next());
+
+    EXPECT_FALSE(reader.rows(PdbPageType::Albums).next());
+}
+
+TEST(RekordboxPdbReaderTest, DecodeStrings) {
+    QByteArray genre(4, '\0');
+    putU32(&genre, 0, 1);
+    genre += longUtf16le(QStringLiteral("Dub Techno é中"));
+    QByteArray label(4, '\0');
+    putU32(&label, 0, 2);
+    // Null characters are removed
+    label += shortAscii(QByteArray("La\0bel", 6));
+    PdbBuilder builder;
+    builder.addTable(PdbPageType::Genres, {genre, label});
+    const QByteArray data = builder.build();
+
+    const PdbReader reader(bytes(data), data.size());
+    auto it = reader.rows(PdbPageType::Genres);
+    ASSERT_TRUE(it.next());
+    EXPECT_EQ(QStringLiteral("Dub Techno é中"),
+            decodePdbNamedRow(PdbPageType::Genres, it.row()).name);
+    ASSERT_TRUE(it.next());
+    EXPECT_EQ(QStringLiteral("Label"),
+            decodePdbNamedRow(PdbPageType::Genres, it.row()).name);
+}
+
+TEST(RekordboxPdbReaderTest, FollowPages) {
+    constexpr int kTrackCount = 500;
+    PdbBuilder builder;
+    builder.addTable(PdbPageType::Tracks, makeTrackRows(kTrackCount));
+    QByteArray data = builder.build();
+    ASSERT_GT(data.size(), 3 * static_cast<int>(kPageSize));
+
+    // Remove the first row of the second page
+    const int presentFlags = 3 * kPageSize - 4;
+    putU16(&data,
+            presentFlags,
+            qFromLittleEndian<quint16>(data.constData() + presentFlags) & ~1);
+
+    const PdbReader reader(bytes(data), data.size());
+    quint32 expectedId = 1;
+    int trackCount = 0;
+    for (auto it = reader.rows(PdbPageType::Tracks); it.next();) {
+        const auto track = decodePdbTrackRow(it.row());
+        if (trackCount > 0 && track.id != expectedId) {
+            // Only one row is missing
+            EXPECT_EQ(expectedId + 1, track.id);
+        }
+        expectedId = track.id + 1;
+        ++trackCount;
+    }
+    EXPECT_EQ(kTrackCount - 1, trackCount);
+}
+
+TEST(RekordboxPdbReaderTest, CorruptData) {
+    PdbBuilder builder;
+    builder.addTable(PdbPageType::Tracks, makeTrackRows(100));
+    const QByteArray data = builder.build();
+
+    // A cycle in the page links ends when all pages have been visited once
+    QByteArray cyclic = data;
+    putU32(&cyclic, 28 + 12, 0xffff);
+    putU32(&cyclic, 2 * kPageSize + 12, 1);
+    int rowCount = 0;
+    {
+        const PdbReader reader(bytes(cyclic), cyclic.size());
+        for (auto it = reader.rows(PdbPageType::Tracks); it.next();) {
+            ++rowCount;
+        }
+        EXPECT_LE(rowCount, 100 * cyclic.size() / static_cast<int>(kPageSize));
+    }
+
+    // Pages that are not data pages are skipped
+    QByteArray strange = data;
+    putU8(&strange, kPageSize + 27, 0x44);
+    {
+        const PdbReader reader(bytes(strange), strange.size());
+        auto it = reader.rows(PdbPageType::Tracks);
+        ASSERT_TRUE(it.next());
+        EXPECT_LT(1u, decodePdbTrackRow(it.row()).id);
+    }
+
+    // A truncated file yields the complete pages only
+    for (int size = 0; size < data.size(); size += 509) {
+        const PdbReader reader(bytes(data), size);
+        rowCount = 0;
+        for (auto it = reader.rows(PdbPageType::Tracks); it.next();) {
+            decodePdbTrackRow(it.row());
+            ++rowCount;
+        }
+        EXPECT_LT(rowCount, 100);
+    }
+
+    // Fields of a row at the end of the page are not read beyond the page
+    QByteArray outside = data;
+    putU16(&outside, 2 * kPageSize - 6, kPageSize - kPageHeapOffset - 10);
+    {
+        const PdbReader reader(bytes(outside), outside.size());
+        auto it = reader.rows(PdbPageType::Tracks);
+        ASSERT_TRUE(it.next());
+        EXPECT_EQ(0u, decodePdbTrackRow(it.row()).id);
+    }
+
+    EXPECT_FALSE(PdbReader(nullptr, 0).isValid());
+    QByteArray noPageSize = data;
+    putU32(&noPageSize, 4, 0);
+    EXPECT_FALSE(PdbReader(bytes(noPageSize), noPageSize.size()).isValid());
+}
+
+void putU32BE(QByteArray* pData, int offset, quint32 value) {
+    qToBigEndian(value, pData->data() + offset);
+}
+
+QByteArray anlzSection(const char* tag, const QByteArray& body) {
+    QByteArray section(12, '\0');
+    std::memcpy(section.data(), tag, 4);
+    putU32BE(&section, 4, 12);
+    putU32BE(&section, 8, static_cast<quint32>(12 + body.size()));
+    return section + body;
+}
+
+QByteArray anlzFile(const QList<QByteArray>& sections) {
+    QByteArray data(28, '\0');
+    std::memcpy(data.data(), "PMAI", 4);
+    putU32BE(&data, 4, 28);
+    for (const auto& section : sections) {
+        data += section;
+    }
+    putU32BE(&data, 8, static_cast<quint32>(data.size()));
+    return data;
+}
+
+TEST(RekordboxAnlzTest, DecodeSections) {
+    QByteArray beatGrid(12 + 3 * 8, '\0');
+    putU32BE(&beatGrid, 8, 3);
+    for (int i = 0; i < 3; ++i) {
+        putU32BE(&beatGrid, 12 + 8 * i + 4, 500 * i + 20);
+    }
+
+    QByteArray cues(12 + 2 * 56, '\0');
+    putU32BE(&cues, 0, static_cast<quint32>(AnlzCueListType::MemoryCues));
+    qToBigEndian<quint16>(2, cues.data() + 6);
+    for (int i = 0; i < 2; ++i) {
+        const int entry = 12 + 56 * i;
+        std::memcpy(cues.data() + entry, "PCPT", 4);
+        putU8(&cues, entry + 28, static_cast<quint8>(i + 1));
+        putU32BE(&cues, entry + 32, 1000 * (i + 1));
+        putU32BE(&cues, entry + 36, 1000 * (i + 1) + 500);
+    }
+
+    const QString comment = QStringLiteral("Drop");
+    QByteArray commentBytes(reinterpret_cast<const char*>(comment.utf16()),
+            2 * comment.size());
+    commentBytes += QByteArray(2, '\0');
+    QByteArray extendedEntry(44, '\0');
+    std::memcpy(extendedEntry.data(), "PCP2", 4);
+    putU32BE(&extendedEntry, 12, 2);
+    putU8(&extendedEntry, 16, 1);
+    putU32BE(&extendedEntry, 20, 3000);
+    putU8(&extendedEntry, 28, 5);
+    putU32BE(&extendedEntry, 40, static_cast<quint32>(commentBytes.size()));
+    extendedEntry += commentBytes;
+    extendedEntry += QByteArray("\x01\x10\x20\x30", 4);
+    extendedEntry += QByteArray(8, '\0');
+    putU32BE(&extendedEntry, 8, static_cast<quint32>(extendedEntry.size()));
+    QByteArray extendedCues(8, '\0');
+    putU32BE(&extendedCues, 0, static_cast<quint32>(AnlzCueListType::HotCues));
+    qToBigEndian<quint16>(2, extendedCues.data() + 4);
+    extendedCues += extendedEntry;
+    extendedCues += extendedEntry;
+
+    const QByteArray data = anlzFile({
+            anlzSection("PPTH", QByteArray(16, '\0')),
+            anlzSection("PQTZ", beatGrid),
+            anlzSection("PCOB", cues),
+            anlzSection("PCO2", extendedCues),
+    });
+
+    AnlzSectionIterator section(bytes(data), data.size());
+    ASSERT_TRUE(section.isValid());
+    ASSERT_TRUE(section.next());
+    EXPECT_EQ(0x50505448u, section.tag());
+
+    ASSERT_TRUE(section.next());
+    ASSERT_EQ(static_cast<quint32>(AnlzSectionTag::BeatGrid), section.tag());
+    ASSERT_EQ(3, section.beatCount());
+    EXPECT_EQ(20u, section.beatTime(0));
+    EXPECT_EQ(1020u, section.beatTime(2));
+
+    ASSERT_TRUE(section.next());
+    ASSERT_EQ(static_cast<quint32>(AnlzSectionTag::Cues), section.tag());
+    EXPECT_EQ(AnlzCueListType::MemoryCues, section.cueListType());
+    auto entries = section.cueEntries();
+    ASSERT_EQ(2, entries.size());
+    EXPECT_EQ(AnlzCueEntryType::MemoryCue, entries[0].type);
+    EXPECT_EQ(1000u, entries[0].time);
+    EXPECT_EQ(AnlzCueEntryType::Loop, entries[1].type);
+    EXPECT_EQ(2000u, entries[1].time);
+    EXPECT_EQ(2500u, entries[1].loopTime);
+
+    ASSERT_TRUE(section.next());
+    ASSERT_EQ(static_cast<quint32>(AnlzSectionTag::Cues2), section.tag());
+    EXPECT_EQ(AnlzCueListType::HotCues, section.cueListType());
+    entries = section.cueEntries();
+    ASSERT_EQ(2, entries.size());
+    for (const auto& entry : entries) {
+        EXPECT_EQ(2u, entry.hotCue);
+        EXPECT_EQ(3000u, entry.time);
+        EXPECT_EQ(5, entry.colorId);
+        EXPECT_EQ(commentBytes, entry.comment);
+        EXPECT_EQ(0x10, entry.colorRed);
+        EXPECT_EQ(0x20, entry.colorGreen);
+        EXPECT_EQ(0x30, entry.colorBlue);
+    }
+
+    EXPECT_FALSE(section.next());
+
+    // A truncated file yields the complete sections only
+    for (int size = 0; size < data.size(); ++size) {
+        AnlzSectionIterator truncated(bytes(data), size);
+        while (truncated.next()) {
+            if (truncated.tag() == static_cast<quint32>(AnlzSectionTag::BeatGrid)) {
+                EXPECT_EQ(3, truncated.beatCount());
+            } else {
+                truncated.cueEntries();
+            }
+        }
+    }
+}
+
+QString kaitaiText(rekordbox_pdb_t::device_sql_string_t* pString) {
+    auto* pBody = pString->body();
+    if (auto* pShortAscii = dynamic_cast<rekordbox_pdb_t::device_sql_short_ascii_t*>(pBody)) {
+        return QString::fromStdString(pShortAscii->text());
+    }
+    if (auto* pLongAscii = dynamic_cast<rekordbox_pdb_t::device_sql_long_ascii_t*>(pBody)) {
+        return QString::fromStdString(pLongAscii->text());
+    }
+    return QString();
+}
+
+void BM_RekordboxPdbKaitai(benchmark::State& state) {
+    PdbBuilder builder;
+    builder.addTable(PdbPageType::Tracks, makeTrackRows(static_cast<int>(state.range(0))));
+    const QByteArray data = builder.build();
+    std::istringstream stream(data.toStdString());
+    for (auto _ : state) {
+        stream.clear();
+        stream.seekg(0);
+        kaitai::kstream ks(&stream);
+        rekordbox_pdb_t pdb(&ks);
+        int trackCount = 0;
+        for (const auto& table : *pdb.tables()) {
+            if (table->type() != rekordbox_pdb_t::PAGE_TYPE_TRACKS) {
+                continue;
+            }
+            const auto lastIndex = table->last_page()->index();
+            rekordbox_pdb_t::page_ref_t* pPageRef = table->first_page();
+            while (true) {
+                rekordbox_pdb_t::page_t* pPage = pPageRef->body();
+                if (pPage->is_data_page()) {
+                    for (const auto& rowGroup : *pPage->row_groups()) {
+                        for (const auto& rowRef : *rowGroup->rows()) {
+                            if (!rowRef->present()) {
+                                continue;
+                            }
+                            auto* pTrack = static_cast<rekordbox_pdb_t::track_row_t*>(
+                                    rowRef->body());
+                            benchmark::DoNotOptimize(kaitaiText(pTrack->title()));
+                            benchmark::DoNotOptimize(kaitaiText(pTrack->file_path()));
+                            benchmark::DoNotOptimize(kaitaiText(pTrack->comment()));
+                            benchmark::DoNotOptimize(kaitaiText(pTrack->analyze_path()));
+                            ++trackCount;
+                        }
+                    }
+                }
+                if (pPageRef->index() == lastIndex) {
+                    break;
+                }
+                pPageRef = pPage->next_page();
+            }
+        }
+        benchmark::DoNotOptimize(trackCount);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_RekordboxPdbReader(benchmark::State& state) {
+    PdbBuilder builder;
+    builder.addTable(PdbPageType::Tracks, makeTrackRows(static_cast<int>(state.range(0))));
+    const QByteArray data = builder.build();
+    for (auto _ : state) {
+        const PdbReader reader(bytes(data), data.size());
+        int trackCount = 0;
+        for (auto it = reader.rows(PdbPageType::Tracks); it.next();) {
+            benchmark::DoNotOptimize(decodePdbTrackRow(it.row()));
+            ++trackCount;
+        }
+        benchmark::DoNotOptimize(trackCount);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK(BM_RekordboxPdbKaitai)->Arg(50000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RekordboxPdbReader)->Arg(50000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,43 @@
+#ifdef __BROADCAST__
+
+#include "engine/sidechain/sharedbroadcastencoder.h"
+
+#include <gtest/gtest.h>
+
+#include "encoder/encodersettings.h"
+#include "engine/sidechain/enginesidechain.h"
+#include "recording/defs_recording.h"
+#include "test/mixxxtest.h"
+
+namespace {
+
+class FlacTestSettings : public EncoderSettings {
+  public:
+    QString getFormat() const override {
+        return ENCODING_FLAC;
+    }
+};
+
+class SharedBroadcastEncoderTest : public MixxxTest {};
+
+TEST_F(SharedBroadcastEncoderTest, InitEncoderFails) {
+    const auto pSettings = std::make_shared<FlacTestSettings>();
+    // Exceeds the maximum sample rate of FLAC
+    const auto sampleRate = mixxx::audio::SampleRate(2000000);
+
+    CSAMPLE sidechainMix[2] = {};
+    EngineSideChain sideChain(config(), sidechainMix);
+
+    // Must neither deadlock nor register the encoder
+    QString errorMessage;
+    EXPECT_EQ(nullptr,
+            SharedBroadcastEncoder::acquire(
+                    pSettings, sampleRate, &sideChain, &errorMessage));
+    EXPECT_EQ(nullptr,
+            SharedBroadcastEncoder::acquire(
+                    pSettings, sampleRate, &sideChain, &errorMessage));
+}
+
+} // namespace
+
+#endif // __BROADCAST__
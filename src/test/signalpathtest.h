@@ -164,7 +164,7 @@ class BaseSignalPathTest : public MixxxTest, SoundSourceProviderRegistration {
         m_pNumDecks->set(m_pNumDecks->get() + 1);
     }
 
-    void loadTrack(Deck* pDeck, TrackPointer pTrack) {
+    void loadTrack(BaseTrackPlayerImpl* pDeck, TrackPointer pTrack) {
         EngineDeck* pEngineDeck = pDeck->getEngineDeck();
         if (pEngineDeck->getEngineBuffer()->isTrackLoaded()) {
             pEngineDeck->getEngineBuffer()->ejectTrack();
@@ -1,11 +1,14 @@
+#include <benchmark/benchmark.h>
 #include <gtest/gtest.h>
 
 #include <QtDebug>
+#include <random>
 
 #include "sources/soundsourceproxy.cpp"
 #include "test/mixxxtest.h"
 #include "track/track.h"
 #include "util/samplebuffer.h"
+#include "util/sample.h"
 
 using namespace mixxx;
 
@@ -18,6 +21,56 @@ const QList<QString> kStemFiles = {
         "04-vocal.wav",
 };
 
+// The chunk size of the CachingReader, which reads the decks
+constexpr SINT kChunkFrames = 8192;
+constexpr int kStemCount = 4;
+
+QUrl stemTestFileUrl() {
+    return QUrl::fromLocalFile(
+            MixxxTest::getOrInitTestDir().filePath("stems/test.stem.mp4"));
+}
+
+// Each stem with its own input, as the stems were opened before they
+// started to share a single demuxer
+class SeparateDemuxerSTEM {
+  public:
+    SeparateDemuxerSTEM() {
+        mixxx::AudioSource::OpenParams config;
+        config.setChannelCount(mixxx::audio::ChannelCount::stereo());
+        for (int stemIdx = 0; stemIdx < kStemCount; ++stemIdx) {
+            // The first stream is the main mix
+            m_stems.push_back(std::make_unique<SoundSourceSingleSTEM>(
+                    stemTestFileUrl(), stemIdx + 1));
+            m_stems.back()->open(AudioSource::OpenMode::Strict, config);
+        }
+    }
+
+    IndexRange frameIndexRange() const {
+        return m_stems.front()->frameIndexRange();
+    }
+
+    void read(SINT startFrame, SampleBuffer* pOutput, SampleBuffer* pStemBuffer) {
+        const auto range = IndexRange::forward(startFrame, kChunkFrames);
+        for (int stemIdx = 0; stemIdx < kStemCount; ++stemIdx) {
+            m_stems[stemIdx]->readSampleFrames(WritableSampleFrames(range,
+                    SampleBuffer::WritableSlice(pStemBuffer->data(), kChunkFrames * 2)));
+            for (SINT i = 0; i < kChunkFrames; ++i) {
+                (*pOutput)[2 * kStemCount * i + 2 * stemIdx] = (*pStemBuffer)[2 * i];
+                (*pOutput)[2 * kStemCount * i + 2 * stemIdx + 1] = (*pStemBuffer)[2 * i + 1];
+            }
+        }
+    }
+
+  private:
+    std::vector<std::unique_ptr<SoundSourceSingleSTEM>> m_stems;
+};
+
+ReadableSampleFrames readChunk(SoundSourceSTEM* pSource, SINT startFrame, SampleBuffer* pOutput) {
+    return pSource->readSampleFrames(WritableSampleFrames(
+            IndexRange::forward(startFrame, kChunkFrames),
+            SampleBuffer::WritableSlice(pOutput->data(), pOutput->size())));
+}
+
 class StemTest : public MixxxTest {
   protected:
     void SetUp() override {
@@ -152,4 +205,106 @@ TEST_F(StemTest, OpenStem) {
             sourceStem.getSignalInfo());
 }
 
+TEST_F(StemTest, SharedDemuxerMatchesSeparateInputs) {
+    SoundSourceSTEM sourceStem(stemTestFileUrl());
+    mixxx::AudioSource::OpenParams config;
+    config.setChannelCount(mixxx::audio::ChannelCount::stem());
+    ASSERT_EQ(sourceStem.open(AudioSource::OpenMode::Strict, config),
+            AudioSource::OpenResult::Succeeded);
+    SeparateDemuxerSTEM separateStems;
+    ASSERT_EQ(sourceStem.frameIndexRange(), separateStems.frameIndexRange());
+
+    SampleBuffer sharedOutput(kChunkFrames * 2 * kStemCount);
+    SampleBuffer separateOutput(kChunkFrames * 2 * kStemCount);
+    SampleBuffer stemBuffer(kChunkFrames * 2);
+    // Continue reading, then seek backward and forward
+    const SINT lastChunkStart = sourceStem.frameIndexRange().end() - kChunkFrames;
+    for (SINT startFrame : {SINT{0}, kChunkFrames, lastChunkStart / 2, SINT{1000}, lastChunkStart}) {
+        ASSERT_EQ(kChunkFrames,
+                readChunk(&sourceStem, startFrame, &sharedOutput).frameLength());
+        separateStems.read(startFrame, &separateOutput, &stemBuffer);
+        for (SINT i = 0; i < sharedOutput.size(); ++i) {
+            ASSERT_EQ(separateOutput[i], sharedOutput[i])
+                    << "sample " << i << " of the chunk at frame " << startFrame;
+        }
+    }
+}
+
+TEST_F(StemTest, SelectDecodedStems) {
+    SoundSourceSTEM sourceStem(stemTestFileUrl());
+    SoundSourceSTEM referenceStem(stemTestFileUrl());
+    mixxx::AudioSource::OpenParams config;
+    config.setChannelCount(mixxx::audio::ChannelCount::stem());
+    ASSERT_EQ(sourceStem.open(AudioSource::OpenMode::Strict, config),
+            AudioSource::OpenResult::Succeeded);
+    ASSERT_EQ(referenceStem.open(AudioSource::OpenMode::Strict, config),
+            AudioSource::OpenResult::Succeeded);
+
+    SampleBuffer output(kChunkFrames * 2 * kStemCount);
+    SampleBuffer referenceOutput(kChunkFrames * 2 * kStemCount);
+    const auto firstAndThird = StemChannelSelection(StemChannel::First) | StemChannel::Third;
+    EXPECT_EQ(firstAndThird, sourceStem.selectDecodedStems(firstAndThird));
+    for (SINT startFrame : {SINT{0}, kChunkFrames}) {
+        ASSERT_EQ(kChunkFrames, readChunk(&sourceStem, startFrame, &output).frameLength());
+        ASSERT_EQ(kChunkFrames,
+                readChunk(&referenceStem, startFrame, &referenceOutput).frameLength());
+        for (SINT i = 0; i < output.size(); ++i) {
+            const int stemIdx = static_cast<int>(i % (2 * kStemCount)) / 2;
+            if (stemIdx == 0 || stemIdx == 2) {
+                ASSERT_EQ(referenceOutput[i], output[i]) << "sample " << i;
+            } else {
+                ASSERT_EQ(0, output[i]) << "sample " << i;
+            }
+        }
+    }
+
+    // Selecting all stems again makes all of them seek to the next position
+    EXPECT_EQ(StemChannelSelection(), sourceStem.selectDecodedStems(StemChannel::All));
+    ASSERT_EQ(kChunkFrames, readChunk(&sourceStem, 2 * kChunkFrames, &output).frameLength());
+    // Seek the reference to the same position
+    readChunk(&referenceStem, 4 * kChunkFrames, &referenceOutput);
+    ASSERT_EQ(kChunkFrames,
+            readChunk(&referenceStem, 2 * kChunkFrames, &referenceOutput).frameLength());
+    for (SINT i = 0; i < output.size(); ++i) {
+        ASSERT_EQ(referenceOutput[i], output[i]) << "sample " << i;
+    }
+}
+
+// Random seeks with a chunk read each, like a stem deck that is scratched
+// or jumps between hotcues
+static void BM_StemDeckSeekSharedDemuxer(benchmark::State& state) {
+    SoundSourceSTEM sourceStem(stemTestFileUrl());
+    mixxx::AudioSource::OpenParams config;
+    config.setChannelCount(mixxx::audio::ChannelCount::stem());
+    if (sourceStem.open(AudioSource::OpenMode::Strict, config) !=
+            AudioSource::OpenResult::Succeeded) {
+        state.SkipWithError("Failed to open the stem file");
+        return;
+    }
+    SampleBuffer output(kChunkFrames * 2 * kStemCount);
+    std::mt19937 generator;
+    std::uniform_int_distribution<SINT> startFrames(
+            0, sourceStem.frameIndexRange().end() - kChunkFrames);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(readChunk(&sourceStem, startFrames(generator), &output));
+    }
+    state.SetItemsProcessed(state.iterations() * kChunkFrames);
+}
+BENCHMARK(BM_StemDeckSeekSharedDemuxer)->Unit(benchmark::kMillisecond);
+
+static void BM_StemDeckSeekSeparateDemuxers(benchmark::State& state) {
+    SeparateDemuxerSTEM separateStems;
+    SampleBuffer output(kChunkFrames * 2 * kStemCount);
+    SampleBuffer stemBuffer(kChunkFrames * 2);
+    std::mt19937 generator;
+    std::uniform_int_distribution<SINT> startFrames(
+            0, separateStems.frameIndexRange().end() - kChunkFrames);
+    for (auto _ : state) {
+        separateStems.read(startFrames(generator), &output, &stemBuffer);
+        benchmark::DoNotOptimize(output.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kChunkFrames);
+}
+BENCHMARK(BM_StemDeckSeekSeparateDemuxers)->Unit(benchmark::kMillisecond);
+
 } // namespace
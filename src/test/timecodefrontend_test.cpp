@@ -0,0 +1,220 @@
+#include "vinylcontrol/timecodefrontend.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QString>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "util/math.h"
+#include "vinylcontrol/defs_vinylcontrol.h"
+
+#ifdef _MSC_VER
+#include "timecoder.h"
+#else
+extern "C" {
+#include "timecoder.h"
+}
+#endif
+
+namespace {
+
+constexpr unsigned int kSampleRate = 96000;
+constexpr int kChannels = 2;
+constexpr CSAMPLE_GAIN kGain = 1.3f;
+
+// How a timecode places its tones on the record. The same as the SWITCH_*
+// flags of the definitions in lib/xwax/timecoder.c.
+struct TimecodeFormat {
+    const char* name;
+    bool primaryLeft;
+    bool invertedPhase;
+};
+
+const TimecodeFormat kSerato = {MIXXX_VINYL_SERATOCV02VINYLSIDEA_XWAX_NAME, false, false};
+const TimecodeFormat kTraktor = {MIXXX_VINYL_TRAKTORSCRATCHSIDEA_XWAX_NAME, true, true};
+const TimecodeFormat kMixVibes = {MIXXX_VINYL_MIXVIBESDVS_XWAX_NAME, false, true};
+
+bits_t parity(bits_t bits) {
+    bits_t result = 0;
+    while (bits != 0) {
+        result ^= bits & 1;
+        bits >>= 1;
+    }
+    return result;
+}
+
+// Records a timecode vinyl, which is played from startSeconds at the nominal
+// speed plus a sine shaped scratch. Each cycle of the primary tone carries
+// the next bit of the LFSR sequence of the timecode in its amplitude, and
+// the secondary tone is 90 degrees out of phase.
+std::vector<CSAMPLE> recordTimecode(const TimecodeFormat& format,
+        const timecode_def* pDef,
+        double seconds,
+        double startSeconds,
+        double scratchDepth,
+        double scratchHz) {
+    const auto frames = static_cast<std::size_t>(seconds * kSampleRate);
+    const double startCycle = startSeconds * pDef->resolution;
+    const auto maxCycle = static_cast<std::size_t>(
+            startCycle + seconds * pDef->resolution * (1.0 + scratchDepth) + 1);
+
+    std::vector<unsigned char> cycleBits(maxCycle + 1);
+    bits_t state = pDef->seed;
+    for (auto& bit : cycleBits) {
+        bit = (state >> (pDef->bits - 1)) & 1;
+        state = (state >> 1) |
+                (parity(state & (pDef->taps | 1)) << (pDef->bits - 1));
+    }
+
+    std::vector<CSAMPLE> recording(frames * kChannels);
+    double cycle = startCycle;
+    for (std::size_t frame = 0; frame < frames; ++frame) {
+        const double time = static_cast<double>(frame) / kSampleRate;
+        const double pitch = 1.0 + scratchDepth * std::sin(2 * M_PI * scratchHz * time);
+        cycle += pDef->resolution * pitch / kSampleRate;
+        const auto cycleIndex = static_cast<std::size_t>(math_max(cycle, 0.0));
+        const double amplitude = cycleBits[cycleIndex] ? 0.5 : 0.3;
+        const double phase = 2 * M_PI * (cycle - std::floor(cycle));
+        const auto primary = static_cast<CSAMPLE>(amplitude * std::sin(phase));
+        const auto secondary = static_cast<CSAMPLE>(
+                (format.invertedPhase ? 0.4 : -0.4) * std::cos(phase));
+        recording[frame * kChannels] = format.primaryLeft ? primary : secondary;
+        recording[frame * kChannels + 1] = format.primaryLeft ? secondary : primary;
+    }
+    return recording;
+}
+
+// The conversion in front of timecoder_submit() that TimecodeFrontEnd
+// replaces, for reference
+void submitSamples(timecoder* pTimecoder,
+        std::vector<short>* pWorkBuffer,
+        const CSAMPLE* pSamples,
+        SINT numFrames,
+        CSAMPLE_GAIN gain) {
+    pWorkBuffer->resize(numFrames * kChannels);
+    for (SINT i = 0; i < numFrames * kChannels; ++i) {
+        CSAMPLE sample = pSamples[i] * gain * SAMPLE_MAXIMUM;
+        if (sample > SAMPLE_MAXIMUM) {
+            (*pWorkBuffer)[i] = SAMPLE_MAXIMUM;
+        } else if (sample < SAMPLE_MINIMUM) {
+            (*pWorkBuffer)[i] = SAMPLE_MINIMUM;
+        } else {
+            (*pWorkBuffer)[i] = static_cast<short>(sample);
+        }
+    }
+    timecoder_submit(pTimecoder, pWorkBuffer->data(), numFrames);
+}
+
+class TimecoderState {
+  public:
+    explicit TimecoderState(timecode_def* pDef) {
+        timecoder_init(&m_timecoder, pDef, 1.0, kSampleRate, false);
+        timecoder_monitor_init(&m_timecoder, MIXXX_VINYL_SCOPE_SIZE);
+    }
+    ~TimecoderState() {
+        timecoder_monitor_clear(&m_timecoder);
+        timecoder_clear(&m_timecoder);
+    }
+
+    timecoder* get() {
+        return &m_timecoder;
+    }
+
+  private:
+    timecoder m_timecoder;
+};
+
+class TimecodeFrontEndTest : public testing::TestWithParam<TimecodeFormat> {
+  protected:
+    static void TearDownTestSuite() {
+        timecoder_free_lookup();
+    }
+};
+
+TEST_P(TimecodeFrontEndTest, decodesExactlyLikeTimecoderSubmit) {
+    const TimecodeFormat& format = GetParam();
+    timecode_def* pDef = timecoder_find_definition(format.name);
+    ASSERT_NE(nullptr, pDef);
+
+    // Steady playback, scratching, and fast scratches through the stop
+    for (const double scratchDepth : {0.0, 0.8, 2.0}) {
+        const auto recording = recordTimecode(format, pDef, 3.0, 20.0, scratchDepth, 3.0);
+        TimecoderState reference(pDef);
+        TimecoderState vectorized(pDef);
+        std::vector<short> workBuffer;
+        TimecodeFrontEnd frontEnd;
+
+        int validPositions = 0;
+        // Not a multiple of the block size of the front end
+        constexpr SINT kFrames = 300;
+        const auto frames = static_cast<SINT>(recording.size() / kChannels);
+        for (SINT frame = 0; frame + kFrames <= frames; frame += kFrames) {
+            const CSAMPLE* pSamples = recording.data() + frame * kChannels;
+            submitSamples(reference.get(), &workBuffer, pSamples, kFrames, kGain);
+            frontEnd.submit(vectorized.get(), pSamples, kFrames, kGain);
+
+            double referenceWhen = 0;
+            double vectorizedWhen = 0;
+            const int position = timecoder_get_position(reference.get(), &referenceWhen);
+            ASSERT_EQ(position, timecoder_get_position(vectorized.get(), &vectorizedWhen));
+            ASSERT_EQ(referenceWhen, vectorizedWhen);
+            ASSERT_EQ(timecoder_get_pitch(reference.get()),
+                    timecoder_get_pitch(vectorized.get()));
+            ASSERT_EQ(0,
+                    std::memcmp(reference.get()->mon,
+                            vectorized.get()->mon,
+                            MIXXX_VINYL_SCOPE_SIZE * MIXXX_VINYL_SCOPE_SIZE));
+            if (position >= 0) {
+                ++validPositions;
+            }
+        }
+        // The recording is actually decoded
+        EXPECT_GT(validPositions, 0) << "scratch depth " << scratchDepth;
+        if (scratchDepth == 0.0) {
+            EXPECT_NEAR(1.0, timecoder_get_pitch(vectorized.get()), 0.01);
+            EXPECT_NEAR(23000, timecoder_get_position(vectorized.get(), nullptr), 5);
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(TimecodeFrontEndTest,
+        TimecodeFrontEndTest,
+        testing::Values(kSerato, kTraktor, kMixVibes),
+        [](const testing::TestParamInfo<TimecodeFormat>& info) {
+            return std::string(info.param.name);
+        });
+
+// Arguments: frames per buffer
+template<bool vectorized>
+static void BM_TimecodeDecode(benchmark::State& state) {
+    timecode_def* pDef = timecoder_find_definition(kSerato.name);
+    const auto recording = recordTimecode(kSerato, pDef, 10.0, 20.0, 0.8, 3.0);
+    const auto framesPerBuffer = static_cast<SINT>(state.range(0));
+    const auto frames = static_cast<SINT>(recording.size() / kChannels);
+
+    TimecoderState timecoderState(pDef);
+    std::vector<short> workBuffer;
+    TimecodeFrontEnd frontEnd;
+    SINT frame = 0;
+    for (auto _ : state) {
+        if (frame + framesPerBuffer > frames) {
+            frame = 0;
+        }
+        const CSAMPLE* pSamples = recording.data() + frame * kChannels;
+        if (vectorized) {
+            frontEnd.submit(timecoderState.get(), pSamples, framesPerBuffer, kGain);
+        } else {
+            submitSamples(timecoderState.get(), &workBuffer, pSamples, framesPerBuffer, kGain);
+        }
+        benchmark::DoNotOptimize(timecoder_get_pitch(timecoderState.get()));
+        frame += framesPerBuffer;
+    }
+    state.SetItemsProcessed(state.iterations() * framesPerBuffer);
+}
+BENCHMARK_TEMPLATE(BM_TimecodeDecode, false)->Range(64, 4096);
+BENCHMARK_TEMPLATE(BM_TimecodeDecode, true)->Range(64, 4096);
+
+} // namespace
@@ -0,0 +1,219 @@
+#include "vinylcontrol/vinylcontrolprocessor.h"
+
+#include <benchmark/benchmark.h>
+
+#include <QThread>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "test/signalpathtest.h"
+#include "util/math.h"
+#include "util/performancetimer.h"
+#include "vinylcontrol/defs_vinylcontrol.h"
+
+// Replays a timecode signal into VinylControlProcessor like the sound device
+// does and measures how long it takes until the pitch of all decks has been
+// decoded and handed to the engine.
+// Run with: mixxx-test --benchmark --benchmark_filter=BM_VinylControlReplay
+
+namespace {
+
+constexpr auto kSampleRate = mixxx::audio::SampleRate(96000);
+constexpr int kChannels = 2;
+// Serato CV02 side A, the default timecode
+constexpr double kCarrierHz = 1000.0;
+constexpr double kRecordingSeconds = 10.0;
+constexpr int kReplayIterations = 4000;
+
+// The repository doesn't contain recordings of timecode vinyl, so the pitch
+// carrier of the timecode is recorded synthetically: a quadrature sine pair as
+// picked up from the left and right groove, while the record is scratched
+// back and forth around the nominal speed.
+std::vector<CSAMPLE> recordTimecode(double scratchHz) {
+    const auto frames = static_cast<std::size_t>(kRecordingSeconds * kSampleRate.toDouble());
+    std::vector<CSAMPLE> recording(frames * kChannels);
+    double phase = 0;
+    for (std::size_t frame = 0; frame < frames; ++frame) {
+        const double seconds = frame / kSampleRate.toDouble();
+        const double pitch = 1.0 + 0.75 * std::sin(2 * M_PI * scratchHz * seconds);
+        phase += 2 * M_PI * kCarrierHz * pitch / kSampleRate.toDouble();
+        recording[frame * kChannels] = static_cast<CSAMPLE>(0.5 * std::sin(phase));
+        recording[frame * kChannels + 1] = static_cast<CSAMPLE>(0.5 * std::cos(phase));
+    }
+    return recording;
+}
+
+AudioInput vinylControlInput(int index) {
+    return AudioInput(AudioPathType::VinylControl,
+            0,
+            mixxx::audio::ChannelCount::stereo(),
+            static_cast<unsigned char>(index));
+}
+
+class VinylControlProcessorTest : public BaseSignalPathTest {
+  protected:
+    void SetUp() override {
+        BaseSignalPathTest::SetUp();
+        m_pDeck4 = std::make_unique<Deck>(nullptr,
+                m_pConfig,
+                m_pEngineMixer,
+                m_pEffectsManager,
+                EngineChannel::CENTER,
+                m_pEngineMixer->registerChannelGroup(QStringLiteral("[Channel4]")));
+        addDeck(m_pDeck4->getEngineDeck());
+        // Created by SoundManager in the application
+        m_pInputGain = std::make_unique<ControlObject>(ConfigKey(VINYL_PREF_KEY, "gain"));
+        m_pInputGain->set(1.0);
+        config()->set(ConfigKey("[Soundcard]", "Samplerate"),
+                ConfigValue(static_cast<int>(kSampleRate.value())));
+
+        const QString kTrackLocationTest = getTestDir().filePath(QStringLiteral("sine-30.wav"));
+        const std::vector<BaseTrackPlayerImpl*> decks = {
+                m_pMixerDeck1, m_pMixerDeck2, m_pMixerDeck3, m_pDeck4.get()};
+        for (auto* pDeck : decks) {
+            loadTrack(pDeck, TrackPointer(Track::newTemporary(kTrackLocationTest)));
+            ControlObject::set(ConfigKey(pDeck->getGroup(), "vinylcontrol_mode"),
+                    MIXXX_VCMODE_RELATIVE);
+            ControlObject::set(ConfigKey(pDeck->getGroup(), "vinylcontrol_enabled"), 1.0);
+        }
+    }
+
+    void TearDown() override {
+        m_pProcessor.reset();
+        m_pInputGain.reset();
+        m_pDeck4.reset();
+        BaseSignalPathTest::TearDown();
+    }
+
+    void createProcessor(bool perInputThreads, int numInputs) {
+        config()->setValue(ConfigKey(VINYL_PREF_KEY, "per_input_threads"), perInputThreads);
+        m_pProcessor = std::make_unique<VinylControlProcessor>(nullptr, config());
+        for (int i = 0; i < numInputs; ++i) {
+            m_pProcessor->onInputConfigured(vinylControlInput(i));
+        }
+    }
+
+    // Passes one buffer of each input to the processor, like the callback of
+    // the sound device, and waits until all of them have been analyzed.
+    void replay(int numInputs, const CSAMPLE* pBuffer, SINT frames) {
+        SINT expectedFrames[kMaximumVinylControlInputs];
+        for (int i = 0; i < numInputs; ++i) {
+            expectedFrames[i] = m_pProcessor->analyzedFrames(i) + frames;
+            m_pProcessor->receiveBuffer(vinylControlInput(i), pBuffer, frames);
+        }
+        for (int i = 0; i < numInputs; ++i) {
+            while (m_pProcessor->analyzedFrames(i) < expectedFrames[i]) {
+                if (!m_pProcessor->perInputThreads()) {
+                    // The shared thread misses wake ups that arrive while it
+                    // is busy. In realtime the next buffer wakes it up again.
+                    m_pProcessor->receiveBuffer(vinylControlInput(i), pBuffer, 0);
+                }
+                QThread::yieldCurrentThread();
+            }
+        }
+    }
+
+    std::unique_ptr<Deck> m_pDeck4;
+    std::unique_ptr<ControlObject> m_pInputGain;
+    std::unique_ptr<VinylControlProcessor> m_pProcessor;
+};
+
+TEST_F(VinylControlProcessorTest, perInputThreadsAnalyzeAllInputs) {
+    createProcessor(true, kMaximumVinylControlInputs);
+    ASSERT_TRUE(m_pProcessor->perInputThreads());
+    m_pProcessor->setSignalQualityReporting(true);
+
+    const auto recording = recordTimecode(0.5);
+    constexpr SINT kFrames = 256;
+    for (int buffer = 0; buffer < 16; ++buffer) {
+        replay(kMaximumVinylControlInputs, recording.data() + buffer * kFrames * kChannels, kFrames);
+    }
+    for (int i = 0; i < kMaximumVinylControlInputs; ++i) {
+        EXPECT_EQ(16 * kFrames, m_pProcessor->analyzedFrames(i));
+    }
+
+    bool reported[kMaximumVinylControlInputs] = {};
+    VinylSignalQualityReport report;
+    while (m_pProcessor->readSignalQualityReport(&report)) {
+        ASSERT_LT(report.processor, kMaximumVinylControlInputs);
+        reported[report.processor] = true;
+    }
+    EXPECT_TRUE(std::all_of(std::begin(reported), std::end(reported), [](bool r) { return r; }));
+
+    // Reconfiguring an input restarts its worker
+    m_pProcessor->onInputUnconfigured(vinylControlInput(0));
+    EXPECT_FALSE(m_pProcessor->deckConfigured(0));
+    m_pProcessor->onInputConfigured(vinylControlInput(0));
+    replay(1, recording.data(), kFrames);
+    EXPECT_EQ(kFrames, m_pProcessor->analyzedFrames(0));
+}
+
+class VinylControlReplayBenchmarkSetup : public VinylControlProcessorTest {
+  public:
+    VinylControlReplayBenchmarkSetup(bool perInputThreads, int numInputs) {
+        SetUp();
+        createProcessor(perInputThreads, numInputs);
+    }
+
+    ~VinylControlReplayBenchmarkSetup() override {
+        TearDown();
+    }
+
+    using VinylControlProcessorTest::replay;
+
+  private:
+    void TestBody() override {
+    }
+};
+
+// Arguments: per-input threads, timecode inputs, frames per buffer
+void BM_VinylControlReplay(benchmark::State& state) {
+    const bool perInputThreads = state.range(0) != 0;
+    const auto numInputs = static_cast<int>(state.range(1));
+    const auto framesPerBuffer = static_cast<SINT>(state.range(2));
+    VinylControlReplayBenchmarkSetup setup(perInputThreads, numInputs);
+
+    // Fast scratches, which suffer most from latency
+    const auto recording = recordTimecode(4.0);
+    const auto recordingFrames = static_cast<SINT>(recording.size() / kChannels);
+    std::vector<double> latencyMicros;
+    latencyMicros.reserve(kReplayIterations);
+    SINT framePos = 0;
+    PerformanceTimer timer;
+    for (auto _ : state) {
+        if (framePos + framesPerBuffer > recordingFrames) {
+            framePos = 0;
+        }
+        timer.start();
+        setup.replay(numInputs, recording.data() + framePos * kChannels, framesPerBuffer);
+        latencyMicros.push_back(timer.elapsed().toDoubleMicros());
+        framePos += framesPerBuffer;
+    }
+    state.SetItemsProcessed(state.iterations() * framesPerBuffer * numInputs);
+
+    std::sort(latencyMicros.begin(), latencyMicros.end());
+    const auto percentile = [&latencyMicros](double p) {
+        return latencyMicros[static_cast<std::size_t>(p * (latencyMicros.size() - 1))];
+    };
+    state.counters["p50_us"] = percentile(0.5);
+    state.counters["p99_us"] = percentile(0.99);
+    state.counters["max_us"] = latencyMicros.back();
+}
+
+} // namespace
+
+BENCHMARK(BM_VinylControlReplay)
+        ->ArgNames({"per_input", "inputs", "frames"})
+        ->Args({0, 1, 256})
+        ->Args({1, 1, 256})
+        ->Args({0, 4, 64})
+        ->Args({1, 4, 64})
+        ->Args({0, 4, 256})
+        ->Args({1, 4, 256})
+        ->Args({0, 4, 1024})
+        ->Args({1, 4, 1024})
+        ->Iterations(kReplayIterations)
+        ->Unit(benchmark::kMicrosecond)
+        ->UseRealTime();
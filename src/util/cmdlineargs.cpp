@@ -59,6 +59,8 @@ CmdlineArgs::CmdlineArgs()
           m_safeMode(false),
           m_useLegacyVuMeter(false),
           m_useLegacySpinny(false),
+          m_useShaderOverview(false),
+          m_useSharedWaveformSurface(false),
           m_debugAssertBreak(false),
           m_settingsPathSet(false),
           m_scaleFactor(1.0),
@@ -236,6 +238,24 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
     parser.addOption(timelinePath);
     parser.addOption(timelinePathDeprecated);
 
+    const QCommandLineOption renderOffline(QStringLiteral("render-offline"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Renders the main mix of the specified music files "
+                                      "faster than realtime into the --render-output file "
+                                      "and exits. The automation script contains one control "
+                                      "change per line, e.g. '12.5 [Channel1] play 1'. The "
+                                      "last event marks the end of the rendering.")
+                            : QString(),
+            QStringLiteral("script"));
+    parser.addOption(renderOffline);
+
+    const QCommandLineOption renderOutput(QStringLiteral("render-output"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "The WAV file --render-offline writes to")
+                            : QString(),
+            QStringLiteral("file"));
+    parser.addOption(renderOutput);
+
     const QCommandLineOption enableLegacyVuMeter(QStringLiteral("enable-legacy-vumeter"),
             forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
                                       "Use legacy vu meter")
@@ -248,6 +268,20 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
                             : QString());
     parser.addOption(enableLegacySpinny);
 
+    const QCommandLineOption enableShaderOverview(QStringLiteral("enable-shader-overview"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Render the waveform overviews with OpenGL shaders")
+                            : QString());
+    parser.addOption(enableShaderOverview);
+
+    const QCommandLineOption enableSharedWaveformSurface(
+            QStringLiteral("enable-shared-waveform-surface"),
+            forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
+                                      "Render the accelerated waveforms of all decks "
+                                      "into one OpenGL surface")
+                            : QString());
+    parser.addOption(enableSharedWaveformSurface);
+
     const QCommandLineOption controllerDebug(QStringLiteral("controller-debug"),
             forUserFeedback ? QCoreApplication::translate("CmdlineArgs",
                                       "Causes Mixxx to display/log all of the controller data it "
@@ -441,8 +475,19 @@ bool CmdlineArgs::parse(const QStringList& arguments, CmdlineArgs::ParseMode mod
         m_timelinePath = parser.value(timelinePathDeprecated);
     }
 
+    if (parser.isSet(renderOffline)) {
+        m_renderOfflineScriptPath = parser.value(renderOffline);
+        m_renderOfflineOutputPath = parser.value(renderOutput);
+        if (m_renderOfflineOutputPath.isEmpty()) {
+            fputs("\nrender-offline requires render-output to be set.\n", stdout);
+            return false;
+        }
+    }
+
     m_useLegacyVuMeter = parser.isSet(enableLegacyVuMeter);
     m_useLegacySpinny = parser.isSet(enableLegacySpinny);
+    m_useShaderOverview = parser.isSet(enableShaderOverview);
+    m_useSharedWaveformSurface = parser.isSet(enableSharedWaveformSurface);
     m_controllerDebug = parser.isSet(controllerDebug) || parser.isSet(controllerDebugDeprecated);
     m_controllerPreviewScreens = parser.isSet(controllerPreviewScreens);
     m_controllerAbortOnWarning = parser.isSet(controllerAbortOnWarning);
@@ -61,6 +61,12 @@ class CmdlineArgs final {
     bool getUseLegacySpinny() const {
         return m_useLegacySpinny;
     }
+    bool getUseShaderOverview() const {
+        return m_useShaderOverview;
+    }
+    bool getUseSharedWaveformSurface() const {
+        return m_useSharedWaveformSurface;
+    }
     bool getDebugAssertBreak() const { return m_debugAssertBreak; }
     bool getSettingsPathSet() const { return m_settingsPathSet; }
     mixxx::LogLevel getLogLevel() const { return m_logLevel; }
@@ -76,6 +82,15 @@ class CmdlineArgs final {
     }
     const QString& getResourcePath() const { return m_resourcePath; }
     const QString& getTimelinePath() const { return m_timelinePath; }
+    bool getRenderOffline() const {
+        return !m_renderOfflineScriptPath.isEmpty();
+    }
+    const QString& getRenderOfflineScriptPath() const {
+        return m_renderOfflineScriptPath;
+    }
+    const QString& getRenderOfflineOutputPath() const {
+        return m_renderOfflineOutputPath;
+    }
 
     void setScaleFactor(double scaleFactor) {
         m_scaleFactor = scaleFactor;
@@ -106,6 +121,8 @@ class CmdlineArgs final {
     bool m_safeMode;
     bool m_useLegacyVuMeter;
     bool m_useLegacySpinny;
+    bool m_useShaderOverview;
+    bool m_useSharedWaveformSurface;
     bool m_debugAssertBreak;
     bool m_settingsPathSet; // has --settingsPath been set on command line ?
     double m_scaleFactor;
@@ -118,4 +135,6 @@ class CmdlineArgs final {
     QString m_settingsPath;
     QString m_resourcePath;
     QString m_timelinePath;
+    QString m_renderOfflineScriptPath;
+    QString m_renderOfflineOutputPath;
 };
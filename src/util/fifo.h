@@ -1,37 +1,66 @@
 #pragma once
 
-#include "pa_ringbuffer.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
 
+// Only for ring_buffer_size_t, which is part of the region API below
+#include "pa_ringbuffer.h"
 #include "util/class.h"
 #include "util/math.h"
 
-template <class DataType>
+/// A lock-free single-producer/single-consumer ring buffer.
+///
+/// The capacity is rounded up to a power of two, so indices wrap with a mask.
+/// The read and write indices are free running and live on separate cache
+/// lines, to avoid false sharing between the producer and the consumer thread.
+///
+/// Besides copying read()/write(), the aquire/release region functions give
+/// in-place access to the contiguous parts of the buffer, which allows zero
+/// copy reading and writing. Only a single thread may write and only a single
+/// thread may read at a time.
+template<class DataType>
 class FIFO {
   public:
     explicit FIFO(int size)
-            : m_data(roundUpToPowerOf2(size)) {
-        // If we can't represent the next higher power of 2 then bail.
-        if (m_data.size() == 0) {
-            return;
-        }
-        PaUtil_InitializeRingBuffer(&m_ringBuffer,
-                static_cast<ring_buffer_size_t>(sizeof(DataType)),
-                static_cast<ring_buffer_size_t>(m_data.size()),
-                m_data.data());
+            : m_data(roundUpToPowerOf2(size)),
+              // If we can't represent the next higher power of 2 the buffer
+              // is empty and nothing can be read or written.
+              m_mask(m_data.empty() ? 0 : m_data.size() - 1),
+              m_writeIndex(0),
+              m_readIndex(0) {
     }
     virtual ~FIFO() {
     }
     int readAvailable() const {
-        return PaUtil_GetRingBufferReadAvailable(&m_ringBuffer);
+        return static_cast<int>(m_writeIndex.load(std::memory_order_acquire) -
+                m_readIndex.load(std::memory_order_acquire));
     }
     int writeAvailable() const {
-        return PaUtil_GetRingBufferWriteAvailable(&m_ringBuffer);
+        return static_cast<int>(m_data.size()) - readAvailable();
     }
     int read(DataType* pData, int count) {
-        return PaUtil_ReadRingBuffer(&m_ringBuffer, pData, count);
+        DataType* dataPtr1;
+        ring_buffer_size_t size1;
+        DataType* dataPtr2;
+        ring_buffer_size_t size2;
+        const int read = aquireReadRegions(count, &dataPtr1, &size1, &dataPtr2, &size2);
+        std::copy(dataPtr1, dataPtr1 + size1, pData);
+        std::copy(dataPtr2, dataPtr2 + size2, pData + size1);
+        releaseReadRegions(read);
+        return read;
     }
     int write(const DataType* pData, int count) {
-        return PaUtil_WriteRingBuffer(&m_ringBuffer, pData, count);
+        DataType* dataPtr1;
+        ring_buffer_size_t size1;
+        DataType* dataPtr2;
+        ring_buffer_size_t size2;
+        const int written = aquireWriteRegions(count, &dataPtr1, &size1, &dataPtr2, &size2);
+        std::copy(pData, pData + size1, dataPtr1);
+        std::copy(pData + size1, pData + written, dataPtr2);
+        releaseWriteRegions(written);
+        return written;
     }
     void writeBlocking(const DataType* pData, int count) {
         int written = 0;
@@ -39,31 +68,77 @@ class FIFO {
             written += write(pData + written, count - written);
         }
     }
+    /// Returns up to count elements of free space in place, split into two
+    /// regions if the space wraps around the end of the buffer. The space is
+    /// published to the reader by releaseWriteRegions().
     int aquireWriteRegions(int count,
             DataType** dataPtr1, ring_buffer_size_t* sizePtr1,
             DataType** dataPtr2, ring_buffer_size_t* sizePtr2) {
-        return PaUtil_GetRingBufferWriteRegions(&m_ringBuffer, count,
-                (void**)dataPtr1, sizePtr1, (void**)dataPtr2, sizePtr2);
+        const int available = math_min(count, writeAvailable());
+        getRegions(m_writeIndex.load(std::memory_order_relaxed),
+                available,
+                dataPtr1,
+                sizePtr1,
+                dataPtr2,
+                sizePtr2);
+        return available;
     }
     int releaseWriteRegions(int count) {
-        return PaUtil_AdvanceRingBufferWriteIndex(&m_ringBuffer, count);
+        const std::size_t writeIndex =
+                m_writeIndex.load(std::memory_order_relaxed) + count;
+        m_writeIndex.store(writeIndex, std::memory_order_release);
+        return static_cast<int>(writeIndex & m_mask);
     }
+    /// Returns up to count readable elements in place, split into two
+    /// regions if they wrap around the end of the buffer. The elements stay
+    /// valid until they are released by releaseReadRegions().
     int aquireReadRegions(int count,
             DataType** dataPtr1, ring_buffer_size_t* sizePtr1,
             DataType** dataPtr2, ring_buffer_size_t* sizePtr2) {
-        return PaUtil_GetRingBufferReadRegions(&m_ringBuffer, count,
-                (void**)dataPtr1, sizePtr1, (void**)dataPtr2, sizePtr2);
+        const int available = math_min(count, readAvailable());
+        getRegions(m_readIndex.load(std::memory_order_relaxed),
+                available,
+                dataPtr1,
+                sizePtr1,
+                dataPtr2,
+                sizePtr2);
+        return available;
     }
     int releaseReadRegions(int count) {
-        return PaUtil_AdvanceRingBufferReadIndex(&m_ringBuffer, count);
+        const std::size_t readIndex =
+                m_readIndex.load(std::memory_order_relaxed) + count;
+        m_readIndex.store(readIndex, std::memory_order_release);
+        return static_cast<int>(readIndex & m_mask);
     }
     int flushReadData(int count) {
         int flush = math_min(readAvailable(), count);
-        return PaUtil_AdvanceRingBufferReadIndex(&m_ringBuffer, flush);
+        return releaseReadRegions(flush);
     }
 
   private:
+    // Avoid std::hardware_destructive_interference_size, which is not
+    // available with all supported compilers.
+    static constexpr std::size_t kCacheLineSize = 64;
+
+    void getRegions(std::size_t index,
+            int count,
+            DataType** dataPtr1,
+            ring_buffer_size_t* sizePtr1,
+            DataType** dataPtr2,
+            ring_buffer_size_t* sizePtr2) {
+        const std::size_t start = index & m_mask;
+        const int size1 = math_min(count, static_cast<int>(m_data.size() - start));
+        *dataPtr1 = m_data.data() + start;
+        *sizePtr1 = size1;
+        *dataPtr2 = m_data.data();
+        *sizePtr2 = count - size1;
+    }
+
     std::vector<DataType> m_data;
-    PaUtilRingBuffer m_ringBuffer;
+    const std::size_t m_mask;
+    // Written by the producer only
+    alignas(kCacheLineSize) std::atomic<std::size_t> m_writeIndex;
+    // Written by the consumer only
+    alignas(kCacheLineSize) std::atomic<std::size_t> m_readIndex;
     DISALLOW_COPY_AND_ASSIGN(FIFO);
 };
@@ -0,0 +1,54 @@
+#include "util/mappedfile.h"
+
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("MappedFile");
+
+} // anonymous namespace
+
+MappedFile::MappedFile(const QString& filePath)
+        : m_file(filePath),
+          m_pData(nullptr),
+          m_size(0) {
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        kLogger.warning()
+                << "Failed to open file"
+                << filePath
+                << m_file.errorString();
+        return;
+    }
+    const qint64 size = m_file.size();
+    if (size <= 0) {
+        return;
+    }
+    m_pData = m_file.map(0, size);
+    if (!m_pData) {
+        kLogger.info()
+                << "Reading file into memory, because it can't be mapped"
+                << filePath
+                << m_file.errorString();
+        m_buffer = m_file.readAll();
+        if (m_buffer.size() != size) {
+            kLogger.warning()
+                    << "Failed to read file"
+                    << filePath
+                    << m_file.errorString();
+            m_buffer.clear();
+            return;
+        }
+        m_pData = reinterpret_cast<const uchar*>(m_buffer.constData());
+    }
+    m_size = size;
+}
+
+MappedFile::~MappedFile() {
+    if (isMapped()) {
+        m_file.unmap(const_cast<uchar*>(m_pData));
+    }
+}
+
+} // namespace mixxx
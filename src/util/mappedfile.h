@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+namespace mixxx {
+
+/// Maps a whole file read-only into memory.
+///
+/// If the file can't be mapped, e.g. on some network file systems, its
+/// contents are read into memory instead. Either way data() stays valid
+/// until the MappedFile is destroyed.
+///
+/// NOTE: Like any memory mapping, a file that disappears while mapped, e.g.
+/// on a removable drive, might terminate the application with SIGBUS. Keep
+/// the mapping only for as long as the data is parsed.
+class MappedFile final {
+  public:
+    explicit MappedFile(const QString& filePath);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&&) = delete;
+    MappedFile& operator=(MappedFile&&) = delete;
+
+    bool isValid() const {
+        return m_pData != nullptr;
+    }
+
+    bool isMapped() const {
+        return isValid() && m_buffer.isNull();
+    }
+
+    const uchar* data() const {
+        return m_pData;
+    }
+
+    qint64 size() const {
+        return m_size;
+    }
+
+  private:
+    QFile m_file;
+    const uchar* m_pData;
+    qint64 m_size;
+    QByteArray m_buffer;
+};
+
+} // namespace mixxx
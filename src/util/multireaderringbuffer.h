@@ -0,0 +1,271 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "util/assert.h"
+#include "util/math.h"
+
+/// A lock-free ring buffer with a single writer and multiple readers.
+///
+/// The writer copies the data into the buffer once. Every reader has its own
+/// read cursor and accesses the data in place through acquireReadRegions(),
+/// so no reader needs its own copy.
+///
+/// A reader that lags so far behind that a write would overrun its unread
+/// data doesn't hold back the others: its read cursor is advanced past the
+/// overwritten items, and only its overflow counter is charged with them.
+/// Items that a reader has acquired are never overwritten though. If a write
+/// would reach them, the whole block is dropped and charged to the overflow
+/// counters of all readers, which miss it alike. Readers should acquire and
+/// hold only small parts of the buffer at a time.
+///
+/// write() is wait-free and may be called from the realtime thread. Readers
+/// are added and removed from other threads, each reader must only be read
+/// from a single thread.
+template<typename DataType>
+class MultiReaderRingBuffer final {
+  public:
+    using ReaderId = int;
+
+    MultiReaderRingBuffer(int size, int maxReaders)
+            : m_data(roundUpToPowerOf2(size)),
+              m_mask(static_cast<std::uint64_t>(m_data.size()) - 1),
+              m_readers(std::make_unique<Reader[]>(maxReaders)),
+              m_maxReaders(maxReaders),
+              m_writePos(0) {
+    }
+
+    int size() const {
+        return static_cast<int>(m_data.size());
+    }
+
+    /// Adds a reader, which starts reading at the current write position.
+    /// Returns -1 if already maxReaders readers are active.
+    ReaderId addReader() {
+        for (ReaderId reader = 0; reader < m_maxReaders; ++reader) {
+            Reader& slot = m_readers[reader];
+            bool expected = false;
+            if (slot.allocated.compare_exchange_strong(expected, true)) {
+                slot.readState.store(
+                        toReadState(m_writePos.load(std::memory_order_acquire), false),
+                        std::memory_order_relaxed);
+                slot.overflowCount.store(0, std::memory_order_relaxed);
+                // Only now the writer starts to respect this reader.
+                slot.active.store(true, std::memory_order_release);
+                return reader;
+            }
+        }
+        return -1;
+    }
+
+    void removeReader(ReaderId reader) {
+        VERIFY_OR_DEBUG_ASSERT(isValidReader(reader)) {
+            return;
+        }
+        m_readers[reader].active.store(false, std::memory_order_release);
+        m_readers[reader].allocated.store(false, std::memory_order_release);
+    }
+
+    /// The space left for the writer before the slowest reader is overrun.
+    int writeAvailable() const {
+        const std::uint64_t writePos = m_writePos.load(std::memory_order_relaxed);
+        std::uint64_t minReadPos = writePos;
+        for (ReaderId reader = 0; reader < m_maxReaders; ++reader) {
+            const Reader& slot = m_readers[reader];
+            if (slot.active.load(std::memory_order_acquire)) {
+                minReadPos = std::min(minReadPos,
+                        readPosOf(slot.readState.load(std::memory_order_acquire)));
+            }
+        }
+        return static_cast<int>(m_data.size() - (writePos - minReadPos));
+    }
+
+    /// Writes count items and returns the number of items written, which is
+    /// less than count if the block is larger than the whole buffer and 0 if
+    /// the block would overwrite items acquired by a reader.
+    /// Wait-free, must only be called by a single writer thread.
+    int write(const DataType* pData, int count) {
+        const std::uint64_t writePos = m_writePos.load(std::memory_order_relaxed);
+        const std::uint64_t capacity = m_data.size();
+        if (static_cast<std::uint64_t>(count) > capacity) {
+            // Only the most recent items fit into the buffer
+            pData += count - capacity;
+            count = static_cast<int>(capacity);
+        }
+        const std::uint64_t newWritePos = writePos + count;
+
+        // Move the readers that would be overrun past the overwritten items,
+        // before overwriting them.
+        const std::uint64_t minReadPos =
+                newWritePos > capacity ? newWritePos - capacity : 0;
+        if (isAcquiredBefore(minReadPos)) {
+            dropWrite(count);
+            return 0;
+        }
+        for (ReaderId reader = 0; reader < m_maxReaders; ++reader) {
+            Reader& slot = m_readers[reader];
+            if (!slot.active.load(std::memory_order_acquire)) {
+                continue;
+            }
+            // Synchronizes with releaseReadRegions(), the released items
+            // must have been read before they are overwritten.
+            std::uint64_t readState = slot.readState.load(std::memory_order_acquire);
+            while (readPosOf(readState) < minReadPos) {
+                // The reader has acquired its items since the check above
+                if (isAcquired(readState)) {
+                    dropWrite(count);
+                    return 0;
+                }
+                // Fails if the reader released or acquired items meanwhile,
+                // then retry with its new state.
+                if (slot.readState.compare_exchange_weak(readState,
+                            toReadState(minReadPos, false),
+                            std::memory_order_acq_rel,
+                            std::memory_order_acquire)) {
+                    slot.overflowCount.fetch_add(
+                            minReadPos - readPosOf(readState), std::memory_order_relaxed);
+                    break;
+                }
+            }
+        }
+
+        const std::uint64_t startIndex = writePos & m_mask;
+        const int size1 = std::min(count, static_cast<int>(capacity - startIndex));
+        std::copy(pData, pData + size1, m_data.begin() + startIndex);
+        std::copy(pData + size1, pData + count, m_data.begin());
+
+        // Publish the data to the readers
+        m_writePos.store(newWritePos, std::memory_order_release);
+        return count;
+    }
+
+    int readAvailable(ReaderId reader) const {
+        DEBUG_ASSERT(isValidReader(reader));
+        // The write position first, the writer advances the read position
+        // of an overrun reader before publishing the new write position.
+        const std::uint64_t writePos = m_writePos.load(std::memory_order_acquire);
+        return static_cast<int>(writePos -
+                readPosOf(m_readers[reader].readState.load(std::memory_order_acquire)));
+    }
+
+    /// Returns pointers to up to count items, which can be read in place until
+    /// they are released with releaseReadRegions(). The writer doesn't
+    /// overwrite them meanwhile. The data may wrap around the end of the
+    /// buffer, then they are split into two regions.
+    /// Returns the total number of items available in both regions.
+    int acquireReadRegions(ReaderId reader,
+            int count,
+            const DataType** pData1,
+            int* pSize1,
+            const DataType** pData2,
+            int* pSize2) {
+        DEBUG_ASSERT(isValidReader(reader));
+        Reader& slot = m_readers[reader];
+        DEBUG_ASSERT(!isAcquired(slot.readState.load(std::memory_order_relaxed)));
+        // Marking the items as acquired prevents that the writer advances the
+        // read position, so the items from there on can't be overwritten.
+        std::uint64_t readState = slot.readState.load(std::memory_order_relaxed);
+        while (!slot.readState.compare_exchange_weak(readState,
+                toReadState(readPosOf(readState), true),
+                std::memory_order_acq_rel,
+                std::memory_order_acquire)) {
+        }
+        const std::uint64_t readPos = readPosOf(readState);
+        slot.acquiredPos = readPos;
+        // Loaded afterwards, all items up to here are protected
+        const std::uint64_t writePos = m_writePos.load(std::memory_order_acquire);
+        const int available = std::min(count, static_cast<int>(writePos - readPos));
+        const std::uint64_t startIndex = readPos & m_mask;
+        const int size1 = std::min(available, static_cast<int>(m_data.size() - startIndex));
+        *pData1 = m_data.data() + startIndex;
+        *pSize1 = size1;
+        *pData2 = m_data.data();
+        *pSize2 = available - size1;
+        return available;
+    }
+
+    /// Releases count items previously acquired by acquireReadRegions(),
+    /// allowing the writer to reuse their space.
+    void releaseReadRegions(ReaderId reader, int count) {
+        DEBUG_ASSERT(isValidReader(reader));
+        Reader& slot = m_readers[reader];
+        DEBUG_ASSERT(isAcquired(slot.readState.load(std::memory_order_relaxed)));
+        // The writer doesn't modify the state of a reader that has acquired
+        // items, so it can't have moved the read position meanwhile.
+        slot.readState.store(toReadState(slot.acquiredPos + count, false),
+                std::memory_order_release);
+    }
+
+    /// Returns and resets the number of items dropped, because this reader
+    /// didn't keep up with the writer.
+    std::uint64_t takeOverflowCount(ReaderId reader) {
+        DEBUG_ASSERT(isValidReader(reader));
+        return m_readers[reader].overflowCount.exchange(0, std::memory_order_relaxed);
+    }
+
+  private:
+    struct Reader {
+        std::atomic<bool> allocated{false};
+        std::atomic<bool> active{false};
+        // The read position and whether the reader has acquired the items
+        // from there on, in a single word so that the writer can't advance
+        // the read position while the reader acquires them.
+        std::atomic<std::uint64_t> readState{0};
+        std::atomic<std::uint64_t> overflowCount{0};
+        // Only accessed by the reader's thread
+        std::uint64_t acquiredPos{0};
+    };
+
+    static constexpr std::uint64_t toReadState(std::uint64_t readPos, bool acquired) {
+        return (readPos << 1) | (acquired ? 1 : 0);
+    }
+
+    static constexpr std::uint64_t readPosOf(std::uint64_t readState) {
+        return readState >> 1;
+    }
+
+    static constexpr bool isAcquired(std::uint64_t readState) {
+        return (readState & 1) != 0;
+    }
+
+    // Returns true if a reader has acquired items before minReadPos, which
+    // would be overwritten.
+    bool isAcquiredBefore(std::uint64_t minReadPos) const {
+        for (ReaderId reader = 0; reader < m_maxReaders; ++reader) {
+            const Reader& slot = m_readers[reader];
+            if (!slot.active.load(std::memory_order_acquire)) {
+                continue;
+            }
+            const std::uint64_t readState = slot.readState.load(std::memory_order_acquire);
+            if (isAcquired(readState) && readPosOf(readState) < minReadPos) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // None of the readers receives the dropped items
+    void dropWrite(int count) {
+        for (ReaderId reader = 0; reader < m_maxReaders; ++reader) {
+            Reader& slot = m_readers[reader];
+            if (slot.active.load(std::memory_order_acquire)) {
+                slot.overflowCount.fetch_add(count, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool isValidReader(ReaderId reader) const {
+        return reader >= 0 && reader < m_maxReaders &&
+                m_readers[reader].allocated.load(std::memory_order_relaxed);
+    }
+
+    std::vector<DataType> m_data;
+    const std::uint64_t m_mask;
+    const std::unique_ptr<Reader[]> m_readers;
+    const int m_maxReaders;
+    std::atomic<std::uint64_t> m_writePos;
+};
@@ -0,0 +1,61 @@
+#include "vinylcontrol/timecodefrontend.h"
+
+#include "util/math.h"
+
+#ifdef _MSC_VER
+#include "timecoder.h"
+#else
+extern "C" {
+#include "timecoder.h"
+}
+#endif
+
+namespace {
+
+constexpr SINT kChannels = 2;
+
+// xwax works in the full range of a signed int
+constexpr int kTimecoderScale = 1 << 16;
+
+// Small enough to stay in the L1 cache while the decoder runs over it
+constexpr SINT kBlockFrames = 256;
+
+} // anonymous namespace
+
+TimecodeFrontEnd::TimecodeFrontEnd()
+        : m_left(kBlockFrames),
+          m_right(kBlockFrames) {
+}
+
+void TimecodeFrontEnd::convert(
+        const CSAMPLE* pSamples, SINT numFrames, CSAMPLE_GAIN gain) {
+    int* pLeft = m_left.data();
+    int* pRight = m_right.data();
+    // note: LOOP VECTORIZED.
+    for (SINT i = 0; i < numFrames; ++i) {
+        // Clipped and truncated to the range of SAMPLE. Multiplying by the
+        // gain and the maximum in two steps keeps the rounding of the
+        // conversion to SAMPLE.
+        const CSAMPLE left = math_clamp(pSamples[i * kChannels] * gain * SAMPLE_MAXIMUM,
+                static_cast<CSAMPLE>(SAMPLE_MINIMUM),
+                static_cast<CSAMPLE>(SAMPLE_MAXIMUM));
+        const CSAMPLE right = math_clamp(pSamples[i * kChannels + 1] * gain * SAMPLE_MAXIMUM,
+                static_cast<CSAMPLE>(SAMPLE_MINIMUM),
+                static_cast<CSAMPLE>(SAMPLE_MAXIMUM));
+        pLeft[i] = static_cast<int>(left) * kTimecoderScale;
+        pRight[i] = static_cast<int>(right) * kTimecoderScale;
+    }
+}
+
+void TimecodeFrontEnd::submit(struct timecoder* pTimecoder,
+        const CSAMPLE* pSamples,
+        SINT numFrames,
+        CSAMPLE_GAIN gain) {
+    while (numFrames > 0) {
+        const SINT frames = math_min(numFrames, kBlockFrames);
+        convert(pSamples, frames, gain);
+        timecoder_submit_channels(pTimecoder, m_left.data(), m_right.data(), frames);
+        pSamples += frames * kChannels;
+        numFrames -= frames;
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+
+#include "util/types.h"
+
+struct timecoder;
+
+// Prepares blocks of input samples for the xwax timecoder.
+//
+// The conversion to the integer range of xwax, the gain and the separation
+// of the left and right channel are done for a whole block in loops that the
+// compiler vectorizes, instead of per sample in front of each call into the
+// decoder. The decoded position and pitch are exactly the same as when
+// converting the samples to SAMPLE and passing them to timecoder_submit().
+class TimecodeFrontEnd {
+  public:
+    TimecodeFrontEnd();
+
+    // The gain is applied before the conversion. Samples beyond the range
+    // of SAMPLE are clipped.
+    void submit(struct timecoder* pTimecoder,
+            const CSAMPLE* pSamples,
+            SINT numFrames,
+            CSAMPLE_GAIN gain);
+
+  private:
+    void convert(const CSAMPLE* pSamples, SINT numFrames, CSAMPLE_GAIN gain);
+
+    std::vector<int> m_left;
+    std::vector<int> m_right;
+};
@@ -0,0 +1,62 @@
+#include "vinylcontrol/vinylcontrolinputworker.h"
+
+#include "moc_vinylcontrolinputworker.cpp"
+#include "util/defs.h"
+#include "util/sample.h"
+#include "vinylcontrol/vinylcontrolprocessor.h"
+
+VinylControlInputWorker::VinylControlInputWorker(
+        VinylControlProcessor* pProcessor, int inputIndex)
+        : m_pProcessor(pProcessor),
+          m_inputIndex(inputIndex),
+          m_pWorkBuffer(SampleUtil::alloc(MAX_BUFFER_LEN)),
+          m_wakePending(false),
+          m_bQuit(false),
+          m_bReloadConfig(false) {
+}
+
+VinylControlInputWorker::~VinylControlInputWorker() {
+    stop();
+    SampleUtil::free(m_pWorkBuffer);
+}
+
+void VinylControlInputWorker::wake() {
+    if (!m_wakePending.exchange(true, std::memory_order_acq_rel)) {
+        m_semaWake.release();
+    }
+}
+
+void VinylControlInputWorker::requestReloadConfig() {
+    m_bReloadConfig = true;
+    m_semaWake.release();
+}
+
+void VinylControlInputWorker::stop() {
+    if (!isRunning()) {
+        return;
+    }
+    m_bQuit = true;
+    m_semaWake.release();
+    wait();
+    m_bQuit = false;
+}
+
+void VinylControlInputWorker::run() {
+    QThread::currentThread()->setObjectName(
+            QStringLiteral("VinylControlInputWorker %1").arg(m_inputIndex + 1));
+
+    while (true) {
+        m_semaWake.acquire();
+        if (m_bQuit) {
+            break;
+        }
+        // Samples that are written after this point are followed by another
+        // wake up, so none of them are left in the pipe.
+        m_wakePending.store(false, std::memory_order_release);
+
+        if (m_bReloadConfig.exchange(false)) {
+            m_pProcessor->reloadInputConfig(m_inputIndex);
+        }
+        m_pProcessor->processInput(m_inputIndex, m_pWorkBuffer);
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QSemaphore>
+#include <QThread>
+#include <atomic>
+
+#include "util/types.h"
+
+class VinylControlProcessor;
+
+// VinylControlInputWorker analyzes the timecode of a single vinyl control
+// input on a dedicated thread. VinylControlProcessor uses one worker per
+// configured input instead of its shared thread if per-input threads are
+// enabled, so the pitch and position updates of a deck don't wait for the
+// analysis of the other decks.
+class VinylControlInputWorker : public QThread {
+    Q_OBJECT
+  public:
+    VinylControlInputWorker(VinylControlProcessor* pProcessor, int inputIndex);
+    ~VinylControlInputWorker() override;
+
+    // Called by the engine callback after writing to the sample pipe of the
+    // input. Does not lock: the semaphore is only released if the worker has
+    // not been woken up since it last drained the sample pipe.
+    void wake();
+
+    // Called from the main thread.
+    void requestReloadConfig();
+
+    // Called from the main thread. Blocks until the worker has finished the
+    // buffer that it is currently analyzing. The worker can be restarted
+    // afterwards.
+    void stop();
+
+  protected:
+    void run() override;
+
+  private:
+    VinylControlProcessor* const m_pProcessor;
+    const int m_inputIndex;
+    CSAMPLE* m_pWorkBuffer;
+    QSemaphore m_semaWake;
+    std::atomic<bool> m_wakePending;
+    std::atomic<bool> m_bQuit;
+    std::atomic<bool> m_bReloadConfig;
+};
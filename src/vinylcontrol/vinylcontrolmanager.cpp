@@ -160,13 +160,8 @@ void VinylControlManager::removeSignalQualityListener(VinylSignalQualityListener
 }
 
 void VinylControlManager::updateSignalQualityListeners() {
-    FIFO<VinylSignalQualityReport>* signalQualityFifo = m_pProcessor->getSignalQualityFifo();
-    if (signalQualityFifo == nullptr) {
-        return;
-    }
-
     VinylSignalQualityReport report;
-    while (signalQualityFifo->read(&report, 1) == 1) {
+    while (m_pProcessor->readSignalQualityReport(&report)) {
         foreach (VinylSignalQualityListener* pListener, m_listeners) {
             pListener->onVinylSignalQualityUpdate(report);
         }
@@ -7,19 +7,21 @@
 #include "util/timer.h"
 #include "vinylcontrol/defs_vinylcontrol.h"
 #include "vinylcontrol/vinylcontrol.h"
+#include "vinylcontrol/vinylcontrolinputworker.h"
 #include "vinylcontrol/vinylcontrolxwax.h"
 
-#define SIGNAL_QUALITY_FIFO_SIZE 256
+#define SIGNAL_QUALITY_FIFO_SIZE (256 / kMaximumVinylControlInputs)
 #define SAMPLE_PIPE_FIFO_SIZE 65536
 
 VinylControlProcessor::VinylControlProcessor(QObject* pParent, UserSettingsPointer pConfig)
         : QThread(pParent),
           m_pConfig(pConfig),
+          m_bPerInputThreads(pConfig->getValue<bool>(
+                  ConfigKey(VINYL_PREF_KEY, "per_input_threads"), false)),
           m_pToggle(new ControlPushButton(ConfigKey(VINYL_PREF_KEY, "Toggle"))),
           m_pWorkBuffer(SampleUtil::alloc(MAX_BUFFER_LEN)),
           m_processorsLock(QT_RECURSIVE_MUTEX_INIT),
           m_processors(kMaximumVinylControlInputs, nullptr),
-          m_signalQualityFifo(SIGNAL_QUALITY_FIFO_SIZE),
           m_bReportSignalQuality(false),
           m_bQuit(false),
           m_bReloadConfig(false) {
@@ -31,15 +33,26 @@ VinylControlProcessor::VinylControlProcessor(QObject* pParent, UserSettingsPoint
 
     for (int i = 0; i < kMaximumVinylControlInputs; ++i) {
         m_samplePipes[i] = new FIFO<CSAMPLE>(SAMPLE_PIPE_FIFO_SIZE);
+        m_signalQualityFifos[i] = new FIFO<VinylSignalQualityReport>(SIGNAL_QUALITY_FIFO_SIZE);
+        m_analyzedFrames[i].store(0);
+        m_inputWorkers[i] = m_bPerInputThreads
+                ? new VinylControlInputWorker(this, i)
+                : nullptr;
     }
 
-    start(QThread::HighPriority);
+    if (!m_bPerInputThreads) {
+        start(QThread::HighPriority);
+    }
 }
 
 VinylControlProcessor::~VinylControlProcessor() {
     m_bQuit = true;
     m_samplesAvailableSignal.wakeAll();
     wait();
+    for (int i = 0; i < kMaximumVinylControlInputs; ++i) {
+        delete m_inputWorkers[i];
+        m_inputWorkers[i] = nullptr;
+    }
 
     delete m_pToggle;
     SampleUtil::free(m_pWorkBuffer);
@@ -53,6 +66,8 @@ VinylControlProcessor::~VinylControlProcessor() {
 
             delete m_samplePipes[i];
             m_samplePipes[i] = nullptr;
+            delete m_signalQualityFifos[i];
+            m_signalQualityFifos[i] = nullptr;
         }
     }
 
@@ -68,13 +83,49 @@ void VinylControlProcessor::setSignalQualityReporting(bool enable) {
 void VinylControlProcessor::shutdown() {
     m_bQuit = true;
     m_samplesAvailableSignal.wakeAll();
+    if (m_bPerInputThreads) {
+        for (int i = 0; i < kMaximumVinylControlInputs; ++i) {
+            stopInputWorker(i);
+        }
+    }
 }
 
 void VinylControlProcessor::requestReloadConfig() {
+    if (m_bPerInputThreads) {
+        for (int i = 0; i < kMaximumVinylControlInputs; ++i) {
+            m_inputWorkers[i]->requestReloadConfig();
+        }
+        return;
+    }
     m_bReloadConfig = true;
     m_samplesAvailableSignal.wakeAll();
 }
 
+bool VinylControlProcessor::readSignalQualityReport(VinylSignalQualityReport* pReport) {
+    for (int i = 0; i < kMaximumVinylControlInputs; ++i) {
+        if (m_signalQualityFifos[i]->read(pReport, 1) == 1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void VinylControlProcessor::startInputWorker(int index) {
+    if (!m_bPerInputThreads || m_bQuit) {
+        return;
+    }
+    // Decoding the timecode of a deck is as time critical as the engine
+    // callback that is waiting for its pitch.
+    m_inputWorkers[index]->start(QThread::TimeCriticalPriority);
+}
+
+void VinylControlProcessor::stopInputWorker(int index) {
+    if (!m_bPerInputThreads) {
+        return;
+    }
+    m_inputWorkers[index]->stop();
+}
+
 void VinylControlProcessor::run() {
     unsigned static id = 0; //the id of this thread, for debugging purposes //XXX copypasta (should factor this out somehow), -kousu 2/2009
     QThread::currentThread()->setObjectName(QString("VinylControlProcessor %1").arg(++id));
@@ -86,39 +137,7 @@ void VinylControlProcessor::run() {
         }
 
         for (int i = 0; i < kMaximumVinylControlInputs; ++i) {
-            auto locker = lockMutex(&m_processorsLock);
-            VinylControl* pProcessor = m_processors[i];
-            locker.unlock();
-            FIFO<CSAMPLE>* pSamplePipe = m_samplePipes[i];
-
-            if (pSamplePipe->readAvailable() > 0) {
-                int samplesRead = pSamplePipe->read(m_pWorkBuffer, MAX_BUFFER_LEN);
-
-                if (samplesRead % 2 != 0) {
-                    qWarning() << "VinylControlProcessor received non-even number of samples via sample FIFO.";
-                    samplesRead--;
-                }
-                int framesRead = samplesRead / 2;
-
-                if (pProcessor) {
-                    pProcessor->analyzeSamples(m_pWorkBuffer, framesRead);
-                } else {
-                    // Samples are being written to a non-existent processor. Warning?
-                    qWarning() << "Samples written to non-existent VinylControl processor:" << i;
-                }
-            }
-
-            // TODO(rryan) define a time-based update rate. This will update way
-            // too quickly.
-            if (pProcessor && m_bReportSignalQuality) {
-                VinylSignalQualityReport report;
-                if (pProcessor->writeQualityReport(&report)) {
-                    report.processor = i;
-                    if (m_signalQualityFifo.write(&report, 1) != 1) {
-                        qWarning() << "VinylControlProcessor could not write signal quality report for VC index:" << i;
-                    }
-                }
-            }
+            processInput(i, m_pWorkBuffer);
         }
 
         if (m_bQuit) {
@@ -133,22 +152,63 @@ void VinylControlProcessor::run() {
     }
 }
 
+void VinylControlProcessor::processInput(int index, CSAMPLE* pWorkBuffer) {
+    auto locker = lockMutex(&m_processorsLock);
+    VinylControl* pProcessor = m_processors[index];
+    locker.unlock();
+    FIFO<CSAMPLE>* pSamplePipe = m_samplePipes[index];
+
+    if (pSamplePipe->readAvailable() > 0) {
+        int samplesRead = pSamplePipe->read(pWorkBuffer, MAX_BUFFER_LEN);
+
+        if (samplesRead % 2 != 0) {
+            qWarning() << "VinylControlProcessor received non-even number of samples via sample FIFO.";
+            samplesRead--;
+        }
+        int framesRead = samplesRead / 2;
+
+        if (pProcessor) {
+            pProcessor->analyzeSamples(pWorkBuffer, framesRead);
+            m_analyzedFrames[index].fetch_add(framesRead, std::memory_order_release);
+        } else {
+            // Samples are being written to a non-existent processor. Warning?
+            qWarning() << "Samples written to non-existent VinylControl processor:" << index;
+        }
+    }
+
+    // TODO(rryan) define a time-based update rate. This will update way
+    // too quickly.
+    if (pProcessor && m_bReportSignalQuality) {
+        VinylSignalQualityReport report;
+        if (pProcessor->writeQualityReport(&report)) {
+            report.processor = index;
+            if (m_signalQualityFifos[index]->write(&report, 1) != 1) {
+                qWarning() << "VinylControlProcessor could not write signal quality report for VC index:" << index;
+            }
+        }
+    }
+}
+
 void VinylControlProcessor::reloadConfig() {
     for (int i = 0; i < kMaximumVinylControlInputs; ++i) {
-        auto locker = lockMutex(&m_processorsLock);
-        VinylControl* pCurrent = m_processors[i];
+        reloadInputConfig(i);
+    }
+}
 
-        if (pCurrent == nullptr) {
-            continue;
-        }
+void VinylControlProcessor::reloadInputConfig(int index) {
+    auto locker = lockMutex(&m_processorsLock);
+    VinylControl* pCurrent = m_processors[index];
 
-        VinylControl *pNew = new VinylControlXwax(
-            m_pConfig, kVCGroup.arg(i + 1));
-        m_processors.replace(i, pNew);
-        locker.unlock();
-        // Delete outside of the critical section to avoid deadlocks.
-        delete pCurrent;
+    if (pCurrent == nullptr) {
+        return;
     }
+
+    VinylControl* pNew = new VinylControlXwax(
+            m_pConfig, kVCGroup.arg(index + 1));
+    m_processors.replace(index, pNew);
+    locker.unlock();
+    // Delete outside of the critical section to avoid deadlocks.
+    delete pCurrent;
 }
 
 void VinylControlProcessor::onInputConfigured(const AudioInput& input) {
@@ -167,12 +227,17 @@ void VinylControlProcessor::onInputConfigured(const AudioInput& input) {
     VinylControl *pNew = new VinylControlXwax(
         m_pConfig, kVCGroup.arg(index + 1));
 
+    // The worker of the input must not analyze samples with the processor
+    // that is replaced.
+    stopInputWorker(index);
     auto locker = lockMutex(&m_processorsLock);
     VinylControl* pCurrent = m_processors.at(index);
     m_processors.replace(index, pNew);
     locker.unlock();
     // Delete outside of the critical section to avoid deadlocks.
     delete pCurrent;
+    m_analyzedFrames[index].store(0);
+    startInputWorker(index);
 }
 
 void VinylControlProcessor::onInputUnconfigured(const AudioInput& input) {
@@ -189,6 +254,7 @@ void VinylControlProcessor::onInputUnconfigured(const AudioInput& input) {
         return;
     }
 
+    stopInputWorker(index);
     auto locker = lockMutex(&m_processorsLock);
     VinylControl* pVC = m_processors.at(index);
     m_processors.replace(index, nullptr);
@@ -233,7 +299,11 @@ void VinylControlProcessor::receiveBuffer(const AudioInput& input,
                    << "VCIndex:" << vcIndex;
     }
 
-    m_samplesAvailableSignal.wakeAll();
+    if (m_bPerInputThreads) {
+        m_inputWorkers[vcIndex]->wake();
+    } else {
+        m_samplesAvailableSignal.wakeAll();
+    }
 }
 
 void VinylControlProcessor::toggleDeck(double value) {
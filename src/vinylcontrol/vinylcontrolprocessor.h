@@ -3,6 +3,7 @@
 #include <QThread>
 #include <QVector>
 #include <QWaitCondition>
+#include <atomic>
 
 #include "preferences/usersettings.h"
 #include "soundio/soundmanagerutil.h"
@@ -11,6 +12,7 @@
 #include "vinylcontrol/vinylsignalquality.h"
 
 class VinylControl;
+class VinylControlInputWorker;
 class ControlPushButton;
 class QObject;
 
@@ -18,6 +20,12 @@ class QObject;
 // the engine callback and feeding those samples to the VinylControl
 // classes. The most important thing is that the connection between the engine
 // callback and VinylControlProcessor (the receiveBuffer method) is lock-free.
+//
+// By default a single thread analyzes the inputs of all decks one after the
+// other. With the [VinylControl],per_input_threads preference every configured
+// input is analyzed by its own VinylControlInputWorker instead, which the
+// engine callback wakes up without taking a lock. The preference is read on
+// construction.
 class VinylControlProcessor : public QThread, public AudioDestination {
     Q_OBJECT
   public:
@@ -35,10 +43,25 @@ class VinylControlProcessor : public QThread, public AudioDestination {
 
     bool deckConfigured(int index) const;
 
-    FIFO<VinylSignalQualityReport>* getSignalQualityFifo() {
-        return &m_signalQualityFifo;
+    bool perInputThreads() const {
+        return m_bPerInputThreads;
     }
 
+    // Called from the main thread. Reads the next pending signal quality
+    // report of any input. Returns false if there is none.
+    bool readSignalQualityReport(VinylSignalQualityReport* pReport);
+
+    // The number of frames of the given input that have been analyzed since
+    // the input was configured. The pitch and position that were decoded from
+    // these frames have been handed to the engine controls of the deck.
+    SINT analyzedFrames(int index) const {
+        return m_analyzedFrames[index].load(std::memory_order_acquire);
+    }
+
+    // Called from the thread that analyzes the given input.
+    void processInput(int index, CSAMPLE* pWorkBuffer);
+    void reloadInputConfig(int index);
+
   public slots:
     virtual void onInputConfigured(const AudioInput& input);
     virtual void onInputUnconfigured(const AudioInput& input);
@@ -62,8 +85,11 @@ class VinylControlProcessor : public QThread, public AudioDestination {
 
   private:
     void reloadConfig();
+    void startInputWorker(int index);
+    void stopInputWorker(int index);
 
     UserSettingsPointer m_pConfig;
+    const bool m_bPerInputThreads;
     ControlPushButton* m_pToggle;
     // A pre-allocated array of FIFOs for writing samples from the engine
     // callback to the processor thread. There is a maximum of
@@ -74,7 +100,13 @@ class VinylControlProcessor : public QThread, public AudioDestination {
     QMutex m_waitForSampleMutex;
     QT_RECURSIVE_MUTEX m_processorsLock;
     QVector<VinylControl*> m_processors;
-    FIFO<VinylSignalQualityReport> m_signalQualityFifo;
+    // Only used with per-input threads. Pre-allocated so that the engine
+    // callback can wake them up while inputs are (un)configured.
+    VinylControlInputWorker* m_inputWorkers[kMaximumVinylControlInputs];
+    // One FIFO per input, because each of them has a single writer only if
+    // the inputs are analyzed on different threads.
+    FIFO<VinylSignalQualityReport>* m_signalQualityFifos[kMaximumVinylControlInputs];
+    std::atomic<SINT> m_analyzedFrames[kMaximumVinylControlInputs];
     volatile bool m_bReportSignalQuality;
     volatile bool m_bQuit;
     volatile bool m_bReloadConfig;
@@ -21,10 +21,6 @@
    4) Extrapolate small dropouts and keep track of "dynamics"
  ********************/
 
-namespace {
-constexpr int kChannels = 2;
-} // namespace
-
 // Sample threshold below which we consider there to be no signal.
 constexpr double kMinSignal = 75.0 / SAMPLE_MAXIMUM;
 
@@ -34,8 +30,6 @@ QMutex VinylControlXwax::s_xwaxLUTMutex;
 VinylControlXwax::VinylControlXwax(UserSettingsPointer pConfig, const QString& group)
         : VinylControl(pConfig, group),
           m_dVinylPositionOld(0.0),
-          m_pWorkBuffer(MAX_BUFFER_LEN),
-          m_workBufferSize(MAX_BUFFER_LEN),
           m_iQualityRingIndex(0),
           m_iQualityRingFilled(0),
           m_iQualityLastPosition(-1),
@@ -210,29 +204,8 @@ void VinylControlXwax::analyzeSamples(CSAMPLE* pSamples, size_t nFrames) {
         gain = 1.0f;
     }
 
-    size_t samplesSize = nFrames * kChannels;
-
-    if (samplesSize > m_workBufferSize) {
-        m_pWorkBuffer.resize(samplesSize);
-        m_workBufferSize = samplesSize;
-    }
-
-    // Convert CSAMPLE samples to shorts, preventing overflow.
-    for (int i = 0; i < static_cast<int>(samplesSize); ++i) {
-        CSAMPLE sample = pSamples[i] * gain * SAMPLE_MAXIMUM;
-
-        if (sample > SAMPLE_MAXIMUM) {
-            m_pWorkBuffer[i] = SAMPLE_MAXIMUM;
-        } else if (sample < SAMPLE_MINIMUM) {
-            m_pWorkBuffer[i] = SAMPLE_MINIMUM;
-        } else {
-            m_pWorkBuffer[i] = static_cast<short>(sample);
-        }
-    }
-
-    // Submit the samples to the xwax timecode processor. The size argument is
-    // in stereo frames.
-    timecoder_submit(&timecoder, m_pWorkBuffer.data(), nFrames);
+    // Submit the samples to the xwax timecode processor.
+    m_timecodeFrontEnd.submit(&timecoder, pSamples, static_cast<SINT>(nFrames), gain);
 
     bool bHaveSignal = fabs(pSamples[0]) + fabs(pSamples[1]) > kMinSignal;
     //qDebug() << "signal?" << bHaveSignal;
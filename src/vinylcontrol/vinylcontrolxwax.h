@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "util/types.h"
+#include "vinylcontrol/timecodefrontend.h"
 #include "vinylcontrol/vinylcontrol.h"
 
 #ifdef _MSC_VER
@@ -58,9 +59,8 @@ class VinylControlXwax : public VinylControl {
     // The position read last time it was polled.
     double m_dVinylPositionOld;
 
-    // Scratch buffer for CSAMPLE -> short conversions.
-    std::vector<short> m_pWorkBuffer;
-    size_t m_workBufferSize;
+    // Converts the input samples for the timecoder.
+    TimecodeFrontEnd m_timecodeFrontEnd;
 
     // Signal quality ring buffer.
     // TODO(XXX): Replace with CircularBuffer instead of handling the ring logic
@@ -11,6 +11,11 @@ class allshader::RGBAData {
     QVector<QVector4D> mData;
 
   public:
+    void addForTriangle(float r, float g, float b, float a) {
+        mData.push_back({r, g, b, a});
+        mData.push_back({r, g, b, a});
+        mData.push_back({r, g, b, a});
+    }
     void addForRectangle(float r, float g, float b, float a) {
         mData.push_back({r, g, b, a});
         mData.push_back({r, g, b, a});
@@ -56,7 +56,7 @@ bool WaveformRenderBeat::preprocessInner() {
     }
 
     int alpha = m_waveformRenderer->getBeatGridAlpha();
-    if (alpha == 0) {
+    if (alpha == 0 || m_waveformRenderer->isReducedDetail()) {
         return false;
     }
 
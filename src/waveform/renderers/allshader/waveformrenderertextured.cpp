@@ -325,6 +325,14 @@ void WaveformRendererTextured::paintGL() {
         m_textureRenderedWaveformCompletion = currentCompletion;
     }
 
+    // The framebuffer is rendered with its own viewport. Restore the one of
+    // the widget afterwards, which doesn't start at the origin when the
+    // widget is drawn into an allshader::WaveformSurface.
+    // The scissor rectangle of the surface would also clip the framebuffer.
+    GLint targetViewport[4];
+    glGetIntegerv(GL_VIEWPORT, targetViewport);
+    const GLboolean scissorTest = glIsEnabled(GL_SCISSOR_TEST);
+
     // Per-band gain from the EQ knobs.
     float lowGain(1.0), midGain(1.0), highGain(1.0), allGain(1.0);
     getGains(&allGain, true, &lowGain, &midGain, &highGain);
@@ -446,6 +454,7 @@ void WaveformRendererTextured::paintGL() {
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
         m_framebuffer->bind();
+        glDisable(GL_SCISSOR_TEST);
         glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
         glClear(GL_COLOR_BUFFER_BIT);
         // glCallList(m_unitQuadListId);
@@ -467,6 +476,9 @@ void WaveformRendererTextured::paintGL() {
         glEnd();
 
         m_framebuffer->release();
+        if (scissorTest) {
+            glEnable(GL_SCISSOR_TEST);
+        }
 
         m_frameShaderProgram->release();
 
@@ -493,15 +505,12 @@ void WaveformRendererTextured::paintGL() {
     // paint buffer into viewport
     {
         // OpenGL pixels are real screen pixels, not device independent
-        // pixels like QPainter provides. We scale the viewport by the
-        // devicePixelRatio to render the texture to the surface.
-        const float devicePixelRatio = m_waveformRenderer->getDevicePixelRatio();
-        glViewport(0,
-                0,
-                static_cast<GLsizei>(
-                        devicePixelRatio * m_waveformRenderer->getWidth()),
-                static_cast<GLsizei>(
-                        devicePixelRatio * m_waveformRenderer->getHeight()));
+        // pixels like QPainter provides. The viewport of the widget is
+        // already scaled by the devicePixelRatio.
+        glViewport(targetViewport[0],
+                targetViewport[1],
+                targetViewport[2],
+                targetViewport[3]);
         glBindTexture(GL_TEXTURE_2D, m_framebuffer->texture());
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
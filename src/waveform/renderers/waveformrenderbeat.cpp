@@ -35,7 +35,7 @@ void WaveformRenderBeat::draw(QPainter* painter, QPaintEvent* /*event*/) {
     }
 
     int alpha = m_waveformRenderer->getBeatGridAlpha();
-    if (alpha == 0) {
+    if (alpha == 0 || m_waveformRenderer->isReducedDetail()) {
         return;
     }
 #ifdef MIXXX_USE_QOPENGL
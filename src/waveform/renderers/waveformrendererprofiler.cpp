@@ -0,0 +1,201 @@
+#include "waveform/renderers/waveformrendererprofiler.h"
+
+#include <cstdlib>
+#include <typeinfo>
+
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#endif
+
+#ifdef WAVEFORM_GPU_TIMING
+#include <QOpenGLContext>
+#include <QOpenGLTimeMonitor>
+#endif
+
+#include "util/logger.h"
+#include "util/stat.h"
+#include "util/timer.h"
+#include "waveform/renderers/waveformrendererabstract.h"
+
+namespace {
+
+const mixxx::Logger kLogger("WaveformRendererProfiler");
+
+QString rendererName(const WaveformRendererAbstract& renderer) {
+    const char* pName = typeid(renderer).name();
+#if __has_include(<cxxabi.h>)
+    int status = 0;
+    char* pDemangled = abi::__cxa_demangle(pName, nullptr, nullptr, &status);
+    if (status == 0 && pDemangled) {
+        const QString name = QString::fromLatin1(pDemangled);
+        std::free(pDemangled);
+        return name;
+    }
+#endif
+    // MSVC already returns "class allshader::WaveformRenderBeat"
+    QString name = QString::fromLatin1(pName);
+    if (name.startsWith(QStringLiteral("class "))) {
+        name.remove(0, 6);
+    }
+    return name;
+}
+
+void reportDuration(const QString& key, qint64 nanos) {
+    Stat::track(key,
+            Stat::DURATION_NANOSEC,
+            Stat::experimentFlags(kDefaultComputeFlags),
+            static_cast<double>(nanos));
+}
+
+} // namespace
+
+WaveformRendererProfiler::WaveformRendererProfiler(const QString& group,
+        const QList<WaveformRendererAbstract*>& renderers)
+        : m_pTimedRenderer(nullptr)
+#ifdef WAVEFORM_GPU_TIMING
+          ,
+          m_bGpuTimerFailed(false),
+          m_bRecordGpu(false)
+#endif
+{
+    m_stats.reserve(renderers.size());
+    for (int i = 0; i < renderers.size(); ++i) {
+        // The index tells apart the renderers for the slip cursor
+        const QString key = QStringLiteral("WaveformRenderer %1 %2 %3")
+                                    .arg(group,
+                                            QString::number(i).rightJustified(2, '0'),
+                                            rendererName(*renderers[i]));
+        m_stats.push_back(RendererStats{renderers[i],
+                key + QStringLiteral(" CPU"),
+                key + QStringLiteral(" GPU"),
+                mixxx::Duration(),
+                false});
+    }
+}
+
+WaveformRendererProfiler::~WaveformRendererProfiler() = default;
+
+WaveformRendererProfiler::RendererStats* WaveformRendererProfiler::stats(
+        const WaveformRendererAbstract* pRenderer) {
+    for (auto& stats : m_stats) {
+        if (stats.pRenderer == pRenderer) {
+            return &stats;
+        }
+    }
+    return nullptr;
+}
+
+void WaveformRendererProfiler::beginFrame(bool useGpuTimer) {
+#ifdef WAVEFORM_GPU_TIMING
+    m_bRecordGpu = false;
+    if (!useGpuTimer || m_bGpuTimerFailed) {
+        return;
+    }
+    if (!m_pTimeMonitor) {
+        QOpenGLContext* pContext = QOpenGLContext::currentContext();
+        if (!pContext || pContext->isOpenGLES() ||
+                (pContext->format().version() < qMakePair(3, 3) &&
+                        !pContext->hasExtension(QByteArrayLiteral("GL_ARB_timer_query")))) {
+            kLogger.info() << "GPU timing of the waveform renderers is not supported";
+            m_bGpuTimerFailed = true;
+            return;
+        }
+        m_pTimeMonitor = std::make_unique<QOpenGLTimeMonitor>();
+        // A pair of samples around the render of each renderer
+        m_pTimeMonitor->setSampleCount(static_cast<int>(m_stats.size()) * 2);
+        if (!m_pTimeMonitor->create()) {
+            kLogger.warning() << "Failed to create the timer queries";
+            m_pTimeMonitor.reset();
+            m_bGpuTimerFailed = true;
+            return;
+        }
+    }
+    if (!m_gpuRendererIndices.empty()) {
+        if (!m_pTimeMonitor->isResultAvailable()) {
+            // Skip this frame rather than wait for the GPU
+            return;
+        }
+        collectGpuResults();
+    }
+    m_bRecordGpu = true;
+#else
+    Q_UNUSED(useGpuTimer);
+#endif
+}
+
+void WaveformRendererProfiler::endFrame() {
+    for (auto& stats : m_stats) {
+        if (stats.active) {
+            reportDuration(stats.cpuKey, stats.cpuTime.toIntegerNanos());
+            stats.cpuTime = mixxx::Duration();
+            stats.active = false;
+        }
+    }
+#ifdef WAVEFORM_GPU_TIMING
+    m_bRecordGpu = false;
+#endif
+}
+
+void WaveformRendererProfiler::beginRenderer(
+        const WaveformRendererAbstract* pRenderer, bool onGpu) {
+    if (m_pTimedRenderer) {
+        return;
+    }
+    m_pTimedRenderer = pRenderer;
+#ifdef WAVEFORM_GPU_TIMING
+    if (onGpu && m_bRecordGpu) {
+        const RendererStats* pStats = stats(pRenderer);
+        if (pStats && m_pTimeMonitor->recordSample() >= 0) {
+            m_gpuRendererIndices.push_back(static_cast<int>(pStats - m_stats.data()));
+        } else {
+            m_bRecordGpu = false;
+        }
+    }
+#else
+    Q_UNUSED(onGpu);
+#endif
+    m_timer.start();
+}
+
+void WaveformRendererProfiler::endRenderer(
+        const WaveformRendererAbstract* pRenderer, bool onGpu) {
+    if (m_pTimedRenderer != pRenderer) {
+        return;
+    }
+    m_pTimedRenderer = nullptr;
+    const mixxx::Duration elapsed = m_timer.elapsed();
+#ifdef WAVEFORM_GPU_TIMING
+    if (onGpu && m_bRecordGpu) {
+        if (m_pTimeMonitor->recordSample() < 0) {
+            // The pair is incomplete
+            m_gpuRendererIndices.pop_back();
+            m_bRecordGpu = false;
+        }
+    }
+#else
+    Q_UNUSED(onGpu);
+#endif
+    RendererStats* pStats = stats(pRenderer);
+    if (pStats) {
+        pStats->cpuTime += elapsed;
+        pStats->active = true;
+    }
+}
+
+#ifdef WAVEFORM_GPU_TIMING
+void WaveformRendererProfiler::collectGpuResults() {
+    const QList<GLuint64> intervals = m_pTimeMonitor->waitForIntervals();
+    // The intervals alternate between the render of a renderer and the
+    // time in between two renderers
+    for (std::size_t i = 0; i < m_gpuRendererIndices.size(); ++i) {
+        const auto intervalIndex = static_cast<qsizetype>(i * 2);
+        if (intervalIndex >= intervals.size()) {
+            break;
+        }
+        reportDuration(m_stats[m_gpuRendererIndices[i]].gpuKey,
+                static_cast<qint64>(intervals[intervalIndex]));
+    }
+    m_gpuRendererIndices.clear();
+    m_pTimeMonitor->reset();
+}
+#endif
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QtGui/qtgui-config.h> // for QT_OPENGL_ES_2
+#include <memory>
+#include <vector>
+
+#include "util/class.h"
+#include "util/performancetimer.h"
+
+#if defined(MIXXX_USE_QOPENGL) && !defined(QT_OPENGL_ES_2)
+#define WAVEFORM_GPU_TIMING
+class QOpenGLTimeMonitor;
+#endif
+
+class WaveformRendererAbstract;
+
+/// WaveformRendererProfiler measures how long each renderer in the stack of a
+/// WaveformWidgetRenderer takes per frame, and reports it to the StatsManager,
+/// where it shows up in the developer tools. It is only created in
+/// `--developer` mode.
+///
+/// The CPU time covers all the calls of a renderer within a frame. The GPU
+/// time is measured with timestamp queries around the render calls, which are
+/// only available with desktop OpenGL 3.3 or GL_ARB_timer_query. The results
+/// of the queries are collected one or more frames later, so reading them
+/// never stalls the pipeline.
+class WaveformRendererProfiler {
+  public:
+    WaveformRendererProfiler(const QString& group,
+            const QList<WaveformRendererAbstract*>& renderers);
+    ~WaveformRendererProfiler();
+
+    /// Must be called with the OpenGL context of the widget current, if
+    /// useGpuTimer is true.
+    void beginFrame(bool useGpuTimer);
+    void endFrame();
+
+    void beginRenderer(const WaveformRendererAbstract* pRenderer, bool onGpu);
+    void endRenderer(const WaveformRendererAbstract* pRenderer, bool onGpu);
+
+  private:
+    struct RendererStats {
+        const WaveformRendererAbstract* pRenderer;
+        QString cpuKey;
+        QString gpuKey;
+        mixxx::Duration cpuTime;
+        bool active;
+    };
+
+    RendererStats* stats(const WaveformRendererAbstract* pRenderer);
+
+    std::vector<RendererStats> m_stats;
+    PerformanceTimer m_timer;
+    // The renderer that is currently timed, to not count it twice if the
+    // calls happen to nest
+    const WaveformRendererAbstract* m_pTimedRenderer;
+
+#ifdef WAVEFORM_GPU_TIMING
+    void collectGpuResults();
+
+    std::unique_ptr<QOpenGLTimeMonitor> m_pTimeMonitor;
+    // The renderers of the samples that are recorded or pending in
+    // m_pTimeMonitor, one for each pair of samples
+    std::vector<int> m_gpuRendererIndices;
+    bool m_bGpuTimerFailed;
+    bool m_bRecordGpu;
+#endif
+
+    DISALLOW_COPY_AND_ASSIGN(WaveformRendererProfiler);
+};
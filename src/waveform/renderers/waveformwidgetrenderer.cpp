@@ -5,8 +5,10 @@
 
 #include "control/controlproxy.h"
 #include "track/track.h"
+#include "util/cmdlineargs.h"
 #include "util/math.h"
 #include "waveform/renderers/waveformrendererabstract.h"
+#include "waveform/renderers/waveformrendererprofiler.h"
 #include "waveform/visualplayposition.h"
 #include "waveform/waveform.h"
 
@@ -46,7 +48,9 @@ WaveformWidgetRenderer::WaveformWidgetRenderer(const QString& group)
           m_trackSamples(0),
           m_scaleFactor(1.0),
           m_playMarkerPosition(s_defaultPlayMarkerPosition),
-          m_passthroughEnabled(false) {
+          m_passthroughEnabled(false),
+          m_bReducedDetail(false),
+          m_bPositionMoving(false) {
     //qDebug() << "WaveformWidgetRenderer";
     for (int type = ::WaveformRendererAbstract::Play;
             type <= ::WaveformRendererAbstract::Slip;
@@ -75,6 +79,8 @@ WaveformWidgetRenderer::WaveformWidgetRenderer(const QString& group)
 WaveformWidgetRenderer::~WaveformWidgetRenderer() {
     //qDebug() << "~WaveformWidgetRenderer";
 
+    m_pProfiler.reset();
+
     for (int i = 0; i < m_rendererStack.size(); ++i) {
         delete m_rendererStack[i];
     }
@@ -105,10 +111,15 @@ bool WaveformWidgetRenderer::init() {
             return false;
         }
     }
+
+    if (CmdlineArgs::Instance().getDeveloper()) {
+        m_pProfiler = std::make_unique<WaveformRendererProfiler>(m_group, m_rendererStack);
+    }
     return true;
 }
 
 void WaveformWidgetRenderer::onPreRender(VSyncThread* vsyncThread) {
+    m_bPositionMoving = false;
     if (m_passthroughEnabled) {
         // disables renderers in draw()
         for (int type = ::WaveformRendererAbstract::Play;
@@ -172,9 +183,11 @@ void WaveformWidgetRenderer::onPreRender(VSyncThread* vsyncThread) {
         for (int type = ::WaveformRendererAbstract::Play;
                 type <= ::WaveformRendererAbstract::Slip;
                 type++) {
+            const double previousPos = m_pos[type];
             // Avoid pixel jitter in play position by rounding to the nearest track
             // pixel.
             m_pos[type] = round(truePos[type] * m_trackPixelCount) / m_trackPixelCount;
+            m_bPositionMoving = m_bPositionMoving || m_pos[type] != previousPos;
             m_posVSample[type] = static_cast<int>(m_pos[type] * m_totalVSamples);
             m_truePosSample[type] = truePos[type] * static_cast<double>(m_trackSamples);
             m_firstDisplayedPosition[type] = m_pos[type] - displayedLengthLeft;
@@ -217,6 +230,17 @@ void WaveformWidgetRenderer::draw(QPainter* painter, QPaintEvent* event) {
             drawPassthroughLabel(painter);
         }
         return;
+    } else if (m_pProfiler) {
+        m_pProfiler->beginFrame(false);
+        for (int i = 0; i < stackSize; i++) {
+            WaveformRendererAbstract* pRenderer = m_rendererStack.at(i);
+            m_pProfiler->beginRenderer(pRenderer, false);
+            pRenderer->draw(painter, event);
+            m_pProfiler->endRenderer(pRenderer, false);
+        }
+        m_pProfiler->endFrame();
+
+        drawPlayPosmarker(painter);
     } else {
         for (int i = 0; i < stackSize; i++) {
             //qDebug() << i << " a  " << timer.restart().formatNanosWithUnit();
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory>
+
 #include "track/track_decl.h"
 #include "util/class.h"
 #include "waveform/renderers/waveformmark.h"
@@ -14,6 +16,7 @@ class VisualPlayPosition;
 class VSyncThread;
 class QPainter;
 class WaveformRendererAbstract;
+class WaveformRendererProfiler;
 
 class WaveformWidgetRenderer {
   public:
@@ -142,6 +145,22 @@ class WaveformWidgetRenderer {
         return m_alphaBeatGrid;
     }
 
+    /// Leaves out the overlays that are the least important when the
+    /// waveform is not in focus, currently the beat grid. Used by
+    /// WaveformWidgetFactory to stay within the frame budget.
+    void setReducedDetail(bool reducedDetail) {
+        m_bReducedDetail = reducedDetail;
+    }
+    bool isReducedDetail() const {
+        return m_bReducedDetail;
+    }
+
+    /// Returns true if the play or slip position has changed in the last
+    /// onPreRender(), i.e. the deck is playing or is scratched.
+    bool isPositionMoving() const {
+        return m_bPositionMoving;
+    }
+
     virtual void resizeRenderer(int width, int height, float devicePixelRatio);
 
     int getHeight() const {
@@ -239,6 +258,9 @@ class WaveformWidgetRenderer {
     double m_scaleFactor;
     double m_playMarkerPosition;   // 0.0 - left, 0.5 - center, 1.0 - right
 
+    // Only created in developer mode
+    std::unique_ptr<WaveformRendererProfiler> m_pProfiler;
+
 #ifdef WAVEFORMWIDGETRENDERER_DEBUG
     PerformanceTimer* m_timer;
     int m_lastFrameTime;
@@ -262,6 +284,8 @@ private:
     void drawPassthroughLabel(QPainter* painter);
 
     bool m_passthroughEnabled;
+    bool m_bReducedDetail;
+    bool m_bPositionMoving;
     double m_pos[2];
     double m_truePosSample[2];
 };
@@ -25,6 +25,7 @@
 #include "waveform/vsyncthread.h"
 #ifdef MIXXX_USE_QOPENGL
 #include "waveform/renderers/allshader/waveformrenderersignalbase.h"
+#include "waveform/widgets/allshader/waveformsurface.h"
 #include "waveform/widgets/allshader/waveformwidget.h"
 #include "waveform/widgets/glvsynctestwidget.h"
 #endif
@@ -38,14 +39,35 @@
 #include "widget/wwaveformviewer.h"
 
 namespace {
-// Returns true if the given waveform should be rendered.
-bool shouldRenderWaveform(WaveformWidgetAbstract* pWaveformWidget) {
+
+// Rendering the waveforms may take this fraction of the frame time before
+// the adaptive quality kicks in
+constexpr double kFrameBudgetFraction = 0.5;
+// Below this fraction of the frame time the quality is raised again
+constexpr double kFrameBudgetRaiseFraction = 0.25;
+// The waveforms of decks that don't move are rendered every nth frame,
+// indexed by the adaptive level
+constexpr unsigned int kIdleFrameDivider[] = {1, 2, 4};
+constexpr int kMaxAdaptiveLevel = 2;
+// From this level on the idle waveforms are drawn without beat grid
+constexpr int kReducedDetailAdaptiveLevel = 2;
+
+const QString kAdaptiveLevelStatKey = QStringLiteral("WaveformWidgetFactory adaptive level");
+
+// Returns true if the given waveform should be rendered. pSurface is the
+// window the waveform is rendered into, if it has none of its own.
+bool shouldRenderWaveform(WaveformWidgetAbstract* pWaveformWidget,
+        WGLWidget* pSurface = nullptr) {
     if (pWaveformWidget == nullptr ||
         pWaveformWidget->getWidth() == 0 ||
         pWaveformWidget->getHeight() == 0) {
         return false;
     }
 
+    if (pSurface != nullptr) {
+        return pWaveformWidget->getWidget()->isVisible() && pSurface->shouldRender();
+    }
+
     auto* glw = pWaveformWidget->getGLWidget();
     if (glw == nullptr) {
         // Not a WGLWidget. We can simply use QWidget::isVisible.
@@ -70,7 +92,9 @@ WaveformWidgetAbstractHandle::WaveformWidgetAbstractHandle()
 WaveformWidgetHolder::WaveformWidgetHolder()
         : m_waveformWidget(nullptr),
           m_waveformViewer(nullptr),
-          m_skinContextCache(UserSettingsPointer(), QString()) {
+          m_skinContextCache(UserSettingsPointer(), QString()),
+          m_bRendered(false),
+          m_bHosted(false) {
 }
 
 WaveformWidgetHolder::WaveformWidgetHolder(WaveformWidgetAbstract* waveformWidget,
@@ -80,7 +104,9 @@ WaveformWidgetHolder::WaveformWidgetHolder(WaveformWidgetAbstract* waveformWidge
     : m_waveformWidget(waveformWidget),
       m_waveformViewer(waveformViewer),
       m_skinNodeCache(node.cloneNode()),
-      m_skinContextCache(&parentContext) {
+      m_skinContextCache(&parentContext),
+      m_bRendered(false),
+      m_bHosted(false) {
 }
 
 ///////////////////////////////////////////
@@ -97,6 +123,7 @@ WaveformWidgetFactory::WaveformWidgetFactory()
           m_endOfTrackWarningTime(30),
           m_defaultZoom(WaveformWidgetRenderer::s_waveformDefaultZoom),
           m_zoomSync(true),
+          m_adaptiveQuality(false),
           m_overviewNormalized(false),
           m_untilMarkShowBeats(false),
           m_untilMarkShowTime(false),
@@ -110,6 +137,12 @@ WaveformWidgetFactory::WaveformWidgetFactory()
           m_vsyncThread(nullptr),
           m_pGuiTick(nullptr),
           m_pVisualsManager(nullptr),
+          m_averageRenderMillis(0.0),
+          m_adaptiveLevel(0),
+          m_framesSinceLevelChange(0),
+          m_adaptiveFrameCounter(0),
+          m_bSharedSurfaceFailed(false),
+          m_bSurfaceRendered(false),
           m_frameCnt(0),
           m_actualFrameRate(0),
           m_playMarkerPosition(WaveformWidgetRenderer::s_defaultPlayMarkerPosition) {
@@ -361,6 +394,9 @@ bool WaveformWidgetFactory::setConfig(UserSettingsPointer config) {
     bool zoomSync = m_config->getValue(ConfigKey("[Waveform]", "ZoomSynchronization"), m_zoomSync);
     setZoomSync(zoomSync);
 
+    setAdaptiveQuality(m_config->getValue(
+            ConfigKey("[Waveform]", "AdaptiveQuality"), m_adaptiveQuality));
+
     int beatGridAlpha = m_config->getValue(ConfigKey("[Waveform]", "beatGridAlpha"), m_beatGridAlpha);
     setDisplayBeatGridAlpha(beatGridAlpha);
 
@@ -462,6 +498,8 @@ void WaveformWidgetFactory::addVuMeter(WVuMeterBase* pVuMeter) {
 }
 
 void WaveformWidgetFactory::slotSkinLoaded() {
+    // Give the new skin a chance
+    m_bSharedSurfaceFailed = false;
     setWidgetTypeFromConfig();
 #if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0) && defined __WINDOWS__
     // This regenerates the waveforms twice because of a bug found on Windows
@@ -604,6 +642,13 @@ bool WaveformWidgetFactory::setWidgetTypeFromHandle(int handleIndex, bool force)
 
     m_skipRender = true;
 
+    // The widgets of the previous surface are deleted below, with its
+    // context current
+    QPointer<allshader::WaveformSurface> pSurface = prepareSharedSurface();
+#ifdef MIXXX_USE_QOPENGL
+    QList<allshader::WaveformWidget*> hostedWidgets;
+#endif
+
     //re-create/setup all waveform widgets
     for (auto& holder : m_waveformWidgetHolders) {
         WaveformWidgetAbstract* previousWidget = holder.m_waveformWidget;
@@ -616,6 +661,15 @@ bool WaveformWidgetFactory::setWidgetTypeFromHandle(int handleIndex, bool force)
         WWaveformViewer* viewer = holder.m_waveformViewer;
         WaveformWidgetAbstract* widget = createWaveformWidget(m_type, holder.m_waveformViewer);
         holder.m_waveformWidget = widget;
+        holder.m_bHosted = false;
+#ifdef MIXXX_USE_QOPENGL
+        auto* pAllshaderWidget = qobject_cast<allshader::WaveformWidget*>(widget->getWidget());
+        if (pSurface && pAllshaderWidget) {
+            pAllshaderWidget->setSurface(pSurface);
+            holder.m_bHosted = true;
+            hostedWidgets.append(pAllshaderWidget);
+        }
+#endif
         viewer->setWaveformWidget(widget);
         viewer->setup(holder.m_skinNodeCache, holder.m_skinContextCache);
         viewer->setZoom(previousZoom);
@@ -630,10 +684,94 @@ bool WaveformWidgetFactory::setWidgetTypeFromHandle(int handleIndex, bool force)
         viewer->update();
     }
 
+#ifdef MIXXX_USE_QOPENGL
+    if (m_pSurface != pSurface) {
+        delete m_pSurface;
+        m_pSurface = pSurface;
+    }
+    if (m_pSurface) {
+        if (hostedWidgets.isEmpty()) {
+            // E.g. the empty waveform
+            delete m_pSurface;
+        } else {
+            m_pSurface->setWaveformWidgets(hostedWidgets);
+        }
+    }
+#endif
+
     m_skipRender = false;
     return true;
 }
 
+QPointer<allshader::WaveformSurface> WaveformWidgetFactory::prepareSharedSurface() {
+#ifdef MIXXX_USE_QOPENGL
+    const WaveformWidgetBackend backend = m_config->getValue(
+            ConfigKey("[Waveform]", "use_hardware_acceleration"),
+            preferredBackend());
+    if (!CmdlineArgs::Instance().getUseSharedWaveformSurface() ||
+            m_bSharedSurfaceFailed ||
+            backend != WaveformWidgetBackend::AllShader ||
+            m_waveformWidgetHolders.size() < 2) {
+        return nullptr;
+    }
+
+    // The surface covers the waveforms from their closest common ancestor
+    QWidget* pAncestor = m_waveformWidgetHolders.front().m_waveformViewer->parentWidget();
+    for (const auto& holder : std::as_const(m_waveformWidgetHolders)) {
+        while (pAncestor && !pAncestor->isAncestorOf(holder.m_waveformViewer)) {
+            pAncestor = pAncestor->parentWidget();
+        }
+    }
+    if (!pAncestor) {
+        return nullptr;
+    }
+    if (m_pSurface && m_pSurface->parentWidget() == pAncestor) {
+        return m_pSurface;
+    }
+
+    auto* pSurface = new allshader::WaveformSurface(pAncestor);
+    // Queued, because the widgets are recreated from the slot
+    connect(pSurface,
+            &allshader::WaveformSurface::layoutUnsupported,
+            this,
+            &WaveformWidgetFactory::slotSharedSurfaceLayoutUnsupported,
+            Qt::QueuedConnection);
+    return pSurface;
+#else
+    return {};
+#endif
+}
+
+WGLWidget* WaveformWidgetFactory::hostingSurface(const WaveformWidgetHolder& holder) const {
+#ifdef MIXXX_USE_QOPENGL
+    if (holder.m_bHosted) {
+        return m_pSurface;
+    }
+#else
+    Q_UNUSED(holder);
+#endif
+    return nullptr;
+}
+
+QString WaveformWidgetFactory::sharedSurfaceStatSuffix() const {
+#ifdef MIXXX_USE_QOPENGL
+    if (m_pSurface) {
+        return QStringLiteral(" on a shared surface");
+    }
+#endif
+    return QString();
+}
+
+void WaveformWidgetFactory::slotSharedSurfaceLayoutUnsupported() {
+    if (m_bSharedSurfaceFailed) {
+        return;
+    }
+    qWarning() << "WaveformWidgetFactory: The skin doesn't allow to render "
+                  "the waveforms on a shared surface, using a window per deck";
+    m_bSharedSurfaceFailed = true;
+    setWidgetTypeFromHandle(getHandleIndex(), true);
+}
+
 void WaveformWidgetFactory::setDefaultZoom(double zoom) {
     m_defaultZoom = math_clamp(zoom, WaveformWidgetRenderer::s_waveformMinZoom,
                                WaveformWidgetRenderer::s_waveformMaxZoom);
@@ -662,6 +800,16 @@ void WaveformWidgetFactory::setZoomSync(bool sync) {
     }
 }
 
+void WaveformWidgetFactory::setAdaptiveQuality(bool adaptive) {
+    m_adaptiveQuality = adaptive;
+    if (m_config) {
+        m_config->setValue(ConfigKey("[Waveform]", "AdaptiveQuality"), m_adaptiveQuality);
+    }
+    if (!m_adaptiveQuality) {
+        setAdaptiveLevel(0);
+    }
+}
+
 void WaveformWidgetFactory::setDisplayBeatGridAlpha(int alpha) {
     m_beatGridAlpha = alpha;
     if (m_waveformWidgetHolders.size() == 0) {
@@ -721,43 +869,79 @@ void WaveformWidgetFactory::notifyZoomChange(WWaveformViewer* viewer) {
 }
 
 void WaveformWidgetFactory::renderSelf() {
-    ScopedTimer t(QStringLiteral("WaveformWidgetFactory::render() %1waveforms"),
-            static_cast<int>(m_waveformWidgetHolders.size()));
+    // Separate keys to compare the frame times with and without the shared
+    // surface in the developer tools
+    ScopedTimer t(QStringLiteral("WaveformWidgetFactory::render() %1waveforms%2"),
+            static_cast<int>(m_waveformWidgetHolders.size()),
+            sharedSurfaceStatSuffix());
 
     if (!m_skipRender) {
         if (m_type) {   // no regular updates for an empty waveform
             // next rendered frame is displayed after next buffer swap and than after VSync
+            m_renderTimer.start();
+#ifdef MIXXX_USE_QOPENGL
+            if (m_pSurface) {
+                m_pSurface->updateLayout();
+            }
+#endif
             QVarLengthArray<bool, 10> shouldRenderWaveforms(
                     static_cast<int>(m_waveformWidgetHolders.size()));
             for (decltype(m_waveformWidgetHolders)::size_type i = 0;
                     i < m_waveformWidgetHolders.size();
                     i++) {
-                WaveformWidgetAbstract* pWaveformWidget = m_waveformWidgetHolders[i].m_waveformWidget;
+                const WaveformWidgetHolder& holder = m_waveformWidgetHolders[i];
+                WaveformWidgetAbstract* pWaveformWidget = holder.m_waveformWidget;
                 // Don't bother doing the pre-render work if we aren't going to
                 // render this widget.
-                bool shouldRender = shouldRenderWaveform(pWaveformWidget);
+                bool shouldRender = shouldRenderWaveform(pWaveformWidget, hostingSurface(holder));
                 shouldRenderWaveforms[static_cast<int>(i)] = shouldRender;
                 if (!shouldRender) {
                     continue;
                 }
                 // Calculate play position for the new Frame in following run
                 pWaveformWidget->preRender(m_vsyncThread);
+                if (m_adaptiveLevel > 0) {
+                    // Only now we know whether the deck is moving
+                    pWaveformWidget->setReducedDetail(
+                            m_adaptiveLevel >= kReducedDetailAdaptiveLevel &&
+                            !pWaveformWidget->isPositionMoving());
+                    // The shared surface is always drawn as a whole
+                    shouldRenderWaveforms[static_cast<int>(i)] =
+                            holder.m_bHosted || !shouldSkipAdaptively(i);
+                }
             }
             //qDebug() << "prerender" << m_vsyncThread->elapsed();
 
             // It may happen that there is an artificially delayed due to
             // anti tearing driver settings
             // all render commands are delayed until the swap from the previous run is executed
+            bool renderSurface = false;
             for (decltype(m_waveformWidgetHolders)::size_type i = 0;
                     i < m_waveformWidgetHolders.size();
                     i++) {
-                WaveformWidgetAbstract* pWaveformWidget = m_waveformWidgetHolders[i].m_waveformWidget;
+                WaveformWidgetHolder& holder = m_waveformWidgetHolders[i];
+                // The shared surface is swapped once for all
+                holder.m_bRendered = shouldRenderWaveforms[static_cast<int>(i)] &&
+                        !holder.m_bHosted;
                 if (!shouldRenderWaveforms[static_cast<int>(i)]) {
                     continue;
                 }
-                pWaveformWidget->render();
+                if (holder.m_bHosted) {
+                    renderSurface = true;
+                    continue;
+                }
+                holder.m_waveformWidget->render();
                 //qDebug() << "render" << i << m_vsyncThread->elapsed();
             }
+#ifdef MIXXX_USE_QOPENGL
+            if (renderSurface && m_pSurface) {
+                m_pSurface->render();
+            }
+            m_bSurfaceRendered = renderSurface;
+#endif
+            if (m_adaptiveQuality) {
+                updateAdaptiveLevel(m_renderTimer.elapsed());
+            }
         }
 
         // WSpinnys are also double-buffered WGLWidgets, like all the waveform
@@ -766,6 +950,8 @@ void WaveformWidgetFactory::renderSelf() {
         // Same for WVuMeterGL. Note that we are either using WVuMeter or WVuMeterGL.
         // If we are using WVuMeter, this does nothing
         emit renderVuMeters(m_vsyncThread);
+        // Same for the WOverviews that are rendered with shaders
+        emit renderOverviews();
 
         // Notify all other waveform-like widgets (e.g. WSpinny's) that they should
         // update.
@@ -789,14 +975,69 @@ void WaveformWidgetFactory::renderSelf() {
     //qDebug() << "refresh end" << m_vsyncThread->elapsed();
 }
 
+bool WaveformWidgetFactory::shouldSkipAdaptively(std::size_t holderIndex) const {
+    const WaveformWidgetAbstract* pWaveformWidget =
+            m_waveformWidgetHolders[holderIndex].m_waveformWidget;
+    if (pWaveformWidget->isPositionMoving()) {
+        return false;
+    }
+    // Spread the idle waveforms over the frames
+    return (m_adaptiveFrameCounter + holderIndex) % kIdleFrameDivider[m_adaptiveLevel] != 0;
+}
+
+void WaveformWidgetFactory::updateAdaptiveLevel(mixxx::Duration renderTime) {
+    ++m_adaptiveFrameCounter;
+    ++m_framesSinceLevelChange;
+    // Exponential moving average over roughly the last 10 frames
+    m_averageRenderMillis = 0.9 * m_averageRenderMillis + 0.1 * renderTime.toDoubleMillis();
+    Stat::track(kAdaptiveLevelStatKey,
+            Stat::UNSPECIFIED,
+            Stat::experimentFlags(Stat::COUNT | Stat::AVERAGE | Stat::MAX),
+            m_adaptiveLevel);
+
+    const double frameMillis = 1000.0 / math_max(m_frameRate, 1);
+    if (m_averageRenderMillis > frameMillis * kFrameBudgetFraction) {
+        // Give the average half a second to settle after a change
+        if (m_adaptiveLevel < kMaxAdaptiveLevel &&
+                m_framesSinceLevelChange > m_frameRate / 2) {
+            setAdaptiveLevel(m_adaptiveLevel + 1);
+        }
+    } else if (m_averageRenderMillis < frameMillis * kFrameBudgetRaiseFraction) {
+        // Raise the quality only after two seconds within the budget, to
+        // not toggle back and forth
+        if (m_adaptiveLevel > 0 && m_framesSinceLevelChange > m_frameRate * 2) {
+            setAdaptiveLevel(m_adaptiveLevel - 1);
+        }
+    } else {
+        // Stay at the current level
+        m_framesSinceLevelChange = math_min(m_framesSinceLevelChange, m_frameRate);
+    }
+}
+
+void WaveformWidgetFactory::setAdaptiveLevel(int level) {
+    if (level == m_adaptiveLevel) {
+        return;
+    }
+    qDebug() << "WaveformWidgetFactory: adaptive quality level" << level
+             << "at an average render time of" << m_averageRenderMillis << "ms";
+    m_adaptiveLevel = level;
+    m_framesSinceLevelChange = 0;
+    if (m_adaptiveLevel < kReducedDetailAdaptiveLevel) {
+        for (const auto& holder : std::as_const(m_waveformWidgetHolders)) {
+            holder.m_waveformWidget->setReducedDetail(false);
+        }
+    }
+}
+
 void WaveformWidgetFactory::render() {
     renderSelf();
     m_vsyncThread->vsyncSlotFinished();
 }
 
 void WaveformWidgetFactory::swapSelf() {
-    ScopedTimer t(QStringLiteral("WaveformWidgetFactory::swap() %1waveforms"),
-            static_cast<int>(m_waveformWidgetHolders.size()));
+    ScopedTimer t(QStringLiteral("WaveformWidgetFactory::swap() %1waveforms%2"),
+            static_cast<int>(m_waveformWidgetHolders.size()),
+            sharedSurfaceStatSuffix());
 
     // Do this in an extra slot to be sure to hit the desired interval
     if (!m_skipRender) {
@@ -810,7 +1051,7 @@ void WaveformWidgetFactory::swapSelf() {
                 // unexposed window. Prevents continuous log spew of
                 // "QOpenGLContext::swapBuffers() called with non-exposed
                 // window, behavior is undefined" on Qt5. See issue #9360.
-                if (!shouldRenderWaveform(pWaveformWidget)) {
+                if (!holder.m_bRendered || !shouldRenderWaveform(pWaveformWidget)) {
                     continue;
                 }
                 WGLWidget* glw = pWaveformWidget->getGLWidget();
@@ -821,6 +1062,12 @@ void WaveformWidgetFactory::swapSelf() {
                 }
                 //qDebug() << "swap x" << m_vsyncThread->elapsed();
             }
+#ifdef MIXXX_USE_QOPENGL
+            if (m_bSurfaceRendered && m_pSurface) {
+                m_pSurface->swap();
+            }
+            m_bSurfaceRendered = false;
+#endif
         }
         // WSpinnys are also double-buffered QGLWidgets, like all the waveform
         // renderers. Swap all the WSpinny widgets now.
@@ -828,6 +1075,8 @@ void WaveformWidgetFactory::swapSelf() {
         // Same for WVuMeterGL. Note that we are either using WVuMeter or WVuMeterGL
         // If we are using WVuMeter, this does nothing
         emit swapVuMeters();
+        // And the WOverviews that are rendered with shaders
+        emit swapOverviews();
     }
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QObject>
+#include <QPointer>
 #include <QSurfaceFormat>
 #include <QVector>
 #include <vector>
@@ -20,6 +21,10 @@ class WaveformWidgetAbstract;
 class VSyncThread;
 class GuiTick;
 class VisualsManager;
+class WGLWidget;
+namespace allshader {
+class WaveformSurface;
+} // namespace allshader
 
 class WaveformWidgetAbstractHandle {
   public:
@@ -98,6 +103,10 @@ class WaveformWidgetHolder {
     WWaveformViewer* m_waveformViewer;
     QDomNode m_skinNodeCache;
     SkinContext m_skinContextCache;
+    // Only swap what has been rendered
+    bool m_bRendered;
+    // Rendered by the shared surface
+    bool m_bHosted;
 
     friend class WaveformWidgetFactory;
 };
@@ -193,6 +202,14 @@ class WaveformWidgetFactory : public QObject, public Singleton<WaveformWidgetFac
     void setZoomSync(bool sync);
     int isZoomSync() const { return m_zoomSync;}
 
+    /// If enabled, the waveforms of the decks that don't move are rendered
+    /// at a lower frame rate and with fewer overlays when rendering the
+    /// waveforms takes more than half of the frame time.
+    void setAdaptiveQuality(bool adaptive);
+    bool isAdaptiveQuality() const {
+        return m_adaptiveQuality;
+    }
+
     void setDisplayBeatGridAlpha(int alpha);
     int getBeatGridAlpha() const { return m_beatGridAlpha; }
 
@@ -224,6 +241,8 @@ class WaveformWidgetFactory : public QObject, public Singleton<WaveformWidgetFac
     void swapSpinnies();
     void renderVuMeters(VSyncThread*);
     void swapVuMeters();
+    void renderOverviews();
+    void swapOverviews();
 
     void overviewNormalizeChanged();
     void overallVisualGainChanged();
@@ -242,10 +261,17 @@ class WaveformWidgetFactory : public QObject, public Singleton<WaveformWidgetFac
     void swap();
     void swapAndRender();
     void slotFrameSwapped();
+    void slotSharedSurfaceLayoutUnsupported();
 
   private:
     void renderSelf();
     void swapSelf();
+    bool shouldSkipAdaptively(std::size_t holderIndex) const;
+    void updateAdaptiveLevel(mixxx::Duration renderTime);
+    void setAdaptiveLevel(int level);
+    QPointer<allshader::WaveformSurface> prepareSharedSurface();
+    WGLWidget* hostingSurface(const WaveformWidgetHolder& holder) const;
+    QString sharedSurfaceStatSuffix() const;
 
     void addHandle(
             QHash<WaveformWidgetType::Type, QList<WaveformWidgetBackend>>&
@@ -279,6 +305,7 @@ class WaveformWidgetFactory : public QObject, public Singleton<WaveformWidgetFac
     int m_endOfTrackWarningTime;
     double m_defaultZoom;
     bool m_zoomSync;
+    bool m_adaptiveQuality;
     double m_visualGain[FilterCount];
     bool m_overviewNormalized;
 
@@ -306,6 +333,19 @@ class WaveformWidgetFactory : public QObject, public Singleton<WaveformWidgetFac
     WaveformWidgetAbstract* createSimpleWaveformWidget(WWaveformViewer* viewer);
     WaveformWidgetAbstract* createVSyncTestWaveformWidget(WWaveformViewer* viewer);
 
+    // Adaptive quality
+    PerformanceTimer m_renderTimer;
+    double m_averageRenderMillis;
+    int m_adaptiveLevel;
+    int m_framesSinceLevelChange;
+    unsigned int m_adaptiveFrameCounter;
+
+    // Renders the accelerated waveforms of all decks with
+    // --enable-shared-waveform-surface
+    QPointer<allshader::WaveformSurface> m_pSurface;
+    bool m_bSharedSurfaceFailed;
+    bool m_bSurfaceRendered;
+
     //Debug
     PerformanceTimer m_time;
     float m_frameCnt;
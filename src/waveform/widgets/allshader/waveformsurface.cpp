@@ -0,0 +1,376 @@
+#include "waveform/widgets/allshader/waveformsurface.h"
+
+#include <QApplication>
+#include <QDropEvent>
+#include <QMouseEvent>
+#include <QWheelEvent>
+#include <cmath>
+
+#include "moc_waveformsurface.cpp"
+#include "util/logger.h"
+#include "waveform/widgets/allshader/waveformwidget.h"
+#include "widget/wwaveformviewer.h"
+
+namespace {
+
+const mixxx::Logger kLogger("WaveformSurface");
+
+QPointF globalPosition(const QMouseEvent* pEvent) {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    return pEvent->globalPosition();
+#else
+    return pEvent->screenPos();
+#endif
+}
+
+QPointF scenePosition(const QMouseEvent* pEvent) {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    return pEvent->scenePosition();
+#else
+    return pEvent->windowPos();
+#endif
+}
+
+QPointF dropPosition(const QDropEvent* pEvent) {
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    return pEvent->position();
+#else
+    return pEvent->posF();
+#endif
+}
+
+GLint toDevicePixels(int pixels, qreal devicePixelRatio) {
+    return static_cast<GLint>(std::lround(pixels * devicePixelRatio));
+}
+
+} // namespace
+
+namespace allshader {
+
+WaveformSurface::WaveformSurface(QWidget* pParent)
+        : WGLWidget(pParent),
+          m_bLayoutChecked(false) {
+    setTrackDropTarget(this);
+    m_backgroundColor = pParent->palette().color(QPalette::Window);
+}
+
+WaveformSurface::~WaveformSurface() = default;
+
+void WaveformSurface::setWaveformWidgets(const QList<WaveformWidget*>& widgets) {
+    m_waveforms.clear();
+    m_waveforms.reserve(widgets.size());
+    for (WaveformWidget* pWidget : widgets) {
+        DEBUG_ASSERT(pWidget->surface() == this);
+        m_waveforms.push_back(HostedWaveform{pWidget, QRect(), QSize()});
+    }
+    m_bLayoutChecked = false;
+    m_pMouseGrabber = nullptr;
+    m_pHoveredViewer = nullptr;
+    m_pDropTarget = nullptr;
+}
+
+bool WaveformSurface::hosts(const WaveformWidget* pWidget) const {
+    for (const auto& waveform : m_waveforms) {
+        if (waveform.pWidget == pWidget) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void WaveformSurface::updateLayout() {
+    QWidget* pParent = parentWidget();
+    QRect bounds;
+    bool layoutChanged = false;
+    for (auto& waveform : m_waveforms) {
+        QRect rect;
+        if (waveform.pWidget && waveform.pWidget->isVisible()) {
+            rect = QRect(waveform.pWidget->mapTo(pParent, QPoint(0, 0)),
+                    waveform.pWidget->size());
+            bounds |= rect;
+        }
+        // Still in the coordinates of the parent
+        layoutChanged = layoutChanged || rect != waveform.rect.translated(pos());
+        waveform.rect = rect;
+    }
+    if (bounds.isEmpty()) {
+        hide();
+        return;
+    }
+    for (auto& waveform : m_waveforms) {
+        waveform.rect.translate(-bounds.topLeft());
+    }
+    if (bounds != geometry()) {
+        setGeometry(bounds);
+        layoutChanged = true;
+    }
+    if (isHidden()) {
+        show();
+        raise();
+    }
+
+    if (layoutChanged) {
+        m_bLayoutChecked = false;
+    }
+    if (!m_bLayoutChecked) {
+        m_bLayoutChecked = true;
+        if (coversOtherWidgets(pParent, bounds)) {
+            kLogger.warning() << "Other widgets are placed between the waveforms, "
+                                 "rendering each waveform separately";
+            emit layoutUnsupported();
+            return;
+        }
+    }
+
+    if (!getOpenGLWindow()) {
+        // Resized with a current context once we have a window
+        return;
+    }
+    for (auto& waveform : m_waveforms) {
+        if (!waveform.pWidget || waveform.rect.isEmpty() ||
+                waveform.rect.size() == waveform.rendererSize) {
+            continue;
+        }
+        makeCurrentIfNeeded();
+        // Like OpenGLWindow::resizeGL(), in device pixels
+        const qreal devicePixelRatio = waveform.pWidget->devicePixelRatioF();
+        waveform.pWidget->resizeGL(toDevicePixels(waveform.rect.width(), devicePixelRatio),
+                toDevicePixels(waveform.rect.height(), devicePixelRatio));
+        waveform.rendererSize = waveform.rect.size();
+    }
+}
+
+bool WaveformSurface::coversOtherWidgets(QWidget* pParent, const QRect& area) const {
+    const QList<QObject*>& children = pParent->children();
+    for (QObject* pChild : children) {
+        auto* pWidget = qobject_cast<QWidget*>(pChild);
+        if (!pWidget || pWidget == this || pWidget->isWindow() || !pWidget->isVisible()) {
+            continue;
+        }
+        const QRect childRect = pWidget->geometry();
+        if (!childRect.intersects(area)) {
+            continue;
+        }
+        if (containsViewer(pWidget)) {
+            if (qobject_cast<WWaveformViewer*>(pWidget) == nullptr &&
+                    coversOtherWidgets(pWidget, area.translated(-childRect.topLeft()))) {
+                return true;
+            }
+            continue;
+        }
+        return true;
+    }
+    return false;
+}
+
+bool WaveformSurface::containsViewer(const QWidget* pWidget) const {
+    for (const auto& waveform : m_waveforms) {
+        if (!waveform.pWidget) {
+            continue;
+        }
+        const QWidget* pViewer = waveform.pWidget->parentWidget();
+        if (pWidget == pViewer || pWidget->isAncestorOf(pViewer)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void WaveformSurface::render() {
+    if (!shouldRender()) {
+        return;
+    }
+    makeCurrentIfNeeded();
+    drawWaveforms();
+    doneCurrent();
+}
+
+void WaveformSurface::swap() {
+    if (!shouldRender()) {
+        return;
+    }
+    makeCurrentIfNeeded();
+    swapBuffers();
+    doneCurrent();
+}
+
+void WaveformSurface::initializeGL() {
+    initializeOpenGLFunctions();
+}
+
+void WaveformSurface::paintGL() {
+    drawWaveforms();
+}
+
+void WaveformSurface::paintEvent(QPaintEvent* event) {
+    Q_UNUSED(event);
+}
+
+void WaveformSurface::drawWaveforms() {
+    const qreal devicePixelRatio = devicePixelRatioF();
+
+    // Fill the gaps between the waveforms
+    glDisable(GL_SCISSOR_TEST);
+    glViewport(0,
+            0,
+            toDevicePixels(width(), devicePixelRatio),
+            toDevicePixels(height(), devicePixelRatio));
+    glClearColor(static_cast<float>(m_backgroundColor.redF()),
+            static_cast<float>(m_backgroundColor.greenF()),
+            static_cast<float>(m_backgroundColor.blueF()),
+            1.f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    // The scissor rectangle keeps glClear() of the background renderer
+    // within the waveform
+    glEnable(GL_SCISSOR_TEST);
+    for (const auto& waveform : m_waveforms) {
+        if (!waveform.pWidget || waveform.rect.isEmpty() ||
+                waveform.rect.size() != waveform.rendererSize) {
+            continue;
+        }
+        // OpenGL counts from the bottom
+        const GLint x = toDevicePixels(waveform.rect.x(), devicePixelRatio);
+        const GLint y = toDevicePixels(
+                height() - waveform.rect.y() - waveform.rect.height(), devicePixelRatio);
+        const GLint w = toDevicePixels(waveform.rect.width(), devicePixelRatio);
+        const GLint h = toDevicePixels(waveform.rect.height(), devicePixelRatio);
+        glViewport(x, y, w, h);
+        glScissor(x, y, w, h);
+        waveform.pWidget->paintGL();
+    }
+    glDisable(GL_SCISSOR_TEST);
+}
+
+WWaveformViewer* WaveformSurface::viewerAt(QPointF pos, QPointF* pViewerPos) const {
+    for (const auto& waveform : m_waveforms) {
+        if (!waveform.pWidget || !waveform.rect.contains(pos.toPoint())) {
+            continue;
+        }
+        auto* pViewer = qobject_cast<WWaveformViewer*>(waveform.pWidget->parentWidget());
+        if (pViewer && pViewerPos) {
+            *pViewerPos = mapToViewer(pViewer, pos);
+        }
+        return pViewer;
+    }
+    return nullptr;
+}
+
+QPointF WaveformSurface::mapToViewer(const WWaveformViewer* pViewer, QPointF pos) const {
+    return pos + QPointF(mapToGlobal(QPoint(0, 0)) - pViewer->mapToGlobal(QPoint(0, 0)));
+}
+
+bool WaveformSurface::event(QEvent* pEvent) {
+    switch (pEvent->type()) {
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    case QEvent::MouseButtonDblClick:
+    case QEvent::MouseMove:
+    case QEvent::Wheel:
+    case QEvent::Leave:
+        // The events from the window of the surface
+        return forwardMouseEvent(pEvent);
+    default:
+        return WGLWidget::event(pEvent);
+    }
+}
+
+bool WaveformSurface::forwardMouseEvent(QEvent* pEvent) {
+    if (pEvent->type() == QEvent::Leave) {
+        if (m_pHoveredViewer) {
+            QEvent leaveEvent(QEvent::Leave);
+            QApplication::sendEvent(m_pHoveredViewer, &leaveEvent);
+            m_pHoveredViewer = nullptr;
+        }
+        return true;
+    }
+
+    if (pEvent->type() == QEvent::Wheel) {
+        auto* pWheelEvent = static_cast<QWheelEvent*>(pEvent);
+        QPointF viewerPos;
+        WWaveformViewer* pViewer = viewerAt(pWheelEvent->position(), &viewerPos);
+        if (!pViewer) {
+            pEvent->ignore();
+            return false;
+        }
+        QWheelEvent viewerEvent(viewerPos,
+                pWheelEvent->globalPosition(),
+                pWheelEvent->pixelDelta(),
+                pWheelEvent->angleDelta(),
+                pWheelEvent->buttons(),
+                pWheelEvent->modifiers(),
+                pWheelEvent->phase(),
+                pWheelEvent->inverted(),
+                pWheelEvent->source());
+        QApplication::sendEvent(pViewer, &viewerEvent);
+        pEvent->setAccepted(viewerEvent.isAccepted());
+        return true;
+    }
+
+    auto* pMouseEvent = static_cast<QMouseEvent*>(pEvent);
+    const QPointF surfacePos = mapFromGlobal(globalPosition(pMouseEvent).toPoint());
+    QPointF viewerPos;
+    // While a button is pressed, the viewer where it was pressed gets all
+    // events, like with a mouse grab
+    WWaveformViewer* pViewer = m_pMouseGrabber;
+    if (pViewer) {
+        viewerPos = mapToViewer(pViewer, surfacePos);
+    } else {
+        pViewer = viewerAt(surfacePos, &viewerPos);
+    }
+
+    if (pViewer != m_pHoveredViewer) {
+        if (m_pHoveredViewer) {
+            QEvent leaveEvent(QEvent::Leave);
+            QApplication::sendEvent(m_pHoveredViewer, &leaveEvent);
+        }
+        m_pHoveredViewer = pViewer;
+        // Shown by ToolTipQOpenGL
+        setToolTip(pViewer ? pViewer->toolTip() : QString());
+    }
+    if (!pViewer) {
+        pEvent->ignore();
+        return false;
+    }
+
+    if (pEvent->type() == QEvent::MouseButtonPress) {
+        m_pMouseGrabber = pViewer;
+    }
+    QMouseEvent viewerEvent(pMouseEvent->type(),
+            viewerPos,
+            scenePosition(pMouseEvent),
+            globalPosition(pMouseEvent),
+            pMouseEvent->button(),
+            pMouseEvent->buttons(),
+            pMouseEvent->modifiers());
+    QApplication::sendEvent(pViewer, &viewerEvent);
+    if (pMouseEvent->buttons() == Qt::NoButton) {
+        m_pMouseGrabber = nullptr;
+    }
+    pEvent->setAccepted(viewerEvent.isAccepted());
+    return true;
+}
+
+bool WaveformSurface::handleDragAndDropEventFromWindow(QEvent* pEvent) {
+    if (pEvent->type() == QEvent::DragLeave) {
+        if (m_pDropTarget) {
+            const bool result = m_pDropTarget->handleDragAndDropEventFromWindow(pEvent);
+            m_pDropTarget = nullptr;
+            return result;
+        }
+        pEvent->ignore();
+        return false;
+    }
+
+    // DragEnter, DragMove and Drop. The viewers decide by the dragged
+    // tracks and their group, not by the position.
+    WWaveformViewer* pViewer = viewerAt(dropPosition(static_cast<QDropEvent*>(pEvent)), nullptr);
+    if (!pViewer) {
+        pEvent->ignore();
+        return false;
+    }
+    m_pDropTarget = pEvent->type() == QEvent::Drop ? nullptr : pViewer;
+    return pViewer->handleDragAndDropEventFromWindow(pEvent);
+}
+
+} // namespace allshader
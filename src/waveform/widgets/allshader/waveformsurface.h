@@ -0,0 +1,92 @@
+#pragma once
+
+#include <QColor>
+#include <QList>
+#include <QOpenGLFunctions>
+#include <QPointF>
+#include <QPointer>
+#include <QRect>
+#include <vector>
+
+#include "widget/trackdroptarget.h"
+#include "widget/wglwidget.h"
+
+class WWaveformViewer;
+
+namespace allshader {
+class WaveformSurface;
+class WaveformWidget;
+} // namespace allshader
+
+/// WaveformSurface renders the waveforms of all decks into a single OpenGL
+/// window, instead of a window per allshader::WaveformWidget. That is one
+/// context switch and one buffer swap per frame instead of one per deck, and
+/// the rendergraph resources of all decks live in the same context.
+///
+/// The surface is a child of the closest common ancestor of the
+/// WWaveformViewers and covers the bounding rectangle of the waveforms. Each
+/// waveform is drawn into its part of the surface by setting the viewport and
+/// scissor rectangle. The WaveformWidgets stay in their viewers without a
+/// window, so the layout of the skin still places them. Input events are
+/// forwarded to the viewer below the pointer.
+///
+/// Only skins that don't place other widgets between the waveforms are
+/// supported, because the surface would cover them. If that is detected,
+/// layoutUnsupported() is emitted.
+class allshader::WaveformSurface final : public ::WGLWidget,
+                                         public TrackDropTarget,
+                                         private QOpenGLFunctions {
+    Q_OBJECT
+  public:
+    explicit WaveformSurface(QWidget* pParent);
+    ~WaveformSurface() override;
+
+    /// The widgets must have been created with setSurface(this)
+    void setWaveformWidgets(const QList<WaveformWidget*>& widgets);
+    bool hosts(const WaveformWidget* pWidget) const;
+
+    /// Follows the geometry of the waveforms. Cheap if nothing has changed.
+    void updateLayout();
+    /// Renders all visible waveforms with a single makeCurrent()
+    void render();
+    void swap();
+
+    bool handleDragAndDropEventFromWindow(QEvent* pEvent) override;
+
+  signals:
+    void trackDropped(const QString& filename, const QString& group) override;
+    void cloneDeck(const QString& sourceGroup, const QString& targetGroup) override;
+    /// Emitted if other widgets are in the area of the surface
+    void layoutUnsupported();
+
+  protected:
+    bool event(QEvent* pEvent) override;
+
+  private:
+    struct HostedWaveform {
+        QPointer<WaveformWidget> pWidget;
+        // In the coordinates of the surface, empty if hidden
+        QRect rect;
+        QSize rendererSize;
+    };
+
+    void initializeGL() override;
+    void paintGL() override;
+    void paintEvent(QPaintEvent* event) override;
+
+    void drawWaveforms();
+    bool coversOtherWidgets(QWidget* pParent, const QRect& area) const;
+    bool containsViewer(const QWidget* pWidget) const;
+    WWaveformViewer* viewerAt(QPointF pos, QPointF* pViewerPos) const;
+    QPointF mapToViewer(const WWaveformViewer* pViewer, QPointF pos) const;
+    bool forwardMouseEvent(QEvent* pEvent);
+
+    std::vector<HostedWaveform> m_waveforms;
+    QColor m_backgroundColor;
+    bool m_bLayoutChecked;
+
+    // The viewer that receives the mouse events while a button is pressed
+    QPointer<WWaveformViewer> m_pMouseGrabber;
+    QPointer<WWaveformViewer> m_pHoveredViewer;
+    QPointer<WWaveformViewer> m_pDropTarget;
+};
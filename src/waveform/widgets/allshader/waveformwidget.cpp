@@ -2,6 +2,8 @@
 #include "waveform/widgets/allshader/waveformwidget.h"
 
 #include <QApplication>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
 #include <QWheelEvent>
 
 #include "waveform/renderers/allshader/waveformrenderbackground.h"
@@ -17,6 +19,8 @@
 #include "waveform/renderers/allshader/waveformrenderertextured.h"
 #include "waveform/renderers/allshader/waveformrendermark.h"
 #include "waveform/renderers/allshader/waveformrendermarkrange.h"
+#include "waveform/renderers/waveformrendererprofiler.h"
+#include "waveform/widgets/allshader/waveformsurface.h"
 #include "waveform/widgets/allshader/moc_waveformwidget.cpp"
 
 namespace allshader {
@@ -85,14 +89,26 @@ WaveformWidget::WaveformWidget(QWidget* parent,
     m_pOpacityNode = pTopNode->appendChildNode(std::move(pOpacityNode));
 
     m_pEngine = std::make_unique<rendergraph::Engine>(std::move(pTopNode));
+    if (m_pProfiler) {
+        m_pEngine->setObserver(this);
+    }
 }
 
 WaveformWidget::~WaveformWidget() {
-    makeCurrentIfNeeded();
+    // destruction of nodes needs to happen within the opengl context, which
+    // is the one of the surface if the waveform is rendered there
+    WGLWidget* pContextWidget = m_pSurface ? static_cast<WGLWidget*>(m_pSurface) : this;
+    pContextWidget->makeCurrentIfNeeded();
+    // The profiler owns timer queries
+    m_pProfiler.reset();
     m_rendererStack.clear();
-    // destruction of nodes needs to happen within the opengl context
     m_pEngine.reset();
-    doneCurrent();
+    pContextWidget->doneCurrent();
+}
+
+void WaveformWidget::setSurface(WaveformSurface* pSurface) {
+    DEBUG_ASSERT(!getOpenGLWindow());
+    m_pSurface = pSurface;
 }
 
 std::unique_ptr<WaveformRendererSignalBase>
@@ -132,6 +148,10 @@ WaveformWidget::addWaveformSignalRenderer(WaveformWidgetType::Type type,
 }
 
 mixxx::Duration WaveformWidget::render() {
+    VERIFY_OR_DEBUG_ASSERT(!m_pSurface) {
+        // Rendered by WaveformSurface::render()
+        return mixxx::Duration();
+    }
     makeCurrentIfNeeded();
     paintGL();
     doneCurrent();
@@ -143,11 +163,24 @@ mixxx::Duration WaveformWidget::render() {
 }
 
 void WaveformWidget::paintGL() {
+    if (!m_pSurface && getWidth() > 0 && getHeight() > 0) {
+        // The surface sets the viewport to our part of it
+        QOpenGLContext::currentContext()->functions()->glViewport(0,
+                0,
+                static_cast<GLsizei>(std::lround(getWidth() * getDevicePixelRatio())),
+                static_cast<GLsizei>(std::lround(getHeight() * getDevicePixelRatio())));
+    }
     // opacity of 0.f effectively skips the subtree rendering
     m_pOpacityNode->setOpacity(shouldOnlyDrawBackground() ? 0.f : 1.f);
 
+    if (m_pProfiler) {
+        m_pProfiler->beginFrame(true);
+    }
     m_pEngine->preprocess();
     m_pEngine->render();
+    if (m_pProfiler) {
+        m_pProfiler->endFrame();
+    }
 }
 
 void WaveformWidget::castToQWidget() {
@@ -175,6 +208,16 @@ void WaveformWidget::paintEvent(QPaintEvent* event) {
     Q_UNUSED(event);
 }
 
+void WaveformWidget::showEvent(QShowEvent* event) {
+    if (m_pSurface) {
+        // Don't create a window, this widget only keeps the place of the
+        // waveform in the layout
+        QWidget::showEvent(event); // clazy:exclude=skipped-base-method
+        return;
+    }
+    WGLWidget::showEvent(event);
+}
+
 void WaveformWidget::wheelEvent(QWheelEvent* pEvent) {
     QApplication::sendEvent(parentWidget(), pEvent);
     pEvent->accept();
@@ -185,6 +228,21 @@ void WaveformWidget::leaveEvent(QEvent* pEvent) {
     pEvent->accept();
 }
 
+void WaveformWidget::beginNode(rendergraph::Engine::Pass pass, rendergraph::BaseNode* pNode) {
+    // Also called for the nodes that group the renderers
+    const auto* pRenderer = dynamic_cast<const ::WaveformRendererAbstract*>(pNode);
+    if (pRenderer) {
+        m_pProfiler->beginRenderer(pRenderer, pass == rendergraph::Engine::Pass::Render);
+    }
+}
+
+void WaveformWidget::endNode(rendergraph::Engine::Pass pass, rendergraph::BaseNode* pNode) {
+    const auto* pRenderer = dynamic_cast<const ::WaveformRendererAbstract*>(pNode);
+    if (pRenderer) {
+        m_pProfiler->endRenderer(pRenderer, pass == rendergraph::Engine::Pass::Render);
+    }
+}
+
 /* static */
 WaveformRendererSignalBase::Options WaveformWidget::supportedOptions(
         WaveformWidgetType::Type type) {
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <QPointer>
+
 #include "rendergraph/engine.h"
 #include "rendergraph/opacitynode.h"
 #include "waveform/renderers/allshader/waveformrenderersignalbase.h"
@@ -8,13 +10,15 @@
 #include "widget/wglwidget.h"
 
 namespace allshader {
+class WaveformSurface;
 class WaveformWidget;
 class WaveformRenderMark;
 class WaveformRenderMarkRange;
 }
 
 class allshader::WaveformWidget final : public ::WGLWidget,
-                                        public ::WaveformWidgetAbstract {
+                                        public ::WaveformWidgetAbstract,
+                                        private rendergraph::Engine::Observer {
     Q_OBJECT
   public:
     explicit WaveformWidget(QWidget* parent,
@@ -39,15 +43,28 @@ class allshader::WaveformWidget final : public ::WGLWidget,
     WGLWidget* getGLWidget() override {
         return this;
     }
+
+    /// Lets the surface render this waveform instead of a window of its own.
+    /// Must be called before the widget is shown.
+    void setSurface(WaveformSurface* pSurface);
+    WaveformSurface* surface() const {
+        return m_pSurface;
+    }
     static WaveformWidgetVars vars();
     static WaveformRendererSignalBase::Options supportedOptions(WaveformWidgetType::Type type);
 
   private:
     void castToQWidget() override;
     void paintEvent(QPaintEvent* event) override;
+    void showEvent(QShowEvent* event) override;
     void wheelEvent(QWheelEvent* event) override;
     void leaveEvent(QEvent* event) override;
 
+    // overrides for rendergraph::Engine::Observer, only used in developer
+    // mode to time the renderers
+    void beginNode(rendergraph::Engine::Pass pass, rendergraph::BaseNode* pNode) override;
+    void endNode(rendergraph::Engine::Pass pass, rendergraph::BaseNode* pNode) override;
+
     template<class T_Renderer, typename... Args>
     inline std::unique_ptr<T_Renderer> addRendererNode(Args&&... args) {
         return std::unique_ptr<T_Renderer>(addRenderer<T_Renderer>(std::forward<Args>(args)...));
@@ -70,6 +87,7 @@ class allshader::WaveformWidget final : public ::WGLWidget,
     WaveformRenderMark* m_pWaveformRenderMark;
     WaveformRenderMarkRange* m_pWaveformRenderMarkRange;
     WaveformRendererSignalBase* m_pWaveformRendererSignal;
+    QPointer<WaveformSurface> m_pSurface;
 
     DISALLOW_COPY_AND_ASSIGN(WaveformWidget);
 };
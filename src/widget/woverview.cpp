@@ -26,6 +26,12 @@
 #include "widget/controlwidgetconnection.h"
 #include "wskincolor.h"
 
+#ifdef MIXXX_USE_QOPENGL
+#include "waveform/renderers/allshader/rgbadata.h"
+#include "waveform/renderers/allshader/vertexdata.h"
+#include "widget/woverviewglsl.h"
+#endif
+
 WOverview::WOverview(
         const QString& group,
         PlayerManager* pPlayerManager,
@@ -56,6 +62,9 @@ WOverview::WOverview(
           m_trackLoaded(false),
           m_pHoveredMark(nullptr),
           m_scaleFactor(1.0),
+          m_pShaderOverview(nullptr),
+          m_bShaderSceneDirty(false),
+          m_shaderWaveformCacheKey(0),
           m_trackSampleRateControl(
                   m_group,
                   QStringLiteral("track_samplerate")),
@@ -269,7 +278,9 @@ void WOverview::onConnectedControlChanged(double dParameter, double dValue) {
     bool redraw = false;
     int oldPos = m_iPlayPos;
     m_iPlayPos = valueToPosition(dParameter);
-    if (oldPos != m_iPlayPos) {
+    // The shader overview picks up the new position with the next frame,
+    // without painting the scene again.
+    if (oldPos != m_iPlayPos && !m_pShaderOverview) {
         redraw = true;
     }
 
@@ -289,7 +300,7 @@ void WOverview::onConnectedControlChanged(double dParameter, double dValue) {
     }
 
     if (redraw) {
-        update();
+        requestRepaint();
     }
 }
 
@@ -306,7 +317,7 @@ void WOverview::slotWaveformSummaryUpdated() {
         if (m_pWaveform->getCompletion() == m_pWaveform->getDataSize()) {
             m_actualCompletion = 0;
             if (drawNextPixmapPart()) {
-                update();
+                requestRepaint();
             }
         }
     } else {
@@ -317,7 +328,7 @@ void WOverview::slotWaveformSummaryUpdated() {
         m_waveformPeak = -1.0;
         m_pixmapDone = false;
 
-        update();
+        requestRepaint();
     }
 }
 
@@ -329,7 +340,7 @@ void WOverview::onTrackAnalyzerProgress(TrackId trackId, AnalyzerProgress analyz
     bool updateNeeded = drawNextPixmapPart();
     if (updateNeeded || (m_analyzerProgress != analyzerProgress)) {
         m_analyzerProgress = analyzerProgress;
-        update();
+        requestRepaint();
     }
 }
 
@@ -341,7 +352,7 @@ void WOverview::slotTrackLoaded(TrackPointer pTrack) {
     if (m_pCurrentTrack) {
         updateCues(m_pCurrentTrack->getCuePoints());
     }
-    update();
+    requestRepaint();
 }
 
 void WOverview::slotLoadingTrack(TrackPointer pNewTrack, TrackPointer pOldTrack) {
@@ -384,13 +395,13 @@ void WOverview::slotLoadingTrack(TrackPointer pNewTrack, TrackPointer pOldTrack)
         m_pCurrentTrack.reset();
         m_pWaveform.clear();
     }
-    update();
+    requestRepaint();
 }
 
 void WOverview::onEndOfTrackChange(double v) {
     //qDebug() << "WOverview::onEndOfTrackChange()" << v;
     m_endOfTrack = v > 0.0;
-    update();
+    requestRepaint();
 }
 
 void WOverview::onMarkChanged(double v) {
@@ -398,19 +409,19 @@ void WOverview::onMarkChanged(double v) {
     //qDebug() << "WOverview::onMarkChanged()" << v;
     if (m_pCurrentTrack) {
         updateCues(m_pCurrentTrack->getCuePoints());
-        update();
+        requestRepaint();
     }
 }
 
 void WOverview::onMarkRangeChange(double v) {
     Q_UNUSED(v);
     //qDebug() << "WOverview::onMarkRangeChange()" << v;
-    update();
+    requestRepaint();
 }
 
 void WOverview::onRateRatioChange(double v) {
     Q_UNUSED(v);
-    update();
+    requestRepaint();
 }
 
 void WOverview::onPassthroughChange(double v) {
@@ -421,7 +432,7 @@ void WOverview::onPassthroughChange(double v) {
     }
 
     // Always call this to trigger a repaint even if not track is loaded
-    update();
+    requestRepaint();
 }
 
 void WOverview::slotTypeControlChanged(double v) {
@@ -438,11 +449,11 @@ void WOverview::slotTypeControlChanged(double v) {
 }
 
 void WOverview::slotMinuteMarkersChanged(bool /*unused*/) {
-    update();
+    requestRepaint();
 }
 
 void WOverview::slotNormalizeOrVisualGainChanged() {
-    update();
+    requestRepaint();
 }
 
 void WOverview::updateCues(const QList<CuePointer> &loadedCues) {
@@ -508,14 +519,14 @@ void WOverview::mouseMoveEvent(QMouseEvent* e) {
         // cursor is dragged outside this widget before releasing right click.
         m_timeRulerPos.setX(math_clamp(e->pos().x(), 0, width()));
         m_timeRulerPos.setY(math_clamp(e->pos().y(), 0, height()));
-        update();
+        requestRepaint();
         return;
     }
 
     m_pHoveredMark = m_marks.findHoveredMark(e->pos(), m_orientation);
 
     //qDebug() << "WOverview::mouseMoveEvent" << e->pos() << m_iPos;
-    update();
+    requestRepaint();
 }
 
 void WOverview::mouseReleaseEvent(QMouseEvent* e) {
@@ -622,7 +633,7 @@ void WOverview::mousePressEvent(QMouseEvent* e) {
 
 void WOverview::slotCueMenuPopupAboutToHide() {
     m_pHoveredMark.clear();
-    update();
+    requestRepaint();
 }
 
 void WOverview::leaveEvent(QEvent* pEvent) {
@@ -632,11 +643,15 @@ void WOverview::leaveEvent(QEvent* pEvent) {
     }
     m_bLeftClickDragging = false;
     m_bTimeRulerActive = false;
-    update();
+    requestRepaint();
 }
 
 void WOverview::paintEvent(QPaintEvent* pEvent) {
     Q_UNUSED(pEvent);
+    if (m_pShaderOverview) {
+        // Covered by the shader overview
+        return;
+    }
     ScopedTimer t(QStringLiteral("WOverview::paintEvent"));
 
     QPainter painter(this);
@@ -680,6 +695,240 @@ void WOverview::paintEvent(QPaintEvent* pEvent) {
     }
 }
 
+void WOverview::requestRepaint() {
+    if (m_pShaderOverview) {
+        // Built with the next frame from the vsync thread
+        m_bShaderSceneDirty = true;
+        return;
+    }
+    update();
+}
+
+#ifdef MIXXX_USE_QOPENGL
+void WOverview::enableShaderRendering() {
+    VERIFY_OR_DEBUG_ASSERT(!m_pShaderOverview) {
+        return;
+    }
+    m_pShaderOverview = new WOverviewGLSL(this);
+    m_pShaderOverview->setTrackDropTarget(this);
+    m_pShaderOverview->setToolTip(toolTip());
+    m_pShaderOverview->setOrientation(m_orientation);
+    m_pShaderOverview->setStyle(m_backgroundColor,
+            m_backgroundPixmap,
+            m_playPosColor,
+            m_playedOverlayColor,
+            m_scaleFactor);
+    m_pShaderOverview->resize(size());
+    // The passthrough label is part of the label texture
+    m_pPassthroughLabel->hide();
+
+    WaveformWidgetFactory* widgetFactory = WaveformWidgetFactory::instance();
+    connect(widgetFactory,
+            &WaveformWidgetFactory::renderOverviews,
+            this,
+            &WOverview::slotRenderShaderOverview);
+    connect(widgetFactory,
+            &WaveformWidgetFactory::swapOverviews,
+            m_pShaderOverview,
+            &WOverviewGLSL::swap);
+    m_bShaderSceneDirty = true;
+}
+
+void WOverview::slotRenderShaderOverview() {
+    if (!m_pShaderOverview->shouldRender()) {
+        return;
+    }
+    if (m_bShaderSceneDirty) {
+        updateShaderScene();
+    }
+    const bool trackLoaded = m_pCurrentTrack && getTrackSamples() > 0;
+    m_pShaderOverview->setCursors(m_iPlayPos,
+            m_iPickupPos,
+            trackLoaded,
+            m_pCurrentTrack && m_bLeftClickDragging);
+    m_pShaderOverview->render();
+}
+
+void WOverview::updateShaderScene() {
+    ScopedTimer t(QStringLiteral("WOverview::updateShaderScene"));
+    m_bShaderSceneDirty = false;
+
+    // The cache key changes whenever drawNextPixmapPart() has painted into
+    // the image, so the waveform is only uploaded after it has grown.
+    if (m_waveformSourceImage.cacheKey() != m_shaderWaveformCacheKey) {
+        m_shaderWaveformCacheKey = m_waveformSourceImage.cacheKey();
+        m_pShaderOverview->setWaveformImage(m_waveformSourceImage);
+    }
+    m_pShaderOverview->setWaveformSourceRect(waveformSourceRect(waveformDiffGain()));
+
+    allshader::VertexData vertices;
+    allshader::RGBAData colors;
+    int underlayVertexCount = 0;
+    if (m_pCurrentTrack) {
+        addShaderGeometry(&vertices, &colors, &underlayVertexCount);
+    }
+    m_pShaderOverview->setMarkGeometry(vertices, colors, underlayVertexCount);
+
+    // Text is still rendered with QPainter, but only when the scene changes
+    // and not for every move of the play position.
+    const qreal devicePixelRatio = devicePixelRatioF();
+    QImage labelImage(size() * devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    labelImage.setDevicePixelRatio(devicePixelRatio);
+    labelImage.fill(Qt::transparent);
+    {
+        QPainter painter(&labelImage);
+        painter.setFont(font());
+        if (m_pCurrentTrack) {
+            drawAnalyzerProgress(&painter);
+            const double trackSamples = getTrackSamples();
+            if (trackSamples > 0) {
+                const float offset = 1.0f;
+                const auto gain = static_cast<CSAMPLE_GAIN>(length() - 2) /
+                        static_cast<CSAMPLE_GAIN>(trackSamples);
+                // The line positions have been updated by addShaderGeometry()
+                layoutMarkLabels(offset, gain);
+                drawTimeRuler(&painter);
+                drawMarkLabels(&painter, offset, gain);
+            }
+        }
+        if (m_bPassthroughEnabled) {
+            drawPassthroughOverlay(&painter);
+            drawPassthroughLabel(&painter);
+        }
+    }
+    m_pShaderOverview->setLabelImage(labelImage);
+}
+
+void WOverview::addShaderGeometry(allshader::VertexData* pVertices,
+        allshader::RGBAData* pColors,
+        int* pUnderlayVertexCount) {
+    // Along the length and across the breadth, the shader overview transposes
+    // it for the vertical orientation.
+    const auto fullLength = static_cast<float>(length());
+    const auto fullBreadth = static_cast<float>(breadth());
+    const auto lineWidth = static_cast<float>(m_scaleFactor);
+
+    // Below the waveform, like drawEndOfTrackBackground() and drawAxis()
+    if (m_endOfTrack) {
+        WOverviewGLSL::addRectangle(pVertices,
+                pColors,
+                QRectF(1, 1, fullLength - 2, fullBreadth - 2),
+                m_endOfTrackColor,
+                0.3f);
+    }
+    WOverviewGLSL::addRectangle(pVertices,
+            pColors,
+            QRectF(0, (fullBreadth - lineWidth) / 2, fullLength, lineWidth),
+            m_axesColor,
+            1.f);
+    *pUnderlayVertexCount = pVertices->size();
+
+    // Like drawMinuteMarkers()
+    if (m_trackLoaded && static_cast<bool>(m_pMinuteMarkersControl->get()) &&
+            m_pRateRatioControl->get() != 0) {
+        const double trackSeconds = samplePositionToSeconds(getTrackSamples());
+        const double markerHeight = fullBreadth * 0.08;
+        const double lowerMarkerYPos = fullBreadth * 0.92;
+        for (double currentMarkerSeconds = 60; currentMarkerSeconds < trackSeconds;
+                currentMarkerSeconds += 60) {
+            const double markerXPos =
+                    currentMarkerSeconds / trackSeconds * fullLength - lineWidth / 2;
+            WOverviewGLSL::addRectangle(pVertices,
+                    pColors,
+                    QRectF(markerXPos, 0.0, lineWidth, markerHeight),
+                    m_axesColor,
+                    1.f);
+            WOverviewGLSL::addRectangle(pVertices,
+                    pColors,
+                    QRectF(markerXPos, lowerMarkerYPos, lineWidth, fullBreadth - lowerMarkerYPos),
+                    m_axesColor,
+                    1.f);
+        }
+    }
+
+    // Like drawEndOfTrackFrame()
+    if (m_endOfTrack) {
+        const float frameWidth = 1.5f * lineWidth;
+        const QRectF frame[] = {
+                QRectF(0, 0, fullLength, frameWidth),
+                QRectF(0, fullBreadth - frameWidth, fullLength, frameWidth),
+                QRectF(0, frameWidth, frameWidth, fullBreadth - 2 * frameWidth),
+                QRectF(fullLength - frameWidth,
+                        frameWidth,
+                        frameWidth,
+                        fullBreadth - 2 * frameWidth),
+        };
+        for (const auto& rect : frame) {
+            WOverviewGLSL::addRectangle(pVertices, pColors, rect, m_endOfTrackColor, 0.8f);
+        }
+    }
+
+    const double trackSamples = getTrackSamples();
+    if (trackSamples <= 0) {
+        return;
+    }
+    const float offset = 1.0f;
+    const auto gain = static_cast<CSAMPLE_GAIN>(length() - 2) /
+            static_cast<CSAMPLE_GAIN>(trackSamples);
+
+    // Like drawRangeMarks()
+    for (auto&& markRange : m_markRanges) {
+        if (!markRange.active() || !markRange.visible()) {
+            continue;
+        }
+        const qreal startPosition = offset + markRange.start() * gain;
+        const qreal endPosition = offset + markRange.end() * gain;
+        if (startPosition < 0.0 && endPosition < 0.0) {
+            continue;
+        }
+        if (markRange.enabled()) {
+            WOverviewGLSL::addRectangle(pVertices,
+                    pColors,
+                    QRectF(QPointF(startPosition, 0), QPointF(endPosition, fullBreadth)),
+                    markRange.m_activeColor,
+                    static_cast<float>(markRange.m_enabledOpacity));
+        } else {
+            WOverviewGLSL::addRectangle(pVertices,
+                    pColors,
+                    QRectF(QPointF(startPosition, 0), QPointF(endPosition, fullBreadth)),
+                    markRange.m_disabledColor,
+                    static_cast<float>(markRange.m_disabledOpacity));
+        }
+    }
+
+    // Like the first loop of drawMarks()
+    for (const auto& pMark : std::as_const(m_marks)) {
+        const float markPosition = markLinePosition(pMark->getSamplePosition(), offset, gain);
+        pMark->m_linePosition = markPosition;
+
+        WOverviewGLSL::addRectangle(pVertices,
+                pColors,
+                QRectF(markPosition - 1.5f, 0, 1, fullBreadth),
+                pMark->borderColor(),
+                1.f);
+        WOverviewGLSL::addRectangle(pVertices,
+                pColors,
+                QRectF(markPosition - 0.5f, 0, 1, fullBreadth),
+                pMark->fillColor(),
+                1.f);
+
+        const double sampleEndPosition = pMark->getSampleEndPosition();
+        if (sampleEndPosition > 0) {
+            const float markEndPosition = markLinePosition(sampleEndPosition, offset, gain);
+            if (markEndPosition > markPosition) {
+                QColor loopColor = pMark->fillColor();
+                loopColor.setAlphaF(0.5f);
+                WOverviewGLSL::addRectangle(pVertices,
+                        pColors,
+                        QRectF(markPosition, 0, markEndPosition - markPosition, fullBreadth),
+                        loopColor,
+                        1.f);
+            }
+        }
+    }
+}
+#endif
+
 void WOverview::drawEndOfTrackBackground(QPainter* pPainter) {
     if (m_endOfTrack) {
         PainterScope painterScope(pPainter);
@@ -699,27 +948,32 @@ void WOverview::drawAxis(QPainter* pPainter) {
     }
 }
 
-void WOverview::drawWaveformPixmap(QPainter* pPainter) {
+float WOverview::waveformDiffGain() const {
     WaveformWidgetFactory* widgetFactory = WaveformWidgetFactory::instance();
+    bool normalize = widgetFactory->isOverviewNormalized();
+    if (normalize && m_pixmapDone && m_waveformPeak > 1) {
+        return 255 - m_waveformPeak - 1;
+    }
+    const auto visualGain = static_cast<float>(
+            widgetFactory->getVisualGain(WaveformWidgetFactory::All));
+    return 255.0f - (255.0f / visualGain);
+}
+
+QRect WOverview::waveformSourceRect(float diffGain) const {
+    // Crop the full range waveform data to the gain
+    return QRect(0,
+            static_cast<int>(diffGain),
+            m_waveformSourceImage.width(),
+            m_waveformSourceImage.height() - 2 * static_cast<int>(diffGain));
+}
+
+void WOverview::drawWaveformPixmap(QPainter* pPainter) {
     if (!m_waveformSourceImage.isNull()) {
         PainterScope painterScope(pPainter);
-        float diffGain;
-        bool normalize = widgetFactory->isOverviewNormalized();
-        if (normalize && m_pixmapDone && m_waveformPeak > 1) {
-            diffGain = 255 - m_waveformPeak - 1;
-        } else {
-            const auto visualGain = static_cast<float>(
-                    widgetFactory->getVisualGain(WaveformWidgetFactory::All));
-            diffGain = 255.0f - (255.0f / visualGain);
-        }
+        const float diffGain = waveformDiffGain();
 
         if (m_diffGain != diffGain || m_waveformImageScaled.isNull()) {
-            QRect sourceRect(0,
-                    static_cast<int>(diffGain),
-                    m_waveformSourceImage.width(),
-                    m_waveformSourceImage.height() -
-                            2 * static_cast<int>(diffGain));
-            QImage croppedImage = m_waveformSourceImage.copy(sourceRect);
+            QImage croppedImage = m_waveformSourceImage.copy(waveformSourceRect(diffGain));
             if (m_orientation == Qt::Vertical) {
                 // Rotate pixmap
                 croppedImage = croppedImage.transformed(QTransform(0, 1, 1, 0, 0, 0));
@@ -906,34 +1160,30 @@ void WOverview::drawRangeMarks(QPainter* pPainter, const float& offset, const fl
     }
 }
 
-void WOverview::drawMarks(QPainter* pPainter, const float offset, const float gain) {
-    QFont markerFont = pPainter->font();
-    markerFont.setPixelSize(static_cast<int>(m_iLabelFontSize * m_scaleFactor));
-    QFontMetricsF fontMetrics(markerFont);
+float WOverview::markLinePosition(double samplePosition, float offset, float gain) {
+    return math_clamp(offset + static_cast<float>(samplePosition) * gain,
+            0.0f,
+            static_cast<float>(width()));
+}
 
+void WOverview::drawMarks(QPainter* pPainter, const float offset, const float gain) {
     // Text labels are rendered so they do not overlap with other WaveformMarks'
     // labels. If the text would be too wide, it is elided. However, the user
     // can hover the mouse cursor over a label to show the whole label text,
     // temporarily hiding any following labels that would be drawn over it.
     // This requires looping over the WaveformMarks twice and the marks must be
     // sorted in the order they appear on the waveform.
-    // In the first loop, the lines are drawn and the text to render plus its
-    // location are calculated then stored in a WaveformMarkLabel. The text must
-    // be drawn in the second loop to prevent the lines of following
-    // WaveformMarks getting drawn over it. The second loop is in the separate
-    // drawMarkLabels function so it can be called after drawCurrentPosition so
-    // the view of labels is not obscured by the playhead.
-
-    bool markHovered = false;
+    // In the first loop, the lines are drawn, and the text to render plus its
+    // location are calculated in layoutMarkLabels then stored in a
+    // WaveformMarkLabel. The text must be drawn in the second loop to prevent
+    // the lines of following WaveformMarks getting drawn over it. The second
+    // loop is in the separate drawMarkLabels function so it can be called
+    // after drawCurrentPosition so the view of labels is not obscured by the
+    // playhead.
 
-    for (auto it = m_marks.cbegin(); it != m_marks.cend(); ++it) {
+    for (const auto& pMark : std::as_const(m_marks)) {
         PainterScope painterScope(pPainter);
-        const WaveformMarkPointer& pMark = *it;
-        double samplePosition = pMark->getSamplePosition();
-        const float markPosition = math_clamp(
-                offset + static_cast<float>(samplePosition) * gain,
-                0.0f,
-                static_cast<float>(width()));
+        const float markPosition = markLinePosition(pMark->getSamplePosition(), offset, gain);
         pMark->m_linePosition = markPosition;
 
         QLineF line;
@@ -972,6 +1222,21 @@ void WOverview::drawMarks(QPainter* pPainter, const float offset, const float ga
             loopColor.setAlphaF(0.5f);
             pPainter->fillRect(rect, loopColor);
         }
+    }
+
+    layoutMarkLabels(offset, gain);
+}
+
+void WOverview::layoutMarkLabels(const float offset, const float gain) {
+    QFont markerFont = font();
+    markerFont.setPixelSize(static_cast<int>(m_iLabelFontSize * m_scaleFactor));
+    QFontMetricsF fontMetrics(markerFont);
+
+    bool markHovered = false;
+
+    for (auto it = m_marks.cbegin(); it != m_marks.cend(); ++it) {
+        const WaveformMarkPointer& pMark = *it;
+        const float markPosition = pMark->m_linePosition;
 
         if (!pMark->m_text.isEmpty()) {
             Qt::Alignment halign = pMark->m_align & Qt::AlignHorizontal_Mask;
@@ -1316,6 +1581,21 @@ void WOverview::drawPassthroughOverlay(QPainter* pPainter) {
     }
 }
 
+void WOverview::drawPassthroughLabel(QPainter* pPainter) {
+    // Like m_pPassthroughLabel, which can't be shown on top of the shader
+    // overview.
+    PainterScope painterScope(pPainter);
+    QFont labelFont = font();
+    labelFont.setFamily(QStringLiteral("Open Sans"));
+    labelFont.setPixelSize(static_cast<int>(m_iLabelFontSize * 1.5));
+    labelFont.setBold(true);
+    pPainter->setFont(labelFont);
+    pPainter->setPen(m_signalColors.getPassthroughLabelColor());
+    pPainter->drawText(rect().adjusted(m_iLabelFontSize, 0, 0, 0),
+            Qt::AlignLeft | Qt::AlignVCenter,
+            m_pPassthroughLabel->text());
+}
+
 bool WOverview::drawNextPixmapPart() {
     ConstWaveformPointer pWaveform = getWaveform();
     if (!pWaveform) {
@@ -1639,9 +1919,19 @@ void WOverview::resizeEvent(QResizeEvent* pEvent) {
 
     m_waveformImageScaled = QImage();
     m_diffGain = 0;
+#ifdef MIXXX_USE_QOPENGL
+    if (m_pShaderOverview) {
+        m_pShaderOverview->resize(size());
+        m_bShaderSceneDirty = true;
+    }
+#endif
     Init();
 }
 
+bool WOverview::handleDragAndDropEventFromWindow(QEvent* pEvent) {
+    return event(pEvent);
+}
+
 void WOverview::dragEnterEvent(QDragEnterEvent* pEvent) {
     DragAndDropHelper::handleTrackDragEnterEvent(pEvent, m_group, m_pConfig);
 }
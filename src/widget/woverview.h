@@ -19,6 +19,11 @@
 class PlayerManager;
 class QDomNode;
 class SkinContext;
+class WOverviewGLSL;
+namespace allshader {
+class RGBAData;
+class VertexData;
+} // namespace allshader
 
 class WOverview : public WWidget, public TrackDropTarget {
     Q_OBJECT
@@ -31,6 +36,12 @@ class WOverview : public WWidget, public TrackDropTarget {
 
     void setup(const QDomNode& node, const SkinContext& context);
     virtual void initWithTrack(TrackPointer pTrack);
+#ifdef MIXXX_USE_QOPENGL
+    /// Renders the overview with OpenGL shaders from the vsync thread
+    /// instead of painting it. Must be called after setup().
+    void enableShaderRendering();
+#endif
+    bool handleDragAndDropEventFromWindow(QEvent* pEvent) override;
 
     enum class Type {
         Filtered,
@@ -76,8 +87,20 @@ class WOverview : public WWidget, public TrackDropTarget {
     void slotTypeControlChanged(double v);
     void slotMinuteMarkersChanged(bool v);
     void slotNormalizeOrVisualGainChanged();
+#ifdef MIXXX_USE_QOPENGL
+    void slotRenderShaderOverview();
+#endif
 
   private:
+    // Either schedules a paintEvent() or an update of the shader scene
+    void requestRepaint();
+#ifdef MIXXX_USE_QOPENGL
+    void updateShaderScene();
+    void addShaderGeometry(allshader::VertexData* pVertices,
+            allshader::RGBAData* pColors,
+            int* pUnderlayVertexCount);
+#endif
+
     // Append the waveform overview pixmap according to available data
     // in waveform
     bool drawNextPixmapPart();
@@ -101,10 +124,15 @@ class WOverview : public WWidget, public TrackDropTarget {
     void drawAnalyzerProgress(QPainter* pPainter);
     void drawRangeMarks(QPainter* pPainter, const float& offset, const float& gain);
     void drawMarks(QPainter* pPainter, const float offset, const float gain);
+    void layoutMarkLabels(const float offset, const float gain);
+    float markLinePosition(double samplePosition, float offset, float gain);
     void drawPickupPosition(QPainter* pPainter);
     void drawTimeRuler(QPainter* pPainter);
     void drawMarkLabels(QPainter* pPainter, const float offset, const float gain);
     void drawPassthroughOverlay(QPainter* pPainter);
+    void drawPassthroughLabel(QPainter* pPainter);
+    float waveformDiffGain() const;
+    QRect waveformSourceRect(float diffGain) const;
     void paintText(const QString& text, QPainter* pPainter);
     double samplePositionToSeconds(double sample);
     inline int valueToPosition(double value) const {
@@ -181,6 +209,11 @@ class WOverview : public WWidget, public TrackDropTarget {
     QImage m_waveformSourceImage;
     QImage m_waveformImageScaled;
 
+    // Owned by Qt, only set if the overview is rendered with shaders
+    WOverviewGLSL* m_pShaderOverview;
+    bool m_bShaderSceneDirty;
+    qint64 m_shaderWaveformCacheKey;
+
     WaveformSignalColors m_signalColors;
 
     parented_ptr<ControlProxy> m_endOfTrackControl;
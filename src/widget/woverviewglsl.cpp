@@ -0,0 +1,448 @@
+#include "widget/woverviewglsl.h"
+
+#include <QApplication>
+#include <QOpenGLTexture>
+#include <array>
+
+#include "moc_woverviewglsl.cpp"
+#include "util/assert.h"
+#include "util/timer.h"
+
+namespace {
+
+// Swaps the coordinates along the length and the breadth, like the
+// QTransform(0, 1, 1, 0, 0, 0) of the QPainter based WOverview.
+const QMatrix4x4 kTransposeMatrix(
+        0.f, 1.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 1.f);
+
+void addTriangle(allshader::VertexData* pVertices,
+        allshader::RGBAData* pColors,
+        const QVector2D& a,
+        const QVector2D& b,
+        const QVector2D& c,
+        const QColor& color) {
+    pVertices->addTriangle(a, b, c);
+    pColors->addForTriangle(static_cast<float>(color.redF()),
+            static_cast<float>(color.greenF()),
+            static_cast<float>(color.blueF()),
+            static_cast<float>(color.alphaF()));
+}
+
+} // anonymous namespace
+
+// static
+void WOverviewGLSL::addRectangle(allshader::VertexData* pVertices,
+        allshader::RGBAData* pColors,
+        const QRectF& rect,
+        const QColor& color,
+        float opacity) {
+    pVertices->addRectangle(static_cast<float>(rect.left()),
+            static_cast<float>(rect.top()),
+            static_cast<float>(rect.right()),
+            static_cast<float>(rect.bottom()));
+    pColors->addForRectangle(static_cast<float>(color.redF()),
+            static_cast<float>(color.greenF()),
+            static_cast<float>(color.blueF()),
+            static_cast<float>(color.alphaF()) * opacity);
+}
+
+WOverviewGLSL::WOverviewGLSL(QWidget* pParent)
+        : WGLWidget(pParent),
+          m_markBuffer(QOpenGLBuffer::VertexBuffer),
+          m_maxTextureSize(0),
+          m_bBackgroundDirty(false),
+          m_bWaveformDirty(false),
+          m_bLabelsDirty(false),
+          m_bMarkGeometryDirty(true),
+          m_bufferVertexCount(0),
+          m_underlayVertexCount(0),
+          m_overlayVertexCount(0),
+          m_playedVertexOffset(0),
+          m_pickupVertexOffset(0),
+          m_pickupVertexCount(0),
+          m_dragVertexOffset(0),
+          m_dragVertexCount(0),
+          m_orientation(Qt::Horizontal),
+          m_scaleFactor(1.0),
+          m_playPos(0),
+          m_pickupPos(0),
+          m_bShowPickup(false),
+          m_bDragging(false),
+          m_iPendingRenders(0),
+          m_bSwapNeeded(false) {
+    setFocusPolicy(Qt::NoFocus);
+}
+
+WOverviewGLSL::~WOverviewGLSL() {
+    cleanupGL();
+}
+
+void WOverviewGLSL::setOrientation(Qt::Orientation orientation) {
+    m_orientation = orientation;
+    m_bMarkGeometryDirty = true;
+    m_iPendingRenders = 2;
+}
+
+void WOverviewGLSL::setStyle(const QColor& backgroundColor,
+        const QPixmap& backgroundPixmap,
+        const QColor& playPosColor,
+        const QColor& playedOverlayColor,
+        double scaleFactor) {
+    m_backgroundColor = backgroundColor;
+    m_backgroundImage = backgroundPixmap.toImage();
+    m_bBackgroundDirty = true;
+    m_playPosColor = playPosColor;
+    m_playedOverlayColor = playedOverlayColor;
+    m_scaleFactor = scaleFactor;
+    m_bMarkGeometryDirty = true;
+    m_iPendingRenders = 2;
+}
+
+void WOverviewGLSL::setWaveformImage(const QImage& image) {
+    m_waveformImage = image;
+    m_bWaveformDirty = true;
+    m_iPendingRenders = 2;
+}
+
+void WOverviewGLSL::setWaveformSourceRect(const QRectF& sourceRect) {
+    if (m_waveformSourceRect == sourceRect) {
+        return;
+    }
+    m_waveformSourceRect = sourceRect;
+    m_iPendingRenders = 2;
+}
+
+void WOverviewGLSL::setMarkGeometry(const allshader::VertexData& vertices,
+        const allshader::RGBAData& colors,
+        int underlayVertexCount) {
+    VERIFY_OR_DEBUG_ASSERT(vertices.size() == colors.size() &&
+            underlayVertexCount <= vertices.size()) {
+        return;
+    }
+    m_markVertices = vertices;
+    m_markColors = colors;
+    m_underlayVertexCount = underlayVertexCount;
+    m_overlayVertexCount = vertices.size() - underlayVertexCount;
+    m_bMarkGeometryDirty = true;
+    m_iPendingRenders = 2;
+}
+
+void WOverviewGLSL::setLabelImage(const QImage& image) {
+    m_labelImage = image;
+    m_bLabelsDirty = true;
+    m_iPendingRenders = 2;
+}
+
+void WOverviewGLSL::setCursors(int playPos, int pickupPos, bool showPickup, bool dragging) {
+    if (playPos == m_playPos && pickupPos == m_pickupPos &&
+            showPickup == m_bShowPickup && dragging == m_bDragging) {
+        return;
+    }
+    m_playPos = playPos;
+    m_pickupPos = pickupPos;
+    m_bShowPickup = showPickup;
+    m_bDragging = dragging;
+    m_iPendingRenders = 2;
+}
+
+bool WOverviewGLSL::event(QEvent* pEvent) {
+    switch (pEvent->type()) {
+    case QEvent::MouseButtonPress:
+    case QEvent::MouseButtonRelease:
+    case QEvent::MouseButtonDblClick:
+    case QEvent::MouseMove:
+    case QEvent::Wheel:
+    case QEvent::Leave:
+        // The OpenGL window forwards its input to this widget, but the
+        // interaction is handled by the WOverview underneath, which has the
+        // same geometry.
+        return QApplication::sendEvent(parentWidget(), pEvent);
+    default:
+        return WGLWidget::event(pEvent);
+    }
+}
+
+void WOverviewGLSL::render() {
+    if (!shouldRender() || m_iPendingRenders == 0) {
+        return;
+    }
+
+    ScopedTimer t(QStringLiteral("WOverviewGLSL::render"));
+
+    makeCurrentIfNeeded();
+    paintGL();
+    doneCurrent();
+
+    m_iPendingRenders--;
+    m_bSwapNeeded = true;
+}
+
+void WOverviewGLSL::swap() {
+    if (!m_bSwapNeeded || !shouldRender()) {
+        return;
+    }
+    makeCurrentIfNeeded();
+    swapBuffers();
+    doneCurrent();
+    m_bSwapNeeded = false;
+}
+
+void WOverviewGLSL::paintEvent(QPaintEvent* /*unused*/) {
+    // Render twice from the vsync thread, in case triple buffering is used.
+    m_iPendingRenders = 2;
+}
+
+void WOverviewGLSL::showEvent(QShowEvent* event) {
+    WGLWidget::showEvent(event);
+    // Force a rerender when exposed
+    m_iPendingRenders = 2;
+}
+
+void WOverviewGLSL::initializeGL() {
+    initializeOpenGLFunctions();
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &m_maxTextureSize);
+    m_textureShader.init();
+    m_rgbaShader.init();
+    m_markBuffer.create();
+    m_markBuffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
+
+    // Upload everything to the new context
+    m_bBackgroundDirty = true;
+    m_bWaveformDirty = true;
+    m_bLabelsDirty = true;
+    m_bMarkGeometryDirty = true;
+}
+
+void WOverviewGLSL::resizeGL(int w, int h) {
+    Q_UNUSED(w);
+    Q_UNUSED(h);
+    // The cursors span the breadth of the overview
+    m_bMarkGeometryDirty = true;
+    m_iPendingRenders = 2;
+}
+
+void WOverviewGLSL::cleanupGL() {
+    makeCurrentIfNeeded();
+    m_backgroundTexture.destroy();
+    m_waveformTexture.destroy();
+    m_labelTexture.destroy();
+    m_markBuffer.destroy();
+    doneCurrent();
+}
+
+int WOverviewGLSL::length() const {
+    return m_orientation == Qt::Horizontal ? width() : height();
+}
+
+int WOverviewGLSL::breadth() const {
+    return m_orientation == Qt::Horizontal ? height() : width();
+}
+
+void WOverviewGLSL::addCursorGeometry(
+        allshader::VertexData* pVertices, allshader::RGBAData* pColors) {
+    const float lineWidth = static_cast<float>(m_scaleFactor);
+    const float halfWidth = lineWidth / 2;
+    const auto fullBreadth = static_cast<float>(breadth());
+
+    // The played overlay is one pixel long and scaled to the play position
+    m_playedVertexOffset = pVertices->size();
+    addRectangle(pVertices, pColors, QRectF(0, 0, 1, fullBreadth), m_playedOverlayColor, 1.f);
+
+    // The pick-up position with its dark outlines and triangles, drawn around 0
+    m_pickupVertexOffset = pVertices->size();
+    for (const float outline : {-1.f, 1.f}) {
+        addRectangle(pVertices,
+                pColors,
+                QRectF(outline - halfWidth, 0, lineWidth, fullBreadth),
+                m_backgroundColor,
+                0.5f);
+    }
+    addRectangle(pVertices,
+            pColors,
+            QRectF(-halfWidth, 0, lineWidth, fullBreadth),
+            m_playPosColor,
+            1.f);
+    addTriangle(pVertices, pColors, {-2.f, 0.f}, {2.f, 0.f}, {0.f, 2.f}, m_playPosColor);
+    addTriangle(pVertices,
+            pColors,
+            {-2.f, fullBreadth - 1.f},
+            {2.f, fullBreadth - 1.f},
+            {0.f, fullBreadth - 3.f},
+            m_playPosColor);
+    m_pickupVertexCount = pVertices->size() - m_pickupVertexOffset;
+
+    // The thin line at the play position while the pick-up is dragged
+    m_dragVertexOffset = pVertices->size();
+    addRectangle(pVertices,
+            pColors,
+            QRectF(-halfWidth, 0, lineWidth, fullBreadth),
+            m_playPosColor,
+            0.5f);
+    m_dragVertexCount = pVertices->size() - m_dragVertexOffset;
+}
+
+void WOverviewGLSL::uploadMarkGeometry() {
+    allshader::VertexData vertices = m_markVertices;
+    allshader::RGBAData colors = m_markColors;
+    addCursorGeometry(&vertices, &colors);
+
+    const int vertexCount = vertices.size();
+    const int positionBytes = vertexCount * static_cast<int>(sizeof(QVector2D));
+    const int colorBytes = vertexCount * static_cast<int>(sizeof(QVector4D));
+    m_markBuffer.bind();
+    m_markBuffer.allocate(positionBytes + colorBytes);
+    m_markBuffer.write(0, vertices.constData(), positionBytes);
+    m_markBuffer.write(positionBytes, colors.constData(), colorBytes);
+    m_markBuffer.release();
+    m_bufferVertexCount = vertexCount;
+    m_bMarkGeometryDirty = false;
+}
+
+void WOverviewGLSL::drawGeometry(const QMatrix4x4& matrix, int firstVertex, int vertexCount) {
+    if (vertexCount <= 0) {
+        return;
+    }
+    const int positionLocation = m_rgbaShader.positionLocation();
+    const int colorLocation = m_rgbaShader.colorLocation();
+    // The colors follow the positions of all vertices in the buffer
+    const int colorOffset = m_bufferVertexCount * static_cast<int>(sizeof(QVector2D));
+
+    m_rgbaShader.bind();
+    m_markBuffer.bind();
+    m_rgbaShader.enableAttributeArray(positionLocation);
+    m_rgbaShader.enableAttributeArray(colorLocation);
+    m_rgbaShader.setUniformValue(m_rgbaShader.matrixLocation(), matrix);
+    m_rgbaShader.setAttributeBuffer(positionLocation, GL_FLOAT, 0, 2);
+    m_rgbaShader.setAttributeBuffer(colorLocation, GL_FLOAT, colorOffset, 4);
+
+    glDrawArrays(GL_TRIANGLES, firstVertex, vertexCount);
+
+    m_rgbaShader.disableAttributeArray(positionLocation);
+    m_rgbaShader.disableAttributeArray(colorLocation);
+    m_markBuffer.release();
+    m_rgbaShader.release();
+}
+
+void WOverviewGLSL::drawTexture(QOpenGLTexture* pTexture,
+        const QMatrix4x4& matrix,
+        const QRectF& targetRect,
+        const QRectF& textureRect) {
+    const auto texx1 = static_cast<float>(textureRect.left());
+    const auto texy1 = static_cast<float>(textureRect.top());
+    const auto texx2 = static_cast<float>(textureRect.right());
+    const auto texy2 = static_cast<float>(textureRect.bottom());
+
+    const auto posx1 = static_cast<float>(targetRect.left());
+    const auto posy1 = static_cast<float>(targetRect.top());
+    const auto posx2 = static_cast<float>(targetRect.right());
+    const auto posy2 = static_cast<float>(targetRect.bottom());
+
+    const std::array<float, 8> posarray = {posx1, posy1, posx2, posy1, posx1, posy2, posx2, posy2};
+    const std::array<float, 8> texarray = {texx1, texy1, texx2, texy1, texx1, texy2, texx2, texy2};
+
+    const int positionLocation = m_textureShader.positionLocation();
+    const int texcoordLocation = m_textureShader.texcoordLocation();
+
+    m_textureShader.bind();
+    m_textureShader.enableAttributeArray(positionLocation);
+    m_textureShader.enableAttributeArray(texcoordLocation);
+    m_textureShader.setUniformValue(m_textureShader.matrixLocation(), matrix);
+    m_textureShader.setUniformValue(m_textureShader.textureLocation(), 0);
+    m_textureShader.setAttributeArray(positionLocation, GL_FLOAT, posarray.data(), 2);
+    m_textureShader.setAttributeArray(texcoordLocation, GL_FLOAT, texarray.data(), 2);
+
+    pTexture->bind();
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    pTexture->release();
+
+    m_textureShader.disableAttributeArray(positionLocation);
+    m_textureShader.disableAttributeArray(texcoordLocation);
+    m_textureShader.release();
+}
+
+void WOverviewGLSL::paintGL() {
+    if (m_bBackgroundDirty) {
+        m_backgroundTexture.setData(m_backgroundImage);
+        m_bBackgroundDirty = false;
+    }
+    if (m_bWaveformDirty) {
+        m_waveformImageSize = m_waveformImage.size();
+        if (m_maxTextureSize > 0 && m_waveformImage.width() > m_maxTextureSize) {
+            // Texture coordinates are normalized, so the source rect still
+            // applies to the scaled down texture.
+            m_waveformTexture.setData(m_waveformImage.scaled(m_maxTextureSize,
+                    m_waveformImage.height(),
+                    Qt::IgnoreAspectRatio,
+                    Qt::SmoothTransformation));
+        } else {
+            m_waveformTexture.setData(m_waveformImage);
+        }
+        m_bWaveformDirty = false;
+    }
+    if (m_bLabelsDirty) {
+        m_labelTexture.setData(m_labelImage);
+        m_bLabelsDirty = false;
+    }
+    if (m_bMarkGeometryDirty) {
+        uploadMarkGeometry();
+    }
+
+    glClearColor(static_cast<float>(m_backgroundColor.redF()),
+            static_cast<float>(m_backgroundColor.greenF()),
+            static_cast<float>(m_backgroundColor.blueF()),
+            1.f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    QMatrix4x4 widgetMatrix;
+    widgetMatrix.ortho(QRectF(0, 0, width(), height()));
+    QMatrix4x4 trackMatrix = widgetMatrix;
+    if (m_orientation == Qt::Vertical) {
+        trackMatrix *= kTransposeMatrix;
+    }
+    const QRectF unitRect(0, 0, 1, 1);
+
+    if (m_backgroundTexture.isStorageAllocated()) {
+        drawTexture(&m_backgroundTexture, widgetMatrix, rect(), unitRect);
+    }
+
+    drawGeometry(trackMatrix, 0, m_underlayVertexCount);
+
+    if (m_waveformTexture.isStorageAllocated() && !m_waveformImageSize.isEmpty()) {
+        const QRectF textureRect(m_waveformSourceRect.x() / m_waveformImageSize.width(),
+                m_waveformSourceRect.y() / m_waveformImageSize.height(),
+                m_waveformSourceRect.width() / m_waveformImageSize.width(),
+                m_waveformSourceRect.height() / m_waveformImageSize.height());
+        drawTexture(&m_waveformTexture,
+                trackMatrix,
+                QRectF(0, 0, length(), breadth()),
+                textureRect);
+
+        if (m_playedOverlayColor.alpha() > 0) {
+            QMatrix4x4 playedMatrix = trackMatrix;
+            playedMatrix.scale(static_cast<float>(m_playPos), 1.f);
+            drawGeometry(playedMatrix, m_playedVertexOffset, 6);
+        }
+    }
+
+    drawGeometry(trackMatrix, m_underlayVertexCount, m_overlayVertexCount);
+
+    if (m_bDragging) {
+        QMatrix4x4 dragMatrix = trackMatrix;
+        dragMatrix.translate(static_cast<float>(m_playPos), 0.f);
+        drawGeometry(dragMatrix, m_dragVertexOffset, m_dragVertexCount);
+    }
+
+    if (m_bShowPickup) {
+        QMatrix4x4 pickupMatrix = trackMatrix;
+        pickupMatrix.translate(static_cast<float>(m_pickupPos), 0.f);
+        drawGeometry(pickupMatrix, m_pickupVertexOffset, m_pickupVertexCount);
+    }
+
+    if (m_labelTexture.isStorageAllocated()) {
+        drawTexture(&m_labelTexture, widgetMatrix, rect(), unitRect);
+    }
+}
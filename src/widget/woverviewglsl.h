@@ -0,0 +1,136 @@
+#pragma once
+
+#include <QColor>
+#include <QImage>
+#include <QOpenGLBuffer>
+#include <QOpenGLFunctions>
+#include <QPixmap>
+
+#include "shaders/rgbashader.h"
+#include "shaders/textureshader.h"
+#include "util/opengltexture2d.h"
+#include "waveform/renderers/allshader/rgbadata.h"
+#include "waveform/renderers/allshader/vertexdata.h"
+#include "widget/wglwidget.h"
+
+class QOpenGLTexture;
+
+/// WOverviewGLSL renders the scene of a WOverview with OpenGL. It is a child
+/// widget that covers its WOverview, which still does all the bookkeeping and
+/// handles the user interaction.
+///
+/// The waveform summary, the background pixmap and the text labels are
+/// uploaded as textures, and all the markers, loops and ranges are uploaded
+/// to a single vertex buffer. These only change when the track, its cues or
+/// the look of the overview change. Moving the play position just changes
+/// the matrices of the cursors.
+class WOverviewGLSL : public WGLWidget, private QOpenGLFunctions {
+    Q_OBJECT
+  public:
+    explicit WOverviewGLSL(QWidget* pParent);
+    ~WOverviewGLSL() override;
+
+    void setOrientation(Qt::Orientation orientation);
+    void setStyle(const QColor& backgroundColor,
+            const QPixmap& backgroundPixmap,
+            const QColor& playPosColor,
+            const QColor& playedOverlayColor,
+            double scaleFactor);
+
+    /// Replaces the texture of the waveform summary, which is drawn from
+    /// sourceRect, scaled to the whole widget.
+    void setWaveformImage(const QImage& image);
+    void setWaveformSourceRect(const QRectF& sourceRect);
+
+    /// Replaces the vertex buffer of the markers. The coordinates are along
+    /// the length and across the breadth of the overview, i.e. in widget
+    /// coordinates of a horizontal overview. The first underlayVertexCount
+    /// vertices are drawn below the waveform.
+    void setMarkGeometry(const allshader::VertexData& vertices,
+            const allshader::RGBAData& colors,
+            int underlayVertexCount);
+
+    /// Replaces the texture of all text, which is drawn on top of everything
+    /// else. The image covers the whole widget.
+    void setLabelImage(const QImage& image);
+
+    /// Called for every frame. Only requests a render if a cursor has moved.
+    void setCursors(int playPos, int pickupPos, bool showPickup, bool dragging);
+
+    static void addRectangle(allshader::VertexData* pVertices,
+            allshader::RGBAData* pColors,
+            const QRectF& rect,
+            const QColor& color,
+            float opacity);
+
+    bool event(QEvent* pEvent) override;
+
+  public slots:
+    void render();
+    void swap();
+
+  private:
+    void initializeGL() override;
+    void resizeGL(int w, int h) override;
+    void paintGL() override;
+    void paintEvent(QPaintEvent* /*unused*/) override;
+    void showEvent(QShowEvent* event) override;
+    void cleanupGL();
+
+    void uploadMarkGeometry();
+    void addCursorGeometry(allshader::VertexData* pVertices, allshader::RGBAData* pColors);
+    void drawTexture(QOpenGLTexture* pTexture,
+            const QMatrix4x4& matrix,
+            const QRectF& targetRect,
+            const QRectF& textureRect);
+    void drawGeometry(const QMatrix4x4& matrix, int firstVertex, int vertexCount);
+    int length() const;
+    int breadth() const;
+
+    mixxx::TextureShader m_textureShader;
+    mixxx::RGBAShader m_rgbaShader;
+    OpenGLTexture2D m_backgroundTexture;
+    OpenGLTexture2D m_waveformTexture;
+    OpenGLTexture2D m_labelTexture;
+    QOpenGLBuffer m_markBuffer;
+    int m_maxTextureSize;
+
+    // Data waiting for the upload in the next paintGL()
+    QImage m_backgroundImage;
+    QImage m_waveformImage;
+    QImage m_labelImage;
+    allshader::VertexData m_markVertices;
+    allshader::RGBAData m_markColors;
+    bool m_bBackgroundDirty;
+    bool m_bWaveformDirty;
+    bool m_bLabelsDirty;
+    bool m_bMarkGeometryDirty;
+
+    // Ranges of the vertex buffer
+    int m_bufferVertexCount;
+    int m_underlayVertexCount;
+    int m_overlayVertexCount;
+    int m_playedVertexOffset;
+    int m_pickupVertexOffset;
+    int m_pickupVertexCount;
+    int m_dragVertexOffset;
+    int m_dragVertexCount;
+
+    Qt::Orientation m_orientation;
+    QColor m_backgroundColor;
+    QColor m_playPosColor;
+    QColor m_playedOverlayColor;
+    double m_scaleFactor;
+    QRectF m_waveformSourceRect;
+    QSizeF m_waveformImageSize;
+
+    int m_playPos;
+    int m_pickupPos;
+    bool m_bShowPickup;
+    bool m_bDragging;
+
+    // To make sure we render at least N times after a change, because of
+    // double or triple buffering
+    int m_iPendingRenders;
+    bool m_bSwapNeeded;
+};
@@ -9,6 +9,7 @@
 #include "control/controlobject.h"
 #include "library/dao/trackschema.h"
 #include "library/library.h"
+#include "library/basesqltablemodel.h"
 #include "library/library_prefs.h"
 #include "library/librarytablemodel.h"
 #include "library/searchqueryparser.h"
@@ -184,11 +185,23 @@ void WTrackTableView::loadTrackModel(QAbstractItemModel* model, bool restoreStat
                 horizontalHeader()->sortIndicatorOrder());
 
         if (restoreState) {
-            restoreCurrentViewState();
+            restoreAfterSelect([this] {
+                restoreCurrentViewState();
+            });
         }
         return;
     }
 
+    // Pending restores refer to the previous model
+    m_restoreAfterSelect.clear();
+    if (auto* pSqlTableModel = qobject_cast<BaseSqlTableModel*>(model)) {
+        connect(pSqlTableModel,
+                &BaseSqlTableModel::selectFinished,
+                this,
+                &WTrackTableView::slotSelectFinished,
+                Qt::UniqueConnection);
+    }
+
     setVisible(false);
 
     // Save the previous track model's header state
@@ -339,11 +352,34 @@ void WTrackTableView::loadTrackModel(QAbstractItemModel* model, bool restoreStat
 
     // trigger restoring scrollBar position, selection etc.
     if (restoreState) {
-        restoreCurrentViewState();
+        restoreAfterSelect([this] {
+            restoreCurrentViewState();
+        });
     }
     initTrackMenu();
 }
 
+void WTrackTableView::restoreAfterSelect(std::function<void()> restore) {
+    const auto* pSqlTableModel = qobject_cast<BaseSqlTableModel*>(model());
+    if (pSqlTableModel && pSqlTableModel->isSelectPending()) {
+        m_restoreAfterSelect.append(std::move(restore));
+        return;
+    }
+    restore();
+}
+
+void WTrackTableView::slotSelectFinished() {
+    // Models that have been shown before are still connected
+    if (sender() != model()) {
+        return;
+    }
+    const auto restores = std::move(m_restoreAfterSelect);
+    m_restoreAfterSelect.clear();
+    for (const auto& restore : restores) {
+        restore();
+    }
+}
+
 void WTrackTableView::initTrackMenu() {
     auto* pTrackModel = getTrackModel();
     DEBUG_ASSERT(pTrackModel);
@@ -567,26 +603,30 @@ void WTrackTableView::onSearch(const QString& text) {
     QList<TrackId> selectedTracks = getSelectedTrackIds();
     TrackId prevTrack = getCurrentTrackId();
     saveCurrentIndex();
+    // A search replaces the rows of a pending search
+    m_restoreAfterSelect.clear();
     pTrackModel->search(text);
-    if (queryIsLessSpecific) {
-        // If the user removed query terms, we try to select the same
-        // tracks as before
-        setCurrentTrackId(prevTrack, m_prevColumn);
-        setSelectedTracks(selectedTracks);
-    } else {
-        // The user created a more specific search query, try to restore a
-        // previous state
-        if (!restoreCurrentViewState()) {
-            // We found no saved state for this query, try to select the
-            // tracks last active, if they are part of the result set
-            if (!setCurrentTrackId(prevTrack, m_prevColumn)) {
-                // if the last focused track is not present try to focus the
-                // respective index and scroll there
-                restoreCurrentIndex();
-            }
+    restoreAfterSelect([this, queryIsLessSpecific, selectedTracks, prevTrack] {
+        if (queryIsLessSpecific) {
+            // If the user removed query terms, we try to select the same
+            // tracks as before
+            setCurrentTrackId(prevTrack, m_prevColumn);
             setSelectedTracks(selectedTracks);
+        } else {
+            // The user created a more specific search query, try to restore a
+            // previous state
+            if (!restoreCurrentViewState()) {
+                // We found no saved state for this query, try to select the
+                // tracks last active, if they are part of the result set
+                if (!setCurrentTrackId(prevTrack, m_prevColumn)) {
+                    // if the last focused track is not present try to focus the
+                    // respective index and scroll there
+                    restoreCurrentIndex();
+                }
+                setSelectedTracks(selectedTracks);
+            }
         }
-    }
+    });
 }
 
 void WTrackTableView::onShow() {
@@ -1595,17 +1635,26 @@ void WTrackTableView::doSortByColumn(int headerSection, Qt::SortOrder sortOrder)
         prevColumn = currentIndex().column();
     }
 
+    // A sort replaces the rows of a pending sort or search
+    m_restoreAfterSelect.clear();
     sortByColumn(headerSection, sortOrder);
 
-    if (usePositions) {
-        selectTracksByPosition(selectedTrackPositions, prevColumn);
-    } else {
-        selectTracksById(selectedTrackIds, prevColumn);
-    }
+    restoreAfterSelect([this,
+                               usePositions,
+                               selectedTrackPositions,
+                               selectedTrackIds,
+                               prevColumn,
+                               savedHScrollBarPos] {
+        if (usePositions) {
+            selectTracksByPosition(selectedTrackPositions, prevColumn);
+        } else {
+            selectTracksById(selectedTrackIds, prevColumn);
+        }
 
-    // This seems to be broken since at least Qt 5.12: no scrolling is issued
-    // scrollTo(first, QAbstractItemView::EnsureVisible);
-    horizontalScrollBar()->setValue(savedHScrollBarPos);
+        // This seems to be broken since at least Qt 5.12: no scrolling is issued
+        // scrollTo(first, QAbstractItemView::EnsureVisible);
+        horizontalScrollBar()->setValue(savedHScrollBarPos);
+    });
 }
 
 void WTrackTableView::selectTracksByPosition(const QList<int>& positions, int prevColumn) {
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <QAbstractItemModel>
+#include <QList>
 #include <QSortFilterProxyModel>
+#include <functional>
 
 #include "control/controlproxy.h"
 #include "control/pollingcontrolproxy.h"
@@ -143,6 +145,7 @@ class WTrackTableView : public WLibraryTableView {
 
     void slotSortingChanged(int headerSection, Qt::SortOrder order);
     void keyNotationChanged();
+    void slotSelectFinished();
 
   protected:
     QString getModelStateKey() const override;
@@ -172,6 +175,11 @@ class WTrackTableView : public WLibraryTableView {
 
     void initTrackMenu();
 
+    // Restores the selection or the view state after a sort or search as
+    // soon as the model has replaced its rows, which might happen later if
+    // the rows are queried in background.
+    void restoreAfterSelect(std::function<void()> restore);
+
     void hideOrRemoveSelectedTracks();
 
     const UserSettingsPointer m_pConfig;
@@ -195,4 +203,6 @@ class WTrackTableView : public WLibraryTableView {
     ControlProxy* m_pKeyNotation;
     ControlProxy* m_pSortColumn;
     ControlProxy* m_pSortOrder;
+
+    QList<std::function<void()>> m_restoreAfterSelect;
 };